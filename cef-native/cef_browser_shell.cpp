@@ -26,6 +26,14 @@
 #include "include/handlers/simple_render_process_handler.h"
 #include "include/handlers/simple_app.h"
 #include "include/core/WalletService.h"
+#include "include/core/IdentityCache.h"
+#include "include/core/WalletSubscriptions.h"
+#include "include/core/DaemonChannel.h"
+#include "include/core/OverlayPool.h"
+#include "include/core/ProfileCache.h"
+#include "include/core/StartupOrchestrator.h"
+#include "include/core/TabManager.h"
+#include "include/core/OcclusionTracker.h"
 #include <shellapi.h>
 #include <windows.h>
 #include <windowsx.h>
@@ -190,10 +198,24 @@ void ShutdownApplication() {
     // Note: WalletService destructor will be called automatically when the app exits
     // This ensures the daemon is properly terminated
 
+    // Stop the identity watcher and the wallet event stream before their browsers go away
+    IdentityCache::GetInstance().Stop();
+    WalletSubscriptions::GetInstance().Stop();
+    DaemonChannel::GetInstance().Stop();
+
+    // Close pooled overlays (hidden ones included) and their windows
+    LOG_INFO("🔄 Releasing overlay pool...");
+    OverlayPool::GetInstance().Shutdown();
+
+    // Persist this launch's cache hit rates and the start-page warm list
+    ProfileCache::GetInstance().Save();
+
+    // Join the startup daemon thread and flush the startup trace
+    StartupOrchestrator::GetInstance().Shutdown();
+
     // Step 1: Close all CEF browsers first
     LOG_INFO("🔄 Closing CEF browsers...");
     CefRefPtr<CefBrowser> header_browser = SimpleHandler::GetHeaderBrowser();
-    CefRefPtr<CefBrowser> webview_browser = SimpleHandler::GetWebviewBrowser();
     CefRefPtr<CefBrowser> settings_browser = SimpleHandler::GetSettingsBrowser();
     CefRefPtr<CefBrowser> wallet_browser = SimpleHandler::GetWalletBrowser();
     CefRefPtr<CefBrowser> backup_browser = SimpleHandler::GetBackupBrowser();
@@ -204,10 +226,8 @@ void ShutdownApplication() {
         header_browser->GetHost()->CloseBrowser(false);
     }
 
-    if (webview_browser) {
-        LOG_INFO("🔄 Closing webview browser...");
-        webview_browser->GetHost()->CloseBrowser(false);
-    }
+    LOG_INFO("🔄 Closing webview tabs...");
+    TabManager::GetInstance().CloseAll();
 
     if (settings_browser) {
         LOG_INFO("🔄 Closing settings browser...");
@@ -330,6 +350,13 @@ LRESULT CALLBACK ShellWindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
         }
 
         case WM_SIZE: {
+            // Minimizing hides every browser instead of resizing them to an empty client area
+            if (wParam == SIZE_MINIMIZED) {
+                OcclusionTracker::GetInstance().OnMinimized(true);
+                return 0;
+            }
+            OcclusionTracker::GetInstance().OnMinimized(false);
+
             // Handle window resizing - resize child windows and CEF browsers
             RECT rect;
             GetClientRect(hwnd, &rect);
@@ -362,16 +389,8 @@ LRESULT CALLBACK ShellWindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
                 SetWindowPos(g_webview_hwnd, nullptr, 0, shellHeight, width, webviewHeight,
                     SWP_NOZORDER | SWP_NOACTIVATE);
 
-                // Resize the CEF browser in the webview window
-                CefRefPtr<CefBrowser> webview_browser = SimpleHandler::GetWebviewBrowser();
-                if (webview_browser) {
-                    HWND webview_cef_hwnd = webview_browser->GetHost()->GetWindowHandle();
-                    if (webview_cef_hwnd && IsWindow(webview_cef_hwnd)) {
-                        SetWindowPos(webview_cef_hwnd, nullptr, 0, 0, width, webviewHeight,
-                            SWP_NOZORDER | SWP_NOACTIVATE);
-                        webview_browser->GetHost()->WasResized();
-                    }
-                }
+                // Only the active tab is resized; background tabs are resized when activated
+                TabManager::GetInstance().OnHostResized();
             }
 
             // Resize overlay windows if they exist and are visible
@@ -438,6 +457,11 @@ LRESULT CALLBACK ShellWindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lPar
             return 0;
         }
 
+        case WM_ACTIVATEAPP:
+            // Overlays drop to the background frame rate while another application has focus
+            OcclusionTracker::GetInstance().OnAppActivated(wParam != FALSE);
+            break;
+
         case WM_CLOSE:
             LOG_INFO("🛑 Main shell window received WM_CLOSE - starting graceful shutdown...");
             ShutdownApplication();
@@ -932,6 +956,9 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow) {
     LOG_INFO("=== NEW SESSION STARTED ===");
     LOG_INFO("Shell starting...");
 
+    // Start the startup timeline; the daemon is probed/launched in parallel from here on
+    StartupOrchestrator::GetInstance().Begin();
+
     // Redirect stdout and stderr to debug_output.log as backup
     FILE* dummy;
     errno_t result1 = freopen_s(&dummy, "debug_output.log", "a", stdout);
@@ -962,6 +989,13 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow) {
     CefString(&settings.locales_dir_path).FromWString(L"cef-binaries\\Resources\\locales");
     CefString(&settings.browser_subprocess_path).FromWString(exe_path);
 
+    // On-disk profile so HTTP/code caches and storage survive restarts
+    StartupOrchestrator::GetInstance().BeginPhase("profile_configure");
+    ProfileCache::GetInstance().Configure(settings);
+    StartupOrchestrator::GetInstance().EndPhase("profile_configure");
+
+    StartupOrchestrator::GetInstance().BeginPhase("window_setup");
+
     RECT rect;
     SystemParametersInfo(SPI_GETWORKAREA, 0, &rect, 0);
     int width  = rect.right - rect.left;
@@ -1032,9 +1066,12 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int nCmdShow) {
     ShowWindow(hwnd, SW_SHOW);        UpdateWindow(hwnd);
     ShowWindow(header_hwnd, SW_SHOW); UpdateWindow(header_hwnd);
     ShowWindow(webview_hwnd, SW_SHOW); UpdateWindow(webview_hwnd);
+    StartupOrchestrator::GetInstance().EndPhase("window_setup");
 
     LOG_DEBUG("Initializing CEF...");
+    StartupOrchestrator::GetInstance().BeginPhase("cef_initialize");
     bool success = CefInitialize(main_args, settings, app, nullptr);
+    StartupOrchestrator::GetInstance().EndPhase("cef_initialize");
     LOG_DEBUG("CefInitialize success: " + std::string(success ? "true" : "false"));
 
     if (!success) return 1;
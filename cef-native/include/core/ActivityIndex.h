@@ -0,0 +1,110 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Rollups of wallet calls per domain, built from ActivityJournal events. Each domain keeps running
+// totals per hour, so the totals for any time range are the difference of two entries found by
+// binary search, and per-route buckets for the breakdown of a single domain. Rollup() merges hours
+// before a cutoff into days to bound memory; ranges resolve to whole hours, or whole days where
+// they reach into merged data.
+// Not thread-safe; ActivityJournal loads one on the file thread and hands it to the UI thread.
+class ActivityIndex {
+public:
+    enum Outcome : uint8_t {
+        kOk = 0,
+        kHttpError = 1,     // the daemon answered with a non-2xx status
+        kFailed = 2,        // the daemon could not be reached
+        kCanceled = 3,      // released before an answer, e.g. an approval that never came
+        kApproved = 4,      // answered through the BRC-100 approval modal
+        kShed = 5           // turned away by the daemon scheduler or circuit breaker without reaching the daemon
+    };
+
+    struct Event {
+        uint32_t domain = 0;
+        uint16_t route = 0;
+        uint8_t outcome = kOk;
+        int64_t timeMs = 0;
+        uint32_t latencyMicros = 0;
+        uint32_t bytesIn = 0;
+        uint32_t bytesOut = 0;
+    };
+
+    // Id for a domain or "METHOD /path" route, interning it if new; returns false for a new name
+    // once the table is full
+    bool InternDomain(const std::string& name, uint32_t& id);
+    bool InternRoute(const std::string& name, uint16_t& id);
+
+    // Replayed names arrive with their ids from the journal
+    void DefineDomain(uint32_t id, const std::string& name);
+    void DefineRoute(uint16_t id, const std::string& name);
+
+    void Add(const Event& event);
+
+    // Merges hourly totals and route buckets before beforeMs into one entry per day
+    void Rollup(int64_t beforeMs);
+
+    // {from, to, total, domains: [{domain, calls, errors, avgLatencyMs, bytesIn, bytesOut, lastUsed}]}
+    // busiest first
+    nlohmann::json QueryDomains(int64_t fromMs, int64_t toMs, size_t limit) const;
+
+    // {domain, from, to, total, routes: [...], bucketMs, series: [{t, calls, errors}]}, or null
+    // for an unknown domain
+    nlohmann::json QueryDomain(const std::string& domain, int64_t fromMs, int64_t toMs) const;
+
+    // Binary snapshot of names and rollups; Restore returns false on a malformed one
+    std::string Serialize() const;
+    bool Restore(const std::string& data);
+
+    uint64_t EventCount() const { return eventCount_; }
+    size_t DomainCount() const { return domainNames_.size(); }
+    size_t RouteCount() const { return routeNames_.size(); }
+    size_t MemoryBytes() const;
+
+private:
+    // Running totals from the domain's first hour through this one
+    struct HourTotals {
+        int32_t hour = 0;
+        uint64_t calls = 0;
+        uint64_t errors = 0;
+        uint64_t latencyMicros = 0;
+        uint64_t bytesIn = 0;
+        uint64_t bytesOut = 0;
+    };
+
+    struct RouteBucket {
+        int32_t hour = 0;
+        uint16_t route = 0;
+        uint32_t calls = 0;
+        uint32_t errors = 0;
+        uint32_t latencyMaxMicros = 0;
+        uint64_t latencyMicros = 0;
+        uint64_t bytesIn = 0;
+        uint64_t bytesOut = 0;
+    };
+
+    struct Domain {
+        int64_t lastUsedMs = 0;
+        std::vector<HourTotals> hours;
+        std::vector<RouteBucket> buckets;   // by hour, then route
+    };
+
+    // Totals over hours [fromHour, toHour) as a difference of running totals
+    HourTotals RangeTotals(const Domain& domain, int32_t fromHour, int32_t toHour) const;
+
+    // Widens [fromHour, toHour) to whole days where it reaches into merged data
+    void ResolveRange(int64_t fromMs, int64_t toMs, int32_t& fromHour, int32_t& toHour) const;
+
+    std::vector<std::string> domainNames_;
+    std::vector<std::string> routeNames_;
+    std::unordered_map<std::string, uint32_t> domainIds_;
+    std::unordered_map<std::string, uint16_t> routeIds_;
+    std::vector<Domain> domains_;
+    uint64_t eventCount_ = 0;
+
+    // Hours before this one hold whole days
+    int32_t dailyBeforeHour_ = 0;
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "ActivityIndex.h"
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Record of every wallet call a site made: domain, route, time, latency, bytes and outcome. Calls
+// are appended as fixed-size binary records to <profile>\Activity\journal.log in batches written
+// on the file thread, and folded into an ActivityIndex for the settings UI's usage queries. Every
+// few tens of thousands of calls the index is snapshotted to rollups.bin together with the journal
+// length it covers, so startup restores the snapshot and replays only the journal written since.
+// UI thread only, except Record.
+class ActivityJournal {
+public:
+    static ActivityJournal& GetInstance();
+
+    // Starts loading; calls recorded before it finishes are applied afterwards
+    void Start();
+
+    // One wallet call that completed or was abandoned; bytesIn is the request body, bytesOut the
+    // response. Safe on any thread: off the UI thread it only posts a task.
+    void Record(const std::string& domain, const std::string& method, const std::string& endpoint,
+                int64_t startedMs, uint32_t latencyMicros, uint32_t bytesIn, uint32_t bytesOut,
+                ActivityIndex::Outcome outcome);
+
+    // {domain?, from?, to?, limit?}: per-domain totals when domain is absent, otherwise that
+    // domain's routes and time series. The range defaults to the last 30 days.
+    nlohmann::json Query(const nlohmann::json& request);
+
+    // Journal size, load and snapshot results and query timings
+    nlohmann::json GetStats() const;
+
+    // "METHOD /path" with the query string dropped and id-like path segments collapsed
+    static std::string RouteOf(const std::string& method, const std::string& endpoint);
+
+private:
+    struct LoadResult {
+        uint64_t journalBytes = 0;
+        uint64_t replayedEvents = 0;
+        uint64_t truncatedBytes = 0;
+        bool fromSnapshot = false;
+        bool ok = false;
+        long long loadMs = 0;
+    };
+
+    struct QueuedEvent {
+        std::string domain;
+        std::string route;
+        ActivityIndex::Event event;
+    };
+
+    ActivityJournal() = default;
+    ActivityJournal(const ActivityJournal&) = delete;
+    ActivityJournal& operator=(const ActivityJournal&) = delete;
+
+    static void LoadOnFileThread(std::wstring directory);
+    void OnLoaded(ActivityIndex* index, const LoadResult& result);
+    void Apply(const QueuedEvent& queued);
+    void ScheduleFlush();
+    void Flush();
+
+    bool started_ = false;
+    bool persistent_ = false;
+    std::wstring directory_;
+
+    std::unique_ptr<ActivityIndex> index_;
+    std::vector<QueuedEvent> queued_;
+    LoadResult load_;
+
+    // Records waiting for the next batched write, and the journal length once it lands
+    std::string writeBuffer_;
+    bool flushScheduled_ = false;
+    uint64_t journalBytes_ = 0;
+
+    uint64_t eventsSinceSnapshot_ = 0;
+    uint64_t snapshots_ = 0;
+    size_t lastSnapshotBytes_ = 0;
+
+    uint64_t eventsRecorded_ = 0;
+    uint64_t eventsDropped_ = 0;
+    uint64_t queries_ = 0;
+    double queryMaxMicros_ = 0.0;
+    std::vector<double> recentQueryMicros_;
+    size_t recentQueryNext_ = 0;
+};
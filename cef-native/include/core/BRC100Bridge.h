@@ -2,6 +2,7 @@
 
 #include <string>
 #include <nlohmann/json.hpp>
+#include "DaemonTransport.h"
 #include <windows.h>
 #include <winhttp.h>
 #include <thread>
@@ -57,6 +58,7 @@ private:
     HINTERNET hSession_;
     HINTERNET hConnect_;
     bool connected_;
+    DaemonSocket socket_;
 
     // WebSocket connection
     HINTERNET hWebSocket_;
@@ -2,6 +2,7 @@
 
 #include "include/cef_v8.h"
 #include "BRC100Bridge.h"
+#include <map>
 
 class BRC100Handler : public CefV8Handler {
 public:
@@ -18,9 +19,26 @@ public:
     // Initialize BRC-100 API in JavaScript context
     static void RegisterBRC100API(CefRefPtr<CefV8Context> context);
 
+    // Applies a "brc100_session_update" pushed by the browser's BRC100SessionCache: {live, drop?}
+    static void UpdateSessionCache(const nlohmann::json& update);
+
 private:
     std::unique_ptr<BRC100Bridge> bridge_;
 
+    // Sessions this process has created or seen validated, answering validateSession without a
+    // daemon round trip. Only trusted while the browser's table is live, since its pushes are what
+    // drop revoked sessions; kept to main frames, which are the ones those pushes reach.
+    struct CachedSession {
+        nlohmann::json session;
+        int64_t expiresAtMs;
+        int64_t cachedAtMs;
+    };
+    static std::map<std::string, CachedSession> sessionCache_;
+    static bool sessionCacheLive_;
+
+    static bool CanCacheSessions();
+    static void CacheSession(const nlohmann::json& session);
+
     // API method handlers
     bool HandleStatus(CefRefPtr<CefV8Value> object, const CefV8ValueList& arguments, CefRefPtr<CefV8Value>& retval, CefString& exception);
     bool HandleIsAvailable(CefRefPtr<CefV8Value> object, const CefV8ValueList& arguments, CefRefPtr<CefV8Value>& retval, CefString& exception);
@@ -50,9 +68,8 @@ private:
     bool HandleCreateSPVProof(CefRefPtr<CefV8Value> object, const CefV8ValueList& arguments, CefRefPtr<CefV8Value>& retval, CefString& exception);
 
     // Helper methods
-    nlohmann::json V8ValueToJSON(CefRefPtr<CefV8Value> value);
-    CefRefPtr<CefV8Value> JSONToV8Value(const nlohmann::json& json);
     std::string V8StringToStdString(const CefString& cefStr);
+    bool ValidateBEEFPayload(const nlohmann::json& beefData, std::string& error);
 
     IMPLEMENT_REFCOUNTING(BRC100Handler);
     DISALLOW_COPY_AND_ASSIGN(BRC100Handler);
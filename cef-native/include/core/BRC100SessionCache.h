@@ -0,0 +1,47 @@
+#pragma once
+
+#include "BRC100SessionTable.h"
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Browser-process copy of the daemon's BRC-100 session table, so session checks are answered
+// without a daemon round trip. Seeded from /brc100/sessions each time the wallet event stream
+// connects and kept current from its sessions topic (WalletSubscriptions feeds both); emptied
+// when the stream drops, since a daemon that restarted has forgotten every session. The table
+// itself is a BRC100SessionTable; this fetches its snapshots and tells renderers. Renderers keep
+// their own copy of the sessions they have seen and are told by "brc100_session_update" which to
+// drop.
+class BRC100SessionCache {
+public:
+    static BRC100SessionCache& GetInstance();
+
+    // Event stream state and sessions topic events; UI thread
+    void OnStreamConnected();
+    void OnStreamLost();
+    void OnEvent(const nlohmann::json& data);
+
+    // See BRC100SessionTable; any thread
+    bool Validate(const std::string& body, std::string& response);
+    bool DomainHasSession(const std::string& domain);
+
+    // {live} for a renderer asking whether its copy may be trusted, sent as brc100_session_update
+    nlohmann::json GetSyncState();
+
+    nlohmann::json GetStats();
+
+private:
+    BRC100SessionCache() = default;
+    BRC100SessionCache(const BRC100SessionCache&) = delete;
+    BRC100SessionCache& operator=(const BRC100SessionCache&) = delete;
+
+    static void FetchOnWorkerThread(uint64_t generation);
+    void OnSnapshot(uint64_t generation, const nlohmann::json& response);
+
+    // Pushes to every renderer: which sessions to drop, and whether to keep trusting their copy
+    void Broadcast(const nlohmann::json& update);
+
+    std::mutex mutex_;
+    BRC100SessionTable table_;
+};
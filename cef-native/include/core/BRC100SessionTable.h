@@ -0,0 +1,89 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// The daemon's BRC-100 session table as BRC100SessionCache keeps it: sessions by id, an expiry
+// order for purging and a count of unexpired sessions per app domain. Seeded from a
+// /brc100/sessions response; sessions topic events that arrive while the snapshot is in flight are
+// held and replayed over it in order. Nothing is answered until it has been seeded, and only what
+// the table holds is answered at all: a session id it does not know goes to the daemon.
+// Not thread-safe; BRC100SessionCache guards its one instance with a mutex.
+class BRC100SessionTable {
+public:
+    enum SeedResult {
+        kSeeded,
+        kNotListed,     // the response had no session list; the daemon keeps answering
+        kStale          // from an older stream connection, or seeding was not asked for
+    };
+
+    // Unix milliseconds of a session's expiresAt (RFC 3339, as the daemon writes it); 0 if unreadable
+    static int64_t ExpiresAtMs(const nlohmann::json& session);
+    static int64_t NowMs();
+
+    // The stream connected: empties the table and starts waiting for a snapshot; returns the
+    // generation to hand back to Seed() with it
+    uint64_t BeginSeeding();
+    // The stream dropped, so a daemon that restarted may have forgotten every session: empties the
+    // table and stops answering. Returns whether it was answering before.
+    bool Drop();
+    SeedResult Seed(uint64_t generation, const nlohmann::json& response);
+
+    // A sessions topic event: created, updated, revoked or expired. Returns false when it carries
+    // no change or session id.
+    bool OnEvent(const std::string& change, const nlohmann::json& session);
+
+    // Answers a POST /brc100/session/validate body exactly as the daemon would; false when the
+    // daemon has to (not seeded, no sessionId in the body, or a session the table does not hold)
+    bool Validate(const std::string& body, std::string& response);
+    // True when the domain holds an unexpired session, which settles /isAuthenticated locally
+    bool DomainHasSession(const std::string& domain);
+
+    bool Live() const { return live_; }
+    size_t Size() const { return sessions_.size(); }
+
+    nlohmann::json GetStats() const;
+
+private:
+    struct Entry {
+        nlohmann::json session;
+        std::string domain;
+        int64_t expiresAtMs;
+    };
+
+    void Apply(const std::string& change, const nlohmann::json& session);
+    void Put(const nlohmann::json& session);
+    void Erase(const std::string& sessionId);
+    void PurgeExpired(int64_t nowMs);
+    void Clear();
+
+    bool live_ = false;
+    // Bumped whenever the stream connects or drops, so a snapshot from an older connection is ignored
+    uint64_t generation_ = 0;
+    bool seeding_ = false;
+    // Events that arrived while the snapshot was in flight, replayed over it in order
+    std::vector<std::pair<std::string, nlohmann::json>> pendingEvents_;
+
+    std::unordered_map<std::string, Entry> sessions_;
+    // (expiresAtMs, sessionId), soonest first
+    std::set<std::pair<int64_t, std::string>> byExpiry_;
+    // Unexpired sessions per app domain
+    std::unordered_map<std::string, size_t> domains_;
+
+    uint64_t seeds_ = 0;
+    uint64_t clears_ = 0;
+    uint64_t events_ = 0;
+    uint64_t expired_ = 0;
+    // Sessions left out because their expiry could not be read; checks for them go to the daemon
+    uint64_t unreadable_ = 0;
+    uint64_t validAnswers_ = 0;
+    uint64_t invalidAnswers_ = 0;
+    uint64_t daemonAnswers_ = 0;
+    uint64_t authenticatedAnswers_ = 0;
+    uint64_t validateMicros_ = 0;
+};
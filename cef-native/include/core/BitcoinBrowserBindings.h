@@ -0,0 +1,13 @@
+#pragma once
+
+#include "include/cef_v8.h"
+
+// Installs window.bitcoinBrowser as native functions from OnContextCreated, so it exists before
+// any page script runs. Promise-returning methods go through RendererRpc.
+// Every context gets identity, navigation and address; only the browser's own UI (an app-URL
+// main frame) also gets wallet, tabs, history and overlay.
+class BitcoinBrowserBindings {
+public:
+    // Returns the time spent building the bindings, in microseconds
+    static long long Install(CefRefPtr<CefV8Context> context, bool appFrame);
+};
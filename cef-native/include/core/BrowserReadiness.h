@@ -0,0 +1,50 @@
+#pragma once
+
+#include "include/cef_browser.h"
+#include "include/cef_process_message.h"
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <map>
+
+// Tracks whether each browser's React app has mounted (it sends "app_ready" once it has)
+// and holds work for that browser until then. Replaces guessing with fixed post-load delays:
+// queued messages are flushed the moment the page signals readiness, and sent immediately
+// once it is ready. A navigation/reload resets the browser to not-ready.
+// UI thread only.
+class BrowserReadiness {
+public:
+    using Task = std::function<void(CefRefPtr<CefBrowser> browser)>;
+
+    static BrowserReadiness& GetInstance();
+
+    // Load started: page state is gone until the app signals again
+    void MarkLoading(CefRefPtr<CefBrowser> browser);
+
+    // "app_ready" received: runs everything queued for the browser, in order
+    void MarkReady(CefRefPtr<CefBrowser> browser);
+
+    bool IsReady(CefRefPtr<CefBrowser> browser) const;
+
+    // Runs now if the browser is ready, otherwise when it becomes ready
+    void RunWhenReady(CefRefPtr<CefBrowser> browser, Task task);
+
+    // Sends to the browser's main frame now or on readiness
+    void SendWhenReady(CefRefPtr<CefBrowser> browser, CefRefPtr<CefProcessMessage> message);
+
+    // Drops state for a browser that is being closed
+    void Forget(CefRefPtr<CefBrowser> browser);
+
+private:
+    struct State {
+        bool ready = false;
+        std::chrono::steady_clock::time_point loadStart;
+        std::deque<Task> pending;
+    };
+
+    BrowserReadiness() = default;
+    BrowserReadiness(const BrowserReadiness&) = delete;
+    BrowserReadiness& operator=(const BrowserReadiness&) = delete;
+
+    std::map<int, State> states_;
+};
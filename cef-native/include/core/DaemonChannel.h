@@ -0,0 +1,113 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Shared-memory request/response rings to the wallet daemon for the calls sites make most often
+// (getPublicKey, createSignature, createHmac, verifyHmac), each microseconds of work that over
+// HTTP pays far more for the round trip. The daemon creates the mapping and two named events at
+// startup (go-wallet/shm_channel_windows.go), owned by and open to its user only; this side
+// attaches when they exist and are owned by the same user as the browser. Each ring slot
+// holds one 16-byte frame header and a payload of the site's JSON body or the daemon's answer.
+// Whoever waits sets a flag first, so events are only signalled when the other side sleeps;
+// calls submitted together are published, and answered, as one batch.
+class DaemonChannel {
+public:
+    enum Op : uint16_t {
+        kGetPublicKey = 1,
+        kCreateSignature,
+        kCreateHmac,
+        kVerifyHmac
+    };
+
+    // status is the daemon's HTTP status, or 0 when the call was not answered over the channel
+    // (daemon gone, hung or answer too large); all channel ops are safe to resend over HTTP then
+    using Callback = std::function<void(int status, std::string body)>;
+
+    struct Call {
+        uint16_t op;
+        std::string body;
+        Callback done;
+    };
+
+    static DaemonChannel& GetInstance();
+
+    // Op serving a POST to this wallet endpoint, or 0 when it goes over HTTP
+    static uint16_t OpForEndpoint(const std::string& endpoint);
+
+    // Attaches to the mapping of that name; GetInstance() uses the one the daemon creates
+    explicit DaemonChannel(const std::wstring& name);
+    ~DaemonChannel();
+    DaemonChannel(const DaemonChannel&) = delete;
+    DaemonChannel& operator=(const DaemonChannel&) = delete;
+
+    // Starts the thread that attaches to the daemon, reattaches after it restarts and delivers answers
+    void Start();
+    void Stop();
+
+    bool Connected() const { return connected_; }
+
+    // Queues one call; false when the channel is down, full or the body does not fit a slot, and
+    // the caller should use HTTP instead. done runs on the channel thread.
+    bool Submit(uint16_t op, const std::string& body, Callback done);
+
+    // Queues calls in order and wakes the daemon at most once; returns how many were queued
+    size_t SubmitBatch(std::vector<Call>& calls);
+
+    nlohmann::json GetStats() const;
+
+private:
+    struct Pending {
+        Callback done;
+        uint64_t deadline;
+    };
+
+    bool Attach();
+    void Detach();
+    void Run();
+    // Delivers the answers the daemon has published; returns how many
+    size_t Drain();
+    // Fails calls past their deadline; true if any were
+    bool ExpireCalls();
+    void WaitForAnswers();
+
+    uint8_t* Slot(int ring, uint32_t index) const;
+
+    std::wstring name_;
+    // HANDLEs on Windows, kept as void* so this header does not pull in windows.h
+    void* mapping_ = nullptr;
+    uint8_t* view_ = nullptr;
+    void* requestEvent_ = nullptr;
+    void* answerEvent_ = nullptr;
+    void* stopEvent_ = nullptr;
+
+    std::atomic<bool> running_{false};
+    std::atomic<bool> connected_{false};
+    std::thread worker_;
+
+    // Submitting side; pending_ is shared with the channel thread
+    std::mutex mutex_;
+    uint32_t requestHead_ = 0;
+    uint32_t nextId_ = 1;
+    std::unordered_map<uint32_t, Pending> pending_;
+
+    // Channel thread only
+    uint32_t answerTail_ = 0;
+    bool foreignObjectLogged_ = false;
+
+    std::atomic<uint64_t> calls_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> answered_{0};
+    std::atomic<uint64_t> timeouts_{0};
+    std::atomic<uint64_t> wakeups_{0};
+    std::atomic<uint64_t> sleeps_{0};
+    std::atomic<uint64_t> attaches_{0};
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// How long a daemon call may take. Each route has a budget; a caller further up the stack (an
+// IPC message, a site's resource request) can open a Scope that cuts every call beneath it short,
+// so nested calls share the caller's deadline instead of each waiting out their own.
+class DaemonDeadline {
+public:
+    // Narrows this thread's deadline to budgetMs from now for the life of the scope; a scope
+    // inside another never extends it
+    class Scope {
+    public:
+        explicit Scope(uint32_t budgetMs);
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        uint64_t previous_;
+    };
+
+    // What is left of routeBudgetMs once cut to this thread's deadline; 0 when that has passed
+    static uint32_t RemainingMs(uint32_t routeBudgetMs);
+    static uint64_t NowMs();
+};
+
+struct DaemonRoutePolicy {
+    uint32_t budgetMs;
+    // Safe to send twice, so a slow attempt may be hedged and a failed one retried
+    bool idempotent;
+    // Sent even while the circuit is open, and an answer closes it; for health checks, which
+    // startup polls while the daemon comes up
+    bool probe;
+
+    static DaemonRoutePolicy For(const std::string& method, const std::string& endpoint);
+};
+
+// Fails daemon calls fast while the daemon is down or stalled, instead of every caller waiting
+// out its own timeout. Trips after consecutive failures or a high failure rate among recent calls,
+// stays open for a cool-down that doubles with each failed probe, then lets a single probe through.
+// Also sends hedges for reads that run past the recent p95, within a budget of a tenth of calls.
+class DaemonCircuitBreaker {
+public:
+    enum class State { Closed, Open, HalfOpen };
+
+    enum class Outcome {
+        Answered,       // the daemon answered, whatever the status
+        Failed,         // no answer from any attempt
+        TimedOut,       // the deadline passed first
+        FailedFast      // not sent: the breaker is open or the deadline had already passed
+    };
+
+    // One try at a request, with its timeout; true once the daemon answered
+    using Attempt = std::function<bool(uint32_t timeoutMs, int& status, std::string& body)>;
+
+    static DaemonCircuitBreaker& GetInstance();
+    static const char* StateName(State state);
+    static const char* OutcomeName(Outcome outcome);
+
+    // GetInstance() guards the wallet daemon; tests build their own
+    DaemonCircuitBreaker() = default;
+    DaemonCircuitBreaker(const DaemonCircuitBreaker&) = delete;
+    DaemonCircuitBreaker& operator=(const DaemonCircuitBreaker&) = delete;
+
+    // Runs attempt on the calling thread within the deadline
+    Outcome Call(const DaemonRoutePolicy& policy, const Attempt& attempt, int& status, std::string& body);
+
+    // For idempotent requests: first runs on the calling thread, normally over a kept-alive
+    // connection, and is retried there if it fails fast. Once it has run past the hedge delay a
+    // second attempt from makeHedge goes out on a thread of its own, and cancelFirst (callable from
+    // any thread) cuts first short if that answers first. A hedge may be abandoned at the deadline,
+    // so it must own everything it touches; only a few are ever out at once.
+    Outcome CallHedged(const DaemonRoutePolicy& policy, const Attempt& first, const std::function<void()>& cancelFirst,
+                       const std::function<Attempt()>& makeHedge, int& status, std::string& body);
+
+    // For callers that send the request themselves: false while calls should fail fast, otherwise
+    // the call must be reported to OnSuccess or OnFailure
+    bool Allow();
+    void OnSuccess(uint64_t latencyUs);
+    void OnFailure();
+
+    State state();
+
+    nlohmann::json GetStats();
+
+private:
+    struct Race;
+
+    // Lets a hedge through if the budget allows; the delay is 0 when it does not
+    uint32_t HedgeDelayMs(uint32_t budgetMs);
+    // Sends a hedge for race unless it is already decided, out of tokens or over the in-flight cap
+    void SendHedge(const std::shared_ptr<Race>& race, const std::function<Attempt()>& makeHedge,
+                   std::chrono::steady_clock::time_point deadline);
+    void RecordLocked(bool ok);
+
+    std::mutex mutex_;
+    State state_ = State::Closed;
+    uint64_t openUntilMs_ = 0;
+    uint64_t coolDownMs_ = 0;
+    bool probing_ = false;
+    uint64_t probeStartedMs_ = 0;
+    uint32_t consecutiveFailures_ = 0;
+    // Recent outcomes, true for a failure, oldest overwritten first
+    std::vector<bool> recent_;
+    size_t nextRecent_ = 0;
+    // Recent answered latencies in microseconds, for the hedge delay
+    std::vector<double> latencies_;
+    size_t nextLatency_ = 0;
+    double hedgeTokens_ = 0;
+
+    uint64_t calls_ = 0;
+    uint64_t outcomes_[4] = {};
+    uint64_t hedges_ = 0;
+    uint64_t hedgeWins_ = 0;
+    uint64_t hedgesCapped_ = 0;
+    uint64_t retries_ = 0;
+    uint64_t trips_ = 0;
+};
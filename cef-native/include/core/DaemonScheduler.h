@@ -0,0 +1,140 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Admission control in front of the wallet daemon, so that one site flooding it cannot starve the
+// user's own wallet panel. Calls are classed by who made them; UI calls are admitted at once (the
+// UI thread waits on them, and dApp answers need that thread), the other classes share a fixed
+// number of in-flight slots. Waiting calls are admitted highest class first and round-robin between
+// domains within a class. Each site also has a token bucket per class, and queues are bounded:
+// a call over its site's rate, behind a full queue or left waiting past its deadline is shed.
+class DaemonScheduler {
+public:
+    enum Priority : uint8_t {
+        kUi = 0,        // user-initiated, from the shell's own views
+        kAuth,          // a site authenticating
+        kDapp,          // any other site call
+        kBackground,    // the shell's own syncing and watching
+        kPriorityCount
+    };
+
+    enum Verdict : uint8_t {
+        kAdmitted = 0,
+        kRateLimited,   // over the site's token bucket
+        kQueueFull,     // too many calls waiting in its class, or from its site
+        kExpired,       // waited past the class deadline
+        kCanceled
+    };
+
+    // Runs exactly once, from Submit() itself or from whichever thread frees a slot; must not block
+    using AdmitCallback = std::function<void(Verdict)>;
+
+    static DaemonScheduler& GetInstance();
+    static const char* PriorityName(Priority priority);
+    static const char* VerdictName(Verdict verdict);
+
+    // Class of a call a site makes through the request interceptor
+    static Priority ClassifySiteRequest(const std::string& endpoint);
+    // Calls that stay open until the daemon has something to say; they are rate limited but hold
+    // no slot, or a few of them would block everything else
+    static bool IsLongPoll(const std::string& endpoint);
+
+    // GetInstance() is the daemon's scheduler; tests and benchmarks build their own
+    DaemonScheduler() = default;
+    DaemonScheduler(const DaemonScheduler&) = delete;
+    DaemonScheduler& operator=(const DaemonScheduler&) = delete;
+
+    // Queues a call and returns a ticket for Cancel(). An admitted call must be Release()d.
+    uint64_t Submit(Priority priority, const std::string& domain, AdmitCallback admit);
+    // Drops a call still waiting; its callback never runs. False once it was admitted or shed.
+    bool Cancel(uint64_t ticket);
+    // Blocks until the call is admitted or shed
+    Verdict Acquire(Priority priority, const std::string& domain);
+    void Release(Priority priority);
+
+    // Token bucket alone, for long polls
+    bool TakeToken(Priority priority, const std::string& domain);
+
+    // Holds a slot for one blocking call
+    class Slot {
+    public:
+        Slot(Priority priority, const std::string& domain)
+            : priority_(priority), verdict_(GetInstance().Acquire(priority, domain)) {}
+        ~Slot() {
+            if (verdict_ == kAdmitted) {
+                GetInstance().Release(priority_);
+            }
+        }
+        Slot(const Slot&) = delete;
+        Slot& operator=(const Slot&) = delete;
+
+        bool Admitted() const { return verdict_ == kAdmitted; }
+        Verdict verdict() const { return verdict_; }
+
+    private:
+        Priority priority_;
+        Verdict verdict_;
+    };
+
+    // Per class: calls by verdict, in flight, waiting, and queue wait percentiles
+    nlohmann::json GetStats();
+
+private:
+    struct Waiter {
+        uint64_t ticket;
+        uint64_t enqueuedUs;
+        AdmitCallback admit;
+    };
+
+    // Waiting calls of one class, one FIFO per domain taking turns
+    struct ClassQueue {
+        std::unordered_map<std::string, std::deque<Waiter>> byDomain;
+        std::deque<std::string> turns;
+        size_t size = 0;
+    };
+
+    struct Bucket {
+        double tokens;
+        uint64_t refilledUs;
+    };
+
+    struct ClassStats {
+        uint64_t submitted = 0;
+        uint64_t verdicts[5] = {};
+        uint64_t inFlight = 0;
+        uint64_t peakWaiting = 0;
+        // Most recent queue waits in microseconds, oldest overwritten first
+        std::vector<double> waitMicros;
+        size_t nextWait = 0;
+    };
+
+    using Admission = std::pair<AdmitCallback, Verdict>;
+
+    // Takes a waiting call out of its queue, recording why; false once it has left
+    bool Withdraw(uint64_t ticket, Verdict verdict);
+    bool TakeTokenLocked(Priority priority, const std::string& domain, uint64_t nowUs);
+    // Admits waiting calls into free slots and sheds expired ones; the callbacks are run by the
+    // caller once the lock is released
+    void DispatchLocked(uint64_t nowUs, std::vector<Admission>& admissions);
+    bool PopNext(Priority priority, Waiter& waiter);
+    void RecordWait(Priority priority, uint64_t micros);
+    static void RunAdmissions(std::vector<Admission>& admissions);
+
+    std::mutex mutex_;
+    ClassQueue queues_[kPriorityCount];
+    ClassStats stats_[kPriorityCount];
+    std::unordered_map<std::string, Bucket> buckets_[kPriorityCount];
+    // Ticket -> class and domain, for Cancel()
+    std::unordered_map<uint64_t, std::pair<Priority, std::string>> waiting_;
+    uint64_t nextTicket_ = 1;
+    size_t sharedInFlight_ = 0;
+    uint64_t dispatches_ = 0;
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+// Which transport the browser uses to reach the wallet daemon. By default requests go over the
+// daemon's Unix domain socket (<APPDATA>\BabbageBrowser\wallet\daemon.sock; Winsock has AF_UNIX
+// since Windows 10 1803) and fall back to WinHTTP on localhost:3301 whenever the socket cannot
+// be used. --wallet-transport=tcp keeps everything on TCP.
+class DaemonTransport {
+public:
+    enum class Mode {
+        Auto,   // socket first, TCP when that fails
+        Tcp     // TCP only
+    };
+
+    static DaemonTransport& GetInstance();
+
+    // From --wallet-transport at startup, before the first daemon request
+    void SetMode(Mode mode) { mode_ = mode; }
+    static const char* ModeName(Mode mode);
+
+    const std::string& SocketPath() const { return socketPath_; }
+
+    // Whether requests should try the socket now. After the socket fails to connect (a daemon
+    // without it, or not started yet) it is left alone for a few seconds so that every request
+    // does not pay for a failed connect first.
+    bool SocketAvailable() const;
+    void OnSocketConnectFailed();
+
+    void RecordSocketRequest(bool ok) { (ok ? socketRequests_ : socketFailures_)++; }
+    void RecordTcpRequest() { tcpRequests_++; }
+
+    // Mode and request counts per transport
+    nlohmann::json GetStats() const;
+
+private:
+    DaemonTransport();
+    DaemonTransport(const DaemonTransport&) = delete;
+    DaemonTransport& operator=(const DaemonTransport&) = delete;
+
+    std::atomic<Mode> mode_{Mode::Auto};
+    std::string socketPath_;
+    // GetTickCount64() before which SocketAvailable() is false
+    std::atomic<uint64_t> socketRetryAt_{0};
+
+    std::atomic<uint64_t> socketRequests_{0};
+    std::atomic<uint64_t> socketFailures_{0};
+    std::atomic<uint64_t> tcpRequests_{0};
+};
+
+// HTTP/1.1 to the daemon over its Unix domain socket. Each instance keeps one connection alive
+// between requests, plus a separate one for a long-running stream. Not thread-safe, like the
+// WalletService that owns it, except that Cancel() and CancelRequest() may be called from any thread.
+class DaemonSocket {
+public:
+    DaemonSocket() = default;
+    // A daemon listening somewhere else, such as a test's stub; requests and streams to it skip
+    // the transport's retry window and counters
+    explicit DaemonSocket(const std::string& path) : path_(path) {}
+    ~DaemonSocket();
+    DaemonSocket(const DaemonSocket&) = delete;
+    DaemonSocket& operator=(const DaemonSocket&) = delete;
+
+    enum class Result {
+        Ok,             // status and responseBody hold the daemon's answer
+        Unavailable,    // nothing reached the daemon; the caller should go over TCP instead
+        Failed          // the request went out but no complete answer came back
+    };
+
+    // Sends the request and reads the whole response, giving up on a send or receive that stalls
+    // for timeoutMs (0 for the same 30 s as WinHTTP)
+    Result Request(const std::string& method, const std::string& endpoint, const std::string& body,
+                   int& status, std::string& responseBody, uint32_t timeoutMs = 0);
+
+    // GETs endpoint and hands the body to onData as it arrives, until onData returns false, the
+    // daemon ends the response or Cancel() is called. onOpen runs once a 200 response has started.
+    // Returns the response status, 0 when the socket could not be connected (use TCP instead) or
+    // -1 when the connection ended before a response.
+    int Stream(const std::string& endpoint, const std::function<void()>& onOpen,
+               const std::function<bool(const char*, size_t)>& onData);
+
+    // Ends a Stream() call blocked on another thread
+    void Cancel();
+
+    // Ends a Request() blocked on another thread, as when a hedge has already answered it; the
+    // kept-alive connection is dropped, the request is not sent again, and the next request opens
+    // a new one
+    void CancelRequest();
+
+private:
+    void CloseConnection();
+
+    std::string path_;
+    // SOCKET values, kept as integers so this header does not pull in winsock2.h. connection_ is
+    // only changed under connectionMutex_, so CancelRequest() never shuts down a closed socket.
+    std::mutex connectionMutex_;
+    uintptr_t connection_ = ~uintptr_t(0);
+    // Set by CancelRequest(), so the request in flight fails instead of going out again
+    bool requestCanceled_ = false;
+    std::atomic<uintptr_t> stream_{~uintptr_t(0)};
+};
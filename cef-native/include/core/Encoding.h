@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Hex and base64 codecs for wallet payloads (transactions, BEEF, keys, signatures).
+// Each call picks the widest implementation the CPU supports (AVX2, SSSE3, scalar)
+// at runtime, so the binary still runs on machines without AVX2.
+namespace Encoding {
+
+    // Hex (lowercase output, case-insensitive input)
+    std::string hexEncode(const uint8_t* data, size_t length);
+    std::string hexEncode(const std::string& bytes);
+    bool hexDecode(const std::string& hex, std::string& out);
+    bool isValidHex(const std::string& hex);
+
+    // Base64 (RFC 4648 standard alphabet, '=' padding required on input)
+    std::string base64Encode(const uint8_t* data, size_t length);
+    std::string base64Encode(const std::string& bytes);
+    bool base64Decode(const std::string& base64, std::string& out);
+    bool isValidBase64(const std::string& base64);
+
+    // Name of the implementation in use ("avx2", "ssse3" or "scalar")
+    const char* activeImplementation();
+
+    // Pins one implementation by name, or "auto" to go back to the CPU's best; false if this CPU
+    // cannot run it. Lets tests and benchmarks cover every path on one machine.
+    bool forceImplementation(const std::string& name);
+}
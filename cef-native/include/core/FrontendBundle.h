@@ -0,0 +1,95 @@
+#pragma once
+
+#include "include/cef_resource_handler.h"
+#include "include/cef_scheme.h"
+#include <nlohmann/json.hpp>
+#include <windows.h>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+// The built React UI, packed by frontend/scripts/pack-bundle.mjs into one indexed archive
+// (frontend.bundle) and memory-mapped at startup. Served on bitcoin-browser://app/ so the
+// header and overlays load without touching a socket. When no bundle is present the shell
+// falls back to the Vite dev server at http://127.0.0.1:5137.
+//
+// Archive layout (little-endian):
+//   header  "BBFEPK01" | u32 entryCount | u32 indexBytes
+//   index   u16 pathLen | path | u8 mimeLen | mime | u64 etag |
+//           3 x (u64 offset | u32 length) for identity, br, gzip (offset 0 = absent)
+//   data    blobs at absolute file offsets
+class FrontendBundle {
+public:
+    static const char* kScheme;
+    static const char* kHost;
+
+    enum Encoding { kIdentity = 0, kBrotli = 1, kGzip = 2, kEncodingCount = 3 };
+
+    struct Entry {
+        std::string mime;
+        std::string etag;
+        const uint8_t* data[kEncodingCount] = {};
+        uint32_t length[kEncodingCount] = {};
+    };
+
+    static FrontendBundle& GetInstance();
+
+    // Maps the archive; returns false (and leaves the dev-server fallback active) on any error
+    bool Open(const std::wstring& path);
+    void Close();
+    bool IsOpen() const { return view_ != nullptr; }
+
+    // Registers the bitcoin-browser:// handler with CEF (browser process, after CefInitialize)
+    void RegisterSchemeHandler();
+
+    // Looks up a request path; extensionless paths fall back to /index.html for client-side routes
+    const Entry* Find(const std::string& path) const;
+
+    // Base URL of the UI ("bitcoin-browser://app" or the dev server) plus a route path
+    std::string Url(const std::string& route) const;
+
+    // True for URLs served from either UI origin, so renderer checks work with both. Gates the
+    // privileged bitcoinBrowser bindings, so it matches the origin exactly.
+    static bool IsAppUrl(const std::string& url);
+    static bool IsAppRootUrl(const std::string& url);
+
+    // Counters updated by the resource handler (IO thread)
+    void RecordServed(Encoding encoding, uint32_t bytes);
+    void RecordNotModified();
+    void RecordMiss();
+
+    // Open time, entry count and served/304/miss counts per encoding
+    nlohmann::json GetStats() const;
+
+private:
+    FrontendBundle() = default;
+    FrontendBundle(const FrontendBundle&) = delete;
+    FrontendBundle& operator=(const FrontendBundle&) = delete;
+
+    bool ParseIndex(const uint8_t* base, size_t size);
+
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+    const uint8_t* view_ = nullptr;
+    size_t size_ = 0;
+    long long openMicros_ = 0;
+    std::unordered_map<std::string, Entry> entries_;
+
+    std::atomic<uint64_t> served_[kEncodingCount] = {};
+    std::atomic<uint64_t> servedBytes_[kEncodingCount] = {};
+    std::atomic<uint64_t> notModified_{0};
+    std::atomic<uint64_t> misses_{0};
+};
+
+// Serves bitcoin-browser://app/* straight out of the mapped archive
+class FrontendSchemeHandlerFactory : public CefSchemeHandlerFactory {
+public:
+    CefRefPtr<CefResourceHandler> Create(CefRefPtr<CefBrowser> browser,
+                                         CefRefPtr<CefFrame> frame,
+                                         const CefString& scheme_name,
+                                         CefRefPtr<CefRequest> request) override;
+
+private:
+    IMPLEMENT_REFCOUNTING(FrontendSchemeHandlerFactory);
+};
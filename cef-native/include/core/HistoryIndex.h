@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// In-memory index over browsing history for address bar suggestions. URLs are kept sorted by
+// match key (lowercased, without scheme and "www.") for prefix lookups, prefixes of up to three
+// characters have precomputed top lists, and trigram posting lists over host and title catch
+// substring matches. Results are ranked by frecency: visit count weighted by recency, with
+// typed visits counting extra.
+// Not thread-safe; HistoryStore builds one on the file thread and hands it to the UI thread.
+class HistoryIndex {
+public:
+    struct Entry {
+        std::string url;
+        std::string key;
+        std::string title;
+        uint32_t visits = 0;
+        uint32_t typed = 0;
+        int64_t lastVisitMs = 0;
+    };
+
+    struct Suggestion {
+        std::string url;
+        std::string title;
+        uint32_t visits = 0;
+        uint32_t typed = 0;
+        bool prefixMatch = false;
+        double score = 0.0;
+    };
+
+    // One visit at timeMs; typed when it came from the address bar
+    void AddVisit(const std::string& url, int64_t timeMs, bool typed);
+
+    // Folds in a URL's totals, as written by log compaction
+    void AddAggregate(const std::string& url, const std::string& title,
+                      uint32_t visits, uint32_t typed, int64_t lastVisitMs);
+
+    // true when the URL has been visited and its title changed
+    bool SetTitle(const std::string& url, const std::string& title);
+
+    // Sorting is deferred between these while a whole log is replayed
+    void BeginBulk();
+    void EndBulk(int64_t nowMs);
+
+    // Up to limit suggestions for the typed text, best first
+    std::vector<Suggestion> Query(const std::string& text, size_t limit, int64_t nowMs);
+
+    const std::vector<Entry>& Entries() const { return entries_; }
+    uint64_t VisitCount() const { return visitCount_; }
+    size_t MemoryBytes() const;
+
+    // Lowercased, trimmed text without scheme and leading "www."
+    static std::string KeyOf(const std::string& text);
+    static double Frecency(const Entry& entry, int64_t nowMs);
+
+private:
+    uint32_t FindOrInsert(const std::string& url);
+    void IndexTrigrams(uint32_t index, const std::string& text);
+    void MergePending();
+    void RefreshShortPrefixes(int64_t nowMs, bool force);
+    bool KeyLess(uint32_t a, uint32_t b) const { return entries_[a].key < entries_[b].key; }
+
+    std::vector<Entry> entries_;
+    std::unordered_map<std::string, uint32_t> byUrl_;
+
+    // Entry indexes sorted by key, plus recent inserts not merged in yet
+    std::vector<uint32_t> sorted_;
+    std::vector<uint32_t> pending_;
+    bool bulk_ = false;
+
+    // Trigram of lowercased host or title -> entries containing it
+    std::unordered_map<uint32_t, std::vector<uint32_t>> trigrams_;
+
+    // Key prefix of up to three characters -> best entries, rebuilt at most every few seconds
+    std::unordered_map<uint32_t, std::vector<uint32_t>> shortTop_;
+    int64_t shortBuiltMs_ = 0;
+    bool shortDirty_ = true;
+
+    uint64_t visitCount_ = 0;
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "HistoryIndex.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Browsing history behind the address bar's suggestions. Visits and title changes are appended
+// to <profile>\History\visits.log, a compact binary log that is memory-mapped and replayed into a
+// HistoryIndex on the file thread at startup; a torn tail from a crash is cut off, and a log
+// that has grown to several records per URL is rewritten as one record each. Without a
+// persistent profile history lives in memory for the session only.
+// UI thread only.
+class HistoryStore {
+public:
+    static HistoryStore& GetInstance();
+
+    // Starts loading the log; visits recorded before it finishes are applied afterwards
+    void Start();
+
+    // A tab finished loading a page (TabManager skips prerenders and restores of discarded tabs)
+    void RecordVisit(const std::string& url, const std::string& title, bool activeTab);
+    void RecordTitle(const std::string& url, const std::string& title);
+
+    // Address bar navigation: the active tab's next visit counts as typed
+    void NoteTypedNavigation();
+
+    // [{url, title, visits, typed, prefix}] best first
+    nlohmann::json Search(const std::string& text, size_t limit);
+
+    // Index size, load and query timings
+    nlohmann::json GetStats() const;
+
+private:
+    struct LoadResult {
+        uint64_t records = 0;
+        uint64_t logBytes = 0;
+        uint64_t truncatedBytes = 0;
+        bool compacted = false;
+        bool ok = false;
+        long long loadMs = 0;
+    };
+
+    struct QueuedVisit {
+        std::string url;
+        std::string title;
+        bool typed = false;
+        int64_t timeMs = 0;
+    };
+
+    HistoryStore() = default;
+    HistoryStore(const HistoryStore&) = delete;
+    HistoryStore& operator=(const HistoryStore&) = delete;
+
+    static void LoadOnFileThread(std::wstring path, int64_t nowMs);
+    void OnLoaded(HistoryIndex* index, const LoadResult& result);
+    void ApplyVisit(const QueuedVisit& visit);
+    void Append(const std::string& record);
+
+    bool started_ = false;
+    bool persistent_ = false;
+    std::wstring path_;
+
+    std::unique_ptr<HistoryIndex> index_;
+    std::vector<QueuedVisit> queued_;
+    LoadResult load_;
+
+    std::chrono::steady_clock::time_point typedAt_;
+    bool typedPending_ = false;
+
+    uint64_t visitsRecorded_ = 0;
+    uint64_t bytesAppended_ = 0;
+    uint64_t queries_ = 0;
+    double queryMaxMicros_ = 0.0;
+    std::vector<double> recentQueryMicros_;
+    size_t recentQueryNext_ = 0;
+};
@@ -16,6 +16,11 @@ public:
     virtual ~HttpRequestInterceptor();
 
     // CefResourceRequestHandler methods
+    cef_return_value_t OnBeforeResourceLoad(CefRefPtr<CefBrowser> browser,
+                                            CefRefPtr<CefFrame> frame,
+                                            CefRefPtr<CefRequest> request,
+                                            CefRefPtr<CefCallback> callback) override;
+
     CefRefPtr<CefResourceHandler> GetResourceHandler(
         CefRefPtr<CefBrowser> browser,
         CefRefPtr<CefFrame> frame,
@@ -45,3 +50,7 @@ private:
 // Global functions for BRC-100 auth modal
 void triggerBRC100AuthApprovalModal(const std::string& domain, const std::string& method, const std::string& endpoint, const std::string& body);
 void sendAuthRequestDataToOverlay();
+
+// Syncs the state store's domain whitelist with the daemon's domainWhitelist.json now, then again
+// whenever the daemon rewrites the file
+void startDomainWhitelistSync();
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <windows.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Browser-process cache of the public part of identity.json (address, publicKey, backedUp) plus
+// the daemon health state. A background thread watches the identity directory and probes the
+// daemon; whenever either changes, an "identity_update" message is pushed to the shell renderers
+// so identity.get() can be answered from renderer memory instead of disk + HTTP. The private key
+// is never cached, sent or stored. The last public fields are kept in the state store for the
+// next startup.
+class IdentityCache {
+public:
+    static IdentityCache& GetInstance();
+
+    void Start();
+    void Stop();
+
+    // Re-read identity.json now (e.g. after a wallet event) and broadcast if it changed
+    void Reload();
+
+    // Health result from outside the watch loop (startup daemon probe); broadcasts on change
+    void SetDaemonHealthy(bool healthy);
+
+    // {"identity": <public fields or null>, "daemonHealthy": bool}
+    nlohmann::json GetSnapshot();
+
+    // The fields of an identity.json record that may leave the browser process
+    static nlohmann::json PublicFields(const nlohmann::json& identity);
+
+    // Pushes the current snapshot to the shell browsers (UI thread only)
+    void BroadcastUpdate();
+
+private:
+    IdentityCache() = default;
+    ~IdentityCache();
+    IdentityCache(const IdentityCache&) = delete;
+    IdentityCache& operator=(const IdentityCache&) = delete;
+
+    void WatchLoop();
+    bool ReadIdentityFile(nlohmann::json& identity);
+    bool RefreshIdentity();
+    void PostBroadcast();
+
+    std::string identityDir_;
+    std::string identityPath_;
+
+    std::mutex mutex_;
+    nlohmann::json identity_;
+    bool hasIdentity_ = false;
+
+    std::atomic<bool> daemonHealthy_{false};
+    std::atomic<bool> running_{false};
+    HANDLE stopEvent_ = nullptr;
+    std::thread worker_;
+};
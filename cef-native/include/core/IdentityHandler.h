@@ -16,8 +16,15 @@ public:
                  CefRefPtr<CefV8Value>& retval,
                  CefString& exception) override;
 
+    // Applies an "identity_update" payload pushed by the browser process
+    static void UpdateCache(const nlohmann::json& snapshot);
+
+private:
+    // Renderer-side copy of the browser's IdentityCache; identity.get() answers from here
+    static nlohmann::json cachedIdentity_;
+    static bool hasCachedIdentity_;
+    static bool daemonHealthy_;
+    static bool cacheInitialized_;
+
     IMPLEMENT_REFCOUNTING(IdentityHandler);
 };
-
-// Declare jsonToV8 function
-CefRefPtr<CefV8Value> jsonToV8(const nlohmann::json& j);
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "include/cef_browser.h"
+#include "include/cef_frame.h"
+#include "include/cef_process_message.h"
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Registration-based process message dispatch.
+// Message names are interned to route ids once at registration; dispatch is a single hash
+// lookup instead of a chain of string compares, and every route keeps call counts and timing.
+// Not thread-safe: each router lives on one CEF thread (browser UI thread or renderer thread).
+class MessageRouter {
+public:
+    using Handler = std::function<bool(CefRefPtr<CefBrowser> browser,
+                                       CefRefPtr<CefFrame> frame,
+                                       CefProcessId source_process,
+                                       CefRefPtr<CefProcessMessage> message)>;
+
+    // logProcess matches Logger's process ids (1 = render, 2 = browser)
+    MessageRouter(const std::string& name, int logProcess);
+
+    // Returns false (and keeps the existing handler) if the message already has a route
+    bool Register(const std::string& messageName, Handler handler);
+
+    // Runs the registered handler; returns false if there is none or it declined the message
+    bool Dispatch(CefRefPtr<CefBrowser> browser,
+                  CefRefPtr<CefFrame> frame,
+                  CefProcessId source_process,
+                  CefRefPtr<CefProcessMessage> message);
+
+    // Per-route call counts and timing, sorted by total time
+    nlohmann::json GetStats() const;
+    void LogStats() const;
+
+private:
+    struct Route {
+        std::string name;
+        Handler handler;
+        uint64_t calls = 0;
+        uint64_t totalMicros = 0;
+        uint64_t maxMicros = 0;
+    };
+
+    std::string name_;
+    int logProcess_;
+    std::unordered_map<std::string, size_t> routeIds_;
+    std::vector<Route> routes_;
+    uint64_t dispatched_ = 0;
+    uint64_t unrouted_ = 0;
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+// Guesses where the address bar is heading from each keystroke and warms it up:
+// DNS resolution for any plausible target, a preconnect once the guess is likely, and a
+// prerender in a hidden tab when confidence reaches --prerender-confidence (default 0.8;
+// --no-prerender disables it). Committing to the prerendered URL swaps that tab in for the
+// active one. Guesses rank the origins committed from the address bar this session.
+// Prerendering tabs cannot reach the wallet; HttpRequestInterceptor cancels their wallet calls.
+// UI thread only.
+class NavigationPredictor {
+public:
+    static NavigationPredictor& GetInstance();
+
+    // Reads the switches
+    void Start();
+
+    // Address bar text changed
+    void OnInput(const std::string& text);
+
+    // Address bar navigation to the normalized url; true when a prerendered tab was swapped in,
+    // otherwise the caller loads the url into the active tab
+    bool OnCommit(const std::string& url);
+
+    // Hooks from TabManager
+    void OnPrerenderCreated(int tabId, uint64_t token);
+    void OnTabLoaded(int tabId);
+    void OnTabRemoved(int tabId);
+
+    // Scheme-less input gets http://, as the address bar always has
+    static std::string NormalizeUrl(const std::string& text);
+
+    // Prediction accuracy, warmup counts and commit-to-ready times by warmup level
+    nlohmann::json GetStats() const;
+
+private:
+    enum class Warmup { None, Resolved, Preconnected, Prerendered, Count };
+
+    struct Prediction {
+        std::string url;
+        std::string origin;
+        double confidence = 0.0;
+    };
+
+    struct Prerender {
+        std::string url;
+        uint64_t token = 0;
+        int tabId = 0;
+        bool loaded = false;
+        std::chrono::steady_clock::time_point startedAt;
+    };
+
+    struct PendingReady {
+        Warmup warmup = Warmup::None;
+        std::chrono::steady_clock::time_point committedAt;
+    };
+
+    struct ReadyStats {
+        uint64_t count = 0;
+        uint64_t totalMs = 0;
+    };
+
+    NavigationPredictor() = default;
+    NavigationPredictor(const NavigationPredictor&) = delete;
+    NavigationPredictor& operator=(const NavigationPredictor&) = delete;
+
+    Prediction Predict(const std::string& text) const;
+    void Resolve(const std::string& origin);
+    void Preconnect(const std::string& origin);
+    void StartPrerender(const std::string& url);
+    void CancelPrerender();
+    void RecordReady(Warmup warmup, std::chrono::steady_clock::time_point committedAt);
+    static const char* WarmupName(Warmup warmup);
+
+    double prerenderConfidence_ = 0.8;
+    bool prerenderEnabled_ = true;
+
+    // Committed origin -> commit count
+    std::unordered_map<std::string, uint32_t> origins_;
+
+    // When each origin was last resolved / preconnected
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> resolvedAt_;
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> preconnectedAt_;
+
+    Prediction lastPrediction_;
+    Prerender prerender_;
+    uint64_t nextPrerenderToken_ = 0;
+
+    // Keyed by tab id: commits waiting for their page to finish loading
+    std::unordered_map<int, PendingReady> pendingReady_;
+
+    uint64_t inputs_ = 0;
+    uint64_t predictions_ = 0;
+    uint64_t resolves_ = 0;
+    uint64_t preconnects_ = 0;
+    uint64_t prerendersStarted_ = 0;
+    uint64_t prerenderHits_ = 0;
+    uint64_t prerendersWasted_ = 0;
+    uint64_t commits_ = 0;
+    uint64_t commitsPredicted_ = 0;
+    ReadyStats ready_[static_cast<int>(Warmup::Count)];
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "include/cef_browser.h"
+#include <nlohmann/json.hpp>
+#include <windows.h>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+// Decides which browsers are on screen and tells CEF. Windowed browsers (header, tabs) are
+// hidden by hiding their HWND, the same signal TabManager uses for background tabs; windowless
+// overlays get WasHidden and a frame rate that drops while the shell is in the background
+// (--background-overlay-fps, default 5). Chromium throttles timers and rAF in hidden pages on its own.
+// While the main window is minimized every browser is hidden.
+// CPU time of the browser and its child processes is sampled per shell state (active, idle,
+// background, minimized) so idle-but-open sessions can be measured.
+// UI thread only.
+class OcclusionTracker {
+public:
+    static OcclusionTracker& GetInstance();
+
+    // Reads the switches and starts CPU sampling
+    void Start();
+
+    // Main window state from ShellWindowProc
+    void OnMinimized(bool minimized);
+    void OnAppActivated(bool active);
+    bool IsMinimized() const { return minimized_; }
+
+    // Overlay visibility from OverlayPool; applies WasHidden and the frame rate
+    void SetOverlayVisible(const std::string& role, CefRefPtr<CefBrowser> browser, bool visible);
+    void OnOverlayClosed(const std::string& role);
+
+    // Visibility per browser, CPU usage per shell state and notification counts
+    nlohmann::json GetStats() const;
+
+private:
+    enum class ShellState { Active, Idle, Background, Minimized, Count };
+
+    struct Overlay {
+        CefRefPtr<CefBrowser> browser;
+        bool visible = false;
+        bool appliedHidden = false;
+        int appliedFps = 0;
+    };
+
+    struct StateUsage {
+        uint64_t wallMs = 0;
+        uint64_t cpuMs = 0;
+    };
+
+    OcclusionTracker() = default;
+    OcclusionTracker(const OcclusionTracker&) = delete;
+    OcclusionTracker& operator=(const OcclusionTracker&) = delete;
+
+    void ApplyOverlay(Overlay& overlay);
+    void ApplyAll();
+    void SetWindowedVisible(bool visible);
+    void SampleCpu();
+    void ScheduleSample();
+    ShellState CurrentState() const;
+    static const char* StateName(ShellState state);
+
+    bool minimized_ = false;
+    bool appActive_ = true;
+    int foregroundFps_ = 30;
+    int backgroundFps_ = 5;
+    bool started_ = false;
+
+    std::map<std::string, Overlay> overlays_;
+
+    // CPU sampling: last cumulative kernel+user time per process, in 100 ns units
+    std::unordered_map<DWORD, uint64_t> lastCpuTimes_;
+    std::chrono::steady_clock::time_point lastSample_;
+    StateUsage usage_[static_cast<int>(ShellState::Count)];
+
+    uint64_t hideNotifications_ = 0;
+    uint64_t showNotifications_ = 0;
+    uint64_t frameRateChanges_ = 0;
+    uint64_t minimizes_ = 0;
+};
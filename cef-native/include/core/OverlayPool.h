@@ -0,0 +1,84 @@
+#pragma once
+
+#include "include/cef_browser.h"
+#include <nlohmann/json.hpp>
+#include <windows.h>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+
+struct OverlaySpec;
+
+// Keeps overlay browsers (settings, wallet, backup, brc100auth) alive between shows.
+// Closing an overlay hides its layered HWND and marks the browser hidden instead of destroying it,
+// so the next show is a window move + repaint rather than a renderer spin-up and full page load.
+// Pooled overlays are evicted least-recently-used when their estimated footprint exceeds the budget.
+// UI thread only.
+class OverlayPool {
+public:
+    static OverlayPool& GetInstance();
+
+    // Estimated bytes the pool may keep alive (visible overlays are never evicted)
+    void SetMemoryBudget(size_t bytes);
+
+    // Creates hidden settings + wallet overlays so the first show is already warm
+    void PrewarmDefaults(HINSTANCE hInstance);
+
+    // Shows the overlay for a role, reusing a pooled browser when one matches the window size
+    bool Show(const std::string& role, HINSTANCE hInstance);
+
+    // Hides a pooled overlay; returns false if the role has no pooled overlay
+    bool Hide(const std::string& role);
+
+    // Lifecycle hooks from SimpleHandler / MyOverlayRenderHandler
+    void OnBrowserCreated(const std::string& role, CefRefPtr<CefBrowser> browser);
+    void OnLoadFinished(const std::string& role);
+    void OnOverlayPainted(HWND hwnd);
+
+    // Closes every pooled browser and window
+    void Shutdown();
+
+    // Per-role show counts, warm/cold show-to-first-paint timing and eviction counts
+    nlohmann::json GetStats() const;
+
+private:
+    struct Entry {
+        const OverlaySpec* spec = nullptr;
+        HWND hwnd = nullptr;
+        int width = 0;
+        int height = 0;
+        CefRefPtr<CefBrowser> browser;
+        bool loaded = false;
+        bool visible = false;
+        uint64_t lastUsed = 0;
+        bool awaitingPaint = false;
+        bool warmShow = false;
+        std::chrono::steady_clock::time_point showStart;
+    };
+
+    struct RoleStats {
+        uint64_t warmShows = 0;
+        uint64_t coldShows = 0;
+        uint64_t warmTotalMicros = 0;
+        uint64_t coldTotalMicros = 0;
+        uint64_t maxMicros = 0;
+        uint64_t evictions = 0;
+    };
+
+    OverlayPool() = default;
+    OverlayPool(const OverlayPool&) = delete;
+    OverlayPool& operator=(const OverlayPool&) = delete;
+
+    Entry* CreateEntry(const OverlaySpec& spec, HINSTANCE hInstance, bool visible);
+    void PresentEntry(Entry& entry);
+    void Evict(const std::string& role);
+    void EnforceBudget(const std::string& keepRole);
+    size_t EstimateBytes(const Entry& entry) const;
+    size_t TotalEstimatedBytes() const;
+
+    std::map<std::string, Entry> entries_;
+    std::map<std::string, RoleStats> stats_;
+    size_t budgetBytes_ = 256 * 1024 * 1024;
+    uint64_t useCounter_ = 0;
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "include/cef_resource_handler.h"
+#include <chrono>
 #include <string>
 
 // Global variable to store pending auth request data
@@ -11,6 +12,10 @@ struct PendingAuthRequest {
     std::string body;
     bool isValid;
     CefRefPtr<CefResourceHandler> handler;
+
+    // Approval-modal latency: interception -> data delivered to the overlay -> modal visible
+    std::chrono::steady_clock::time_point interceptedAt;
+    std::chrono::steady_clock::time_point deliveredAt;
 };
 
 // External reference to pending auth request
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "include/cef_app.h"
+#include "include/cef_browser.h"
+#include "include/cef_command_line.h"
+#include "include/cef_devtools_message_observer.h"
+#include "include/cef_registration.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+// Manages the on-disk CEF profile under %LOCALAPPDATA%\BabbageBrowser\Profile so the HTTP cache,
+// V8 code cache and site storage survive restarts. The caches are held under a size budget
+// (--cache-budget-mb, default 512), the start page's critical subresources and the wallet UI are
+// re-fetched in the background after startup to prime the cache, and per-launch disk-cache hit
+// rates and load times are kept so repeat launches can be compared.
+// UI thread only, except Configure/AppendSwitches which run during startup.
+class ProfileCache {
+public:
+    static ProfileCache& GetInstance();
+
+    // Before CefInitialize: resolves the profile, trims caches over budget, fills cache paths
+    void Configure(CefSettings& settings);
+
+    // Browser-process switches: caps Chromium's HTTP disk cache
+    void AppendSwitches(CefRefPtr<CefCommandLine> command_line);
+
+    // Issues background GETs for last session's warm list plus the start page and wallet UI
+    void StartWarmup(const std::vector<std::string>& urls);
+
+    // Subscribes to DevTools Network events for the browser to count disk-cache hits
+    void Observe(CefRefPtr<CefBrowser> browser, const std::string& role);
+    void Unobserve(int browserId);
+
+    // Main-frame load start/end; the first completed load per role is that launch's ready time
+    void OnLoadStarted(const std::string& role);
+    void OnLoadFinished(const std::string& role);
+
+    // Profile directory; empty when running without a persistent profile
+    const std::wstring& GetRootPath() const { return rootPath_; }
+
+    // Writes this launch's stats and the warm list into the profile
+    void Save();
+
+    // This launch vs. the previous one: hit rates, first-load times, warmup results, cache size
+    nlohmann::json GetStats() const;
+
+    // Called by the DevTools observer and warmup requests
+    void OnResponseReceived(const std::string& role, const std::string& url, const std::string& type, bool fromCache);
+    void OnWarmupComplete(bool ok, bool fromCache);
+
+private:
+    struct RoleStats {
+        uint64_t responses = 0;
+        uint64_t cacheHits = 0;
+        long long firstLoadMs = -1;
+        std::chrono::steady_clock::time_point loadStart;
+        bool loading = false;
+    };
+
+    ProfileCache() = default;
+    ProfileCache(const ProfileCache&) = delete;
+    ProfileCache& operator=(const ProfileCache&) = delete;
+
+    void LoadPrevious();
+    void EnforceBudget();
+
+    std::wstring rootPath_;
+    std::wstring cachePath_;
+    uint64_t budgetBytes_ = 512ull * 1024 * 1024;
+    uint64_t sizeAtStartup_ = 0;
+    uint64_t trimmedBytes_ = 0;
+
+    std::map<std::string, RoleStats> roles_;
+    std::map<int, CefRefPtr<CefRegistration>> observers_;
+
+    // Start-page subresources seen this launch, replayed as warmup next launch
+    std::vector<std::string> warmList_;
+    std::vector<std::string> previousWarmList_;
+    bool recordingWarmList_ = true;
+
+    uint64_t warmupIssued_ = 0;
+    uint64_t warmupDone_ = 0;
+    uint64_t warmupFailed_ = 0;
+    uint64_t warmupFromCache_ = 0;
+
+    nlohmann::json previousLaunch_;
+    uint64_t launchNumber_ = 1;
+};
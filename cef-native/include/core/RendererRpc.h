@@ -0,0 +1,43 @@
+#pragma once
+
+#include "include/cef_v8.h"
+#include "include/cef_values.h"
+#include <map>
+#include <string>
+
+// Renderer-side table of in-flight rpc_request calls, keyed by request id.
+// A call completes either through JS callbacks (cefMessage.request) or by settling
+// a V8 promise (native bitcoinBrowser bindings). Renderer thread only.
+class RendererRpc {
+public:
+    struct PendingCall {
+        std::string messageName;
+        CefRefPtr<CefV8Context> context;
+        CefRefPtr<CefV8Value> onSuccess;
+        CefRefPtr<CefV8Value> onError;
+        CefRefPtr<CefV8Value> promise;
+        // When set, the payload must carry success:true and the promise resolves to this field
+        std::string unwrapField;
+    };
+
+    // Converts a JS argument array into process message arguments; objects travel as JSON strings
+    static bool ConvertArguments(CefRefPtr<CefV8Value> array, CefRefPtr<CefListValue> out, std::string& error);
+
+    // Registers the call and sends the rpc_request envelope from the call's frame; returns the request id
+    static int Send(PendingCall call, CefRefPtr<CefListValue> args);
+
+    // Delivers an rpc_response; returns false if no call is pending under that id
+    static bool Complete(int requestId, const std::string& responseName, CefRefPtr<CefListValue> responseArgs);
+
+    // Drops calls owned by a released context
+    static void DropContext(CefRefPtr<CefV8Context> context);
+
+    static size_t InFlight() { return pending_.size(); }
+
+private:
+    // Resolves or rejects the call from its response; may throw on a payload V8 cannot hold
+    static void Settle(const PendingCall& call, const std::string& responseName, CefRefPtr<CefListValue> responseArgs);
+
+    static std::map<int, PendingCall> pending_;
+    static int nextRequestId_;
+};
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "WalletService.h"
+#include <nlohmann/json.hpp>
+#include <windows.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Drives shell startup so independent work overlaps instead of running back to back:
+// the Go daemon is probed (and launched if it is not already up) on its own thread while
+// windows are built and CEF initializes, and browser creation is issued before the
+// WebSocket server, identity watcher and cache warmup.
+// Every phase is recorded on a timeline and written to startup_trace.json in Chrome trace
+// format (open in chrome://tracing or Perfetto). The header's app-ready time is checked
+// against a first-paint budget (--first-paint-budget-ms, default 2000).
+class StartupOrchestrator {
+public:
+    static StartupOrchestrator& GetInstance();
+
+    // WinMain entry: starts the clock and the daemon thread
+    void Begin();
+
+    // Timeline recording; safe from any thread
+    void BeginPhase(const std::string& name);
+    void EndPhase(const std::string& name);
+    void Mark(const std::string& name);
+
+    // Named startup milestones ("header_app_ready", "webview_loaded", "daemon_settled");
+    // the trace is written once all of them have been reached
+    void Milestone(const std::string& name);
+
+    // Joins the daemon thread and writes the final trace
+    void Shutdown();
+
+    // Phase durations, milestones and budget result
+    nlohmann::json GetTimeline() const;
+
+private:
+    struct Event {
+        std::string name;
+        char phase;          // 'X' complete, 'i' instant
+        long long startUs;
+        long long durationUs;
+        unsigned long threadId;
+    };
+
+    StartupOrchestrator() = default;
+    StartupOrchestrator(const StartupOrchestrator&) = delete;
+    StartupOrchestrator& operator=(const StartupOrchestrator&) = delete;
+
+    long long NowUs() const;
+    void DaemonLoop();
+    void WriteTrace();
+
+    std::chrono::steady_clock::time_point t0_;
+    long long firstPaintBudgetMs_ = 2000;
+    bool launchDaemon_ = true;
+
+    mutable std::mutex mutex_;
+    std::vector<Event> events_;
+    std::map<std::string, long long> openPhases_;
+    std::set<std::string> pendingMilestones_;
+    bool budgetExceeded_ = false;
+
+    // Owns the daemon when we launched it; its destructor stops the process at exit
+    std::unique_ptr<WalletService> daemon_;
+    std::thread daemonThread_;
+    std::atomic<bool> stopping_{false};
+};
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Small embedded key-value store for shell state (domain whitelist, identity snapshot, backup
+// modal state) under %APPDATA%\BabbageBrowser\state. Every change is appended to state.log as a
+// batch of put/delete records closed by a checksummed commit record, so a batch is applied
+// entirely or not at all; recovery replays committed batches and cuts off anything after the
+// last intact commit. All live data is held in memory, making reads free and a point update
+// cost one append regardless of store size. Once the log is mostly superseded records it is
+// rewritten on the file thread from a snapshot, without holding up commits.
+// Thread-safe. The file calls are Win32 or POSIX, so the store also builds in the Linux tests.
+class StateStore {
+public:
+    class Batch {
+    public:
+        void Put(const std::string& key, const std::string& value);
+        void Delete(const std::string& key);
+        bool Empty() const { return ops_.empty(); }
+
+    private:
+        friend class StateStore;
+        struct Op {
+            bool erase = false;
+            std::string key;
+            std::string value;
+        };
+        std::vector<Op> ops_;
+    };
+
+    static StateStore& GetInstance();
+
+    // Opens or creates the store and replays its log in place of whatever is held in memory;
+    // false leaves it working in memory only
+    bool Open(const std::wstring& directory);
+    void Close();
+
+    bool Get(const std::string& key, std::string& value) const;
+
+    // Every key starting with prefix, in key order
+    std::vector<std::pair<std::string, std::string>> Scan(const std::string& prefix) const;
+
+    // Durable commits are flushed to disk before returning; others survive a crash of the
+    // browser but not of the OS
+    bool Put(const std::string& key, const std::string& value, bool durable = true);
+    bool Delete(const std::string& key, bool durable = true);
+    bool Commit(const Batch& batch, bool durable = true);
+
+    // Key count, log size vs. live data, commit latency, recovery and compaction results
+    nlohmann::json GetStats() const;
+
+private:
+    StateStore() = default;
+    ~StateStore();
+    StateStore(const StateStore&) = delete;
+    StateStore& operator=(const StateStore&) = delete;
+
+    void Recover(const std::string& data, uint64_t& validEnd);
+    void ApplyLocked(const Batch& batch);
+    bool AppendLocked(const std::string& records, bool durable);
+    void MaybeScheduleCompaction();
+    void Compact();
+    void ResetLocked();
+    static size_t EntryBytes(const std::string& key, const std::string& value);
+
+    mutable std::mutex mutex_;
+    std::map<std::string, std::string> data_;
+    std::wstring logPath_;
+#ifdef _WIN32
+    HANDLE log_ = INVALID_HANDLE_VALUE;
+#else
+    int log_ = -1;
+#endif
+
+    uint64_t sequence_ = 0;
+    uint64_t logBytes_ = 0;
+    uint64_t liveBytes_ = 0;
+    bool compacting_ = false;
+    // Records committed while a compaction writes its snapshot; carried over to the new log
+    std::string compactionTail_;
+
+    uint64_t recoveredBatches_ = 0;
+    uint64_t truncatedBytes_ = 0;
+    uint64_t commits_ = 0;
+    uint64_t durableCommits_ = 0;
+    uint64_t failedCommits_ = 0;
+    uint64_t commitMicrosTotal_ = 0;
+    uint64_t commitMicrosMax_ = 0;
+    uint64_t compactions_ = 0;
+    uint64_t bytesReclaimed_ = 0;
+    long long lastCompactionMs_ = 0;
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <windows.h>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+// Discard policy for background tabs. Every tick it samples each live tab's renderer private
+// bytes (renderers report their pid on context creation) and, while the total is over the budget
+// (--tab-memory-budget-mb, default 1536), discards the least recently active background tabs that
+// have been idle long enough (--tab-discard-idle-s, default 300). A tab with a wallet request in
+// flight or an approval modal pending for its domain is never discarded. Before discarding, the
+// page's scroll offset is read back from the renderer; the active tab's thumbnail is refreshed each
+// tick so discarded tabs still have a preview in the strip.
+// UI thread only.
+class TabLifecycle {
+public:
+    static TabLifecycle& GetInstance();
+
+    // Reads the switches and schedules the first tick
+    void Start();
+
+    // Renderer reports from SimpleHandler routes
+    void OnRendererPid(int browserId, DWORD pid);
+    void OnTabState(int browserId, int scrollX, int scrollY);
+
+    // Hooks from TabManager
+    void OnTabRestoring(int tabId);
+    void OnTabLoaded(int tabId);
+    void OnTabRemoved(int tabId);
+
+    // data:image/bmp URL of the tab's last thumbnail, empty if none was captured
+    std::string GetThumbnailDataUrl(int tabId) const;
+
+    // Discards, restores, reclaimed bytes, current renderer memory and budget
+    nlohmann::json GetStats() const;
+
+private:
+    struct PendingDiscard {
+        int tabId = 0;
+        uint64_t estimatedBytes = 0;
+        std::chrono::steady_clock::time_point requestedAt;
+    };
+
+    TabLifecycle() = default;
+    TabLifecycle(const TabLifecycle&) = delete;
+    TabLifecycle& operator=(const TabLifecycle&) = delete;
+
+    void Tick();
+    void ScheduleTick();
+    bool IsProtected(const std::string& domain, int walletInFlight) const;
+    void CaptureActiveThumbnail();
+
+    uint64_t budgetBytes_ = 1536ull * 1024 * 1024;
+    std::chrono::seconds minIdle_{300};
+    bool started_ = false;
+
+    // Renderer pid per browser id
+    std::unordered_map<int, DWORD> rendererPids_;
+
+    // Scroll read-back requested, keyed by browser id
+    std::unordered_map<int, PendingDiscard> pendingDiscards_;
+
+    // Last thumbnail per tab id, as BMP file bytes
+    std::map<int, std::string> thumbnails_;
+
+    // Restore start per tab id, for restore latency
+    std::map<int, std::chrono::steady_clock::time_point> restoring_;
+
+    uint64_t rendererBytes_ = 0;
+    uint64_t discards_ = 0;
+    uint64_t restores_ = 0;
+    uint64_t reclaimedBytes_ = 0;
+    uint64_t skippedProtected_ = 0;
+    uint64_t restoreTotalMs_ = 0;
+    uint64_t ticks_ = 0;
+};
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "include/cef_browser.h"
+#include <nlohmann/json.hpp>
+#include <windows.h>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Owns the webview browsers, one per tab, all parented to g_webview_hwnd.
+// A tab's id is the id of the first browser created for it and stays stable across a
+// discard/restore; browser ids map to tabs in O(1) for message routing and the interceptor's
+// wallet lookups. Only the active tab's window is shown and kept sized: a switch hides the old
+// window and shows the new one, resizing it only if the host changed size while it was hidden.
+// The per-tab wallet context is readable from the IO thread; everything else is UI thread only.
+class TabManager {
+public:
+    // What the HttpRequestInterceptor needs to attribute a wallet call to its tab
+    struct WalletContext {
+        std::string url;
+        std::string domain;
+        uint64_t walletRequests = 0;
+        int walletInFlight = 0;
+        bool prerender = false;
+        bool prerenderWalletBlocked = false;
+    };
+
+    // Read-only view of a tab for TabLifecycle's discard policy
+    struct TabSnapshot {
+        int id = 0;
+        int browserId = 0;
+        bool active = false;
+        bool discarded = false;
+        std::string url;
+        std::string domain;
+        int walletInFlight = 0;
+        std::chrono::steady_clock::time_point lastActive;
+    };
+
+    static TabManager& GetInstance();
+
+    // Opens a tab in the webview host; it becomes active once created when activate is set
+    void OpenTab(const std::string& url, bool activate = true);
+
+    // Activating a discarded tab recreates its browser and switches once it exists
+    bool ActivateTab(int tabId);
+    bool CloseTab(int tabId);
+
+    // Cycles through the tab strip (Ctrl+Tab / Ctrl+Shift+Tab)
+    void ActivateAdjacent(int direction);
+
+    // Closes a background tab's browser but keeps it in the strip with its URL and scroll offset
+    bool DiscardTab(int tabId, int scrollX, int scrollY);
+
+    // Prerender tabs load hidden and stay out of the strip until adopted, which puts them in place
+    // of the active tab; NavigationPredictor is told the tab id once the browser exists
+    bool OpenPrerender(const std::string& url, uint64_t token);
+    bool AdoptPrerender(int tabId);
+    void ClosePrerender(int tabId);
+
+    CefRefPtr<CefBrowser> GetActiveBrowser() const;
+    CefRefPtr<CefBrowser> GetTabBrowser(int tabId) const;
+    int GetActiveTabId() const { return activeTabId_; }
+    int TabIdForBrowser(int browserId) const;
+    std::vector<CefRefPtr<CefBrowser>> GetBrowsers() const;
+    std::vector<TabSnapshot> Snapshot() const;
+
+    // Lifecycle hooks from SimpleHandler (role "webview")
+    void OnTabCreated(CefRefPtr<CefBrowser> browser);
+    void OnTabClosed(int browserId);
+    void OnTabLoaded(int browserId);
+    void OnAddressChange(int browserId, const std::string& url);
+    void OnTitleChange(int browserId, const std::string& title);
+
+    // The webview host was resized: only the active tab follows, the rest catch up on activation
+    void OnHostResized();
+
+    // Closes every tab browser (shutdown)
+    void CloseAll();
+
+    // IO thread: per-tab context for wallet routing; false when the browser is not a tab
+    bool GetWalletContext(int browserId, WalletContext& context) const;
+
+    // Any thread: brackets the lifetime of a wallet resource handler issued by the browser
+    void BeginWalletRequest(int browserId);
+    void EndWalletRequest(int browserId);
+
+    // IO thread: true (and remembered) when the browser is a prerender whose wallet call must be
+    // refused; an adopted prerender that hit this is reloaded so the page sees a working wallet
+    bool BlockPrerenderWalletRequest(int browserId);
+
+    // [{id, url, title, domain, active, discarded}] in strip order
+    nlohmann::json GetTabList() const;
+
+    // Tab counts, switch latency percentiles, process memory and the last benchmark run
+    nlohmann::json GetStats() const;
+
+    // Opens tabCount background tabs of url (at most 100), times round-robin switches across all
+    // of them, then closes them again; results appear under "benchmark" in GetStats()
+    void StartBenchmark(int tabCount, const std::string& url);
+
+private:
+    struct PendingTab {
+        bool activate = false;
+        bool benchmark = false;
+        int restoreTabId = 0;
+        uint64_t prerenderToken = 0;
+    };
+
+    struct Tab {
+        int id = 0;
+        CefRefPtr<CefBrowser> browser;
+        std::string title;
+        int width = 0;
+        int height = 0;
+        bool prerender = false;
+        // The next load is not a new visit (a restored discard or a benchmark tab)
+        bool skipHistory = false;
+        std::chrono::steady_clock::time_point lastActive;
+
+        // Discard state: the browser is gone, the strip entry and page position remain
+        bool discarded = false;
+        bool restoring = false;
+        bool restoreScroll = false;
+        std::string discardedUrl;
+        int scrollX = 0;
+        int scrollY = 0;
+    };
+
+    TabManager() = default;
+    TabManager(const TabManager&) = delete;
+    TabManager& operator=(const TabManager&) = delete;
+
+    bool CreateTabBrowser(const std::string& url, const PendingTab& pending);
+    void ShowTab(Tab& tab);
+    void RemoveTab(int tabId);
+    void BroadcastTabs();
+    void RecordSwitch(long long micros);
+    void RunBenchmarkSwitches();
+
+    std::unordered_map<int, Tab> tabs_;
+    std::unordered_map<int, int> browserToTab_;
+    std::vector<int> order_;
+    int activeTabId_ = -1;
+
+    // Tabs whose browsers are still being created, in request order
+    std::deque<PendingTab> pending_;
+
+    // Keyed by browser id
+    mutable std::mutex contextMutex_;
+    std::unordered_map<int, WalletContext> contexts_;
+
+    uint64_t opened_ = 0;
+    uint64_t closed_ = 0;
+    uint64_t switches_ = 0;
+    uint64_t switchTotalMicros_ = 0;
+    uint64_t switchMaxMicros_ = 0;
+    std::vector<long long> recentSwitchMicros_;
+    size_t recentSwitchNext_ = 0;
+
+    int benchmarkPending_ = 0;
+    bool benchmarkRunning_ = false;
+    std::vector<int> benchmarkTabIds_;
+    uint64_t benchmarkBaselineBytes_ = 0;
+    nlohmann::json benchmarkResult_;
+};
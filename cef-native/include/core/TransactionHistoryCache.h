@@ -0,0 +1,113 @@
+#pragma once
+
+#include "TransactionHistoryIndex.h"
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Local copy of the wallet's transaction history that the history panel pages through, so opening
+// it no longer pulls the whole history from the daemon and across IPC. The cache syncs from the
+// daemon's /transaction/history with the cursor of the last sync, so only new and changed
+// transactions travel; a daemon without cursor support returns its full listing and the cache
+// works out the difference itself. Changes are appended to <profile>\Wallet\txhistory.log and
+// replayed at startup; the log is rewritten once it is mostly superseded records. Only the newest
+// kMaxTransactions transactions are kept.
+// UI thread only.
+class TransactionHistoryCache {
+public:
+    static constexpr size_t kMaxTransactions = 250000;
+
+    static TransactionHistoryCache& GetInstance();
+
+    // Starts loading the cached history; the first sync runs when a page is first asked for
+    void Start();
+
+    // {offset?, limit?, status?, text?, refresh?}: one window of the newest-first history as
+    // {total, offset, items, version, syncing, complete, syncedAt, error?}. Answers from the cache
+    // straight away and starts a sync when the cache is stale or refresh is set; history
+    // subscribers hear when it is done.
+    nlohmann::json Page(const nlohmann::json& request);
+
+    // The wallet sent a transaction, so the next page request syncs regardless of age
+    void Invalidate();
+
+    // Syncs now, or straight after the running sync; WalletSubscriptions hears the new Summary()
+    void Refresh();
+
+    // {total, version, syncedAt}: pushed to history subscribers after every load and sync
+    nlohmann::json Summary() const;
+
+    // Cache size, load and sync results and page timings
+    nlohmann::json GetStats() const;
+
+private:
+    struct LoadResult {
+        uint64_t logBytes = 0;
+        uint64_t logRecords = 0;
+        uint64_t truncatedBytes = 0;
+        uint64_t evicted = 0;
+        std::string cursor;
+        bool ok = false;
+        long long loadMs = 0;
+    };
+
+    // One response from the daemon, applied on the UI thread while the sync goes on
+    struct SyncPage {
+        std::vector<TransactionHistoryIndex::Transaction> transactions;
+        std::vector<std::string> removed;
+        std::string cursor;
+        bool listing = false;       // a full listing from a daemon without cursor support
+        bool last = true;
+        std::string error;
+        long long fetchMs = 0;
+    };
+
+    TransactionHistoryCache() = default;
+    TransactionHistoryCache(const TransactionHistoryCache&) = delete;
+    TransactionHistoryCache& operator=(const TransactionHistoryCache&) = delete;
+
+    static void LoadOnFileThread(std::wstring directory);
+    void OnLoaded(TransactionHistoryIndex* index, const LoadResult& result);
+
+    void MaybeSync(bool force);
+    static void SyncOnWorkerThread(std::string cursor);
+    void OnSyncPage(const SyncPage& page);
+
+    void AppendToLog(std::string records, size_t recordCount);
+    void MaybeCompactLog();
+
+    bool started_ = false;
+    bool persistent_ = false;
+    std::wstring directory_;
+
+    std::unique_ptr<TransactionHistoryIndex> index_;
+    LoadResult load_;
+    std::string cursor_;
+    bool complete_ = true;
+
+    uint64_t logBytes_ = 0;
+    uint64_t logRecords_ = 0;
+    uint64_t compactions_ = 0;
+
+    bool syncing_ = false;
+    bool stale_ = true;
+    bool syncAfterLoad_ = false;
+    bool syncAgain_ = false;
+    int64_t syncedAtMs_ = 0;
+    std::string syncError_;
+    uint64_t syncs_ = 0;
+    uint64_t syncPages_ = 0;
+    uint64_t transactionsReceived_ = 0;
+    uint64_t transactionsChanged_ = 0;
+    uint64_t transactionsRemoved_ = 0;
+    uint64_t transactionsEvicted_ = 0;
+    long long lastSyncMs_ = 0;
+    long long syncStartedMs_ = 0;
+
+    uint64_t pages_ = 0;
+    double pageMaxMicros_ = 0.0;
+    std::vector<double> recentPageMicros_;
+    size_t recentPageNext_ = 0;
+};
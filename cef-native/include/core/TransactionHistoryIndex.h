@@ -0,0 +1,122 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// In-memory wallet transaction history for the history panel, newest first. Each transaction is a
+// fixed-size entry whose txid, recipient and memo live in one shared text buffer, so a history of
+// a hundred thousand transactions costs a few dozen bytes per row plus its text. Entries are
+// ordered by timestamp and looked up by txid through two sorted index arrays that deltas from the
+// daemon are merged into. The last few filters keep their match lists until the history changes,
+// so scrolling a filtered view or switching back to one is as cheap as scrolling the whole list.
+// Not thread-safe; TransactionHistoryCache loads one on the file thread and hands it to the UI thread.
+class TransactionHistoryIndex {
+public:
+    enum Status : uint8_t {
+        kPending = 0,
+        kConfirmed = 1,
+        kFailed = 2
+    };
+
+    struct Transaction {
+        std::string txid;
+        std::string recipient;
+        std::string memo;
+        int64_t timestamp = 0;
+        int64_t amount = 0;
+        int64_t fee = 0;
+        uint32_t confirmations = 0;
+        uint8_t status = kPending;
+    };
+
+    struct Filter {
+        int status = -1;        // a Status, or -1 for any
+        std::string text;       // case-insensitive substring of txid, recipient or memo
+        bool Empty() const { return status < 0 && text.empty(); }
+    };
+
+    // Daemon JSON in the frontend's Transaction shape; false without a txid
+    static bool FromJson(const nlohmann::json& json, Transaction& transaction);
+    static nlohmann::json ToJson(const Transaction& transaction);
+    static const char* StatusName(uint8_t status);
+
+    // Inserts new transactions and updates changed ones; later duplicates in the batch win.
+    // Returns how many rows were added or changed, and their positions in batch when asked.
+    size_t Upsert(const std::vector<Transaction>& batch, std::vector<size_t>* changedAt = nullptr);
+
+    // Drops transactions by txid; returns how many were present
+    size_t Remove(const std::vector<std::string>& txids);
+
+    // Txids of cached transactions missing from a full listing, for daemons without a cursor
+    std::vector<std::string> MissingFrom(const std::vector<Transaction>& listing) const;
+
+    // Drops the oldest transactions beyond maxCount; returns how many were dropped
+    size_t EvictOldest(size_t maxCount);
+
+    // {total, offset, items} for rows [offset, offset + limit) of the filtered, newest-first list
+    nlohmann::json Page(size_t offset, size_t limit, const Filter& filter);
+
+    // Every transaction, newest first
+    void ForEach(const std::function<void(const Transaction&)>& visit) const;
+
+    size_t Count() const { return order_.size(); }
+    uint64_t Version() const { return version_; }
+    size_t MemoryBytes() const;
+
+private:
+    struct Entry {
+        int64_t timestamp = 0;
+        int64_t amount = 0;
+        int64_t fee = 0;
+        uint32_t confirmations = 0;
+        uint32_t textOffset = 0;
+        uint16_t memoLength = 0;
+        uint8_t txidLength = 0;
+        uint8_t recipientLength = 0;
+        uint8_t status = kPending;
+        bool live = false;
+    };
+
+    std::string TxidOf(const Entry& entry) const;
+    Transaction Expand(const Entry& entry) const;
+    void StoreText(Entry& entry, const Transaction& transaction);
+    bool SameAs(const Entry& entry, const Transaction& transaction) const;
+    bool Matches(const Entry& entry, const Filter& filter) const;
+
+    // Slot holding txid, or -1
+    int64_t Find(const std::string& txid) const;
+
+    // Newest first, ties by txid
+    bool OrderLess(uint32_t a, uint32_t b) const;
+    bool TxidLess(uint32_t a, uint32_t b) const;
+
+    // Rebuilds entries and text without dead slots once enough of them has been superseded
+    void MaybeRepack();
+
+    std::vector<Entry> entries_;
+    std::string text_;
+    size_t deadTextBytes_ = 0;
+    size_t deadSlots_ = 0;
+
+    // Live slots, newest first, and the same slots by txid
+    std::vector<uint32_t> order_;
+    std::vector<uint32_t> byTxid_;
+
+    uint64_t version_ = 0;
+
+    // Matching slots, newest first, for the last few filters; valid while version_ is unchanged
+    struct FilterView {
+        int status = -1;
+        std::string text;
+        uint64_t version = 0;
+        uint64_t lastUsed = 0;
+        std::vector<uint32_t> matches;
+    };
+    const std::vector<uint32_t>& ViewFor(const Filter& filter);
+
+    std::vector<FilterView> filterViews_;
+    uint64_t filterUses_ = 0;
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "include/cef_v8.h"
+#include <nlohmann/json.hpp>
+
+// Shared V8 <-> JSON conversion for every CefV8Handler.
+// Handles arbitrarily nested arrays/objects up to maxDepth (throws std::runtime_error beyond it),
+// keeps 64-bit integers exact, and maps ArrayBuffers to JSON binary values or base64 strings.
+namespace V8Json {
+
+    const int kDefaultMaxDepth = 64;
+
+    enum class BinaryMode {
+        Base64,   // ArrayBuffer -> base64 string (what the Go daemon expects for []byte fields)
+        Binary    // ArrayBuffer -> nlohmann::json::binary_t
+    };
+
+    CefRefPtr<CefV8Value> toV8(const nlohmann::json& value, int maxDepth = kDefaultMaxDepth);
+
+    nlohmann::json fromV8(CefRefPtr<CefV8Value> value,
+                          BinaryMode binaryMode = BinaryMode::Base64,
+                          int maxDepth = kDefaultMaxDepth);
+}
@@ -2,8 +2,11 @@
 
 #include <string>
 #include <nlohmann/json.hpp>
+#include "DaemonTransport.h"
+#include "DaemonScheduler.h"
 #include <windows.h>
 #include <winhttp.h>
+#include <functional>
 #include <thread>
 #include <atomic>
 
@@ -36,7 +39,23 @@ public:
     nlohmann::json broadcastTransaction(const nlohmann::json& transactionData);
     nlohmann::json sendTransaction(const nlohmann::json& transactionData);
     nlohmann::json getBalance(const nlohmann::json& balanceData);
-    nlohmann::json getTransactionHistory();
+    // Changes since cursor when the daemon supports it, at most limit of them (0 for no limit)
+    nlohmann::json getTransactionHistory(const std::string& since = "", size_t limit = 0);
+
+    // Holds /wallet/events open and hands each newline-delimited event to onEvent until it returns
+    // false, the daemon closes the stream or cancelEventStream() is called. onOpen runs once the
+    // daemon has accepted the stream; returns false when it never did (no daemon, or no stream support).
+    bool streamEvents(const std::function<void()>& onOpen,
+                      const std::function<bool(const nlohmann::json&)>& onEvent);
+    // Ends a streamEvents() call blocked on another thread
+    void cancelEventStream();
+
+    // Scheduler class of this instance's requests and the site they count against; UI unless set,
+    // as most callers are the shell's views
+    void setPriority(DaemonScheduler::Priority priority, const std::string& site = "") {
+        priority_ = priority;
+        site_ = site;
+    }
 
     // Connection management
     bool isConnected();
@@ -57,6 +76,11 @@ private:
     HINTERNET hSession_;
     HINTERNET hConnect_;
     bool connected_;
+    std::atomic<HINTERNET> eventStream_{nullptr};
+    // Tried before WinHTTP for every request
+    DaemonSocket socket_;
+    DaemonScheduler::Priority priority_ = DaemonScheduler::kUi;
+    std::string site_;
 
     // Process management
     PROCESS_INFORMATION daemonProcess_;
@@ -65,6 +89,7 @@ private:
 
     // HTTP helper methods
     nlohmann::json makeHttpRequest(const std::string& method, const std::string& endpoint, const std::string& body = "");
+    bool makeTcpRequest(const std::string& method, const std::string& endpoint, const std::string& body, std::string& responseBody, uint32_t timeoutMs);
     bool initializeConnection();
     void cleanupConnection();
     std::string readResponse(HINTERNET hRequest);
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "include/cef_browser.h"
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class WalletService;
+
+// Pushes wallet state to the browsers that subscribed to it, so views stop polling the daemon.
+// One background thread keeps the daemon's /wallet/events stream open. A change event either
+// carries the new state or makes the topic be fetched once for all subscribers, and the result
+// goes out as a "wallet_state" message only to browsers subscribed to that topic, and only when
+// it differs from what was last sent. Topics nobody subscribes to are not fetched at all.
+// Against a daemon without the stream, subscribed topics are polled slowly instead.
+// UI thread only, apart from the stream thread it owns. The parts that talk to the daemon (the
+// stream thread and topic fetches) live in WalletSubscriptionsStream.cpp.
+class WalletSubscriptions {
+public:
+    enum Topic : uint8_t {
+        kBalance = 0,       // {balance} from /wallet/balance
+        kAddresses,         // {addresses} from /wallet/addresses
+        kHistory,           // TransactionHistoryCache::Summary()
+        kMessages,          // {count} of relayed messages, carried by the daemon's events
+        kTopicCount
+    };
+
+    static WalletSubscriptions& GetInstance();
+
+    static const char* TopicName(Topic topic);
+    // Topic for a name, or -1
+    static int TopicFromName(const std::string& name);
+
+    void Start();
+    void Stop();
+
+    // {topics: [...]}: adds topics to the browser's subscription and returns {states} with the
+    // current state of each one already known. The rest are fetched and pushed when they arrive.
+    nlohmann::json Subscribe(CefRefPtr<CefBrowser> browser, const nlohmann::json& request);
+
+    // {topics: [...]} drops those topics; anything else drops the whole subscription
+    void Unsubscribe(int browserId, const nlohmann::json& request);
+
+    // New state for a topic worked out elsewhere in the browser; pushed if it changed
+    void Publish(Topic topic, const nlohmann::json& state);
+
+    // Posted to the UI thread by the stream thread: the stream opened or dropped (supported is
+    // false when the daemon has no stream at all), and each event it carried
+    void OnStreamState(bool connected, bool supported);
+    void OnEvent(const nlohmann::json& event);
+
+    // Subscribers per topic, stream state, fetches, pushes and suppressed duplicates
+    nlohmann::json GetStats() const;
+
+private:
+    struct TopicState {
+        nlohmann::json state;
+        bool known = false;
+        // The daemon reported a change nobody has fetched yet
+        bool stale = true;
+        bool fetching = false;
+        bool fetchAgain = false;
+        uint64_t version = 0;
+        uint64_t subscribers = 0;
+        uint64_t events = 0;
+        uint64_t fetches = 0;
+        uint64_t pushes = 0;
+        uint64_t unchanged = 0;
+    };
+
+    struct Subscriber {
+        CefRefPtr<CefBrowser> browser;
+        uint32_t topics = 0;
+    };
+
+    WalletSubscriptions() = default;
+    ~WalletSubscriptions();
+    WalletSubscriptions(const WalletSubscriptions&) = delete;
+    WalletSubscriptions& operator=(const WalletSubscriptions&) = delete;
+
+    static uint32_t TopicMask(const nlohmann::json& request);
+    void SetTopics(int browserId, Subscriber& subscriber, uint32_t topics);
+
+    void StreamLoop();
+
+    // Fetches the topic unless it is already being fetched; history goes through its cache
+    void Fetch(Topic topic);
+    static void FetchOnWorkerThread(Topic topic);
+    void OnFetched(Topic topic, const nlohmann::json& state);
+
+    // Refetches subscribed topics while the stream is down
+    void SchedulePoll();
+    void Poll();
+
+    std::map<int, Subscriber> subscribers_;
+    TopicState topics_[kTopicCount];
+
+    bool started_ = false;
+    bool streamConnected_ = false;
+    bool streamSupported_ = true;
+    uint64_t streamConnects_ = 0;
+    uint64_t polls_ = 0;
+
+    std::atomic<bool> running_{false};
+    // Wakes the stream thread from its reconnect delay when running_ goes false
+    std::mutex stopMutex_;
+    std::condition_variable stopped_;
+    // A shared_ptr so that code without WalletService's definition, such as the unit tests, can
+    // still construct and destroy this class
+    std::shared_ptr<WalletService> streamService_;
+    std::thread worker_;
+};
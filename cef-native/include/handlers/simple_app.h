@@ -39,6 +39,9 @@ public:
     void OnBeforeCommandLineProcessing(const CefString& process_type,
                                        CefRefPtr<CefCommandLine> command_line) override;
 
+    // Runs in every process; registers bitcoin-browser:// for the embedded frontend bundle
+    void OnRegisterCustomSchemes(CefRawPtr<CefSchemeRegistrar> registrar) override;
+
     void OnContextInitialized() override;
 
     void SetWindowHandles(HWND hwnd, HWND shell, HWND webview);
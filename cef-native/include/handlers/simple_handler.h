@@ -9,6 +9,9 @@
 #include "include/cef_resource_request_handler.h"
 #include "include/cef_context_menu_handler.h"
 #include "include/cef_keyboard_handler.h"
+#include "../core/MessageRouter.h"
+
+class WalletService;
 
 class SimpleHandler : public CefClient,
                       public CefLifeSpanHandler,
@@ -27,10 +30,10 @@ public:
     CefRefPtr<CefRequestHandler> GetRequestHandler() override;
     CefRefPtr<CefContextMenuHandler> GetContextMenuHandler() override;
     CefRefPtr<CefKeyboardHandler> GetKeyboardHandler() override;
-    static CefRefPtr<CefBrowser> webview_browser_;
     static CefRefPtr<CefBrowser> header_browser_;
     static CefRefPtr<CefBrowser> GetOverlayBrowser();
     static CefRefPtr<CefBrowser> GetHeaderBrowser();
+    // Active tab's browser (see TabManager)
     static CefRefPtr<CefBrowser> GetWebviewBrowser();
     static CefRefPtr<CefBrowser> GetSettingsBrowser();
     static CefRefPtr<CefBrowser> GetWalletBrowser();
@@ -40,8 +43,12 @@ public:
     static bool needs_overlay_reload_;
     static void TriggerDeferredPanel(const std::string& panel);
 
+    // Clears the static reference for an overlay role if it still points at this browser
+    static void ReleaseOverlayBrowser(const std::string& role, CefRefPtr<CefBrowser> browser);
+
     // CefDisplayHandler methods
     void OnTitleChange(CefRefPtr<CefBrowser> browser, const CefString& title) override;
+    void OnAddressChange(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, const CefString& url) override;
 
     // CefLoadHandler methods
     void OnLoadError(CefRefPtr<CefBrowser> browser,
@@ -56,6 +63,7 @@ public:
                                bool canGoForward) override;
 
     void OnAfterCreated(CefRefPtr<CefBrowser> browser) override;
+    void OnBeforeClose(CefRefPtr<CefBrowser> browser) override;
 
     bool OnProcessMessageReceived(CefRefPtr<CefBrowser> browser,
                               CefRefPtr<CefFrame> frame,
@@ -96,10 +104,27 @@ public:
 private:
     std::string role_;
     CefRefPtr<CefRenderHandler> render_handler_;
+    MessageRouter router_;
+    void RegisterMessageRoutes();
+
+    // Benchmark routes drive real browsers, so they answer only shell browsers of a shell started
+    // with --enable-benchmarks
+    bool BenchmarksAllowed(const std::string& route) const;
+    // Routes that expose the user's own data or the browser itself answer only the shell's views,
+    // never a page in a tab
+    bool ShellRoleAllowed(const std::string& route) const;
+    // Wallet calls from the shell's own views run as UI calls; a tab's run as its site's dApp calls
+    void ScheduleWalletCalls(WalletService& walletService, CefRefPtr<CefBrowser> browser) const;
     static CefRefPtr<CefBrowser> overlay_browser_;
     static CefRefPtr<CefBrowser> settings_browser_;
     static CefRefPtr<CefBrowser> wallet_browser_;
     static CefRefPtr<CefBrowser> backup_browser_;
     static CefRefPtr<CefBrowser> brc100_auth_browser_;
+
+    // Request id of the rpc_request currently being dispatched (0 for plain messages)
+    static int current_rpc_request_id_;
+    static bool rpc_response_sent_;
+    static void SendRendererResponse(CefRefPtr<CefBrowser> browser, CefRefPtr<CefProcessMessage> response);
+
     IMPLEMENT_REFCOUNTING(SimpleHandler);
 };
@@ -3,6 +3,7 @@
 
 #include "include/cef_render_process_handler.h"
 #include "include/cef_v8.h"
+#include "../core/MessageRouter.h"
 
 class SimpleRenderProcessHandler : public CefRenderProcessHandler {
 public:
@@ -13,6 +14,11 @@ public:
         CefRefPtr<CefFrame> frame,
         CefRefPtr<CefV8Context> context) override;
 
+    void OnContextReleased(
+        CefRefPtr<CefBrowser> browser,
+        CefRefPtr<CefFrame> frame,
+        CefRefPtr<CefV8Context> context) override;
+
     bool OnProcessMessageReceived(
         CefRefPtr<CefBrowser> browser,
         CefRefPtr<CefFrame> frame,
@@ -20,5 +26,12 @@ public:
         CefRefPtr<CefProcessMessage> message) override;
 
 private:
+    MessageRouter router_;
+    void RegisterMessageRoutes();
+
+    // Native binding cost per V8 context, for comparison against the old post-load injection
+    long long bindingInstalls_ = 0;
+    long long bindingMicrosTotal_ = 0;
+
     IMPLEMENT_REFCOUNTING(SimpleRenderProcessHandler);
 };
@@ -0,0 +1,506 @@
+#include "../../include/core/ActivityIndex.h"
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+namespace {
+    const int64_t kHourMs = 60ll * 60 * 1000;
+    const int32_t kHoursPerDay = 24;
+
+    const size_t kMaxDomains = 1 << 20;
+    const size_t kMaxRoutes = 4096;
+    const size_t kMaxNameLength = 1024;
+
+    // Time series in a domain query are bucketed to stay under this many points
+    const int32_t kMaxSeriesPoints = 200;
+
+    int32_t HourOf(int64_t timeMs) {
+        return static_cast<int32_t>((std::max)(timeMs, static_cast<int64_t>(0)) / kHourMs);
+    }
+
+    double AverageMs(uint64_t latencyMicros, uint64_t calls) {
+        return calls ? static_cast<double>(latencyMicros) / calls / 1000.0 : 0.0;
+    }
+
+    template <typename T>
+    void PutValue(std::string& out, const T& value) {
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    void PutArray(std::string& out, const std::vector<T>& values) {
+        PutValue(out, static_cast<uint32_t>(values.size()));
+        out.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    void PutName(std::string& out, const std::string& name) {
+        PutValue(out, static_cast<uint16_t>(name.size()));
+        out.append(name);
+    }
+
+    // Bounds-checked reader over a snapshot
+    class Reader {
+    public:
+        explicit Reader(const std::string& data) : data_(data) {}
+
+        template <typename T>
+        bool Get(T& value) {
+            if (data_.size() - offset_ < sizeof(T)) {
+                return false;
+            }
+            std::memcpy(&value, data_.data() + offset_, sizeof(T));
+            offset_ += sizeof(T);
+            return true;
+        }
+
+        template <typename T>
+        bool GetArray(std::vector<T>& values) {
+            uint32_t count = 0;
+            if (!Get(count) || (data_.size() - offset_) / sizeof(T) < count) {
+                return false;
+            }
+            values.resize(count);
+            std::memcpy(values.data(), data_.data() + offset_, count * sizeof(T));
+            offset_ += count * sizeof(T);
+            return true;
+        }
+
+        bool GetName(std::string& name) {
+            uint16_t length = 0;
+            if (!Get(length) || data_.size() - offset_ < length) {
+                return false;
+            }
+            name.assign(data_.data() + offset_, length);
+            offset_ += length;
+            return true;
+        }
+
+        bool AtEnd() const { return offset_ == data_.size(); }
+
+    private:
+        const std::string& data_;
+        size_t offset_ = 0;
+    };
+}
+
+bool ActivityIndex::InternDomain(const std::string& name, uint32_t& id) {
+    auto it = domainIds_.find(name);
+    if (it != domainIds_.end()) {
+        id = it->second;
+        return true;
+    }
+    if (domainNames_.size() >= kMaxDomains || name.size() > kMaxNameLength) {
+        return false;
+    }
+    id = static_cast<uint32_t>(domainNames_.size());
+    DefineDomain(id, name);
+    return true;
+}
+
+bool ActivityIndex::InternRoute(const std::string& name, uint16_t& id) {
+    auto it = routeIds_.find(name);
+    if (it != routeIds_.end()) {
+        id = it->second;
+        return true;
+    }
+    if (routeNames_.size() >= kMaxRoutes || name.size() > kMaxNameLength) {
+        return false;
+    }
+    id = static_cast<uint16_t>(routeNames_.size());
+    DefineRoute(id, name);
+    return true;
+}
+
+void ActivityIndex::DefineDomain(uint32_t id, const std::string& name) {
+    if (id >= kMaxDomains) {
+        return;
+    }
+    if (id >= domainNames_.size()) {
+        domainNames_.resize(id + 1);
+        domains_.resize(id + 1);
+    }
+    domainNames_[id] = name;
+    domainIds_[name] = id;
+}
+
+void ActivityIndex::DefineRoute(uint16_t id, const std::string& name) {
+    if (id >= kMaxRoutes) {
+        return;
+    }
+    if (id >= routeNames_.size()) {
+        routeNames_.resize(id + 1);
+    }
+    routeNames_[id] = name;
+    routeIds_[name] = id;
+}
+
+void ActivityIndex::Add(const Event& event) {
+    if (event.domain >= domains_.size() || event.route >= routeNames_.size()) {
+        return;
+    }
+    Domain& domain = domains_[event.domain];
+    domain.lastUsedMs = (std::max)(domain.lastUsedMs, event.timeMs);
+    eventCount_++;
+
+    int32_t hour = HourOf(event.timeMs);
+    if (hour < dailyBeforeHour_) {
+        hour -= hour % kHoursPerDay;
+    }
+    uint64_t error = event.outcome == kOk || event.outcome == kApproved ? 0 : 1;
+
+    // Events arrive in time order, so this is almost always an update of or append after the
+    // last hour; a late one shifts the running totals of every hour after it
+    auto hourIt = std::lower_bound(domain.hours.begin(), domain.hours.end(), hour,
+                                   [](const HourTotals& totals, int32_t h) { return totals.hour < h; });
+    if (hourIt == domain.hours.end() || hourIt->hour != hour) {
+        HourTotals totals;
+        if (hourIt != domain.hours.begin()) {
+            totals = *(hourIt - 1);
+        }
+        totals.hour = hour;
+        hourIt = domain.hours.insert(hourIt, totals);
+    }
+    for (auto it = hourIt; it != domain.hours.end(); ++it) {
+        it->calls++;
+        it->errors += error;
+        it->latencyMicros += event.latencyMicros;
+        it->bytesIn += event.bytesIn;
+        it->bytesOut += event.bytesOut;
+    }
+
+    auto bucketIt = std::lower_bound(domain.buckets.begin(), domain.buckets.end(), std::make_pair(hour, event.route),
+                                     [](const RouteBucket& bucket, const std::pair<int32_t, uint16_t>& key) {
+                                         return bucket.hour != key.first ? bucket.hour < key.first : bucket.route < key.second;
+                                     });
+    if (bucketIt == domain.buckets.end() || bucketIt->hour != hour || bucketIt->route != event.route) {
+        RouteBucket bucket;
+        bucket.hour = hour;
+        bucket.route = event.route;
+        bucketIt = domain.buckets.insert(bucketIt, bucket);
+    }
+    bucketIt->calls++;
+    bucketIt->errors += static_cast<uint32_t>(error);
+    bucketIt->latencyMicros += event.latencyMicros;
+    bucketIt->latencyMaxMicros = (std::max)(bucketIt->latencyMaxMicros, event.latencyMicros);
+    bucketIt->bytesIn += event.bytesIn;
+    bucketIt->bytesOut += event.bytesOut;
+}
+
+void ActivityIndex::Rollup(int64_t beforeMs) {
+    int32_t cutoff = HourOf(beforeMs);
+    cutoff -= cutoff % kHoursPerDay;
+    if (cutoff <= dailyBeforeHour_) {
+        return;
+    }
+
+    for (Domain& domain : domains_) {
+        // The last running total of each day already covers the whole day
+        auto first = std::lower_bound(domain.hours.begin(), domain.hours.end(), dailyBeforeHour_,
+                                      [](const HourTotals& totals, int32_t h) { return totals.hour < h; });
+        auto last = std::lower_bound(first, domain.hours.end(), cutoff,
+                                     [](const HourTotals& totals, int32_t h) { return totals.hour < h; });
+        auto out = first;
+        for (auto it = first; it != last; ++it) {
+            int32_t day = it->hour - it->hour % kHoursPerDay;
+            if (out != first && (out - 1)->hour == day) {
+                *(out - 1) = *it;
+            } else {
+                *out++ = *it;
+            }
+            (out - 1)->hour = day;
+        }
+        domain.hours.erase(out, last);
+
+        auto firstBucket = std::lower_bound(domain.buckets.begin(), domain.buckets.end(), dailyBeforeHour_,
+                                            [](const RouteBucket& bucket, int32_t h) { return bucket.hour < h; });
+        auto lastBucket = std::lower_bound(firstBucket, domain.buckets.end(), cutoff,
+                                           [](const RouteBucket& bucket, int32_t h) { return bucket.hour < h; });
+        for (auto it = firstBucket; it != lastBucket; ++it) {
+            it->hour -= it->hour % kHoursPerDay;
+        }
+        std::stable_sort(firstBucket, lastBucket, [](const RouteBucket& a, const RouteBucket& b) {
+            return a.hour != b.hour ? a.hour < b.hour : a.route < b.route;
+        });
+        auto outBucket = firstBucket;
+        for (auto it = firstBucket; it != lastBucket; ++it) {
+            if (outBucket != firstBucket && (outBucket - 1)->hour == it->hour && (outBucket - 1)->route == it->route) {
+                RouteBucket& merged = *(outBucket - 1);
+                merged.calls += it->calls;
+                merged.errors += it->errors;
+                merged.latencyMicros += it->latencyMicros;
+                merged.latencyMaxMicros = (std::max)(merged.latencyMaxMicros, it->latencyMaxMicros);
+                merged.bytesIn += it->bytesIn;
+                merged.bytesOut += it->bytesOut;
+            } else {
+                *outBucket++ = *it;
+            }
+        }
+        domain.buckets.erase(outBucket, lastBucket);
+
+        domain.hours.shrink_to_fit();
+        domain.buckets.shrink_to_fit();
+    }
+    dailyBeforeHour_ = cutoff;
+}
+
+void ActivityIndex::ResolveRange(int64_t fromMs, int64_t toMs, int32_t& fromHour, int32_t& toHour) const {
+    fromHour = HourOf(fromMs);
+    toHour = HourOf(toMs - 1) + 1;
+    if (fromHour < dailyBeforeHour_) {
+        fromHour -= fromHour % kHoursPerDay;
+    }
+    if (toHour < dailyBeforeHour_ && toHour % kHoursPerDay != 0) {
+        toHour += kHoursPerDay - toHour % kHoursPerDay;
+    }
+}
+
+ActivityIndex::HourTotals ActivityIndex::RangeTotals(const Domain& domain, int32_t fromHour, int32_t toHour) const {
+    auto before = [&domain](int32_t hour) -> const HourTotals* {
+        auto it = std::lower_bound(domain.hours.begin(), domain.hours.end(), hour,
+                                   [](const HourTotals& totals, int32_t h) { return totals.hour < h; });
+        return it == domain.hours.begin() ? nullptr : &*(it - 1);
+    };
+
+    HourTotals result;
+    const HourTotals* end = before(toHour);
+    if (!end) {
+        return result;
+    }
+    result = *end;
+    if (const HourTotals* start = before(fromHour)) {
+        result.calls -= start->calls;
+        result.errors -= start->errors;
+        result.latencyMicros -= start->latencyMicros;
+        result.bytesIn -= start->bytesIn;
+        result.bytesOut -= start->bytesOut;
+    }
+    return result;
+}
+
+nlohmann::json ActivityIndex::QueryDomains(int64_t fromMs, int64_t toMs, size_t limit) const {
+    int32_t fromHour = 0;
+    int32_t toHour = 0;
+    ResolveRange(fromMs, toMs, fromHour, toHour);
+
+    struct Row {
+        uint32_t domain;
+        HourTotals totals;
+    };
+    std::vector<Row> rows;
+    HourTotals total;
+    for (uint32_t id = 0; id < domains_.size(); id++) {
+        if (domains_[id].hours.empty()) {
+            continue;
+        }
+        HourTotals totals = RangeTotals(domains_[id], fromHour, toHour);
+        if (totals.calls == 0) {
+            continue;
+        }
+        total.calls += totals.calls;
+        total.errors += totals.errors;
+        total.latencyMicros += totals.latencyMicros;
+        total.bytesIn += totals.bytesIn;
+        total.bytesOut += totals.bytesOut;
+        rows.push_back({ id, totals });
+    }
+
+    size_t count = (std::min)(limit, rows.size());
+    std::partial_sort(rows.begin(), rows.begin() + count, rows.end(), [](const Row& a, const Row& b) {
+        return a.totals.calls > b.totals.calls;
+    });
+
+    nlohmann::json domains = nlohmann::json::array();
+    for (size_t i = 0; i < count; i++) {
+        const Row& row = rows[i];
+        domains.push_back({
+            {"domain", domainNames_[row.domain]},
+            {"calls", row.totals.calls},
+            {"errors", row.totals.errors},
+            {"avgLatencyMs", AverageMs(row.totals.latencyMicros, row.totals.calls)},
+            {"bytesIn", row.totals.bytesIn},
+            {"bytesOut", row.totals.bytesOut},
+            {"lastUsed", domains_[row.domain].lastUsedMs}
+        });
+    }
+
+    return {
+        {"from", static_cast<int64_t>(fromHour) * kHourMs},
+        {"to", static_cast<int64_t>(toHour) * kHourMs},
+        {"total", {
+            {"domains", rows.size()},
+            {"calls", total.calls},
+            {"errors", total.errors},
+            {"avgLatencyMs", AverageMs(total.latencyMicros, total.calls)},
+            {"bytesIn", total.bytesIn},
+            {"bytesOut", total.bytesOut}
+        }},
+        {"domains", domains}
+    };
+}
+
+nlohmann::json ActivityIndex::QueryDomain(const std::string& name, int64_t fromMs, int64_t toMs) const {
+    auto idIt = domainIds_.find(name);
+    if (idIt == domainIds_.end()) {
+        return nullptr;
+    }
+    const Domain& domain = domains_[idIt->second];
+
+    int32_t fromHour = 0;
+    int32_t toHour = 0;
+    ResolveRange(fromMs, toMs, fromHour, toHour);
+    HourTotals totals = RangeTotals(domain, fromHour, toHour);
+
+    std::map<uint16_t, RouteBucket> routes;
+    auto bucketIt = std::lower_bound(domain.buckets.begin(), domain.buckets.end(), fromHour,
+                                     [](const RouteBucket& bucket, int32_t h) { return bucket.hour < h; });
+    for (; bucketIt != domain.buckets.end() && bucketIt->hour < toHour; ++bucketIt) {
+        RouteBucket& route = routes[bucketIt->route];
+        route.calls += bucketIt->calls;
+        route.errors += bucketIt->errors;
+        route.latencyMicros += bucketIt->latencyMicros;
+        route.latencyMaxMicros = (std::max)(route.latencyMaxMicros, bucketIt->latencyMaxMicros);
+        route.bytesIn += bucketIt->bytesIn;
+        route.bytesOut += bucketIt->bytesOut;
+    }
+
+    nlohmann::json routeList = nlohmann::json::array();
+    for (const auto& entry : routes) {
+        const RouteBucket& route = entry.second;
+        routeList.push_back({
+            {"route", routeNames_[entry.first]},
+            {"calls", route.calls},
+            {"errors", route.errors},
+            {"avgLatencyMs", AverageMs(route.latencyMicros, route.calls)},
+            {"maxLatencyMs", route.latencyMaxMicros / 1000.0},
+            {"bytesIn", route.bytesIn},
+            {"bytesOut", route.bytesOut}
+        });
+    }
+    std::sort(routeList.begin(), routeList.end(), [](const nlohmann::json& a, const nlohmann::json& b) {
+        return a["calls"].get<uint64_t>() > b["calls"].get<uint64_t>();
+    });
+
+    // The series only spans hours the domain was active in, so an open-ended range stays cheap
+    nlohmann::json series = nlohmann::json::array();
+    int32_t bucketHours = 1;
+    if (!domain.hours.empty()) {
+        int32_t seriesFrom = (std::max)(fromHour, domain.hours.front().hour);
+        int32_t seriesTo = (std::min)(toHour, domain.hours.back().hour + 1);
+        int32_t span = seriesTo - seriesFrom;
+        for (int32_t candidate : { 1, 6, 24, 24 * 7 }) {
+            bucketHours = candidate;
+            if (span <= candidate * kMaxSeriesPoints) {
+                break;
+            }
+        }
+        bucketHours = (std::max)(bucketHours, (span + kMaxSeriesPoints - 1) / kMaxSeriesPoints);
+        if (seriesFrom < dailyBeforeHour_) {
+            // Merged days cannot be split, so points there are whole days
+            seriesFrom -= seriesFrom % kHoursPerDay;
+            bucketHours = (std::max)(bucketHours, kHoursPerDay);
+        }
+        for (int32_t hour = seriesFrom; hour < seriesTo; hour += bucketHours) {
+            HourTotals point = RangeTotals(domain, hour, (std::min)(hour + bucketHours, seriesTo));
+            series.push_back({
+                {"t", static_cast<int64_t>(hour) * kHourMs},
+                {"calls", point.calls},
+                {"errors", point.errors}
+            });
+        }
+    }
+
+    return {
+        {"domain", name},
+        {"from", static_cast<int64_t>(fromHour) * kHourMs},
+        {"to", static_cast<int64_t>(toHour) * kHourMs},
+        {"total", {
+            {"calls", totals.calls},
+            {"errors", totals.errors},
+            {"avgLatencyMs", AverageMs(totals.latencyMicros, totals.calls)},
+            {"bytesIn", totals.bytesIn},
+            {"bytesOut", totals.bytesOut}
+        }},
+        {"lastUsed", domain.lastUsedMs},
+        {"routes", routeList},
+        {"bucketMs", static_cast<int64_t>(bucketHours) * kHourMs},
+        {"series", series}
+    };
+}
+
+std::string ActivityIndex::Serialize() const {
+    std::string out;
+    PutValue(out, static_cast<uint32_t>(domainNames_.size()));
+    for (const std::string& name : domainNames_) {
+        PutName(out, name);
+    }
+    PutValue(out, static_cast<uint32_t>(routeNames_.size()));
+    for (const std::string& name : routeNames_) {
+        PutName(out, name);
+    }
+    PutValue(out, eventCount_);
+    PutValue(out, dailyBeforeHour_);
+    for (const Domain& domain : domains_) {
+        PutValue(out, domain.lastUsedMs);
+        PutArray(out, domain.hours);
+        PutArray(out, domain.buckets);
+    }
+    return out;
+}
+
+bool ActivityIndex::Restore(const std::string& data) {
+    Reader reader(data);
+    ActivityIndex restored;
+
+    uint32_t domainCount = 0;
+    if (!reader.Get(domainCount) || domainCount > kMaxDomains) {
+        return false;
+    }
+    for (uint32_t id = 0; id < domainCount; id++) {
+        std::string name;
+        if (!reader.GetName(name)) {
+            return false;
+        }
+        restored.DefineDomain(id, name);
+    }
+
+    uint32_t routeCount = 0;
+    if (!reader.Get(routeCount) || routeCount > kMaxRoutes) {
+        return false;
+    }
+    for (uint32_t id = 0; id < routeCount; id++) {
+        std::string name;
+        if (!reader.GetName(name)) {
+            return false;
+        }
+        restored.DefineRoute(static_cast<uint16_t>(id), name);
+    }
+
+    if (!reader.Get(restored.eventCount_) || !reader.Get(restored.dailyBeforeHour_)) {
+        return false;
+    }
+    for (Domain& domain : restored.domains_) {
+        if (!reader.Get(domain.lastUsedMs) || !reader.GetArray(domain.hours) || !reader.GetArray(domain.buckets)) {
+            return false;
+        }
+    }
+    if (!reader.AtEnd()) {
+        return false;
+    }
+
+    *this = std::move(restored);
+    return true;
+}
+
+size_t ActivityIndex::MemoryBytes() const {
+    size_t bytes = domains_.capacity() * sizeof(Domain);
+    for (const Domain& domain : domains_) {
+        bytes += domain.hours.capacity() * sizeof(HourTotals) + domain.buckets.capacity() * sizeof(RouteBucket);
+    }
+    for (const std::string& name : domainNames_) {
+        bytes += name.capacity() + sizeof(std::string) + sizeof(uint32_t);
+    }
+    for (const std::string& name : routeNames_) {
+        bytes += name.capacity() + sizeof(std::string) + sizeof(uint16_t);
+    }
+    return bytes;
+}
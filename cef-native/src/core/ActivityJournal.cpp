@@ -0,0 +1,525 @@
+#include "../../include/core/ActivityJournal.h"
+#include "../../include/core/ProfileCache.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+#include "include/base/cef_bind.h"
+#include <windows.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+#define LOG_DEBUG_BROWSER(msg) Logger::Log(msg, 0, 2)
+#define LOG_INFO_BROWSER(msg) Logger::Log(msg, 1, 2)
+#define LOG_WARNING_BROWSER(msg) Logger::Log(msg, 2, 2)
+
+namespace fs = std::filesystem;
+
+namespace {
+    const char kJournalMagic[8] = { 'B', 'B', 'A', 'C', 'T', 'J', '0', '1' };
+    const char kSnapshotMagic[8] = { 'B', 'B', 'R', 'O', 'L', 'L', '0', '1' };
+
+    enum RecordType : uint8_t {
+        // Name records assign an id before the first event that uses it
+        kDomainRecord = 1,
+        kRouteRecord = 2,
+        kEventRecord = 3
+    };
+
+#pragma pack(push, 1)
+    struct NameRecord {
+        uint8_t type;
+        uint8_t reserved;
+        uint16_t length;
+        uint32_t id;
+    };
+
+    struct EventRecord {
+        uint8_t type;
+        uint8_t outcome;
+        uint16_t route;
+        uint32_t domain;
+        int64_t timeMs;
+        uint32_t latencyMicros;
+        uint32_t bytesIn;
+        uint32_t bytesOut;
+    };
+
+    struct SnapshotHeader {
+        char magic[8];
+        uint64_t journalBytes;   // journal length the rollups cover
+        uint64_t payloadBytes;
+    };
+#pragma pack(pop)
+
+    // Records are batched for this long before being handed to the file thread
+    const long long kFlushDelayMs = 1000;
+
+    // Rollups are snapshotted after this many new calls, bounding the journal replayed at startup
+    const uint64_t kSnapshotEvents = 50000;
+
+    // Calls older than this are only kept per day
+    const int64_t kHourlyRetentionMs = 7ll * 24 * 60 * 60 * 1000;
+
+    const int64_t kDefaultRangeMs = 30ll * 24 * 60 * 60 * 1000;
+    const size_t kDefaultDomainLimit = 50;
+    const size_t kMaxDomainLimit = 500;
+    const size_t kRecentQuerySamples = 256;
+
+    // File thread only
+    HANDLE g_activityLog = INVALID_HANDLE_VALUE;
+
+    int64_t NowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    std::string EncodeName(uint8_t type, uint32_t id, const std::string& name) {
+        NameRecord record = { type, 0, static_cast<uint16_t>(name.size()), id };
+        std::string data(reinterpret_cast<const char*>(&record), sizeof(record));
+        data.append(name);
+        return data;
+    }
+
+    std::string EncodeEvent(const ActivityIndex::Event& event) {
+        EventRecord record = {
+            kEventRecord, event.outcome, event.route, event.domain,
+            event.timeMs, event.latencyMicros, event.bytesIn, event.bytesOut
+        };
+        return std::string(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+
+    bool WriteAll(HANDLE file, const std::string& data) {
+        DWORD written = 0;
+        return WriteFile(file, data.data(), static_cast<DWORD>(data.size()), &written, nullptr) &&
+               written == data.size();
+    }
+
+    // Replays records from offset; returns the offset just past the last intact record
+    uint64_t ReplayJournal(const char* data, uint64_t size, uint64_t offset, ActivityIndex& index, uint64_t& events) {
+        while (offset < size) {
+            uint8_t type = static_cast<uint8_t>(data[offset]);
+            if (type == kEventRecord) {
+                if (offset + sizeof(EventRecord) > size) {
+                    break;
+                }
+                EventRecord record;
+                std::memcpy(&record, data + offset, sizeof(record));
+                if (record.domain >= index.DomainCount() || record.route >= index.RouteCount()) {
+                    break;
+                }
+                ActivityIndex::Event event;
+                event.domain = record.domain;
+                event.route = record.route;
+                event.outcome = record.outcome;
+                event.timeMs = record.timeMs;
+                event.latencyMicros = record.latencyMicros;
+                event.bytesIn = record.bytesIn;
+                event.bytesOut = record.bytesOut;
+                index.Add(event);
+                offset += sizeof(record);
+                events++;
+            } else if (type == kDomainRecord || type == kRouteRecord) {
+                if (offset + sizeof(NameRecord) > size) {
+                    break;
+                }
+                NameRecord record;
+                std::memcpy(&record, data + offset, sizeof(record));
+                uint64_t length = sizeof(record) + record.length;
+                if (record.length == 0 || offset + length > size) {
+                    break;
+                }
+                std::string name(data + offset + sizeof(record), record.length);
+                if (type == kDomainRecord) {
+                    index.DefineDomain(record.id, name);
+                } else {
+                    index.DefineRoute(static_cast<uint16_t>(record.id), name);
+                }
+                offset += length;
+            } else {
+                break;
+            }
+        }
+        return offset;
+    }
+
+    // Restores rollups.bin into index if it is intact and covers no more than the journal holds
+    bool RestoreSnapshot(const fs::path& path, uint64_t journalSize, ActivityIndex& index, uint64_t& journalBytes) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+        std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        SnapshotHeader header;
+        if (data.size() < sizeof(header)) {
+            return false;
+        }
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ||
+            header.payloadBytes != data.size() - sizeof(header) ||
+            header.journalBytes < sizeof(kJournalMagic) || header.journalBytes > journalSize) {
+            return false;
+        }
+        if (!index.Restore(data.substr(sizeof(header)))) {
+            return false;
+        }
+        journalBytes = header.journalBytes;
+        return true;
+    }
+
+    // File thread: the journal is flushed first so a snapshot never claims records the disk lacks
+    void WriteSnapshot(const std::wstring& directory, const std::string& payload, uint64_t journalBytes) {
+        if (g_activityLog == INVALID_HANDLE_VALUE) {
+            return;
+        }
+        FlushFileBuffers(g_activityLog);
+
+        std::wstring path = (fs::path(directory) / L"rollups.bin").wstring();
+        std::wstring tempPath = path + L".tmp";
+        HANDLE temp = CreateFileW(tempPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (temp == INVALID_HANDLE_VALUE) {
+            return;
+        }
+
+        SnapshotHeader header;
+        std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+        header.journalBytes = journalBytes;
+        header.payloadBytes = payload.size();
+        bool ok = WriteAll(temp, std::string(reinterpret_cast<const char*>(&header), sizeof(header))) &&
+                  WriteAll(temp, payload) && FlushFileBuffers(temp);
+        CloseHandle(temp);
+        if (!ok || !MoveFileExW(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+            DeleteFileW(tempPath.c_str());
+        }
+    }
+
+    // Collapses path segments that look like ids (numbers, hashes, txids) so each route stays one row
+    bool IsIdSegment(const std::string& segment) {
+        if (segment.empty()) {
+            return false;
+        }
+        bool digits = std::all_of(segment.begin(), segment.end(), [](char c) {
+            return std::isdigit(static_cast<unsigned char>(c)) != 0;
+        });
+        if (digits) {
+            return true;
+        }
+        bool token = std::all_of(segment.begin(), segment.end(), [](char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_';
+        });
+        bool hasDigit = std::any_of(segment.begin(), segment.end(), [](char c) {
+            return std::isdigit(static_cast<unsigned char>(c)) != 0;
+        });
+        return segment.size() >= 16 && token && hasDigit;
+    }
+
+    double PercentileMicros(std::vector<double> samples, double p) {
+        if (samples.empty()) {
+            return 0.0;
+        }
+        size_t index = static_cast<size_t>(p * (samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return samples[index];
+    }
+}
+
+ActivityJournal& ActivityJournal::GetInstance() {
+    static ActivityJournal instance;
+    return instance;
+}
+
+std::string ActivityJournal::RouteOf(const std::string& method, const std::string& endpoint) {
+    std::string path = endpoint.substr(0, endpoint.find_first_of("?#"));
+    std::string route = method + " ";
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t end = path.find('/', start);
+        if (end == std::string::npos) {
+            end = path.size();
+        }
+        std::string segment = path.substr(start, end - start);
+        route += IsIdSegment(segment) ? ":id" : segment;
+        if (end < path.size()) {
+            route += '/';
+        }
+        start = end + 1;
+    }
+    return route;
+}
+
+void ActivityJournal::Start() {
+    CEF_REQUIRE_UI_THREAD();
+    if (started_) {
+        return;
+    }
+    started_ = true;
+
+    const std::wstring& root = ProfileCache::GetInstance().GetRootPath();
+    if (root.empty()) {
+        index_.reset(new ActivityIndex());
+        load_.ok = true;
+        LOG_INFO_BROWSER("🧾 No persistent profile; wallet activity is kept for this session only");
+        return;
+    }
+
+    persistent_ = true;
+    directory_ = (fs::path(root) / L"Activity").wstring();
+    CefPostTask(TID_FILE_BACKGROUND, base::BindOnce(&ActivityJournal::LoadOnFileThread, directory_));
+}
+
+void ActivityJournal::LoadOnFileThread(std::wstring directory) {
+    auto started = std::chrono::steady_clock::now();
+    ActivityIndex* index = new ActivityIndex();
+    LoadResult result;
+
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    std::wstring path = (fs::path(directory) / L"journal.log").wstring();
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                              OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER size = {};
+    if (file != INVALID_HANDLE_VALUE && GetFileSizeEx(file, &size)) {
+        uint64_t fileSize = static_cast<uint64_t>(size.QuadPart);
+        uint64_t validEnd = 0;
+
+        if (fileSize >= sizeof(kJournalMagic)) {
+            HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            const char* view = mapping ? static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+            if (view && std::memcmp(view, kJournalMagic, sizeof(kJournalMagic)) == 0) {
+                uint64_t replayFrom = sizeof(kJournalMagic);
+                result.fromSnapshot = RestoreSnapshot(fs::path(directory) / L"rollups.bin", fileSize, *index, replayFrom);
+                validEnd = ReplayJournal(view, fileSize, replayFrom, *index, result.replayedEvents);
+                index->Rollup(NowMs() - kHourlyRetentionMs);
+            }
+            if (view) {
+                UnmapViewOfFile(view);
+            }
+            if (mapping) {
+                CloseHandle(mapping);
+            }
+        }
+
+        // Drops a batch torn by a crash mid-write, or starts over on a foreign file
+        if (validEnd < fileSize) {
+            LARGE_INTEGER position;
+            position.QuadPart = static_cast<LONGLONG>(validEnd);
+            SetFilePointerEx(file, position, nullptr, FILE_BEGIN);
+            SetEndOfFile(file);
+            result.truncatedBytes = fileSize - validEnd;
+        }
+        if (validEnd == 0) {
+            WriteAll(file, std::string(kJournalMagic, sizeof(kJournalMagic)));
+            validEnd = sizeof(kJournalMagic);
+        }
+        result.journalBytes = validEnd;
+
+        LARGE_INTEGER zero = {};
+        SetFilePointerEx(file, zero, nullptr, FILE_END);
+        result.ok = true;
+    }
+
+    g_activityLog = file;
+    result.loadMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started).count();
+
+    CefPostTask(TID_UI, base::BindOnce([](ActivityIndex* loaded, LoadResult loadResult) {
+        ActivityJournal::GetInstance().OnLoaded(loaded, loadResult);
+    }, index, result));
+}
+
+void ActivityJournal::OnLoaded(ActivityIndex* index, const LoadResult& result) {
+    index_.reset(index);
+    load_ = result;
+    journalBytes_ = result.journalBytes;
+    if (!result.ok) {
+        persistent_ = false;
+        LOG_WARNING_BROWSER("⚠️ Wallet activity journal could not be opened; new calls will not be saved");
+    }
+
+    for (const QueuedEvent& queued : queued_) {
+        Apply(queued);
+    }
+    queued_.clear();
+
+    // A long replay means the snapshot is stale; the next flush writes a fresh one
+    eventsSinceSnapshot_ += result.replayedEvents;
+    if (persistent_ && eventsSinceSnapshot_ >= kSnapshotEvents) {
+        ScheduleFlush();
+    }
+
+    LOG_INFO_BROWSER("🧾 Wallet activity loaded: " + std::to_string(index_->EventCount()) + " calls from " +
+                     std::to_string(index_->DomainCount()) + " sites in " + std::to_string(result.loadMs) + " ms" +
+                     (result.fromSnapshot ? ", " + std::to_string(result.replayedEvents) + " replayed after snapshot" : "") +
+                     (result.truncatedBytes ? ", dropped " + std::to_string(result.truncatedBytes) + " torn bytes" : ""));
+}
+
+void ActivityJournal::Record(const std::string& domain, const std::string& method, const std::string& endpoint,
+                             int64_t startedMs, uint32_t latencyMicros, uint32_t bytesIn, uint32_t bytesOut,
+                             ActivityIndex::Outcome outcome) {
+    if (!CefCurrentlyOn(TID_UI)) {
+        CefPostTask(TID_UI, base::BindOnce([](std::string d, std::string m, std::string e, int64_t s,
+                                              uint32_t l, uint32_t in, uint32_t out, ActivityIndex::Outcome o) {
+            ActivityJournal::GetInstance().Record(d, m, e, s, l, in, out, o);
+        }, domain, method, endpoint, startedMs, latencyMicros, bytesIn, bytesOut, outcome));
+        return;
+    }
+    if (!started_ || domain.empty()) {
+        return;
+    }
+
+    QueuedEvent queued;
+    queued.domain = domain;
+    queued.route = RouteOf(method, endpoint);
+    queued.event.outcome = outcome;
+    queued.event.timeMs = startedMs;
+    queued.event.latencyMicros = latencyMicros;
+    queued.event.bytesIn = bytesIn;
+    queued.event.bytesOut = bytesOut;
+    eventsRecorded_++;
+
+    if (index_) {
+        Apply(queued);
+    } else {
+        queued_.push_back(queued);
+    }
+}
+
+void ActivityJournal::Apply(const QueuedEvent& queued) {
+    ActivityIndex::Event event = queued.event;
+    size_t domainsBefore = index_->DomainCount();
+    size_t routesBefore = index_->RouteCount();
+    if (!index_->InternDomain(queued.domain, event.domain) || !index_->InternRoute(queued.route, event.route)) {
+        eventsDropped_++;
+        return;
+    }
+
+    if (persistent_) {
+        if (index_->DomainCount() > domainsBefore) {
+            writeBuffer_ += EncodeName(kDomainRecord, event.domain, queued.domain);
+        }
+        if (index_->RouteCount() > routesBefore) {
+            writeBuffer_ += EncodeName(kRouteRecord, event.route, queued.route);
+        }
+        writeBuffer_ += EncodeEvent(event);
+        ScheduleFlush();
+    }
+    index_->Add(event);
+    eventsSinceSnapshot_++;
+}
+
+void ActivityJournal::ScheduleFlush() {
+    if (flushScheduled_) {
+        return;
+    }
+    flushScheduled_ = true;
+    CefPostDelayedTask(TID_UI, base::BindOnce([]() {
+        ActivityJournal::GetInstance().Flush();
+    }), kFlushDelayMs);
+}
+
+void ActivityJournal::Flush() {
+    CEF_REQUIRE_UI_THREAD();
+    flushScheduled_ = false;
+
+    if (!writeBuffer_.empty()) {
+        journalBytes_ += writeBuffer_.size();
+        // Same sequenced thread as the load, so batches land after the replayed journal
+        CefPostTask(TID_FILE_BACKGROUND, base::BindOnce([](std::string data) {
+            if (g_activityLog != INVALID_HANDLE_VALUE) {
+                WriteAll(g_activityLog, data);
+            }
+        }, std::move(writeBuffer_)));
+        writeBuffer_.clear();
+    }
+
+    if (eventsSinceSnapshot_ >= kSnapshotEvents) {
+        index_->Rollup(NowMs() - kHourlyRetentionMs);
+        std::string payload = index_->Serialize();
+        lastSnapshotBytes_ = payload.size();
+        eventsSinceSnapshot_ = 0;
+        snapshots_++;
+        CefPostTask(TID_FILE_BACKGROUND, base::BindOnce([](std::wstring directory, std::string data, uint64_t covered) {
+            WriteSnapshot(directory, data, covered);
+        }, directory_, std::move(payload), journalBytes_));
+    }
+}
+
+nlohmann::json ActivityJournal::Query(const nlohmann::json& request) {
+    CEF_REQUIRE_UI_THREAD();
+    if (!index_) {
+        return {{"loading", true}};
+    }
+
+    int64_t nowMs = NowMs();
+    std::string domain;
+    int64_t fromMs = nowMs - kDefaultRangeMs;
+    int64_t toMs = nowMs;
+    size_t limit = kDefaultDomainLimit;
+    // The query comes from a renderer: a field of the wrong type keeps its default rather than throwing
+    if (request.is_object()) {
+        if (request.contains("domain") && request["domain"].is_string()) {
+            domain = request["domain"].get<std::string>();
+        }
+        if (request.contains("from") && request["from"].is_number_integer()) {
+            fromMs = (std::min)(request["from"].get<int64_t>(), nowMs);
+        }
+        if (request.contains("to") && request["to"].is_number_integer()) {
+            toMs = request["to"].get<int64_t>();
+        }
+        if (request.contains("limit") && request["limit"].is_number_unsigned()) {
+            limit = (std::min)(request["limit"].get<size_t>(), kMaxDomainLimit);
+        }
+    }
+    toMs = (std::max)(toMs, fromMs + 1);
+
+    auto start = std::chrono::steady_clock::now();
+    nlohmann::json result = domain.empty() ? index_->QueryDomains(fromMs, toMs, limit)
+                                           : index_->QueryDomain(domain, fromMs, toMs);
+    double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    queries_++;
+    queryMaxMicros_ = (std::max)(queryMaxMicros_, micros);
+    if (recentQueryMicros_.size() < kRecentQuerySamples) {
+        recentQueryMicros_.push_back(micros);
+    } else {
+        recentQueryMicros_[recentQueryNext_] = micros;
+        recentQueryNext_ = (recentQueryNext_ + 1) % kRecentQuerySamples;
+    }
+    return result;
+}
+
+nlohmann::json ActivityJournal::GetStats() const {
+    return {
+        {"loaded", index_ != nullptr},
+        {"persistent", persistent_},
+        {"directory", fs::path(directory_).u8string()},
+        {"calls", index_ ? index_->EventCount() : 0},
+        {"sites", index_ ? index_->DomainCount() : 0},
+        {"indexBytes", index_ ? index_->MemoryBytes() : 0},
+        {"journalBytes", journalBytes_},
+        {"pendingWriteBytes", writeBuffer_.size()},
+        {"loadMs", load_.loadMs},
+        {"loadedFromSnapshot", load_.fromSnapshot},
+        {"replayedAtLoad", load_.replayedEvents},
+        {"truncatedBytes", load_.truncatedBytes},
+        {"snapshots", snapshots_},
+        {"lastSnapshotBytes", lastSnapshotBytes_},
+        {"callsRecorded", eventsRecorded_},
+        {"callsDropped", eventsDropped_},
+        {"queries", queries_},
+        {"p50QueryMicros", PercentileMicros(recentQueryMicros_, 0.5)},
+        {"p95QueryMicros", PercentileMicros(recentQueryMicros_, 0.95)},
+        {"maxQueryMicros", queryMaxMicros_}
+    };
+}
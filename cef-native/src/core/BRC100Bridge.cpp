@@ -89,6 +89,21 @@ void BRC100Bridge::setBaseUrl(const std::string& url) {
 }
 
 nlohmann::json BRC100Bridge::makeHttpRequest(const std::string& method, const std::string& endpoint, const nlohmann::json& body) {
+    // Over the daemon's local socket when it is up; a POST that got lost there is not sent twice
+    int status = 0;
+    std::string socketResponse;
+    DaemonSocket::Result viaSocket = socket_.Request(method, endpoint, method == "GET" ? "" : body.dump(), status, socketResponse);
+    if (viaSocket == DaemonSocket::Result::Ok) {
+        try {
+            return nlohmann::json::parse(socketResponse);
+        } catch (const std::exception& e) {
+            return nlohmann::json{{"error", "Invalid JSON response: " + std::string(e.what())}};
+        }
+    }
+    if (viaSocket == DaemonSocket::Result::Failed && method != "GET") {
+        return nlohmann::json{{"error", "Failed to receive response"}};
+    }
+
     if (!isConnected()) {
         return nlohmann::json{{"error", "Not connected to server"}};
     }
@@ -135,6 +150,7 @@ nlohmann::json BRC100Bridge::makeHttpRequest(const std::string& method, const st
     // Read response
     std::string response = readResponse(hRequest);
     WinHttpCloseHandle(hRequest);
+    DaemonTransport::GetInstance().RecordTcpRequest();
 
     try {
         return nlohmann::json::parse(response);
@@ -1,9 +1,25 @@
 #include "BRC100Handler.h"
 #include "BRC100Bridge.h"
+#include "Encoding.h"
+#include "V8JsonConverter.h"
+#include "BRC100SessionTable.h"
 #include "include/cef_v8.h"
 #include <iostream>
 #include <sstream>
 
+namespace {
+    // Ceiling on how long a renderer trusts a session it holds, should a browser push go missing
+    const int64_t kSessionCacheMaxAgeMs = 60000;
+
+    std::string SessionIdOf(const nlohmann::json& data) {
+        auto sessionId = data.is_object() ? data.find("sessionId") : data.end();
+        return sessionId != data.end() && sessionId->is_string() ? sessionId->get<std::string>() : "";
+    }
+}
+
+std::map<std::string, BRC100Handler::CachedSession> BRC100Handler::sessionCache_;
+bool BRC100Handler::sessionCacheLive_ = false;
+
 BRC100Handler::BRC100Handler() {
     bridge_ = std::make_unique<BRC100Bridge>();
 }
@@ -11,6 +27,38 @@ BRC100Handler::BRC100Handler() {
 BRC100Handler::~BRC100Handler() {
 }
 
+void BRC100Handler::UpdateSessionCache(const nlohmann::json& update) {
+    sessionCacheLive_ = update.value("live", false);
+    if (!sessionCacheLive_) {
+        sessionCache_.clear();
+        return;
+    }
+    if (update.contains("drop") && update["drop"].is_array()) {
+        for (const auto& sessionId : update["drop"]) {
+            if (sessionId.is_string()) {
+                sessionCache_.erase(sessionId.get<std::string>());
+            }
+        }
+    }
+}
+
+bool BRC100Handler::CanCacheSessions() {
+    if (!sessionCacheLive_) {
+        return false;
+    }
+    CefRefPtr<CefV8Context> context = CefV8Context::GetCurrentContext();
+    return context && context->GetFrame() && context->GetFrame()->IsMain();
+}
+
+void BRC100Handler::CacheSession(const nlohmann::json& session) {
+    std::string sessionId = SessionIdOf(session);
+    int64_t expiresAtMs = BRC100SessionTable::ExpiresAtMs(session);
+    if (sessionId.empty() || expiresAtMs == 0 || !CanCacheSessions()) {
+        return;
+    }
+    sessionCache_[sessionId] = CachedSession{session, expiresAtMs, BRC100SessionTable::NowMs()};
+}
+
 bool BRC100Handler::Execute(const CefString& name,
                            CefRefPtr<CefV8Value> object,
                            const CefV8ValueList& arguments,
@@ -109,7 +157,7 @@ void BRC100Handler::RegisterBRC100API(CefRefPtr<CefV8Context> context) {
 bool BRC100Handler::HandleStatus(CefRefPtr<CefV8Value> object, const CefV8ValueList& arguments, CefRefPtr<CefV8Value>& retval, CefString& exception) {
     try {
         auto response = bridge_->getStatus();
-        retval = JSONToV8Value(response);
+        retval = V8Json::toV8(response);
         return true;
     } catch (const std::exception& e) {
         exception = "Status request failed: " + std::string(e.what());
@@ -136,9 +184,9 @@ bool BRC100Handler::HandleGenerateIdentity(CefRefPtr<CefV8Value> object, const C
     }
 
     try {
-        auto identityData = V8ValueToJSON(arguments[0]);
+        auto identityData = V8Json::fromV8(arguments[0]);
         auto response = bridge_->generateIdentity(identityData);
-        retval = JSONToV8Value(response);
+        retval = V8Json::toV8(response);
         return true;
     } catch (const std::exception& e) {
         exception = "Identity generation failed: " + std::string(e.what());
@@ -153,9 +201,9 @@ bool BRC100Handler::HandleValidateIdentity(CefRefPtr<CefV8Value> object, const C
     }
 
     try {
-        auto identityData = V8ValueToJSON(arguments[0]);
+        auto identityData = V8Json::fromV8(arguments[0]);
         auto response = bridge_->validateIdentity(identityData);
-        retval = JSONToV8Value(response);
+        retval = V8Json::toV8(response);
         return true;
     } catch (const std::exception& e) {
         exception = "Identity validation failed: " + std::string(e.what());
@@ -170,9 +218,9 @@ bool BRC100Handler::HandleSelectiveDisclosure(CefRefPtr<CefV8Value> object, cons
     }
 
     try {
-        auto disclosureData = V8ValueToJSON(arguments[0]);
+        auto disclosureData = V8Json::fromV8(arguments[0]);
         auto response = bridge_->createSelectiveDisclosure(disclosureData);
-        retval = JSONToV8Value(response);
+        retval = V8Json::toV8(response);
         return true;
     } catch (const std::exception& e) {
         exception = "Selective disclosure creation failed: " + std::string(e.what());
@@ -188,9 +236,9 @@ bool BRC100Handler::HandleGenerateChallenge(CefRefPtr<CefV8Value> object, const
     }
 
     try {
-        auto challengeData = V8ValueToJSON(arguments[0]);
+        auto challengeData = V8Json::fromV8(arguments[0]);
         auto response = bridge_->generateChallenge(challengeData);
-        retval = JSONToV8Value(response);
+        retval = V8Json::toV8(response);
         return true;
     } catch (const std::exception& e) {
         exception = "Challenge generation failed: " + std::string(e.what());
@@ -205,9 +253,9 @@ bool BRC100Handler::HandleAuthenticate(CefRefPtr<CefV8Value> object, const CefV8
     }
 
     try {
-        auto authData = V8ValueToJSON(arguments[0]);
+        auto authData = V8Json::fromV8(arguments[0]);
         auto response = bridge_->authenticate(authData);
-        retval = JSONToV8Value(response);
+        retval = V8Json::toV8(response);
         return true;
     } catch (const std::exception& e) {
         exception = "Authentication failed: " + std::string(e.what());
@@ -222,9 +270,9 @@ bool BRC100Handler::HandleDeriveType42Keys(CefRefPtr<CefV8Value> object, const C
     }
 
     try {
-        auto keyData = V8ValueToJSON(arguments[0]);
+        auto keyData = V8Json::fromV8(arguments[0]);
         auto response = bridge_->deriveType42Keys(keyData);
-        retval = JSONToV8Value(response);
+        retval = V8Json::toV8(response);
         return true;
     } catch (const std::exception& e) {
         exception = "Type-42 key derivation failed: " + std::string(e.what());
@@ -240,9 +288,12 @@ bool BRC100Handler::HandleCreateSession(CefRefPtr<CefV8Value> object, const CefV
     }
 
     try {
-        auto sessionData = V8ValueToJSON(arguments[0]);
+        auto sessionData = V8Json::fromV8(arguments[0]);
         auto response = bridge_->createSession(sessionData);
-        retval = JSONToV8Value(response);
+        if (response.value("success", false) && response.contains("data") && response["data"].contains("session")) {
+            CacheSession(response["data"]["session"]);
+        }
+        retval = V8Json::toV8(response);
         return true;
     } catch (const std::exception& e) {
         exception = "Session creation failed: " + std::string(e.what());
@@ -257,9 +308,28 @@ bool BRC100Handler::HandleValidateSession(CefRefPtr<CefV8Value> object, const Ce
     }
 
     try {
-        auto sessionData = V8ValueToJSON(arguments[0]);
+        auto sessionData = V8Json::fromV8(arguments[0]);
+        std::string sessionId = SessionIdOf(sessionData);
+
+        auto cached = sessionCache_.find(sessionId);
+        if (cached != sessionCache_.end()) {
+            int64_t nowMs = BRC100SessionTable::NowMs();
+            if (CanCacheSessions() && cached->second.expiresAtMs > nowMs &&
+                nowMs - cached->second.cachedAtMs < kSessionCacheMaxAgeMs) {
+                retval = V8Json::toV8(nlohmann::json{
+                    {"success", true},
+                    {"data", {{"valid", true}, {"session", cached->second.session}}}
+                });
+                return true;
+            }
+            sessionCache_.erase(cached);
+        }
+
         auto response = bridge_->validateSession(sessionData);
-        retval = JSONToV8Value(response);
+        if (response.value("success", false) && response.contains("data") && response["data"].contains("session")) {
+            CacheSession(response["data"]["session"]);
+        }
+        retval = V8Json::toV8(response);
         return true;
     } catch (const std::exception& e) {
         exception = "Session validation failed: " + std::string(e.what());
@@ -274,9 +344,10 @@ bool BRC100Handler::HandleRevokeSession(CefRefPtr<CefV8Value> object, const CefV
     }
 
     try {
-        auto sessionData = V8ValueToJSON(arguments[0]);
+        auto sessionData = V8Json::fromV8(arguments[0]);
+        sessionCache_.erase(SessionIdOf(sessionData));
         auto response = bridge_->revokeSession(sessionData);
-        retval = JSONToV8Value(response);
+        retval = V8Json::toV8(response);
         return true;
     } catch (const std::exception& e) {
         exception = "Session revocation failed: " + std::string(e.what());
@@ -292,9 +363,9 @@ bool BRC100Handler::HandleCreateBEEF(CefRefPtr<CefV8Value> object, const CefV8Va
     }
 
     try {
-        auto beefData = V8ValueToJSON(arguments[0]);
+        auto beefData = V8Json::fromV8(arguments[0]);
         auto response = bridge_->createBEEF(beefData);
-        retval = JSONToV8Value(response);
+        retval = V8Json::toV8(response);
         return true;
     } catch (const std::exception& e) {
         exception = "BEEF creation failed: " + std::string(e.what());
@@ -309,9 +380,14 @@ bool BRC100Handler::HandleVerifyBEEF(CefRefPtr<CefV8Value> object, const CefV8Va
     }
 
     try {
-        auto beefData = V8ValueToJSON(arguments[0]);
+        auto beefData = V8Json::fromV8(arguments[0]);
+        std::string validationError;
+        if (!ValidateBEEFPayload(beefData, validationError)) {
+            exception = "BEEF verification failed: " + validationError;
+            return false;
+        }
         auto response = bridge_->verifyBEEF(beefData);
-        retval = JSONToV8Value(response);
+        retval = V8Json::toV8(response);
         return true;
     } catch (const std::exception& e) {
         exception = "BEEF verification failed: " + std::string(e.what());
@@ -326,9 +402,14 @@ bool BRC100Handler::HandleBroadcastBEEF(CefRefPtr<CefV8Value> object, const CefV
     }
 
     try {
-        auto beefData = V8ValueToJSON(arguments[0]);
+        auto beefData = V8Json::fromV8(arguments[0]);
+        std::string validationError;
+        if (!ValidateBEEFPayload(beefData, validationError)) {
+            exception = "BEEF broadcast failed: " + validationError;
+            return false;
+        }
         auto response = bridge_->broadcastBEEF(beefData);
-        retval = JSONToV8Value(response);
+        retval = V8Json::toV8(response);
         return true;
     } catch (const std::exception& e) {
         exception = "BEEF broadcast failed: " + std::string(e.what());
@@ -344,9 +425,9 @@ bool BRC100Handler::HandleVerifySPV(CefRefPtr<CefV8Value> object, const CefV8Val
     }
 
     try {
-        auto spvData = V8ValueToJSON(arguments[0]);
+        auto spvData = V8Json::fromV8(arguments[0]);
         auto response = bridge_->verifySPV(spvData);
-        retval = JSONToV8Value(response);
+        retval = V8Json::toV8(response);
         return true;
     } catch (const std::exception& e) {
         exception = "SPV verification failed: " + std::string(e.what());
@@ -361,9 +442,9 @@ bool BRC100Handler::HandleCreateSPVProof(CefRefPtr<CefV8Value> object, const Cef
     }
 
     try {
-        auto proofData = V8ValueToJSON(arguments[0]);
+        auto proofData = V8Json::fromV8(arguments[0]);
         auto response = bridge_->createSPVProof(proofData);
-        retval = JSONToV8Value(response);
+        retval = V8Json::toV8(response);
         return true;
     } catch (const std::exception& e) {
         exception = "SPV proof creation failed: " + std::string(e.what());
@@ -372,60 +453,21 @@ bool BRC100Handler::HandleCreateSPVProof(CefRefPtr<CefV8Value> object, const Cef
 }
 
 // Helper methods
-nlohmann::json BRC100Handler::V8ValueToJSON(CefRefPtr<CefV8Value> value) {
-    if (value->IsBool()) {
-        return nlohmann::json(value->GetBoolValue());
-    } else if (value->IsInt()) {
-        return nlohmann::json(value->GetIntValue());
-    } else if (value->IsDouble()) {
-        return nlohmann::json(value->GetDoubleValue());
-    } else if (value->IsString()) {
-        return nlohmann::json(V8StringToStdString(value->GetStringValue()));
-    } else if (value->IsArray()) {
-        nlohmann::json arr = nlohmann::json::array();
-        for (int i = 0; i < value->GetArrayLength(); i++) {
-            arr.push_back(V8ValueToJSON(value->GetValue(i)));
-        }
-        return arr;
-    } else if (value->IsObject()) {
-        nlohmann::json obj = nlohmann::json::object();
-        std::vector<CefString> keys;
-        value->GetKeys(keys);
-        for (const auto& key : keys) {
-            obj[V8StringToStdString(key)] = V8ValueToJSON(value->GetValue(key));
-        }
-        return obj;
-    }
-    return nlohmann::json(nullptr);
+std::string BRC100Handler::V8StringToStdString(const CefString& cefStr) {
+    return cefStr.ToString();
 }
 
-CefRefPtr<CefV8Value> BRC100Handler::JSONToV8Value(const nlohmann::json& json) {
-    if (json.is_null()) {
-        return CefV8Value::CreateNull();
-    } else if (json.is_boolean()) {
-        return CefV8Value::CreateBool(json.get<bool>());
-    } else if (json.is_number_integer()) {
-        return CefV8Value::CreateInt(json.get<int>());
-    } else if (json.is_number_float()) {
-        return CefV8Value::CreateDouble(json.get<double>());
-    } else if (json.is_string()) {
-        return CefV8Value::CreateString(json.get<std::string>());
-    } else if (json.is_array()) {
-        CefRefPtr<CefV8Value> arr = CefV8Value::CreateArray(json.size());
-        for (size_t i = 0; i < json.size(); i++) {
-            arr->SetValue(i, JSONToV8Value(json[i]));
-        }
-        return arr;
-    } else if (json.is_object()) {
-        CefRefPtr<CefV8Value> obj = CefV8Value::CreateObject(nullptr, nullptr);
-        for (auto& item : json.items()) {
-            obj->SetValue(item.key(), JSONToV8Value(item.value()), V8_PROPERTY_ATTRIBUTE_NONE);
-        }
-        return obj;
+// The daemon unmarshals beefData into []byte, so it must be standard base64
+bool BRC100Handler::ValidateBEEFPayload(const nlohmann::json& beefData, std::string& error) {
+    const nlohmann::json* tx = &beefData;
+    if (beefData.contains("beefTransaction") && beefData["beefTransaction"].is_object()) {
+        tx = &beefData["beefTransaction"];
     }
-    return CefV8Value::CreateNull();
-}
 
-std::string BRC100Handler::V8StringToStdString(const CefString& cefStr) {
-    return cefStr.ToString();
+    if (tx->contains("beefData") && (*tx)["beefData"].is_string() &&
+        !Encoding::isValidBase64((*tx)["beefData"].get<std::string>())) {
+        error = "beefData is not valid base64";
+        return false;
+    }
+    return true;
 }
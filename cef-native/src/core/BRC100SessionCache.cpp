@@ -0,0 +1,141 @@
+#include "../../include/core/BRC100SessionCache.h"
+#include "../../include/core/WalletService.h"
+#include "../../include/core/TabManager.h"
+#include "../../include/handlers/simple_handler.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+#include "include/base/cef_bind.h"
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+#define LOG_DEBUG_BROWSER(msg) Logger::Log(msg, 0, 2)
+#define LOG_INFO_BROWSER(msg) Logger::Log(msg, 1, 2)
+#define LOG_WARNING_BROWSER(msg) Logger::Log(msg, 2, 2)
+
+BRC100SessionCache& BRC100SessionCache::GetInstance() {
+    static BRC100SessionCache instance;
+    return instance;
+}
+
+void BRC100SessionCache::OnStreamConnected() {
+    CEF_REQUIRE_UI_THREAD();
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        generation = table_.BeginSeeding();
+    }
+    CefPostTask(TID_FILE_USER_VISIBLE, base::BindOnce(&BRC100SessionCache::FetchOnWorkerThread, generation));
+}
+
+void BRC100SessionCache::OnStreamLost() {
+    CEF_REQUIRE_UI_THREAD();
+    bool wasLive;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wasLive = table_.Drop();
+    }
+    if (wasLive) {
+        LOG_INFO_BROWSER("🔑 Session table dropped with the wallet event stream; session checks go to the daemon");
+        Broadcast({{"live", false}});
+    }
+}
+
+void BRC100SessionCache::OnEvent(const nlohmann::json& data) {
+    CEF_REQUIRE_UI_THREAD();
+    if (!data.is_object()) {
+        return;
+    }
+    std::string change = data.contains("change") && data["change"].is_string() ? data["change"].get<std::string>() : "";
+    nlohmann::json session = data.value("session", nlohmann::json::object());
+
+    bool live;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!table_.OnEvent(change, session)) {
+            return;
+        }
+        live = table_.Live();
+    }
+
+    // Renderers only hold sessions they were shown, so a new one needs no message
+    if (change != "created") {
+        Broadcast({{"live", live}, {"drop", nlohmann::json::array({session["sessionId"]})}});
+    }
+}
+
+void BRC100SessionCache::FetchOnWorkerThread(uint64_t generation) {
+    WalletService walletService;
+    walletService.setPriority(DaemonScheduler::kBackground);
+    nlohmann::json response = walletService.makeHttpRequestPublic("GET", "/brc100/sessions");
+
+    CefPostTask(TID_UI, base::BindOnce([](uint64_t fetched, nlohmann::json result) {
+        BRC100SessionCache::GetInstance().OnSnapshot(fetched, result);
+    }, generation, std::move(response)));
+}
+
+void BRC100SessionCache::OnSnapshot(uint64_t generation, const nlohmann::json& response) {
+    CEF_REQUIRE_UI_THREAD();
+    BRC100SessionTable::SeedResult result;
+    size_t count;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        result = table_.Seed(generation, response);
+        count = table_.Size();
+    }
+
+    if (result == BRC100SessionTable::kNotListed) {
+        LOG_INFO_BROWSER("🔑 Daemon does not list sessions; session checks go to the daemon");
+    } else if (result == BRC100SessionTable::kSeeded) {
+        LOG_INFO_BROWSER("🔑 Session table seeded with " + std::to_string(count) + " sessions");
+        Broadcast({{"live", true}});
+    }
+}
+
+bool BRC100SessionCache::Validate(const std::string& body, std::string& response) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return table_.Validate(body, response);
+}
+
+bool BRC100SessionCache::DomainHasSession(const std::string& domain) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return table_.DomainHasSession(domain);
+}
+
+nlohmann::json BRC100SessionCache::GetSyncState() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {{"live", table_.Live()}};
+}
+
+void BRC100SessionCache::Broadcast(const nlohmann::json& update) {
+    CEF_REQUIRE_UI_THREAD();
+
+    CefRefPtr<CefProcessMessage> message = CefProcessMessage::Create("brc100_session_update");
+    message->GetArgumentList()->SetString(0, update.dump());
+
+    std::vector<CefRefPtr<CefBrowser>> browsers = TabManager::GetInstance().GetBrowsers();
+    browsers.insert(browsers.end(), {
+        SimpleHandler::GetHeaderBrowser(),
+        SimpleHandler::GetOverlayBrowser(),
+        SimpleHandler::GetSettingsBrowser(),
+        SimpleHandler::GetWalletBrowser(),
+        SimpleHandler::GetBackupBrowser(),
+        SimpleHandler::GetBRC100AuthBrowser()
+    });
+
+    for (const auto& browser : browsers) {
+        if (browser && browser->GetMainFrame()) {
+            // SendProcessMessage consumes the message, so every browser gets its own copy
+            browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, message->Copy());
+        }
+    }
+}
+
+nlohmann::json BRC100SessionCache::GetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return table_.GetStats();
+}
@@ -0,0 +1,254 @@
+#include "../../include/core/BRC100SessionTable.h"
+#include <chrono>
+#include <cstdio>
+
+namespace {
+    // Days from 1970-01-01 to a proleptic Gregorian date
+    int64_t DaysFromCivil(int64_t year, int month, int day) {
+        year -= month <= 2;
+        int64_t era = (year >= 0 ? year : year - 399) / 400;
+        int64_t yearOfEra = year - era * 400;
+        int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+        int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+        return era * 146097 + dayOfEra - 719468;
+    }
+
+    nlohmann::json ValidateError(const std::string& reason, const std::string& sessionId) {
+        return {{"success", false}, {"error", "Failed to validate session: session " + reason + ": " + sessionId}};
+    }
+}
+
+int64_t BRC100SessionTable::ExpiresAtMs(const nlohmann::json& session) {
+    if (!session.is_object() || !session.contains("expiresAt") || !session["expiresAt"].is_string()) {
+        return 0;
+    }
+    // 2006-01-02T15:04:05[.999999999](Z|+07:00)
+    const std::string value = session["expiresAt"].get<std::string>();
+    int year, month, day, hour, minute, second, consumed = 0;
+    if (std::sscanf(value.c_str(), "%4d-%2d-%2dT%2d:%2d:%2d%n", &year, &month, &day, &hour, &minute, &second, &consumed) != 6 ||
+        consumed == 0) {
+        return 0;
+    }
+
+    size_t pos = static_cast<size_t>(consumed);
+    int64_t millis = 0;
+    if (pos < value.size() && value[pos] == '.') {
+        int64_t scale = 100;
+        for (pos++; pos < value.size() && value[pos] >= '0' && value[pos] <= '9'; pos++) {
+            millis += (value[pos] - '0') * scale;
+            scale /= 10;
+        }
+    }
+
+    int64_t offsetMinutes = 0;
+    if (pos < value.size() && (value[pos] == '+' || value[pos] == '-')) {
+        int offsetHours, offsetMins;
+        if (std::sscanf(value.c_str() + pos + 1, "%2d:%2d", &offsetHours, &offsetMins) != 2) {
+            return 0;
+        }
+        offsetMinutes = (value[pos] == '-' ? -1 : 1) * (offsetHours * 60 + offsetMins);
+    } else if (pos >= value.size() || value[pos] != 'Z') {
+        return 0;
+    }
+
+    int64_t seconds = DaysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second - offsetMinutes * 60;
+    return seconds * 1000 + millis;
+}
+
+int64_t BRC100SessionTable::NowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+uint64_t BRC100SessionTable::BeginSeeding() {
+    Clear();
+    pendingEvents_.clear();
+    live_ = false;
+    seeding_ = true;
+    return ++generation_;
+}
+
+bool BRC100SessionTable::Drop() {
+    bool wasLive = live_;
+    Clear();
+    pendingEvents_.clear();
+    live_ = false;
+    seeding_ = false;
+    generation_++;
+    clears_++;
+    return wasLive;
+}
+
+BRC100SessionTable::SeedResult BRC100SessionTable::Seed(uint64_t generation, const nlohmann::json& response) {
+    if (generation != generation_ || !seeding_) {
+        return kStale;
+    }
+    seeding_ = false;
+
+    const nlohmann::json* sessions = nullptr;
+    if (response.is_object() && response.value("success", false) && response.contains("data") &&
+        response["data"].is_object() && response["data"].contains("sessions") && response["data"]["sessions"].is_array()) {
+        sessions = &response["data"]["sessions"];
+    }
+    if (!sessions) {
+        pendingEvents_.clear();
+        return kNotListed;
+    }
+
+    Clear();
+    for (const auto& session : *sessions) {
+        Put(session);
+    }
+    // Everything announced since the stream opened, some of it possibly already in the snapshot;
+    // applying it in order leaves each session as its latest change
+    for (const auto& event : pendingEvents_) {
+        Apply(event.first, event.second);
+    }
+    pendingEvents_.clear();
+    live_ = true;
+    seeds_++;
+    return kSeeded;
+}
+
+bool BRC100SessionTable::OnEvent(const std::string& change, const nlohmann::json& session) {
+    if (change.empty() || !session.is_object() || !session.contains("sessionId") || !session["sessionId"].is_string() ||
+        session["sessionId"].get<std::string>().empty()) {
+        return false;
+    }
+    events_++;
+    if (seeding_) {
+        pendingEvents_.emplace_back(change, session);
+    } else if (live_) {
+        Apply(change, session);
+    }
+    return true;
+}
+
+void BRC100SessionTable::Apply(const std::string& change, const nlohmann::json& session) {
+    if (change == "created" || change == "updated") {
+        Put(session);
+    } else {
+        Erase(session.value("sessionId", ""));
+    }
+}
+
+void BRC100SessionTable::Put(const nlohmann::json& session) {
+    if (!session.is_object() || !session.contains("sessionId") || !session["sessionId"].is_string()) {
+        return;
+    }
+    std::string sessionId = session["sessionId"].get<std::string>();
+    if (sessionId.empty()) {
+        return;
+    }
+    Erase(sessionId);
+
+    int64_t expiresAtMs = ExpiresAtMs(session);
+    if (expiresAtMs == 0) {
+        // Left out, and since Validate() only answers for sessions it holds, the daemon decides
+        unreadable_++;
+        return;
+    }
+    if (expiresAtMs <= NowMs()) {
+        return;
+    }
+    std::string domain = session.contains("appDomain") && session["appDomain"].is_string()
+                         ? session["appDomain"].get<std::string>() : "";
+    sessions_[sessionId] = Entry{session, domain, expiresAtMs};
+    byExpiry_.emplace(expiresAtMs, sessionId);
+    domains_[domain]++;
+}
+
+void BRC100SessionTable::Erase(const std::string& sessionId) {
+    auto it = sessions_.find(sessionId);
+    if (it == sessions_.end()) {
+        return;
+    }
+    byExpiry_.erase({it->second.expiresAtMs, sessionId});
+    auto domain = domains_.find(it->second.domain);
+    if (domain != domains_.end() && --domain->second == 0) {
+        domains_.erase(domain);
+    }
+    sessions_.erase(it);
+}
+
+void BRC100SessionTable::PurgeExpired(int64_t nowMs) {
+    while (!byExpiry_.empty() && byExpiry_.begin()->first <= nowMs) {
+        std::string sessionId = byExpiry_.begin()->second;
+        Erase(sessionId);
+        expired_++;
+    }
+}
+
+void BRC100SessionTable::Clear() {
+    sessions_.clear();
+    byExpiry_.clear();
+    domains_.clear();
+}
+
+bool BRC100SessionTable::Validate(const std::string& body, std::string& response) {
+    auto startedAt = std::chrono::steady_clock::now();
+
+    nlohmann::json request = nlohmann::json::parse(body, nullptr, false);
+    if (!request.is_object() || !request.contains("sessionId") || !request["sessionId"].is_string()) {
+        return false;
+    }
+    std::string sessionId = request["sessionId"].get<std::string>();
+
+    // A session missing here may still be one the daemon holds (one whose expiry could not be
+    // read, say), so only the daemon says "not found"
+    auto it = sessions_.find(sessionId);
+    if (!live_ || it == sessions_.end()) {
+        daemonAnswers_++;
+        return false;
+    }
+
+    // The daemon reports a session it still holds past its expiry as expired, then forgets it
+    if (it->second.expiresAtMs <= NowMs()) {
+        Erase(sessionId);
+        expired_++;
+        response = ValidateError("expired", sessionId).dump();
+        invalidAnswers_++;
+    } else {
+        response = nlohmann::json{
+            {"success", true},
+            {"data", {{"valid", true}, {"session", it->second.session}}}
+        }.dump();
+        validAnswers_++;
+    }
+
+    validateMicros_ += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - startedAt).count());
+    return true;
+}
+
+bool BRC100SessionTable::DomainHasSession(const std::string& domain) {
+    if (!live_) {
+        return false;
+    }
+    PurgeExpired(NowMs());
+    if (domains_.find(domain) == domains_.end()) {
+        return false;
+    }
+    authenticatedAnswers_++;
+    return true;
+}
+
+nlohmann::json BRC100SessionTable::GetStats() const {
+    uint64_t localAnswers = validAnswers_ + invalidAnswers_;
+    return {
+        {"live", live_},
+        {"seeding", seeding_},
+        {"sessions", sessions_.size()},
+        {"domains", domains_.size()},
+        {"seeds", seeds_},
+        {"clears", clears_},
+        {"events", events_},
+        {"expired", expired_},
+        {"unreadable", unreadable_},
+        {"validAnswers", validAnswers_},
+        {"invalidAnswers", invalidAnswers_},
+        {"daemonAnswers", daemonAnswers_},
+        {"authenticatedAnswers", authenticatedAnswers_},
+        {"avgValidateMicros", localAnswers ? static_cast<double>(validateMicros_) / localAnswers : 0.0}
+    };
+}
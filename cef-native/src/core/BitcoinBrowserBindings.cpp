@@ -0,0 +1,287 @@
+#include "../../include/core/BitcoinBrowserBindings.h"
+#include "../../include/core/RendererRpc.h"
+#include "../../include/core/IdentityHandler.h"
+#include "../../include/core/NavigationHandler.h"
+#include "../../include/core/V8JsonConverter.h"
+#include "include/cef_process_message.h"
+#include "include/wrapper/cef_helpers.h"
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <string>
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 1);
+};
+
+#define LOG_DEBUG_RENDER(msg) Logger::Log(msg, 0, 1)
+
+namespace {
+
+    enum class ArgMode {
+        None,   // no arguments forwarded
+        Bool,   // first JS argument as a bool
+        Json    // first JS argument serialized to a JSON string
+    };
+
+    struct RpcMethod {
+        const char* object;
+        const char* method;
+        const char* messageName;
+        ArgMode args;
+        const char* unwrapField;
+    };
+
+    // Every promise-returning bitcoinBrowser method and the browser message it maps to
+    const RpcMethod kRpcMethods[] = {
+        { "address", "generate",              "address_generate",        ArgMode::None, nullptr },
+        { "wallet",  "getStatus",             "wallet_status_check",     ArgMode::None, nullptr },
+        { "wallet",  "create",                "create_wallet",           ArgMode::None, nullptr },
+        { "wallet",  "load",                  "load_wallet",             ArgMode::None, nullptr },
+        { "wallet",  "getInfo",               "get_wallet_info",         ArgMode::None, nullptr },
+        { "wallet",  "generateAddress",       "address_generate",        ArgMode::None, nullptr },
+        { "wallet",  "getCurrentAddress",     "get_current_address",     ArgMode::None, nullptr },
+        { "wallet",  "getAddresses",          "get_addresses",           ArgMode::None, "addresses" },
+        { "wallet",  "markBackedUp",          "mark_wallet_backed_up",   ArgMode::None, nullptr },
+        { "wallet",  "getBackupModalState",   "get_backup_modal_state",  ArgMode::None, nullptr },
+        { "wallet",  "setBackupModalState",   "set_backup_modal_state",  ArgMode::Bool, nullptr },
+        { "wallet",  "getBalance",            "get_balance",             ArgMode::None, nullptr },
+        { "wallet",  "sendTransaction",       "send_transaction",        ArgMode::Json, nullptr },
+        { "wallet",  "getTransactionHistory", "get_transaction_history", ArgMode::Json, nullptr },
+        { "wallet",  "getActivity",           "wallet_activity_query",   ArgMode::Json, nullptr },
+        { "wallet",  "subscribe",             "wallet_subscribe",        ArgMode::Json, nullptr },
+        { "wallet",  "unsubscribe",           "wallet_unsubscribe",      ArgMode::Json, nullptr },
+        { "history", "search",                "history_search",          ArgMode::Json, nullptr },
+    };
+
+    // One handler per bitcoinBrowser sub-object; the function name selects the table row
+    class RpcMethodHandler : public CefV8Handler {
+    public:
+        explicit RpcMethodHandler(const char* object) : object_(object) {}
+
+        bool Execute(const CefString& name,
+                     CefRefPtr<CefV8Value> object,
+                     const CefV8ValueList& arguments,
+                     CefRefPtr<CefV8Value>& retval,
+                     CefString& exception) override {
+            CEF_REQUIRE_RENDERER_THREAD();
+
+            const RpcMethod* method = nullptr;
+            std::string methodName = name.ToString();
+            for (const RpcMethod& candidate : kRpcMethods) {
+                if (std::strcmp(candidate.object, object_) == 0 && methodName == candidate.method) {
+                    method = &candidate;
+                    break;
+                }
+            }
+            if (!method) {
+                exception = "Unknown bitcoinBrowser method: " + methodName;
+                return true;
+            }
+
+            CefRefPtr<CefV8Context> context = CefV8Context::GetCurrentContext();
+            if (!context || !context->GetFrame()) {
+                exception = methodName + "() called without a frame context";
+                return true;
+            }
+
+            CefRefPtr<CefListValue> args = CefListValue::Create();
+            if (method->args == ArgMode::Bool) {
+                args->SetBool(0, !arguments.empty() && arguments[0]->GetBoolValue());
+            } else if (method->args == ArgMode::Json) {
+                try {
+                    args->SetString(0, arguments.empty() ? "null" : V8Json::fromV8(arguments[0]).dump());
+                } catch (const std::exception& e) {
+                    exception = methodName + "(): " + e.what();
+                    return true;
+                }
+            }
+
+            RendererRpc::PendingCall call;
+            call.messageName = method->messageName;
+            call.context = context;
+            call.promise = CefV8Value::CreatePromise();
+            if (method->unwrapField) {
+                call.unwrapField = method->unwrapField;
+            }
+
+            retval = call.promise;
+            RendererRpc::Send(std::move(call), args);
+            return true;
+        }
+
+    private:
+        const char* object_;
+
+        IMPLEMENT_REFCOUNTING(RpcMethodHandler);
+    };
+
+    // overlay.show/hide/toggleInput/close are fire-and-forget messages to the browser process
+    class OverlayHandler : public CefV8Handler {
+    public:
+        bool Execute(const CefString& name,
+                     CefRefPtr<CefV8Value> object,
+                     const CefV8ValueList& arguments,
+                     CefRefPtr<CefV8Value>& retval,
+                     CefString& exception) override {
+            CEF_REQUIRE_RENDERER_THREAD();
+
+            CefRefPtr<CefV8Context> context = CefV8Context::GetCurrentContext();
+            if (!context || !context->GetFrame()) {
+                exception = "overlay." + name.ToString() + "() called without a frame context";
+                return true;
+            }
+
+            CefRefPtr<CefProcessMessage> message;
+            if (name == "show") {
+                // A request intercepted for this page opens the auth overlay instead of settings
+                CefRefPtr<CefV8Value> global = context->GetGlobal();
+                CefRefPtr<CefV8Value> pending = global->GetValue("pendingBRC100AuthRequest");
+                if (pending && pending->IsObject()) {
+                    message = CefProcessMessage::Create("overlay_show_brc100_auth");
+                    CefRefPtr<CefListValue> args = message->GetArgumentList();
+                    const char* fields[] = { "domain", "method", "endpoint", "body" };
+                    for (size_t i = 0; i < 4; i++) {
+                        CefRefPtr<CefV8Value> field = pending->GetValue(fields[i]);
+                        args->SetString(i, field && field->IsString() ? field->GetStringValue() : CefString());
+                    }
+                    global->SetValue("pendingBRC100AuthRequest", CefV8Value::CreateNull(), V8_PROPERTY_ATTRIBUTE_NONE);
+                } else {
+                    message = CefProcessMessage::Create("overlay_show_settings");
+                }
+            } else if (name == "hide") {
+                message = CefProcessMessage::Create("overlay_hide");
+            } else if (name == "toggleInput") {
+                message = CefProcessMessage::Create("overlay_input");
+                message->GetArgumentList()->SetBool(0, !arguments.empty() && arguments[0]->GetBoolValue());
+            } else if (name == "close") {
+                message = CefProcessMessage::Create("overlay_close");
+            } else {
+                exception = "Unknown overlay method: " + name.ToString();
+                return true;
+            }
+
+            LOG_DEBUG_RENDER("🎯 overlay." + name.ToString() + "() -> " + message->GetName().ToString());
+            context->GetFrame()->SendProcessMessage(PID_BROWSER, message);
+            return true;
+        }
+
+    private:
+        IMPLEMENT_REFCOUNTING(OverlayHandler);
+    };
+
+    // tabs.open/activate/close/list; the tab strip itself arrives as 'tabs_changed' message events
+    class TabsHandler : public CefV8Handler {
+    public:
+        bool Execute(const CefString& name,
+                     CefRefPtr<CefV8Value> object,
+                     const CefV8ValueList& arguments,
+                     CefRefPtr<CefV8Value>& retval,
+                     CefString& exception) override {
+            CEF_REQUIRE_RENDERER_THREAD();
+
+            CefRefPtr<CefV8Context> context = CefV8Context::GetCurrentContext();
+            if (!context || !context->GetFrame()) {
+                exception = "tabs." + name.ToString() + "() called without a frame context";
+                return true;
+            }
+
+            CefRefPtr<CefProcessMessage> message;
+            if (name == "open") {
+                message = CefProcessMessage::Create("tab_open");
+                CefRefPtr<CefListValue> args = message->GetArgumentList();
+                args->SetString(0, !arguments.empty() && arguments[0]->IsString() ? arguments[0]->GetStringValue() : CefString());
+                args->SetBool(1, arguments.size() < 2 || arguments[1]->GetBoolValue());
+            } else if (name == "activate" || name == "close") {
+                if (arguments.empty() || !arguments[0]->IsInt()) {
+                    exception = "tabs." + name.ToString() + "() expects a tab id";
+                    return true;
+                }
+                message = CefProcessMessage::Create(name == "activate" ? "tab_activate" : "tab_close");
+                message->GetArgumentList()->SetInt(0, arguments[0]->GetIntValue());
+            } else if (name == "list") {
+                message = CefProcessMessage::Create("tab_list");
+            } else {
+                exception = "Unknown tabs method: " + name.ToString();
+                return true;
+            }
+
+            context->GetFrame()->SendProcessMessage(PID_BROWSER, message);
+            return true;
+        }
+
+    private:
+        IMPLEMENT_REFCOUNTING(TabsHandler);
+    };
+
+    CefRefPtr<CefV8Value> AddObject(CefRefPtr<CefV8Value> parent, const char* name) {
+        CefRefPtr<CefV8Value> object = CefV8Value::CreateObject(nullptr, nullptr);
+        parent->SetValue(name, object, V8_PROPERTY_ATTRIBUTE_READONLY);
+        return object;
+    }
+
+    // RPC namespaces any page may use; wallet and history stay with the browser's own UI
+    bool IsPublicObject(const char* object) {
+        return std::strcmp(object, "address") == 0;
+    }
+
+    void AddFunction(CefRefPtr<CefV8Value> object, const char* name, CefRefPtr<CefV8Handler> handler) {
+        object->SetValue(name, CefV8Value::CreateFunction(name, handler), V8_PROPERTY_ATTRIBUTE_NONE);
+    }
+}
+
+long long BitcoinBrowserBindings::Install(CefRefPtr<CefV8Context> context, bool appFrame) {
+    CEF_REQUIRE_RENDERER_THREAD();
+
+    auto start = std::chrono::steady_clock::now();
+
+    CefRefPtr<CefV8Value> global = context->GetGlobal();
+    CefRefPtr<CefV8Value> bitcoinBrowser = CefV8Value::CreateObject(nullptr, nullptr);
+    global->SetValue("bitcoinBrowser", bitcoinBrowser, V8_PROPERTY_ATTRIBUTE_READONLY);
+
+    CefRefPtr<IdentityHandler> identityHandler = new IdentityHandler();
+    CefRefPtr<CefV8Value> identity = AddObject(bitcoinBrowser, "identity");
+    AddFunction(identity, "get", identityHandler);
+    AddFunction(identity, "markBackedUp", identityHandler);
+
+    CefRefPtr<CefV8Value> navigation = AddObject(bitcoinBrowser, "navigation");
+    CefRefPtr<NavigationHandler> navigationHandler = new NavigationHandler();
+    AddFunction(navigation, "navigate", navigationHandler);
+    AddFunction(navigation, "predict", navigationHandler);
+
+    // Tabs and overlay drive the browser's own UI
+    if (appFrame) {
+        CefRefPtr<TabsHandler> tabsHandler = new TabsHandler();
+        CefRefPtr<CefV8Value> tabs = AddObject(bitcoinBrowser, "tabs");
+        AddFunction(tabs, "open", tabsHandler);
+        AddFunction(tabs, "activate", tabsHandler);
+        AddFunction(tabs, "close", tabsHandler);
+        AddFunction(tabs, "list", tabsHandler);
+
+        CefRefPtr<OverlayHandler> overlayHandler = new OverlayHandler();
+        CefRefPtr<CefV8Value> overlay = AddObject(bitcoinBrowser, "overlay");
+        AddFunction(overlay, "show", overlayHandler);
+        AddFunction(overlay, "hide", overlayHandler);
+        AddFunction(overlay, "toggleInput", overlayHandler);
+        AddFunction(overlay, "close", overlayHandler);
+    }
+
+    // RPC-backed objects, built straight from the method table: one object and handler per name
+    std::map<std::string, std::pair<CefRefPtr<CefV8Value>, CefRefPtr<RpcMethodHandler>>> rpcObjects;
+    for (const RpcMethod& method : kRpcMethods) {
+        if (!appFrame && !IsPublicObject(method.object)) {
+            continue;
+        }
+        auto& rpcObject = rpcObjects[method.object];
+        if (!rpcObject.first) {
+            rpcObject.first = AddObject(bitcoinBrowser, method.object);
+            rpcObject.second = new RpcMethodHandler(method.object);
+        }
+        AddFunction(rpcObject.first, method.method, rpcObject.second);
+    }
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
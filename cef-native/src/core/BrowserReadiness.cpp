@@ -0,0 +1,86 @@
+#include "../../include/core/BrowserReadiness.h"
+#include "include/wrapper/cef_helpers.h"
+#include <string>
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+#define LOG_DEBUG_BROWSER(msg) Logger::Log(msg, 0, 2)
+#define LOG_INFO_BROWSER(msg) Logger::Log(msg, 1, 2)
+
+BrowserReadiness& BrowserReadiness::GetInstance() {
+    static BrowserReadiness instance;
+    return instance;
+}
+
+void BrowserReadiness::MarkLoading(CefRefPtr<CefBrowser> browser) {
+    CEF_REQUIRE_UI_THREAD();
+
+    // Queued work survives the reload and is delivered to the new page
+    State& state = states_[browser->GetIdentifier()];
+    state.ready = false;
+    state.loadStart = std::chrono::steady_clock::now();
+}
+
+void BrowserReadiness::MarkReady(CefRefPtr<CefBrowser> browser) {
+    CEF_REQUIRE_UI_THREAD();
+
+    State& state = states_[browser->GetIdentifier()];
+    bool wasReady = state.ready;
+    state.ready = true;
+
+    if (!wasReady && state.loadStart.time_since_epoch().count() != 0) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - state.loadStart).count();
+        LOG_INFO_BROWSER("✅ Browser " + std::to_string(browser->GetIdentifier()) + " app ready " +
+                         std::to_string(elapsed) + " ms after load start, flushing " +
+                         std::to_string(state.pending.size()) + " queued message(s)");
+    }
+
+    // Tasks may queue more work or reload the page, so take the batch first
+    std::deque<Task> batch;
+    batch.swap(state.pending);
+    for (auto& task : batch) {
+        task(browser);
+    }
+}
+
+bool BrowserReadiness::IsReady(CefRefPtr<CefBrowser> browser) const {
+    auto it = states_.find(browser->GetIdentifier());
+    return it != states_.end() && it->second.ready;
+}
+
+void BrowserReadiness::RunWhenReady(CefRefPtr<CefBrowser> browser, Task task) {
+    CEF_REQUIRE_UI_THREAD();
+
+    if (!browser) {
+        return;
+    }
+
+    State& state = states_[browser->GetIdentifier()];
+    if (state.ready) {
+        task(browser);
+        return;
+    }
+
+    state.pending.push_back(std::move(task));
+    LOG_DEBUG_BROWSER("🕒 Queued work for browser " + std::to_string(browser->GetIdentifier()) +
+                      " until app ready (" + std::to_string(state.pending.size()) + " pending)");
+}
+
+void BrowserReadiness::SendWhenReady(CefRefPtr<CefBrowser> browser, CefRefPtr<CefProcessMessage> message) {
+    RunWhenReady(browser, [message](CefRefPtr<CefBrowser> target) {
+        if (target->GetMainFrame()) {
+            target->GetMainFrame()->SendProcessMessage(PID_RENDERER, message);
+        }
+    });
+}
+
+void BrowserReadiness::Forget(CefRefPtr<CefBrowser> browser) {
+    if (browser) {
+        states_.erase(browser->GetIdentifier());
+    }
+}
@@ -0,0 +1,578 @@
+#include "../../include/core/DaemonChannel.h"
+#ifdef _WIN32
+#include <windows.h>
+#include <aclapi.h>
+#else
+#include <fcntl.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+#define LOG_DEBUG_BROWSER(msg) Logger::Log(msg, 0, 2)
+#define LOG_INFO_BROWSER(msg) Logger::Log(msg, 1, 2)
+#define LOG_WARNING_BROWSER(msg) Logger::Log(msg, 2, 2)
+
+namespace {
+    // Layout shared with go-wallet/shm_channel_windows.go. Every counter sits on its own cache
+    // line and only ever moves forward; its owner is the only writer.
+    const uint32_t kMagic = 0x43574242;     // "BBWC"
+    const uint32_t kVersion = 1;
+    const uint32_t kSlotCount = 256;
+    const uint32_t kSlotBytes = 4096;
+
+    const size_t kOffMagic = 0;
+    const size_t kOffVersion = 4;
+    const size_t kOffSlotCount = 8;
+    const size_t kOffSlotBytes = 12;
+    const size_t kOffRequestHead = 64;      // browser
+    const size_t kOffRequestTail = 128;     // daemon
+    const size_t kOffAnswerHead = 192;      // daemon
+    const size_t kOffAnswerTail = 256;      // browser
+    const size_t kOffDaemonWaiting = 320;
+    const size_t kOffBrowserWaiting = 384;
+    const size_t kOffDaemonReady = 448;
+    const size_t kOffSlots = 512;
+    const size_t kChannelBytes = kOffSlots + 2 * size_t(kSlotCount) * kSlotBytes;
+
+    const int kRequestRing = 0;
+    const int kAnswerRing = 1;
+
+    struct Frame {
+        uint32_t length;    // payload bytes after the header
+        uint32_t id;
+        uint16_t op;
+        uint16_t status;    // HTTP status of the answer; 0 in requests
+        uint32_t reserved;
+    };
+    static_assert(sizeof(Frame) == 16, "frame header is part of the shared layout");
+
+    const uint32_t kMaxPayload = kSlotBytes - sizeof(Frame);
+    // Answer that did not fit a slot; the call goes over HTTP instead
+    const uint16_t kStatusTooLarge = 0xFFFF;
+
+    const wchar_t* const kDaemonChannelName = L"Local\\BabbageBrowserWalletChannel";
+
+    const uint32_t kAttachRetryMs = 2000;
+    // Longest sleep between deadline checks while calls are outstanding
+    const uint32_t kWaitSliceMs = 50;
+    const uint64_t kCallTimeoutMs = 2000;
+    // Polls of the other side's ring before sleeping; under load the next frame is usually this
+    // close. With a single core the other side cannot run while we spin, so we go straight to sleep.
+    int SpinRounds() {
+        static const int rounds = std::thread::hardware_concurrency() > 1 ? 2000 : 0;
+        return rounds;
+    }
+
+    std::atomic<uint32_t>* Word(uint8_t* view, size_t offset) {
+        return reinterpret_cast<std::atomic<uint32_t>*>(view + offset);
+    }
+
+    uint8_t* RingSlot(uint8_t* view, int ring, uint32_t index) {
+        return view + kOffSlots + (size_t(ring) * kSlotCount + index % kSlotCount) * kSlotBytes;
+    }
+
+    // The named objects behind the channel, as void* handles. On Windows they are the daemon's
+    // mapping and two auto-reset events. Elsewhere, so the rings can be tested on Linux, they are
+    // the POSIX shared memory object "/<name>" and the semaphores "/<name>.request" and
+    // "/<name>.response"; a semaphore that counts past one only wakes its waiter for nothing.
+#ifdef _WIN32
+    // SID of the user this process runs as
+    bool CurrentUserSid(std::vector<uint8_t>& sid) {
+        HANDLE token = nullptr;
+        if (!OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY, &token)) {
+            return false;
+        }
+        DWORD size = 0;
+        GetTokenInformation(token, TokenUser, nullptr, 0, &size);
+        std::vector<uint8_t> buffer(size);
+        bool ok = size > 0 && GetTokenInformation(token, TokenUser, buffer.data(), size, &size);
+        CloseHandle(token);
+        if (!ok) {
+            return false;
+        }
+        PSID user = reinterpret_cast<TOKEN_USER*>(buffer.data())->User.Sid;
+        sid.assign(static_cast<uint8_t*>(user), static_cast<uint8_t*>(user) + GetLengthSid(user));
+        return true;
+    }
+
+    // Whether a named object we opened was created by our own user. The daemon creates the
+    // channel's objects owned by its user, so one owned by anyone else was put there first under
+    // the daemon's name and is never attached to.
+    bool OwnedByCurrentUser(HANDLE object) {
+        static const std::vector<uint8_t> user = [] {
+            std::vector<uint8_t> sid;
+            CurrentUserSid(sid);
+            return sid;
+        }();
+        PSID owner = nullptr;
+        PSECURITY_DESCRIPTOR descriptor = nullptr;
+        if (user.empty() || GetSecurityInfo(object, SE_KERNEL_OBJECT, OWNER_SECURITY_INFORMATION,
+                                            &owner, nullptr, nullptr, nullptr, &descriptor) != ERROR_SUCCESS) {
+            return false;
+        }
+        bool owned = owner && EqualSid(owner, const_cast<uint8_t*>(user.data()));
+        LocalFree(descriptor);
+        return owned;
+    }
+
+    void* OpenMapping(const std::wstring& name) {
+        return OpenFileMappingW(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+    }
+
+    void* OpenNamedEvent(const std::wstring& name) {
+        return OpenEventW(EVENT_MODIFY_STATE | SYNCHRONIZE | READ_CONTROL, FALSE, name.c_str());
+    }
+
+    uint8_t* MapView(void* mapping) {
+        return static_cast<uint8_t*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, kChannelBytes));
+    }
+
+    void UnmapView(uint8_t* view) {
+        UnmapViewOfFile(view);
+    }
+
+    void CloseObject(void* object) {
+        CloseHandle(object);
+    }
+
+    void* CreateStopEvent() {
+        return CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    }
+
+    void Signal(void* event) {
+        SetEvent(event);
+    }
+
+    void Wait(void* event, uint32_t timeoutMs) {
+        WaitForSingleObject(event, timeoutMs);
+    }
+
+    // Until either is signalled or the timeout passes
+    void WaitEither(void* event, void* stopEvent, uint32_t timeoutMs) {
+        HANDLE handles[] = { event, stopEvent };
+        WaitForMultipleObjects(2, handles, FALSE, timeoutMs);
+    }
+
+    uint64_t TickMs() {
+        return GetTickCount64();
+    }
+
+    uint32_t ProcessId() {
+        return static_cast<uint32_t>(GetCurrentProcessId());
+    }
+
+    void SpinPause() {
+        YieldProcessor();
+    }
+#else
+    struct NamedObject {
+        int fd;             // the shared memory object, or -1
+        sem_t* semaphore;   // an event, or nullptr
+        bool named;         // false for the stop semaphore, which is this process's own
+        uid_t owner;
+    };
+
+    // ASCII names only
+    std::string PosixName(const std::wstring& name) {
+        return "/" + std::string(name.begin(), name.end());
+    }
+
+    void* OpenMapping(const std::wstring& name) {
+        int fd = shm_open(PosixName(name).c_str(), O_RDWR, 0);
+        struct stat info;
+        if (fd >= 0 && (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < kChannelBytes)) {
+            close(fd);
+            fd = -1;
+        }
+        return fd >= 0 ? new NamedObject{ fd, nullptr, true, info.st_uid } : nullptr;
+    }
+
+    void* OpenNamedEvent(const std::wstring& name) {
+        // Linux keeps a named semaphore as /dev/shm/sem.<name>, which is where its owner shows
+        std::string posixName = PosixName(name);
+        struct stat info;
+        if (stat(("/dev/shm/sem." + posixName.substr(1)).c_str(), &info) != 0) {
+            return nullptr;
+        }
+        sem_t* semaphore = sem_open(posixName.c_str(), 0);
+        return semaphore != SEM_FAILED ? new NamedObject{ -1, semaphore, true, info.st_uid } : nullptr;
+    }
+
+    bool OwnedByCurrentUser(void* object) {
+        return static_cast<NamedObject*>(object)->owner == geteuid();
+    }
+
+    uint8_t* MapView(void* mapping) {
+        void* view = mmap(nullptr, kChannelBytes, PROT_READ | PROT_WRITE, MAP_SHARED,
+                          static_cast<NamedObject*>(mapping)->fd, 0);
+        return view != MAP_FAILED ? static_cast<uint8_t*>(view) : nullptr;
+    }
+
+    void UnmapView(uint8_t* view) {
+        munmap(view, kChannelBytes);
+    }
+
+    void CloseObject(void* object) {
+        NamedObject* named = static_cast<NamedObject*>(object);
+        if (named->fd >= 0) {
+            close(named->fd);
+        }
+        if (named->semaphore && named->named) {
+            sem_close(named->semaphore);
+        } else if (named->semaphore) {
+            sem_destroy(named->semaphore);
+            delete named->semaphore;
+        }
+        delete named;
+    }
+
+    void* CreateStopEvent() {
+        sem_t* semaphore = new sem_t;
+        sem_init(semaphore, 0, 0);
+        return new NamedObject{ -1, semaphore, false, geteuid() };
+    }
+
+    void Signal(void* event) {
+        sem_post(static_cast<NamedObject*>(event)->semaphore);
+    }
+
+    void Wait(void* event, uint32_t timeoutMs) {
+        timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += timeoutMs / 1000;
+        deadline.tv_nsec += static_cast<long>(timeoutMs % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+        while (sem_timedwait(static_cast<NamedObject*>(event)->semaphore, &deadline) != 0 && errno == EINTR) {
+        }
+    }
+
+    // Semaphores cannot be waited on together, so a stop is only seen once the slice is over
+    void WaitEither(void* event, void*, uint32_t timeoutMs) {
+        Wait(event, timeoutMs);
+    }
+
+    uint64_t TickMs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    uint32_t ProcessId() {
+        return static_cast<uint32_t>(getpid());
+    }
+
+    void SpinPause() {
+        std::this_thread::yield();
+    }
+#endif
+}
+
+DaemonChannel& DaemonChannel::GetInstance() {
+    static DaemonChannel instance(kDaemonChannelName);
+    return instance;
+}
+
+uint16_t DaemonChannel::OpForEndpoint(const std::string& endpoint) {
+    static const std::pair<const char*, Op> kEndpoints[] = {
+        { "/getPublicKey", kGetPublicKey },
+        { "/createSignature", kCreateSignature },
+        { "/createHmac", kCreateHmac },
+        { "/verifyHmac", kVerifyHmac }
+    };
+    std::string path = endpoint.substr(0, endpoint.find('?'));
+    for (const auto& entry : kEndpoints) {
+        if (path == entry.first) {
+            return entry.second;
+        }
+    }
+    return 0;
+}
+
+DaemonChannel::DaemonChannel(const std::wstring& name)
+    : name_(name),
+      // Ids from an earlier browser's calls still in the rings will not match ours
+      nextId_(ProcessId() << 16 | 1) {
+}
+
+DaemonChannel::~DaemonChannel() {
+    Stop();
+}
+
+void DaemonChannel::Start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    stopEvent_ = CreateStopEvent();
+    worker_ = std::thread(&DaemonChannel::Run, this);
+}
+
+void DaemonChannel::Stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    Signal(stopEvent_);
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    CloseObject(stopEvent_);
+    stopEvent_ = nullptr;
+}
+
+uint8_t* DaemonChannel::Slot(int ring, uint32_t index) const {
+    return RingSlot(view_, ring, index);
+}
+
+bool DaemonChannel::Attach() {
+    void* mapping = OpenMapping(name_);
+    if (!mapping) {
+        return false;
+    }
+    void* requestEvent = OpenNamedEvent(name_ + L".request");
+    void* answerEvent = OpenNamedEvent(name_ + L".response");
+
+    // Wallet requests carry site data and signing input, so nothing is mapped or written until
+    // every object is known to be the daemon's
+    bool owned = requestEvent && answerEvent && OwnedByCurrentUser(mapping) &&
+                 OwnedByCurrentUser(requestEvent) && OwnedByCurrentUser(answerEvent);
+    if (!owned && requestEvent && answerEvent && !foreignObjectLogged_) {
+        foreignObjectLogged_ = true;
+        LOG_WARNING_BROWSER("⚠️ Wallet channel objects are not owned by this user; staying on HTTP");
+    }
+    uint8_t* view = owned ? MapView(mapping) : nullptr;
+
+    bool compatible = view && requestEvent && answerEvent &&
+                      Word(view, kOffMagic)->load() == kMagic &&
+                      Word(view, kOffVersion)->load() == kVersion &&
+                      Word(view, kOffSlotCount)->load() == kSlotCount &&
+                      Word(view, kOffSlotBytes)->load() == kSlotBytes &&
+                      Word(view, kOffDaemonReady)->load() == 1;
+    if (!compatible) {
+        if (view) {
+            UnmapView(view);
+        }
+        for (void* handle : { mapping, requestEvent, answerEvent }) {
+            if (handle) {
+                CloseObject(handle);
+            }
+        }
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        mapping_ = mapping;
+        view_ = view;
+        requestEvent_ = requestEvent;
+        answerEvent_ = answerEvent;
+        // Carry on from where the rings are; answers meant for an earlier browser are skipped
+        requestHead_ = Word(view_, kOffRequestHead)->load();
+        answerTail_ = Word(view_, kOffAnswerHead)->load();
+        Word(view_, kOffAnswerTail)->store(answerTail_);
+        connected_ = true;
+    }
+    attaches_++;
+    LOG_INFO_BROWSER("⚡ Wallet daemon shared-memory channel attached");
+    return true;
+}
+
+void DaemonChannel::Detach() {
+    std::unordered_map<uint32_t, Pending> abandoned;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connected_ = false;
+        abandoned.swap(pending_);
+        UnmapView(view_);
+        view_ = nullptr;
+        for (void** handle : { &mapping_, &requestEvent_, &answerEvent_ }) {
+            CloseObject(*handle);
+            *handle = nullptr;
+        }
+    }
+    for (auto& entry : abandoned) {
+        entry.second.done(0, std::string());
+    }
+    LOG_INFO_BROWSER("⚡ Wallet daemon shared-memory channel detached, " + std::to_string(abandoned.size()) +
+                     " calls handed back to HTTP");
+}
+
+void DaemonChannel::Run() {
+    while (running_) {
+        if (!connected_ && !Attach()) {
+            Wait(stopEvent_, kAttachRetryMs);
+            continue;
+        }
+        if (Drain() > 0) {
+            continue;
+        }
+        // A daemon that shut down cleared its ready flag; one that stopped answering shows up
+        // as calls running past their deadline
+        if (Word(view_, kOffDaemonReady)->load() == 0 || ExpireCalls()) {
+            Detach();
+            continue;
+        }
+        WaitForAnswers();
+    }
+    if (connected_) {
+        Detach();
+    }
+}
+
+size_t DaemonChannel::Drain() {
+    uint32_t head = Word(view_, kOffAnswerHead)->load(std::memory_order_acquire);
+    if (head == answerTail_) {
+        return 0;
+    }
+
+    struct Answer {
+        uint32_t id;
+        int status;
+        std::string body;
+        Callback done;
+    };
+    std::vector<Answer> answers;
+    answers.reserve(head - answerTail_);
+    for (; answerTail_ != head; answerTail_++) {
+        const uint8_t* slot = Slot(kAnswerRing, answerTail_);
+        Frame frame;
+        memcpy(&frame, slot, sizeof(frame));
+        int status = frame.status == kStatusTooLarge ? 0 : frame.status;
+        answers.push_back({ frame.id, status,
+                            std::string(reinterpret_cast<const char*>(slot + sizeof(frame)), (std::min)(frame.length, kMaxPayload)),
+                            nullptr });
+    }
+    Word(view_, kOffAnswerTail)->store(answerTail_, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (Answer& answer : answers) {
+            auto it = pending_.find(answer.id);
+            if (it != pending_.end()) {
+                answer.done = std::move(it->second.done);
+                pending_.erase(it);
+            }
+        }
+    }
+    for (Answer& answer : answers) {
+        if (answer.done) {
+            answer.done(answer.status, std::move(answer.body));
+        }
+    }
+    answered_ += answers.size();
+    return answers.size();
+}
+
+bool DaemonChannel::ExpireCalls() {
+    std::vector<Callback> expired;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t now = TickMs();
+        for (auto it = pending_.begin(); it != pending_.end();) {
+            if (it->second.deadline <= now) {
+                expired.push_back(std::move(it->second.done));
+                it = pending_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    for (Callback& done : expired) {
+        done(0, std::string());
+    }
+    if (!expired.empty()) {
+        timeouts_ += expired.size();
+        LOG_WARNING_BROWSER("⚠️ " + std::to_string(expired.size()) + " wallet channel calls timed out");
+    }
+    return !expired.empty();
+}
+
+void DaemonChannel::WaitForAnswers() {
+    for (int i = 0; i < SpinRounds(); i++) {
+        if (Word(view_, kOffAnswerHead)->load() != answerTail_) {
+            return;
+        }
+        SpinPause();
+    }
+
+    // Announce the sleep before the last look, so an answer published in between still wakes us
+    Word(view_, kOffBrowserWaiting)->store(1);
+    if (Word(view_, kOffAnswerHead)->load() == answerTail_) {
+        WaitEither(answerEvent_, stopEvent_, kWaitSliceMs);
+        sleeps_++;
+    }
+    Word(view_, kOffBrowserWaiting)->store(0);
+}
+
+bool DaemonChannel::Submit(uint16_t op, const std::string& body, Callback done) {
+    std::vector<Call> calls;
+    calls.push_back({ op, body, std::move(done) });
+    return SubmitBatch(calls) == 1;
+}
+
+size_t DaemonChannel::SubmitBatch(std::vector<Call>& calls) {
+    size_t queued = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (connected_) {
+            uint64_t deadline = TickMs() + kCallTimeoutMs;
+            // Outstanding calls never exceed the ring size, so the daemon always has room to answer.
+            // pending_ alone does not say the request ring has room: after a reattach it starts
+            // empty while the daemon may still have slots from before to read.
+            uint32_t requestTail = Word(view_, kOffRequestTail)->load(std::memory_order_acquire);
+            for (Call& call : calls) {
+                if (call.body.size() > kMaxPayload || pending_.size() >= kSlotCount ||
+                    requestHead_ - requestTail >= kSlotCount) {
+                    break;
+                }
+                Frame frame = { static_cast<uint32_t>(call.body.size()), nextId_++, call.op, 0, 0 };
+                uint8_t* slot = Slot(kRequestRing, requestHead_);
+                memcpy(slot, &frame, sizeof(frame));
+                memcpy(slot + sizeof(frame), call.body.data(), call.body.size());
+                pending_[frame.id] = Pending{ std::move(call.done), deadline };
+                requestHead_++;
+                queued++;
+            }
+        }
+        if (queued > 0) {
+            Word(view_, kOffRequestHead)->store(requestHead_);
+            if (Word(view_, kOffDaemonWaiting)->exchange(0) == 1) {
+                Signal(requestEvent_);
+                wakeups_++;
+            }
+        }
+    }
+
+    calls_ += queued;
+    batches_ += queued > 0 ? 1 : 0;
+    rejected_ += calls.size() - queued;
+    return queued;
+}
+
+nlohmann::json DaemonChannel::GetStats() const {
+    return {
+        {"running", running_.load()},
+        {"connected", connected_.load()},
+        {"attaches", attaches_.load()},
+        {"calls", calls_.load()},
+        {"batches", batches_.load()},
+        {"rejected", rejected_.load()},
+        {"answered", answered_.load()},
+        {"timeouts", timeouts_.load()},
+        {"daemonWakeups", wakeups_.load()},
+        {"sleeps", sleeps_.load()}
+    };
+}
@@ -0,0 +1,475 @@
+#include "../../include/core/DaemonResilience.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <thread>
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+#define LOG_DEBUG_BROWSER(msg) Logger::Log(msg, 0, 2)
+#define LOG_INFO_BROWSER(msg) Logger::Log(msg, 1, 2)
+#define LOG_WARNING_BROWSER(msg) Logger::Log(msg, 2, 2)
+
+namespace {
+    // 0 when no scope is open on this thread
+    thread_local uint64_t t_deadlineMs = 0;
+
+    const uint32_t kTripAfterConsecutive = 5;
+    // Or at least half of the last kRecentCalls failed, once there are kMinRecentCalls of them
+    const size_t kRecentCalls = 20;
+    const size_t kMinRecentCalls = 10;
+    const uint64_t kFirstCoolDownMs = 1000;
+    const uint64_t kMaxCoolDownMs = 30000;
+    // A probe that never reported back (its caller gave up) stops blocking the next one after this
+    const uint64_t kProbeTimeoutMs = 5000;
+
+    const size_t kLatencySamples = 256;
+    const size_t kMinLatencySamples = 20;
+    const uint32_t kMinHedgeDelayMs = 10;
+    // Hedges earned per call, and the most that can be saved up
+    const double kHedgeTokensPerCall = 0.1;
+    const double kMaxHedgeTokens = 10;
+    // Hedges running at once across every breaker, abandoned ones included
+    const int kMaxHedgesInFlight = 4;
+    std::atomic<int> g_hedgesInFlight{0};
+
+    double PercentileMicros(std::vector<double> samples, double p) {
+        if (samples.empty()) {
+            return 0.0;
+        }
+        size_t index = static_cast<size_t>(p * (samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return samples[index];
+    }
+
+    // Sends each hedge once its delay has passed, from one thread for the whole process, so a
+    // read that answers in time never starts a thread of its own
+    class HedgeTimer {
+    public:
+        static HedgeTimer& GetInstance() {
+            // Never destroyed: its thread runs until the process exits
+            static HedgeTimer* instance = new HedgeTimer();
+            return *instance;
+        }
+
+        void Schedule(std::chrono::steady_clock::time_point at, std::function<void()> task) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            pending_.emplace(at, std::move(task));
+            wake_.notify_one();
+        }
+
+    private:
+        HedgeTimer() {
+            std::thread(&HedgeTimer::Run, this).detach();
+        }
+
+        void Run() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (true) {
+                if (pending_.empty()) {
+                    wake_.wait(lock);
+                    continue;
+                }
+                auto next = pending_.begin();
+                if (std::chrono::steady_clock::now() < next->first) {
+                    wake_.wait_until(lock, next->first);
+                    continue;
+                }
+                std::function<void()> task = std::move(next->second);
+                pending_.erase(next);
+                lock.unlock();
+                task();
+                lock.lock();
+            }
+        }
+
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::multimap<std::chrono::steady_clock::time_point, std::function<void()>> pending_;
+    };
+
+    uint64_t NowUs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+}
+
+DaemonDeadline::Scope::Scope(uint32_t budgetMs) : previous_(t_deadlineMs) {
+    uint64_t deadline = NowMs() + budgetMs;
+    t_deadlineMs = previous_ != 0 ? (std::min)(previous_, deadline) : deadline;
+}
+
+DaemonDeadline::Scope::~Scope() {
+    t_deadlineMs = previous_;
+}
+
+uint32_t DaemonDeadline::RemainingMs(uint32_t routeBudgetMs) {
+    if (t_deadlineMs == 0) {
+        return routeBudgetMs;
+    }
+    uint64_t now = NowMs();
+    if (t_deadlineMs <= now) {
+        return 0;
+    }
+    return static_cast<uint32_t>((std::min)(static_cast<uint64_t>(routeBudgetMs), t_deadlineMs - now));
+}
+
+uint64_t DaemonDeadline::NowMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+DaemonRoutePolicy DaemonRoutePolicy::For(const std::string& method, const std::string& endpoint) {
+    std::string path = endpoint.substr(0, endpoint.find('?'));
+    if (method == "GET") {
+        if (path == "/health") {
+            return {2000, true, true};
+        }
+        if (path == "/transaction/history") {
+            return {15000, true, false};
+        }
+        return {5000, true, false};
+    }
+    // Site calls that only read wallet state
+    if (path == "/getPublicKey" || path == "/getVersion" || path == "/getNetwork" ||
+        path == "/isAuthenticated" || path == "/listOutputs" || path == "/listMessages" ||
+        path == "/verifyHmac") {
+        return {10000, true, false};
+    }
+    // Building, signing and broadcasting wait on the network
+    if (path.compare(0, 13, "/transaction/") == 0) {
+        return {30000, false, false};
+    }
+    return {15000, false, false};
+}
+
+DaemonCircuitBreaker& DaemonCircuitBreaker::GetInstance() {
+    static DaemonCircuitBreaker instance;
+    return instance;
+}
+
+const char* DaemonCircuitBreaker::StateName(State state) {
+    switch (state) {
+        case State::Closed: return "closed";
+        case State::Open: return "open";
+        case State::HalfOpen: return "halfOpen";
+        default: return "unknown";
+    }
+}
+
+const char* DaemonCircuitBreaker::OutcomeName(Outcome outcome) {
+    switch (outcome) {
+        case Outcome::Answered: return "answered";
+        case Outcome::Failed: return "failed";
+        case Outcome::TimedOut: return "timedOut";
+        case Outcome::FailedFast: return "failedFast";
+        default: return "unknown";
+    }
+}
+
+bool DaemonCircuitBreaker::Allow() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t now = DaemonDeadline::NowMs();
+    switch (state_) {
+        case State::Closed:
+            return true;
+        case State::Open:
+            if (now < openUntilMs_) {
+                return false;
+            }
+            state_ = State::HalfOpen;
+            probing_ = false;
+            // fall through
+        case State::HalfOpen:
+            if (probing_ && now - probeStartedMs_ < kProbeTimeoutMs) {
+                return false;
+            }
+            probing_ = true;
+            probeStartedMs_ = now;
+            return true;
+    }
+    return false;
+}
+
+void DaemonCircuitBreaker::OnSuccess(uint64_t latencyUs) {
+    bool closed = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        RecordLocked(false);
+        consecutiveFailures_ = 0;
+        if (latencies_.size() < kLatencySamples) {
+            latencies_.push_back(static_cast<double>(latencyUs));
+        } else {
+            latencies_[nextLatency_] = static_cast<double>(latencyUs);
+            nextLatency_ = (nextLatency_ + 1) % kLatencySamples;
+        }
+        if (state_ != State::Closed) {
+            state_ = State::Closed;
+            coolDownMs_ = 0;
+            probing_ = false;
+            closed = true;
+        }
+    }
+    if (closed) {
+        LOG_INFO_BROWSER("🔌 Wallet daemon answering again, circuit closed");
+    }
+}
+
+void DaemonCircuitBreaker::OnFailure() {
+    uint64_t openedFor = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        RecordLocked(true);
+        consecutiveFailures_++;
+
+        bool trip = false;
+        if (state_ == State::HalfOpen) {
+            // The probe failed: back off for longer
+            coolDownMs_ = (std::min)(coolDownMs_ * 2, kMaxCoolDownMs);
+            probing_ = false;
+            trip = true;
+        } else if (state_ == State::Closed) {
+            size_t failures = static_cast<size_t>(std::count(recent_.begin(), recent_.end(), true));
+            if (consecutiveFailures_ >= kTripAfterConsecutive ||
+                (recent_.size() >= kMinRecentCalls && failures * 2 >= recent_.size())) {
+                coolDownMs_ = kFirstCoolDownMs;
+                trips_++;
+                trip = true;
+            }
+        }
+        if (trip) {
+            state_ = State::Open;
+            openUntilMs_ = DaemonDeadline::NowMs() + coolDownMs_;
+            // The next closed period is judged on its own calls
+            recent_.clear();
+            nextRecent_ = 0;
+            openedFor = coolDownMs_;
+        }
+    }
+    if (openedFor > 0) {
+        LOG_WARNING_BROWSER("⚠️ Wallet daemon not answering, failing calls fast for " + std::to_string(openedFor) + " ms");
+    }
+}
+
+void DaemonCircuitBreaker::RecordLocked(bool failed) {
+    if (recent_.size() < kRecentCalls) {
+        recent_.push_back(failed);
+    } else {
+        recent_[nextRecent_] = failed;
+        nextRecent_ = (nextRecent_ + 1) % kRecentCalls;
+    }
+}
+
+DaemonCircuitBreaker::State DaemonCircuitBreaker::state() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return state_;
+}
+
+uint32_t DaemonCircuitBreaker::HedgeDelayMs(uint32_t budgetMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (hedgeTokens_ < 1.0 || state_ != State::Closed) {
+        return 0;
+    }
+    uint32_t delay = budgetMs / 2;
+    if (latencies_.size() >= kMinLatencySamples) {
+        uint32_t p95 = static_cast<uint32_t>(PercentileMicros(latencies_, 0.95) / 1000) + 1;
+        delay = (std::min)(delay, (std::max)(p95, kMinHedgeDelayMs));
+    }
+    return delay;
+}
+
+DaemonCircuitBreaker::Outcome DaemonCircuitBreaker::Call(const DaemonRoutePolicy& policy, const Attempt& attempt,
+                                                         int& status, std::string& body) {
+    uint32_t budgetMs = DaemonDeadline::RemainingMs(policy.budgetMs);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        calls_++;
+        hedgeTokens_ = (std::min)(kMaxHedgeTokens, hedgeTokens_ + kHedgeTokensPerCall);
+    }
+    if (budgetMs == 0 || (!policy.probe && !Allow())) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        outcomes_[static_cast<int>(Outcome::FailedFast)]++;
+        return Outcome::FailedFast;
+    }
+
+    uint64_t startedUs = NowUs();
+    bool answered = attempt(budgetMs, status, body);
+    uint64_t elapsedMs = (NowUs() - startedUs) / 1000;
+    // A read that failed quickly (a dropped connection, a daemon restarting) gets one more try
+    if (!answered && policy.idempotent && elapsedMs < budgetMs / 2) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            retries_++;
+        }
+        answered = attempt(static_cast<uint32_t>(budgetMs - elapsedMs), status, body);
+        elapsedMs = (NowUs() - startedUs) / 1000;
+    }
+
+    Outcome outcome = answered ? Outcome::Answered : elapsedMs >= budgetMs ? Outcome::TimedOut : Outcome::Failed;
+    if (answered) {
+        OnSuccess(NowUs() - startedUs);
+    } else {
+        OnFailure();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    outcomes_[static_cast<int>(outcome)]++;
+    return outcome;
+}
+
+// Shared with the hedge thread and the hedge timer, which may outlive the call
+struct DaemonCircuitBreaker::Race {
+    std::mutex mutex;
+    std::condition_variable changed;
+    // The caller has its answer or gave up; nothing more is sent or cancelled for it
+    bool settled = false;
+    bool firstRunning = false;
+    std::function<void()> cancelFirst;
+    int hedgesRunning = 0;
+    bool hedgeWon = false;
+    int status = 0;
+    std::string body;
+};
+
+void DaemonCircuitBreaker::SendHedge(const std::shared_ptr<Race>& race, const std::function<Attempt()>& makeHedge,
+                                     std::chrono::steady_clock::time_point deadline) {
+    std::lock_guard<std::mutex> raceLock(race->mutex);
+    auto now = std::chrono::steady_clock::now();
+    if (race->settled || race->hedgeWon || now >= deadline) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (hedgeTokens_ < 1.0) {
+            return;
+        }
+        // Hedges abandoned at their deadline keep a thread and a connection until they time out
+        if (g_hedgesInFlight.load() >= kMaxHedgesInFlight) {
+            hedgesCapped_++;
+            return;
+        }
+        hedgeTokens_ -= 1.0;
+        hedges_++;
+    }
+    g_hedgesInFlight++;
+    race->hedgesRunning++;
+    uint32_t timeoutMs = static_cast<uint32_t>((std::max)(int64_t(1),
+        static_cast<int64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count())));
+    Attempt attempt = makeHedge();
+    std::thread([race, attempt, timeoutMs]() {
+        int attemptStatus = 0;
+        std::string attemptBody;
+        bool answered = attempt(timeoutMs, attemptStatus, attemptBody);
+        g_hedgesInFlight--;
+        std::lock_guard<std::mutex> lock(race->mutex);
+        race->hedgesRunning--;
+        if (answered && !race->settled && !race->hedgeWon) {
+            race->hedgeWon = true;
+            race->status = attemptStatus;
+            race->body = std::move(attemptBody);
+            if (race->firstRunning) {
+                race->cancelFirst();
+            }
+        }
+        race->changed.notify_all();
+    }).detach();
+}
+
+DaemonCircuitBreaker::Outcome DaemonCircuitBreaker::CallHedged(const DaemonRoutePolicy& policy, const Attempt& first,
+                                                               const std::function<void()>& cancelFirst,
+                                                               const std::function<Attempt()>& makeHedge,
+                                                               int& status, std::string& body) {
+    uint32_t budgetMs = DaemonDeadline::RemainingMs(policy.budgetMs);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        calls_++;
+        hedgeTokens_ = (std::min)(kMaxHedgeTokens, hedgeTokens_ + kHedgeTokensPerCall);
+    }
+    if (budgetMs == 0 || (!policy.probe && !Allow())) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        outcomes_[static_cast<int>(Outcome::FailedFast)]++;
+        return Outcome::FailedFast;
+    }
+
+    auto race = std::make_shared<Race>();
+    race->cancelFirst = cancelFirst;
+    race->firstRunning = true;
+    uint64_t startedUs = NowUs();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(budgetMs);
+    uint32_t hedgeDelayMs = HedgeDelayMs(budgetMs);
+    if (hedgeDelayMs > 0) {
+        // The timer's task only touches this breaker while the race is unsettled, and the race is
+        // settled before this call returns
+        HedgeTimer::GetInstance().Schedule(std::chrono::steady_clock::now() + std::chrono::milliseconds(hedgeDelayMs),
+                                           [this, race, makeHedge, deadline]() { SendHedge(race, makeHedge, deadline); });
+    }
+
+    bool answered = first(budgetMs, status, body);
+    uint64_t elapsedMs = (NowUs() - startedUs) / 1000;
+    std::unique_lock<std::mutex> lock(race->mutex);
+    // A read that failed quickly (a dropped connection, a daemon restarting) gets one more try,
+    // unless a hedge is already out for it
+    if (!answered && !race->hedgeWon && race->hedgesRunning == 0 && elapsedMs < budgetMs / 2) {
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> breakerLock(mutex_);
+            retries_++;
+        }
+        answered = first(static_cast<uint32_t>(budgetMs - elapsedMs), status, body);
+        lock.lock();
+    }
+    race->firstRunning = false;
+    if (!answered) {
+        race->changed.wait_until(lock, deadline, [&race]() { return race->hedgeWon || race->hedgesRunning == 0; });
+    }
+    bool hedgeWon = !answered && race->hedgeWon;
+    if (hedgeWon) {
+        answered = true;
+        status = race->status;
+        body = std::move(race->body);
+    }
+    race->settled = true;
+    lock.unlock();
+
+    Outcome outcome = answered ? Outcome::Answered
+                    : std::chrono::steady_clock::now() >= deadline ? Outcome::TimedOut : Outcome::Failed;
+    if (answered) {
+        OnSuccess(NowUs() - startedUs);
+    } else {
+        OnFailure();
+    }
+    std::lock_guard<std::mutex> breakerLock(mutex_);
+    outcomes_[static_cast<int>(outcome)]++;
+    if (hedgeWon) {
+        hedgeWins_++;
+    }
+    return outcome;
+}
+
+nlohmann::json DaemonCircuitBreaker::GetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    nlohmann::json outcomes = nlohmann::json::object();
+    for (int o = 0; o < 4; o++) {
+        outcomes[OutcomeName(static_cast<Outcome>(o))] = outcomes_[o];
+    }
+    return {
+        {"state", StateName(state_)},
+        {"coolDownMs", coolDownMs_},
+        {"consecutiveFailures", consecutiveFailures_},
+        {"calls", calls_},
+        {"outcomes", outcomes},
+        {"trips", trips_},
+        {"hedges", hedges_},
+        {"hedgeWins", hedgeWins_},
+        {"hedgesInFlight", g_hedgesInFlight.load()},
+        {"hedgesCapped", hedgesCapped_},
+        {"retries", retries_},
+        {"p95AnswerMicros", PercentileMicros(latencies_, 0.95)}
+    };
+}
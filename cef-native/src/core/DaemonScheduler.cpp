@@ -0,0 +1,376 @@
+#include "../../include/core/DaemonScheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+namespace {
+    // Calls in flight at once from every class but UI. The daemon answers many requests in
+    // parallel, but past a handful they only queue up inside it where nothing can reorder them.
+    const size_t kSharedSlots = 8;
+    // Every this many admissions goes to the lowest class waiting, so background sync still moves
+    // under a steady stream of site calls
+    const uint64_t kLowestClassEvery = 16;
+
+    struct ClassLimits {
+        size_t maxWaiting;          // calls waiting in the class
+        size_t maxWaitingPerDomain;
+        uint64_t deadlineMs;        // longest wait for a slot
+        double tokensPerSecond;     // per domain; 0 for no rate limit
+        double burst;
+    };
+
+    const ClassLimits kLimits[DaemonScheduler::kPriorityCount] = {
+        {0, 0, 0, 0, 0},                    // UI: admitted at once
+        {64, 8, 10000, 5, 10},              // auth
+        {256, 32, 5000, 50, 100},           // sites
+        {64, 64, 30000, 0, 0}               // background
+    };
+
+    const size_t kWaitSamples = 1024;
+    // Buckets of sites that have gone quiet are dropped once there are this many
+    const size_t kMaxBuckets = 1024;
+
+    uint64_t NowUs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    double PercentileMicros(std::vector<double> samples, double p) {
+        if (samples.empty()) {
+            return 0.0;
+        }
+        size_t index = static_cast<size_t>(p * (samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return samples[index];
+    }
+}
+
+DaemonScheduler& DaemonScheduler::GetInstance() {
+    static DaemonScheduler instance;
+    return instance;
+}
+
+const char* DaemonScheduler::PriorityName(Priority priority) {
+    switch (priority) {
+        case kUi: return "ui";
+        case kAuth: return "auth";
+        case kDapp: return "dapp";
+        case kBackground: return "background";
+        default: return "unknown";
+    }
+}
+
+const char* DaemonScheduler::VerdictName(Verdict verdict) {
+    switch (verdict) {
+        case kAdmitted: return "admitted";
+        case kRateLimited: return "rateLimited";
+        case kQueueFull: return "queueFull";
+        case kExpired: return "expired";
+        case kCanceled: return "canceled";
+        default: return "unknown";
+    }
+}
+
+DaemonScheduler::Priority DaemonScheduler::ClassifySiteRequest(const std::string& endpoint) {
+    if (endpoint.find("/brc100/auth/") != std::string::npos ||
+        endpoint.find("/.well-known/auth") != std::string::npos ||
+        endpoint.find("/isAuthenticated") != std::string::npos ||
+        endpoint.find("/waitForAuthentication") != std::string::npos) {
+        return kAuth;
+    }
+    return kDapp;
+}
+
+bool DaemonScheduler::IsLongPoll(const std::string& endpoint) {
+    return endpoint.find("/socket.io/") != std::string::npos ||
+           endpoint.find("/waitForAuthentication") != std::string::npos;
+}
+
+uint64_t DaemonScheduler::Submit(Priority priority, const std::string& domain, AdmitCallback admit) {
+    std::vector<Admission> admissions;
+    uint64_t ticket;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ticket = nextTicket_++;
+        ClassStats& stats = stats_[priority];
+        stats.submitted++;
+
+        if (priority == kUi) {
+            stats.verdicts[kAdmitted]++;
+            stats.inFlight++;
+            RecordWait(priority, 0);
+            admissions.emplace_back(std::move(admit), kAdmitted);
+        } else {
+            uint64_t nowUs = NowUs();
+            const ClassLimits& limits = kLimits[priority];
+            ClassQueue& queue = queues_[priority];
+            auto domainQueue = queue.byDomain.find(domain);
+            size_t domainWaiting = domainQueue == queue.byDomain.end() ? 0 : domainQueue->second.size();
+
+            Verdict verdict = kAdmitted;
+            if (!TakeTokenLocked(priority, domain, nowUs)) {
+                verdict = kRateLimited;
+            } else if (queue.size >= limits.maxWaiting || domainWaiting >= limits.maxWaitingPerDomain) {
+                verdict = kQueueFull;
+            }
+
+            if (verdict != kAdmitted) {
+                stats.verdicts[verdict]++;
+                admissions.emplace_back(std::move(admit), verdict);
+            } else {
+                if (domainWaiting == 0) {
+                    queue.turns.push_back(domain);
+                }
+                queue.byDomain[domain].push_back(Waiter{ticket, nowUs, std::move(admit)});
+                queue.size++;
+                stats.peakWaiting = (std::max)(stats.peakWaiting, static_cast<uint64_t>(queue.size));
+                waiting_[ticket] = std::make_pair(priority, domain);
+                DispatchLocked(nowUs, admissions);
+            }
+        }
+    }
+    RunAdmissions(admissions);
+    return ticket;
+}
+
+bool DaemonScheduler::Cancel(uint64_t ticket) {
+    return Withdraw(ticket, kCanceled);
+}
+
+bool DaemonScheduler::Withdraw(uint64_t ticket, Verdict verdict) {
+    AdmitCallback dropped;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto entry = waiting_.find(ticket);
+    if (entry == waiting_.end()) {
+        return false;
+    }
+    Priority priority = entry->second.first;
+    ClassQueue& queue = queues_[priority];
+    auto domainQueue = queue.byDomain.find(entry->second.second);
+    if (domainQueue != queue.byDomain.end()) {
+        std::deque<Waiter>& waiters = domainQueue->second;
+        auto waiter = std::find_if(waiters.begin(), waiters.end(),
+                                   [ticket](const Waiter& w) { return w.ticket == ticket; });
+        if (waiter != waiters.end()) {
+            // Destroyed outside the lock, in case it holds the last reference to its caller
+            dropped = std::move(waiter->admit);
+            waiters.erase(waiter);
+            queue.size--;
+        }
+        if (waiters.empty()) {
+            queue.turns.erase(std::find(queue.turns.begin(), queue.turns.end(), domainQueue->first));
+            queue.byDomain.erase(domainQueue);
+        }
+    }
+    waiting_.erase(entry);
+    stats_[priority].verdicts[verdict]++;
+    return true;
+}
+
+DaemonScheduler::Verdict DaemonScheduler::Acquire(Priority priority, const std::string& domain) {
+    struct Outcome {
+        std::mutex mutex;
+        std::condition_variable decided;
+        bool done = false;
+        Verdict verdict = kCanceled;
+    };
+    auto outcome = std::make_shared<Outcome>();
+
+    uint64_t ticket = Submit(priority, domain, [outcome](Verdict verdict) {
+        std::lock_guard<std::mutex> lock(outcome->mutex);
+        outcome->done = true;
+        outcome->verdict = verdict;
+        outcome->decided.notify_all();
+    });
+
+    std::unique_lock<std::mutex> lock(outcome->mutex);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kLimits[priority].deadlineMs);
+    if (!outcome->decided.wait_until(lock, deadline, [&outcome]() { return outcome->done; })) {
+        // Nothing has freed a slot since the deadline passed; if the call was admitted or shed
+        // meanwhile, its callback is on its way
+        lock.unlock();
+        if (Withdraw(ticket, kExpired)) {
+            return kExpired;
+        }
+        lock.lock();
+        outcome->decided.wait(lock, [&outcome]() { return outcome->done; });
+    }
+    return outcome->verdict;
+}
+
+void DaemonScheduler::Release(Priority priority) {
+    std::vector<Admission> admissions;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stats_[priority].inFlight > 0) {
+            stats_[priority].inFlight--;
+        }
+        if (priority != kUi && sharedInFlight_ > 0) {
+            sharedInFlight_--;
+        }
+        DispatchLocked(NowUs(), admissions);
+    }
+    RunAdmissions(admissions);
+}
+
+bool DaemonScheduler::TakeToken(Priority priority, const std::string& domain) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_[priority].submitted++;
+    bool taken = TakeTokenLocked(priority, domain, NowUs());
+    stats_[priority].verdicts[taken ? kAdmitted : kRateLimited]++;
+    return taken;
+}
+
+bool DaemonScheduler::TakeTokenLocked(Priority priority, const std::string& domain, uint64_t nowUs) {
+    const ClassLimits& limits = kLimits[priority];
+    if (limits.tokensPerSecond <= 0) {
+        return true;
+    }
+
+    std::unordered_map<std::string, Bucket>& buckets = buckets_[priority];
+    auto bucket = buckets.find(domain);
+    if (bucket == buckets.end()) {
+        if (buckets.size() >= kMaxBuckets) {
+            // A bucket that has refilled is the same as none at all
+            for (auto it = buckets.begin(); it != buckets.end();) {
+                double refill = (nowUs - it->second.refilledUs) / 1e6 * limits.tokensPerSecond;
+                it = it->second.tokens + refill >= limits.burst ? buckets.erase(it) : std::next(it);
+            }
+        }
+        bucket = buckets.emplace(domain, Bucket{limits.burst, nowUs}).first;
+    }
+
+    Bucket& b = bucket->second;
+    b.tokens = (std::min)(limits.burst, b.tokens + (nowUs - b.refilledUs) / 1e6 * limits.tokensPerSecond);
+    b.refilledUs = nowUs;
+    if (b.tokens < 1.0) {
+        return false;
+    }
+    b.tokens -= 1.0;
+    return true;
+}
+
+void DaemonScheduler::DispatchLocked(uint64_t nowUs, std::vector<Admission>& admissions) {
+    // Shed calls that have waited too long; each domain's queue is in arrival order
+    for (int p = kAuth; p < kPriorityCount; p++) {
+        ClassQueue& queue = queues_[p];
+        if (queue.size == 0) {
+            continue;
+        }
+        uint64_t deadlineUs = kLimits[p].deadlineMs * 1000;
+        for (auto domainQueue = queue.byDomain.begin(); domainQueue != queue.byDomain.end();) {
+            std::deque<Waiter>& waiters = domainQueue->second;
+            while (!waiters.empty() && nowUs - waiters.front().enqueuedUs > deadlineUs) {
+                waiting_.erase(waiters.front().ticket);
+                stats_[p].verdicts[kExpired]++;
+                admissions.emplace_back(std::move(waiters.front().admit), kExpired);
+                waiters.pop_front();
+                queue.size--;
+            }
+            if (waiters.empty()) {
+                queue.turns.erase(std::find(queue.turns.begin(), queue.turns.end(), domainQueue->first));
+                domainQueue = queue.byDomain.erase(domainQueue);
+            } else {
+                ++domainQueue;
+            }
+        }
+    }
+
+    while (sharedInFlight_ < kSharedSlots) {
+        int chosen = -1;
+        bool lowestTurn = dispatches_ % kLowestClassEvery == kLowestClassEvery - 1;
+        for (int p = kAuth; p < kPriorityCount; p++) {
+            if (queues_[p].size > 0) {
+                chosen = p;
+                if (!lowestTurn) {
+                    break;
+                }
+            }
+        }
+        if (chosen < 0) {
+            return;
+        }
+
+        Priority priority = static_cast<Priority>(chosen);
+        Waiter waiter;
+        if (!PopNext(priority, waiter)) {
+            return;
+        }
+        dispatches_++;
+        sharedInFlight_++;
+        stats_[priority].inFlight++;
+        stats_[priority].verdicts[kAdmitted]++;
+        RecordWait(priority, nowUs - waiter.enqueuedUs);
+        admissions.emplace_back(std::move(waiter.admit), kAdmitted);
+    }
+}
+
+bool DaemonScheduler::PopNext(Priority priority, Waiter& waiter) {
+    ClassQueue& queue = queues_[priority];
+    if (queue.turns.empty()) {
+        return false;
+    }
+    std::string domain = std::move(queue.turns.front());
+    queue.turns.pop_front();
+
+    auto domainQueue = queue.byDomain.find(domain);
+    std::deque<Waiter>& waiters = domainQueue->second;
+    waiter = std::move(waiters.front());
+    waiters.pop_front();
+    queue.size--;
+    waiting_.erase(waiter.ticket);
+
+    // Back of the line until every other waiting domain has had a call admitted
+    if (waiters.empty()) {
+        queue.byDomain.erase(domainQueue);
+    } else {
+        queue.turns.push_back(std::move(domain));
+    }
+    return true;
+}
+
+void DaemonScheduler::RecordWait(Priority priority, uint64_t micros) {
+    ClassStats& stats = stats_[priority];
+    if (stats.waitMicros.size() < kWaitSamples) {
+        stats.waitMicros.push_back(static_cast<double>(micros));
+    } else {
+        stats.waitMicros[stats.nextWait] = static_cast<double>(micros);
+        stats.nextWait = (stats.nextWait + 1) % kWaitSamples;
+    }
+}
+
+void DaemonScheduler::RunAdmissions(std::vector<Admission>& admissions) {
+    for (Admission& admission : admissions) {
+        if (admission.first) {
+            admission.first(admission.second);
+        }
+    }
+    admissions.clear();
+}
+
+nlohmann::json DaemonScheduler::GetStats() {
+    nlohmann::json classes = nlohmann::json::object();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int p = 0; p < kPriorityCount; p++) {
+        const ClassStats& stats = stats_[p];
+        nlohmann::json verdicts = nlohmann::json::object();
+        for (int v = kAdmitted; v <= kCanceled; v++) {
+            verdicts[VerdictName(static_cast<Verdict>(v))] = stats.verdicts[v];
+        }
+        classes[PriorityName(static_cast<Priority>(p))] = {
+            {"submitted", stats.submitted},
+            {"verdicts", verdicts},
+            {"inFlight", stats.inFlight},
+            {"waiting", queues_[p].size},
+            {"waitingDomains", queues_[p].byDomain.size()},
+            {"peakWaiting", stats.peakWaiting},
+            {"p50WaitMicros", PercentileMicros(stats.waitMicros, 0.5)},
+            {"p99WaitMicros", PercentileMicros(stats.waitMicros, 0.99)}
+        };
+    }
+    return {
+        {"sharedSlots", kSharedSlots},
+        {"sharedInFlight", sharedInFlight_},
+        {"classes", classes}
+    };
+}
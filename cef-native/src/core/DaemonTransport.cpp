@@ -0,0 +1,486 @@
+#include "../../include/core/DaemonTransport.h"
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+#else
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+#define LOG_DEBUG_BROWSER(msg) Logger::Log(msg, 0, 2)
+#define LOG_INFO_BROWSER(msg) Logger::Log(msg, 1, 2)
+#define LOG_WARNING_BROWSER(msg) Logger::Log(msg, 2, 2)
+
+namespace {
+#ifdef _WIN32
+    const int kSendFlags = 0;
+
+    bool StartSockets() {
+        static std::once_flag once;
+        static bool started = false;
+        std::call_once(once, [] {
+            WSADATA data;
+            started = WSAStartup(MAKEWORD(2, 2), &data) == 0;
+        });
+        return started;
+    }
+
+    bool RecvTimedOut() {
+        return WSAGetLastError() == WSAETIMEDOUT;
+    }
+
+    void SetTimeouts(SOCKET s, DWORD timeoutMs) {
+        setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeoutMs), sizeof(timeoutMs));
+        setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeoutMs), sizeof(timeoutMs));
+    }
+#else
+    // The Winsock names this file uses, over POSIX sockets, so the client builds and is tested on Linux
+    typedef int SOCKET;
+    typedef uint32_t DWORD;
+    const SOCKET INVALID_SOCKET = -1;
+    const int SOCKET_ERROR = -1;
+    const int SD_BOTH = SHUT_RDWR;
+    // A daemon that has hung up must not end the process with SIGPIPE
+    const int kSendFlags = MSG_NOSIGNAL;
+
+    bool StartSockets() {
+        return true;
+    }
+
+    int closesocket(SOCKET s) {
+        return close(s);
+    }
+
+    bool RecvTimedOut() {
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+
+    void SetTimeouts(SOCKET s, DWORD timeoutMs) {
+        timeval timeout = {static_cast<time_t>(timeoutMs / 1000), static_cast<suseconds_t>((timeoutMs % 1000) * 1000)};
+        setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    }
+
+    uint64_t GetTickCount64() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+#endif
+
+    const uintptr_t kNoSocket = static_cast<uintptr_t>(INVALID_SOCKET);
+
+    // Same as WinHTTP's default receive timeout, which the TCP path runs with
+    const DWORD kRequestTimeoutMs = 30000;
+    // The daemon sends a heartbeat on /wallet/events every 15 s
+    const DWORD kStreamTimeoutMs = 45000;
+    // How long requests skip the socket after it failed to connect
+    const uint64_t kSocketRetryMs = 5000;
+
+    const size_t kMaxHeadBytes = 64 * 1024;
+    const size_t kReadChunkBytes = 64 * 1024;
+
+    SOCKET Connect(const std::string& path, DWORD timeoutMs) {
+        if (path.empty() || !StartSockets()) {
+            return INVALID_SOCKET;
+        }
+
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) {
+            return INVALID_SOCKET;
+        }
+        memcpy(address.sun_path, path.c_str(), path.size());
+
+        SOCKET s = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (s == INVALID_SOCKET) {
+            return INVALID_SOCKET;
+        }
+        if (connect(s, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == SOCKET_ERROR) {
+            closesocket(s);
+            return INVALID_SOCKET;
+        }
+        SetTimeouts(s, timeoutMs);
+        return s;
+    }
+
+    bool SendAll(SOCKET s, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            int chunk = static_cast<int>((std::min)(data.size() - sent, size_t(1) << 30));
+            int n = send(s, data.data() + sent, chunk, kSendFlags);
+            if (n == SOCKET_ERROR) {
+                return false;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    std::string FormatRequest(const std::string& method, const std::string& endpoint, const std::string& body) {
+        std::string request = method + " " + endpoint + " HTTP/1.1\r\n"
+                              "Host: localhost\r\n"
+                              "Content-Type: application/json\r\n";
+        if (!body.empty() || method != "GET") {
+            request += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+        }
+        request += "\r\n";
+        request += body;
+        return request;
+    }
+
+    void LowerCase(std::string& text) {
+        std::transform(text.begin(), text.end(), text.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    }
+
+    struct ResponseHead {
+        int status = 0;
+        bool chunked = false;
+        // -1 when the body runs until the daemon closes the connection
+        int64_t contentLength = -1;
+        bool close = false;
+    };
+
+    // Reads one HTTP/1.1 response off a socket: the status line and headers, then the body by
+    // Content-Length, chunked encoding or until the connection closes, in pieces as they arrive
+    class ResponseReader {
+    public:
+        explicit ResponseReader(SOCKET s) : socket_(s) {}
+
+        // Bytes received before the first failure, and whether that failure was a timeout: a
+        // connection that ended with nothing at all back never delivered the request
+        size_t received() const { return received_; }
+        bool timedOut() const { return timedOut_; }
+
+        bool ReadHead(ResponseHead& head) {
+            std::string line;
+            if (!ReadLine(line) || line.compare(0, 5, "HTTP/") != 0) {
+                return false;
+            }
+            size_t space = line.find(' ');
+            if (space == std::string::npos) {
+                return false;
+            }
+            head.status = std::atoi(line.c_str() + space + 1);
+            head.close = line.compare(0, 8, "HTTP/1.0") == 0;
+
+            size_t headBytes = line.size();
+            while (ReadLine(line)) {
+                if (line.empty()) {
+                    return head.status > 0;
+                }
+                headBytes += line.size() + 2;
+                if (headBytes > kMaxHeadBytes) {
+                    return false;
+                }
+                size_t colon = line.find(':');
+                if (colon == std::string::npos) {
+                    continue;
+                }
+                std::string name = line.substr(0, colon);
+                LowerCase(name);
+                std::string value = line.substr(colon + 1);
+                value.erase(0, value.find_first_not_of(" \t"));
+                LowerCase(value);
+
+                if (name == "content-length") {
+                    head.contentLength = std::strtoll(value.c_str(), nullptr, 10);
+                } else if (name == "transfer-encoding") {
+                    head.chunked = value.find("chunked") != std::string::npos;
+                } else if (name == "connection") {
+                    head.close = value.find("close") != std::string::npos;
+                }
+            }
+            return false;
+        }
+
+        // True once the whole body went to onData; false when the socket failed or onData
+        // returned false
+        bool ReadBody(const ResponseHead& head, const std::function<bool(const char*, size_t)>& onData) {
+            if (head.chunked) {
+                std::string line;
+                while (ReadLine(line)) {
+                    uint64_t size = std::strtoull(line.c_str(), nullptr, 16);
+                    if (size == 0) {
+                        // Trailers, then the blank line ending the response
+                        while (ReadLine(line)) {
+                            if (line.empty()) {
+                                return true;
+                            }
+                        }
+                        return false;
+                    }
+                    if (!Deliver(size, onData) || !ReadLine(line)) {
+                        return false;
+                    }
+                }
+                return false;
+            }
+            if (head.contentLength >= 0) {
+                return Deliver(static_cast<uint64_t>(head.contentLength), onData);
+            }
+            while (true) {
+                if (pos_ < buffer_.size()) {
+                    if (!onData(buffer_.data() + pos_, buffer_.size() - pos_)) {
+                        return false;
+                    }
+                    pos_ = buffer_.size();
+                }
+                if (!Fill()) {
+                    return !timedOut_;
+                }
+            }
+        }
+
+    private:
+        bool Fill() {
+            if (pos_ == buffer_.size()) {
+                buffer_.clear();
+                pos_ = 0;
+            }
+            size_t used = buffer_.size();
+            buffer_.resize(used + kReadChunkBytes);
+            int n = recv(socket_, &buffer_[used], static_cast<int>(kReadChunkBytes), 0);
+            if (n <= 0) {
+                timedOut_ = n == SOCKET_ERROR && RecvTimedOut();
+                buffer_.resize(used);
+                return false;
+            }
+            buffer_.resize(used + static_cast<size_t>(n));
+            received_ += static_cast<size_t>(n);
+            return true;
+        }
+
+        bool ReadLine(std::string& line) {
+            size_t searchFrom = pos_;
+            while (true) {
+                size_t end = buffer_.find("\r\n", searchFrom);
+                if (end != std::string::npos) {
+                    if (end - pos_ > kMaxHeadBytes) {
+                        return false;
+                    }
+                    line.assign(buffer_, pos_, end - pos_);
+                    pos_ = end + 2;
+                    return true;
+                }
+                if (buffer_.size() - pos_ > kMaxHeadBytes) {
+                    return false;
+                }
+                // A line split across reads may end in a '\r' already scanned
+                size_t scanned = buffer_.size() - pos_;
+                if (!Fill()) {
+                    return false;
+                }
+                searchFrom = pos_ + (scanned > 0 ? scanned - 1 : 0);
+            }
+        }
+
+        bool Deliver(uint64_t length, const std::function<bool(const char*, size_t)>& onData) {
+            while (length > 0) {
+                if (pos_ == buffer_.size() && !Fill()) {
+                    return false;
+                }
+                size_t n = static_cast<size_t>((std::min)(static_cast<uint64_t>(buffer_.size() - pos_), length));
+                if (!onData(buffer_.data() + pos_, n)) {
+                    return false;
+                }
+                pos_ += n;
+                length -= n;
+            }
+            return true;
+        }
+
+        SOCKET socket_;
+        std::string buffer_;
+        size_t pos_ = 0;
+        size_t received_ = 0;
+        bool timedOut_ = false;
+    };
+}
+
+DaemonTransport& DaemonTransport::GetInstance() {
+    static DaemonTransport instance;
+    return instance;
+}
+
+DaemonTransport::DaemonTransport() {
+    // Where the daemon's ServeLocalSocket puts it
+    if (const char* homeDir = std::getenv("USERPROFILE")) {
+        socketPath_ = std::string(homeDir) + "\\AppData\\Roaming\\BabbageBrowser\\wallet\\daemon.sock";
+    }
+}
+
+const char* DaemonTransport::ModeName(Mode mode) {
+    return mode == Mode::Tcp ? "tcp" : "auto";
+}
+
+bool DaemonTransport::SocketAvailable() const {
+    return mode_ == Mode::Auto && !socketPath_.empty() && GetTickCount64() >= socketRetryAt_.load();
+}
+
+void DaemonTransport::OnSocketConnectFailed() {
+    if (socketRetryAt_.exchange(GetTickCount64() + kSocketRetryMs) == 0) {
+        LOG_INFO_BROWSER("🔌 Wallet daemon socket not reachable at " + socketPath_ + ", using TCP until it is");
+    }
+}
+
+nlohmann::json DaemonTransport::GetStats() const {
+    return {
+        {"mode", ModeName(mode_)},
+        {"socketPath", socketPath_},
+        {"socketAvailable", SocketAvailable()},
+        {"socketRequests", socketRequests_.load()},
+        {"socketFailures", socketFailures_.load()},
+        {"tcpRequests", tcpRequests_.load()}
+    };
+}
+
+DaemonSocket::~DaemonSocket() {
+    CloseConnection();
+}
+
+void DaemonSocket::CloseConnection() {
+    std::lock_guard<std::mutex> lock(connectionMutex_);
+    if (connection_ != kNoSocket) {
+        closesocket(static_cast<SOCKET>(connection_));
+        connection_ = kNoSocket;
+    }
+}
+
+DaemonSocket::Result DaemonSocket::Request(const std::string& method, const std::string& endpoint,
+                                           const std::string& body, int& status, std::string& responseBody,
+                                           uint32_t timeoutMs) {
+    DaemonTransport& transport = DaemonTransport::GetInstance();
+    const bool ownDaemon = path_.empty();
+    const std::string request = FormatRequest(method, endpoint, body);
+    const DWORD timeout = timeoutMs > 0 ? timeoutMs : kRequestTimeoutMs;
+    {
+        std::lock_guard<std::mutex> lock(connectionMutex_);
+        requestCanceled_ = false;
+    }
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        bool reused = connection_ != kNoSocket;
+        if (!reused) {
+            if (ownDaemon && !transport.SocketAvailable()) {
+                return Result::Unavailable;
+            }
+            SOCKET s = Connect(ownDaemon ? transport.SocketPath() : path_, timeout);
+            if (s == INVALID_SOCKET) {
+                if (ownDaemon) {
+                    transport.OnSocketConnectFailed();
+                }
+                return Result::Unavailable;
+            }
+            std::lock_guard<std::mutex> lock(connectionMutex_);
+            connection_ = static_cast<uintptr_t>(s);
+        }
+
+        SOCKET s = static_cast<SOCKET>(connection_);
+        if (reused) {
+            SetTimeouts(s, timeout);
+        }
+        ResponseReader reader(s);
+        ResponseHead head;
+        if (SendAll(s, request) && reader.ReadHead(head)) {
+            responseBody.clear();
+            bool complete = reader.ReadBody(head, [&responseBody](const char* data, size_t size) {
+                responseBody.append(data, size);
+                return true;
+            });
+            if (!complete || head.close) {
+                CloseConnection();
+            }
+            if (complete) {
+                status = head.status;
+                if (ownDaemon) {
+                    transport.RecordSocketRequest(true);
+                }
+                return Result::Ok;
+            }
+            break;
+        }
+
+        bool nothingBack = reader.received() == 0 && !reader.timedOut();
+        bool canceled;
+        {
+            std::lock_guard<std::mutex> lock(connectionMutex_);
+            canceled = requestCanceled_;
+        }
+        CloseConnection();
+        // A kept-alive connection the daemon has since dropped fails without a byte coming back;
+        // the request never reached a handler, so it is safe to send again on a new connection.
+        // One shut down by CancelRequest() looks the same, but its caller has its answer already.
+        if (!reused || !nothingBack || canceled) {
+            break;
+        }
+    }
+
+    if (ownDaemon) {
+        transport.RecordSocketRequest(false);
+    }
+    return Result::Failed;
+}
+
+int DaemonSocket::Stream(const std::string& endpoint, const std::function<void()>& onOpen,
+                         const std::function<bool(const char*, size_t)>& onData) {
+    DaemonTransport& transport = DaemonTransport::GetInstance();
+    const bool ownDaemon = path_.empty();
+    if (ownDaemon && !transport.SocketAvailable()) {
+        return 0;
+    }
+    SOCKET s = Connect(ownDaemon ? transport.SocketPath() : path_, kStreamTimeoutMs);
+    if (s == INVALID_SOCKET) {
+        if (ownDaemon) {
+            transport.OnSocketConnectFailed();
+        }
+        return 0;
+    }
+    stream_ = static_cast<uintptr_t>(s);
+
+    ResponseReader reader(s);
+    ResponseHead head;
+    int status = -1;
+    if (SendAll(s, FormatRequest("GET", endpoint, "")) && reader.ReadHead(head)) {
+        status = head.status;
+        if (status == 200) {
+            onOpen();
+            reader.ReadBody(head, onData);
+        }
+    }
+
+    // Cancel() only shuts the socket down, so closing it stays with this thread
+    stream_ = kNoSocket;
+    closesocket(s);
+    return status;
+}
+
+void DaemonSocket::Cancel() {
+    uintptr_t s = stream_.exchange(kNoSocket);
+    if (s != kNoSocket) {
+        shutdown(static_cast<SOCKET>(s), SD_BOTH);
+    }
+}
+
+void DaemonSocket::CancelRequest() {
+    std::lock_guard<std::mutex> lock(connectionMutex_);
+    requestCanceled_ = true;
+    if (connection_ != kNoSocket) {
+        shutdown(static_cast<SOCKET>(connection_), SD_BOTH);
+    }
+}
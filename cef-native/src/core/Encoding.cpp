@@ -0,0 +1,529 @@
+#include "../../include/core/Encoding.h"
+
+#include <array>
+#include <atomic>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define ENCODING_HAS_X86_SIMD 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC exposes every intrinsic unconditionally; GCC/Clang need the ISA enabled per function
+#if defined(ENCODING_HAS_X86_SIMD) && !defined(_MSC_VER)
+#define ENCODING_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define ENCODING_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define ENCODING_TARGET_SSSE3
+#define ENCODING_TARGET_AVX2
+#endif
+
+namespace {
+
+    enum class SimdLevel { Scalar, SSSE3, AVX2 };
+
+    SimdLevel detectSimdLevel() {
+#if defined(ENCODING_HAS_X86_SIMD)
+#if defined(_MSC_VER)
+        int info[4] = { 0 };
+        __cpuid(info, 0);
+        int maxLeaf = info[0];
+
+        __cpuid(info, 1);
+        bool ssse3 = (info[2] & (1 << 9)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+
+        bool avx2 = false;
+        if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+        }
+#else
+        __builtin_cpu_init();
+        bool ssse3 = __builtin_cpu_supports("ssse3");
+        bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+        if (avx2) return SimdLevel::AVX2;
+        if (ssse3) return SimdLevel::SSSE3;
+#endif
+        return SimdLevel::Scalar;
+    }
+
+    SimdLevel detectedSimdLevel() {
+        static const SimdLevel level = detectSimdLevel();
+        return level;
+    }
+
+    // -1 until forceImplementation() pins a level
+    std::atomic<int> forcedSimdLevel{-1};
+
+    SimdLevel simdLevel() {
+        int forced = forcedSimdLevel.load(std::memory_order_relaxed);
+        return forced >= 0 ? static_cast<SimdLevel>(forced) : detectedSimdLevel();
+    }
+
+    const char kHexDigits[] = "0123456789abcdef";
+    const char kBase64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    // 0..15 for hex digits, -1 otherwise
+    const std::array<int8_t, 256>& hexTable() {
+        static const std::array<int8_t, 256> table = [] {
+            std::array<int8_t, 256> t;
+            t.fill(-1);
+            for (int i = 0; i < 10; ++i) t['0' + i] = static_cast<int8_t>(i);
+            for (int i = 0; i < 6; ++i) {
+                t['a' + i] = static_cast<int8_t>(10 + i);
+                t['A' + i] = static_cast<int8_t>(10 + i);
+            }
+            return t;
+        }();
+        return table;
+    }
+
+    // 0..63 for base64 characters, -1 otherwise ('=' is handled separately)
+    const std::array<int8_t, 256>& base64Table() {
+        static const std::array<int8_t, 256> table = [] {
+            std::array<int8_t, 256> t;
+            t.fill(-1);
+            for (int i = 0; i < 64; ++i) {
+                t[static_cast<uint8_t>(kBase64Alphabet[i])] = static_cast<int8_t>(i);
+            }
+            return t;
+        }();
+        return table;
+    }
+
+    // ========== Scalar tails ==========
+
+    void hexEncodeScalar(const uint8_t* src, size_t i, size_t length, char* dst) {
+        for (; i < length; ++i) {
+            dst[2 * i] = kHexDigits[src[i] >> 4];
+            dst[2 * i + 1] = kHexDigits[src[i] & 0x0f];
+        }
+    }
+
+    bool hexDecodeScalar(const char* src, size_t i, size_t length, uint8_t* dst) {
+        const auto& table = hexTable();
+        for (; i < length; i += 2) {
+            int8_t hi = table[static_cast<uint8_t>(src[i])];
+            int8_t lo = table[static_cast<uint8_t>(src[i + 1])];
+            if (hi < 0 || lo < 0) return false;
+            dst[i / 2] = static_cast<uint8_t>((hi << 4) | lo);
+        }
+        return true;
+    }
+
+    void base64EncodeScalar(const uint8_t* src, size_t i, size_t length, char* dst) {
+        char* out = dst + (i / 3) * 4;
+        for (; i + 3 <= length; i += 3) {
+            uint32_t v = (uint32_t(src[i]) << 16) | (uint32_t(src[i + 1]) << 8) | src[i + 2];
+            *out++ = kBase64Alphabet[(v >> 18) & 0x3f];
+            *out++ = kBase64Alphabet[(v >> 12) & 0x3f];
+            *out++ = kBase64Alphabet[(v >> 6) & 0x3f];
+            *out++ = kBase64Alphabet[v & 0x3f];
+        }
+        size_t remaining = length - i;
+        if (remaining == 1) {
+            uint32_t v = uint32_t(src[i]) << 16;
+            *out++ = kBase64Alphabet[(v >> 18) & 0x3f];
+            *out++ = kBase64Alphabet[(v >> 12) & 0x3f];
+            *out++ = '=';
+            *out++ = '=';
+        } else if (remaining == 2) {
+            uint32_t v = (uint32_t(src[i]) << 16) | (uint32_t(src[i + 1]) << 8);
+            *out++ = kBase64Alphabet[(v >> 18) & 0x3f];
+            *out++ = kBase64Alphabet[(v >> 12) & 0x3f];
+            *out++ = kBase64Alphabet[(v >> 6) & 0x3f];
+            *out++ = '=';
+        }
+    }
+
+    // Decodes full quads in [i, end); padding is not accepted here
+    bool base64DecodeScalar(const char* src, size_t i, size_t end, uint8_t* dst) {
+        const auto& table = base64Table();
+        uint8_t* out = dst + (i / 4) * 3;
+        for (; i < end; i += 4) {
+            int8_t a = table[static_cast<uint8_t>(src[i])];
+            int8_t b = table[static_cast<uint8_t>(src[i + 1])];
+            int8_t c = table[static_cast<uint8_t>(src[i + 2])];
+            int8_t d = table[static_cast<uint8_t>(src[i + 3])];
+            if ((a | b | c | d) < 0) return false;
+            uint32_t v = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6) | uint32_t(d);
+            *out++ = static_cast<uint8_t>(v >> 16);
+            *out++ = static_cast<uint8_t>(v >> 8);
+            *out++ = static_cast<uint8_t>(v);
+        }
+        return true;
+    }
+
+#if defined(ENCODING_HAS_X86_SIMD)
+
+    // ========== SSSE3 ==========
+
+    // 16 bytes -> 32 hex chars per iteration
+    ENCODING_TARGET_SSSE3 size_t hexEncodeSSSE3(const uint8_t* src, size_t length, char* dst) {
+        const __m128i lut = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kHexDigits));
+        const __m128i mask = _mm_set1_epi8(0x0f);
+        size_t i = 0;
+        for (; i + 16 <= length; i += 16) {
+            __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(in, 4), mask));
+            __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(in, mask));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i), _mm_unpacklo_epi8(hi, lo));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
+        }
+        return i;
+    }
+
+    // Maps 16 hex chars to nibble values; false if any char is not a hex digit
+    ENCODING_TARGET_SSSE3 inline bool hexNibblesSSSE3(__m128i chars, __m128i& nibbles) {
+        const __m128i minusOne = _mm_set1_epi8(-1);
+        __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+        __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(digit, minusOne), _mm_cmpgt_epi8(_mm_set1_epi8(10), digit));
+        __m128i alpha = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+        __m128i isAlpha = _mm_and_si128(_mm_cmpgt_epi8(alpha, minusOne), _mm_cmpgt_epi8(_mm_set1_epi8(6), alpha));
+        if (_mm_movemask_epi8(_mm_or_si128(isDigit, isAlpha)) != 0xffff) return false;
+        nibbles = _mm_or_si128(_mm_and_si128(isDigit, digit),
+                               _mm_and_si128(isAlpha, _mm_add_epi8(alpha, _mm_set1_epi8(10))));
+        return true;
+    }
+
+    // 32 hex chars -> 16 bytes per iteration; returns chars consumed or SIZE_MAX on invalid input
+    ENCODING_TARGET_SSSE3 size_t hexDecodeSSSE3(const char* src, size_t length, uint8_t* dst) {
+        const __m128i weights = _mm_set1_epi16(0x0110);
+        size_t i = 0;
+        for (; i + 32 <= length; i += 32) {
+            __m128i a, b;
+            if (!hexNibblesSSSE3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), a) ||
+                !hexNibblesSSSE3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16)), b)) {
+                return SIZE_MAX;
+            }
+            __m128i packed = _mm_packus_epi16(_mm_maddubs_epi16(a, weights), _mm_maddubs_epi16(b, weights));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i / 2), packed);
+        }
+        return i;
+    }
+
+    // 12 bytes -> 16 chars per iteration (reads 16 bytes)
+    ENCODING_TARGET_SSSE3 size_t base64EncodeSSSE3(const uint8_t* src, size_t length, char* dst) {
+        const __m128i shuffle = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+        const __m128i shiftLut = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                               '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                               '/' - 63, 'A', 0, 0);
+        size_t i = 0;
+        char* out = dst;
+        for (; i + 16 <= length; i += 12, out += 16) {
+            __m128i in = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), shuffle);
+            __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+            __m128i t1 = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+            __m128i indices = _mm_or_si128(t0, t1);
+
+            __m128i reduced = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+            __m128i isUpper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+            reduced = _mm_or_si128(reduced, _mm_and_si128(isUpper, _mm_set1_epi8(13)));
+            __m128i chars = _mm_add_epi8(_mm_shuffle_epi8(shiftLut, reduced), indices);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), chars);
+        }
+        return i;
+    }
+
+    // 16 chars -> 12 bytes per iteration (writes 16 bytes); returns chars consumed or SIZE_MAX
+    ENCODING_TARGET_SSSE3 size_t base64DecodeSSSE3(const char* src, size_t end, uint8_t* dst) {
+        const __m128i lutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                            0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+        const __m128i lutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+        const __m128i lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+        const __m128i mask = _mm_set1_epi8(0x0f);
+        const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+        size_t i = 0;
+        uint8_t* out = dst;
+        for (; i + 16 <= end; i += 16, out += 12) {
+            __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask);
+            __m128i lo = _mm_shuffle_epi8(lutLo, _mm_and_si128(in, mask));
+            __m128i hi = _mm_shuffle_epi8(lutHi, hiNibbles);
+            if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0) {
+                return SIZE_MAX;
+            }
+            __m128i isSlash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+            __m128i values = _mm_add_epi8(in, _mm_shuffle_epi8(lutRoll, _mm_add_epi8(isSlash, hiNibbles)));
+
+            __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+            __m128i bytes = _mm_shuffle_epi8(_mm_madd_epi16(merged, _mm_set1_epi32(0x00011000)), pack);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), bytes);
+        }
+        return i;
+    }
+
+    // ========== AVX2 ==========
+
+    // 16 bytes -> 32 hex chars per iteration, widening each byte into its own 16-bit lane
+    ENCODING_TARGET_AVX2 size_t hexEncodeAVX2(const uint8_t* src, size_t length, char* dst) {
+        const __m256i lut = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(kHexDigits)));
+        const __m256i mask = _mm256_set1_epi16(0x0f);
+        size_t i = 0;
+        for (; i + 16 <= length; i += 16) {
+            __m256i words = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+            __m256i indices = _mm256_or_si256(_mm256_srli_epi16(words, 4),
+                                              _mm256_slli_epi16(_mm256_and_si256(words, mask), 8));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 2 * i), _mm256_shuffle_epi8(lut, indices));
+        }
+        return i;
+    }
+
+    ENCODING_TARGET_AVX2 inline bool hexNibblesAVX2(__m256i chars, __m256i& nibbles) {
+        const __m256i minusOne = _mm256_set1_epi8(-1);
+        __m256i digit = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+        __m256i isDigit = _mm256_and_si256(_mm256_cmpgt_epi8(digit, minusOne), _mm256_cmpgt_epi8(_mm256_set1_epi8(10), digit));
+        __m256i alpha = _mm256_sub_epi8(_mm256_or_si256(chars, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+        __m256i isAlpha = _mm256_and_si256(_mm256_cmpgt_epi8(alpha, minusOne), _mm256_cmpgt_epi8(_mm256_set1_epi8(6), alpha));
+        if (_mm256_movemask_epi8(_mm256_or_si256(isDigit, isAlpha)) != -1) return false;
+        nibbles = _mm256_or_si256(_mm256_and_si256(isDigit, digit),
+                                  _mm256_and_si256(isAlpha, _mm256_add_epi8(alpha, _mm256_set1_epi8(10))));
+        return true;
+    }
+
+    // 64 hex chars -> 32 bytes per iteration
+    ENCODING_TARGET_AVX2 size_t hexDecodeAVX2(const char* src, size_t length, uint8_t* dst) {
+        const __m256i weights = _mm256_set1_epi16(0x0110);
+        size_t i = 0;
+        for (; i + 64 <= length; i += 64) {
+            __m256i a, b;
+            if (!hexNibblesAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)), a) ||
+                !hexNibblesAVX2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 32)), b)) {
+                return SIZE_MAX;
+            }
+            __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(a, weights), _mm256_maddubs_epi16(b, weights));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i / 2), _mm256_permute4x64_epi64(packed, 0xd8));
+        }
+        return i;
+    }
+
+    // 24 bytes -> 32 chars per iteration; each 128-bit lane takes 12 input bytes (reads 28 bytes)
+    ENCODING_TARGET_AVX2 size_t base64EncodeAVX2(const uint8_t* src, size_t length, char* dst) {
+        const __m256i shuffle = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                                 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+        const __m256i shiftLut = _mm256_broadcastsi128_si256(
+            _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                          '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                          '/' - 63, 'A', 0, 0));
+        size_t i = 0;
+        char* out = dst;
+        for (; i + 28 <= length; i += 24, out += 32) {
+            __m256i in = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12)), 1);
+            in = _mm256_shuffle_epi8(in, shuffle);
+            __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+            __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+            __m256i indices = _mm256_or_si256(t0, t1);
+
+            __m256i reduced = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+            __m256i isUpper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+            reduced = _mm256_or_si256(reduced, _mm256_and_si256(isUpper, _mm256_set1_epi8(13)));
+            __m256i chars = _mm256_add_epi8(_mm256_shuffle_epi8(shiftLut, reduced), indices);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), chars);
+        }
+        return i;
+    }
+
+    // 32 chars -> 24 bytes per iteration (writes 32 bytes); returns chars consumed or SIZE_MAX
+    ENCODING_TARGET_AVX2 size_t base64DecodeAVX2(const char* src, size_t end, uint8_t* dst) {
+        const __m256i lutLo = _mm256_broadcastsi128_si256(
+            _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                          0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a));
+        const __m256i lutHi = _mm256_broadcastsi128_si256(
+            _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                          0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10));
+        const __m256i lutRoll = _mm256_broadcastsi128_si256(
+            _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0));
+        const __m256i mask = _mm256_set1_epi8(0x0f);
+        const __m256i pack = _mm256_broadcastsi128_si256(
+            _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        const __m256i compact = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7);
+
+        size_t i = 0;
+        uint8_t* out = dst;
+        for (; i + 32 <= end; i += 32, out += 24) {
+            __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            __m256i hiNibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), mask);
+            __m256i lo = _mm256_shuffle_epi8(lutLo, _mm256_and_si256(in, mask));
+            __m256i hi = _mm256_shuffle_epi8(lutHi, hiNibbles);
+            if (_mm256_movemask_epi8(_mm256_cmpgt_epi8(_mm256_and_si256(lo, hi), _mm256_setzero_si256())) != 0) {
+                return SIZE_MAX;
+            }
+            __m256i isSlash = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/'));
+            __m256i values = _mm256_add_epi8(in, _mm256_shuffle_epi8(lutRoll, _mm256_add_epi8(isSlash, hiNibbles)));
+
+            __m256i merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+            __m256i bytes = _mm256_shuffle_epi8(_mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000)), pack);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permutevar8x32_epi32(bytes, compact));
+        }
+        return i;
+    }
+
+#endif // ENCODING_HAS_X86_SIMD
+
+    // Slack so vector stores past the logical end stay inside the buffer
+    const size_t kDecodeSlack = 32;
+}
+
+namespace Encoding {
+
+std::string hexEncode(const uint8_t* data, size_t length) {
+    std::string out(length * 2, '\0');
+    if (length == 0) return out;
+
+    size_t i = 0;
+#if defined(ENCODING_HAS_X86_SIMD)
+    switch (simdLevel()) {
+        case SimdLevel::AVX2:  i = hexEncodeAVX2(data, length, &out[0]); break;
+        case SimdLevel::SSSE3: i = hexEncodeSSSE3(data, length, &out[0]); break;
+        default: break;
+    }
+#endif
+    hexEncodeScalar(data, i, length, &out[0]);
+    return out;
+}
+
+std::string hexEncode(const std::string& bytes) {
+    return hexEncode(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+}
+
+bool hexDecode(const std::string& hex, std::string& out) {
+    out.clear();
+    const size_t length = hex.size();
+    if (length % 2 != 0) return false;
+    if (length == 0) return true;
+
+    std::string buffer(length / 2 + kDecodeSlack, '\0');
+    uint8_t* dst = reinterpret_cast<uint8_t*>(&buffer[0]);
+
+    size_t i = 0;
+#if defined(ENCODING_HAS_X86_SIMD)
+    switch (simdLevel()) {
+        case SimdLevel::AVX2:  i = hexDecodeAVX2(hex.data(), length, dst); break;
+        case SimdLevel::SSSE3: i = hexDecodeSSSE3(hex.data(), length, dst); break;
+        default: break;
+    }
+    if (i == SIZE_MAX) return false;
+#endif
+    if (!hexDecodeScalar(hex.data(), i, length, dst)) return false;
+
+    buffer.resize(length / 2);
+    out.swap(buffer);
+    return true;
+}
+
+bool isValidHex(const std::string& hex) {
+    std::string scratch;
+    return hexDecode(hex, scratch);
+}
+
+std::string base64Encode(const uint8_t* data, size_t length) {
+    std::string out(((length + 2) / 3) * 4, '\0');
+    if (length == 0) return out;
+
+    size_t i = 0;
+#if defined(ENCODING_HAS_X86_SIMD)
+    switch (simdLevel()) {
+        case SimdLevel::AVX2:  i = base64EncodeAVX2(data, length, &out[0]); break;
+        case SimdLevel::SSSE3: i = base64EncodeSSSE3(data, length, &out[0]); break;
+        default: break;
+    }
+#endif
+    base64EncodeScalar(data, i, length, &out[0]);
+    return out;
+}
+
+std::string base64Encode(const std::string& bytes) {
+    return base64Encode(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size());
+}
+
+bool base64Decode(const std::string& base64, std::string& out) {
+    out.clear();
+    const size_t length = base64.size();
+    if (length % 4 != 0) return false;
+    if (length == 0) return true;
+
+    size_t padding = 0;
+    if (base64[length - 1] == '=') ++padding;
+    if (base64[length - 2] == '=') ++padding;
+    if (padding == 1 && base64[length - 2] == '=') return false;
+
+    // Everything except the final quad is unpadded and goes through the fast path
+    const size_t bodyEnd = length - 4;
+    const size_t decodedLength = (length / 4) * 3 - padding;
+    std::string buffer(decodedLength + kDecodeSlack, '\0');
+    uint8_t* dst = reinterpret_cast<uint8_t*>(&buffer[0]);
+
+    size_t i = 0;
+#if defined(ENCODING_HAS_X86_SIMD)
+    switch (simdLevel()) {
+        case SimdLevel::AVX2:  i = base64DecodeAVX2(base64.data(), bodyEnd, dst); break;
+        case SimdLevel::SSSE3: i = base64DecodeSSSE3(base64.data(), bodyEnd, dst); break;
+        default: break;
+    }
+    if (i == SIZE_MAX) return false;
+#endif
+    if (!base64DecodeScalar(base64.data(), i, bodyEnd, dst)) return false;
+
+    // Final quad, which may carry one or two '=' characters
+    const auto& table = base64Table();
+    const char* tail = base64.data() + bodyEnd;
+    int8_t a = table[static_cast<uint8_t>(tail[0])];
+    int8_t b = table[static_cast<uint8_t>(tail[1])];
+    int8_t c = padding >= 2 ? 0 : table[static_cast<uint8_t>(tail[2])];
+    int8_t d = padding >= 1 ? 0 : table[static_cast<uint8_t>(tail[3])];
+    if ((a | b | c | d) < 0) return false;
+
+    uint32_t v = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6) | uint32_t(d);
+    uint8_t* out3 = dst + (bodyEnd / 4) * 3;
+    out3[0] = static_cast<uint8_t>(v >> 16);
+    if (padding < 2) out3[1] = static_cast<uint8_t>(v >> 8);
+    if (padding < 1) out3[2] = static_cast<uint8_t>(v);
+
+    buffer.resize(decodedLength);
+    out.swap(buffer);
+    return true;
+}
+
+bool isValidBase64(const std::string& base64) {
+    std::string scratch;
+    return base64Decode(base64, scratch);
+}
+
+const char* activeImplementation() {
+    switch (simdLevel()) {
+        case SimdLevel::AVX2:  return "avx2";
+        case SimdLevel::SSSE3: return "ssse3";
+        default:               return "scalar";
+    }
+}
+
+bool forceImplementation(const std::string& name) {
+    if (name == "auto") {
+        forcedSimdLevel = -1;
+        return true;
+    }
+
+    SimdLevel level;
+    if (name == "avx2") level = SimdLevel::AVX2;
+    else if (name == "ssse3") level = SimdLevel::SSSE3;
+    else if (name == "scalar") level = SimdLevel::Scalar;
+    else return false;
+
+    // Levels are ordered, and a CPU that has one has every level below it
+    if (static_cast<int>(level) > static_cast<int>(detectedSimdLevel())) {
+        return false;
+    }
+    forcedSimdLevel = static_cast<int>(level);
+    return true;
+}
+
+} // namespace Encoding
@@ -0,0 +1,399 @@
+#include "../../include/core/FrontendBundle.h"
+#include "include/cef_parser.h"
+#include "include/wrapper/cef_helpers.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+#define LOG_DEBUG_BROWSER(msg) Logger::Log(msg, 0, 2)
+#define LOG_INFO_BROWSER(msg) Logger::Log(msg, 1, 2)
+#define LOG_WARNING_BROWSER(msg) Logger::Log(msg, 2, 2)
+
+const char* FrontendBundle::kScheme = "bitcoin-browser";
+const char* FrontendBundle::kHost = "app";
+
+namespace {
+    const char kMagic[8] = { 'B', 'B', 'F', 'E', 'P', 'K', '0', '1' };
+    const char* kDevServerOrigin = "http://127.0.0.1:5137";
+    const char* kBundleOrigin = "bitcoin-browser://app";
+    const char* kEncodingNames[] = { "identity", "br", "gzip" };
+
+    // The URL's origin is exactly this one (not merely a prefix of its host or port)
+    bool HasOrigin(const std::string& url, const char* origin) {
+        size_t length = std::strlen(origin);
+        return url.compare(0, length, origin) == 0 &&
+               (url.size() == length || url[length] == '/' || url[length] == '?' || url[length] == '#');
+    }
+
+    // Bounds-checked little-endian reader over the mapped index
+    class IndexReader {
+    public:
+        IndexReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+        bool Read(void* out, size_t bytes) {
+            if (bytes > size_ - pos_) {
+                return false;
+            }
+            std::memcpy(out, data_ + pos_, bytes);
+            pos_ += bytes;
+            return true;
+        }
+
+        bool ReadString(size_t bytes, std::string& out) {
+            if (bytes > size_ - pos_) {
+                return false;
+            }
+            out.assign(reinterpret_cast<const char*>(data_ + pos_), bytes);
+            pos_ += bytes;
+            return true;
+        }
+
+    private:
+        const uint8_t* data_;
+        size_t size_;
+        size_t pos_ = 0;
+    };
+
+    bool AcceptsEncoding(const std::string& acceptEncoding, const char* token) {
+        size_t pos = acceptEncoding.find(token);
+        while (pos != std::string::npos) {
+            size_t end = pos + std::strlen(token);
+            bool startOk = pos == 0 || acceptEncoding[pos - 1] == ' ' || acceptEncoding[pos - 1] == ',';
+            bool endOk = end == acceptEncoding.size() || acceptEncoding[end] == ',' ||
+                         acceptEncoding[end] == ';' || acceptEncoding[end] == ' ';
+            if (startOk && endOk) {
+                return true;
+            }
+            pos = acceptEncoding.find(token, end);
+        }
+        return false;
+    }
+
+    class FrontendResourceHandler : public CefResourceHandler {
+    public:
+        bool Open(CefRefPtr<CefRequest> request,
+                  bool& handle_request,
+                  CefRefPtr<CefCallback> callback) override {
+            CEF_REQUIRE_IO_THREAD();
+
+            // Everything is already in memory, so the request completes synchronously
+            handle_request = true;
+
+            FrontendBundle& bundle = FrontendBundle::GetInstance();
+            CefURLParts parts;
+            std::string path = "/";
+            if (CefParseURL(request->GetURL(), parts)) {
+                path = CefString(&parts.path).ToString();
+            }
+
+            entry_ = bundle.Find(path);
+            if (!entry_) {
+                bundle.RecordMiss();
+                LOG_WARNING_BROWSER("⚠️ Frontend bundle has no entry for " + path);
+                status_ = 404;
+                return true;
+            }
+
+            if (request->GetHeaderByName("If-None-Match").ToString() == entry_->etag) {
+                bundle.RecordNotModified();
+                status_ = 304;
+                return true;
+            }
+
+            std::string acceptEncoding = request->GetHeaderByName("Accept-Encoding");
+            if (entry_->data[FrontendBundle::kBrotli] && AcceptsEncoding(acceptEncoding, "br")) {
+                encoding_ = FrontendBundle::kBrotli;
+            } else if (entry_->data[FrontendBundle::kGzip] && AcceptsEncoding(acceptEncoding, "gzip")) {
+                encoding_ = FrontendBundle::kGzip;
+            }
+
+            immutable_ = path.compare(0, 8, "/assets/") == 0;
+            status_ = 200;
+            bundle.RecordServed(encoding_, entry_->length[encoding_]);
+            return true;
+        }
+
+        void GetResponseHeaders(CefRefPtr<CefResponse> response,
+                                int64_t& response_length,
+                                CefString& redirectUrl) override {
+            CEF_REQUIRE_IO_THREAD();
+
+            response->SetStatus(status_);
+            if (status_ == 404) {
+                response->SetStatusText("Not Found");
+                response->SetMimeType("text/plain");
+                response_length = 0;
+                return;
+            }
+
+            response->SetStatusText(status_ == 304 ? "Not Modified" : "OK");
+            response->SetMimeType(entry_->mime);
+            if (entry_->mime.compare(0, 5, "text/") == 0 || entry_->mime == "application/json") {
+                response->SetCharset("utf-8");
+            }
+            response->SetHeaderByName("ETag", entry_->etag, true);
+            response->SetHeaderByName("Vary", "Accept-Encoding", true);
+
+            // Vite fingerprints everything under /assets/; the HTML entry points must revalidate
+            response->SetHeaderByName("Cache-Control",
+                                      immutable_ ? "public, max-age=31536000, immutable" : "no-cache", true);
+
+            if (status_ == 304) {
+                response_length = 0;
+                return;
+            }
+
+            if (encoding_ != FrontendBundle::kIdentity) {
+                response->SetHeaderByName("Content-Encoding", kEncodingNames[encoding_], true);
+            }
+            response_length = entry_->length[encoding_];
+        }
+
+        bool Read(void* data_out,
+                  int bytes_to_read,
+                  int& bytes_read,
+                  CefRefPtr<CefResourceReadCallback> callback) override {
+            bytes_read = 0;
+            if (status_ != 200) {
+                return false;
+            }
+
+            uint32_t length = entry_->length[encoding_];
+            if (offset_ >= length) {
+                return false;
+            }
+
+            bytes_read = static_cast<int>((std::min<uint32_t>)(length - offset_, static_cast<uint32_t>(bytes_to_read)));
+            std::memcpy(data_out, entry_->data[encoding_] + offset_, bytes_read);
+            offset_ += bytes_read;
+            return true;
+        }
+
+        bool Skip(int64_t bytes_to_skip,
+                  int64_t& bytes_skipped,
+                  CefRefPtr<CefResourceSkipCallback> callback) override {
+            uint32_t length = entry_ ? entry_->length[encoding_] : 0;
+            int64_t remaining = static_cast<int64_t>(length) - offset_;
+            bytes_skipped = (std::min)(bytes_to_skip, remaining);
+            offset_ += static_cast<uint32_t>(bytes_skipped);
+            return bytes_skipped > 0;
+        }
+
+        void Cancel() override {}
+
+    private:
+        const FrontendBundle::Entry* entry_ = nullptr;
+        FrontendBundle::Encoding encoding_ = FrontendBundle::kIdentity;
+        int status_ = 404;
+        bool immutable_ = false;
+        uint32_t offset_ = 0;
+
+        IMPLEMENT_REFCOUNTING(FrontendResourceHandler);
+    };
+}
+
+FrontendBundle& FrontendBundle::GetInstance() {
+    static FrontendBundle instance;
+    return instance;
+}
+
+bool FrontendBundle::Open(const std::wstring& path) {
+    auto start = std::chrono::steady_clock::now();
+
+    file_ = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+        LOG_INFO_BROWSER("📦 No frontend bundle found, UI will load from the dev server");
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file_, &fileSize) || fileSize.QuadPart < 16) {
+        LOG_WARNING_BROWSER("⚠️ Frontend bundle is empty or unreadable");
+        Close();
+        return false;
+    }
+
+    mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    view_ = mapping_ ? static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+    if (!view_) {
+        LOG_WARNING_BROWSER("⚠️ Failed to map frontend bundle (error " + std::to_string(GetLastError()) + ")");
+        Close();
+        return false;
+    }
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+
+    if (!ParseIndex(view_, size_)) {
+        LOG_WARNING_BROWSER("⚠️ Frontend bundle index is corrupt, falling back to the dev server");
+        Close();
+        return false;
+    }
+
+    openMicros_ = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    LOG_INFO_BROWSER("📦 Frontend bundle mapped: " + std::to_string(entries_.size()) + " entries, " +
+                     std::to_string(size_) + " bytes in " + std::to_string(openMicros_) + " us");
+    return true;
+}
+
+void FrontendBundle::Close() {
+    entries_.clear();
+    if (view_) {
+        UnmapViewOfFile(view_);
+        view_ = nullptr;
+    }
+    if (mapping_) {
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+    }
+    if (file_ != INVALID_HANDLE_VALUE) {
+        CloseHandle(file_);
+        file_ = INVALID_HANDLE_VALUE;
+    }
+    size_ = 0;
+}
+
+bool FrontendBundle::ParseIndex(const uint8_t* base, size_t size) {
+    if (std::memcmp(base, kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+
+    uint32_t entryCount = 0;
+    uint32_t indexBytes = 0;
+    std::memcpy(&entryCount, base + 8, 4);
+    std::memcpy(&indexBytes, base + 12, 4);
+    if (indexBytes > size - 16) {
+        return false;
+    }
+
+    IndexReader reader(base + 16, indexBytes);
+    entries_.reserve(entryCount);
+
+    for (uint32_t i = 0; i < entryCount; i++) {
+        uint16_t pathLen = 0;
+        uint8_t mimeLen = 0;
+        uint64_t etag = 0;
+        std::string path;
+        Entry entry;
+
+        if (!reader.Read(&pathLen, 2) || !reader.ReadString(pathLen, path) ||
+            !reader.Read(&mimeLen, 1) || !reader.ReadString(mimeLen, entry.mime) ||
+            !reader.Read(&etag, 8)) {
+            return false;
+        }
+
+        char etagText[24];
+        std::snprintf(etagText, sizeof(etagText), "\"%016llx\"", static_cast<unsigned long long>(etag));
+        entry.etag = etagText;
+
+        for (int e = 0; e < kEncodingCount; e++) {
+            uint64_t offset = 0;
+            uint32_t length = 0;
+            if (!reader.Read(&offset, 8) || !reader.Read(&length, 4)) {
+                return false;
+            }
+            if (offset == 0) {
+                continue;
+            }
+            if (offset > size || length > size - offset) {
+                return false;
+            }
+            entry.data[e] = base + offset;
+            entry.length[e] = length;
+        }
+
+        entries_.emplace(std::move(path), std::move(entry));
+    }
+
+    return entries_.count("/index.html") == 1;
+}
+
+void FrontendBundle::RegisterSchemeHandler() {
+    CEF_REQUIRE_UI_THREAD();
+
+    if (!IsOpen()) {
+        return;
+    }
+    CefRegisterSchemeHandlerFactory(kScheme, kHost, new FrontendSchemeHandlerFactory());
+}
+
+const FrontendBundle::Entry* FrontendBundle::Find(const std::string& path) const {
+    std::string key = (path.empty() || path == "/") ? "/index.html" : path;
+
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+        return &it->second;
+    }
+
+    // Client-side routes (/settings, /wallet, ...) have no file; hand them the SPA shell
+    size_t lastSlash = key.find_last_of('/');
+    if (key.find('.', lastSlash == std::string::npos ? 0 : lastSlash) == std::string::npos) {
+        it = entries_.find("/index.html");
+        if (it != entries_.end()) {
+            return &it->second;
+        }
+    }
+    return nullptr;
+}
+
+std::string FrontendBundle::Url(const std::string& route) const {
+    return std::string(IsOpen() ? kBundleOrigin : kDevServerOrigin) + route;
+}
+
+bool FrontendBundle::IsAppUrl(const std::string& url) {
+    return HasOrigin(url, kBundleOrigin) || HasOrigin(url, kDevServerOrigin);
+}
+
+bool FrontendBundle::IsAppRootUrl(const std::string& url) {
+    std::string bundleRoot = std::string(kBundleOrigin) + "/";
+    std::string devRoot = std::string(kDevServerOrigin) + "/";
+    return url == kBundleOrigin || url == bundleRoot || url == kDevServerOrigin || url == devRoot;
+}
+
+void FrontendBundle::RecordServed(Encoding encoding, uint32_t bytes) {
+    served_[encoding]++;
+    servedBytes_[encoding] += bytes;
+}
+
+void FrontendBundle::RecordNotModified() {
+    notModified_++;
+}
+
+void FrontendBundle::RecordMiss() {
+    misses_++;
+}
+
+nlohmann::json FrontendBundle::GetStats() const {
+    nlohmann::json served = nlohmann::json::object();
+    for (int e = 0; e < kEncodingCount; e++) {
+        served[kEncodingNames[e]] = {
+            {"responses", served_[e].load()},
+            {"bytes", servedBytes_[e].load()}
+        };
+    }
+
+    return {
+        {"source", IsOpen() ? "bundle" : "devServer"},
+        {"origin", IsOpen() ? kBundleOrigin : kDevServerOrigin},
+        {"entries", entries_.size()},
+        {"mappedBytes", size_},
+        {"openMicros", openMicros_},
+        {"served", served},
+        {"notModified", notModified_.load()},
+        {"misses", misses_.load()}
+    };
+}
+
+CefRefPtr<CefResourceHandler> FrontendSchemeHandlerFactory::Create(CefRefPtr<CefBrowser> browser,
+                                                                   CefRefPtr<CefFrame> frame,
+                                                                   const CefString& scheme_name,
+                                                                   CefRefPtr<CefRequest> request) {
+    return new FrontendResourceHandler();
+}
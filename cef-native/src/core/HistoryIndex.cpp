@@ -0,0 +1,357 @@
+#include "../../include/core/HistoryIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <functional>
+
+namespace {
+    // Inserts are merged into the sorted array in batches of this size
+    const size_t kMaxPending = 1024;
+
+    // Bound the work a single keystroke can cause on very common prefixes or trigrams; past
+    // these the best of the matches seen so far is returned
+    const size_t kMaxPrefixScan = 4000;
+    const size_t kMaxSubstringScan = 1000;
+
+    // Queries up to this long are answered from the precomputed top lists
+    const size_t kShortPrefixLength = 3;
+    const size_t kShortTopSize = 32;
+    const int64_t kShortRefreshMs = 5 * 1000;
+    const int64_t kShortMaxAgeMs = 60 * 60 * 1000;
+
+    // Distinct trigrams indexed per host or title
+    const size_t kMaxTrigramsPerText = 64;
+
+    // A URL that starts with what was typed beats one that merely contains it
+    const double kPrefixBonus = 2.0;
+
+    const int64_t kDayMs = 24ll * 60 * 60 * 1000;
+
+    using Candidate = std::pair<double, uint32_t>;
+
+    std::string Lowercase(const std::string& text) {
+        std::string lower(text);
+        for (char& c : lower) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        return lower;
+    }
+
+    bool StartsWith(const std::string& text, const std::string& prefix) {
+        return text.size() >= prefix.size() && text.compare(0, prefix.size(), prefix) == 0;
+    }
+
+    // query is already lowercase
+    bool ContainsIgnoreCase(const std::string& text, const std::string& query) {
+        return std::search(text.begin(), text.end(), query.begin(), query.end(), [](char a, char b) {
+            return std::tolower(static_cast<unsigned char>(a)) == b;
+        }) != text.end();
+    }
+
+    uint32_t TrigramAt(const std::string& text, size_t i) {
+        return (static_cast<uint32_t>(static_cast<unsigned char>(text[i])) << 16) |
+               (static_cast<uint32_t>(static_cast<unsigned char>(text[i + 1])) << 8) |
+               static_cast<uint32_t>(static_cast<unsigned char>(text[i + 2]));
+    }
+
+    // The first `length` (at most three) bytes of the key, zero-padded
+    uint32_t ShortCode(const std::string& key, size_t length) {
+        uint32_t code = 0;
+        for (size_t i = 0; i < kShortPrefixLength; i++) {
+            code = (code << 8) | (i < length ? static_cast<unsigned char>(key[i]) : 0);
+        }
+        return code;
+    }
+
+    std::string HostOfKey(const std::string& key) {
+        return key.substr(0, key.find_first_of("/?#"));
+    }
+
+    // Keeps the best `limit` candidates in a min-heap; an index seen twice keeps its higher score
+    void Offer(std::vector<Candidate>& heap, size_t limit, uint32_t index, double score) {
+        if (heap.size() == limit && score <= heap.front().first) {
+            return;
+        }
+        for (Candidate& candidate : heap) {
+            if (candidate.second == index) {
+                if (score > candidate.first) {
+                    candidate.first = score;
+                    std::make_heap(heap.begin(), heap.end(), std::greater<Candidate>());
+                }
+                return;
+            }
+        }
+        heap.emplace_back(score, index);
+        std::push_heap(heap.begin(), heap.end(), std::greater<Candidate>());
+        if (heap.size() > limit) {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<Candidate>());
+            heap.pop_back();
+        }
+    }
+}
+
+std::string HistoryIndex::KeyOf(const std::string& text) {
+    size_t start = text.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t\r\n");
+    std::string key = Lowercase(text.substr(start, end - start + 1));
+
+    size_t schemeEnd = key.find("://");
+    if (schemeEnd != std::string::npos && schemeEnd < 16) {
+        key.erase(0, schemeEnd + 3);
+    }
+    if (StartsWith(key, "www.")) {
+        key.erase(0, 4);
+    }
+    return key;
+}
+
+// Firefox-style buckets: recent visits weigh more, typed visits count three times
+double HistoryIndex::Frecency(const Entry& entry, int64_t nowMs) {
+    int64_t ageMs = nowMs - entry.lastVisitMs;
+    double recency = 10.0;
+    if (ageMs < 4 * kDayMs) {
+        recency = 100.0;
+    } else if (ageMs < 14 * kDayMs) {
+        recency = 70.0;
+    } else if (ageMs < 31 * kDayMs) {
+        recency = 50.0;
+    } else if (ageMs < 90 * kDayMs) {
+        recency = 30.0;
+    }
+    return (entry.visits + 2.0 * entry.typed) * recency;
+}
+
+uint32_t HistoryIndex::FindOrInsert(const std::string& url) {
+    auto it = byUrl_.find(url);
+    if (it != byUrl_.end()) {
+        return it->second;
+    }
+
+    uint32_t index = static_cast<uint32_t>(entries_.size());
+    Entry entry;
+    entry.url = url;
+    entry.key = KeyOf(url);
+    entries_.push_back(std::move(entry));
+    byUrl_.emplace(url, index);
+    IndexTrigrams(index, HostOfKey(entries_[index].key));
+
+    pending_.push_back(index);
+    if (!bulk_ && pending_.size() >= kMaxPending) {
+        MergePending();
+    }
+    return index;
+}
+
+void HistoryIndex::AddVisit(const std::string& url, int64_t timeMs, bool typed) {
+    Entry& entry = entries_[FindOrInsert(url)];
+    entry.visits++;
+    if (typed) {
+        entry.typed++;
+    }
+    entry.lastVisitMs = (std::max)(entry.lastVisitMs, timeMs);
+    visitCount_++;
+    shortDirty_ = true;
+}
+
+void HistoryIndex::AddAggregate(const std::string& url, const std::string& title,
+                                uint32_t visits, uint32_t typed, int64_t lastVisitMs) {
+    Entry& entry = entries_[FindOrInsert(url)];
+    entry.visits += visits;
+    entry.typed += typed;
+    entry.lastVisitMs = (std::max)(entry.lastVisitMs, lastVisitMs);
+    visitCount_ += visits;
+    shortDirty_ = true;
+    if (!title.empty()) {
+        SetTitle(url, title);
+    }
+}
+
+bool HistoryIndex::SetTitle(const std::string& url, const std::string& title) {
+    auto it = byUrl_.find(url);
+    if (it == byUrl_.end()) {
+        return false;
+    }
+    Entry& entry = entries_[it->second];
+    if (entry.title == title) {
+        return false;
+    }
+    entry.title = title;
+    // Trigrams of an older title stay behind; matches are re-checked against the current one
+    IndexTrigrams(it->second, Lowercase(title));
+    return true;
+}
+
+void HistoryIndex::IndexTrigrams(uint32_t index, const std::string& text) {
+    if (text.size() < 3) {
+        return;
+    }
+    std::vector<uint32_t> codes;
+    codes.reserve(text.size() - 2);
+    for (size_t i = 0; i + 2 < text.size(); i++) {
+        codes.push_back(TrigramAt(text, i));
+    }
+    std::sort(codes.begin(), codes.end());
+    codes.erase(std::unique(codes.begin(), codes.end()), codes.end());
+    if (codes.size() > kMaxTrigramsPerText) {
+        codes.resize(kMaxTrigramsPerText);
+    }
+
+    for (uint32_t code : codes) {
+        std::vector<uint32_t>& postings = trigrams_[code];
+        if (postings.empty() || postings.back() != index) {
+            postings.push_back(index);
+        }
+    }
+}
+
+void HistoryIndex::MergePending() {
+    if (pending_.empty()) {
+        return;
+    }
+    auto less = [this](uint32_t a, uint32_t b) { return KeyLess(a, b); };
+    std::sort(pending_.begin(), pending_.end(), less);
+    std::vector<uint32_t> merged;
+    merged.reserve(sorted_.size() + pending_.size());
+    std::merge(sorted_.begin(), sorted_.end(), pending_.begin(), pending_.end(), std::back_inserter(merged), less);
+    sorted_.swap(merged);
+    pending_.clear();
+}
+
+void HistoryIndex::BeginBulk() {
+    bulk_ = true;
+}
+
+void HistoryIndex::EndBulk(int64_t nowMs) {
+    bulk_ = false;
+    MergePending();
+    RefreshShortPrefixes(nowMs, true);
+}
+
+// Short prefixes match too much of the history to rank per keystroke, so their best entries are
+// kept precomputed; between rebuilds new URLs are still found through the pending list
+void HistoryIndex::RefreshShortPrefixes(int64_t nowMs, bool force) {
+    int64_t age = nowMs - shortBuiltMs_;
+    if (!force && !(shortDirty_ && age >= kShortRefreshMs) && age < kShortMaxAgeMs) {
+        return;
+    }
+
+    std::unordered_map<uint32_t, std::vector<Candidate>> heaps;
+    for (uint32_t i = 0; i < entries_.size(); i++) {
+        const Entry& entry = entries_[i];
+        double score = Frecency(entry, nowMs);
+        size_t lengths = (std::min)(entry.key.size(), kShortPrefixLength);
+        for (size_t length = 1; length <= lengths; length++) {
+            Offer(heaps[ShortCode(entry.key, length)], kShortTopSize, i, score);
+        }
+    }
+
+    shortTop_.clear();
+    for (auto& pair : heaps) {
+        std::sort(pair.second.begin(), pair.second.end(), std::greater<Candidate>());
+        std::vector<uint32_t>& top = shortTop_[pair.first];
+        top.reserve(pair.second.size());
+        for (const Candidate& candidate : pair.second) {
+            top.push_back(candidate.second);
+        }
+    }
+    shortBuiltMs_ = nowMs;
+    shortDirty_ = false;
+}
+
+std::vector<HistoryIndex::Suggestion> HistoryIndex::Query(const std::string& text, size_t limit, int64_t nowMs) {
+    std::vector<Suggestion> results;
+    std::string query = KeyOf(text);
+    if (query.empty() || limit == 0 || entries_.empty()) {
+        return results;
+    }
+
+    std::vector<Candidate> heap;
+    heap.reserve(limit + 1);
+
+    // URLs whose key starts with the query
+    if (query.size() <= kShortPrefixLength) {
+        RefreshShortPrefixes(nowMs, false);
+        auto top = shortTop_.find(ShortCode(query, query.size()));
+        if (top != shortTop_.end()) {
+            for (uint32_t index : top->second) {
+                Offer(heap, limit, index, Frecency(entries_[index], nowMs) * kPrefixBonus);
+            }
+        }
+    } else {
+        auto it = std::lower_bound(sorted_.begin(), sorted_.end(), query, [this](uint32_t index, const std::string& value) {
+            return entries_[index].key < value;
+        });
+        for (size_t scanned = 0; it != sorted_.end() && scanned < kMaxPrefixScan; ++it, ++scanned) {
+            const Entry& entry = entries_[*it];
+            if (!StartsWith(entry.key, query)) {
+                break;
+            }
+            Offer(heap, limit, *it, Frecency(entry, nowMs) * kPrefixBonus);
+        }
+    }
+    for (uint32_t index : pending_) {
+        if (StartsWith(entries_[index].key, query)) {
+            Offer(heap, limit, index, Frecency(entries_[index], nowMs) * kPrefixBonus);
+        }
+    }
+
+    // URLs whose host or title contains the query, found through its rarest trigram
+    if (query.size() >= 3) {
+        const std::vector<uint32_t>* rarest = nullptr;
+        for (size_t i = 0; i + 2 < query.size(); i++) {
+            auto postings = trigrams_.find(TrigramAt(query, i));
+            if (postings == trigrams_.end()) {
+                rarest = nullptr;
+                break;
+            }
+            if (!rarest || postings->second.size() < rarest->size()) {
+                rarest = &postings->second;
+            }
+        }
+        if (rarest) {
+            // Newest URLs first: they are the likelier to rank when the scan is cut short
+            size_t scanned = 0;
+            for (auto it = rarest->rbegin(); it != rarest->rend() && scanned < kMaxSubstringScan; ++it, ++scanned) {
+                uint32_t index = *it;
+                const Entry& entry = entries_[index];
+                if (entry.key.find(query) != std::string::npos || ContainsIgnoreCase(entry.title, query)) {
+                    Offer(heap, limit, index, Frecency(entry, nowMs));
+                }
+            }
+        }
+    }
+
+    std::sort(heap.begin(), heap.end(), std::greater<Candidate>());
+    results.reserve(heap.size());
+    for (const Candidate& candidate : heap) {
+        const Entry& entry = entries_[candidate.second];
+        Suggestion suggestion;
+        suggestion.url = entry.url;
+        suggestion.title = entry.title;
+        suggestion.visits = entry.visits;
+        suggestion.typed = entry.typed;
+        suggestion.prefixMatch = StartsWith(entry.key, query);
+        suggestion.score = candidate.first;
+        results.push_back(std::move(suggestion));
+    }
+    return results;
+}
+
+// Approximate: string payloads and container storage, not allocator overhead
+size_t HistoryIndex::MemoryBytes() const {
+    size_t bytes = entries_.capacity() * sizeof(Entry);
+    for (const Entry& entry : entries_) {
+        bytes += entry.url.capacity() * 2 + entry.key.capacity() + entry.title.capacity();
+    }
+    bytes += byUrl_.size() * (sizeof(std::pair<const std::string, uint32_t>) + 2 * sizeof(void*));
+    bytes += (sorted_.capacity() + pending_.capacity()) * sizeof(uint32_t);
+    for (const auto& pair : trigrams_) {
+        bytes += sizeof(pair) + pair.second.capacity() * sizeof(uint32_t);
+    }
+    for (const auto& pair : shortTop_) {
+        bytes += sizeof(pair) + pair.second.capacity() * sizeof(uint32_t);
+    }
+    return bytes;
+}
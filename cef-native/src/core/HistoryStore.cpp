@@ -0,0 +1,435 @@
+#include "../../include/core/HistoryStore.h"
+#include "../../include/core/ProfileCache.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+#include "include/base/cef_bind.h"
+#include <windows.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+#define LOG_DEBUG_BROWSER(msg) Logger::Log(msg, 0, 2)
+#define LOG_INFO_BROWSER(msg) Logger::Log(msg, 1, 2)
+#define LOG_WARNING_BROWSER(msg) Logger::Log(msg, 2, 2)
+
+namespace fs = std::filesystem;
+
+namespace {
+    const char kLogMagic[8] = { 'B', 'B', 'H', 'I', 'S', 'T', '0', '1' };
+
+    enum RecordType : uint8_t {
+        kVisitRecord = 1,
+        kTitleRecord = 2,
+        // Compacted totals for one URL: the header is followed by visits and typed counts
+        kAggregateRecord = 3
+    };
+
+    const uint8_t kTypedFlag = 1;
+
+#pragma pack(push, 1)
+    struct RecordHeader {
+        uint8_t type;
+        uint8_t flags;
+        uint16_t urlLength;
+        uint16_t titleLength;
+        int64_t timeMs;
+    };
+
+    struct AggregateCounts {
+        uint32_t visits;
+        uint32_t typed;
+    };
+#pragma pack(pop)
+
+    const size_t kMaxUrlLength = 2048;
+    const size_t kMaxTitleLength = 512;
+
+    // The log is rewritten once it holds this many records and several per URL
+    const uint64_t kCompactMinRecords = 20000;
+    const uint64_t kCompactRecordsPerUrl = 4;
+
+    // How long after an address bar navigation the active tab's visit still counts as typed
+    const long long kTypedWindowMs = 15000;
+
+    const size_t kMaxResults = 20;
+    const size_t kRecentQuerySamples = 256;
+
+    // File thread only
+    HANDLE g_historyLog = INVALID_HANDLE_VALUE;
+
+    int64_t NowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    bool IsHistoryUrl(const std::string& url) {
+        return (url.compare(0, 7, "http://") == 0 || url.compare(0, 8, "https://") == 0) &&
+               url.size() <= kMaxUrlLength;
+    }
+
+    // Cuts at a UTF-8 character boundary
+    std::string TruncateTitle(const std::string& title) {
+        if (title.size() <= kMaxTitleLength) {
+            return title;
+        }
+        size_t length = kMaxTitleLength;
+        while (length > 0 && (static_cast<unsigned char>(title[length]) & 0xC0) == 0x80) {
+            length--;
+        }
+        return title.substr(0, length);
+    }
+
+    std::string EncodeRecord(uint8_t type, uint8_t flags, const std::string& url, const std::string& title,
+                             int64_t timeMs, const AggregateCounts* counts = nullptr) {
+        RecordHeader header;
+        header.type = type;
+        header.flags = flags;
+        header.urlLength = static_cast<uint16_t>(url.size());
+        header.titleLength = static_cast<uint16_t>(title.size());
+        header.timeMs = timeMs;
+
+        std::string record(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (counts) {
+            record.append(reinterpret_cast<const char*>(counts), sizeof(*counts));
+        }
+        record.append(url);
+        record.append(title);
+        return record;
+    }
+
+    bool WriteAll(HANDLE file, const std::string& data) {
+        DWORD written = 0;
+        return WriteFile(file, data.data(), static_cast<DWORD>(data.size()), &written, nullptr) &&
+               written == data.size();
+    }
+
+    // Replays records from the mapped log; returns the offset just past the last intact record
+    uint64_t ReplayLog(const char* data, uint64_t size, HistoryIndex& index, uint64_t& records) {
+        uint64_t offset = sizeof(kLogMagic);
+        while (offset + sizeof(RecordHeader) <= size) {
+            RecordHeader header;
+            std::memcpy(&header, data + offset, sizeof(header));
+            uint64_t countsSize = header.type == kAggregateRecord ? sizeof(AggregateCounts) : 0;
+            uint64_t length = sizeof(header) + countsSize + header.urlLength + header.titleLength;
+            if (header.type < kVisitRecord || header.type > kAggregateRecord ||
+                header.urlLength == 0 || offset + length > size) {
+                break;
+            }
+
+            const char* body = data + offset + sizeof(header);
+            AggregateCounts counts = {};
+            if (countsSize) {
+                std::memcpy(&counts, body, sizeof(counts));
+                body += sizeof(counts);
+            }
+            std::string url(body, header.urlLength);
+            std::string title(body + header.urlLength, header.titleLength);
+
+            if (header.type == kVisitRecord) {
+                index.AddVisit(url, header.timeMs, (header.flags & kTypedFlag) != 0);
+                if (!title.empty()) {
+                    index.SetTitle(url, title);
+                }
+            } else if (header.type == kTitleRecord) {
+                index.SetTitle(url, title);
+            } else {
+                index.AddAggregate(url, title, counts.visits, counts.typed, header.timeMs);
+            }
+            offset += length;
+            records++;
+        }
+        return offset;
+    }
+
+    // Writes one aggregate record per URL to a sibling file and swaps it in; returns the reopened log
+    HANDLE CompactLog(HANDLE file, const std::wstring& path, const HistoryIndex& index, uint64_t& logBytes) {
+        std::wstring tempPath = path + L".tmp";
+        HANDLE temp = CreateFileW(tempPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (temp == INVALID_HANDLE_VALUE) {
+            return file;
+        }
+
+        std::string buffer(kLogMagic, sizeof(kLogMagic));
+        bool ok = true;
+        uint64_t written = 0;
+        for (const HistoryIndex::Entry& entry : index.Entries()) {
+            AggregateCounts counts = { entry.visits, entry.typed };
+            buffer += EncodeRecord(kAggregateRecord, 0, entry.url, entry.title, entry.lastVisitMs, &counts);
+            if (buffer.size() >= 1 << 20) {
+                ok = ok && WriteAll(temp, buffer);
+                written += buffer.size();
+                buffer.clear();
+            }
+        }
+        ok = ok && WriteAll(temp, buffer) && FlushFileBuffers(temp);
+        written += buffer.size();
+        CloseHandle(temp);
+        if (!ok) {
+            DeleteFileW(tempPath.c_str());
+            return file;
+        }
+
+        CloseHandle(file);
+        if (!MoveFileExW(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+            DeleteFileW(tempPath.c_str());
+        } else {
+            logBytes = written;
+        }
+        return CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                           OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    }
+
+    double PercentileMicros(std::vector<double> samples, double p) {
+        if (samples.empty()) {
+            return 0.0;
+        }
+        size_t index = static_cast<size_t>(p * (samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return samples[index];
+    }
+}
+
+HistoryStore& HistoryStore::GetInstance() {
+    static HistoryStore instance;
+    return instance;
+}
+
+void HistoryStore::Start() {
+    CEF_REQUIRE_UI_THREAD();
+    if (started_) {
+        return;
+    }
+    started_ = true;
+
+    const std::wstring& root = ProfileCache::GetInstance().GetRootPath();
+    if (root.empty()) {
+        index_.reset(new HistoryIndex());
+        load_.ok = true;
+        LOG_INFO_BROWSER("📜 No persistent profile; history is kept for this session only");
+        return;
+    }
+
+    persistent_ = true;
+    path_ = (fs::path(root) / L"History" / L"visits.log").wstring();
+    CefPostTask(TID_FILE_USER_BLOCKING, base::BindOnce(&HistoryStore::LoadOnFileThread, path_, NowMs()));
+}
+
+void HistoryStore::LoadOnFileThread(std::wstring path, int64_t nowMs) {
+    auto started = std::chrono::steady_clock::now();
+    HistoryIndex* index = new HistoryIndex();
+    LoadResult result;
+
+    std::error_code ec;
+    fs::create_directories(fs::path(path).parent_path(), ec);
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                              OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER size = {};
+    if (file != INVALID_HANDLE_VALUE && GetFileSizeEx(file, &size)) {
+        uint64_t fileSize = static_cast<uint64_t>(size.QuadPart);
+        uint64_t validEnd = 0;
+
+        if (fileSize >= sizeof(kLogMagic)) {
+            HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            const char* view = mapping ? static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+            if (view && std::memcmp(view, kLogMagic, sizeof(kLogMagic)) == 0) {
+                index->BeginBulk();
+                validEnd = ReplayLog(view, fileSize, *index, result.records);
+                index->EndBulk(nowMs);
+            }
+            if (view) {
+                UnmapViewOfFile(view);
+            }
+            if (mapping) {
+                CloseHandle(mapping);
+            }
+        }
+
+        // Drops a record torn by a crash mid-append, or starts over on a foreign file
+        if (validEnd < fileSize) {
+            LARGE_INTEGER position;
+            position.QuadPart = static_cast<LONGLONG>(validEnd);
+            SetFilePointerEx(file, position, nullptr, FILE_BEGIN);
+            SetEndOfFile(file);
+            result.truncatedBytes = fileSize - validEnd;
+        }
+        if (validEnd == 0) {
+            WriteAll(file, std::string(kLogMagic, sizeof(kLogMagic)));
+            validEnd = sizeof(kLogMagic);
+        }
+        result.logBytes = validEnd;
+
+        if (result.records >= kCompactMinRecords &&
+            result.records >= kCompactRecordsPerUrl * index->Entries().size()) {
+            file = CompactLog(file, path, *index, result.logBytes);
+            result.compacted = true;
+        }
+
+        if (file != INVALID_HANDLE_VALUE) {
+            LARGE_INTEGER zero = {};
+            SetFilePointerEx(file, zero, nullptr, FILE_END);
+            result.ok = true;
+        }
+    }
+
+    g_historyLog = file;
+    result.loadMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started).count();
+
+    CefPostTask(TID_UI, base::BindOnce([](HistoryIndex* loaded, LoadResult loadResult) {
+        HistoryStore::GetInstance().OnLoaded(loaded, loadResult);
+    }, index, result));
+}
+
+void HistoryStore::OnLoaded(HistoryIndex* index, const LoadResult& result) {
+    index_.reset(index);
+    load_ = result;
+    if (!result.ok) {
+        LOG_WARNING_BROWSER("⚠️ History log could not be opened; new visits will not be saved");
+    }
+
+    for (const QueuedVisit& visit : queued_) {
+        ApplyVisit(visit);
+    }
+    queued_.clear();
+
+    LOG_INFO_BROWSER("📜 History loaded: " + std::to_string(index_->Entries().size()) + " URLs, " +
+                     std::to_string(index_->VisitCount()) + " visits in " + std::to_string(result.loadMs) + " ms" +
+                     (result.truncatedBytes ? ", dropped " + std::to_string(result.truncatedBytes) + " torn bytes" : "") +
+                     (result.compacted ? ", compacted" : ""));
+}
+
+void HistoryStore::ApplyVisit(const QueuedVisit& visit) {
+    index_->AddVisit(visit.url, visit.timeMs, visit.typed);
+    if (!visit.title.empty()) {
+        index_->SetTitle(visit.url, visit.title);
+    }
+}
+
+void HistoryStore::RecordVisit(const std::string& url, const std::string& title, bool activeTab) {
+    CEF_REQUIRE_UI_THREAD();
+    bool typed = false;
+    if (activeTab && typedPending_) {
+        typed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - typedAt_).count() < kTypedWindowMs;
+        typedPending_ = false;
+    }
+    if (!started_ || !IsHistoryUrl(url)) {
+        return;
+    }
+
+    QueuedVisit visit;
+    visit.url = url;
+    visit.title = TruncateTitle(title);
+    visit.typed = typed;
+    visit.timeMs = NowMs();
+    visitsRecorded_++;
+
+    if (persistent_) {
+        Append(EncodeRecord(kVisitRecord, typed ? kTypedFlag : 0, visit.url, visit.title, visit.timeMs));
+    }
+    if (index_) {
+        ApplyVisit(visit);
+    } else {
+        queued_.push_back(visit);
+    }
+}
+
+void HistoryStore::RecordTitle(const std::string& url, const std::string& title) {
+    CEF_REQUIRE_UI_THREAD();
+    if (!started_ || !IsHistoryUrl(url)) {
+        return;
+    }
+    std::string truncated = TruncateTitle(title);
+
+    bool changed = false;
+    if (index_) {
+        changed = index_->SetTitle(url, truncated);
+    } else {
+        for (auto it = queued_.rbegin(); it != queued_.rend(); ++it) {
+            if (it->url == url) {
+                changed = it->title != truncated;
+                it->title = truncated;
+                break;
+            }
+        }
+    }
+    if (changed && persistent_) {
+        Append(EncodeRecord(kTitleRecord, 0, url, truncated, NowMs()));
+    }
+}
+
+void HistoryStore::NoteTypedNavigation() {
+    typedPending_ = true;
+    typedAt_ = std::chrono::steady_clock::now();
+}
+
+void HistoryStore::Append(const std::string& record) {
+    bytesAppended_ += record.size();
+    // Same sequenced thread as the load, so appends land after the replayed log
+    CefPostTask(TID_FILE_USER_BLOCKING, base::BindOnce([](std::string data) {
+        if (g_historyLog != INVALID_HANDLE_VALUE) {
+            WriteAll(g_historyLog, data);
+        }
+    }, record));
+}
+
+nlohmann::json HistoryStore::Search(const std::string& text, size_t limit) {
+    CEF_REQUIRE_UI_THREAD();
+    nlohmann::json results = nlohmann::json::array();
+    if (!index_) {
+        return results;
+    }
+
+    limit = (std::max)(static_cast<size_t>(1), (std::min)(limit, kMaxResults));
+    auto start = std::chrono::steady_clock::now();
+    std::vector<HistoryIndex::Suggestion> suggestions = index_->Query(text, limit, NowMs());
+    double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    queries_++;
+    queryMaxMicros_ = (std::max)(queryMaxMicros_, micros);
+    if (recentQueryMicros_.size() < kRecentQuerySamples) {
+        recentQueryMicros_.push_back(micros);
+    } else {
+        recentQueryMicros_[recentQueryNext_] = micros;
+        recentQueryNext_ = (recentQueryNext_ + 1) % kRecentQuerySamples;
+    }
+
+    for (const HistoryIndex::Suggestion& suggestion : suggestions) {
+        results.push_back({
+            {"url", suggestion.url},
+            {"title", suggestion.title},
+            {"visits", suggestion.visits},
+            {"typed", suggestion.typed},
+            {"prefix", suggestion.prefixMatch}
+        });
+    }
+    return results;
+}
+
+nlohmann::json HistoryStore::GetStats() const {
+    return {
+        {"loaded", index_ != nullptr},
+        {"persistent", persistent_},
+        {"logPath", fs::path(path_).u8string()},
+        {"urls", index_ ? index_->Entries().size() : 0},
+        {"visits", index_ ? index_->VisitCount() : 0},
+        {"indexBytes", index_ ? index_->MemoryBytes() : 0},
+        {"loadMs", load_.loadMs},
+        {"loadedRecords", load_.records},
+        {"logBytes", load_.logBytes + bytesAppended_},
+        {"truncatedBytes", load_.truncatedBytes},
+        {"compactedAtLoad", load_.compacted},
+        {"visitsRecorded", visitsRecorded_},
+        {"queries", queries_},
+        {"p50QueryMicros", PercentileMicros(recentQueryMicros_, 0.5)},
+        {"p95QueryMicros", PercentileMicros(recentQueryMicros_, 0.95)},
+        {"maxQueryMicros", queryMaxMicros_}
+    };
+}
@@ -10,7 +10,16 @@
 #include "../handlers/simple_handler.h"
 #include "../handlers/simple_app.h"
 #include "../../include/core/WebSocketServerHandler.h"
+#include "../../include/core/BrowserReadiness.h"
+#include "../../include/core/TabManager.h"
+#include "../../include/core/StateStore.h"
+#include "../../include/core/ActivityJournal.h"
+#include "../../include/core/DaemonChannel.h"
+#include "../../include/core/DaemonScheduler.h"
+#include "../../include/core/DaemonResilience.h"
+#include "../../include/core/BRC100SessionCache.h"
 #include <iostream>
+#include <map>
 #include <regex>
 
 #include "../include/core/PendingAuthRequest.h"
@@ -24,15 +33,21 @@ PendingAuthRequest g_pendingAuthRequest = {"", "", "", "", false, nullptr};
 // Global variable to track if a modal is currently pending
 std::string g_pendingModalDomain = "";
 #include <sstream>
+#include <cctype>
+#include <vector>
 #include <algorithm>
 #include <fstream>
 #include <mutex>
+#include <atomic>
+#include <memory>
 #include <condition_variable>
 #include <nlohmann/json.hpp>
 #include <cstdlib>
 #include <ctime>
 #include <chrono>
 #include <iomanip>
+#include <thread>
+#include <windows.h>
 
 // Logger class for proper debug logging
 class Logger {
@@ -91,119 +106,207 @@ public:
 #define LOG_ERROR_HTTP(msg) Logger::Log(msg, 3, 2)
 
 // Domain verification class
+// Whitelist entries live in the state store under "whitelist/<domain>"; domainWhitelist.json is
+// owned by the wallet daemon and re-imported whenever the daemon rewrites it
 class DomainVerifier {
-private:
-    std::string whitelistFilePath;
-
 public:
-    DomainVerifier() {
-        // Set path to domainWhitelist.json
-        char* homeDir = std::getenv("USERPROFILE");
-        whitelistFilePath = std::string(homeDir) + "\\AppData\\Roaming\\BabbageBrowser\\wallet\\domainWhitelist.json";
+    static std::string KeyFor(const std::string& domain) {
+        return "whitelist/" + domain;
     }
 
     bool isDomainWhitelisted(const std::string& domain) {
-        // Read whitelist file and check domain
-        std::ifstream file(whitelistFilePath);
-        if (!file.is_open()) {
-            std::cout << "🔒 Domain whitelist file not found: " << whitelistFilePath << std::endl;
-            return false;
+        std::string value;
+        if (StateStore::GetInstance().Get(KeyFor(domain), value)) {
+            // Domain is whitelisted - allow it regardless of request count
+            // (one-time domains should remain approved for the session)
+            std::cout << "🔒 Domain " << domain << " is whitelisted" << std::endl;
+            return true;
         }
 
-        try {
-            nlohmann::json whitelist;
-            file >> whitelist;
-            file.close();
-
-            for (const auto& entry : whitelist) {
-                if (entry["domain"] == domain) {
-                    // Domain is whitelisted - allow it regardless of request count
-                    // (one-time domains should remain approved for the session)
-                    std::cout << "🔒 Domain " << domain << " is whitelisted" << std::endl;
-                    return true;
-                }
-            }
-
-            std::cout << "🔒 Domain " << domain << " is not whitelisted" << std::endl;
-            return false;
-        } catch (const std::exception& e) {
-            std::cout << "🔒 Error reading domain whitelist: " << e.what() << std::endl;
-            file.close();
-            return false;
-        }
+        std::cout << "🔒 Domain " << domain << " is not whitelisted" << std::endl;
+        return false;
     }
 
     void addToWhitelist(const std::string& domain, bool isPermanent) {
-        // Read existing whitelist
-        nlohmann::json whitelist = nlohmann::json::array();
-        std::ifstream file(whitelistFilePath);
-        if (file.is_open()) {
-            try {
-                file >> whitelist;
-                file.close();
-            } catch (const std::exception& e) {
-                std::cout << "🔒 Error reading whitelist for update: " << e.what() << std::endl;
-                file.close();
-            }
-        }
+        nlohmann::json entry;
+        entry["addedAt"] = std::time(nullptr);
+        entry["lastUsed"] = std::time(nullptr);
+        entry["requestCount"] = 0;
+        entry["isPermanent"] = isPermanent;
 
-        // Add new entry
-        nlohmann::json newEntry;
-        newEntry["domain"] = domain;
-        newEntry["addedAt"] = std::time(nullptr);
-        newEntry["lastUsed"] = std::time(nullptr);
-        newEntry["requestCount"] = 0;
-        newEntry["isPermanent"] = isPermanent;
-
-        whitelist.push_back(newEntry);
-
-        // Write back to file
-        std::ofstream outFile(whitelistFilePath);
-        if (outFile.is_open()) {
-            outFile << whitelist.dump(2);
-            outFile.close();
+        if (StateStore::GetInstance().Put(KeyFor(domain), entry.dump())) {
             std::cout << "🔒 Added domain " << domain << " to whitelist" << std::endl;
         } else {
-            std::cout << "🔒 Error writing to whitelist file" << std::endl;
+            std::cout << "🔒 Error writing domain " << domain << " to the state store" << std::endl;
         }
     }
 
     void recordRequest(const std::string& domain) {
-        // Read existing whitelist
-        nlohmann::json whitelist = nlohmann::json::array();
+        std::string value;
+        if (!StateStore::GetInstance().Get(KeyFor(domain), value)) {
+            return;
+        }
+
+        nlohmann::json entry = nlohmann::json::parse(value, nullptr, false);
+        if (!entry.is_object()) {
+            return;
+        }
+        entry["lastUsed"] = std::time(nullptr);
+        entry["requestCount"] = entry.value("requestCount", 0) + 1;
+
+        // Usage counters are not worth a disk flush per wallet request
+        StateStore::GetInstance().Put(KeyFor(domain), entry.dump(), false);
+        std::cout << "🔒 Recorded request from domain " << domain << std::endl;
+    }
+
+    // Directory holding the daemon's domainWhitelist.json
+    static std::string WalletDir() {
+        const char* homeDir = std::getenv("USERPROFILE");
+        return std::string(homeDir ? homeDir : "") + "\\AppData\\Roaming\\BabbageBrowser\\wallet";
+    }
+
+    // Brings the store in line with the daemon's whitelist file: new domains are added, domains
+    // the daemon dropped are removed, and counters already in the store are kept. Domains approved
+    // in the last kPendingAddSeconds survive a file that predates them, since the daemon writes
+    // the file only after the add request from addDomainToWhitelist reaches it
+    static void importWhitelistFile() {
+        std::string whitelistFilePath = WalletDir() + "\\domainWhitelist.json";
+
         std::ifstream file(whitelistFilePath);
-        if (file.is_open()) {
-            try {
-                file >> whitelist;
-                file.close();
-            } catch (const std::exception& e) {
-                std::cout << "🔒 Error reading whitelist for recording: " << e.what() << std::endl;
-                file.close();
-                return;
+        if (!file.is_open()) {
+            LOG_DEBUG_HTTP("🔒 Domain whitelist file not found: " + whitelistFilePath);
+            return;
+        }
+
+        nlohmann::json whitelist = nlohmann::json::parse(file, nullptr, false);
+        if (!whitelist.is_array()) {
+            LOG_WARNING_HTTP("🔒 Domain whitelist file could not be parsed, keeping stored whitelist");
+            return;
+        }
+
+        StateStore& store = StateStore::GetInstance();
+        std::map<std::string, std::string> stored;
+        for (auto& item : store.Scan("whitelist/")) {
+            stored.emplace(std::move(item));
+        }
+
+        StateStore::Batch batch;
+        for (const auto& item : whitelist) {
+            if (!item.is_object() || !item.contains("domain") || !item["domain"].is_string()) {
+                continue;
+            }
+            std::string key = KeyFor(item["domain"].get<std::string>());
+            if (stored.erase(key) > 0) {
+                continue;
+            }
+
+            nlohmann::json entry;
+            entry["addedAt"] = item.value("addedAt", static_cast<long long>(std::time(nullptr)));
+            entry["lastUsed"] = item.value("lastUsed", entry["addedAt"].get<long long>());
+            entry["requestCount"] = item.value("requestCount", 0);
+            entry["isPermanent"] = item.value("isPermanent", false);
+            batch.Put(key, entry.dump());
+        }
+        const long long now = static_cast<long long>(std::time(nullptr));
+        for (const auto& item : stored) {
+            nlohmann::json entry = nlohmann::json::parse(item.second, nullptr, false);
+            if (entry.is_object() && now - entry.value("addedAt", 0ll) < kPendingAddSeconds) {
+                continue;
             }
+            batch.Delete(item.first);
         }
 
-        // Update request count
-        for (auto& entry : whitelist) {
-            if (entry["domain"] == domain) {
-                entry["lastUsed"] = std::time(nullptr);
-                entry["requestCount"] = entry["requestCount"].get<int>() + 1;
+        if (!batch.Empty() && store.Commit(batch)) {
+            LOG_INFO_HTTP("🔒 Domain whitelist imported into the state store");
+        }
+    }
+
+private:
+    static const long long kPendingAddSeconds = 60;
+};
+
+// Re-imports domainWhitelist.json whenever the wallet directory changes, so domains the daemon
+// adds or removes through /domain/whitelist/add|remove reach the store without a restart
+class DomainWhitelistWatcher {
+public:
+    ~DomainWhitelistWatcher() {
+        Stop();
+    }
+
+    void Start() {
+        if (running_.exchange(true)) {
+            return;
+        }
+        walletDir_ = DomainVerifier::WalletDir();
+        stopEvent_ = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        worker_ = std::thread(&DomainWhitelistWatcher::WatchLoop, this);
+    }
+
+    void Stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        SetEvent(stopEvent_);
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+        CloseHandle(stopEvent_);
+        stopEvent_ = nullptr;
+    }
+
+private:
+    // The wallet directory only exists once a wallet has been created; re-arm at this interval
+    static const DWORD kRearmIntervalMs = 10000;
+
+    void WatchLoop() {
+        HANDLE change = INVALID_HANDLE_VALUE;
+        while (running_) {
+            if (change == INVALID_HANDLE_VALUE) {
+                change = FindFirstChangeNotificationA(walletDir_.c_str(), FALSE,
+                                                      FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+            }
+
+            DWORD result;
+            if (change != INVALID_HANDLE_VALUE) {
+                HANDLE handles[] = { stopEvent_, change };
+                result = WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+            } else {
+                result = WaitForSingleObject(stopEvent_, kRearmIntervalMs);
+            }
+
+            if (result == WAIT_OBJECT_0) {
                 break;
             }
+            if (result == WAIT_OBJECT_0 + 1) {
+                // A half-written file fails to parse and is picked up by the next notification
+                DomainVerifier::importWhitelistFile();
+                if (!FindNextChangeNotification(change)) {
+                    FindCloseChangeNotification(change);
+                    change = INVALID_HANDLE_VALUE;
+                }
+            } else if (result == WAIT_TIMEOUT) {
+                // Catches a file written before the watcher could be armed
+                DomainVerifier::importWhitelistFile();
+            }
         }
 
-        // Write back to file
-        std::ofstream outFile(whitelistFilePath);
-        if (outFile.is_open()) {
-            outFile << whitelist.dump(2);
-            outFile.close();
-            std::cout << "🔒 Recorded request from domain " << domain << std::endl;
-        } else {
-            std::cout << "🔒 Error writing to whitelist file for recording" << std::endl;
+        if (change != INVALID_HANDLE_VALUE) {
+            FindCloseChangeNotification(change);
         }
     }
+
+    std::string walletDir_;
+    std::atomic<bool> running_{false};
+    HANDLE stopEvent_ = nullptr;
+    std::thread worker_;
 };
 
+void startDomainWhitelistSync() {
+    static DomainWhitelistWatcher watcher;
+    DomainVerifier::importWhitelistFile();
+    watcher.Start();
+}
+
 // Forward declaration
 class AsyncHTTPClient;
 
@@ -217,8 +320,25 @@ public:
                               const std::string& requestDomain,
                               CefRefPtr<CefBrowser> browser)
         : method_(method), endpoint_(endpoint), body_(body), requestDomain_(requestDomain),
-          responseOffset_(0), requestCompleted_(false), browser_(browser) {
+          responseOffset_(0), requestCompleted_(false), browser_(browser),
+          startedAt_(std::chrono::steady_clock::now()),
+          startedMs_(std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::system_clock::now().time_since_epoch()).count()) {
         LOG_DEBUG_HTTP("🌐 AsyncWalletResourceHandler constructor called for " + method + " " + endpoint + " from domain " + requestDomain);
+        // In flight until CEF releases the handler, which covers time spent waiting on an approval modal
+        if (browser_) {
+            TabManager::GetInstance().BeginWalletRequest(browser_->GetIdentifier());
+        }
+    }
+
+    ~AsyncWalletResourceHandler() override {
+        if (!activityRecorded_) {
+            recordActivity(ActivityIndex::kCanceled);
+        }
+        releaseSchedulerSlot();
+        if (browser_) {
+            TabManager::GetInstance().EndWalletRequest(browser_->GetIdentifier());
+        }
     }
 
     bool Open(CefRefPtr<CefRequest> request,
@@ -259,10 +379,14 @@ public:
 
         handle_request = true;
 
-        // Start async HTTP request to Go daemon
-        LOG_DEBUG_HTTP("🌐 About to start async HTTP request...");
-        startAsyncHTTPRequest();
-        LOG_DEBUG_HTTP("🌐 Async HTTP request started");
+        if (answerLocally()) {
+            return true;
+        }
+
+        // Start async HTTP request to Go daemon once the scheduler lets it through
+        LOG_DEBUG_HTTP("🌐 About to schedule async HTTP request...");
+        scheduleDaemonRequest();
+        LOG_DEBUG_HTTP("🌐 Async HTTP request scheduled");
 
         // Don't call callback->Continue() yet - wait for HTTP response
         return true;
@@ -275,9 +399,15 @@ public:
 
         LOG_DEBUG_HTTP("🌐 AsyncWalletResourceHandler::GetResponseHeaders called");
 
-        response->SetStatus(200);
-        response->SetStatusText("OK");
+        response->SetStatus(responseStatus_);
+        response->SetStatusText(responseStatus_ == 403 ? "Forbidden" :
+                                responseStatus_ == 429 ? "Too Many Requests" :
+                                responseStatus_ == 503 ? "Service Unavailable" :
+                                responseStatus_ == 504 ? "Gateway Timeout" : "OK");
         response->SetMimeType("application/json");
+        if (responseStatus_ == 429 || responseStatus_ == 503) {
+            response->SetHeaderByName("Retry-After", "1", true);
+        }
         response->SetHeaderByName("Access-Control-Allow-Origin", "*", true);
         response->SetHeaderByName("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS", true);
         response->SetHeaderByName("Access-Control-Allow-Headers", "Content-Type, Authorization", true);
@@ -318,18 +448,40 @@ public:
         CEF_REQUIRE_IO_THREAD();
         LOG_DEBUG_HTTP("🌐 AsyncWalletResourceHandler::Cancel called");
 
+        canceled_ = true;
+        if (schedulerTicket_ != 0 && DaemonScheduler::GetInstance().Cancel(schedulerTicket_)) {
+            schedulerTicket_ = 0;
+        }
         if (urlRequest_) {
             urlRequest_->Cancel();
             urlRequest_ = nullptr;
         }
+        releaseSchedulerSlot();
     }
 
-    // Called by AsyncHTTPClient when HTTP response is received
-    void onHTTPResponseReceived(const std::string& data) {
+    // Called by AsyncHTTPClient when HTTP response is received; httpStatus is 0 if the daemon was unreachable
+    void onHTTPResponseReceived(const std::string& data, int httpStatus) {
         LOG_DEBUG_HTTP("🌐 AsyncWalletResourceHandler received HTTP response: " + data);
 
+        // A request the page dropped says nothing about the daemon
+        if (reportsToBreaker_.exchange(false)) {
+            if (httpStatus != 0) {
+                DaemonCircuitBreaker::GetInstance().OnSuccess(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sentAt_).count()));
+            } else if (!canceled_) {
+                DaemonCircuitBreaker::GetInstance().OnFailure();
+            }
+        }
+
         responseData_ = data;
+        if (httpStatus == 0 && *deadlinePassed_) {
+            responseStatus_ = 504;
+            responseData_ = nlohmann::json{{"status", "error"}, {"error", "Wallet did not answer in time"}}.dump();
+        }
         requestCompleted_ = true;
+        releaseSchedulerSlot();
+        recordActivity(httpStatus == 0 ? ActivityIndex::kFailed :
+                       httpStatus >= 200 && httpStatus < 300 ? ActivityIndex::kOk : ActivityIndex::kHttpError);
 
         LOG_DEBUG_HTTP("🌐 About to call readCallback_->Continue()");
         // Now we can continue with the response
@@ -345,6 +497,7 @@ public:
 
         responseData_ = data;
         requestCompleted_ = true;
+        recordActivity(ActivityIndex::kApproved);
 
         LOG_DEBUG_HTTP("🔐 About to call readCallback_->Continue() for auth response");
         // Now we can continue with the response
@@ -374,6 +527,8 @@ public:
         g_pendingAuthRequest.body = ""; // No body for domain approval
         g_pendingAuthRequest.isValid = true;
         g_pendingAuthRequest.handler = nullptr; // Will be set when we create the handler
+        g_pendingAuthRequest.interceptedAt = std::chrono::steady_clock::now();
+        g_pendingAuthRequest.deliveredAt = {};
 
         // Send message to frontend to create overlay with domain approval request data
         CefRefPtr<CefBrowser> header_browser = SimpleHandler::GetHeaderBrowser();
@@ -427,6 +582,8 @@ void triggerBRC100AuthApprovalModal(const std::string& domain, const std::string
     g_pendingAuthRequest.body = body;
     g_pendingAuthRequest.isValid = true;
     g_pendingAuthRequest.handler = handler;
+    g_pendingAuthRequest.interceptedAt = std::chrono::steady_clock::now();
+    g_pendingAuthRequest.deliveredAt = {};
 
     // Send message to frontend to create overlay with auth request data
     CefRefPtr<CefBrowser> header_browser = SimpleHandler::GetHeaderBrowser();
@@ -459,6 +616,13 @@ void triggerBRC100AuthApprovalModal(const std::string& domain, const std::string
 }
 
 
+    // Called on the IO thread once the daemon scheduler has admitted or shed this request
+    void onSchedulerVerdict(DaemonScheduler::Verdict verdict);
+
+    // Called on the IO thread with the daemon's answer over the shared-memory channel; status 0
+    // means it was not answered there, and the request goes over HTTP instead
+    void onChannelAnswer(int httpStatus, const std::string& data);
+
     // Static method to create CefURLRequest on UI thread (called by URLRequestCreationTask)
     static void createURLRequestOnUIThread(AsyncWalletResourceHandler* handler,
                                           CefRefPtr<CefRequest> httpRequest,
@@ -466,7 +630,30 @@ void triggerBRC100AuthApprovalModal(const std::string& domain, const std::string
                                           CefRefPtr<CefRequestContext> context);
 
 private:
+    // Session checks the browser's copy of the session table can settle; true once answered
+    bool answerLocally();
+    void scheduleDaemonRequest();
     void startAsyncHTTPRequest();
+    void startURLRequest();
+    // Answers the page without reaching the daemon
+    void failRequest(int httpStatus, const std::string& error, ActivityIndex::Outcome outcome);
+
+    void releaseSchedulerSlot() {
+        if (holdsSchedulerSlot_.exchange(false)) {
+            DaemonScheduler::GetInstance().Release(priority_);
+        }
+    }
+
+    // One journal entry per request: when it was answered, or when CEF released it unanswered
+    void recordActivity(ActivityIndex::Outcome outcome) {
+        activityRecorded_ = true;
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - startedAt_).count();
+        ActivityJournal::GetInstance().Record(requestDomain_, method_, endpoint_, startedMs_,
+                                              static_cast<uint32_t>((std::min)(latency, static_cast<long long>(UINT32_MAX))),
+                                              static_cast<uint32_t>(body_.size()),
+                                              static_cast<uint32_t>(responseData_.size()), outcome);
+    }
 
     // Request data
     std::string method_;
@@ -485,6 +672,30 @@ private:
     // CEF request management
     CefRefPtr<CefURLRequest> urlRequest_;
     CefRefPtr<CefCallback> readCallback_;
+    // 429 or 503 when the scheduler or circuit breaker turned the request away, 504 past the deadline
+    int responseStatus_ = 200;
+    std::atomic<bool> canceled_{false};
+
+    // The route's deadline, counted from when the page made the request, so time spent queued
+    // comes out of it; long polls have none. The daemon is told what is left, and the request is
+    // canceled on the UI thread once it passes.
+    uint32_t budgetMs_ = 0;
+    uint32_t remainingMs_ = 0;
+    std::shared_ptr<std::atomic<bool>> deadlinePassed_ = std::make_shared<std::atomic<bool>>(false);
+    // Set once the breaker let the request through, until its outcome is reported
+    std::atomic<bool> reportsToBreaker_{false};
+    std::chrono::steady_clock::time_point sentAt_;
+
+    // Daemon scheduler admission; the slot is given back when the answer arrives (on the UI
+    // thread for CefURLRequest) or the request is canceled
+    DaemonScheduler::Priority priority_ = DaemonScheduler::kDapp;
+    uint64_t schedulerTicket_ = 0;
+    std::atomic<bool> holdsSchedulerSlot_{false};
+
+    // Activity journal timing
+    std::chrono::steady_clock::time_point startedAt_;
+    int64_t startedMs_;
+    bool activityRecorded_ = false;
 
     IMPLEMENT_REFCOUNTING(AsyncWalletResourceHandler);
     DISALLOW_COPY_AND_ASSIGN(AsyncWalletResourceHandler);
@@ -556,8 +767,11 @@ public:
         cefRequest->SetMethod("POST");
         cefRequest->SetHeaderByName("Content-Type", "application/json", true);
 
-        // Create JSON body
-        std::string jsonBody = "{\"domain\":\"" + domain_ + "\",\"permanent\":" + (permanent_ ? "true" : "false") + "}";
+        // Create JSON body (the daemon reads "isPermanent")
+        nlohmann::json body;
+        body["domain"] = domain_;
+        body["isPermanent"] = permanent_;
+        std::string jsonBody = body.dump();
         LOG_DEBUG_HTTP("🔐 Domain whitelist JSON body: " + jsonBody);
 
         // Create post data
@@ -593,6 +807,10 @@ private:
 void addDomainToWhitelist(const std::string& domain, bool permanent) {
     LOG_DEBUG_HTTP("🔐 Adding domain to whitelist: " + domain + " (permanent: " + std::to_string(permanent) + ")");
 
+    // Approved immediately; the daemon's copy catches up when the request below completes
+    DomainVerifier domainVerifier;
+    domainVerifier.addToWhitelist(domain, permanent);
+
     // Post task to UI thread - CefURLRequest::Create must be called from UI thread
     CefPostTask(TID_UI, new DomainWhitelistTask(domain, permanent));
     LOG_DEBUG_HTTP("🔐 Domain whitelist task posted to UI thread");
@@ -641,8 +859,12 @@ void sendAuthRequestDataToOverlay() {
         args->SetString(2, g_pendingAuthRequest.endpoint);
         args->SetString(3, g_pendingAuthRequest.body);
 
-        auth_browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, message);
-        LOG_DEBUG_HTTP("🔐 Sent auth request data to overlay");
+        // Delivered the moment the overlay's React app reports app_ready (immediately if it already has)
+        BrowserReadiness::GetInstance().RunWhenReady(auth_browser, [message](CefRefPtr<CefBrowser> browser) {
+            browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, message);
+            g_pendingAuthRequest.deliveredAt = std::chrono::steady_clock::now();
+            LOG_DEBUG_HTTP("🔐 Sent auth request data to overlay");
+        });
 
         // Don't clear the pending request here - it will be cleared after auth response is processed
     } else {
@@ -650,6 +872,54 @@ void sendAuthRequestDataToOverlay() {
     }
 }
 
+// Approval-modal latency, accumulated across requests
+namespace {
+    struct AuthModalLatencyStats {
+        uint64_t count = 0;
+        uint64_t totalMs = 0;
+        uint64_t maxMs = 0;
+        uint64_t totalDeliveryMs = 0;
+    };
+    AuthModalLatencyStats g_authModalLatency;
+
+    uint64_t MillisBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(to - from).count());
+    }
+}
+
+// Called when the auth overlay reports its modal on screen
+void recordAuthModalVisible() {
+    if (g_pendingAuthRequest.interceptedAt.time_since_epoch().count() == 0) {
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    uint64_t totalMs = MillisBetween(g_pendingAuthRequest.interceptedAt, now);
+    bool delivered = g_pendingAuthRequest.deliveredAt.time_since_epoch().count() != 0;
+    uint64_t deliveryMs = delivered ? MillisBetween(g_pendingAuthRequest.interceptedAt, g_pendingAuthRequest.deliveredAt) : totalMs;
+
+    g_authModalLatency.count++;
+    g_authModalLatency.totalMs += totalMs;
+    g_authModalLatency.totalDeliveryMs += deliveryMs;
+    g_authModalLatency.maxMs = std::max(g_authModalLatency.maxMs, totalMs);
+
+    LOG_DEBUG_HTTP("⏱️ Approval modal visible " + std::to_string(totalMs) + " ms after interception (data delivered at " +
+                   std::to_string(deliveryMs) + " ms) for " + g_pendingAuthRequest.domain);
+
+    // Only the first visible report per request counts
+    g_pendingAuthRequest.interceptedAt = {};
+}
+
+nlohmann::json getAuthModalLatencyStats() {
+    const auto& s = g_authModalLatency;
+    return {
+        {"count", s.count},
+        {"avgMs", s.count ? s.totalMs / s.count : 0},
+        {"maxMs", s.maxMs},
+        {"avgDeliveryMs", s.count ? s.totalDeliveryMs / s.count : 0}
+    };
+}
+
 // Async HTTP Client for handling CEF URL requests
 class AsyncHTTPClient : public CefURLRequestClient {
 public:
@@ -666,7 +936,11 @@ public:
 
         // Notify parent handler that HTTP request completed
         if (parent_) {
-            parent_->onHTTPResponseReceived(responseData_);
+            int httpStatus = 0;
+            if (request->GetRequestStatus() == UR_SUCCESS && request->GetResponse()) {
+                httpStatus = request->GetResponse()->GetStatus();
+            }
+            parent_->onHTTPResponseReceived(responseData_, httpStatus);
         }
     }
 
@@ -727,22 +1001,273 @@ private:
     DISALLOW_COPY_AND_ASSIGN(URLRequestCreationTask);
 };
 
+// Task to hand a shared-memory channel answer back to the handler on the IO thread
+class ChannelAnswerTask : public CefTask {
+public:
+    ChannelAnswerTask(CefRefPtr<AsyncWalletResourceHandler> handler, int httpStatus, std::string data)
+        : handler_(handler), httpStatus_(httpStatus), data_(std::move(data)) {}
+
+    void Execute() override {
+        handler_->onChannelAnswer(httpStatus_, data_);
+    }
+
+private:
+    CefRefPtr<AsyncWalletResourceHandler> handler_;
+    int httpStatus_;
+    std::string data_;
+
+    IMPLEMENT_REFCOUNTING(ChannelAnswerTask);
+    DISALLOW_COPY_AND_ASSIGN(ChannelAnswerTask);
+};
+
+// Task to hand the daemon scheduler's verdict back to the handler on the IO thread
+class SchedulerVerdictTask : public CefTask {
+public:
+    SchedulerVerdictTask(CefRefPtr<AsyncWalletResourceHandler> handler, DaemonScheduler::Verdict verdict)
+        : handler_(handler), verdict_(verdict) {}
+
+    void Execute() override {
+        handler_->onSchedulerVerdict(verdict_);
+    }
+
+private:
+    CefRefPtr<AsyncWalletResourceHandler> handler_;
+    DaemonScheduler::Verdict verdict_;
+
+    IMPLEMENT_REFCOUNTING(SchedulerVerdictTask);
+    DISALLOW_COPY_AND_ASSIGN(SchedulerVerdictTask);
+};
+
+// Cancels a daemon request still in flight at its deadline, on the UI thread it was created on
+class RequestDeadlineTask : public CefTask {
+public:
+    RequestDeadlineTask(CefRefPtr<CefURLRequest> request, std::shared_ptr<std::atomic<bool>> deadlinePassed)
+        : request_(request), deadlinePassed_(std::move(deadlinePassed)) {}
+
+    void Execute() override {
+        if (request_->GetRequestStatus() == UR_IO_PENDING) {
+            *deadlinePassed_ = true;
+            request_->Cancel();
+        }
+    }
+
+private:
+    CefRefPtr<CefURLRequest> request_;
+    std::shared_ptr<std::atomic<bool>> deadlinePassed_;
+
+    IMPLEMENT_REFCOUNTING(RequestDeadlineTask);
+    DISALLOW_COPY_AND_ASSIGN(RequestDeadlineTask);
+};
+
+void AsyncWalletResourceHandler::scheduleDaemonRequest() {
+    DaemonScheduler& scheduler = DaemonScheduler::GetInstance();
+    priority_ = DaemonScheduler::ClassifySiteRequest(endpoint_);
+
+    if (DaemonScheduler::IsLongPoll(endpoint_)) {
+        onSchedulerVerdict(scheduler.TakeToken(priority_, requestDomain_) ? DaemonScheduler::kAdmitted
+                                                                          : DaemonScheduler::kRateLimited);
+        return;
+    }
+
+    CefRefPtr<AsyncWalletResourceHandler> self(this);
+    schedulerTicket_ = scheduler.Submit(priority_, requestDomain_, [self](DaemonScheduler::Verdict verdict) {
+        CefPostTask(TID_IO, new SchedulerVerdictTask(self, verdict));
+    });
+}
+
+void AsyncWalletResourceHandler::onSchedulerVerdict(DaemonScheduler::Verdict verdict) {
+    CEF_REQUIRE_IO_THREAD();
+    // Long polls are let through by the token bucket alone, without a ticket or a slot
+    bool heldSlot = schedulerTicket_ != 0;
+    schedulerTicket_ = 0;
+
+    if (verdict != DaemonScheduler::kAdmitted) {
+        LOG_DEBUG_HTTP(std::string("🚦 Shed ") + endpoint_ + " from " + requestDomain_ + ": " +
+                       DaemonScheduler::VerdictName(verdict));
+        failRequest(verdict == DaemonScheduler::kRateLimited ? 429 : 503,
+                    std::string("Wallet is busy (") + DaemonScheduler::VerdictName(verdict) + "), retry shortly",
+                    ActivityIndex::kShed);
+        return;
+    }
+
+    holdsSchedulerSlot_ = heldSlot;
+    if (canceled_) {
+        releaseSchedulerSlot();
+        return;
+    }
+    startAsyncHTTPRequest();
+}
+
+void AsyncWalletResourceHandler::failRequest(int httpStatus, const std::string& error, ActivityIndex::Outcome outcome) {
+    responseStatus_ = httpStatus;
+    responseData_ = nlohmann::json{{"status", "error"}, {"error", error}}.dump();
+    requestCompleted_ = true;
+    releaseSchedulerSlot();
+    recordActivity(outcome);
+    if (readCallback_) {
+        readCallback_->Continue();
+    }
+}
+
+namespace {
+    // The path the daemon's router ends up serving for an endpoint: percent-escapes decoded, then
+    // empty and "." segments dropped and ".." applied, as Go's ServeMux cleans a path before
+    // redirecting to the clean one (which CefURLRequest would otherwise follow)
+    std::string CleanPath(const std::string& endpoint) {
+        std::string raw = endpoint.substr(0, endpoint.find_first_of("?#"));
+        std::string decoded;
+        for (size_t i = 0; i < raw.size(); i++) {
+            if (raw[i] == '%' && i + 2 < raw.size() && std::isxdigit(static_cast<unsigned char>(raw[i + 1])) &&
+                std::isxdigit(static_cast<unsigned char>(raw[i + 2]))) {
+                decoded += static_cast<char>(std::stoi(raw.substr(i + 1, 2), nullptr, 16));
+                i += 2;
+            } else {
+                decoded += raw[i];
+            }
+        }
+
+        std::vector<std::string> segments;
+        std::stringstream parts(decoded);
+        std::string segment;
+        while (std::getline(parts, segment, '/')) {
+            if (segment.empty() || segment == ".") {
+                continue;
+            }
+            if (segment == "..") {
+                if (!segments.empty()) {
+                    segments.pop_back();
+                }
+                continue;
+            }
+            segments.push_back(segment);
+        }
+
+        std::string path;
+        for (const std::string& part : segments) {
+            path += "/" + part;
+        }
+        return path.empty() ? "/" : path;
+    }
+}
+
+bool AsyncWalletResourceHandler::answerLocally() {
+    std::string path = CleanPath(endpoint_);
+
+    // Every site's sessions are listed there; only the browser itself reads it, and the daemon
+    // answers it on its owner-only socket alone
+    if (path == "/brc100/sessions") {
+        failRequest(403, "Not available to sites", ActivityIndex::kHttpError);
+        return true;
+    }
+    if (method_ != "POST") {
+        return false;
+    }
+
+    BRC100SessionCache& sessions = BRC100SessionCache::GetInstance();
+    std::string answer;
+    if (path == "/brc100/session/validate") {
+        if (!sessions.Validate(body_, answer)) {
+            return false;
+        }
+    } else if (path == "/isAuthenticated") {
+        // Only the positive answer is settled here; the daemon decides for a domain without a session
+        if (!sessions.DomainHasSession(requestDomain_)) {
+            return false;
+        }
+        std::time_t now = std::time(nullptr);
+        std::tm utc;
+        gmtime_s(&utc, &now);
+        std::stringstream timestamp;
+        timestamp << std::put_time(&utc, "%Y-%m-%dT%H:%M:%SZ");
+        answer = nlohmann::json{{"authenticated", true}, {"timestamp", timestamp.str()}}.dump();
+    } else {
+        return false;
+    }
+
+    LOG_DEBUG_HTTP("🔑 Answered " + path + " for " + requestDomain_ + " from the session table");
+    responseData_ = answer;
+    requestCompleted_ = true;
+    recordActivity(ActivityIndex::kOk);
+    return true;
+}
+
 // Implementation of AsyncWalletResourceHandler::startAsyncHTTPRequest
 void AsyncWalletResourceHandler::startAsyncHTTPRequest() {
+    if (!DaemonScheduler::IsLongPoll(endpoint_)) {
+        budgetMs_ = DaemonRoutePolicy::For(method_, endpoint_).budgetMs;
+        auto queuedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startedAt_).count();
+        if (queuedMs >= budgetMs_) {
+            failRequest(504, "Wallet did not answer in time", ActivityIndex::kFailed);
+            return;
+        }
+        if (!DaemonCircuitBreaker::GetInstance().Allow()) {
+            LOG_DEBUG_HTTP("🔌 Circuit open, failing " + endpoint_ + " from " + requestDomain_ + " fast");
+            failRequest(503, "Wallet is not responding, retry shortly", ActivityIndex::kShed);
+            return;
+        }
+        reportsToBreaker_ = true;
+    }
+    sentAt_ = std::chrono::steady_clock::now();
+
+    // Key and signature calls skip HTTP when the daemon's shared-memory channel is up
+    uint16_t op = method_ == "POST" ? DaemonChannel::OpForEndpoint(endpoint_) : 0;
+    if (op != 0) {
+        CefRefPtr<AsyncWalletResourceHandler> self(this);
+        bool queued = DaemonChannel::GetInstance().Submit(op, body_, [self](int status, std::string body) {
+            CefPostTask(TID_IO, new ChannelAnswerTask(self, status, std::move(body)));
+        });
+        if (queued) {
+            LOG_DEBUG_HTTP("⚡ Sent " + endpoint_ + " over the shared-memory channel");
+            return;
+        }
+    }
+    startURLRequest();
+}
+
+void AsyncWalletResourceHandler::onChannelAnswer(int httpStatus, const std::string& data) {
+    CEF_REQUIRE_IO_THREAD();
+    if (httpStatus == 0) {
+        LOG_DEBUG_HTTP("⚡ No channel answer for " + endpoint_ + ", retrying over HTTP");
+        startURLRequest();
+        return;
+    }
+    onHTTPResponseReceived(data, httpStatus);
+}
+
+void AsyncWalletResourceHandler::startURLRequest() {
     LOG_DEBUG_HTTP("🌐 Starting async HTTP request to: " + endpoint_);
 
+    if (budgetMs_ > 0) {
+        auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startedAt_).count();
+        if (elapsedMs >= budgetMs_) {
+            // The shared-memory channel used up the deadline without answering
+            *deadlinePassed_ = true;
+            onHTTPResponseReceived("", 0);
+            return;
+        }
+        remainingMs_ = static_cast<uint32_t>(budgetMs_ - elapsedMs);
+    }
+
     // Create CEF HTTP request
     LOG_DEBUG_HTTP("🌐 Creating CEF HTTP request");
     CefRefPtr<CefRequest> httpRequest = CefRequest::Create();
     std::string fullUrl = "http://localhost:3301" + endpoint_;
     httpRequest->SetURL(fullUrl);
     httpRequest->SetMethod(method_);
+    // A redirect from the daemon (its router sends one for an unclean path) would be fetched
+    // without answerLocally() having seen where it leads, so it goes back to the site as it is
+    httpRequest->SetFlags(UR_FLAG_STOP_ON_REDIRECT);
 
     LOG_DEBUG_HTTP("🌐 Setting headers for request");
     // Set headers
     CefRequest::HeaderMap headers;
     headers.insert(std::make_pair("Content-Type", "application/json"));
     headers.insert(std::make_pair("Accept", "application/json"));
+    if (remainingMs_ > 0) {
+        headers.insert(std::make_pair("X-Request-Deadline-Ms", std::to_string(remainingMs_)));
+    }
     httpRequest->SetHeaderMap(headers);
 
     // Set POST body if needed
@@ -800,6 +1325,10 @@ void AsyncWalletResourceHandler::createURLRequestOnUIThread(AsyncWalletResourceH
         LOG_DEBUG_HTTP("🌐 Creating CefURLRequest on UI thread");
         handler->urlRequest_ = CefURLRequest::Create(httpRequest, client, context);
         LOG_DEBUG_HTTP("🌐 CefURLRequest created successfully on UI thread");
+        if (handler->urlRequest_ && handler->remainingMs_ > 0) {
+            CefPostDelayedTask(TID_UI, new RequestDeadlineTask(handler->urlRequest_, handler->deadlinePassed_),
+                               handler->remainingMs_);
+        }
     } catch (const std::exception& e) {
         LOG_DEBUG_HTTP("🌐 Exception in UI thread: " + std::string(e.what()));
     } catch (...) {
@@ -815,6 +1344,20 @@ HttpRequestInterceptor::~HttpRequestInterceptor() {
     LOG_DEBUG_HTTP("🌐 HttpRequestInterceptor destroyed");
 }
 
+cef_return_value_t HttpRequestInterceptor::OnBeforeResourceLoad(CefRefPtr<CefBrowser> browser,
+                                                                CefRefPtr<CefFrame> frame,
+                                                                CefRefPtr<CefRequest> request,
+                                                                CefRefPtr<CefCallback> callback) {
+    CEF_REQUIRE_IO_THREAD();
+
+    // A prerendering page has not been opened by the user yet and must not reach the wallet
+    if (browser && TabManager::GetInstance().BlockPrerenderWalletRequest(browser->GetIdentifier())) {
+        LOG_DEBUG_HTTP("🌐 Cancelling wallet request from prerendering tab: " + request->GetURL().ToString());
+        return RV_CANCEL;
+    }
+    return RV_CONTINUE;
+}
+
 CefRefPtr<CefResourceHandler> HttpRequestInterceptor::GetResourceHandler(
     CefRefPtr<CefBrowser> browser,
     CefRefPtr<CefFrame> frame,
@@ -1127,6 +1670,14 @@ bool HttpRequestInterceptor::isSocketIOConnection(const std::string& url) {
 std::string HttpRequestInterceptor::extractDomain(CefRefPtr<CefBrowser> browser, CefRefPtr<CefRequest> request) {
     std::string domain;
 
+    // Tabs keep their committed domain, so the lookup needs no frame access from the IO thread
+    TabManager::WalletContext tabContext;
+    if (browser && TabManager::GetInstance().GetWalletContext(browser->GetIdentifier(), tabContext) &&
+        !tabContext.domain.empty()) {
+        LOG_DEBUG_HTTP("🌐 Using tab " + std::to_string(browser->GetIdentifier()) + " domain: " + tabContext.domain);
+        return tabContext.domain;
+    }
+
     // Use main frame URL as the primary source (most reliable)
     if (browser) {
         CefRefPtr<CefFrame> mainFrame = browser->GetMainFrame();
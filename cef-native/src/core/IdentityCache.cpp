@@ -0,0 +1,245 @@
+#include "../../include/core/IdentityCache.h"
+#include "../../include/core/WalletService.h"
+#include "../../include/core/StateStore.h"
+#include "../../include/handlers/simple_handler.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/base/cef_bind.h"
+#include "include/wrapper/cef_helpers.h"
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+#define LOG_DEBUG_BROWSER(msg) Logger::Log(msg, 0, 2)
+#define LOG_INFO_BROWSER(msg) Logger::Log(msg, 1, 2)
+#define LOG_WARNING_BROWSER(msg) Logger::Log(msg, 2, 2)
+
+namespace {
+    // Daemon health is re-probed whenever the watcher has been idle this long
+    const DWORD kHealthProbeIntervalMs = 10000;
+
+    // Public fields of the last identity seen, so startup has one without touching identity.json
+    const char* kIdentityKey = "identity/public";
+
+    // Earlier builds kept the whole identity.json, encrypted private key included, under this key
+    const char* kLegacyIdentityKey = "identity";
+}
+
+IdentityCache& IdentityCache::GetInstance() {
+    static IdentityCache instance;
+    return instance;
+}
+
+IdentityCache::~IdentityCache() {
+    Stop();
+}
+
+void IdentityCache::Start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+
+    const char* homeDir = std::getenv("USERPROFILE");
+    identityDir_ = std::string(homeDir ? homeDir : "") + "\\AppData\\Roaming\\BabbageBrowser";
+    identityPath_ = identityDir_ + "\\identity.json";
+
+    // Prime from the state store so the first renderer sync already has data; the watcher
+    // re-reads identity.json before anything else
+    std::string stored;
+    if (StateStore::GetInstance().Get(kLegacyIdentityKey, stored)) {
+        StateStore::GetInstance().Delete(kLegacyIdentityKey);
+    }
+    if (StateStore::GetInstance().Get(kIdentityKey, stored)) {
+        nlohmann::json identity = nlohmann::json::parse(stored, nullptr, false);
+        if (!identity.is_discarded()) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            identity_ = PublicFields(identity);
+            hasIdentity_ = true;
+        }
+    }
+
+    stopEvent_ = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    worker_ = std::thread(&IdentityCache::WatchLoop, this);
+    LOG_INFO_BROWSER("🪪 Identity cache started, watching " + identityDir_);
+}
+
+void IdentityCache::Stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    SetEvent(stopEvent_);
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    CloseHandle(stopEvent_);
+    stopEvent_ = nullptr;
+    LOG_INFO_BROWSER("🪪 Identity cache stopped");
+}
+
+void IdentityCache::Reload() {
+    if (RefreshIdentity()) {
+        PostBroadcast();
+    }
+}
+
+void IdentityCache::SetDaemonHealthy(bool healthy) {
+    if (healthy != daemonHealthy_.exchange(healthy) && running_) {
+        PostBroadcast();
+    }
+}
+
+nlohmann::json IdentityCache::PublicFields(const nlohmann::json& identity) {
+    nlohmann::json fields = nlohmann::json::object();
+    if (!identity.is_object()) {
+        return fields;
+    }
+    for (const char* key : { "address", "publicKey", "backedUp" }) {
+        if (identity.contains(key)) {
+            fields[key] = identity[key];
+        }
+    }
+    return fields;
+}
+
+nlohmann::json IdentityCache::GetSnapshot() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {
+        {"identity", hasIdentity_ ? identity_ : nlohmann::json(nullptr)},
+        {"daemonHealthy", daemonHealthy_.load()}
+    };
+}
+
+void IdentityCache::BroadcastUpdate() {
+    CEF_REQUIRE_UI_THREAD();
+
+    CefRefPtr<CefProcessMessage> update = CefProcessMessage::Create("identity_update");
+    update->GetArgumentList()->SetString(0, GetSnapshot().dump());
+
+    // Shell browsers only; tabs run third-party pages
+    const CefRefPtr<CefBrowser> browsers[] = {
+        SimpleHandler::GetHeaderBrowser(),
+        SimpleHandler::GetOverlayBrowser(),
+        SimpleHandler::GetSettingsBrowser(),
+        SimpleHandler::GetWalletBrowser(),
+        SimpleHandler::GetBackupBrowser(),
+        SimpleHandler::GetBRC100AuthBrowser()
+    };
+
+    for (const auto& browser : browsers) {
+        if (browser && browser->GetMainFrame()) {
+            // SendProcessMessage consumes the message, so every browser gets its own copy
+            browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, update->Copy());
+        }
+    }
+}
+
+void IdentityCache::PostBroadcast() {
+    CefPostTask(TID_UI, base::BindOnce([]() {
+        IdentityCache::GetInstance().BroadcastUpdate();
+    }));
+}
+
+bool IdentityCache::ReadIdentityFile(nlohmann::json& identity) {
+    std::ifstream identityFile(identityPath_);
+    if (!identityFile.good()) {
+        return false;
+    }
+
+    try {
+        identityFile >> identity;
+        return true;
+    } catch (const std::exception& e) {
+        // The wallet may still be writing the file; the next change notification retries
+        LOG_WARNING_BROWSER("⚠️ Identity cache could not parse identity.json: " + std::string(e.what()));
+        return false;
+    }
+}
+
+bool IdentityCache::RefreshIdentity() {
+    nlohmann::json identity;
+    bool found = ReadIdentityFile(identity);
+    if (found) {
+        identity = PublicFields(identity);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (found == hasIdentity_ && (!found || identity == identity_)) {
+            return false;
+        }
+
+        hasIdentity_ = found;
+        identity_ = found ? identity : nlohmann::json();
+    }
+
+    // Outside the lock so snapshots are not held up by the flush
+    if (found) {
+        StateStore::GetInstance().Put(kIdentityKey, identity.dump());
+    } else {
+        StateStore::GetInstance().Delete(kIdentityKey);
+    }
+    LOG_DEBUG_BROWSER(std::string("🪪 Identity cache updated: ") + (found ? "identity loaded" : "no identity"));
+    return true;
+}
+
+void IdentityCache::WatchLoop() {
+    WalletService walletService;
+    walletService.setPriority(DaemonScheduler::kBackground);
+    HANDLE change = INVALID_HANDLE_VALUE;
+
+    RefreshIdentity();
+    daemonHealthy_ = walletService.isHealthy();
+    PostBroadcast();
+
+    while (running_) {
+        // The directory only exists once a wallet has been created, so keep trying to arm the watcher
+        if (change == INVALID_HANDLE_VALUE) {
+            change = FindFirstChangeNotificationA(identityDir_.c_str(), FALSE,
+                                                  FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+        }
+
+        bool changed = false;
+        DWORD result;
+        if (change != INVALID_HANDLE_VALUE) {
+            HANDLE handles[] = { stopEvent_, change };
+            result = WaitForMultipleObjects(2, handles, FALSE, kHealthProbeIntervalMs);
+        } else {
+            result = WaitForSingleObject(stopEvent_, kHealthProbeIntervalMs);
+        }
+
+        if (result == WAIT_OBJECT_0) {
+            break;
+        }
+
+        if (result == WAIT_OBJECT_0 + 1) {
+            changed = RefreshIdentity();
+            if (!FindNextChangeNotification(change)) {
+                FindCloseChangeNotification(change);
+                change = INVALID_HANDLE_VALUE;
+            }
+        } else if (result == WAIT_TIMEOUT) {
+            bool healthy = walletService.isHealthy();
+            if (healthy != daemonHealthy_.exchange(healthy)) {
+                LOG_INFO_BROWSER(std::string("🩺 Daemon health changed: ") + (healthy ? "healthy" : "unhealthy"));
+                changed = true;
+            }
+            // Picks up a file that appeared before the watcher could be armed
+            changed = RefreshIdentity() || changed;
+        }
+
+        if (changed) {
+            PostBroadcast();
+        }
+    }
+
+    if (change != INVALID_HANDLE_VALUE) {
+        FindCloseChangeNotification(change);
+    }
+}
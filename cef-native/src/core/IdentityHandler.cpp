@@ -1,28 +1,20 @@
 #include "../../include/core/IdentityHandler.h"
+#include "../../include/core/V8JsonConverter.h"
+#include "include/cef_process_message.h"
 #include <fstream>
 #include <cstdlib>
 
-CefRefPtr<CefV8Value> jsonToV8(const nlohmann::json& j) {
-    if (j.is_object()) {
-        CefRefPtr<CefV8Value> obj = CefV8Value::CreateObject(nullptr, nullptr);
-        for (auto it = j.begin(); it != j.end(); ++it) {
-            const std::string& key = it.key();
-            const auto& value = it.value();
-            if (value.is_string()) {
-                obj->SetValue(key, CefV8Value::CreateString(value.get<std::string>()), V8_PROPERTY_ATTRIBUTE_NONE);
-            } else if (value.is_boolean()) {
-                obj->SetValue(key, CefV8Value::CreateBool(value), V8_PROPERTY_ATTRIBUTE_NONE);
-            } else if (value.is_number_integer()) {
-                obj->SetValue(key, CefV8Value::CreateInt(value), V8_PROPERTY_ATTRIBUTE_NONE);
-            } else if (value.is_number_float()) {
-                obj->SetValue(key, CefV8Value::CreateDouble(value), V8_PROPERTY_ATTRIBUTE_NONE);
-            } else {
-                obj->SetValue(key, CefV8Value::CreateString(value.dump()), V8_PROPERTY_ATTRIBUTE_NONE);
-            }
-        }
-        return obj;
-    }
-    return CefV8Value::CreateUndefined();
+nlohmann::json IdentityHandler::cachedIdentity_;
+bool IdentityHandler::hasCachedIdentity_ = false;
+bool IdentityHandler::daemonHealthy_ = false;
+bool IdentityHandler::cacheInitialized_ = false;
+
+void IdentityHandler::UpdateCache(const nlohmann::json& snapshot) {
+    const nlohmann::json& identity = snapshot.contains("identity") ? snapshot["identity"] : nlohmann::json();
+    hasCachedIdentity_ = identity.is_object();
+    cachedIdentity_ = hasCachedIdentity_ ? identity : nlohmann::json();
+    daemonHealthy_ = snapshot.value("daemonHealthy", false);
+    cacheInitialized_ = true;
 }
 
 bool IdentityHandler::Execute(const CefString& name,
@@ -38,7 +30,13 @@ bool IdentityHandler::Execute(const CefString& name,
     OutputDebugStringA(debugMsg.c_str());
     OutputDebugStringA("\n");
 
-    // For identity.get(), first check if local identity file exists
+    // Served from the cache pushed by the browser process; no disk or daemon round trip
+    if (name == "get" && hasCachedIdentity_) {
+        retval = V8Json::toV8(cachedIdentity_);
+        return true;
+    }
+
+    // Cache not populated yet (or no identity): fall back to the local identity file
     if (name == "get") {
         const char* homeDir = std::getenv("USERPROFILE");
         std::string identityPath = std::string(homeDir) + "\\AppData\\Roaming\\BabbageBrowser\\identity.json";
@@ -49,8 +47,12 @@ bool IdentityHandler::Execute(const CefString& name,
                 nlohmann::json identity;
                 identityFile >> identity;
                 identityFile.close();
+                // Same fields the browser-process cache hands out; the key stays on disk
+                if (identity.is_object()) {
+                    identity.erase("privateKey");
+                }
 
-                CefRefPtr<CefV8Value> identityObject = jsonToV8(identity);
+                CefRefPtr<CefV8Value> identityObject = V8Json::toV8(identity);
                 retval = identityObject;
                 return true;
             } catch (const std::exception& e) {
@@ -73,8 +75,9 @@ bool IdentityHandler::Execute(const CefString& name,
         return false;
     }
 
-    // Check daemon health
-    if (!walletService.isHealthy()) {
+    // Check daemon health; the browser's background probe saves a blocking round trip once known
+    bool healthy = cacheInitialized_ ? daemonHealthy_ : walletService.isHealthy();
+    if (!healthy) {
         std::cerr << "❌ Go wallet daemon is not healthy" << std::endl;
         exception = "Go wallet daemon is not responding properly.";
         return false;
@@ -84,6 +87,14 @@ bool IdentityHandler::Execute(const CefString& name,
         std::cout << "✅ Marking wallet as backed up via Go daemon" << std::endl;
 
         if (walletService.markWalletBackedUp()) {
+            if (hasCachedIdentity_) {
+                cachedIdentity_["backedUp"] = true;
+            }
+            // Have the browser re-read identity.json and push it to every renderer
+            CefRefPtr<CefV8Context> context = CefV8Context::GetCurrentContext();
+            if (context && context->GetFrame()) {
+                context->GetFrame()->SendProcessMessage(PID_BROWSER, CefProcessMessage::Create("identity_invalidate"));
+            }
             retval = CefV8Value::CreateString("success");
         } else {
             retval = CefV8Value::CreateString("error");
@@ -104,7 +115,7 @@ bool IdentityHandler::Execute(const CefString& name,
 
         std::cout << "📦 Wallet info from Go daemon: " << walletInfo.dump() << std::endl;
 
-        CefRefPtr<CefV8Value> walletObject = jsonToV8(walletInfo);
+        CefRefPtr<CefV8Value> walletObject = V8Json::toV8(walletInfo);
         retval = walletObject;
 
         return true;
@@ -0,0 +1,96 @@
+#include "../../include/core/MessageRouter.h"
+
+#include <algorithm>
+#include <chrono>
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+namespace {
+    // Emit a stats summary every N dispatched messages
+    const uint64_t kStatsLogInterval = 500;
+}
+
+MessageRouter::MessageRouter(const std::string& name, int logProcess)
+    : name_(name), logProcess_(logProcess) {
+}
+
+bool MessageRouter::Register(const std::string& messageName, Handler handler) {
+    if (routeIds_.count(messageName)) {
+        Logger::Log("⚠️ [" + name_ + "] Duplicate route ignored: " + messageName, 2, logProcess_);
+        return false;
+    }
+
+    routeIds_.emplace(messageName, routes_.size());
+    Route route;
+    route.name = messageName;
+    route.handler = std::move(handler);
+    routes_.push_back(std::move(route));
+    return true;
+}
+
+bool MessageRouter::Dispatch(CefRefPtr<CefBrowser> browser,
+                             CefRefPtr<CefFrame> frame,
+                             CefProcessId source_process,
+                             CefRefPtr<CefProcessMessage> message) {
+    if (++dispatched_ % kStatsLogInterval == 0) {
+        LogStats();
+    }
+
+    auto it = routeIds_.find(message->GetName().ToString());
+    if (it == routeIds_.end()) {
+        ++unrouted_;
+        return false;
+    }
+
+    // Index rather than reference: a handler may register routes or re-enter Dispatch
+    const size_t id = it->second;
+    auto start = std::chrono::steady_clock::now();
+    Handler handler = routes_[id].handler;
+    bool handled = handler(browser, frame, source_process, message);
+    uint64_t elapsed = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+
+    Route& route = routes_[id];
+    route.calls++;
+    route.totalMicros += elapsed;
+    route.maxMicros = std::max(route.maxMicros, elapsed);
+    return handled;
+}
+
+nlohmann::json MessageRouter::GetStats() const {
+    std::vector<const Route*> sorted;
+    for (const auto& route : routes_) {
+        if (route.calls > 0) {
+            sorted.push_back(&route);
+        }
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Route* a, const Route* b) {
+        return a->totalMicros > b->totalMicros;
+    });
+
+    nlohmann::json routes = nlohmann::json::array();
+    for (const Route* route : sorted) {
+        routes.push_back({
+            {"message", route->name},
+            {"calls", route->calls},
+            {"totalMicros", route->totalMicros},
+            {"avgMicros", route->totalMicros / route->calls},
+            {"maxMicros", route->maxMicros}
+        });
+    }
+
+    return {
+        {"router", name_},
+        {"dispatched", dispatched_},
+        {"unrouted", unrouted_},
+        {"routes", routes}
+    };
+}
+
+void MessageRouter::LogStats() const {
+    Logger::Log("📊 [" + name_ + "] IPC routing stats: " + GetStats().dump(), 1, logProcess_);
+}
@@ -18,16 +18,27 @@ bool NavigationHandler::Execute(const CefString& name,
     CEF_REQUIRE_RENDERER_THREAD();
 
     if (arguments.empty() || !arguments[0]->IsString()) {
-        exception = "Expected a string as the first argument to navigate.";
+        exception = "Expected a string as the first argument to " + name.ToString() + ".";
         return false;
     }
 
     std::string path = arguments[0]->GetStringValue();
-    std::cout << "📡 Navigation request to: " << path << std::endl;
 
     CefRefPtr<CefV8Context> context = CefV8Context::GetCurrentContext();
     CefRefPtr<CefFrame> frame = context->GetFrame();
 
+    // predict(text): address bar keystrokes for the browser's NavigationPredictor
+    if (name == "predict") {
+        if (frame) {
+            CefRefPtr<CefProcessMessage> message = CefProcessMessage::Create("navigation_input");
+            message->GetArgumentList()->SetString(0, path);
+            frame->SendProcessMessage(PID_BROWSER, message);
+        }
+        return true;
+    }
+
+    std::cout << "📡 Navigation request to: " << path << std::endl;
+
     if (frame) {
         CefRefPtr<CefProcessMessage> message = CefProcessMessage::Create("navigate");
         message->GetArgumentList()->SetString(0, path);
@@ -0,0 +1,443 @@
+#include "../../include/core/NavigationPredictor.h"
+#include "../../include/core/TabManager.h"
+#include "include/cef_command_line.h"
+#include "include/cef_request.h"
+#include "include/cef_request_context.h"
+#include "include/cef_urlrequest.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+#include "include/base/cef_bind.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+#define LOG_DEBUG_BROWSER(msg) Logger::Log(msg, 0, 2)
+#define LOG_INFO_BROWSER(msg) Logger::Log(msg, 1, 2)
+
+namespace {
+    const double kResolveConfidence = 0.1;
+    const double kPreconnectConfidence = 0.3;
+
+    // Below this many commits an origin is never certain enough to prerender
+    const uint32_t kPrerenderMinCommits = 2;
+
+    // Typed hosts we have never committed to: worth a preconnect, not a prerender
+    const double kUnknownHostConfidence = 0.4;
+
+    // Roughly how long the network service keeps a resolved host / an idle socket warm
+    const auto kResolveTtl = std::chrono::seconds(60);
+    const auto kPreconnectTtl = std::chrono::seconds(10);
+
+    // An unused prerender is closed after this long without a commit
+    const int kPrerenderTimeoutMs = 30000;
+
+    std::string Lower(std::string text) {
+        std::transform(text.begin(), text.end(), text.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return text;
+    }
+
+    std::string Trim(const std::string& text) {
+        size_t start = text.find_first_not_of(" \t\r\n");
+        if (start == std::string::npos) {
+            return "";
+        }
+        size_t end = text.find_last_not_of(" \t\r\n");
+        return text.substr(start, end - start + 1);
+    }
+
+    // "scheme://host[:port]" of a normalized url, lowercased
+    std::string OriginOf(const std::string& url) {
+        size_t protocolPos = url.find("://");
+        if (protocolPos == std::string::npos) {
+            return "";
+        }
+        size_t end = url.find_first_of("/?#", protocolPos + 3);
+        return Lower(end == std::string::npos ? url : url.substr(0, end));
+    }
+
+    // Host part of typed text or an origin, without scheme and "www."
+    std::string BareHost(const std::string& text) {
+        std::string host = Lower(text);
+        size_t protocolPos = host.find("://");
+        if (protocolPos != std::string::npos) {
+            host = host.substr(protocolPos + 3);
+        }
+        size_t end = host.find_first_of("/?#");
+        if (end != std::string::npos) {
+            host = host.substr(0, end);
+        }
+        if (host.rfind("www.", 0) == 0) {
+            host = host.substr(4);
+        }
+        return host;
+    }
+
+    bool LooksLikeHost(const std::string& host) {
+        if (host == "localhost" || host.rfind("localhost:", 0) == 0) {
+            return true;
+        }
+        if (host.find(' ') != std::string::npos) {
+            return false;
+        }
+        size_t dot = host.rfind('.');
+        if (dot == std::string::npos) {
+            return false;
+        }
+        std::string tld = host.substr(dot + 1);
+        size_t port = tld.find(':');
+        if (port != std::string::npos) {
+            tld = tld.substr(0, port);
+        }
+        return tld.size() >= 2 &&
+               std::all_of(tld.begin(), tld.end(), [](unsigned char c) { return std::isalpha(c) != 0; });
+    }
+
+    std::string SameUrlKey(const std::string& url) {
+        std::string key = Lower(url);
+        if (!key.empty() && key.back() == '/') {
+            key.pop_back();
+        }
+        return key;
+    }
+
+    class ResolveCallback : public CefResolveCallback {
+    public:
+        explicit ResolveCallback(const std::string& origin) : origin_(origin) {}
+
+        void OnResolveCompleted(cef_errorcode_t result, const std::vector<CefString>& resolved_ips) override {
+            if (result != ERR_NONE) {
+                LOG_DEBUG_BROWSER("🔮 Prefetch resolve failed for " + origin_ + " (" + std::to_string(result) + ")");
+            }
+        }
+
+    private:
+        std::string origin_;
+        IMPLEMENT_REFCOUNTING(ResolveCallback);
+    };
+
+    // HEAD to the origin opens (and, through redirects, upgrades) the connection the navigation
+    // will reuse; the response itself is discarded
+    class PreconnectClient : public CefURLRequestClient {
+    public:
+        void OnRequestComplete(CefRefPtr<CefURLRequest> request) override {}
+        void OnUploadProgress(CefRefPtr<CefURLRequest> request, int64_t current, int64_t total) override {}
+        void OnDownloadProgress(CefRefPtr<CefURLRequest> request, int64_t current, int64_t total) override {}
+        void OnDownloadData(CefRefPtr<CefURLRequest> request, const void* data, size_t data_length) override {}
+
+        bool GetAuthCredentials(bool isProxy,
+                                const CefString& host,
+                                int port,
+                                const CefString& realm,
+                                const CefString& scheme,
+                                CefRefPtr<CefAuthCallback> callback) override {
+            return false;
+        }
+
+    private:
+        IMPLEMENT_REFCOUNTING(PreconnectClient);
+    };
+}
+
+NavigationPredictor& NavigationPredictor::GetInstance() {
+    static NavigationPredictor instance;
+    return instance;
+}
+
+void NavigationPredictor::Start() {
+    CefRefPtr<CefCommandLine> command_line = CefCommandLine::GetGlobalCommandLine();
+    if (!command_line) {
+        return;
+    }
+    if (command_line->HasSwitch("prerender-confidence")) {
+        double confidence = std::atof(command_line->GetSwitchValue("prerender-confidence").ToString().c_str());
+        if (confidence > 0.0) {
+            prerenderConfidence_ = confidence;
+        }
+    }
+    prerenderEnabled_ = !command_line->HasSwitch("no-prerender");
+}
+
+std::string NavigationPredictor::NormalizeUrl(const std::string& text) {
+    std::string url = Trim(text);
+    if (!(url.rfind("http://", 0) == 0 || url.rfind("https://", 0) == 0)) {
+        url = "http://" + url;
+    }
+    return url;
+}
+
+NavigationPredictor::Prediction NavigationPredictor::Predict(const std::string& text) const {
+    Prediction prediction;
+    std::string typed = Trim(text);
+    std::string typedHost = BareHost(typed);
+    if (typedHost.empty()) {
+        return prediction;
+    }
+
+    // Past the host the user is typing a path, so only that exact host can match
+    std::string afterScheme = typed.find("://") != std::string::npos ? typed.substr(typed.find("://") + 3) : typed;
+    bool hasPath = afterScheme.find_first_of("/?#") != std::string::npos;
+
+    const std::string* bestOrigin = nullptr;
+    uint32_t bestCommits = 0;
+    uint64_t totalCommits = 0;
+    for (const auto& pair : origins_) {
+        std::string host = BareHost(pair.first);
+        bool matches = hasPath ? host == typedHost : host.rfind(typedHost, 0) == 0;
+        if (!matches) {
+            continue;
+        }
+        totalCommits += pair.second;
+        if (pair.second > bestCommits) {
+            bestCommits = pair.second;
+            bestOrigin = &pair.first;
+        }
+    }
+
+    if (bestOrigin) {
+        prediction.origin = *bestOrigin;
+        prediction.url = hasPath ? NormalizeUrl(typed) : *bestOrigin + "/";
+        prediction.confidence = static_cast<double>(bestCommits) / totalCommits;
+        if (bestCommits < kPrerenderMinCommits) {
+            prediction.confidence = (std::min)(prediction.confidence, prerenderConfidence_ - 0.01);
+        }
+        if (typedHost.size() < 3) {
+            // One or two letters match too much to be sure of anything
+            prediction.confidence *= 0.5;
+        }
+        return prediction;
+    }
+
+    if (LooksLikeHost(typedHost)) {
+        prediction.url = NormalizeUrl(typed);
+        prediction.origin = OriginOf(prediction.url);
+        prediction.confidence = kUnknownHostConfidence;
+    }
+    return prediction;
+}
+
+void NavigationPredictor::OnInput(const std::string& text) {
+    CEF_REQUIRE_UI_THREAD();
+    inputs_++;
+
+    Prediction prediction = Predict(text);
+    lastPrediction_ = prediction;
+    if (prediction.url.empty() || prediction.origin.empty()) {
+        return;
+    }
+    predictions_++;
+
+    if (prediction.confidence >= kResolveConfidence) {
+        Resolve(prediction.origin);
+    }
+    if (prediction.confidence >= kPreconnectConfidence) {
+        Preconnect(prediction.origin);
+    }
+    if (prerenderEnabled_ && prediction.confidence >= prerenderConfidence_ &&
+        SameUrlKey(prerender_.url) != SameUrlKey(prediction.url)) {
+        StartPrerender(prediction.url);
+    }
+}
+
+void NavigationPredictor::Resolve(const std::string& origin) {
+    auto now = std::chrono::steady_clock::now();
+    auto it = resolvedAt_.find(origin);
+    if (it != resolvedAt_.end() && now - it->second < kResolveTtl) {
+        return;
+    }
+    resolvedAt_[origin] = now;
+    resolves_++;
+    CefRequestContext::GetGlobalContext()->ResolveHost(origin, new ResolveCallback(origin));
+}
+
+void NavigationPredictor::Preconnect(const std::string& origin) {
+    auto now = std::chrono::steady_clock::now();
+    auto it = preconnectedAt_.find(origin);
+    if (it != preconnectedAt_.end() && now - it->second < kPreconnectTtl) {
+        return;
+    }
+    preconnectedAt_[origin] = now;
+    preconnects_++;
+
+    CefRefPtr<CefRequest> request = CefRequest::Create();
+    request->SetURL(origin + "/");
+    request->SetMethod("HEAD");
+    // Credentialed, so the socket lands in the same pool group the navigation will use
+    request->SetFlags(UR_FLAG_ALLOW_STORED_CREDENTIALS | UR_FLAG_SKIP_CACHE);
+    CefURLRequest::Create(request, new PreconnectClient(), CefRequestContext::GetGlobalContext());
+    LOG_DEBUG_BROWSER("🔮 Preconnecting to " + origin);
+}
+
+void NavigationPredictor::StartPrerender(const std::string& url) {
+    CancelPrerender();
+
+    prerender_ = Prerender();
+    prerender_.url = url;
+    prerender_.token = ++nextPrerenderToken_;
+    prerender_.startedAt = std::chrono::steady_clock::now();
+    if (!TabManager::GetInstance().OpenPrerender(url, prerender_.token)) {
+        prerender_ = Prerender();
+        return;
+    }
+    prerendersStarted_++;
+    LOG_DEBUG_BROWSER("🔮 Prerendering " + url);
+
+    CefPostDelayedTask(TID_UI, base::BindOnce([](uint64_t token) {
+        NavigationPredictor& predictor = NavigationPredictor::GetInstance();
+        if (predictor.prerender_.token == token) {
+            predictor.CancelPrerender();
+        }
+    }, prerender_.token), kPrerenderTimeoutMs);
+}
+
+void NavigationPredictor::CancelPrerender() {
+    if (prerender_.url.empty()) {
+        return;
+    }
+    prerendersWasted_++;
+    if (prerender_.tabId) {
+        TabManager::GetInstance().ClosePrerender(prerender_.tabId);
+    }
+    // A prerender still being created is closed in OnPrerenderCreated
+    prerender_ = Prerender();
+}
+
+void NavigationPredictor::OnPrerenderCreated(int tabId, uint64_t token) {
+    if (prerender_.url.empty() || prerender_.token != token) {
+        // Cancelled or superseded while its browser was being created
+        TabManager::GetInstance().ClosePrerender(tabId);
+        return;
+    }
+    prerender_.tabId = tabId;
+}
+
+bool NavigationPredictor::OnCommit(const std::string& url) {
+    CEF_REQUIRE_UI_THREAD();
+    commits_++;
+
+    auto now = std::chrono::steady_clock::now();
+    std::string origin = OriginOf(url);
+    if (!lastPrediction_.origin.empty() && lastPrediction_.origin == origin) {
+        commitsPredicted_++;
+    }
+    if (!origin.empty()) {
+        origins_[origin]++;
+    }
+    lastPrediction_ = Prediction();
+
+    if (!prerender_.url.empty() && prerender_.tabId && SameUrlKey(prerender_.url) == SameUrlKey(url)) {
+        int tabId = prerender_.tabId;
+        bool loaded = prerender_.loaded;
+        prerender_ = Prerender();
+        if (TabManager::GetInstance().AdoptPrerender(tabId)) {
+            prerenderHits_++;
+            if (loaded) {
+                RecordReady(Warmup::Prerendered, now);
+            } else {
+                pendingReady_[tabId] = { Warmup::Prerendered, now };
+            }
+            LOG_INFO_BROWSER("🔮 Prerender hit: " + url);
+            return true;
+        }
+    }
+    CancelPrerender();
+
+    Warmup warmup = Warmup::None;
+    auto preconnected = preconnectedAt_.find(origin);
+    auto resolved = resolvedAt_.find(origin);
+    if (preconnected != preconnectedAt_.end() && now - preconnected->second < kPreconnectTtl) {
+        warmup = Warmup::Preconnected;
+    } else if (resolved != resolvedAt_.end() && now - resolved->second < kResolveTtl) {
+        warmup = Warmup::Resolved;
+    }
+    int activeTabId = TabManager::GetInstance().GetActiveTabId();
+    if (activeTabId != -1) {
+        pendingReady_[activeTabId] = { warmup, now };
+    }
+    return false;
+}
+
+void NavigationPredictor::OnTabLoaded(int tabId) {
+    if (prerender_.tabId == tabId) {
+        prerender_.loaded = true;
+        return;
+    }
+    auto it = pendingReady_.find(tabId);
+    if (it == pendingReady_.end()) {
+        return;
+    }
+    RecordReady(it->second.warmup, it->second.committedAt);
+    pendingReady_.erase(it);
+}
+
+void NavigationPredictor::OnTabRemoved(int tabId) {
+    pendingReady_.erase(tabId);
+    if (prerender_.tabId == tabId) {
+        prerender_ = Prerender();
+    }
+}
+
+void NavigationPredictor::RecordReady(Warmup warmup, std::chrono::steady_clock::time_point committedAt) {
+    ReadyStats& stats = ready_[static_cast<int>(warmup)];
+    stats.count++;
+    stats.totalMs += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - committedAt).count());
+}
+
+const char* NavigationPredictor::WarmupName(Warmup warmup) {
+    switch (warmup) {
+        case Warmup::None: return "cold";
+        case Warmup::Resolved: return "resolved";
+        case Warmup::Preconnected: return "preconnected";
+        case Warmup::Prerendered: return "prerendered";
+        default: return "unknown";
+    }
+}
+
+nlohmann::json NavigationPredictor::GetStats() const {
+    nlohmann::json ready = nlohmann::json::object();
+    for (int i = 0; i < static_cast<int>(Warmup::Count); i++) {
+        const ReadyStats& stats = ready_[i];
+        ready[WarmupName(static_cast<Warmup>(i))] = {
+            {"count", stats.count},
+            {"avgMs", stats.count ? stats.totalMs / stats.count : 0}
+        };
+    }
+
+    // Time saved relative to cold navigations, per warmup level
+    nlohmann::json savedMs = nlohmann::json::object();
+    const ReadyStats& cold = ready_[static_cast<int>(Warmup::None)];
+    for (int i = 1; i < static_cast<int>(Warmup::Count); i++) {
+        const ReadyStats& stats = ready_[i];
+        if (cold.count && stats.count) {
+            savedMs[WarmupName(static_cast<Warmup>(i))] =
+                static_cast<long long>(cold.totalMs / cold.count) - static_cast<long long>(stats.totalMs / stats.count);
+        }
+    }
+
+    return {
+        {"prerenderEnabled", prerenderEnabled_},
+        {"prerenderConfidence", prerenderConfidence_},
+        {"inputs", inputs_},
+        {"predictions", predictions_},
+        {"resolves", resolves_},
+        {"preconnects", preconnects_},
+        {"prerendersStarted", prerendersStarted_},
+        {"prerenderHits", prerenderHits_},
+        {"prerendersWasted", prerendersWasted_},
+        {"prerenderPrecision", prerendersStarted_ ? static_cast<double>(prerenderHits_) / prerendersStarted_ : 0.0},
+        {"commits", commits_},
+        {"commitsPredicted", commitsPredicted_},
+        {"predictionAccuracy", commits_ ? static_cast<double>(commitsPredicted_) / commits_ : 0.0},
+        {"knownOrigins", origins_.size()},
+        {"commitToReady", ready},
+        {"savedMsVsCold", savedMs}
+    };
+}
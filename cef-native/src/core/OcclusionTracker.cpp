@@ -0,0 +1,296 @@
+#include "../../include/core/OcclusionTracker.h"
+#include "../../include/core/TabManager.h"
+#include "../../include/handlers/simple_handler.h"
+#include "include/cef_command_line.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+#include "include/base/cef_bind.h"
+#include <tlhelp32.h>
+#include <algorithm>
+#include <cstdlib>
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+#define LOG_DEBUG_BROWSER(msg) Logger::Log(msg, 0, 2)
+#define LOG_INFO_BROWSER(msg) Logger::Log(msg, 1, 2)
+
+namespace {
+    const int kCpuSampleIntervalMs = 5000;
+
+    // No keyboard or mouse input for this long counts as an idle session
+    const DWORD kIdleAfterMs = 60 * 1000;
+
+    // Hidden overlays still run a compositor; keep it at the slowest rate CEF accepts
+    const int kHiddenFps = 1;
+
+    uint64_t FileTimeTo100ns(const FILETIME& time) {
+        return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    }
+
+    bool ProcessCpuTime(HANDLE process, uint64_t& total) {
+        FILETIME created, exited, kernel, user;
+        if (!GetProcessTimes(process, &created, &exited, &kernel, &user)) {
+            return false;
+        }
+        total = FileTimeTo100ns(kernel) + FileTimeTo100ns(user);
+        return true;
+    }
+}
+
+OcclusionTracker& OcclusionTracker::GetInstance() {
+    static OcclusionTracker instance;
+    return instance;
+}
+
+void OcclusionTracker::Start() {
+    CEF_REQUIRE_UI_THREAD();
+    if (started_) {
+        return;
+    }
+    started_ = true;
+
+    CefRefPtr<CefCommandLine> command_line = CefCommandLine::GetGlobalCommandLine();
+    if (command_line && command_line->HasSwitch("background-overlay-fps")) {
+        int fps = std::atoi(command_line->GetSwitchValue("background-overlay-fps").ToString().c_str());
+        if (fps > 0) {
+            backgroundFps_ = (std::min)(fps, foregroundFps_);
+        }
+    }
+
+    lastSample_ = std::chrono::steady_clock::now();
+    SampleCpu();
+    ScheduleSample();
+}
+
+void OcclusionTracker::OnMinimized(bool minimized) {
+    if (minimized == minimized_) {
+        return;
+    }
+    SampleCpu();
+    minimized_ = minimized;
+    if (minimized) {
+        minimizes_++;
+    }
+    LOG_DEBUG_BROWSER(std::string("👁️ Main window ") + (minimized ? "minimized, hiding all browsers" : "restored"));
+
+    SetWindowedVisible(!minimized);
+    ApplyAll();
+}
+
+void OcclusionTracker::OnAppActivated(bool active) {
+    if (active == appActive_) {
+        return;
+    }
+    SampleCpu();
+    appActive_ = active;
+    ApplyAll();
+}
+
+void OcclusionTracker::SetOverlayVisible(const std::string& role, CefRefPtr<CefBrowser> browser, bool visible) {
+    if (!browser) {
+        return;
+    }
+    Overlay& overlay = overlays_[role];
+    if (!overlay.browser || overlay.browser->GetIdentifier() != browser->GetIdentifier()) {
+        // A new browser starts shown at the creation frame rate
+        overlay = Overlay();
+        overlay.browser = browser;
+        overlay.appliedFps = foregroundFps_;
+    }
+    overlay.visible = visible;
+    ApplyOverlay(overlay);
+}
+
+void OcclusionTracker::OnOverlayClosed(const std::string& role) {
+    overlays_.erase(role);
+}
+
+void OcclusionTracker::ApplyOverlay(Overlay& overlay) {
+    bool hidden = !overlay.visible || minimized_;
+    int fps = hidden ? kHiddenFps : (appActive_ ? foregroundFps_ : backgroundFps_);
+
+    CefRefPtr<CefBrowserHost> host = overlay.browser->GetHost();
+    if (hidden != overlay.appliedHidden) {
+        // Stops rendering and timers for the hidden page without tearing the renderer down
+        host->WasHidden(hidden);
+        overlay.appliedHidden = hidden;
+        if (hidden) {
+            hideNotifications_++;
+        } else {
+            showNotifications_++;
+            host->Invalidate(PET_VIEW);
+        }
+    }
+    if (fps != overlay.appliedFps) {
+        host->SetWindowlessFrameRate(fps);
+        overlay.appliedFps = fps;
+        frameRateChanges_++;
+    }
+}
+
+void OcclusionTracker::ApplyAll() {
+    for (auto& pair : overlays_) {
+        ApplyOverlay(pair.second);
+    }
+}
+
+void OcclusionTracker::SetWindowedVisible(bool visible) {
+    CefRefPtr<CefBrowser> header = SimpleHandler::GetHeaderBrowser();
+    HWND headerHwnd = header ? header->GetHost()->GetWindowHandle() : nullptr;
+    if (headerHwnd) {
+        ShowWindow(headerHwnd, visible ? SW_SHOWNA : SW_HIDE);
+    }
+
+    if (visible) {
+        // Re-shows and, if needed, resizes the active tab
+        TabManager::GetInstance().OnHostResized();
+    } else {
+        CefRefPtr<CefBrowser> active = TabManager::GetInstance().GetActiveBrowser();
+        HWND activeHwnd = active ? active->GetHost()->GetWindowHandle() : nullptr;
+        if (activeHwnd) {
+            ShowWindow(activeHwnd, SW_HIDE);
+        }
+    }
+
+    if (visible) {
+        showNotifications_++;
+    } else {
+        hideNotifications_++;
+    }
+}
+
+OcclusionTracker::ShellState OcclusionTracker::CurrentState() const {
+    if (minimized_) {
+        return ShellState::Minimized;
+    }
+    if (!appActive_) {
+        return ShellState::Background;
+    }
+    LASTINPUTINFO input = {};
+    input.cbSize = sizeof(input);
+    if (GetLastInputInfo(&input) && GetTickCount() - input.dwTime >= kIdleAfterMs) {
+        return ShellState::Idle;
+    }
+    return ShellState::Active;
+}
+
+const char* OcclusionTracker::StateName(ShellState state) {
+    switch (state) {
+        case ShellState::Active: return "active";
+        case ShellState::Idle: return "idle";
+        case ShellState::Background: return "background";
+        case ShellState::Minimized: return "minimized";
+        default: return "unknown";
+    }
+}
+
+// Charges the CPU time used since the last sample (this process plus its direct children) to
+// the state the shell was in; also called on every state change so each interval has one state
+void OcclusionTracker::SampleCpu() {
+    if (!started_) {
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    uint64_t wallMs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(now - lastSample_).count());
+    lastSample_ = now;
+
+    std::unordered_map<DWORD, uint64_t> cpuTimes;
+    DWORD self = GetCurrentProcessId();
+    uint64_t selfTime = 0;
+    if (ProcessCpuTime(GetCurrentProcess(), selfTime)) {
+        cpuTimes[self] = selfTime;
+    }
+
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (snapshot != INVALID_HANDLE_VALUE) {
+        PROCESSENTRY32W entry = {};
+        entry.dwSize = sizeof(entry);
+        for (BOOL more = Process32FirstW(snapshot, &entry); more; more = Process32NextW(snapshot, &entry)) {
+            if (entry.th32ParentProcessID != self) {
+                continue;
+            }
+            HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, entry.th32ProcessID);
+            if (!process) {
+                continue;
+            }
+            uint64_t total = 0;
+            if (ProcessCpuTime(process, total)) {
+                cpuTimes[entry.th32ProcessID] = total;
+            }
+            CloseHandle(process);
+        }
+        CloseHandle(snapshot);
+    }
+
+    // Processes seen for the first time are only charged from this sample on
+    uint64_t delta = 0;
+    for (const auto& pair : cpuTimes) {
+        auto last = lastCpuTimes_.find(pair.first);
+        if (last != lastCpuTimes_.end() && pair.second >= last->second) {
+            delta += pair.second - last->second;
+        }
+    }
+    lastCpuTimes_.swap(cpuTimes);
+
+    StateUsage& usage = usage_[static_cast<int>(CurrentState())];
+    usage.wallMs += wallMs;
+    usage.cpuMs += delta / 10000;
+}
+
+void OcclusionTracker::ScheduleSample() {
+    CefPostDelayedTask(TID_UI, base::BindOnce([]() {
+        OcclusionTracker& tracker = OcclusionTracker::GetInstance();
+        tracker.SampleCpu();
+        tracker.ScheduleSample();
+    }), kCpuSampleIntervalMs);
+}
+
+nlohmann::json OcclusionTracker::GetStats() const {
+    nlohmann::json browsers = nlohmann::json::array();
+    browsers.push_back({ {"role", "header"}, {"visible", !minimized_} });
+    for (const auto& tab : TabManager::GetInstance().Snapshot()) {
+        browsers.push_back({
+            {"role", "webview"},
+            {"tabId", tab.id},
+            {"visible", tab.active && !tab.discarded && !minimized_}
+        });
+    }
+    for (const auto& pair : overlays_) {
+        browsers.push_back({
+            {"role", pair.first},
+            {"visible", !pair.second.appliedHidden},
+            {"frameRate", pair.second.appliedFps}
+        });
+    }
+
+    nlohmann::json cpu = nlohmann::json::object();
+    for (int i = 0; i < static_cast<int>(ShellState::Count); i++) {
+        const StateUsage& usage = usage_[i];
+        cpu[StateName(static_cast<ShellState>(i))] = {
+            {"wallMs", usage.wallMs},
+            {"cpuMs", usage.cpuMs},
+            // Percent of one core, summed over the browser and its child processes
+            {"cpuPercent", usage.wallMs ? static_cast<double>(usage.cpuMs) * 100.0 / usage.wallMs : 0.0}
+        };
+    }
+
+    return {
+        {"state", StateName(CurrentState())},
+        {"minimized", minimized_},
+        {"appActive", appActive_},
+        {"foregroundOverlayFps", foregroundFps_},
+        {"backgroundOverlayFps", backgroundFps_},
+        {"browsers", browsers},
+        {"cpu", cpu},
+        {"hideNotifications", hideNotifications_},
+        {"showNotifications", showNotifications_},
+        {"frameRateChanges", frameRateChanges_},
+        {"minimizes", minimizes_}
+    };
+}
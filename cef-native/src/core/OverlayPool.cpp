@@ -0,0 +1,417 @@
+#include "../../include/core/OverlayPool.h"
+#include "../../include/core/BrowserReadiness.h"
+#include "../../include/core/FrontendBundle.h"
+#include "../../include/core/OcclusionTracker.h"
+#include "../../include/handlers/simple_app.h"
+#include "../../include/handlers/simple_handler.h"
+#include "../../include/handlers/my_overlay_render_handler.h"
+#include "include/wrapper/cef_helpers.h"
+#include <algorithm>
+#include <vector>
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+#define LOG_DEBUG_BROWSER(msg) Logger::Log(msg, 0, 2)
+#define LOG_INFO_BROWSER(msg) Logger::Log(msg, 1, 2)
+#define LOG_WARNING_BROWSER(msg) Logger::Log(msg, 2, 2)
+#define LOG_ERROR_BROWSER(msg) Logger::Log(msg, 3, 2)
+
+struct OverlaySpec {
+    const char* role;
+    const wchar_t* windowClass;
+    const wchar_t* windowTitle;
+    const char* popupName;
+    const char* route;
+    HWND* hwndSlot;   // global kept in sync for the shell's move/resize/shutdown code
+};
+
+namespace {
+    const OverlaySpec kOverlaySpecs[] = {
+        { "settings",   L"CEFSettingsOverlayWindow",   L"Settings Overlay",     "SettingsOverlay",   "/settings",    &g_settings_overlay_hwnd },
+        { "wallet",     L"CEFWalletOverlayWindow",     L"Wallet Overlay",       "WalletOverlay",     "/wallet",      &g_wallet_overlay_hwnd },
+        { "backup",     L"CEFBackupOverlayWindow",     L"Backup Overlay",       "BackupOverlay",     "/backup",      &g_backup_overlay_hwnd },
+        { "brc100auth", L"CEFBRC100AuthOverlayWindow", L"BRC-100 Auth Overlay", "BRC100AuthOverlay", "/brc100-auth", &g_brc100_auth_overlay_hwnd },
+    };
+
+    // Rough resident cost of one overlay renderer process on top of its paint buffers
+    const size_t kRendererOverheadBytes = 64 * 1024 * 1024;
+
+    const OverlaySpec* FindSpec(const std::string& role) {
+        for (const auto& spec : kOverlaySpecs) {
+            if (role == spec.role) {
+                return &spec;
+            }
+        }
+        return nullptr;
+    }
+
+    uint64_t MicrosSince(std::chrono::steady_clock::time_point start) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+}
+
+OverlayPool& OverlayPool::GetInstance() {
+    static OverlayPool instance;
+    return instance;
+}
+
+void OverlayPool::SetMemoryBudget(size_t bytes) {
+    budgetBytes_ = bytes;
+    LOG_INFO_BROWSER("🏊 Overlay pool budget: " + std::to_string(bytes / (1024 * 1024)) + " MB");
+    EnforceBudget("");
+}
+
+void OverlayPool::PrewarmDefaults(HINSTANCE hInstance) {
+    CEF_REQUIRE_UI_THREAD();
+
+    for (const char* role : { "settings", "wallet" }) {
+        if (entries_.count(role)) {
+            continue;
+        }
+        const OverlaySpec* spec = FindSpec(role);
+        // Prewarming is opportunistic: never evict anything to make room for it
+        if (TotalEstimatedBytes() + kRendererOverheadBytes > budgetBytes_) {
+            LOG_DEBUG_BROWSER("🏊 Skipping prewarm of " + std::string(role) + " overlay, pool budget reached");
+            break;
+        }
+        LOG_DEBUG_BROWSER("🏊 Prewarming " + std::string(role) + " overlay");
+        CreateEntry(*spec, hInstance, false);
+    }
+}
+
+bool OverlayPool::Show(const std::string& role, HINSTANCE hInstance) {
+    CEF_REQUIRE_UI_THREAD();
+
+    const OverlaySpec* spec = FindSpec(role);
+    if (!spec) {
+        LOG_ERROR_BROWSER("❌ Unknown overlay role: " + role);
+        return false;
+    }
+
+    RECT mainRect;
+    GetWindowRect(g_hwnd, &mainRect);
+    int width = mainRect.right - mainRect.left;
+    int height = mainRect.bottom - mainRect.top;
+
+    auto it = entries_.find(role);
+    if (it != entries_.end()) {
+        Entry& entry = it->second;
+        // The window may have been destroyed behind our back, and the paint buffer is sized at creation
+        if (!IsWindow(entry.hwnd) || entry.width != width || entry.height != height) {
+            LOG_DEBUG_BROWSER("🏊 Pooled " + role + " overlay is stale, recreating");
+            Evict(role);
+        }
+    }
+
+    it = entries_.find(role);
+    if (it != entries_.end() && it->second.browser && it->second.loaded) {
+        Entry& entry = it->second;
+        entry.visible = true;
+        entry.lastUsed = ++useCounter_;
+        entry.warmShow = true;
+        entry.awaitingPaint = true;
+        entry.showStart = std::chrono::steady_clock::now();
+
+        PresentEntry(entry);
+
+        // Route-switch in place in case the page navigated while it was hidden, then let React refresh
+        std::string route = spec->route;
+        std::string js =
+            "if (window.location.pathname !== '" + route + "') {"
+            "  window.history.replaceState(null, '', '" + route + "');"
+            "  window.dispatchEvent(new PopStateEvent('popstate'));"
+            "}"
+            "window.dispatchEvent(new CustomEvent('overlayShown'));";
+        entry.browser->GetMainFrame()->ExecuteJavaScript(js, entry.browser->GetMainFrame()->GetURL(), 0);
+
+        OcclusionTracker::GetInstance().SetOverlayVisible(role, entry.browser, true);
+
+        if (role == "brc100auth") {
+            // A warm auth overlay never reloads, so hand it the pending request directly
+            extern void sendAuthRequestDataToOverlay();
+            sendAuthRequestDataToOverlay();
+        }
+
+        LOG_DEBUG_BROWSER("🏊 Showing pooled " + role + " overlay");
+        return true;
+    }
+
+    // Still loading from a prewarm: show the window now, first paint arrives when the page does
+    if (it != entries_.end()) {
+        Entry& entry = it->second;
+        entry.visible = true;
+        entry.lastUsed = ++useCounter_;
+        entry.warmShow = false;
+        entry.awaitingPaint = true;
+        entry.showStart = std::chrono::steady_clock::now();
+        PresentEntry(entry);
+        OcclusionTracker::GetInstance().SetOverlayVisible(role, entry.browser, true);
+        return true;
+    }
+
+    EnforceBudget(role);
+    LOG_DEBUG_BROWSER("🏊 Creating " + role + " overlay (cold)");
+    return CreateEntry(*spec, hInstance, true) != nullptr;
+}
+
+bool OverlayPool::Hide(const std::string& role) {
+    CEF_REQUIRE_UI_THREAD();
+
+    auto it = entries_.find(role);
+    if (it == entries_.end()) {
+        return false;
+    }
+
+    Entry& entry = it->second;
+    entry.visible = false;
+    entry.awaitingPaint = false;
+    if (IsWindow(entry.hwnd)) {
+        ShowWindow(entry.hwnd, SW_HIDE);
+    }
+    OcclusionTracker::GetInstance().SetOverlayVisible(role, entry.browser, false);
+
+    LOG_DEBUG_BROWSER("🏊 " + role + " overlay returned to pool");
+    EnforceBudget("");
+    return true;
+}
+
+void OverlayPool::OnBrowserCreated(const std::string& role, CefRefPtr<CefBrowser> browser) {
+    auto it = entries_.find(role);
+    if (it != entries_.end() && !it->second.browser) {
+        it->second.browser = browser;
+        if (it->second.visible) {
+            OcclusionTracker::GetInstance().SetOverlayVisible(role, browser, true);
+        }
+    }
+}
+
+void OverlayPool::OnLoadFinished(const std::string& role) {
+    auto it = entries_.find(role);
+    if (it == entries_.end() || it->second.loaded) {
+        return;
+    }
+
+    Entry& entry = it->second;
+    entry.loaded = true;
+    if (!entry.visible && entry.browser) {
+        OcclusionTracker::GetInstance().SetOverlayVisible(role, entry.browser, false);
+        LOG_DEBUG_BROWSER("🏊 " + role + " overlay is warm");
+    }
+}
+
+void OverlayPool::OnOverlayPainted(HWND hwnd) {
+    for (auto& pair : entries_) {
+        Entry& entry = pair.second;
+        if (entry.hwnd != hwnd || !entry.awaitingPaint) {
+            continue;
+        }
+
+        entry.awaitingPaint = false;
+        uint64_t elapsed = MicrosSince(entry.showStart);
+        RoleStats& stats = stats_[pair.first];
+        if (entry.warmShow) {
+            stats.warmShows++;
+            stats.warmTotalMicros += elapsed;
+        } else {
+            stats.coldShows++;
+            stats.coldTotalMicros += elapsed;
+        }
+        stats.maxMicros = std::max(stats.maxMicros, elapsed);
+
+        LOG_INFO_BROWSER("⏱️ " + pair.first + " overlay show-to-first-paint: " +
+                         std::to_string(elapsed / 1000) + " ms (" + (entry.warmShow ? "warm" : "cold") + ")");
+        return;
+    }
+}
+
+void OverlayPool::Shutdown() {
+    std::vector<std::string> roles;
+    for (const auto& pair : entries_) {
+        roles.push_back(pair.first);
+    }
+    for (const auto& role : roles) {
+        Evict(role);
+    }
+}
+
+nlohmann::json OverlayPool::GetStats() const {
+    nlohmann::json roles = nlohmann::json::object();
+    for (const auto& pair : stats_) {
+        const RoleStats& s = pair.second;
+        roles[pair.first] = {
+            {"warmShows", s.warmShows},
+            {"coldShows", s.coldShows},
+            {"avgWarmMicros", s.warmShows ? s.warmTotalMicros / s.warmShows : 0},
+            {"avgColdMicros", s.coldShows ? s.coldTotalMicros / s.coldShows : 0},
+            {"maxMicros", s.maxMicros},
+            {"evictions", s.evictions}
+        };
+    }
+
+    nlohmann::json pooled = nlohmann::json::array();
+    for (const auto& pair : entries_) {
+        pooled.push_back({
+            {"role", pair.first},
+            {"visible", pair.second.visible},
+            {"loaded", pair.second.loaded},
+            {"estimatedBytes", EstimateBytes(pair.second)}
+        });
+    }
+
+    return {
+        {"budgetBytes", budgetBytes_},
+        {"estimatedBytes", TotalEstimatedBytes()},
+        {"pooled", pooled},
+        {"roles", roles}
+    };
+}
+
+OverlayPool::Entry* OverlayPool::CreateEntry(const OverlaySpec& spec, HINSTANCE hInstance, bool visible) {
+    RECT mainRect;
+    GetWindowRect(g_hwnd, &mainRect);
+    int width = mainRect.right - mainRect.left;
+    int height = mainRect.bottom - mainRect.top;
+
+    // Created hidden; PresentEntry positions and shows it (this also bypasses Windows' position caching)
+    HWND hwnd = CreateWindowEx(
+        WS_EX_LAYERED | WS_EX_TOOLWINDOW | WS_EX_TOPMOST,
+        spec.windowClass,
+        spec.windowTitle,
+        WS_POPUP,
+        mainRect.left, mainRect.top, width, height,
+        g_hwnd, nullptr, hInstance, nullptr);
+
+    if (!hwnd) {
+        LOG_ERROR_BROWSER("❌ Failed to create " + std::string(spec.role) + " overlay HWND. Error: " + std::to_string(GetLastError()));
+        return nullptr;
+    }
+
+    Entry& entry = entries_[spec.role];
+    entry = Entry();
+    entry.spec = &spec;
+    entry.hwnd = hwnd;
+    entry.width = width;
+    entry.height = height;
+    entry.visible = visible;
+    entry.lastUsed = ++useCounter_;
+    entry.awaitingPaint = visible;
+    entry.warmShow = false;
+    entry.showStart = std::chrono::steady_clock::now();
+    *spec.hwndSlot = hwnd;
+
+    if (visible) {
+        PresentEntry(entry);
+    }
+
+    CefWindowInfo window_info;
+    window_info.windowless_rendering_enabled = true;
+    window_info.SetAsPopup(hwnd, spec.popupName);
+
+    CefBrowserSettings settings;
+    settings.windowless_frame_rate = 30;
+    settings.background_color = CefColorSetARGB(0, 0, 0, 0); // fully transparent
+    settings.javascript = STATE_ENABLED;
+    settings.javascript_access_clipboard = STATE_ENABLED;
+    settings.javascript_dom_paste = STATE_ENABLED;
+
+    CefRefPtr<SimpleHandler> handler(new SimpleHandler(spec.role));
+    CefRefPtr<MyOverlayRenderHandler> render_handler = new MyOverlayRenderHandler(hwnd, width, height);
+    handler->SetRenderHandler(render_handler);
+
+    bool result = CefBrowserHost::CreateBrowser(
+        window_info,
+        handler,
+        FrontendBundle::GetInstance().Url(spec.route),
+        settings,
+        nullptr,
+        CefRequestContext::GetGlobalContext()
+    );
+
+    if (!result) {
+        LOG_ERROR_BROWSER("❌ Failed to create " + std::string(spec.role) + " overlay browser");
+        DestroyWindow(hwnd);
+        *spec.hwndSlot = nullptr;
+        entries_.erase(spec.role);
+        return nullptr;
+    }
+
+    LOG_DEBUG_BROWSER("✅ " + std::string(spec.role) + " overlay browser created (" + (visible ? "visible" : "prewarm") + ")");
+    return &entries_[spec.role];
+}
+
+void OverlayPool::PresentEntry(Entry& entry) {
+    RECT mainRect;
+    GetWindowRect(g_hwnd, &mainRect);
+
+    SetWindowPos(entry.hwnd, HWND_TOPMOST,
+        mainRect.left, mainRect.top, entry.width, entry.height,
+        SWP_NOACTIVATE | SWP_SHOWWINDOW);
+
+    // Enable mouse input for the overlay
+    LONG exStyle = GetWindowLong(entry.hwnd, GWL_EXSTYLE);
+    SetWindowLong(entry.hwnd, GWL_EXSTYLE, exStyle & ~WS_EX_TRANSPARENT);
+}
+
+void OverlayPool::Evict(const std::string& role) {
+    auto it = entries_.find(role);
+    if (it == entries_.end()) {
+        return;
+    }
+
+    Entry& entry = it->second;
+    OcclusionTracker::GetInstance().OnOverlayClosed(role);
+    if (entry.browser) {
+        SimpleHandler::ReleaseOverlayBrowser(role, entry.browser);
+        BrowserReadiness::GetInstance().Forget(entry.browser);
+        entry.browser->GetHost()->CloseBrowser(true);
+    }
+    if (IsWindow(entry.hwnd)) {
+        DestroyWindow(entry.hwnd);
+    }
+    if (*entry.spec->hwndSlot == entry.hwnd) {
+        *entry.spec->hwndSlot = nullptr;
+    }
+
+    stats_[role].evictions++;
+    entries_.erase(it);
+    LOG_DEBUG_BROWSER("🏊 Evicted " + role + " overlay from pool");
+}
+
+void OverlayPool::EnforceBudget(const std::string& keepRole) {
+    // Room for the overlay about to be created
+    size_t incoming = keepRole.empty() || entries_.count(keepRole) ? 0 : kRendererOverheadBytes;
+
+    while (TotalEstimatedBytes() + incoming > budgetBytes_) {
+        std::string victim;
+        uint64_t oldest = UINT64_MAX;
+        for (const auto& pair : entries_) {
+            if (!pair.second.visible && pair.first != keepRole && pair.second.lastUsed < oldest) {
+                oldest = pair.second.lastUsed;
+                victim = pair.first;
+            }
+        }
+        if (victim.empty()) {
+            return;  // only visible overlays left; they are never evicted
+        }
+        Evict(victim);
+    }
+}
+
+size_t OverlayPool::EstimateBytes(const Entry& entry) const {
+    // Our DIB section plus CEF's own copy of the view buffer
+    size_t paintBuffers = static_cast<size_t>(entry.width) * entry.height * 4 * 2;
+    return paintBuffers + kRendererOverheadBytes;
+}
+
+size_t OverlayPool::TotalEstimatedBytes() const {
+    size_t total = 0;
+    for (const auto& pair : entries_) {
+        total += EstimateBytes(pair.second);
+    }
+    return total;
+}
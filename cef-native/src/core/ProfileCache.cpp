@@ -0,0 +1,382 @@
+#include "../../include/core/ProfileCache.h"
+#include "../../include/core/StartupOrchestrator.h"
+#include "include/cef_request.h"
+#include "include/cef_request_context.h"
+#include "include/cef_urlrequest.h"
+#include "include/cef_values.h"
+#include "include/wrapper/cef_helpers.h"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <set>
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+#define LOG_DEBUG_BROWSER(msg) Logger::Log(msg, 0, 2)
+#define LOG_INFO_BROWSER(msg) Logger::Log(msg, 1, 2)
+#define LOG_WARNING_BROWSER(msg) Logger::Log(msg, 2, 2)
+
+namespace fs = std::filesystem;
+
+namespace {
+    // Trimmed in this order when the profile is over budget: cheapest to rebuild first
+    const wchar_t* kCacheDirs[] = { L"GPUCache", L"Code Cache", L"Cache" };
+
+    const size_t kMaxWarmListEntries = 32;
+
+    uint64_t DirectorySize(const fs::path& dir) {
+        uint64_t total = 0;
+        std::error_code ec;
+        for (fs::recursive_directory_iterator it(dir, fs::directory_options::skip_permission_denied, ec), end;
+             !ec && it != end; it.increment(ec)) {
+            if (it->is_regular_file(ec)) {
+                total += it->file_size(ec);
+            }
+        }
+        return total;
+    }
+
+    bool IsHttpUrl(const std::string& url) {
+        return url.compare(0, 7, "http://") == 0 || url.compare(0, 8, "https://") == 0;
+    }
+
+    class NetworkObserver : public CefDevToolsMessageObserver {
+    public:
+        explicit NetworkObserver(const std::string& role) : role_(role) {}
+
+        void OnDevToolsEvent(CefRefPtr<CefBrowser> browser,
+                             const CefString& method,
+                             const void* params,
+                             size_t params_size) override {
+            if (method != "Network.responseReceived") {
+                return;
+            }
+
+            const char* text = static_cast<const char*>(params);
+            nlohmann::json event = nlohmann::json::parse(text, text + params_size, nullptr, false);
+            if (event.is_discarded() || !event.contains("response")) {
+                return;
+            }
+
+            const nlohmann::json& response = event["response"];
+            bool fromCache = response.value("fromDiskCache", false) || response.value("fromPrefetchCache", false);
+            ProfileCache::GetInstance().OnResponseReceived(role_, response.value("url", ""),
+                                                           event.value("type", ""), fromCache);
+        }
+
+    private:
+        std::string role_;
+
+        IMPLEMENT_REFCOUNTING(NetworkObserver);
+    };
+
+    // Fetches one URL into the HTTP cache and discards the body
+    class WarmupClient : public CefURLRequestClient {
+    public:
+        void OnRequestComplete(CefRefPtr<CefURLRequest> request) override {
+            ProfileCache::GetInstance().OnWarmupComplete(request->GetRequestStatus() == UR_SUCCESS,
+                                                         request->ResponseWasCached());
+        }
+
+        void OnUploadProgress(CefRefPtr<CefURLRequest> request, int64_t current, int64_t total) override {}
+        void OnDownloadProgress(CefRefPtr<CefURLRequest> request, int64_t current, int64_t total) override {}
+        void OnDownloadData(CefRefPtr<CefURLRequest> request, const void* data, size_t data_length) override {}
+
+        bool GetAuthCredentials(bool isProxy,
+                                const CefString& host,
+                                int port,
+                                const CefString& realm,
+                                const CefString& scheme,
+                                CefRefPtr<CefAuthCallback> callback) override {
+            return false;
+        }
+
+    private:
+        IMPLEMENT_REFCOUNTING(WarmupClient);
+    };
+}
+
+ProfileCache& ProfileCache::GetInstance() {
+    static ProfileCache instance;
+    return instance;
+}
+
+void ProfileCache::Configure(CefSettings& settings) {
+    CefRefPtr<CefCommandLine> command_line = CefCommandLine::CreateCommandLine();
+    command_line->InitFromString(::GetCommandLineW());
+    if (command_line->HasSwitch("cache-budget-mb")) {
+        int budgetMb = std::atoi(command_line->GetSwitchValue("cache-budget-mb").ToString().c_str());
+        if (budgetMb > 0) {
+            budgetBytes_ = static_cast<uint64_t>(budgetMb) * 1024 * 1024;
+        }
+    }
+
+    const char* localAppData = std::getenv("LOCALAPPDATA");
+    const char* homeDir = std::getenv("USERPROFILE");
+    fs::path root;
+    if (localAppData) {
+        root = fs::path(localAppData);
+    } else if (homeDir) {
+        root = fs::path(homeDir) / "AppData" / "Local";
+    } else {
+        LOG_WARNING_BROWSER("⚠️ No LOCALAPPDATA/USERPROFILE, CEF will run with an in-memory profile");
+        return;
+    }
+    root /= L"BabbageBrowser";
+    root /= L"Profile";
+
+    std::error_code ec;
+    fs::create_directories(root / L"Default", ec);
+    if (ec) {
+        LOG_WARNING_BROWSER("⚠️ Cannot create profile directory (" + ec.message() + "), using an in-memory profile");
+        return;
+    }
+
+    rootPath_ = root.wstring();
+    cachePath_ = (root / L"Default").wstring();
+
+    LoadPrevious();
+    EnforceBudget();
+
+    // cache_path must live under root_cache_path
+    CefString(&settings.root_cache_path).FromWString(rootPath_);
+    CefString(&settings.cache_path).FromWString(cachePath_);
+    settings.persist_session_cookies = true;
+
+    LOG_INFO_BROWSER("💽 Persistent profile: " + root.u8string() + " (launch " + std::to_string(launchNumber_) +
+                     ", caches " + std::to_string(sizeAtStartup_ / (1024 * 1024)) + " MB of " +
+                     std::to_string(budgetBytes_ / (1024 * 1024)) + " MB budget)");
+}
+
+void ProfileCache::EnforceBudget() {
+    fs::path cacheDir(cachePath_);
+
+    uint64_t total = 0;
+    for (const wchar_t* name : kCacheDirs) {
+        total += DirectorySize(cacheDir / name);
+    }
+    sizeAtStartup_ = total;
+
+    // Chromium bounds each cache while running; this catches budget changes and leftovers
+    // from older runs. Nothing has the files open yet, so whole directories can go.
+    for (const wchar_t* name : kCacheDirs) {
+        if (total <= budgetBytes_) {
+            break;
+        }
+        uint64_t size = DirectorySize(cacheDir / name);
+        std::error_code ec;
+        fs::remove_all(cacheDir / name, ec);
+        if (!ec) {
+            total -= size;
+            trimmedBytes_ += size;
+            LOG_INFO_BROWSER("🧹 Profile over budget, cleared " + fs::path(name).u8string() + " (" +
+                             std::to_string(size / (1024 * 1024)) + " MB)");
+        }
+    }
+}
+
+void ProfileCache::AppendSwitches(CefRefPtr<CefCommandLine> command_line) {
+    if (rootPath_.empty() || command_line->HasSwitch("disk-cache-size")) {
+        return;
+    }
+
+    // Leave a quarter of the budget for the code cache and GPU shader cache
+    command_line->AppendSwitchWithValue("disk-cache-size", std::to_string(budgetBytes_ / 4 * 3));
+}
+
+void ProfileCache::LoadPrevious() {
+    fs::path root(rootPath_);
+
+    std::ifstream statsFile(root / L"cache_stats.json");
+    if (statsFile) {
+        nlohmann::json stats = nlohmann::json::parse(statsFile, nullptr, false);
+        if (!stats.is_discarded() && stats.is_object()) {
+            previousLaunch_ = stats;
+            launchNumber_ = stats.value("launch", 0ull) + 1;
+        }
+    }
+
+    std::ifstream warmFile(root / L"warm_list.json");
+    if (warmFile) {
+        nlohmann::json list = nlohmann::json::parse(warmFile, nullptr, false);
+        if (!list.is_discarded() && list.is_array()) {
+            for (const auto& url : list) {
+                if (url.is_string() && previousWarmList_.size() < kMaxWarmListEntries) {
+                    previousWarmList_.push_back(url.get<std::string>());
+                }
+            }
+        }
+    }
+}
+
+void ProfileCache::StartWarmup(const std::vector<std::string>& urls) {
+    CEF_REQUIRE_UI_THREAD();
+
+    if (rootPath_.empty()) {
+        return;
+    }
+
+    StartupOrchestrator::GetInstance().BeginPhase("cache_warmup");
+
+    std::vector<std::string> targets = urls;
+    targets.insert(targets.end(), previousWarmList_.begin(), previousWarmList_.end());
+
+    std::set<std::string> seen;
+    for (const std::string& url : targets) {
+        if (!IsHttpUrl(url) || !seen.insert(url).second) {
+            continue;
+        }
+
+        CefRefPtr<CefRequest> request = CefRequest::Create();
+        request->SetURL(url);
+        request->SetMethod("GET");
+        CefURLRequest::Create(request, new WarmupClient(), CefRequestContext::GetGlobalContext());
+        warmupIssued_++;
+    }
+
+    LOG_INFO_BROWSER("🔥 Cache warmup started for " + std::to_string(warmupIssued_) + " URL(s)");
+    if (warmupIssued_ == 0) {
+        StartupOrchestrator::GetInstance().EndPhase("cache_warmup");
+    }
+}
+
+void ProfileCache::OnWarmupComplete(bool ok, bool fromCache) {
+    if (!ok) {
+        warmupFailed_++;
+    } else {
+        warmupDone_++;
+        if (fromCache) {
+            warmupFromCache_++;
+        }
+    }
+
+    if (warmupDone_ + warmupFailed_ == warmupIssued_) {
+        StartupOrchestrator::GetInstance().EndPhase("cache_warmup");
+    }
+}
+
+void ProfileCache::Observe(CefRefPtr<CefBrowser> browser, const std::string& role) {
+    CEF_REQUIRE_UI_THREAD();
+
+    CefRefPtr<CefBrowserHost> host = browser->GetHost();
+    observers_[browser->GetIdentifier()] = host->AddDevToolsMessageObserver(new NetworkObserver(role));
+
+    // Only response metadata is needed; don't let DevTools buffer bodies
+    CefRefPtr<CefDictionaryValue> params = CefDictionaryValue::Create();
+    params->SetInt("maxTotalBufferSize", 0);
+    params->SetInt("maxResourceBufferSize", 0);
+    host->ExecuteDevToolsMethod(0, "Network.enable", params);
+}
+
+void ProfileCache::Unobserve(int browserId) {
+    observers_.erase(browserId);
+}
+
+void ProfileCache::OnResponseReceived(const std::string& role, const std::string& url,
+                                      const std::string& type, bool fromCache) {
+    if (!IsHttpUrl(url)) {
+        return;
+    }
+
+    RoleStats& stats = roles_[role];
+    stats.responses++;
+    if (fromCache) {
+        stats.cacheHits++;
+    }
+
+    // The render-blocking parts of the start page are what a cold launch waits on
+    if (recordingWarmList_ && role == "webview" && warmList_.size() < kMaxWarmListEntries &&
+        (type == "Script" || type == "Stylesheet" || type == "Font")) {
+        if (std::find(warmList_.begin(), warmList_.end(), url) == warmList_.end()) {
+            warmList_.push_back(url);
+        }
+    }
+}
+
+void ProfileCache::OnLoadStarted(const std::string& role) {
+    RoleStats& stats = roles_[role];
+    if (stats.firstLoadMs < 0 && !stats.loading) {
+        stats.loading = true;
+        stats.loadStart = std::chrono::steady_clock::now();
+    }
+}
+
+void ProfileCache::OnLoadFinished(const std::string& role) {
+    RoleStats& stats = roles_[role];
+    if (!stats.loading) {
+        return;
+    }
+    stats.loading = false;
+    stats.firstLoadMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - stats.loadStart).count();
+
+    if (role == "webview") {
+        recordingWarmList_ = false;
+    }
+
+    long long previousMs = -1;
+    if (previousLaunch_.contains("roles") && previousLaunch_["roles"].contains(role)) {
+        previousMs = previousLaunch_["roles"][role].value("firstLoadMs", -1ll);
+    }
+    LOG_INFO_BROWSER("⏱️ " + role + " first load " + std::to_string(stats.firstLoadMs) + " ms (previous launch: " +
+                     (previousMs >= 0 ? std::to_string(previousMs) + " ms" : std::string("n/a")) + ", cache hits " +
+                     std::to_string(stats.cacheHits) + "/" + std::to_string(stats.responses) + ")");
+}
+
+nlohmann::json ProfileCache::GetStats() const {
+    nlohmann::json roles = nlohmann::json::object();
+    for (const auto& [role, stats] : roles_) {
+        roles[role] = {
+            {"responses", stats.responses},
+            {"cacheHits", stats.cacheHits},
+            {"hitRate", stats.responses ? static_cast<double>(stats.cacheHits) / stats.responses : 0.0},
+            {"firstLoadMs", stats.firstLoadMs}
+        };
+    }
+
+    nlohmann::json current = {
+        {"launch", launchNumber_},
+        {"roles", roles},
+        {"warmup", {
+            {"issued", warmupIssued_},
+            {"completed", warmupDone_},
+            {"failed", warmupFailed_},
+            {"alreadyCached", warmupFromCache_}
+        }},
+        {"cacheBytesAtStartup", sizeAtStartup_},
+        {"trimmedBytes", trimmedBytes_}
+    };
+
+    return {
+        {"persistent", !rootPath_.empty()},
+        {"profilePath", fs::path(rootPath_).u8string()},
+        {"budgetBytes", budgetBytes_},
+        {"current", current},
+        {"previous", previousLaunch_}
+    };
+}
+
+void ProfileCache::Save() {
+    if (rootPath_.empty()) {
+        return;
+    }
+
+    fs::path root(rootPath_);
+    std::ofstream statsFile(root / L"cache_stats.json", std::ios::trunc);
+    if (statsFile) {
+        statsFile << GetStats()["current"].dump(2);
+    }
+
+    // Keep last launch's list if this one never saw the start page load
+    std::ofstream warmFile(root / L"warm_list.json", std::ios::trunc);
+    if (warmFile) {
+        warmFile << nlohmann::json(warmList_.empty() ? previousWarmList_ : warmList_).dump(2);
+    }
+
+    observers_.clear();
+}
@@ -0,0 +1,179 @@
+#include "../../include/core/RendererRpc.h"
+#include "../../include/core/V8JsonConverter.h"
+#include "include/cef_process_message.h"
+#include "include/wrapper/cef_helpers.h"
+#include <nlohmann/json.hpp>
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 1);
+};
+
+#define LOG_DEBUG_RENDER(msg) Logger::Log(msg, 0, 1)
+
+namespace {
+    // Leaves the call's context on every way out of Complete, including a conversion that throws
+    class ContextScope {
+    public:
+        explicit ContextScope(CefRefPtr<CefV8Context> context) : context_(context) {}
+        ~ContextScope() { context_->Exit(); }
+
+        ContextScope(const ContextScope&) = delete;
+        ContextScope& operator=(const ContextScope&) = delete;
+
+    private:
+        CefRefPtr<CefV8Context> context_;
+    };
+}
+
+std::map<int, RendererRpc::PendingCall> RendererRpc::pending_;
+int RendererRpc::nextRequestId_ = 1;
+
+bool RendererRpc::ConvertArguments(CefRefPtr<CefV8Value> array, CefRefPtr<CefListValue> out, std::string& error) {
+    if (!array || !array->IsArray()) {
+        return true;
+    }
+
+    for (int i = 0; i < array->GetArrayLength(); i++) {
+        CefRefPtr<CefV8Value> value = array->GetValue(i);
+        if (value->IsString()) {
+            out->SetString(i, value->GetStringValue());
+        } else if (value->IsBool()) {
+            out->SetBool(i, value->GetBoolValue());
+        } else if (value->IsInt()) {
+            out->SetInt(i, value->GetIntValue());
+        } else if (value->IsDouble()) {
+            out->SetDouble(i, value->GetDoubleValue());
+        } else if (value->IsObject()) {
+            try {
+                out->SetString(i, V8Json::fromV8(value).dump());
+            } catch (const std::exception& e) {
+                error = "argument " + std::to_string(i) + ": " + e.what();
+                return false;
+            }
+        } else {
+            out->SetNull(i);
+        }
+    }
+    return true;
+}
+
+int RendererRpc::Send(PendingCall call, CefRefPtr<CefListValue> args) {
+    CEF_REQUIRE_RENDERER_THREAD();
+
+    int requestId = nextRequestId_++;
+    if (nextRequestId_ <= 0) {
+        nextRequestId_ = 1;
+    }
+
+    CefRefPtr<CefFrame> frame = call.context->GetFrame();
+    std::string messageName = call.messageName;
+    pending_[requestId] = std::move(call);
+
+    CefRefPtr<CefProcessMessage> message = CefProcessMessage::Create("rpc_request");
+    CefRefPtr<CefListValue> envelope = message->GetArgumentList();
+    envelope->SetInt(0, requestId);
+    envelope->SetString(1, messageName);
+    envelope->SetList(2, args ? args : CefListValue::Create());
+    frame->SendProcessMessage(PID_BROWSER, message);
+
+    LOG_DEBUG_RENDER("📤 RPC request " + std::to_string(requestId) + ": " + messageName +
+                     " (" + std::to_string(pending_.size()) + " in flight)");
+    return requestId;
+}
+
+bool RendererRpc::Complete(int requestId, const std::string& responseName, CefRefPtr<CefListValue> responseArgs) {
+    CEF_REQUIRE_RENDERER_THREAD();
+
+    auto it = pending_.find(requestId);
+    if (it == pending_.end()) {
+        return false;
+    }
+
+    PendingCall call = it->second;
+    pending_.erase(it);
+
+    if (!call.context->IsValid() || !call.context->Enter()) {
+        return true;
+    }
+    ContextScope scope(call.context);
+
+    try {
+        Settle(call, responseName, responseArgs);
+    } catch (const std::exception& e) {
+        // A payload V8 cannot hold (e.g. nested past V8Json's depth cap) fails this call, not the renderer
+        std::string message = "Malformed " + responseName + ": " + e.what();
+        LOG_DEBUG_RENDER("❌ RPC " + std::to_string(requestId) + " " + message);
+        if (call.promise) {
+            call.promise->RejectPromise(message);
+        } else if (call.onError) {
+            CefV8ValueList callbackArgs;
+            callbackArgs.push_back(CefV8Value::CreateString(message));
+            call.onError->ExecuteFunction(nullptr, callbackArgs);
+        }
+    }
+    return true;
+}
+
+void RendererRpc::Settle(const PendingCall& call, const std::string& responseName, CefRefPtr<CefListValue> responseArgs) {
+    // Responses carry their payload as a JSON string in arg 0
+    nlohmann::json parsed;
+    bool isJson = false;
+    std::string raw;
+    if (responseArgs && responseArgs->GetSize() > 0 && responseArgs->GetType(0) == VTYPE_STRING) {
+        raw = responseArgs->GetString(0);
+        try {
+            parsed = nlohmann::json::parse(raw);
+            isJson = true;
+        } catch (const std::exception&) {
+        }
+    }
+
+    bool isError = responseName.size() >= 6 &&
+                   responseName.compare(responseName.size() - 6, 6, "_error") == 0;
+
+    if (call.promise) {
+        if (!isError && !call.unwrapField.empty() &&
+            !(isJson && parsed.is_object() && parsed.value("success", false))) {
+            isError = true;
+        }
+
+        if (isError) {
+            std::string message = raw.empty() ? responseName : raw;
+            if (isJson && parsed.is_object() && parsed.contains("error") && parsed["error"].is_string()) {
+                message = parsed["error"].get<std::string>();
+            } else if (isJson && parsed.is_string()) {
+                message = parsed.get<std::string>();
+            }
+            call.promise->RejectPromise(message);
+        } else if (!call.unwrapField.empty()) {
+            call.promise->ResolvePromise(V8Json::toV8(parsed.value(call.unwrapField, nlohmann::json())));
+        } else if (isJson) {
+            call.promise->ResolvePromise(V8Json::toV8(parsed));
+        } else {
+            call.promise->ResolvePromise(raw.empty() ? CefV8Value::CreateNull() : CefV8Value::CreateString(raw));
+        }
+    } else {
+        CefRefPtr<CefV8Value> payload = CefV8Value::CreateNull();
+        if (isJson) {
+            payload = V8Json::toV8(parsed);
+        } else if (!raw.empty()) {
+            payload = CefV8Value::CreateString(raw);
+        }
+
+        CefV8ValueList callbackArgs;
+        callbackArgs.push_back(payload);
+        (isError ? call.onError : call.onSuccess)->ExecuteFunction(nullptr, callbackArgs);
+    }
+}
+
+void RendererRpc::DropContext(CefRefPtr<CefV8Context> context) {
+    for (auto it = pending_.begin(); it != pending_.end();) {
+        if (it->second.context->IsSame(context)) {
+            it = pending_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
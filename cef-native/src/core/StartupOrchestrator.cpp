@@ -0,0 +1,221 @@
+#include "../../include/core/StartupOrchestrator.h"
+#include "../../include/core/IdentityCache.h"
+#include "include/cef_command_line.h"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+#define LOG_DEBUG_BROWSER(msg) Logger::Log(msg, 0, 2)
+#define LOG_INFO_BROWSER(msg) Logger::Log(msg, 1, 2)
+#define LOG_WARNING_BROWSER(msg) Logger::Log(msg, 2, 2)
+
+namespace {
+    const char* kTraceFile = "startup_trace.json";
+    const int kDaemonReadyTimeoutMs = 15000;
+    const int kDaemonPollIntervalMs = 100;
+}
+
+StartupOrchestrator& StartupOrchestrator::GetInstance() {
+    static StartupOrchestrator instance;
+    return instance;
+}
+
+long long StartupOrchestrator::NowUs() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0_).count();
+}
+
+void StartupOrchestrator::Begin() {
+    t0_ = std::chrono::steady_clock::now();
+
+    CefRefPtr<CefCommandLine> command_line = CefCommandLine::CreateCommandLine();
+    command_line->InitFromString(::GetCommandLineW());
+    if (command_line->HasSwitch("first-paint-budget-ms")) {
+        long long budget = std::atoll(command_line->GetSwitchValue("first-paint-budget-ms").ToString().c_str());
+        if (budget > 0) {
+            firstPaintBudgetMs_ = budget;
+        }
+    }
+    launchDaemon_ = !command_line->HasSwitch("no-daemon-launch");
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pendingMilestones_ = { "header_app_ready", "webview_loaded", "daemon_settled" };
+    }
+
+    Mark("startup_begin");
+    daemonThread_ = std::thread(&StartupOrchestrator::DaemonLoop, this);
+}
+
+void StartupOrchestrator::BeginPhase(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    openPhases_[name] = NowUs();
+}
+
+void StartupOrchestrator::EndPhase(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = openPhases_.find(name);
+    if (it == openPhases_.end()) {
+        return;
+    }
+
+    long long end = NowUs();
+    events_.push_back({ name, 'X', it->second, end - it->second, GetCurrentThreadId() });
+    openPhases_.erase(it);
+    LOG_DEBUG_BROWSER("⏱️ Startup phase " + name + ": " + std::to_string((end - events_.back().startUs) / 1000) + " ms");
+}
+
+void StartupOrchestrator::Mark(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    events_.push_back({ name, 'i', NowUs(), 0, GetCurrentThreadId() });
+}
+
+void StartupOrchestrator::Milestone(const std::string& name) {
+    bool complete = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pendingMilestones_.erase(name) == 0) {
+            return;
+        }
+
+        long long now = NowUs();
+        events_.push_back({ name, 'i', now, 0, GetCurrentThreadId() });
+        LOG_INFO_BROWSER("⏱️ Startup milestone " + name + " at " + std::to_string(now / 1000) + " ms");
+
+        if (name == "header_app_ready" && now / 1000 > firstPaintBudgetMs_) {
+            budgetExceeded_ = true;
+            events_.push_back({ "first_paint_budget_exceeded", 'i', now, 0, GetCurrentThreadId() });
+            LOG_WARNING_BROWSER("⚠️ Header first paint took " + std::to_string(now / 1000) + " ms, over the " +
+                                std::to_string(firstPaintBudgetMs_) + " ms budget");
+        }
+
+        complete = pendingMilestones_.empty();
+    }
+
+    if (complete) {
+        WriteTrace();
+    }
+}
+
+void StartupOrchestrator::DaemonLoop() {
+    // Probing and launching the daemon overlaps window setup and CefInitialize
+    BeginPhase("daemon_probe");
+    WalletService probe;
+    bool healthy = probe.isHealthy();
+    EndPhase("daemon_probe");
+
+    if (!healthy && launchDaemon_) {
+        char exePath[MAX_PATH];
+        GetModuleFileNameA(nullptr, exePath, MAX_PATH);
+        std::string daemonPath = std::string(exePath);
+        daemonPath = daemonPath.substr(0, daemonPath.find_last_of("\\/")) + "\\..\\..\\..\\..\\go-wallet\\wallet.exe";
+
+        std::error_code ec;
+        if (std::filesystem::exists(daemonPath, ec)) {
+            BeginPhase("daemon_launch");
+            daemon_ = std::make_unique<WalletService>();
+            daemon_->setDaemonPath(daemonPath);
+            bool started = daemon_->startDaemon();
+            EndPhase("daemon_launch");
+
+            if (started) {
+                BeginPhase("daemon_ready_wait");
+                for (int waited = 0; !stopping_ && waited < kDaemonReadyTimeoutMs; waited += kDaemonPollIntervalMs) {
+                    Sleep(kDaemonPollIntervalMs);
+                    if (probe.isHealthy()) {
+                        healthy = true;
+                        break;
+                    }
+                }
+                EndPhase("daemon_ready_wait");
+            }
+        } else {
+            LOG_WARNING_BROWSER("⚠️ Go daemon not running and not found at " + daemonPath);
+        }
+    }
+
+    if (healthy) {
+        Mark("daemon_ready");
+        IdentityCache::GetInstance().SetDaemonHealthy(true);
+    } else {
+        LOG_WARNING_BROWSER("⚠️ Go daemon not ready during startup; wallet calls will retry on demand");
+    }
+    Milestone("daemon_settled");
+}
+
+void StartupOrchestrator::Shutdown() {
+    stopping_ = true;
+    if (daemonThread_.joinable()) {
+        daemonThread_.join();
+    }
+    WriteTrace();
+}
+
+nlohmann::json StartupOrchestrator::GetTimeline() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    nlohmann::json phases = nlohmann::json::array();
+    nlohmann::json milestones = nlohmann::json::object();
+    for (const Event& event : events_) {
+        if (event.phase == 'X') {
+            phases.push_back({ {"name", event.name}, {"startMs", event.startUs / 1000.0}, {"durationMs", event.durationUs / 1000.0} });
+        } else {
+            milestones[event.name] = event.startUs / 1000.0;
+        }
+    }
+
+    nlohmann::json open = nlohmann::json::array();
+    for (const auto& [name, start] : openPhases_) {
+        open.push_back(name);
+    }
+
+    return {
+        {"phases", phases},
+        {"milestones", milestones},
+        {"openPhases", open},
+        {"pendingMilestones", pendingMilestones_},
+        {"firstPaintBudgetMs", firstPaintBudgetMs_},
+        {"firstPaintBudgetExceeded", budgetExceeded_}
+    };
+}
+
+void StartupOrchestrator::WriteTrace() {
+    nlohmann::json traceEvents = nlohmann::json::array();
+    nlohmann::json metadata;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        DWORD pid = GetCurrentProcessId();
+        for (const Event& event : events_) {
+            nlohmann::json entry = {
+                {"name", event.name},
+                {"cat", "startup"},
+                {"ph", std::string(1, event.phase)},
+                {"ts", event.startUs},
+                {"pid", pid},
+                {"tid", event.threadId}
+            };
+            if (event.phase == 'X') {
+                entry["dur"] = event.durationUs;
+            } else {
+                entry["s"] = "p";
+            }
+            traceEvents.push_back(entry);
+        }
+        metadata = {
+            {"firstPaintBudgetMs", firstPaintBudgetMs_},
+            {"firstPaintBudgetExceeded", budgetExceeded_}
+        };
+    }
+
+    std::ofstream trace(kTraceFile, std::ios::trunc);
+    if (trace) {
+        trace << nlohmann::json{ {"traceEvents", traceEvents}, {"displayTimeUnit", "ms"}, {"metadata", metadata} }.dump(1);
+        LOG_INFO_BROWSER("📝 Startup timeline written to " + std::string(kTraceFile) +
+                         " (" + std::to_string(traceEvents.size()) + " events)");
+    }
+}
@@ -0,0 +1,565 @@
+#include "../../include/core/StateStore.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/base/cef_bind.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+#define LOG_DEBUG_BROWSER(msg) Logger::Log(msg, 0, 2)
+#define LOG_INFO_BROWSER(msg) Logger::Log(msg, 1, 2)
+#define LOG_WARNING_BROWSER(msg) Logger::Log(msg, 2, 2)
+
+namespace fs = std::filesystem;
+
+namespace {
+    const char kLogMagic[8] = { 'B', 'B', 'K', 'V', '0', '0', '0', '1' };
+
+    enum RecordType : uint8_t {
+        kPutRecord = 1,
+        kDeleteRecord = 2,
+        // Closes a batch; valueLength holds the number of records in it and no payload follows
+        kCommitRecord = 3
+    };
+
+#pragma pack(push, 1)
+    struct RecordHeader {
+        uint32_t crc;   // CRC-32 of everything after this field, payload included
+        uint8_t type;
+        uint8_t reserved;
+        uint16_t keyLength;
+        uint32_t valueLength;
+        uint64_t sequence;
+    };
+#pragma pack(pop)
+
+    const size_t kMaxKeyLength = 0xFFFF;
+    const size_t kMaxValueLength = 16 * 1024 * 1024;
+
+    // The log is rewritten once it is this large and mostly superseded records
+    const uint64_t kCompactMinBytes = 1024 * 1024;
+    const uint64_t kCompactRatio = 4;
+
+    uint32_t Crc32(const char* data, size_t length) {
+        static const std::array<uint32_t, 256> table = [] {
+            std::array<uint32_t, 256> entries = {};
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t crc = i;
+                for (int bit = 0; bit < 8; bit++) {
+                    crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+                }
+                entries[i] = crc;
+            }
+            return entries;
+        }();
+
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < length; i++) {
+            crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    void AppendRecord(std::string& out, uint8_t type, uint64_t sequence,
+                      const std::string& key, const std::string& value, uint32_t count = 0) {
+        RecordHeader header = {};
+        header.type = type;
+        header.keyLength = static_cast<uint16_t>(key.size());
+        header.valueLength = type == kCommitRecord ? count : static_cast<uint32_t>(value.size());
+        header.sequence = sequence;
+
+        size_t start = out.size();
+        out.append(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (type != kCommitRecord) {
+            out.append(key);
+            out.append(value);
+        }
+        uint32_t crc = Crc32(out.data() + start + sizeof(header.crc), out.size() - start - sizeof(header.crc));
+        std::memcpy(&out[start], &crc, sizeof(crc));
+    }
+
+#ifdef _WIN32
+    typedef HANDLE FileHandle;
+    const FileHandle kNoFile = INVALID_HANDLE_VALUE;
+
+    FileHandle OpenLog(const std::wstring& path) {
+        return CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                           OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    }
+
+    FileHandle CreateTemp(const std::wstring& path) {
+        return CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    }
+
+    bool ReadAll(FileHandle file, std::string& contents) {
+        LARGE_INTEGER size = {};
+        if (!GetFileSizeEx(file, &size)) {
+            return false;
+        }
+        contents.assign(static_cast<size_t>(size.QuadPart), '\0');
+        DWORD read = 0;
+        return contents.empty() ||
+               (ReadFile(file, &contents[0], static_cast<DWORD>(contents.size()), &read, nullptr) && read == contents.size());
+    }
+
+    bool WriteAll(FileHandle file, const std::string& data) {
+        DWORD written = 0;
+        return WriteFile(file, data.data(), static_cast<DWORD>(data.size()), &written, nullptr) &&
+               written == data.size();
+    }
+
+    bool FlushFile(FileHandle file) {
+        return FlushFileBuffers(file) != 0;
+    }
+
+    // Cuts the file at size and leaves the write position there
+    void TruncateAt(FileHandle file, uint64_t size) {
+        LARGE_INTEGER position;
+        position.QuadPart = static_cast<LONGLONG>(size);
+        SetFilePointerEx(file, position, nullptr, FILE_BEGIN);
+        SetEndOfFile(file);
+    }
+
+    void SeekToEnd(FileHandle file) {
+        LARGE_INTEGER zero = {};
+        SetFilePointerEx(file, zero, nullptr, FILE_END);
+    }
+
+    void CloseFile(FileHandle file) {
+        CloseHandle(file);
+    }
+
+    bool ReplaceLog(const std::wstring& from, const std::wstring& to) {
+        return MoveFileExW(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+    }
+
+    void RemoveFile(const std::wstring& path) {
+        DeleteFileW(path.c_str());
+    }
+#else
+    typedef int FileHandle;
+    const FileHandle kNoFile = -1;
+
+    FileHandle OpenLog(const std::wstring& path) {
+        return ::open(fs::path(path).c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    }
+
+    FileHandle CreateTemp(const std::wstring& path) {
+        return ::open(fs::path(path).c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    }
+
+    bool ReadAll(FileHandle file, std::string& contents) {
+        contents.clear();
+        char buffer[64 * 1024];
+        ssize_t read;
+        while ((read = ::read(file, buffer, sizeof(buffer))) > 0) {
+            contents.append(buffer, static_cast<size_t>(read));
+        }
+        return read == 0;
+    }
+
+    bool WriteAll(FileHandle file, const std::string& data) {
+        size_t offset = 0;
+        while (offset < data.size()) {
+            ssize_t written = ::write(file, data.data() + offset, data.size() - offset);
+            if (written <= 0) {
+                return false;
+            }
+            offset += static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    bool FlushFile(FileHandle file) {
+        return ::fsync(file) == 0;
+    }
+
+    void TruncateAt(FileHandle file, uint64_t size) {
+        if (::ftruncate(file, static_cast<off_t>(size)) == 0) {
+            ::lseek(file, static_cast<off_t>(size), SEEK_SET);
+        }
+    }
+
+    void SeekToEnd(FileHandle file) {
+        ::lseek(file, 0, SEEK_END);
+    }
+
+    void CloseFile(FileHandle file) {
+        ::close(file);
+    }
+
+    bool ReplaceLog(const std::wstring& from, const std::wstring& to) {
+        return ::rename(fs::path(from).c_str(), fs::path(to).c_str()) == 0;
+    }
+
+    void RemoveFile(const std::wstring& path) {
+        ::unlink(fs::path(path).c_str());
+    }
+#endif
+}
+
+void StateStore::Batch::Put(const std::string& key, const std::string& value) {
+    Op op;
+    op.key = key;
+    op.value = value;
+    ops_.push_back(std::move(op));
+}
+
+void StateStore::Batch::Delete(const std::string& key) {
+    Op op;
+    op.erase = true;
+    op.key = key;
+    ops_.push_back(std::move(op));
+}
+
+StateStore& StateStore::GetInstance() {
+    static StateStore instance;
+    return instance;
+}
+
+StateStore::~StateStore() {
+    Close();
+}
+
+size_t StateStore::EntryBytes(const std::string& key, const std::string& value) {
+    return sizeof(RecordHeader) + key.size() + value.size();
+}
+
+bool StateStore::Open(const std::wstring& directory) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (log_ != kNoFile) {
+        return true;
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    ResetLocked();
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    logPath_ = (fs::path(directory) / L"state.log").wstring();
+
+    log_ = OpenLog(logPath_);
+    if (log_ == kNoFile) {
+        LOG_WARNING_BROWSER("⚠️ State store could not open its log; shell state is kept in memory only");
+        return false;
+    }
+
+    std::string contents;
+    if (!ReadAll(log_, contents)) {
+        CloseFile(log_);
+        log_ = kNoFile;
+        LOG_WARNING_BROWSER("⚠️ State store could not read its log; shell state is kept in memory only");
+        return false;
+    }
+
+    uint64_t validEnd = 0;
+    if (contents.size() >= sizeof(kLogMagic) && std::memcmp(contents.data(), kLogMagic, sizeof(kLogMagic)) == 0) {
+        Recover(contents, validEnd);
+    }
+
+    // Cuts off an uncommitted or torn batch; a foreign file starts over
+    if (validEnd < contents.size()) {
+        truncatedBytes_ = contents.size() - validEnd;
+        TruncateAt(log_, validEnd);
+    }
+    if (validEnd == 0) {
+        WriteAll(log_, std::string(kLogMagic, sizeof(kLogMagic)));
+        FlushFile(log_);
+        validEnd = sizeof(kLogMagic);
+    }
+    SeekToEnd(log_);
+    logBytes_ = validEnd;
+
+    LOG_INFO_BROWSER("🗄️ State store opened: " + std::to_string(data_.size()) + " keys from " +
+                     std::to_string(recoveredBatches_) + " batches in " +
+                     std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::steady_clock::now() - started).count()) + " ms" +
+                     (truncatedBytes_ ? ", dropped " + std::to_string(truncatedBytes_) + " uncommitted bytes" : ""));
+    return true;
+}
+
+void StateStore::Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (log_ != kNoFile) {
+        FlushFile(log_);
+        CloseFile(log_);
+        log_ = kNoFile;
+    }
+}
+
+void StateStore::ResetLocked() {
+    data_.clear();
+    sequence_ = 0;
+    logBytes_ = 0;
+    liveBytes_ = 0;
+    recoveredBatches_ = 0;
+    truncatedBytes_ = 0;
+}
+
+// Applies each batch whose commit record is intact; validEnd ends up just past the last one
+void StateStore::Recover(const std::string& data, uint64_t& validEnd) {
+    Batch pending;
+    uint64_t batchSequence = 0;
+    size_t offset = sizeof(kLogMagic);
+    validEnd = offset;
+
+    while (offset + sizeof(RecordHeader) <= data.size()) {
+        RecordHeader header;
+        std::memcpy(&header, data.data() + offset, sizeof(header));
+        size_t payload = header.type == kCommitRecord ? 0 : static_cast<size_t>(header.keyLength) + header.valueLength;
+        size_t length = sizeof(header) + payload;
+        if (header.valueLength > kMaxValueLength || offset + length > data.size() ||
+            Crc32(data.data() + offset + sizeof(header.crc), length - sizeof(header.crc)) != header.crc) {
+            break;
+        }
+
+        if (header.type == kPutRecord || header.type == kDeleteRecord) {
+            if (pending.Empty()) {
+                batchSequence = header.sequence;
+            } else if (header.sequence != batchSequence) {
+                break;
+            }
+            std::string key = data.substr(offset + sizeof(header), header.keyLength);
+            if (header.type == kPutRecord) {
+                pending.Put(key, data.substr(offset + sizeof(header) + header.keyLength, header.valueLength));
+            } else {
+                pending.Delete(key);
+            }
+        } else if (header.type == kCommitRecord) {
+            if (header.valueLength != pending.ops_.size() || (!pending.Empty() && header.sequence != batchSequence)) {
+                break;
+            }
+            ApplyLocked(pending);
+            pending = Batch();
+            sequence_ = (std::max)(sequence_, header.sequence);
+            recoveredBatches_++;
+            validEnd = offset + length;
+        } else {
+            break;
+        }
+        offset += length;
+    }
+}
+
+void StateStore::ApplyLocked(const Batch& batch) {
+    for (const Batch::Op& op : batch.ops_) {
+        auto it = data_.find(op.key);
+        if (it != data_.end()) {
+            liveBytes_ -= EntryBytes(it->first, it->second);
+        }
+        if (op.erase) {
+            if (it != data_.end()) {
+                data_.erase(it);
+            }
+        } else {
+            data_[op.key] = op.value;
+            liveBytes_ += EntryBytes(op.key, op.value);
+        }
+    }
+}
+
+// A failed append is cut back off so the log never holds a partial batch ahead of later ones
+bool StateStore::AppendLocked(const std::string& records, bool durable) {
+    if (!WriteAll(log_, records) || (durable && !FlushFile(log_))) {
+        TruncateAt(log_, logBytes_);
+        return false;
+    }
+    logBytes_ += records.size();
+    if (compacting_) {
+        compactionTail_ += records;
+    }
+    return true;
+}
+
+bool StateStore::Get(const std::string& key, std::string& value) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = data_.find(key);
+    if (it == data_.end()) {
+        return false;
+    }
+    value = it->second;
+    return true;
+}
+
+std::vector<std::pair<std::string, std::string>> StateStore::Scan(const std::string& prefix) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::pair<std::string, std::string>> entries;
+    for (auto it = data_.lower_bound(prefix);
+         it != data_.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+        entries.emplace_back(it->first, it->second);
+    }
+    return entries;
+}
+
+bool StateStore::Put(const std::string& key, const std::string& value, bool durable) {
+    Batch batch;
+    batch.Put(key, value);
+    return Commit(batch, durable);
+}
+
+bool StateStore::Delete(const std::string& key, bool durable) {
+    Batch batch;
+    batch.Delete(key);
+    return Commit(batch, durable);
+}
+
+bool StateStore::Commit(const Batch& batch, bool durable) {
+    if (batch.Empty()) {
+        return true;
+    }
+    for (const Batch::Op& op : batch.ops_) {
+        if (op.key.empty() || op.key.size() > kMaxKeyLength || op.value.size() > kMaxValueLength) {
+            LOG_WARNING_BROWSER("⚠️ State store rejected a batch with an invalid key or oversized value");
+            return false;
+        }
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint64_t sequence = ++sequence_;
+
+        if (log_ != kNoFile) {
+            std::string records;
+            for (const Batch::Op& op : batch.ops_) {
+                AppendRecord(records, op.erase ? kDeleteRecord : kPutRecord, sequence, op.key, op.value);
+            }
+            AppendRecord(records, kCommitRecord, sequence, "", "", static_cast<uint32_t>(batch.ops_.size()));
+
+            if (!AppendLocked(records, durable)) {
+                // Nothing was applied, so memory still matches the log
+                failedCommits_++;
+                LOG_WARNING_BROWSER("⚠️ State store commit failed to reach disk");
+                return false;
+            }
+        }
+        ApplyLocked(batch);
+
+        uint64_t micros = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started).count());
+        commits_++;
+        if (durable) {
+            durableCommits_++;
+        }
+        commitMicrosTotal_ += micros;
+        commitMicrosMax_ = (std::max)(commitMicrosMax_, micros);
+    }
+
+    MaybeScheduleCompaction();
+    return true;
+}
+
+void StateStore::MaybeScheduleCompaction() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (compacting_ || log_ == kNoFile ||
+        logBytes_ < kCompactMinBytes || logBytes_ < kCompactRatio * liveBytes_) {
+        return;
+    }
+    compacting_ = true;
+    CefPostTask(TID_FILE_BACKGROUND, base::BindOnce([]() {
+        StateStore::GetInstance().Compact();
+    }));
+}
+
+// Writes the live data as a single batch to a sibling file and renames it over the log. The data
+// is copied under the lock, but the rewrite and its flush run without it; commits made meanwhile
+// go to the old log as usual and are also kept in compactionTail_, which is appended to the new
+// file under the lock just before the swap.
+void StateStore::Compact() {
+    auto started = std::chrono::steady_clock::now();
+
+    std::map<std::string, std::string> snapshot;
+    uint64_t sequence = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (log_ == kNoFile) {
+            compacting_ = false;
+            return;
+        }
+        snapshot = data_;
+        sequence = ++sequence_;
+        compactionTail_.clear();
+    }
+
+    std::string contents(kLogMagic, sizeof(kLogMagic));
+    if (!snapshot.empty()) {
+        for (const auto& pair : snapshot) {
+            AppendRecord(contents, kPutRecord, sequence, pair.first, pair.second);
+        }
+        AppendRecord(contents, kCommitRecord, sequence, "", "", static_cast<uint32_t>(snapshot.size()));
+    }
+
+    std::wstring tempPath = logPath_ + L".compact";
+    FileHandle temp = CreateTemp(tempPath);
+    bool written = temp != kNoFile && WriteAll(temp, contents) && FlushFile(temp);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    compacting_ = false;
+    std::string tail;
+    tail.swap(compactionTail_);
+
+    // The commits that raced the rewrite are usually a handful of records
+    written = written && log_ != kNoFile && WriteAll(temp, tail) && FlushFile(temp);
+    if (temp != kNoFile) {
+        CloseFile(temp);
+    }
+    if (!written) {
+        RemoveFile(tempPath);
+        if (log_ != kNoFile) {
+            LOG_WARNING_BROWSER("⚠️ State store compaction could not write " + fs::path(tempPath).u8string());
+        }
+        return;
+    }
+
+    CloseFile(log_);
+    bool replaced = ReplaceLog(tempPath, logPath_);
+    if (!replaced) {
+        RemoveFile(tempPath);
+    }
+    log_ = OpenLog(logPath_);
+    if (log_ == kNoFile) {
+        LOG_WARNING_BROWSER("⚠️ State store could not reopen its log; further changes are kept in memory only");
+        return;
+    }
+    SeekToEnd(log_);
+
+    if (replaced) {
+        uint64_t compactedBytes = contents.size() + tail.size();
+        bytesReclaimed_ += logBytes_ > compactedBytes ? logBytes_ - compactedBytes : 0;
+        logBytes_ = compactedBytes;
+        compactions_++;
+    }
+    lastCompactionMs_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started).count();
+}
+
+nlohmann::json StateStore::GetStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {
+        {"open", log_ != kNoFile},
+        {"logPath", fs::path(logPath_).u8string()},
+        {"keys", data_.size()},
+        {"liveBytes", liveBytes_},
+        {"logBytes", logBytes_},
+        {"recoveredBatches", recoveredBatches_},
+        {"truncatedBytes", truncatedBytes_},
+        {"commits", commits_},
+        {"durableCommits", durableCommits_},
+        {"failedCommits", failedCommits_},
+        {"avgCommitMicros", commits_ ? commitMicrosTotal_ / commits_ : 0},
+        {"maxCommitMicros", commitMicrosMax_},
+        {"compactions", compactions_},
+        {"bytesReclaimed", bytesReclaimed_},
+        {"lastCompactionMs", lastCompactionMs_}
+    };
+}
@@ -0,0 +1,361 @@
+#include "../../include/core/TabLifecycle.h"
+#include "../../include/core/TabManager.h"
+#include "../../include/core/PendingAuthRequest.h"
+#include "../../include/core/Encoding.h"
+#include "include/cef_command_line.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+#include "include/base/cef_bind.h"
+#include <psapi.h>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#ifndef PW_RENDERFULLCONTENT
+#define PW_RENDERFULLCONTENT 0x00000002
+#endif
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+#define LOG_DEBUG_BROWSER(msg) Logger::Log(msg, 0, 2)
+#define LOG_INFO_BROWSER(msg) Logger::Log(msg, 1, 2)
+#define LOG_WARNING_BROWSER(msg) Logger::Log(msg, 2, 2)
+
+// Domain whose approval modal is currently open (HttpRequestInterceptor)
+extern std::string g_pendingModalDomain;
+
+namespace {
+    const int kTickIntervalMs = 15000;
+    const auto kCaptureTimeout = std::chrono::seconds(5);
+    const int kThumbnailWidth = 256;
+
+    uint64_t PrivateBytesOf(DWORD pid) {
+        HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+        if (!process) {
+            return 0;
+        }
+        PROCESS_MEMORY_COUNTERS_EX counters = {};
+        uint64_t bytes = 0;
+        if (GetProcessMemoryInfo(process, reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters))) {
+            bytes = counters.PrivateUsage;
+        }
+        CloseHandle(process);
+        return bytes;
+    }
+
+    // Renders the window into a kThumbnailWidth-wide 24-bit BMP; empty on failure
+    std::string CaptureWindowBmp(HWND hwnd) {
+        RECT rect;
+        if (!GetClientRect(hwnd, &rect)) {
+            return "";
+        }
+        int width = rect.right - rect.left;
+        int height = rect.bottom - rect.top;
+        if (width <= 0 || height <= 0) {
+            return "";
+        }
+        int thumbWidth = (std::min)(kThumbnailWidth, width);
+        int thumbHeight = (std::max)(1, height * thumbWidth / width);
+
+        HDC windowDc = GetDC(hwnd);
+        HDC fullDc = CreateCompatibleDC(windowDc);
+        HBITMAP fullBitmap = CreateCompatibleBitmap(windowDc, width, height);
+        HGDIOBJ oldFull = SelectObject(fullDc, fullBitmap);
+
+        std::string bmp;
+        if (PrintWindow(hwnd, fullDc, PW_CLIENTONLY | PW_RENDERFULLCONTENT)) {
+            BITMAPINFO info = {};
+            info.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+            info.bmiHeader.biWidth = thumbWidth;
+            info.bmiHeader.biHeight = thumbHeight;
+            info.bmiHeader.biPlanes = 1;
+            info.bmiHeader.biBitCount = 24;
+            info.bmiHeader.biCompression = BI_RGB;
+
+            void* bits = nullptr;
+            HDC thumbDc = CreateCompatibleDC(windowDc);
+            HBITMAP thumbBitmap = CreateDIBSection(thumbDc, &info, DIB_RGB_COLORS, &bits, nullptr, 0);
+            if (thumbBitmap && bits) {
+                HGDIOBJ oldThumb = SelectObject(thumbDc, thumbBitmap);
+                SetStretchBltMode(thumbDc, HALFTONE);
+                SetBrushOrgEx(thumbDc, 0, 0, nullptr);
+                StretchBlt(thumbDc, 0, 0, thumbWidth, thumbHeight, fullDc, 0, 0, width, height, SRCCOPY);
+                GdiFlush();
+
+                DWORD stride = ((thumbWidth * 3) + 3) & ~3u;
+                DWORD pixelBytes = stride * thumbHeight;
+                BITMAPFILEHEADER file = {};
+                file.bfType = 0x4D42;
+                file.bfOffBits = sizeof(BITMAPFILEHEADER) + sizeof(BITMAPINFOHEADER);
+                file.bfSize = file.bfOffBits + pixelBytes;
+                info.bmiHeader.biSizeImage = pixelBytes;
+
+                bmp.reserve(file.bfSize);
+                bmp.append(reinterpret_cast<const char*>(&file), sizeof(file));
+                bmp.append(reinterpret_cast<const char*>(&info.bmiHeader), sizeof(BITMAPINFOHEADER));
+                bmp.append(static_cast<const char*>(bits), pixelBytes);
+
+                SelectObject(thumbDc, oldThumb);
+            }
+            if (thumbBitmap) {
+                DeleteObject(thumbBitmap);
+            }
+            DeleteDC(thumbDc);
+        }
+
+        SelectObject(fullDc, oldFull);
+        DeleteObject(fullBitmap);
+        DeleteDC(fullDc);
+        ReleaseDC(hwnd, windowDc);
+        return bmp;
+    }
+}
+
+TabLifecycle& TabLifecycle::GetInstance() {
+    static TabLifecycle instance;
+    return instance;
+}
+
+void TabLifecycle::Start() {
+    CEF_REQUIRE_UI_THREAD();
+    if (started_) {
+        return;
+    }
+    started_ = true;
+
+    CefRefPtr<CefCommandLine> command_line = CefCommandLine::GetGlobalCommandLine();
+    if (command_line && command_line->HasSwitch("tab-memory-budget-mb")) {
+        long long budgetMb = std::atoll(command_line->GetSwitchValue("tab-memory-budget-mb").ToString().c_str());
+        if (budgetMb > 0) {
+            budgetBytes_ = static_cast<uint64_t>(budgetMb) * 1024 * 1024;
+        }
+    }
+    if (command_line && command_line->HasSwitch("tab-discard-idle-s")) {
+        long long idleSeconds = std::atoll(command_line->GetSwitchValue("tab-discard-idle-s").ToString().c_str());
+        if (idleSeconds >= 0) {
+            minIdle_ = std::chrono::seconds(idleSeconds);
+        }
+    }
+
+    LOG_INFO_BROWSER("🗂️ Tab lifecycle: budget " + std::to_string(budgetBytes_ / (1024 * 1024)) +
+                     " MB, discard after " + std::to_string(minIdle_.count()) + " s idle");
+    ScheduleTick();
+}
+
+void TabLifecycle::ScheduleTick() {
+    CefPostDelayedTask(TID_UI, base::BindOnce([]() {
+        TabLifecycle::GetInstance().Tick();
+    }), kTickIntervalMs);
+}
+
+void TabLifecycle::OnRendererPid(int browserId, DWORD pid) {
+    rendererPids_[browserId] = pid;
+}
+
+bool TabLifecycle::IsProtected(const std::string& domain, int walletInFlight) const {
+    if (walletInFlight > 0) {
+        return true;
+    }
+    if (domain.empty()) {
+        return false;
+    }
+    // An approval modal holds the request open, but guard on the domain too in case the
+    // modal outlives the handler that raised it
+    return (g_pendingAuthRequest.isValid && g_pendingAuthRequest.domain == domain) ||
+           g_pendingModalDomain == domain;
+}
+
+void TabLifecycle::Tick() {
+    ticks_++;
+    auto now = std::chrono::steady_clock::now();
+
+    for (auto it = pendingDiscards_.begin(); it != pendingDiscards_.end();) {
+        it = now - it->second.requestedAt > kCaptureTimeout ? pendingDiscards_.erase(it) : std::next(it);
+    }
+
+    std::vector<TabManager::TabSnapshot> tabs = TabManager::GetInstance().Snapshot();
+
+    // Renderer memory: each process is measured once and split evenly across the tabs it hosts
+    std::unordered_map<int, DWORD> livePids;
+    std::unordered_map<DWORD, int> tabsPerPid;
+    for (const auto& tab : tabs) {
+        if (tab.discarded || !tab.browserId) {
+            continue;
+        }
+        auto pid = rendererPids_.find(tab.browserId);
+        if (pid != rendererPids_.end()) {
+            livePids[tab.browserId] = pid->second;
+            tabsPerPid[pid->second]++;
+        }
+    }
+    rendererPids_.swap(livePids);
+
+    std::unordered_map<DWORD, uint64_t> bytesPerPid;
+    uint64_t total = 0;
+    for (const auto& pair : tabsPerPid) {
+        uint64_t bytes = PrivateBytesOf(pair.first);
+        bytesPerPid[pair.first] = bytes;
+        total += bytes;
+    }
+    rendererBytes_ = total;
+
+    CaptureActiveThumbnail();
+    ScheduleTick();
+
+    if (total <= budgetBytes_) {
+        return;
+    }
+
+    // Least recently active first
+    std::vector<const TabManager::TabSnapshot*> candidates;
+    for (const auto& tab : tabs) {
+        if (!tab.active && !tab.discarded && tab.browserId && now - tab.lastActive >= minIdle_) {
+            candidates.push_back(&tab);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto* a, const auto* b) {
+        return a->lastActive < b->lastActive;
+    });
+
+    uint64_t excess = total - budgetBytes_;
+    uint64_t planned = 0;
+    for (const auto& pair : pendingDiscards_) {
+        planned += pair.second.estimatedBytes;
+    }
+
+    for (const auto* tab : candidates) {
+        if (planned >= excess) {
+            break;
+        }
+        if (pendingDiscards_.count(tab->browserId)) {
+            continue;
+        }
+        if (IsProtected(tab->domain, tab->walletInFlight)) {
+            skippedProtected_++;
+            continue;
+        }
+        CefRefPtr<CefBrowser> browser = TabManager::GetInstance().GetTabBrowser(tab->id);
+        if (!browser || !browser->GetMainFrame()) {
+            continue;
+        }
+
+        PendingDiscard pending;
+        pending.tabId = tab->id;
+        pending.requestedAt = now;
+        auto pid = rendererPids_.find(tab->browserId);
+        if (pid != rendererPids_.end()) {
+            pending.estimatedBytes = bytesPerPid[pid->second] / tabsPerPid[pid->second];
+        } else if (!rendererPids_.empty()) {
+            pending.estimatedBytes = total / rendererPids_.size();
+        }
+        pendingDiscards_[tab->browserId] = pending;
+        planned += pending.estimatedBytes;
+
+        // The discard itself happens in OnTabState once the renderer has reported its scroll offset
+        browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, CefProcessMessage::Create("tab_capture_state"));
+    }
+}
+
+void TabLifecycle::OnTabState(int browserId, int scrollX, int scrollY) {
+    auto it = pendingDiscards_.find(browserId);
+    if (it == pendingDiscards_.end()) {
+        return;
+    }
+    PendingDiscard pending = it->second;
+    pendingDiscards_.erase(it);
+
+    // Re-check: the tab may have been activated or started a wallet call since the tick
+    for (const auto& tab : TabManager::GetInstance().Snapshot()) {
+        if (tab.id != pending.tabId) {
+            continue;
+        }
+        if (tab.active || tab.discarded || tab.browserId != browserId) {
+            return;
+        }
+        if (IsProtected(tab.domain, tab.walletInFlight)) {
+            skippedProtected_++;
+            return;
+        }
+        break;
+    }
+
+    if (TabManager::GetInstance().DiscardTab(pending.tabId, scrollX, scrollY)) {
+        rendererPids_.erase(browserId);
+        discards_++;
+        reclaimedBytes_ += pending.estimatedBytes;
+        LOG_INFO_BROWSER("🗂️ Discarded tab " + std::to_string(pending.tabId) + ", ~" +
+                         std::to_string(pending.estimatedBytes / (1024 * 1024)) + " MB reclaimed");
+    }
+}
+
+void TabLifecycle::CaptureActiveThumbnail() {
+    TabManager& tabs = TabManager::GetInstance();
+    CefRefPtr<CefBrowser> browser = tabs.GetActiveBrowser();
+    if (!browser) {
+        return;
+    }
+    HWND hwnd = browser->GetHost()->GetWindowHandle();
+    if (!hwnd || !IsWindowVisible(hwnd) || IsIconic(GetAncestor(hwnd, GA_ROOT))) {
+        return;
+    }
+    std::string bmp = CaptureWindowBmp(hwnd);
+    if (!bmp.empty()) {
+        thumbnails_[tabs.GetActiveTabId()] = std::move(bmp);
+    }
+}
+
+void TabLifecycle::OnTabRestoring(int tabId) {
+    restoring_[tabId] = std::chrono::steady_clock::now();
+}
+
+void TabLifecycle::OnTabLoaded(int tabId) {
+    auto it = restoring_.find(tabId);
+    if (it == restoring_.end()) {
+        return;
+    }
+    restores_++;
+    restoreTotalMs_ += std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - it->second).count();
+    restoring_.erase(it);
+}
+
+void TabLifecycle::OnTabRemoved(int tabId) {
+    thumbnails_.erase(tabId);
+    restoring_.erase(tabId);
+}
+
+std::string TabLifecycle::GetThumbnailDataUrl(int tabId) const {
+    auto it = thumbnails_.find(tabId);
+    if (it == thumbnails_.end()) {
+        return "";
+    }
+    return "data:image/bmp;base64," + Encoding::base64Encode(it->second);
+}
+
+nlohmann::json TabLifecycle::GetStats() const {
+    uint64_t thumbnailBytes = 0;
+    for (const auto& pair : thumbnails_) {
+        thumbnailBytes += pair.second.size();
+    }
+
+    return {
+        {"budgetBytes", budgetBytes_},
+        {"minIdleSeconds", minIdle_.count()},
+        {"rendererBytes", rendererBytes_},
+        {"overBudget", rendererBytes_ > budgetBytes_},
+        {"discards", discards_},
+        {"restores", restores_},
+        {"avgRestoreMs", restores_ ? restoreTotalMs_ / restores_ : 0},
+        {"reclaimedBytes", reclaimedBytes_},
+        {"skippedProtected", skippedProtected_},
+        {"pendingCaptures", pendingDiscards_.size()},
+        {"thumbnails", thumbnails_.size()},
+        {"thumbnailBytes", thumbnailBytes},
+        {"ticks", ticks_}
+    };
+}
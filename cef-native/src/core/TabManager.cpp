@@ -0,0 +1,754 @@
+#include "../../include/core/TabManager.h"
+#include "../../include/core/TabLifecycle.h"
+#include "../../include/core/OcclusionTracker.h"
+#include "../../include/core/NavigationPredictor.h"
+#include "../../include/core/HistoryStore.h"
+#include "../../include/handlers/simple_handler.h"
+#include "../../include/handlers/simple_app.h"
+#include "include/cef_request_context.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+#include "include/base/cef_bind.h"
+#include <tlhelp32.h>
+#include <psapi.h>
+#include <algorithm>
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+#define LOG_DEBUG_BROWSER(msg) Logger::Log(msg, 0, 2)
+#define LOG_INFO_BROWSER(msg) Logger::Log(msg, 1, 2)
+#define LOG_WARNING_BROWSER(msg) Logger::Log(msg, 2, 2)
+
+namespace {
+    const size_t kRecentSwitchSamples = 256;
+
+    // Each benchmark tab is a renderer process; past this the machine, not the switch, is measured
+    const int kMaxBenchmarkTabs = 100;
+    const char* kStartPage = "https://metanetapps.com/";
+
+    std::string HostOf(const std::string& url) {
+        size_t protocolPos = url.find("://");
+        if (protocolPos == std::string::npos) {
+            return "";
+        }
+        size_t start = protocolPos + 3;
+        size_t end = url.find('/', start);
+        return end == std::string::npos ? url.substr(start) : url.substr(start, end - start);
+    }
+
+    // Private bytes of every direct child process (renderers, GPU, network service)
+    uint64_t ChildProcessPrivateBytes() {
+        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+        if (snapshot == INVALID_HANDLE_VALUE) {
+            return 0;
+        }
+
+        DWORD self = GetCurrentProcessId();
+        uint64_t total = 0;
+        PROCESSENTRY32W entry = {};
+        entry.dwSize = sizeof(entry);
+        for (BOOL more = Process32FirstW(snapshot, &entry); more; more = Process32NextW(snapshot, &entry)) {
+            if (entry.th32ParentProcessID != self) {
+                continue;
+            }
+            HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, entry.th32ProcessID);
+            if (!process) {
+                continue;
+            }
+            PROCESS_MEMORY_COUNTERS_EX counters = {};
+            if (GetProcessMemoryInfo(process, reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters))) {
+                total += counters.PrivateUsage;
+            }
+            CloseHandle(process);
+        }
+        CloseHandle(snapshot);
+        return total;
+    }
+
+    long long Percentile(std::vector<long long> samples, double p) {
+        if (samples.empty()) {
+            return 0;
+        }
+        size_t index = static_cast<size_t>(p * (samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return samples[index];
+    }
+}
+
+TabManager& TabManager::GetInstance() {
+    static TabManager instance;
+    return instance;
+}
+
+void TabManager::OpenTab(const std::string& url, bool activate) {
+    CEF_REQUIRE_UI_THREAD();
+    PendingTab pending;
+    pending.activate = activate;
+    CreateTabBrowser(url.empty() ? kStartPage : url, pending);
+}
+
+bool TabManager::CreateTabBrowser(const std::string& url, const PendingTab& pending) {
+    RECT hostRect;
+    GetClientRect(g_webview_hwnd, &hostRect);
+
+    CefWindowInfo window_info;
+    window_info.SetAsChild(g_webview_hwnd, CefRect(0, 0, hostRect.right - hostRect.left, hostRect.bottom - hostRect.top));
+    if (!pending.activate) {
+        // Background tabs start hidden so they never flash over the active one
+        window_info.style &= ~WS_VISIBLE;
+    }
+
+    CefBrowserSettings settings;
+    pending_.push_back(pending);
+    if (!CefBrowserHost::CreateBrowser(window_info, new SimpleHandler("webview"), url, settings,
+                                       nullptr, CefRequestContext::GetGlobalContext())) {
+        pending_.pop_back();
+        LOG_WARNING_BROWSER("⚠️ Failed to create tab for " + url);
+        return false;
+    }
+    LOG_DEBUG_BROWSER("🗂️ Opening tab: " + url);
+    return true;
+}
+
+void TabManager::OnTabCreated(CefRefPtr<CefBrowser> browser) {
+    CEF_REQUIRE_UI_THREAD();
+
+    PendingTab pending;
+    if (!pending_.empty()) {
+        pending = pending_.front();
+        pending_.pop_front();
+    } else {
+        // Created outside OpenTab (e.g. the startup browser)
+        pending.activate = true;
+    }
+
+    int browserId = browser->GetIdentifier();
+    RECT hostRect;
+    GetClientRect(g_webview_hwnd, &hostRect);
+
+    Tab* tab = nullptr;
+    if (pending.restoreTabId) {
+        auto it = tabs_.find(pending.restoreTabId);
+        if (it == tabs_.end()) {
+            // Closed while its browser was being recreated
+            browser->GetHost()->CloseBrowser(true);
+            return;
+        }
+        tab = &it->second;
+        tab->discarded = false;
+        tab->restoring = false;
+        tab->restoreScroll = tab->scrollX != 0 || tab->scrollY != 0;
+        tab->skipHistory = true;
+        LOG_DEBUG_BROWSER("🗂️ Tab " + std::to_string(tab->id) + " restored into browser " + std::to_string(browserId));
+    } else {
+        Tab& created = tabs_[browserId];
+        created.id = browserId;
+        created.prerender = pending.prerenderToken != 0;
+        if (!created.prerender) {
+            order_.push_back(browserId);
+            opened_++;
+        }
+        tab = &created;
+        LOG_DEBUG_BROWSER("🗂️ Tab " + std::to_string(browserId) + (created.prerender ? " created for prerender" : " created") +
+                          " (" + std::to_string(tabs_.size()) + " open)");
+    }
+
+    tab->browser = browser;
+    tab->width = hostRect.right - hostRect.left;
+    tab->height = hostRect.bottom - hostRect.top;
+    tab->lastActive = std::chrono::steady_clock::now();
+    browserToTab_[browserId] = tab->id;
+    {
+        std::lock_guard<std::mutex> lock(contextMutex_);
+        WalletContext& context = contexts_[browserId];
+        context.url = browser->GetMainFrame() ? browser->GetMainFrame()->GetURL().ToString() : "";
+        context.domain = HostOf(context.url);
+        context.prerender = tab->prerender;
+    }
+
+    if (tab->prerender) {
+        NavigationPredictor::GetInstance().OnPrerenderCreated(tab->id, pending.prerenderToken);
+        return;
+    }
+
+    if (pending.benchmark) {
+        tab->skipHistory = true;
+        benchmarkTabIds_.push_back(tab->id);
+        if (--benchmarkPending_ == 0) {
+            // Let the new renderers settle before measuring memory and switching
+            CefPostDelayedTask(TID_UI, base::BindOnce([]() {
+                TabManager::GetInstance().RunBenchmarkSwitches();
+            }), 2000);
+        }
+        return;
+    }
+
+    if (pending.activate || activeTabId_ == -1) {
+        ActivateTab(tab->id);
+    } else {
+        BroadcastTabs();
+    }
+}
+
+bool TabManager::ActivateTab(int tabId) {
+    CEF_REQUIRE_UI_THREAD();
+
+    auto target = tabs_.find(tabId);
+    if (target == tabs_.end() || target->second.prerender) {
+        return false;
+    }
+    if (tabId == activeTabId_) {
+        return true;
+    }
+
+    if (target->second.discarded) {
+        // The switch happens in OnTabCreated once the page has a browser again
+        if (!target->second.restoring) {
+            PendingTab pending;
+            pending.activate = true;
+            pending.restoreTabId = tabId;
+            if (!CreateTabBrowser(target->second.discardedUrl, pending)) {
+                return false;
+            }
+            target->second.restoring = true;
+            TabLifecycle::GetInstance().OnTabRestoring(tabId);
+        }
+        return true;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    ShowTab(target->second);
+    auto previous = tabs_.find(activeTabId_);
+    if (previous != tabs_.end() && previous->second.browser) {
+        HWND previousHwnd = previous->second.browser->GetHost()->GetWindowHandle();
+        if (previousHwnd) {
+            // Hiding the window is what tells Chromium the page is hidden for windowed browsers
+            ShowWindow(previousHwnd, SW_HIDE);
+        }
+        // Idle time for the discard policy counts from when the tab was last on screen
+        previous->second.lastActive = std::chrono::steady_clock::now();
+    }
+    activeTabId_ = tabId;
+    target->second.lastActive = std::chrono::steady_clock::now();
+
+    RecordSwitch(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
+
+    if (!benchmarkRunning_) {
+        BroadcastTabs();
+    }
+    return true;
+}
+
+void TabManager::ShowTab(Tab& tab) {
+    // While minimized the active tab stays hidden; OcclusionTracker shows it on restore
+    if (!tab.browser || OcclusionTracker::GetInstance().IsMinimized()) {
+        return;
+    }
+    HWND hwnd = tab.browser->GetHost()->GetWindowHandle();
+    if (!hwnd) {
+        return;
+    }
+
+    RECT hostRect;
+    GetClientRect(g_webview_hwnd, &hostRect);
+    int width = hostRect.right - hostRect.left;
+    int height = hostRect.bottom - hostRect.top;
+
+    if (tab.width != width || tab.height != height) {
+        SetWindowPos(hwnd, HWND_TOP, 0, 0, width, height, SWP_NOACTIVATE | SWP_SHOWWINDOW);
+        tab.browser->GetHost()->WasResized();
+        tab.width = width;
+        tab.height = height;
+    } else {
+        SetWindowPos(hwnd, HWND_TOP, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE | SWP_SHOWWINDOW);
+    }
+}
+
+void TabManager::ActivateAdjacent(int direction) {
+    CEF_REQUIRE_UI_THREAD();
+
+    if (order_.size() < 2) {
+        return;
+    }
+    auto it = std::find(order_.begin(), order_.end(), activeTabId_);
+    int index = it == order_.end() ? 0 : static_cast<int>(it - order_.begin());
+    int count = static_cast<int>(order_.size());
+    ActivateTab(order_[((index + direction) % count + count) % count]);
+}
+
+bool TabManager::CloseTab(int tabId) {
+    CEF_REQUIRE_UI_THREAD();
+
+    auto it = tabs_.find(tabId);
+    auto position = std::find(order_.begin(), order_.end(), tabId);
+    if (it == tabs_.end() || position == order_.end()) {
+        return false;
+    }
+
+    if (order_.size() == 1 && !benchmarkRunning_) {
+        // The shell always keeps one tab; closing the last one goes back to the start page
+        if (it->second.browser) {
+            it->second.browser->GetMainFrame()->LoadURL(kStartPage);
+        }
+        return true;
+    }
+
+    size_t index = position - order_.begin();
+    order_.erase(position);
+    if (tabId == activeTabId_ && !order_.empty()) {
+        ActivateTab(order_[(std::min)(index, order_.size() - 1)]);
+    }
+
+    if (it->second.browser) {
+        // The tab entry is dropped in OnTabClosed once CEF has torn the browser down
+        it->second.browser->GetHost()->CloseBrowser(false);
+    } else {
+        // Discarded: there is no browser left to wait for
+        RemoveTab(tabId);
+    }
+    if (!benchmarkRunning_) {
+        BroadcastTabs();
+    }
+    return true;
+}
+
+bool TabManager::DiscardTab(int tabId, int scrollX, int scrollY) {
+    CEF_REQUIRE_UI_THREAD();
+
+    auto it = tabs_.find(tabId);
+    if (it == tabs_.end() || tabId == activeTabId_ || !it->second.browser) {
+        return false;
+    }
+
+    Tab& tab = it->second;
+    int browserId = tab.browser->GetIdentifier();
+    {
+        std::lock_guard<std::mutex> lock(contextMutex_);
+        auto context = contexts_.find(browserId);
+        if (context != contexts_.end() && context->second.walletInFlight > 0) {
+            return false;
+        }
+        tab.discardedUrl = context != contexts_.end() ? context->second.url : tab.browser->GetMainFrame()->GetURL().ToString();
+    }
+
+    tab.discarded = true;
+    tab.scrollX = scrollX;
+    tab.scrollY = scrollY;
+
+    // Forced: a discarded page must not be able to hold its renderer open with beforeunload
+    CefRefPtr<CefBrowser> browser = tab.browser;
+    tab.browser = nullptr;
+    browser->GetHost()->CloseBrowser(true);
+
+    LOG_DEBUG_BROWSER("🗂️ Tab " + std::to_string(tabId) + " discarded (" + tab.discardedUrl + ")");
+    BroadcastTabs();
+    return true;
+}
+
+bool TabManager::OpenPrerender(const std::string& url, uint64_t token) {
+    CEF_REQUIRE_UI_THREAD();
+    PendingTab pending;
+    pending.prerenderToken = token;
+    return CreateTabBrowser(url, pending);
+}
+
+bool TabManager::AdoptPrerender(int tabId) {
+    CEF_REQUIRE_UI_THREAD();
+
+    auto it = tabs_.find(tabId);
+    if (it == tabs_.end() || !it->second.prerender || !it->second.browser) {
+        return false;
+    }
+    it->second.prerender = false;
+    bool walletBlocked = false;
+    {
+        std::lock_guard<std::mutex> lock(contextMutex_);
+        auto context = contexts_.find(it->second.browser->GetIdentifier());
+        if (context != contexts_.end()) {
+            context->second.prerender = false;
+            walletBlocked = context->second.prerenderWalletBlocked;
+        }
+    }
+    opened_++;
+    if (walletBlocked) {
+        it->second.browser->Reload();
+    }
+    // A prerender still loading (or reloading) is recorded when its load finishes
+    if (!walletBlocked && !it->second.browser->IsLoading()) {
+        HistoryStore::GetInstance().RecordVisit(it->second.browser->GetMainFrame()->GetURL().ToString(),
+                                                it->second.title, true);
+    }
+
+    // Takes the active tab's place in the strip; the replaced tab closes once the switch is done
+    int replacedTabId = activeTabId_;
+    auto position = std::find(order_.begin(), order_.end(), replacedTabId);
+    if (position != order_.end()) {
+        *position = tabId;
+    } else {
+        order_.push_back(tabId);
+    }
+    ActivateTab(tabId);
+
+    auto replaced = tabs_.find(replacedTabId);
+    if (replaced != tabs_.end() && replaced->second.browser) {
+        replaced->second.browser->GetHost()->CloseBrowser(false);
+    }
+    BroadcastTabs();
+    return true;
+}
+
+void TabManager::ClosePrerender(int tabId) {
+    auto it = tabs_.find(tabId);
+    if (it != tabs_.end() && it->second.prerender && it->second.browser) {
+        // Forced: an unseen page gets no say through beforeunload
+        it->second.browser->GetHost()->CloseBrowser(true);
+    }
+}
+
+void TabManager::OnTabClosed(int browserId) {
+    CEF_REQUIRE_UI_THREAD();
+
+    auto mapping = browserToTab_.find(browserId);
+    if (mapping == browserToTab_.end()) {
+        return;
+    }
+    int tabId = mapping->second;
+    browserToTab_.erase(mapping);
+    {
+        std::lock_guard<std::mutex> lock(contextMutex_);
+        contexts_.erase(browserId);
+    }
+
+    auto it = tabs_.find(tabId);
+    if (it != tabs_.end() && it->second.discarded) {
+        // Discarded tabs stay in the strip until the user closes them
+        return;
+    }
+    RemoveTab(tabId);
+}
+
+void TabManager::RemoveTab(int tabId) {
+    auto it = tabs_.find(tabId);
+    if (it == tabs_.end()) {
+        return;
+    }
+    bool prerender = it->second.prerender;
+    tabs_.erase(it);
+    order_.erase(std::remove(order_.begin(), order_.end(), tabId), order_.end());
+    if (activeTabId_ == tabId) {
+        activeTabId_ = -1;
+    }
+    if (!prerender) {
+        closed_++;
+    }
+    TabLifecycle::GetInstance().OnTabRemoved(tabId);
+    NavigationPredictor::GetInstance().OnTabRemoved(tabId);
+}
+
+void TabManager::OnTabLoaded(int browserId) {
+    auto mapping = browserToTab_.find(browserId);
+    if (mapping == browserToTab_.end()) {
+        return;
+    }
+    auto it = tabs_.find(mapping->second);
+    if (it == tabs_.end() || !it->second.browser) {
+        return;
+    }
+
+    Tab& tab = it->second;
+    if (tab.restoreScroll) {
+        tab.restoreScroll = false;
+        std::string js = "window.scrollTo(" + std::to_string(tab.scrollX) + ", " + std::to_string(tab.scrollY) + ");";
+        tab.browser->GetMainFrame()->ExecuteJavaScript(js, tab.browser->GetMainFrame()->GetURL(), 0);
+    }
+    TabLifecycle::GetInstance().OnTabLoaded(tab.id);
+    NavigationPredictor::GetInstance().OnTabLoaded(tab.id);
+
+    // Prerenders are recorded if and when they are adopted
+    if (tab.skipHistory) {
+        tab.skipHistory = false;
+    } else if (!tab.prerender) {
+        HistoryStore::GetInstance().RecordVisit(tab.browser->GetMainFrame()->GetURL().ToString(), tab.title,
+                                                tab.id == activeTabId_);
+    }
+}
+
+void TabManager::OnAddressChange(int browserId, const std::string& url) {
+    {
+        std::lock_guard<std::mutex> lock(contextMutex_);
+        auto it = contexts_.find(browserId);
+        if (it == contexts_.end()) {
+            return;
+        }
+        it->second.url = url;
+        it->second.domain = HostOf(url);
+    }
+    BroadcastTabs();
+}
+
+void TabManager::OnTitleChange(int browserId, const std::string& title) {
+    int tabId = TabIdForBrowser(browserId);
+    auto it = tabs_.find(tabId);
+    if (it != tabs_.end()) {
+        it->second.title = title;
+        BroadcastTabs();
+        if (!it->second.prerender && it->second.browser) {
+            HistoryStore::GetInstance().RecordTitle(it->second.browser->GetMainFrame()->GetURL().ToString(), title);
+        }
+    }
+}
+
+void TabManager::OnHostResized() {
+    CEF_REQUIRE_UI_THREAD();
+
+    auto it = tabs_.find(activeTabId_);
+    if (it != tabs_.end()) {
+        ShowTab(it->second);
+    }
+}
+
+void TabManager::CloseAll() {
+    for (auto& pair : tabs_) {
+        if (pair.second.browser) {
+            pair.second.browser->GetHost()->CloseBrowser(false);
+        }
+    }
+}
+
+CefRefPtr<CefBrowser> TabManager::GetActiveBrowser() const {
+    return GetTabBrowser(activeTabId_);
+}
+
+CefRefPtr<CefBrowser> TabManager::GetTabBrowser(int tabId) const {
+    auto it = tabs_.find(tabId);
+    return it == tabs_.end() ? nullptr : it->second.browser;
+}
+
+int TabManager::TabIdForBrowser(int browserId) const {
+    auto it = browserToTab_.find(browserId);
+    return it == browserToTab_.end() ? -1 : it->second;
+}
+
+std::vector<CefRefPtr<CefBrowser>> TabManager::GetBrowsers() const {
+    std::vector<CefRefPtr<CefBrowser>> browsers;
+    browsers.reserve(tabs_.size());
+    for (const auto& pair : tabs_) {
+        if (pair.second.browser) {
+            browsers.push_back(pair.second.browser);
+        }
+    }
+    return browsers;
+}
+
+std::vector<TabManager::TabSnapshot> TabManager::Snapshot() const {
+    std::vector<TabSnapshot> snapshot;
+    snapshot.reserve(tabs_.size());
+    std::lock_guard<std::mutex> lock(contextMutex_);
+    for (int id : order_) {
+        auto it = tabs_.find(id);
+        if (it == tabs_.end()) {
+            continue;
+        }
+        const Tab& tab = it->second;
+        TabSnapshot entry;
+        entry.id = id;
+        entry.active = id == activeTabId_;
+        entry.discarded = tab.discarded;
+        entry.lastActive = tab.lastActive;
+        entry.url = tab.discardedUrl;
+        if (tab.browser) {
+            entry.browserId = tab.browser->GetIdentifier();
+            auto context = contexts_.find(entry.browserId);
+            if (context != contexts_.end()) {
+                entry.url = context->second.url;
+                entry.domain = context->second.domain;
+                entry.walletInFlight = context->second.walletInFlight;
+            }
+        } else {
+            entry.domain = HostOf(tab.discardedUrl);
+        }
+        snapshot.push_back(entry);
+    }
+    return snapshot;
+}
+
+bool TabManager::GetWalletContext(int browserId, WalletContext& context) const {
+    std::lock_guard<std::mutex> lock(contextMutex_);
+    auto it = contexts_.find(browserId);
+    if (it == contexts_.end()) {
+        return false;
+    }
+    context = it->second;
+    return true;
+}
+
+void TabManager::BeginWalletRequest(int browserId) {
+    std::lock_guard<std::mutex> lock(contextMutex_);
+    auto it = contexts_.find(browserId);
+    if (it != contexts_.end()) {
+        it->second.walletRequests++;
+        it->second.walletInFlight++;
+    }
+}
+
+bool TabManager::BlockPrerenderWalletRequest(int browserId) {
+    std::lock_guard<std::mutex> lock(contextMutex_);
+    auto it = contexts_.find(browserId);
+    if (it == contexts_.end() || !it->second.prerender) {
+        return false;
+    }
+    it->second.prerenderWalletBlocked = true;
+    return true;
+}
+
+void TabManager::EndWalletRequest(int browserId) {
+    std::lock_guard<std::mutex> lock(contextMutex_);
+    auto it = contexts_.find(browserId);
+    if (it != contexts_.end() && it->second.walletInFlight > 0) {
+        it->second.walletInFlight--;
+    }
+}
+
+nlohmann::json TabManager::GetTabList() const {
+    nlohmann::json list = nlohmann::json::array();
+    for (const TabSnapshot& entry : Snapshot()) {
+        auto tab = tabs_.find(entry.id);
+        list.push_back({
+            {"id", entry.id},
+            {"url", entry.url},
+            {"title", tab->second.title},
+            {"domain", entry.domain},
+            {"active", entry.active},
+            {"discarded", entry.discarded}
+        });
+    }
+    return list;
+}
+
+void TabManager::BroadcastTabs() {
+    CefRefPtr<CefBrowser> header = SimpleHandler::GetHeaderBrowser();
+    if (!header || !header->GetMainFrame()) {
+        return;
+    }
+    CefRefPtr<CefProcessMessage> message = CefProcessMessage::Create("tabs_changed");
+    message->GetArgumentList()->SetString(0, GetTabList().dump());
+    header->GetMainFrame()->SendProcessMessage(PID_RENDERER, message);
+}
+
+void TabManager::RecordSwitch(long long micros) {
+    switches_++;
+    switchTotalMicros_ += micros;
+    switchMaxMicros_ = (std::max)(switchMaxMicros_, static_cast<uint64_t>(micros));
+    if (recentSwitchMicros_.size() < kRecentSwitchSamples) {
+        recentSwitchMicros_.push_back(micros);
+    } else {
+        recentSwitchMicros_[recentSwitchNext_] = micros;
+        recentSwitchNext_ = (recentSwitchNext_ + 1) % kRecentSwitchSamples;
+    }
+}
+
+nlohmann::json TabManager::GetStats() const {
+    PROCESS_MEMORY_COUNTERS_EX counters = {};
+    GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters));
+    uint64_t childBytes = ChildProcessPrivateBytes();
+
+    return {
+        {"open", tabs_.size()},
+        {"live", browserToTab_.size()},
+        {"opened", opened_},
+        {"closed", closed_},
+        {"activeTabId", activeTabId_},
+        {"switches", switches_},
+        {"avgSwitchMicros", switches_ ? switchTotalMicros_ / switches_ : 0},
+        {"p50SwitchMicros", Percentile(recentSwitchMicros_, 0.5)},
+        {"p95SwitchMicros", Percentile(recentSwitchMicros_, 0.95)},
+        {"maxSwitchMicros", switchMaxMicros_},
+        {"browserPrivateBytes", static_cast<uint64_t>(counters.PrivateUsage)},
+        {"childPrivateBytes", childBytes},
+        {"childBytesPerTab", browserToTab_.empty() ? 0 : childBytes / browserToTab_.size()},
+        {"benchmark", benchmarkResult_}
+    };
+}
+
+void TabManager::StartBenchmark(int tabCount, const std::string& url) {
+    CEF_REQUIRE_UI_THREAD();
+
+    if (benchmarkPending_ > 0 || benchmarkRunning_ || tabCount <= 0) {
+        LOG_WARNING_BROWSER("⚠️ Tab benchmark already running or invalid tab count");
+        return;
+    }
+    if (tabCount > kMaxBenchmarkTabs) {
+        LOG_WARNING_BROWSER("⚠️ Tab benchmark capped at " + std::to_string(kMaxBenchmarkTabs) + " tabs");
+        tabCount = kMaxBenchmarkTabs;
+    }
+
+    LOG_INFO_BROWSER("🗂️ Tab benchmark: opening " + std::to_string(tabCount) + " tabs of " + url);
+    benchmarkBaselineBytes_ = ChildProcessPrivateBytes();
+    benchmarkTabIds_.clear();
+    benchmarkPending_ = tabCount;
+
+    PendingTab pending;
+    pending.benchmark = true;
+    for (int i = 0; i < tabCount; i++) {
+        CreateTabBrowser(url, pending);
+    }
+}
+
+void TabManager::RunBenchmarkSwitches() {
+    const int kRounds = 3;
+
+    benchmarkRunning_ = true;
+    uint64_t loadedBytes = ChildProcessPrivateBytes();
+    int originalTab = activeTabId_;
+
+    std::vector<long long> samples;
+    std::vector<int> cycle = order_;
+    for (int round = 0; round < kRounds; round++) {
+        for (int id : cycle) {
+            auto tab = tabs_.find(id);
+            if (id == activeTabId_ || tab == tabs_.end() || tab->second.discarded) {
+                continue;
+            }
+            auto start = std::chrono::steady_clock::now();
+            ActivateTab(id);
+            samples.push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count());
+        }
+    }
+    ActivateTab(originalTab);
+
+    for (int id : benchmarkTabIds_) {
+        CloseTab(id);
+    }
+    benchmarkRunning_ = false;
+
+    long long total = 0;
+    for (long long sample : samples) {
+        total += sample;
+    }
+    size_t tabCount = benchmarkTabIds_.size();
+    uint64_t addedBytes = loadedBytes > benchmarkBaselineBytes_ ? loadedBytes - benchmarkBaselineBytes_ : 0;
+
+    benchmarkResult_ = {
+        {"tabs", tabCount},
+        {"tabsOpenDuringSwitching", cycle.size()},
+        {"switchSamples", samples.size()},
+        {"avgSwitchMicros", samples.empty() ? 0 : total / static_cast<long long>(samples.size())},
+        {"p50SwitchMicros", Percentile(samples, 0.5)},
+        {"p95SwitchMicros", Percentile(samples, 0.95)},
+        {"maxSwitchMicros", samples.empty() ? 0 : *std::max_element(samples.begin(), samples.end())},
+        {"childBytesAdded", addedBytes},
+        {"bytesPerTab", tabCount ? addedBytes / tabCount : 0}
+    };
+    benchmarkTabIds_.clear();
+
+    LOG_INFO_BROWSER("🗂️ Tab benchmark done: " + benchmarkResult_.dump());
+    BroadcastTabs();
+}
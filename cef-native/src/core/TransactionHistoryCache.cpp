@@ -0,0 +1,621 @@
+#include "../../include/core/TransactionHistoryCache.h"
+#include "../../include/core/ProfileCache.h"
+#include "../../include/core/WalletService.h"
+#include "../../include/core/WalletSubscriptions.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+#include "include/base/cef_bind.h"
+#include <windows.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+#define LOG_DEBUG_BROWSER(msg) Logger::Log(msg, 0, 2)
+#define LOG_INFO_BROWSER(msg) Logger::Log(msg, 1, 2)
+#define LOG_WARNING_BROWSER(msg) Logger::Log(msg, 2, 2)
+
+namespace fs = std::filesystem;
+
+namespace {
+    const char kLogMagic[8] = { 'B', 'B', 'T', 'X', 'H', 'C', '0', '1' };
+
+    enum RecordType : uint8_t {
+        kTransactionRecord = 1,
+        kRemovedRecord = 2,
+        // Written after a synced page's transactions, so a torn page is fetched again
+        kCursorRecord = 3
+    };
+
+#pragma pack(push, 1)
+    struct TransactionRecord {
+        uint8_t type;
+        uint8_t status;
+        uint8_t txidLength;
+        uint8_t recipientLength;
+        uint16_t memoLength;
+        uint32_t confirmations;
+        int64_t timestamp;
+        int64_t amount;
+        int64_t fee;
+    };
+
+    struct TextRecord {
+        uint8_t type;
+        uint8_t reserved;
+        uint16_t length;
+    };
+#pragma pack(pop)
+
+    using Transaction = TransactionHistoryIndex::Transaction;
+
+    // Transactions asked of the daemon per request, and requests per sync
+    const size_t kSyncPageSize = 1000;
+    const size_t kMaxSyncPages = 1000;
+
+    // A page request older than this since the last sync starts another one
+    const int64_t kSyncIntervalMs = 15000;
+
+    const size_t kDefaultPageSize = 50;
+    const size_t kMaxPageSize = 500;
+
+    // The log is rewritten once it holds this many more records than there are transactions
+    const uint64_t kCompactSlackRecords = 20000;
+
+    const size_t kRecentPageSamples = 256;
+
+    // File thread only
+    HANDLE g_historyLog = INVALID_HANDLE_VALUE;
+
+    int64_t NowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    long long SteadyMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void EncodeTransaction(const Transaction& transaction, std::string& out) {
+        TransactionRecord record = {
+            kTransactionRecord, transaction.status,
+            static_cast<uint8_t>(transaction.txid.size()), static_cast<uint8_t>(transaction.recipient.size()),
+            static_cast<uint16_t>(transaction.memo.size()), transaction.confirmations,
+            transaction.timestamp, transaction.amount, transaction.fee
+        };
+        out.append(reinterpret_cast<const char*>(&record), sizeof(record));
+        out.append(transaction.txid);
+        out.append(transaction.recipient);
+        out.append(transaction.memo);
+    }
+
+    void EncodeText(uint8_t type, const std::string& text, std::string& out) {
+        TextRecord record = { type, 0, static_cast<uint16_t>(text.size()) };
+        out.append(reinterpret_cast<const char*>(&record), sizeof(record));
+        out.append(text);
+    }
+
+    bool WriteAll(HANDLE file, const std::string& data) {
+        DWORD written = 0;
+        return WriteFile(file, data.data(), static_cast<DWORD>(data.size()), &written, nullptr) &&
+               written == data.size();
+    }
+
+    // Replays records from offset; returns the offset just past the last intact record. Runs of
+    // transactions are upserted together so a long log does not re-sort the index per record.
+    uint64_t ReplayLog(const char* data, uint64_t size, uint64_t offset, TransactionHistoryIndex& index,
+                       std::string& cursor, uint64_t& records) {
+        std::vector<Transaction> run;
+        auto flushRun = [&]() {
+            index.Upsert(run);
+            run.clear();
+        };
+
+        while (offset < size) {
+            uint8_t type = static_cast<uint8_t>(data[offset]);
+            if (type == kTransactionRecord) {
+                if (offset + sizeof(TransactionRecord) > size) {
+                    break;
+                }
+                TransactionRecord record;
+                std::memcpy(&record, data + offset, sizeof(record));
+                uint64_t length = sizeof(record) + record.txidLength + record.recipientLength + record.memoLength;
+                if (record.txidLength == 0 || offset + length > size) {
+                    break;
+                }
+                const char* text = data + offset + sizeof(record);
+                Transaction transaction;
+                transaction.txid.assign(text, record.txidLength);
+                transaction.recipient.assign(text + record.txidLength, record.recipientLength);
+                transaction.memo.assign(text + record.txidLength + record.recipientLength, record.memoLength);
+                transaction.status = record.status;
+                transaction.confirmations = record.confirmations;
+                transaction.timestamp = record.timestamp;
+                transaction.amount = record.amount;
+                transaction.fee = record.fee;
+                run.push_back(std::move(transaction));
+                offset += length;
+            } else if (type == kRemovedRecord || type == kCursorRecord) {
+                if (offset + sizeof(TextRecord) > size) {
+                    break;
+                }
+                TextRecord record;
+                std::memcpy(&record, data + offset, sizeof(record));
+                uint64_t length = sizeof(record) + record.length;
+                if (offset + length > size) {
+                    break;
+                }
+                std::string text(data + offset + sizeof(record), record.length);
+                if (type == kRemovedRecord) {
+                    flushRun();
+                    index.Remove({ text });
+                } else {
+                    cursor = text;
+                }
+                offset += length;
+            } else {
+                break;
+            }
+            records++;
+        }
+        flushRun();
+        return offset;
+    }
+
+    // File thread: swaps in a rewritten log; the handle is reopened on whichever file survives
+    void RewriteLog(const std::wstring& directory, const std::string& data) {
+        std::wstring path = (fs::path(directory) / L"txhistory.log").wstring();
+        std::wstring tempPath = path + L".tmp";
+        HANDLE temp = CreateFileW(tempPath.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (temp == INVALID_HANDLE_VALUE) {
+            return;
+        }
+        bool ok = WriteAll(temp, data) && FlushFileBuffers(temp);
+        CloseHandle(temp);
+        if (!ok) {
+            DeleteFileW(tempPath.c_str());
+            return;
+        }
+
+        if (g_historyLog != INVALID_HANDLE_VALUE) {
+            CloseHandle(g_historyLog);
+        }
+        if (!MoveFileExW(tempPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+            DeleteFileW(tempPath.c_str());
+        }
+        g_historyLog = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                   OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (g_historyLog != INVALID_HANDLE_VALUE) {
+            LARGE_INTEGER zero = {};
+            SetFilePointerEx(g_historyLog, zero, nullptr, FILE_END);
+        }
+    }
+
+    double PercentileMicros(std::vector<double> samples, double p) {
+        if (samples.empty()) {
+            return 0.0;
+        }
+        size_t index = static_cast<size_t>(p * (samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return samples[index];
+    }
+}
+
+TransactionHistoryCache& TransactionHistoryCache::GetInstance() {
+    static TransactionHistoryCache instance;
+    return instance;
+}
+
+void TransactionHistoryCache::Start() {
+    CEF_REQUIRE_UI_THREAD();
+    if (started_) {
+        return;
+    }
+    started_ = true;
+
+    const std::wstring& root = ProfileCache::GetInstance().GetRootPath();
+    if (root.empty()) {
+        index_.reset(new TransactionHistoryIndex());
+        load_.ok = true;
+        LOG_INFO_BROWSER("📜 No persistent profile; transaction history is cached for this session only");
+        return;
+    }
+
+    persistent_ = true;
+    directory_ = (fs::path(root) / L"Wallet").wstring();
+    CefPostTask(TID_FILE_BACKGROUND, base::BindOnce(&TransactionHistoryCache::LoadOnFileThread, directory_));
+}
+
+void TransactionHistoryCache::LoadOnFileThread(std::wstring directory) {
+    auto started = std::chrono::steady_clock::now();
+    TransactionHistoryIndex* index = new TransactionHistoryIndex();
+    LoadResult result;
+
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    std::wstring path = (fs::path(directory) / L"txhistory.log").wstring();
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                              OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER size = {};
+    if (file != INVALID_HANDLE_VALUE && GetFileSizeEx(file, &size)) {
+        uint64_t fileSize = static_cast<uint64_t>(size.QuadPart);
+        uint64_t validEnd = 0;
+
+        if (fileSize >= sizeof(kLogMagic)) {
+            HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            const char* view = mapping ? static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+            if (view && std::memcmp(view, kLogMagic, sizeof(kLogMagic)) == 0) {
+                validEnd = ReplayLog(view, fileSize, sizeof(kLogMagic), *index, result.cursor, result.logRecords);
+                result.evicted = index->EvictOldest(kMaxTransactions);
+            }
+            if (view) {
+                UnmapViewOfFile(view);
+            }
+            if (mapping) {
+                CloseHandle(mapping);
+            }
+        }
+
+        // Drops a page torn by a crash mid-write, or starts over on a foreign file
+        if (validEnd < fileSize) {
+            LARGE_INTEGER position;
+            position.QuadPart = static_cast<LONGLONG>(validEnd);
+            SetFilePointerEx(file, position, nullptr, FILE_BEGIN);
+            SetEndOfFile(file);
+            result.truncatedBytes = fileSize - validEnd;
+        }
+        if (validEnd == 0) {
+            WriteAll(file, std::string(kLogMagic, sizeof(kLogMagic)));
+            validEnd = sizeof(kLogMagic);
+        }
+        result.logBytes = validEnd;
+
+        LARGE_INTEGER zero = {};
+        SetFilePointerEx(file, zero, nullptr, FILE_END);
+        result.ok = true;
+    }
+
+    g_historyLog = file;
+    result.loadMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started).count();
+
+    CefPostTask(TID_UI, base::BindOnce([](TransactionHistoryIndex* loaded, LoadResult loadResult) {
+        TransactionHistoryCache::GetInstance().OnLoaded(loaded, loadResult);
+    }, index, result));
+}
+
+void TransactionHistoryCache::OnLoaded(TransactionHistoryIndex* index, const LoadResult& result) {
+    index_.reset(index);
+    load_ = result;
+    cursor_ = result.cursor;
+    logBytes_ = result.logBytes;
+    logRecords_ = result.logRecords;
+    if (result.evicted > 0) {
+        complete_ = false;
+        transactionsEvicted_ += result.evicted;
+    }
+    if (!result.ok) {
+        persistent_ = false;
+        LOG_WARNING_BROWSER("⚠️ Transaction history cache could not be opened; it will not survive a restart");
+    }
+
+    LOG_INFO_BROWSER("📜 Transaction history cache loaded: " + std::to_string(index_->Count()) +
+                     " transactions in " + std::to_string(result.loadMs) + " ms" +
+                     (result.truncatedBytes ? ", dropped " + std::to_string(result.truncatedBytes) + " torn bytes" : ""));
+
+    MaybeCompactLog();
+    WalletSubscriptions::GetInstance().Publish(WalletSubscriptions::kHistory, Summary());
+    if (syncAfterLoad_) {
+        syncAfterLoad_ = false;
+        MaybeSync(false);
+    }
+}
+
+void TransactionHistoryCache::Invalidate() {
+    CEF_REQUIRE_UI_THREAD();
+    stale_ = true;
+}
+
+void TransactionHistoryCache::Refresh() {
+    CEF_REQUIRE_UI_THREAD();
+    stale_ = true;
+    if (!index_) {
+        syncAfterLoad_ = true;
+    } else if (syncing_) {
+        // The running sync may have asked the daemon before the change being announced
+        syncAgain_ = true;
+    } else {
+        MaybeSync(true);
+    }
+}
+
+nlohmann::json TransactionHistoryCache::Summary() const {
+    return {
+        {"total", index_ ? index_->Count() : 0},
+        {"version", index_ ? index_->Version() : 0},
+        {"syncedAt", syncedAtMs_}
+    };
+}
+
+void TransactionHistoryCache::MaybeSync(bool force) {
+    if (syncing_) {
+        return;
+    }
+    if (!force && !stale_ && NowMs() - syncedAtMs_ < kSyncIntervalMs) {
+        return;
+    }
+
+    syncing_ = true;
+    syncStartedMs_ = SteadyMs();
+    // Off the log's file thread: a slow daemon must not hold up writes
+    CefPostTask(TID_FILE_USER_VISIBLE, base::BindOnce(&TransactionHistoryCache::SyncOnWorkerThread, cursor_));
+}
+
+void TransactionHistoryCache::SyncOnWorkerThread(std::string cursor) {
+    WalletService walletService;
+    walletService.setPriority(DaemonScheduler::kBackground);
+
+    for (size_t requests = 1; ; requests++) {
+        auto started = std::chrono::steady_clock::now();
+        nlohmann::json response = walletService.getTransactionHistory(cursor, kSyncPageSize);
+
+        SyncPage page;
+        page.fetchMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started).count();
+
+        const nlohmann::json* transactions = nullptr;
+        if (response.is_array()) {
+            transactions = &response;
+            page.listing = true;
+        } else if (response.is_object() && response.contains("transactions") && response["transactions"].is_array()) {
+            transactions = &response["transactions"];
+            // Without a cursor the object is just a wrapped full listing
+            auto next = response.find("cursor");
+            if (next == response.end() || next->is_null()) {
+                page.listing = true;
+            } else {
+                page.cursor = next->is_string() ? next->get<std::string>() : next->dump();
+                page.last = !response.value("more", false) || page.cursor == cursor || requests >= kMaxSyncPages;
+            }
+            auto removed = response.find("removed");
+            if (removed != response.end() && removed->is_array()) {
+                for (const auto& txid : *removed) {
+                    if (txid.is_string() && !txid.get_ref<const std::string&>().empty() &&
+                        txid.get_ref<const std::string&>().size() <= UINT8_MAX) {
+                        page.removed.push_back(txid.get<std::string>());
+                    }
+                }
+            }
+        } else if (response.is_object() && response.contains("error") && response["error"].is_string()) {
+            page.error = response["error"].get<std::string>();
+        } else {
+            page.error = "Wallet daemon unavailable";
+        }
+
+        if (transactions) {
+            page.transactions.reserve(transactions->size());
+            for (const auto& json : *transactions) {
+                Transaction transaction;
+                if (TransactionHistoryIndex::FromJson(json, transaction)) {
+                    page.transactions.push_back(std::move(transaction));
+                }
+            }
+        }
+
+        bool last = page.last || !page.error.empty();
+        cursor = page.cursor;
+        CefPostTask(TID_UI, base::BindOnce([](SyncPage synced) {
+            TransactionHistoryCache::GetInstance().OnSyncPage(synced);
+        }, std::move(page)));
+        if (last) {
+            return;
+        }
+    }
+}
+
+void TransactionHistoryCache::OnSyncPage(const SyncPage& page) {
+    if (!page.error.empty()) {
+        // Retried on the next page request after the usual interval, or at once on refresh
+        syncing_ = false;
+        stale_ = false;
+        syncedAtMs_ = NowMs();
+        syncError_ = page.error;
+        syncAgain_ = false;
+        LOG_WARNING_BROWSER("⚠️ Transaction history sync failed: " + page.error);
+        return;
+    }
+
+    std::vector<std::string> removed = page.removed;
+    if (page.listing) {
+        std::vector<std::string> missing = index_->MissingFrom(page.transactions);
+        removed.insert(removed.end(), missing.begin(), missing.end());
+    }
+
+    std::vector<size_t> changedAt;
+    size_t changed = index_->Upsert(page.transactions, &changedAt);
+    size_t removedCount = index_->Remove(removed);
+    size_t evicted = index_->EvictOldest(kMaxTransactions);
+    if (evicted > 0) {
+        complete_ = false;
+    }
+
+    syncPages_++;
+    transactionsReceived_ += page.transactions.size();
+    transactionsChanged_ += changed;
+    transactionsRemoved_ += removedCount;
+    transactionsEvicted_ += evicted;
+
+    if (persistent_) {
+        std::string records;
+        size_t recordCount = 0;
+        for (size_t i : changedAt) {
+            EncodeTransaction(page.transactions[i], records);
+            recordCount++;
+        }
+        for (const std::string& txid : removed) {
+            EncodeText(kRemovedRecord, txid, records);
+            recordCount++;
+        }
+        if (page.cursor != cursor_ && page.cursor.size() <= UINT16_MAX) {
+            EncodeText(kCursorRecord, page.cursor, records);
+            recordCount++;
+        }
+        if (!records.empty()) {
+            AppendToLog(std::move(records), recordCount);
+        }
+    }
+    if (page.cursor.size() <= UINT16_MAX) {
+        cursor_ = page.cursor;
+    }
+
+    if (!page.last) {
+        return;
+    }
+    syncing_ = false;
+    stale_ = false;
+    syncedAtMs_ = NowMs();
+    syncError_.clear();
+    syncs_++;
+    lastSyncMs_ = SteadyMs() - syncStartedMs_;
+    if (changed > 0 || removedCount > 0) {
+        LOG_DEBUG_BROWSER("📜 Transaction history synced: " + std::to_string(changed) + " changed, " +
+                          std::to_string(removedCount) + " removed, " + std::to_string(index_->Count()) +
+                          " cached in " + std::to_string(lastSyncMs_) + " ms");
+    }
+    MaybeCompactLog();
+    WalletSubscriptions::GetInstance().Publish(WalletSubscriptions::kHistory, Summary());
+    if (syncAgain_) {
+        syncAgain_ = false;
+        MaybeSync(true);
+    }
+}
+
+void TransactionHistoryCache::AppendToLog(std::string records, size_t recordCount) {
+    logBytes_ += records.size();
+    logRecords_ += recordCount;
+    // Same sequenced thread as the load, so pages land after the replayed log
+    CefPostTask(TID_FILE_BACKGROUND, base::BindOnce([](std::string data) {
+        if (g_historyLog != INVALID_HANDLE_VALUE) {
+            WriteAll(g_historyLog, data);
+        }
+    }, std::move(records)));
+}
+
+void TransactionHistoryCache::MaybeCompactLog() {
+    if (!persistent_ || !index_ || logRecords_ <= 2 * index_->Count() + kCompactSlackRecords) {
+        return;
+    }
+
+    std::string data(kLogMagic, sizeof(kLogMagic));
+    index_->ForEach([&data](const Transaction& transaction) { EncodeTransaction(transaction, data); });
+    uint64_t records = index_->Count();
+    if (!cursor_.empty()) {
+        EncodeText(kCursorRecord, cursor_, data);
+        records++;
+    }
+
+    LOG_DEBUG_BROWSER("📜 Rewriting transaction history log: " + std::to_string(logBytes_) + " -> " +
+                      std::to_string(data.size()) + " bytes");
+    logBytes_ = data.size();
+    logRecords_ = records;
+    compactions_++;
+    CefPostTask(TID_FILE_BACKGROUND, base::BindOnce([](std::wstring directory, std::string rewritten) {
+        RewriteLog(directory, rewritten);
+    }, directory_, std::move(data)));
+}
+
+nlohmann::json TransactionHistoryCache::Page(const nlohmann::json& request) {
+    CEF_REQUIRE_UI_THREAD();
+
+    size_t offset = 0;
+    size_t limit = kDefaultPageSize;
+    bool refresh = false;
+    TransactionHistoryIndex::Filter filter;
+    if (request.is_object()) {
+        offset = request.value("offset", offset);
+        limit = (std::min)(request.value("limit", limit), kMaxPageSize);
+        refresh = request.value("refresh", false);
+        filter.text = request.value("text", "");
+        std::string status = request.value("status", "");
+        if (status == "pending") {
+            filter.status = TransactionHistoryIndex::kPending;
+        } else if (status == "confirmed") {
+            filter.status = TransactionHistoryIndex::kConfirmed;
+        } else if (status == "failed") {
+            filter.status = TransactionHistoryIndex::kFailed;
+        }
+    }
+
+    if (!index_) {
+        syncAfterLoad_ = true;
+        return {
+            {"total", 0},
+            {"offset", offset},
+            {"items", nlohmann::json::array()},
+            {"loading", true},
+            {"syncing", true}
+        };
+    }
+    MaybeSync(refresh);
+
+    auto start = std::chrono::steady_clock::now();
+    nlohmann::json result = index_->Page(offset, limit, filter);
+    double micros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    pages_++;
+    pageMaxMicros_ = (std::max)(pageMaxMicros_, micros);
+    if (recentPageMicros_.size() < kRecentPageSamples) {
+        recentPageMicros_.push_back(micros);
+    } else {
+        recentPageMicros_[recentPageNext_] = micros;
+        recentPageNext_ = (recentPageNext_ + 1) % kRecentPageSamples;
+    }
+
+    result["version"] = index_->Version();
+    result["syncing"] = syncing_;
+    result["complete"] = complete_;
+    result["syncedAt"] = syncedAtMs_;
+    if (!syncError_.empty()) {
+        result["error"] = syncError_;
+    }
+    return result;
+}
+
+nlohmann::json TransactionHistoryCache::GetStats() const {
+    return {
+        {"loaded", index_ != nullptr},
+        {"persistent", persistent_},
+        {"directory", fs::path(directory_).u8string()},
+        {"transactions", index_ ? index_->Count() : 0},
+        {"indexBytes", index_ ? index_->MemoryBytes() : 0},
+        {"complete", complete_},
+        {"cursor", cursor_},
+        {"logBytes", logBytes_},
+        {"logRecords", logRecords_},
+        {"compactions", compactions_},
+        {"loadMs", load_.loadMs},
+        {"truncatedBytes", load_.truncatedBytes},
+        {"syncing", syncing_},
+        {"syncs", syncs_},
+        {"syncPages", syncPages_},
+        {"lastSyncMs", lastSyncMs_},
+        {"syncedAt", syncedAtMs_},
+        {"syncError", syncError_},
+        {"received", transactionsReceived_},
+        {"changed", transactionsChanged_},
+        {"removed", transactionsRemoved_},
+        {"evicted", transactionsEvicted_},
+        {"pages", pages_},
+        {"p50PageMicros", PercentileMicros(recentPageMicros_, 0.5)},
+        {"p95PageMicros", PercentileMicros(recentPageMicros_, 0.95)},
+        {"maxPageMicros", pageMaxMicros_}
+    };
+}
@@ -0,0 +1,500 @@
+#include "../../include/core/TransactionHistoryIndex.h"
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+    const size_t kMaxTxidBytes = 255;
+    const size_t kMaxRecipientBytes = 255;
+    const size_t kMaxMemoBytes = 1024;
+
+    // Superseded text and removed rows are reclaimed once they outweigh what is still live
+    const size_t kRepackMinDeadSlots = 4096;
+    const size_t kRepackMinDeadTextBytes = 1 << 20;
+
+    const size_t kFilterViews = 4;
+
+    // Batches up to this size are inserted row by row; larger ones are merged in one pass
+    const size_t kSmallBatch = 64;
+
+    int64_t Int64Of(const nlohmann::json& json, const char* key) {
+        auto it = json.find(key);
+        if (it == json.end()) {
+            return 0;
+        }
+        if (it->is_number_integer()) {
+            return it->get<int64_t>();
+        }
+        if (it->is_number_float()) {
+            return static_cast<int64_t>(it->get<double>());
+        }
+        return 0;
+    }
+
+    std::string StringOf(const nlohmann::json& json, const char* key, size_t maxBytes) {
+        auto it = json.find(key);
+        if (it == json.end() || !it->is_string()) {
+            return "";
+        }
+        std::string value = it->get<std::string>();
+        if (value.size() > maxBytes) {
+            // Cut before a UTF-8 continuation byte so the text stays valid
+            size_t end = maxBytes;
+            while (end > 0 && (static_cast<unsigned char>(value[end]) & 0xC0) == 0x80) {
+                end--;
+            }
+            value.resize(end);
+        }
+        return value;
+    }
+
+    // ASCII-only lowercase table; the search runs over every cached row on a new filter
+    struct LowerTable {
+        unsigned char map[256];
+        LowerTable() {
+            for (int c = 0; c < 256; c++) {
+                map[c] = static_cast<unsigned char>(c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c);
+            }
+        }
+    };
+    const LowerTable kLower;
+
+    bool ContainsIgnoreCase(const char* text, size_t length, const std::string& lowerNeedle) {
+        size_t needleLength = lowerNeedle.size();
+        if (needleLength > length) {
+            return false;
+        }
+        const unsigned char* haystack = reinterpret_cast<const unsigned char*>(text);
+        const unsigned char* needle = reinterpret_cast<const unsigned char*>(lowerNeedle.data());
+        for (size_t i = 0; i + needleLength <= length; i++) {
+            if (kLower.map[haystack[i]] != needle[0]) {
+                continue;
+            }
+            size_t j = 1;
+            while (j < needleLength && kLower.map[haystack[i + j]] == needle[j]) {
+                j++;
+            }
+            if (j == needleLength) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Adds slots to a list sorted by less
+    template <typename Less>
+    void InsertSorted(std::vector<uint32_t>& list, std::vector<uint32_t> slots, Less less) {
+        if (slots.size() <= kSmallBatch) {
+            for (uint32_t slot : slots) {
+                list.insert(std::upper_bound(list.begin(), list.end(), slot, less), slot);
+            }
+            return;
+        }
+        std::sort(slots.begin(), slots.end(), less);
+        std::vector<uint32_t> merged;
+        merged.reserve(list.size() + slots.size());
+        std::merge(list.begin(), list.end(), slots.begin(), slots.end(), std::back_inserter(merged), less);
+        list.swap(merged);
+    }
+
+    // Removes the given slots, which must be sorted, from a slot list
+    void EraseSlots(std::vector<uint32_t>& list, const std::vector<uint32_t>& sortedSlots) {
+        if (sortedSlots.empty()) {
+            return;
+        }
+        list.erase(std::remove_if(list.begin(), list.end(), [&](uint32_t slot) {
+            return std::binary_search(sortedSlots.begin(), sortedSlots.end(), slot);
+        }), list.end());
+    }
+}
+
+bool TransactionHistoryIndex::FromJson(const nlohmann::json& json, Transaction& transaction) {
+    if (!json.is_object()) {
+        return false;
+    }
+    auto txid = json.find("txid");
+    if (txid == json.end() || !txid->is_string() || txid->get_ref<const std::string&>().empty() ||
+        txid->get_ref<const std::string&>().size() > kMaxTxidBytes) {
+        return false;
+    }
+
+    transaction.txid = txid->get<std::string>();
+    transaction.recipient = StringOf(json, "recipient", kMaxRecipientBytes);
+    transaction.memo = StringOf(json, "memo", kMaxMemoBytes);
+    transaction.timestamp = Int64Of(json, "timestamp");
+    transaction.amount = Int64Of(json, "amount");
+    transaction.fee = Int64Of(json, "fee");
+    transaction.confirmations = static_cast<uint32_t>((std::max)(Int64Of(json, "confirmations"), static_cast<int64_t>(0)));
+
+    std::string status = StringOf(json, "status", 32);
+    if (status == "confirmed") {
+        transaction.status = kConfirmed;
+    } else if (status == "failed") {
+        transaction.status = kFailed;
+    } else {
+        transaction.status = transaction.confirmations > 0 ? kConfirmed : kPending;
+    }
+    return true;
+}
+
+nlohmann::json TransactionHistoryIndex::ToJson(const Transaction& transaction) {
+    nlohmann::json json = {
+        {"txid", transaction.txid},
+        {"status", StatusName(transaction.status)},
+        {"amount", transaction.amount},
+        {"recipient", transaction.recipient},
+        {"timestamp", transaction.timestamp},
+        {"confirmations", transaction.confirmations},
+        {"fee", transaction.fee}
+    };
+    if (!transaction.memo.empty()) {
+        json["memo"] = transaction.memo;
+    }
+    return json;
+}
+
+const char* TransactionHistoryIndex::StatusName(uint8_t status) {
+    switch (status) {
+        case kConfirmed: return "confirmed";
+        case kFailed: return "failed";
+        default: return "pending";
+    }
+}
+
+std::string TransactionHistoryIndex::TxidOf(const Entry& entry) const {
+    return text_.substr(entry.textOffset, entry.txidLength);
+}
+
+TransactionHistoryIndex::Transaction TransactionHistoryIndex::Expand(const Entry& entry) const {
+    Transaction transaction;
+    transaction.txid = text_.substr(entry.textOffset, entry.txidLength);
+    transaction.recipient = text_.substr(entry.textOffset + entry.txidLength, entry.recipientLength);
+    transaction.memo = text_.substr(entry.textOffset + entry.txidLength + entry.recipientLength, entry.memoLength);
+    transaction.timestamp = entry.timestamp;
+    transaction.amount = entry.amount;
+    transaction.fee = entry.fee;
+    transaction.confirmations = entry.confirmations;
+    transaction.status = entry.status;
+    return transaction;
+}
+
+void TransactionHistoryIndex::StoreText(Entry& entry, const Transaction& transaction) {
+    entry.textOffset = static_cast<uint32_t>(text_.size());
+    entry.txidLength = static_cast<uint8_t>((std::min)(transaction.txid.size(), kMaxTxidBytes));
+    entry.recipientLength = static_cast<uint8_t>((std::min)(transaction.recipient.size(), kMaxRecipientBytes));
+    entry.memoLength = static_cast<uint16_t>((std::min)(transaction.memo.size(), kMaxMemoBytes));
+    text_.append(transaction.txid, 0, entry.txidLength);
+    text_.append(transaction.recipient, 0, entry.recipientLength);
+    text_.append(transaction.memo, 0, entry.memoLength);
+}
+
+bool TransactionHistoryIndex::SameAs(const Entry& entry, const Transaction& transaction) const {
+    if (entry.timestamp != transaction.timestamp || entry.amount != transaction.amount ||
+        entry.fee != transaction.fee || entry.confirmations != transaction.confirmations ||
+        entry.status != transaction.status ||
+        entry.recipientLength != transaction.recipient.size() || entry.memoLength != transaction.memo.size()) {
+        return false;
+    }
+    size_t offset = entry.textOffset + entry.txidLength;
+    return text_.compare(offset, entry.recipientLength, transaction.recipient) == 0 &&
+           text_.compare(offset + entry.recipientLength, entry.memoLength, transaction.memo) == 0;
+}
+
+bool TransactionHistoryIndex::Matches(const Entry& entry, const Filter& filter) const {
+    if (filter.status >= 0 && entry.status != filter.status) {
+        return false;
+    }
+    if (filter.text.empty()) {
+        return true;
+    }
+    // txid, recipient and memo are adjacent, but a match must not straddle two of them
+    const char* text = text_.data() + entry.textOffset;
+    return ContainsIgnoreCase(text, entry.txidLength, filter.text) ||
+           ContainsIgnoreCase(text + entry.txidLength, entry.recipientLength, filter.text) ||
+           ContainsIgnoreCase(text + entry.txidLength + entry.recipientLength, entry.memoLength, filter.text);
+}
+
+int64_t TransactionHistoryIndex::Find(const std::string& txid) const {
+    auto it = std::lower_bound(byTxid_.begin(), byTxid_.end(), txid, [this](uint32_t slot, const std::string& value) {
+        const Entry& entry = entries_[slot];
+        return text_.compare(entry.textOffset, entry.txidLength, value) < 0;
+    });
+    if (it == byTxid_.end()) {
+        return -1;
+    }
+    const Entry& entry = entries_[*it];
+    return text_.compare(entry.textOffset, entry.txidLength, txid) == 0 ? static_cast<int64_t>(*it) : -1;
+}
+
+bool TransactionHistoryIndex::TxidLess(uint32_t a, uint32_t b) const {
+    const Entry& left = entries_[a];
+    const Entry& right = entries_[b];
+    return text_.compare(left.textOffset, left.txidLength, text_, right.textOffset, right.txidLength) < 0;
+}
+
+bool TransactionHistoryIndex::OrderLess(uint32_t a, uint32_t b) const {
+    if (entries_[a].timestamp != entries_[b].timestamp) {
+        return entries_[a].timestamp > entries_[b].timestamp;
+    }
+    return TxidLess(a, b);
+}
+
+size_t TransactionHistoryIndex::Upsert(const std::vector<Transaction>& batch, std::vector<size_t>* changedAt) {
+    std::vector<uint32_t> added;
+    std::vector<uint32_t> moved;
+    std::unordered_set<uint32_t> movedSlots;
+    std::unordered_map<std::string, uint32_t> addedByTxid;
+    size_t changed = 0;
+
+    for (size_t i = 0; i < batch.size(); i++) {
+        const Transaction& transaction = batch[i];
+        if (transaction.txid.empty() || transaction.txid.size() > kMaxTxidBytes) {
+            continue;
+        }
+
+        int64_t found = Find(transaction.txid);
+        bool addedHere = false;
+        if (found < 0) {
+            auto it = addedByTxid.find(transaction.txid);
+            if (it != addedByTxid.end()) {
+                found = it->second;
+                addedHere = true;
+            }
+        }
+
+        if (found < 0) {
+            Entry entry;
+            entry.timestamp = transaction.timestamp;
+            entry.amount = transaction.amount;
+            entry.fee = transaction.fee;
+            entry.confirmations = transaction.confirmations;
+            entry.status = transaction.status;
+            entry.live = true;
+            StoreText(entry, transaction);
+            uint32_t slot = static_cast<uint32_t>(entries_.size());
+            entries_.push_back(entry);
+            added.push_back(slot);
+            addedByTxid.emplace(transaction.txid, slot);
+            if (changedAt) {
+                changedAt->push_back(i);
+            }
+            changed++;
+            continue;
+        }
+
+        Entry& entry = entries_[static_cast<size_t>(found)];
+        if (SameAs(entry, transaction)) {
+            continue;
+        }
+        uint32_t slot = static_cast<uint32_t>(found);
+        if (entry.timestamp != transaction.timestamp && !addedHere && movedSlots.insert(slot).second) {
+            // A small batch unlinks the row while its old position can still be searched for
+            if (batch.size() <= kSmallBatch) {
+                order_.erase(std::lower_bound(order_.begin(), order_.end(), slot, [this](uint32_t a, uint32_t b) {
+                    return OrderLess(a, b);
+                }));
+            }
+            moved.push_back(slot);
+        }
+        entry.timestamp = transaction.timestamp;
+        entry.amount = transaction.amount;
+        entry.fee = transaction.fee;
+        entry.confirmations = transaction.confirmations;
+        entry.status = transaction.status;
+        deadTextBytes_ += entry.txidLength + entry.recipientLength + entry.memoLength;
+        StoreText(entry, transaction);
+        if (changedAt) {
+            changedAt->push_back(i);
+        }
+        changed++;
+    }
+
+    if (changed == 0) {
+        return 0;
+    }
+
+    InsertSorted(byTxid_, added, [this](uint32_t a, uint32_t b) { return TxidLess(a, b); });
+
+    // Moved rows leave the order first; new and moved rows are then placed together
+    if (batch.size() > kSmallBatch) {
+        std::vector<uint32_t> sorted = moved;
+        std::sort(sorted.begin(), sorted.end());
+        EraseSlots(order_, sorted);
+    }
+    moved.insert(moved.end(), added.begin(), added.end());
+    InsertSorted(order_, std::move(moved), [this](uint32_t a, uint32_t b) { return OrderLess(a, b); });
+
+    version_++;
+    MaybeRepack();
+    return changed;
+}
+
+size_t TransactionHistoryIndex::Remove(const std::vector<std::string>& txids) {
+    std::vector<uint32_t> removed;
+    for (const std::string& txid : txids) {
+        int64_t found = Find(txid);
+        if (found < 0 || !entries_[static_cast<size_t>(found)].live) {
+            continue;
+        }
+        Entry& entry = entries_[static_cast<size_t>(found)];
+        entry.live = false;
+        deadTextBytes_ += entry.txidLength + entry.recipientLength + entry.memoLength;
+        deadSlots_++;
+        removed.push_back(static_cast<uint32_t>(found));
+    }
+    if (removed.empty()) {
+        return 0;
+    }
+
+    std::sort(removed.begin(), removed.end());
+    removed.erase(std::unique(removed.begin(), removed.end()), removed.end());
+    EraseSlots(order_, removed);
+    EraseSlots(byTxid_, removed);
+    version_++;
+    MaybeRepack();
+    return removed.size();
+}
+
+std::vector<std::string> TransactionHistoryIndex::MissingFrom(const std::vector<Transaction>& listing) const {
+    std::unordered_set<std::string> present;
+    present.reserve(listing.size());
+    for (const Transaction& transaction : listing) {
+        present.insert(transaction.txid);
+    }
+
+    std::vector<std::string> missing;
+    for (uint32_t slot : byTxid_) {
+        std::string txid = TxidOf(entries_[slot]);
+        if (present.find(txid) == present.end()) {
+            missing.push_back(std::move(txid));
+        }
+    }
+    return missing;
+}
+
+size_t TransactionHistoryIndex::EvictOldest(size_t maxCount) {
+    if (order_.size() <= maxCount) {
+        return 0;
+    }
+
+    std::vector<uint32_t> evicted(order_.begin() + maxCount, order_.end());
+    order_.resize(maxCount);
+    for (uint32_t slot : evicted) {
+        Entry& entry = entries_[slot];
+        entry.live = false;
+        deadTextBytes_ += entry.txidLength + entry.recipientLength + entry.memoLength;
+    }
+    deadSlots_ += evicted.size();
+
+    std::sort(evicted.begin(), evicted.end());
+    EraseSlots(byTxid_, evicted);
+    version_++;
+    MaybeRepack();
+    return evicted.size();
+}
+
+void TransactionHistoryIndex::MaybeRepack() {
+    bool slotsWasted = deadSlots_ >= kRepackMinDeadSlots && deadSlots_ > order_.size();
+    bool textWasted = deadTextBytes_ >= kRepackMinDeadTextBytes && deadTextBytes_ * 2 > text_.size();
+    if (!slotsWasted && !textWasted) {
+        return;
+    }
+
+    // Live rows are rewritten in display order, so the new slot of a row is its position
+    std::vector<Entry> entries;
+    entries.reserve(order_.size());
+    std::string text;
+    text.reserve(text_.size() - (std::min)(deadTextBytes_, text_.size()));
+    for (uint32_t slot : order_) {
+        Entry entry = entries_[slot];
+        size_t length = entry.txidLength + entry.recipientLength + entry.memoLength;
+        uint32_t offset = static_cast<uint32_t>(text.size());
+        text.append(text_, entry.textOffset, length);
+        entry.textOffset = offset;
+        entries.push_back(entry);
+    }
+    entries_.swap(entries);
+    text_.swap(text);
+
+    for (uint32_t i = 0; i < order_.size(); i++) {
+        order_[i] = i;
+    }
+    byTxid_ = order_;
+    std::sort(byTxid_.begin(), byTxid_.end(), [this](uint32_t a, uint32_t b) { return TxidLess(a, b); });
+
+    deadTextBytes_ = 0;
+    deadSlots_ = 0;
+    filterViews_.clear();
+}
+
+const std::vector<uint32_t>& TransactionHistoryIndex::ViewFor(const Filter& filter) {
+    Filter lowered = filter;
+    for (char& c : lowered.text) {
+        c = static_cast<char>(kLower.map[static_cast<unsigned char>(c)]);
+    }
+
+    FilterView* view = nullptr;
+    for (FilterView& candidate : filterViews_) {
+        if (candidate.status == lowered.status && candidate.text == lowered.text) {
+            view = &candidate;
+            break;
+        }
+    }
+    if (!view) {
+        if (filterViews_.size() < kFilterViews) {
+            filterViews_.emplace_back();
+            view = &filterViews_.back();
+        } else {
+            view = &*std::min_element(filterViews_.begin(), filterViews_.end(), [](const FilterView& a, const FilterView& b) {
+                return a.lastUsed < b.lastUsed;
+            });
+        }
+        view->status = lowered.status;
+        view->text = lowered.text;
+        view->version = version_ - 1;
+    }
+
+    if (view->version != version_) {
+        view->matches.clear();
+        for (uint32_t slot : order_) {
+            if (Matches(entries_[slot], lowered)) {
+                view->matches.push_back(slot);
+            }
+        }
+        view->version = version_;
+    }
+    view->lastUsed = ++filterUses_;
+    return view->matches;
+}
+
+nlohmann::json TransactionHistoryIndex::Page(size_t offset, size_t limit, const Filter& filter) {
+    const std::vector<uint32_t>& rows = filter.Empty() ? order_ : ViewFor(filter);
+
+    nlohmann::json items = nlohmann::json::array();
+    offset = (std::min)(offset, rows.size());
+    size_t end = offset + (std::min)(limit, rows.size() - offset);
+    for (size_t i = offset; i < end; i++) {
+        items.push_back(ToJson(Expand(entries_[rows[i]])));
+    }
+    return {
+        {"total", rows.size()},
+        {"offset", offset},
+        {"items", items}
+    };
+}
+
+void TransactionHistoryIndex::ForEach(const std::function<void(const Transaction&)>& visit) const {
+    for (uint32_t slot : order_) {
+        visit(Expand(entries_[slot]));
+    }
+}
+
+size_t TransactionHistoryIndex::MemoryBytes() const {
+    size_t bytes = entries_.capacity() * sizeof(Entry) + text_.capacity() +
+                   (order_.capacity() + byTxid_.capacity()) * sizeof(uint32_t);
+    for (const FilterView& view : filterViews_) {
+        bytes += view.matches.capacity() * sizeof(uint32_t) + view.text.capacity();
+    }
+    return bytes;
+}
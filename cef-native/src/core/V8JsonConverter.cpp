@@ -0,0 +1,180 @@
+#include "../../include/core/V8JsonConverter.h"
+#include "../../include/core/Encoding.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+    // Frees the heap copy backing an ArrayBuffer created from a JSON binary value
+    class ArrayBufferReleaser : public CefV8ArrayBufferReleaseCallback {
+    public:
+        void ReleaseBuffer(void* buffer) override { std::free(buffer); }
+
+    private:
+        IMPLEMENT_REFCOUNTING(ArrayBufferReleaser);
+    };
+
+    // Integral doubles inside this range round-trip exactly through int64
+    const double kMaxSafeInteger = 9007199254740991.0;
+
+    void checkDepth(int depth, int maxDepth) {
+        if (depth > maxDepth) {
+            throw std::runtime_error("V8/JSON conversion exceeded maximum nesting depth of " + std::to_string(maxDepth));
+        }
+    }
+
+    CefRefPtr<CefV8Value> toV8Impl(const nlohmann::json& j, int depth, int maxDepth) {
+        checkDepth(depth, maxDepth);
+
+        switch (j.type()) {
+            case nlohmann::json::value_t::null:
+            case nlohmann::json::value_t::discarded:
+                return CefV8Value::CreateNull();
+
+            case nlohmann::json::value_t::boolean:
+                return CefV8Value::CreateBool(j.get<bool>());
+
+            case nlohmann::json::value_t::number_integer: {
+                int64_t v = j.get<int64_t>();
+                if (v >= std::numeric_limits<int32_t>::min() && v <= std::numeric_limits<int32_t>::max()) {
+                    return CefV8Value::CreateInt(static_cast<int32_t>(v));
+                }
+                return CefV8Value::CreateDouble(static_cast<double>(v));
+            }
+
+            case nlohmann::json::value_t::number_unsigned: {
+                uint64_t v = j.get<uint64_t>();
+                if (v <= std::numeric_limits<int32_t>::max()) {
+                    return CefV8Value::CreateInt(static_cast<int32_t>(v));
+                }
+                if (v <= std::numeric_limits<uint32_t>::max()) {
+                    return CefV8Value::CreateUInt(static_cast<uint32_t>(v));
+                }
+                return CefV8Value::CreateDouble(static_cast<double>(v));
+            }
+
+            case nlohmann::json::value_t::number_float:
+                return CefV8Value::CreateDouble(j.get<double>());
+
+            case nlohmann::json::value_t::string:
+                return CefV8Value::CreateString(j.get_ref<const std::string&>());
+
+            case nlohmann::json::value_t::binary: {
+                const auto& bytes = j.get_binary();
+                void* buffer = std::malloc(bytes.empty() ? 1 : bytes.size());
+                if (!buffer) {
+                    throw std::runtime_error("Failed to allocate ArrayBuffer");
+                }
+                if (!bytes.empty()) {
+                    std::memcpy(buffer, bytes.data(), bytes.size());
+                }
+                return CefV8Value::CreateArrayBuffer(buffer, bytes.size(), new ArrayBufferReleaser());
+            }
+
+            case nlohmann::json::value_t::array: {
+                CefRefPtr<CefV8Value> arr = CefV8Value::CreateArray(static_cast<int>(j.size()));
+                int index = 0;
+                for (const auto& item : j) {
+                    arr->SetValue(index++, toV8Impl(item, depth + 1, maxDepth));
+                }
+                return arr;
+            }
+
+            case nlohmann::json::value_t::object: {
+                CefRefPtr<CefV8Value> obj = CefV8Value::CreateObject(nullptr, nullptr);
+                for (auto it = j.begin(); it != j.end(); ++it) {
+                    obj->SetValue(it.key(), toV8Impl(it.value(), depth + 1, maxDepth), V8_PROPERTY_ATTRIBUTE_NONE);
+                }
+                return obj;
+            }
+        }
+        return CefV8Value::CreateNull();
+    }
+
+    nlohmann::json fromV8Impl(CefRefPtr<CefV8Value> value, V8Json::BinaryMode binaryMode, int depth, int maxDepth) {
+        checkDepth(depth, maxDepth);
+
+        if (!value || value->IsNull() || value->IsUndefined()) {
+            return nullptr;
+        }
+        if (value->IsBool()) {
+            return value->GetBoolValue();
+        }
+        if (value->IsInt()) {
+            return value->GetIntValue();
+        }
+        if (value->IsUInt()) {
+            return value->GetUIntValue();
+        }
+        if (value->IsDouble()) {
+            double d = value->GetDoubleValue();
+            if (!std::isfinite(d)) {
+                return nullptr;  // JSON has no NaN/Infinity
+            }
+            // Satoshi amounts arrive as doubles once they exceed int32; keep them integral
+            if (std::trunc(d) == d && std::fabs(d) <= kMaxSafeInteger) {
+                return static_cast<int64_t>(d);
+            }
+            return d;
+        }
+        if (value->IsString()) {
+            return value->GetStringValue().ToString();
+        }
+        if (value->IsArrayBuffer()) {
+            const uint8_t* data = static_cast<const uint8_t*>(value->GetArrayBufferData());
+            size_t length = value->GetArrayBufferByteLength();
+            if (binaryMode == V8Json::BinaryMode::Binary) {
+                std::vector<uint8_t> bytes;
+                if (data && length > 0) {
+                    bytes.assign(data, data + length);
+                }
+                return nlohmann::json::binary(std::move(bytes));
+            }
+            return data ? Encoding::base64Encode(data, length) : std::string();
+        }
+        if (value->IsArray()) {
+            nlohmann::json arr = nlohmann::json::array();
+            const int length = value->GetArrayLength();
+            arr.get_ref<nlohmann::json::array_t&>().reserve(static_cast<size_t>(length));
+            for (int i = 0; i < length; ++i) {
+                arr.push_back(fromV8Impl(value->GetValue(i), binaryMode, depth + 1, maxDepth));
+            }
+            return arr;
+        }
+        if (value->IsFunction()) {
+            return nullptr;
+        }
+        if (value->IsObject()) {
+            nlohmann::json obj = nlohmann::json::object();
+            std::vector<CefString> keys;
+            value->GetKeys(keys);
+            for (const auto& key : keys) {
+                CefRefPtr<CefV8Value> child = value->GetValue(key);
+                // Match JSON.stringify: methods and undefined members are dropped
+                if (!child || child->IsFunction() || child->IsUndefined()) {
+                    continue;
+                }
+                obj.emplace(key.ToString(), fromV8Impl(child, binaryMode, depth + 1, maxDepth));
+            }
+            return obj;
+        }
+        return nullptr;
+    }
+}
+
+namespace V8Json {
+
+CefRefPtr<CefV8Value> toV8(const nlohmann::json& value, int maxDepth) {
+    return toV8Impl(value, 0, maxDepth);
+}
+
+nlohmann::json fromV8(CefRefPtr<CefV8Value> value, BinaryMode binaryMode, int maxDepth) {
+    return fromV8Impl(value, binaryMode, 0, maxDepth);
+}
+
+} // namespace V8Json
@@ -1,4 +1,7 @@
 #include "../../include/core/WalletService.h"
+#include "../../include/core/Encoding.h"
+#include "../../include/core/DaemonResilience.h"
+#include <cctype>
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -174,9 +177,75 @@ void WalletService::setBaseUrl(const std::string& url) {
 }
 
 nlohmann::json WalletService::makeHttpRequest(const std::string& method, const std::string& endpoint, const std::string& body) {
+    DaemonScheduler::Slot slot(priority_, site_);
+    if (!slot.Admitted()) {
+        std::cerr << "❌ Wallet daemon request shed (" << DaemonScheduler::VerdictName(slot.verdict()) << "): "
+                  << method << " " << endpoint << std::endl;
+        return nlohmann::json::object();
+    }
+
+    // Reads go over the local socket with hedging when it is up; everything else tries the socket
+    // first and WinHTTP over localhost otherwise. Either way the breaker fails calls fast while the
+    // daemon is down, and the call gives up at its route's deadline.
+    DaemonRoutePolicy policy = DaemonRoutePolicy::For(method, endpoint);
+    DaemonCircuitBreaker& breaker = DaemonCircuitBreaker::GetInstance();
+    std::string responseBody;
+    int status = 0;
+    DaemonCircuitBreaker::Outcome outcome = DaemonCircuitBreaker::Outcome::Failed;
+    bool hedged = policy.idempotent && DaemonTransport::GetInstance().SocketAvailable();
+    if (hedged) {
+        // The first attempt reuses the kept-alive connection; a hedge may outlive this call, so it
+        // owns its connection and a copy of the request
+        outcome = breaker.CallHedged(policy, [&](uint32_t timeoutMs, int& attemptStatus, std::string& attemptBody) {
+            return socket_.Request(method, endpoint, body, attemptStatus, attemptBody, timeoutMs) ==
+                   DaemonSocket::Result::Ok;
+        }, [this]() { socket_.CancelRequest(); }, [method, endpoint, body]() -> DaemonCircuitBreaker::Attempt {
+            auto socket = std::make_shared<DaemonSocket>();
+            return [socket, method, endpoint, body](uint32_t timeoutMs, int& attemptStatus, std::string& attemptBody) {
+                return socket->Request(method, endpoint, body, attemptStatus, attemptBody, timeoutMs) ==
+                       DaemonSocket::Result::Ok;
+            };
+        }, status, responseBody);
+    }
+    // The socket went away under the hedged read; WinHTTP may still reach the daemon
+    if (!hedged || (outcome == DaemonCircuitBreaker::Outcome::Failed && !DaemonTransport::GetInstance().SocketAvailable())) {
+        outcome = breaker.Call(policy, [&](uint32_t timeoutMs, int& attemptStatus, std::string& attemptBody) {
+            switch (socket_.Request(method, endpoint, body, attemptStatus, attemptBody, timeoutMs)) {
+                case DaemonSocket::Result::Ok:
+                    return true;
+                case DaemonSocket::Result::Failed:
+                    // The daemon may already have acted on it, so only reads are sent again over TCP
+                    if (method != "GET") {
+                        std::cerr << "❌ Wallet daemon request over local socket failed: " << method << " " << endpoint << std::endl;
+                        return false;
+                    }
+                    // fall through
+                case DaemonSocket::Result::Unavailable:
+                    return makeTcpRequest(method, endpoint, body, attemptBody, timeoutMs);
+            }
+            return false;
+        }, status, responseBody);
+    }
+    if (outcome != DaemonCircuitBreaker::Outcome::Answered) {
+        std::cerr << "❌ Wallet daemon request " << DaemonCircuitBreaker::OutcomeName(outcome) << ": "
+                  << method << " " << endpoint << std::endl;
+        return nlohmann::json::object();
+    }
+
+    // Parse JSON response
+    try {
+        return nlohmann::json::parse(responseBody);
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Failed to parse JSON response: " << e.what() << std::endl;
+        std::cerr << "Response body: " << responseBody << std::endl;
+        return nlohmann::json::object();
+    }
+}
+
+bool WalletService::makeTcpRequest(const std::string& method, const std::string& endpoint, const std::string& body, std::string& responseBody, uint32_t timeoutMs) {
     if (!connected_) {
         std::cerr << "❌ Not connected to Go daemon" << std::endl;
-        return nlohmann::json::object();
+        return false;
     }
 
     // Convert endpoint to wide string
@@ -193,9 +262,13 @@ nlohmann::json WalletService::makeHttpRequest(const std::string& method, const s
 
     if (!hRequest) {
         std::cerr << "❌ Failed to create HTTP request. Error: " << GetLastError() << std::endl;
-        return nlohmann::json::object();
+        return false;
     }
 
+    // Resolving and connecting to localhost is immediate; the rest waits at most timeoutMs
+    int timeout = static_cast<int>(timeoutMs);
+    WinHttpSetTimeouts(hRequest, 0, timeout, timeout, timeout);
+
     // Set headers
     std::string contentType = "application/json";
     std::wstring wideContentType(contentType.begin(), contentType.end());
@@ -216,28 +289,21 @@ nlohmann::json WalletService::makeHttpRequest(const std::string& method, const s
     if (!result) {
         std::cerr << "❌ Failed to send HTTP request. Error: " << GetLastError() << std::endl;
         WinHttpCloseHandle(hRequest);
-        return nlohmann::json::object();
+        return false;
     }
 
     // Receive response
     if (!WinHttpReceiveResponse(hRequest, nullptr)) {
         std::cerr << "❌ Failed to receive HTTP response. Error: " << GetLastError() << std::endl;
         WinHttpCloseHandle(hRequest);
-        return nlohmann::json::object();
+        return false;
     }
 
     // Read response body
-    std::string responseBody = readResponse(hRequest);
+    responseBody = readResponse(hRequest);
     WinHttpCloseHandle(hRequest);
-
-    // Parse JSON response
-    try {
-        return nlohmann::json::parse(responseBody);
-    } catch (const std::exception& e) {
-        std::cerr << "❌ Failed to parse JSON response: " << e.what() << std::endl;
-        std::cerr << "Response body: " << responseBody << std::endl;
-        return nlohmann::json::object();
-    }
+    DaemonTransport::GetInstance().RecordTcpRequest();
+    return true;
 }
 
 std::string WalletService::readResponse(HINTERNET hRequest) {
@@ -504,6 +570,13 @@ nlohmann::json WalletService::signTransaction(const nlohmann::json& transactionD
     debugLog << "📋 Transaction data: " << transactionData.dump() << std::endl;
     debugLog.close();
 
+    // Reject malformed raw transactions before they cross the daemon boundary
+    if (transactionData.contains("rawTx") && transactionData["rawTx"].is_string() &&
+        !Encoding::isValidHex(transactionData["rawTx"].get<std::string>())) {
+        std::cerr << "❌ rawTx is not valid hex" << std::endl;
+        return nlohmann::json{{"error", "rawTx is not valid hex"}};
+    }
+
     auto response = makeHttpRequest("POST", "/transaction/sign", transactionData.dump());
 
     if (response.contains("txid")) {
@@ -531,6 +604,12 @@ nlohmann::json WalletService::broadcastTransaction(const nlohmann::json& transac
     debugLog << "📋 Transaction data: " << transactionData.dump() << std::endl;
     debugLog.close();
 
+    if (transactionData.contains("signedTx") && transactionData["signedTx"].is_string() &&
+        !Encoding::isValidHex(transactionData["signedTx"].get<std::string>())) {
+        std::cerr << "❌ signedTx is not valid hex" << std::endl;
+        return nlohmann::json{{"error", "signedTx is not valid hex"}};
+    }
+
     auto response = makeHttpRequest("POST", "/transaction/broadcast", transactionData.dump());
 
     if (response.contains("txid")) {
@@ -589,13 +668,41 @@ nlohmann::json WalletService::getBalance(const nlohmann::json& balanceData) {
     }
 }
 
-nlohmann::json WalletService::getTransactionHistory() {
+// Percent-encodes everything outside the unreserved set, for cursors the daemon hands out
+static std::string QueryEscape(const std::string& value) {
+    static const char kHex[] = "0123456789ABCDEF";
+    std::string escaped;
+    for (unsigned char c : value) {
+        if (std::isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+            escaped += static_cast<char>(c);
+        } else {
+            escaped += '%';
+            escaped += kHex[c >> 4];
+            escaped += kHex[c & 0x0F];
+        }
+    }
+    return escaped;
+}
+
+nlohmann::json WalletService::getTransactionHistory(const std::string& since, size_t limit) {
     std::cout << "📜 Getting transaction history from Go daemon..." << std::endl;
     std::ofstream debugLog("debug_output.log", std::ios::app);
     debugLog << "📜 Getting transaction history from Go daemon..." << std::endl;
     debugLog.close();
 
-    auto response = makeHttpRequest("GET", "/transaction/history");
+    std::string endpoint = "/transaction/history";
+    std::string query;
+    if (!since.empty()) {
+        query += "since=" + QueryEscape(since);
+    }
+    if (limit > 0) {
+        query += (query.empty() ? "" : "&") + std::string("limit=") + std::to_string(limit);
+    }
+    if (!query.empty()) {
+        endpoint += "?" + query;
+    }
+
+    auto response = makeHttpRequest("GET", endpoint);
 
     if (response.is_array() || response.contains("transactions")) {
         std::cout << "✅ Transaction history retrieved successfully" << std::endl;
@@ -612,6 +719,81 @@ nlohmann::json WalletService::getTransactionHistory() {
     }
 }
 
+bool WalletService::streamEvents(const std::function<void()>& onOpen,
+                                 const std::function<bool(const nlohmann::json&)>& onEvent) {
+    // Cuts the body into newline-delimited events, however the reads happen to split it
+    std::string pending;
+    auto onData = [&pending, &onEvent](const char* data, size_t size) {
+        pending.append(data, size);
+
+        bool keepReading = true;
+        size_t start = 0;
+        for (size_t end = pending.find('\n'); end != std::string::npos; end = pending.find('\n', start)) {
+            nlohmann::json event = nlohmann::json::parse(pending.begin() + start, pending.begin() + end, nullptr, false);
+            start = end + 1;
+            if (!event.is_discarded() && !onEvent(event)) {
+                keepReading = false;
+                break;
+            }
+        }
+        pending.erase(0, start);
+        return keepReading;
+    };
+
+    int socketStatus = socket_.Stream("/wallet/events", onOpen, onData);
+    if (socketStatus != 0) {
+        return socketStatus == 200;
+    }
+
+    if (!connected_) {
+        return false;
+    }
+
+    HINTERNET hRequest = WinHttpOpenRequest(hConnect_, L"GET", L"/wallet/events", nullptr,
+                                            WINHTTP_NO_REFERER, WINHTTP_DEFAULT_ACCEPT_TYPES, 0);
+    if (!hRequest) {
+        return false;
+    }
+
+    // The daemon sends a heartbeat every 15 s, so three missed ones mean the stream is dead
+    WinHttpSetTimeouts(hRequest, 0, 5000, 5000, 45000);
+    eventStream_ = hRequest;
+
+    DWORD statusCode = 0;
+    DWORD statusSize = sizeof(statusCode);
+    bool opened = WinHttpSendRequest(hRequest, WINHTTP_NO_ADDITIONAL_HEADERS, 0, WINHTTP_NO_REQUEST_DATA, 0, 0, 0) &&
+                  WinHttpReceiveResponse(hRequest, nullptr) &&
+                  WinHttpQueryHeaders(hRequest, WINHTTP_QUERY_STATUS_CODE | WINHTTP_QUERY_FLAG_NUMBER,
+                                      WINHTTP_HEADER_NAME_BY_INDEX, &statusCode, &statusSize, WINHTTP_NO_HEADER_INDEX) &&
+                  statusCode == 200;
+
+    if (opened) {
+        onOpen();
+
+        std::vector<char> buffer(4096);
+        DWORD read = 0;
+        while (WinHttpReadData(hRequest, buffer.data(), static_cast<DWORD>(buffer.size()), &read) && read > 0 &&
+               onData(buffer.data(), read)) {
+        }
+    }
+
+    // cancelEventStream() may already have closed it
+    if (eventStream_.exchange(nullptr) == hRequest) {
+        WinHttpCloseHandle(hRequest);
+    }
+    return opened;
+}
+
+void WalletService::cancelEventStream() {
+    socket_.Cancel();
+
+    // Closing the handle is how a blocked synchronous WinHttpReadData is cancelled
+    HINTERNET hRequest = eventStream_.exchange(nullptr);
+    if (hRequest) {
+        WinHttpCloseHandle(hRequest);
+    }
+}
+
 // Daemon Process Management Methods
 
 bool WalletService::startDaemon() {
@@ -0,0 +1,302 @@
+#include "../../include/core/WalletSubscriptions.h"
+#include "../../include/core/TransactionHistoryCache.h"
+#include "../../include/core/BRC100SessionCache.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+#include "include/base/cef_bind.h"
+#include <algorithm>
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+#define LOG_DEBUG_BROWSER(msg) Logger::Log(msg, 0, 2)
+#define LOG_INFO_BROWSER(msg) Logger::Log(msg, 1, 2)
+#define LOG_WARNING_BROWSER(msg) Logger::Log(msg, 2, 2)
+
+namespace {
+    const char* const kTopicNames[WalletSubscriptions::kTopicCount] = { "balance", "addresses", "history", "messages" };
+
+    // Refetch interval for subscribed topics while there is no event stream
+    const int64_t kPollIntervalMs = 30000;
+}
+
+const char* WalletSubscriptions::TopicName(Topic topic) {
+    return topic < kTopicCount ? kTopicNames[topic] : "unknown";
+}
+
+int WalletSubscriptions::TopicFromName(const std::string& name) {
+    for (int topic = 0; topic < kTopicCount; topic++) {
+        if (name == kTopicNames[topic]) {
+            return topic;
+        }
+    }
+    return -1;
+}
+
+uint32_t WalletSubscriptions::TopicMask(const nlohmann::json& request) {
+    uint32_t mask = 0;
+    if (!request.is_object() || !request.contains("topics") || !request["topics"].is_array()) {
+        return mask;
+    }
+    for (const auto& name : request["topics"]) {
+        int topic = name.is_string() ? TopicFromName(name.get<std::string>()) : -1;
+        if (topic >= 0) {
+            mask |= 1u << topic;
+        }
+    }
+    return mask;
+}
+
+void WalletSubscriptions::SetTopics(int browserId, Subscriber& subscriber, uint32_t topics) {
+    for (int topic = 0; topic < kTopicCount; topic++) {
+        bool had = (subscriber.topics >> topic) & 1;
+        bool has = (topics >> topic) & 1;
+        if (has && !had) {
+            topics_[topic].subscribers++;
+        } else if (had && !has && --topics_[topic].subscribers == 0 && !streamConnected_) {
+            // Polling stops with the last subscriber, so changes from here on go unseen
+            topics_[topic].stale = true;
+        }
+    }
+    subscriber.topics = topics;
+    if (topics == 0) {
+        subscribers_.erase(browserId);
+    }
+}
+
+nlohmann::json WalletSubscriptions::Subscribe(CefRefPtr<CefBrowser> browser, const nlohmann::json& request) {
+    CEF_REQUIRE_UI_THREAD();
+
+    nlohmann::json states = nlohmann::json::object();
+    uint32_t mask = TopicMask(request);
+    if (!browser || mask == 0) {
+        return {{"states", states}};
+    }
+
+    int browserId = browser->GetIdentifier();
+    Subscriber& subscriber = subscribers_[browserId];
+    subscriber.browser = browser;
+    SetTopics(browserId, subscriber, subscriber.topics | mask);
+
+    for (int topic = 0; topic < kTopicCount; topic++) {
+        if (!((mask >> topic) & 1)) {
+            continue;
+        }
+        TopicState& state = topics_[topic];
+        if (state.known) {
+            states[kTopicNames[topic]] = {{"version", state.version}, {"state", state.state}};
+        }
+        if (!state.known || state.stale) {
+            Fetch(static_cast<Topic>(topic));
+        }
+    }
+
+    LOG_DEBUG_BROWSER("📡 Browser " + std::to_string(browserId) + " subscribed to " +
+                      std::to_string(states.size()) + " known of " + request.value("topics", nlohmann::json::array()).dump());
+    return {{"states", states}};
+}
+
+void WalletSubscriptions::Unsubscribe(int browserId, const nlohmann::json& request) {
+    CEF_REQUIRE_UI_THREAD();
+
+    auto it = subscribers_.find(browserId);
+    if (it == subscribers_.end()) {
+        return;
+    }
+    uint32_t mask = request.is_object() && request.contains("topics") ? TopicMask(request) : ~0u;
+    SetTopics(browserId, it->second, it->second.topics & ~mask);
+}
+
+void WalletSubscriptions::Publish(Topic topic, const nlohmann::json& state) {
+    CEF_REQUIRE_UI_THREAD();
+    if (topic >= kTopicCount) {
+        return;
+    }
+
+    TopicState& topicState = topics_[topic];
+    topicState.stale = false;
+    if (topicState.known && topicState.state == state) {
+        topicState.unchanged++;
+        return;
+    }
+    topicState.state = state;
+    topicState.known = true;
+    topicState.version++;
+
+    if (topicState.subscribers == 0) {
+        return;
+    }
+
+    CefRefPtr<CefProcessMessage> update = CefProcessMessage::Create("wallet_state");
+    update->GetArgumentList()->SetString(0, nlohmann::json{
+        {"topic", kTopicNames[topic]},
+        {"version", topicState.version},
+        {"state", state}
+    }.dump());
+
+    for (const auto& entry : subscribers_) {
+        const Subscriber& subscriber = entry.second;
+        if (((subscriber.topics >> topic) & 1) && subscriber.browser && subscriber.browser->GetMainFrame()) {
+            // SendProcessMessage consumes the message, so every browser gets its own copy
+            subscriber.browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, update->Copy());
+            topicState.pushes++;
+        }
+    }
+}
+
+void WalletSubscriptions::Fetch(Topic topic) {
+    TopicState& state = topics_[topic];
+    switch (topic) {
+        case kHistory:
+            // The cache syncs incrementally and publishes its summary when the sync is done
+            state.fetches++;
+            TransactionHistoryCache::GetInstance().Refresh();
+            return;
+        case kMessages:
+            // Only the daemon's events carry the message count
+            return;
+        default:
+            break;
+    }
+
+    if (state.fetching) {
+        state.fetchAgain = true;
+        return;
+    }
+    state.fetching = true;
+    state.fetches++;
+    CefPostTask(TID_FILE_USER_VISIBLE, base::BindOnce(&WalletSubscriptions::FetchOnWorkerThread, topic));
+}
+
+void WalletSubscriptions::OnFetched(Topic topic, const nlohmann::json& state) {
+    TopicState& topicState = topics_[topic];
+    topicState.fetching = false;
+
+    if (state.contains("error")) {
+        // Stale, so the next subscriber or reconnect tries again
+        topicState.stale = true;
+        LOG_WARNING_BROWSER(std::string("⚠️ Wallet subscription fetch failed for ") + kTopicNames[topic] + ": " +
+                            state["error"].dump());
+    } else {
+        Publish(topic, state);
+    }
+
+    if (topicState.fetchAgain) {
+        topicState.fetchAgain = false;
+        Fetch(topic);
+    }
+}
+
+void WalletSubscriptions::OnEvent(const nlohmann::json& event) {
+    // Session changes feed the session table rather than any subscriber
+    if (event.value("topic", "") == "sessions") {
+        BRC100SessionCache::GetInstance().OnEvent(event.value("data", nlohmann::json::object()));
+        return;
+    }
+
+    int topic = TopicFromName(event.value("topic", ""));
+    if (topic < 0) {
+        // Heartbeats, and topics this browser does not know yet
+        return;
+    }
+
+    TopicState& state = topics_[topic];
+    state.events++;
+
+    auto data = event.find("data");
+    if (data != event.end() && !data->is_null()) {
+        Publish(static_cast<Topic>(topic), topic == kAddresses && data->is_array()
+                                               ? nlohmann::json{{"addresses", *data}}
+                                               : *data);
+        return;
+    }
+
+    if (topic == kHistory) {
+        TransactionHistoryCache::GetInstance().Invalidate();
+    }
+    if (state.subscribers > 0) {
+        Fetch(static_cast<Topic>(topic));
+    } else {
+        state.stale = true;
+    }
+}
+
+void WalletSubscriptions::OnStreamState(bool connected, bool supported) {
+    bool wasSupported = streamSupported_;
+    streamSupported_ = supported;
+    if (connected == streamConnected_) {
+        if (!connected && wasSupported && !supported) {
+            LOG_INFO_BROWSER("📡 Wallet event stream unavailable; polling subscribed topics");
+        }
+        return;
+    }
+    streamConnected_ = connected;
+
+    if (!connected) {
+        LOG_INFO_BROWSER("📡 Wallet event stream lost; polling subscribed topics until it is back");
+        BRC100SessionCache::GetInstance().OnStreamLost();
+        return;
+    }
+
+    // Changes made while the stream was down went unannounced
+    streamConnects_++;
+    LOG_INFO_BROWSER("📡 Wallet event stream connected");
+    BRC100SessionCache::GetInstance().OnStreamConnected();
+    for (int topic = 0; topic < kTopicCount; topic++) {
+        topics_[topic].stale = true;
+        if (topics_[topic].subscribers > 0) {
+            Fetch(static_cast<Topic>(topic));
+        }
+    }
+}
+
+void WalletSubscriptions::SchedulePoll() {
+    CefPostDelayedTask(TID_UI, base::BindOnce([]() {
+        WalletSubscriptions::GetInstance().Poll();
+    }), kPollIntervalMs);
+}
+
+void WalletSubscriptions::Poll() {
+    if (!running_) {
+        return;
+    }
+    if (!streamConnected_ && !subscribers_.empty()) {
+        polls_++;
+        for (int topic = 0; topic < kTopicCount; topic++) {
+            if (topics_[topic].subscribers > 0) {
+                Fetch(static_cast<Topic>(topic));
+            }
+        }
+    }
+    SchedulePoll();
+}
+
+nlohmann::json WalletSubscriptions::GetStats() const {
+    nlohmann::json topics = nlohmann::json::object();
+    for (int topic = 0; topic < kTopicCount; topic++) {
+        const TopicState& state = topics_[topic];
+        topics[kTopicNames[topic]] = {
+            {"subscribers", state.subscribers},
+            {"known", state.known},
+            {"stale", state.stale},
+            {"version", state.version},
+            {"events", state.events},
+            {"fetches", state.fetches},
+            {"pushes", state.pushes},
+            {"unchanged", state.unchanged}
+        };
+    }
+
+    return {
+        {"browsers", subscribers_.size()},
+        {"streamConnected", streamConnected_},
+        {"streamSupported", streamSupported_},
+        {"streamConnects", streamConnects_},
+        {"polls", polls_},
+        {"topics", topics}
+    };
+}
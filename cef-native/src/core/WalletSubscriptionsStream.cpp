@@ -0,0 +1,125 @@
+// The parts of WalletSubscriptions that talk to the daemon: the thread holding the event stream
+// open and the worker-thread fetches of the balance and addresses. Everything else is in
+// WalletSubscriptions.cpp, which the unit tests build against fake_cef.
+
+#include "../../include/core/WalletSubscriptions.h"
+#include "../../include/core/WalletService.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/wrapper/cef_helpers.h"
+#include "include/base/cef_bind.h"
+#include <algorithm>
+#include <chrono>
+
+// Forward declaration of Logger class from main shell
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+#define LOG_DEBUG_BROWSER(msg) Logger::Log(msg, 0, 2)
+#define LOG_INFO_BROWSER(msg) Logger::Log(msg, 1, 2)
+#define LOG_WARNING_BROWSER(msg) Logger::Log(msg, 2, 2)
+
+namespace {
+    // Reconnect delay after the stream drops, doubling up to the cap while the daemon stays away
+    const uint32_t kReconnectMinMs = 1000;
+    const uint32_t kReconnectMaxMs = 30000;
+}
+
+WalletSubscriptions& WalletSubscriptions::GetInstance() {
+    static WalletSubscriptions instance;
+    return instance;
+}
+
+WalletSubscriptions::~WalletSubscriptions() {
+    Stop();
+}
+
+void WalletSubscriptions::Start() {
+    CEF_REQUIRE_UI_THREAD();
+    if (started_) {
+        return;
+    }
+    started_ = true;
+    running_ = true;
+
+    streamService_ = std::make_shared<WalletService>();
+    worker_ = std::thread(&WalletSubscriptions::StreamLoop, this);
+    SchedulePoll();
+    LOG_INFO_BROWSER("📡 Wallet subscriptions started");
+}
+
+void WalletSubscriptions::Stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    {
+        // Taken after running_ changed, so the stream thread either sees it or is already waiting
+        std::lock_guard<std::mutex> lock(stopMutex_);
+    }
+    stopped_.notify_all();
+    streamService_->cancelEventStream();
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    streamService_.reset();
+    LOG_INFO_BROWSER("📡 Wallet subscriptions stopped");
+}
+
+void WalletSubscriptions::StreamLoop() {
+    uint32_t delayMs = kReconnectMinMs;
+
+    while (running_) {
+        bool opened = streamService_->streamEvents(
+            [this]() {
+                if (!running_) {
+                    streamService_->cancelEventStream();
+                    return;
+                }
+                CefPostTask(TID_UI, base::BindOnce([]() {
+                    WalletSubscriptions::GetInstance().OnStreamState(true, true);
+                }));
+            },
+            [this](const nlohmann::json& event) {
+                CefPostTask(TID_UI, base::BindOnce([](nlohmann::json received) {
+                    WalletSubscriptions::GetInstance().OnEvent(received);
+                }, event));
+                return running_.load();
+            });
+
+        if (!running_) {
+            break;
+        }
+
+        CefPostTask(TID_UI, base::BindOnce([](bool supported) {
+            WalletSubscriptions::GetInstance().OnStreamState(false, supported);
+        }, opened));
+
+        // A stream that ran for a while reconnects promptly; a daemon that keeps refusing backs off
+        delayMs = opened ? kReconnectMinMs : (std::min)(delayMs * 2, kReconnectMaxMs);
+        std::unique_lock<std::mutex> lock(stopMutex_);
+        if (stopped_.wait_for(lock, std::chrono::milliseconds(delayMs), [this]() { return !running_; })) {
+            break;
+        }
+    }
+}
+
+void WalletSubscriptions::FetchOnWorkerThread(Topic topic) {
+    WalletService walletService;
+    walletService.setPriority(DaemonScheduler::kBackground);
+    nlohmann::json state;
+
+    if (!walletService.isConnected()) {
+        state = {{"error", "Wallet daemon unavailable"}};
+    } else if (topic == kBalance) {
+        state = walletService.getBalance(nlohmann::json::object());
+    } else if (topic == kAddresses) {
+        state = {{"addresses", walletService.getAllAddresses()}};
+    }
+
+    CefPostTask(TID_UI, base::BindOnce([](Topic fetched, nlohmann::json result) {
+        WalletSubscriptions::GetInstance().OnFetched(fetched, result);
+    }, topic, std::move(state)));
+}
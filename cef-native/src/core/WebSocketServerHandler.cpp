@@ -1,4 +1,5 @@
 #include "../../include/core/WebSocketServerHandler.h"
+#include "../../include/core/StartupOrchestrator.h"
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -50,6 +51,7 @@ void WebSocketServerHandler::OnServerCreated(CefRefPtr<CefServer> server) {
     LOG_DEBUG_BROWSER("🌐 WebSocket Server created successfully");
     LOG_DEBUG_BROWSER("🌐 Server address: " + server->GetAddress().ToString());
     server_running_ = true;
+    StartupOrchestrator::GetInstance().EndPhase("websocket_server");
 }
 
 void WebSocketServerHandler::OnServerDestroyed(CefRefPtr<CefServer> server) {
@@ -1,6 +1,7 @@
 #define _WIN32_WINNT 0x0601
 
 #include "../../include/handlers/my_overlay_render_handler.h"
+#include "../../include/core/OverlayPool.h"
 #include <windows.h>
 #include <dwmapi.h>
 #include <iostream>
@@ -127,6 +128,11 @@ void MyOverlayRenderHandler::OnPaint(CefRefPtr<CefBrowser> browser,
 
     ReleaseDC(NULL, screenDC);
 
+    // Closes the show-to-first-paint measurement for pooled overlays
+    if (result) {
+        OverlayPool::GetInstance().OnOverlayPainted(hwnd_);
+    }
+
     DWORD err = GetLastError();
     std::cout << "→ UpdateLayeredWindow result: " << (result ? "success" : "fail")
             << ", error: " << err << std::endl;
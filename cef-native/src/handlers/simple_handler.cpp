@@ -6,13 +6,35 @@
 #include "include/cef_v8.h"
 #include "include/wrapper/cef_closure_task.h"
 #include "include/cef_task.h"
+#include "include/cef_command_line.h"
 #include "base/cef_callback.h"
 #include "base/internal/cef_callback_internal.h"
 #include <fstream>
 #include <filesystem>
 #include <cstdlib>
+#include <algorithm>
 #include "../../include/core/WalletService.h"
 #include "../../include/core/HttpRequestInterceptor.h"
+#include "../../include/core/IdentityCache.h"
+#include "../../include/core/BRC100SessionCache.h"
+#include "../../include/core/OverlayPool.h"
+#include "../../include/core/BrowserReadiness.h"
+#include "../../include/core/FrontendBundle.h"
+#include "../../include/core/ProfileCache.h"
+#include "../../include/core/StartupOrchestrator.h"
+#include "../../include/core/TabManager.h"
+#include "../../include/core/TabLifecycle.h"
+#include "../../include/core/OcclusionTracker.h"
+#include "../../include/core/NavigationPredictor.h"
+#include "../../include/core/HistoryStore.h"
+#include "../../include/core/StateStore.h"
+#include "../../include/core/ActivityJournal.h"
+#include "../../include/core/TransactionHistoryCache.h"
+#include "../../include/core/WalletSubscriptions.h"
+#include "../../include/core/DaemonTransport.h"
+#include "../../include/core/DaemonChannel.h"
+#include "../../include/core/DaemonScheduler.h"
+#include "../../include/core/DaemonResilience.h"
 #include <windows.h>
 #include <iostream>
 #include <string>
@@ -36,23 +58,27 @@ extern void CreateTestOverlayWithSeparateProcess(HINSTANCE hInstance);
 extern void CreateWalletOverlayWithSeparateProcess(HINSTANCE hInstance);
 extern void CreateBackupOverlayWithSeparateProcess(HINSTANCE hInstance);
 
-// Global backup modal state management
-static bool g_backupModalShown = false;
+// Backup modal state, kept in the state store
+static const char* kBackupModalShownKey = "backup/modalShown";
 
 // Helper functions for backup modal state
 bool getBackupModalShown() {
-    return g_backupModalShown;
+    std::string value;
+    return StateStore::GetInstance().Get(kBackupModalShownKey, value) && value == "1";
 }
 
 void setBackupModalShown(bool shown) {
-    g_backupModalShown = shown;
+    StateStore::GetInstance().Put(kBackupModalShownKey, shown ? "1" : "0", false);
     LOG_DEBUG_BROWSER("💾 Backup modal state set to: " + std::to_string(shown));
 }
 
 std::string SimpleHandler::pending_panel_;
 bool SimpleHandler::needs_overlay_reload_ = false;
 
-SimpleHandler::SimpleHandler(const std::string& role) : role_(role) {}
+SimpleHandler::SimpleHandler(const std::string& role)
+    : role_(role), router_("browser:" + role, 2) {
+    RegisterMessageRoutes();
+}
 
 CefRefPtr<CefLifeSpanHandler> SimpleHandler::GetLifeSpanHandler() {
     return this;
@@ -66,13 +92,69 @@ CefRefPtr<CefLoadHandler> SimpleHandler::GetLoadHandler() {
     return this;
 }
 
-CefRefPtr<CefBrowser> SimpleHandler::webview_browser_ = nullptr;
 CefRefPtr<CefBrowser> SimpleHandler::header_browser_ = nullptr;
 CefRefPtr<CefBrowser> SimpleHandler::overlay_browser_ = nullptr;
 CefRefPtr<CefBrowser> SimpleHandler::settings_browser_ = nullptr;
 CefRefPtr<CefBrowser> SimpleHandler::wallet_browser_ = nullptr;
 CefRefPtr<CefBrowser> SimpleHandler::backup_browser_ = nullptr;
 CefRefPtr<CefBrowser> SimpleHandler::brc100_auth_browser_ = nullptr;
+int SimpleHandler::current_rpc_request_id_ = 0;
+bool SimpleHandler::rpc_response_sent_ = false;
+void SimpleHandler::SendRendererResponse(CefRefPtr<CefBrowser> browser, CefRefPtr<CefProcessMessage> response) {
+    if (!browser || !browser->GetMainFrame()) {
+        return;
+    }
+
+    if (current_rpc_request_id_ == 0) {
+        browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, response);
+        return;
+    }
+
+    // Echo the request id so the renderer resolves exactly the matching call
+    CefRefPtr<CefProcessMessage> envelope = CefProcessMessage::Create("rpc_response");
+    CefRefPtr<CefListValue> args = envelope->GetArgumentList();
+    args->SetInt(0, current_rpc_request_id_);
+    args->SetString(1, response->GetName());
+    args->SetList(2, response->GetArgumentList()->Copy());
+    browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, envelope);
+    rpc_response_sent_ = true;
+}
+
+bool SimpleHandler::BenchmarksAllowed(const std::string& route) const {
+    static const bool enabled = CefCommandLine::GetGlobalCommandLine()->HasSwitch("enable-benchmarks");
+    if (enabled && role_ != "webview") {
+        return true;
+    }
+    LOG_WARNING_BROWSER("⚠️ " + route + " refused for role " + role_ + (enabled ? "" : " (needs --enable-benchmarks)"));
+    return false;
+}
+
+bool SimpleHandler::ShellRoleAllowed(const std::string& route) const {
+    if (role_ != "webview") {
+        return true;
+    }
+    LOG_WARNING_BROWSER("⚠️ " + route + " refused for role " + role_);
+    return false;
+}
+
+void SimpleHandler::ScheduleWalletCalls(WalletService& walletService, CefRefPtr<CefBrowser> browser) const {
+    if (role_ != "webview") {
+        walletService.setPriority(DaemonScheduler::kUi);
+        return;
+    }
+    // A page's calls queue behind the shell's and take turns with other sites; a tab whose domain
+    // is not known yet still gets a site of its own rather than sharing one
+    TabManager::WalletContext tab;
+    std::string site;
+    if (browser && TabManager::GetInstance().GetWalletContext(browser->GetIdentifier(), tab)) {
+        site = tab.domain;
+    }
+    if (site.empty()) {
+        site = "tab:" + std::to_string(browser ? browser->GetIdentifier() : 0);
+    }
+    walletService.setPriority(DaemonScheduler::kDapp, site);
+}
+
 CefRefPtr<CefBrowser> SimpleHandler::GetOverlayBrowser() {
     return overlay_browser_;
 }
@@ -81,7 +163,7 @@ CefRefPtr<CefBrowser> SimpleHandler::GetHeaderBrowser() {
 }
 
 CefRefPtr<CefBrowser> SimpleHandler::GetWebviewBrowser() {
-    return webview_browser_;
+    return TabManager::GetInstance().GetActiveBrowser();
 }
 
 CefRefPtr<CefBrowser> SimpleHandler::GetSettingsBrowser() {
@@ -98,12 +180,24 @@ CefRefPtr<CefBrowser> SimpleHandler::GetBRC100AuthBrowser() {
     return brc100_auth_browser_;
 }
 
+void SimpleHandler::ReleaseOverlayBrowser(const std::string& role, CefRefPtr<CefBrowser> browser) {
+    CefRefPtr<CefBrowser>* slot = nullptr;
+    if (role == "settings") slot = &settings_browser_;
+    else if (role == "wallet") slot = &wallet_browser_;
+    else if (role == "backup") slot = &backup_browser_;
+    else if (role == "brc100auth") slot = &brc100_auth_browser_;
+
+    if (slot && *slot && (*slot)->IsSame(browser)) {
+        *slot = nullptr;
+    }
+}
+
 void SimpleHandler::TriggerDeferredPanel(const std::string& panel) {
     CefRefPtr<CefBrowser> overlay = SimpleHandler::GetOverlayBrowser();
     if (overlay && overlay->GetMainFrame()) {
         std::string js = "window.triggerPanel('" + panel + "')";
         overlay->GetMainFrame()->ExecuteJavaScript(js, overlay->GetMainFrame()->GetURL(), 0);
-        LOG_DEBUG_BROWSER("🧠 Deferred panel triggered after delay: " + panel);
+        LOG_DEBUG_BROWSER("🧠 Deferred panel triggered: " + panel);
     } else {
         LOG_DEBUG_BROWSER("⚠️ Overlay browser still not ready. Skipping panel trigger.");
     }
@@ -114,6 +208,15 @@ void SimpleHandler::OnTitleChange(CefRefPtr<CefBrowser> browser, const CefString
 #if defined(OS_WIN)
     SetWindowText(browser->GetHost()->GetWindowHandle(), std::wstring(title).c_str());
 #endif
+    if (role_ == "webview") {
+        TabManager::GetInstance().OnTitleChange(browser->GetIdentifier(), title.ToString());
+    }
+}
+
+void SimpleHandler::OnAddressChange(CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame, const CefString& url) {
+    if (role_ == "webview" && frame->IsMain()) {
+        TabManager::GetInstance().OnAddressChange(browser->GetIdentifier(), url.ToString());
+    }
 }
 
 void SimpleHandler::OnLoadError(CefRefPtr<CefBrowser> browser,
@@ -169,45 +272,28 @@ void SimpleHandler::OnLoadingStateChange(CefRefPtr<CefBrowser> browser,
         LOG_DEBUG_BROWSER("📡 Backup URL: " + browser->GetMainFrame()->GetURL().ToString());
     }
 
+    if (isLoading) {
+        BrowserReadiness::GetInstance().MarkLoading(browser);
+        ProfileCache::GetInstance().OnLoadStarted(role_);
+    }
+
     if (!isLoading) {
-        if (role_ == "overlay") {
-            // Log that we're about to inject the API
-            LOG_DEBUG_BROWSER("🔧 OVERLAY LOADED - About to inject bitcoinBrowser API");
-
-            // Inject the bitcoinBrowser API when overlay finishes loading
-            extern void InjectBitcoinBrowserAPI(CefRefPtr<CefBrowser> browser);
-            InjectBitcoinBrowserAPI(browser);
-        } else if (role_ == "webview") {
-            // Inject the bitcoinBrowser API into webview browser as well
-            LOG_DEBUG_BROWSER("🔧 WEBVIEW BROWSER LOADED - Injecting bitcoinBrowser API");
-
-            extern void InjectBitcoinBrowserAPI(CefRefPtr<CefBrowser> browser);
-            InjectBitcoinBrowserAPI(browser);
-        } else if (role_ == "header") {
-            // Inject the bitcoinBrowser API into header browser (where React app runs)
-            LOG_DEBUG_BROWSER("🔧 HEADER BROWSER LOADED - Injecting bitcoinBrowser API");
-
-            extern void InjectBitcoinBrowserAPI(CefRefPtr<CefBrowser> browser);
-            InjectBitcoinBrowserAPI(browser);
-        } else if (role_ == "settings") {
-            // Inject the bitcoinBrowser API into settings browser
-            LOG_DEBUG_BROWSER("🔧 SETTINGS BROWSER LOADED - Injecting bitcoinBrowser API");
-
-            extern void InjectBitcoinBrowserAPI(CefRefPtr<CefBrowser> browser);
-            InjectBitcoinBrowserAPI(browser);
+        OverlayPool::GetInstance().OnLoadFinished(role_);
+        ProfileCache::GetInstance().OnLoadFinished(role_);
+        if (role_ == "webview") {
+            StartupOrchestrator::GetInstance().Milestone("webview_loaded");
+            TabManager::GetInstance().OnTabLoaded(browser->GetIdentifier());
+        }
+
+        // bitcoinBrowser is bound natively in OnContextCreated; nothing to inject after load
+        if (role_ == "header") {
+            // The shell is up; warm the common overlays in the background
+            extern HINSTANCE g_hInstance;
+            OverlayPool::GetInstance().PrewarmDefaults(g_hInstance);
         } else if (role_ == "brc100auth") {
-            // Inject the bitcoinBrowser API into BRC-100 auth browser
-            LOG_DEBUG_BROWSER("🔧 BRC-100 AUTH BROWSER LOADED - Injecting bitcoinBrowser API");
-
-            extern void InjectBitcoinBrowserAPI(CefRefPtr<CefBrowser> browser);
-            InjectBitcoinBrowserAPI(browser);
-
-            // Send pending auth request data to the overlay after React app loads
-            // Add a small delay to ensure React is fully mounted
-            CefPostDelayedTask(TID_UI, base::BindOnce([]() {
-                extern void sendAuthRequestDataToOverlay();
-                sendAuthRequestDataToOverlay();
-            }), 500);
+            // Queued until the React app reports app_ready
+            extern void sendAuthRequestDataToOverlay();
+            sendAuthRequestDataToOverlay();
         }
 
         // Overlay-specific logic
@@ -216,7 +302,7 @@ void SimpleHandler::OnLoadingStateChange(CefRefPtr<CefBrowser> browser,
             if (needs_overlay_reload_) {
                 LOG_DEBUG_BROWSER("🔄 Overlay finished loading, now reloading React app");
                 needs_overlay_reload_ = false;
-                browser->GetMainFrame()->LoadURL("http://127.0.0.1:5137/overlay");
+                browser->GetMainFrame()->LoadURL(FrontendBundle::GetInstance().Url("/overlay"));
                 LOG_DEBUG_BROWSER("🔄 LoadURL called for overlay reload");
                 return; // Don't process pending panels yet, wait for reload to complete
             }
@@ -229,9 +315,10 @@ void SimpleHandler::OnLoadingStateChange(CefRefPtr<CefBrowser> browser,
                 // Clear pending_panel_ immediately to prevent duplicate deferred triggers
                 SimpleHandler::pending_panel_.clear();
 
-                // Delay JS execution slightly to ensure React is mounted
-                // Use a simple function call instead of lambda to avoid CEF bind issues
-                CefPostDelayedTask(TID_UI, base::BindOnce(&SimpleHandler::TriggerDeferredPanel, panel), 100);
+                // Fires once React has mounted and registered window.triggerPanel
+                BrowserReadiness::GetInstance().RunWhenReady(browser, [panel](CefRefPtr<CefBrowser>) {
+                    SimpleHandler::TriggerDeferredPanel(panel);
+                });
             }
         }
     }
@@ -241,15 +328,22 @@ void SimpleHandler::OnAfterCreated(CefRefPtr<CefBrowser> browser) {
     CEF_REQUIRE_UI_THREAD();
 
     LOG_DEBUG_BROWSER("✅ OnAfterCreated for role: " + role_);
+    // Closes the startup header_create/webview_create phases; no-op for other roles
+    StartupOrchestrator::GetInstance().EndPhase(role_ + "_create");
 
-    if (role_ == "webview") {
-        webview_browser_ = browser;
-        LOG_DEBUG_BROWSER("📡 WebView browser reference stored.");
-        LOG_DEBUG_BROWSER("📡 WebView browser reference stored. ID: " + std::to_string(browser->GetIdentifier()));
+    if (role_ == "webview" && browser->IsPopup()) {
+        // window.open() from a page inherits this client but is a window of its own: it must not
+        // take a pending tab's place or be activated over the real tab
+        LOG_DEBUG_BROWSER("🪟 Popup window from a tab, not tracked as a tab. ID: " + std::to_string(browser->GetIdentifier()));
+    } else if (role_ == "webview") {
+        TabManager::GetInstance().OnTabCreated(browser);
+        LOG_DEBUG_BROWSER("📡 WebView tab registered. ID: " + std::to_string(browser->GetIdentifier()));
 
         // Trigger initial resize to ensure content renders on startup
         browser->GetHost()->WasResized();
         LOG_DEBUG_BROWSER("🔄 Initial WasResized() called for webview browser");
+
+        ProfileCache::GetInstance().Observe(browser, role_);
     } else if (role_ == "header") {
         header_browser_ = browser;
         LOG_DEBUG_BROWSER("🧭 header browser initialized.");
@@ -281,44 +375,94 @@ void SimpleHandler::OnAfterCreated(CefRefPtr<CefBrowser> browser) {
         LOG_DEBUG_BROWSER("🔐 BRC-100 Auth browser main frame URL: " + browser->GetMainFrame()->GetURL().ToString());
     }
 
+    OverlayPool::GetInstance().OnBrowserCreated(role_, browser);
+
     LOG_DEBUG_BROWSER("🧭 Browser Created → role: " + role_ + ", ID: " + std::to_string(browser->GetIdentifier()) + ", IsPopup: " + (browser->IsPopup() ? "true" : "false") + ", MainFrame URL: " + browser->GetMainFrame()->GetURL().ToString());
 }
 
-bool SimpleHandler::OnProcessMessageReceived(
-    CefRefPtr<CefBrowser> browser,
-    CefRefPtr<CefFrame> frame,
-    CefProcessId source_process,
-    CefRefPtr<CefProcessMessage> message
-) {
+void SimpleHandler::OnBeforeClose(CefRefPtr<CefBrowser> browser) {
     CEF_REQUIRE_UI_THREAD();
 
-    std::string message_name = message->GetName();
-    LOG_DEBUG_BROWSER("📨 Message received: " + message_name + ", Browser ID: " + std::to_string(browser->GetIdentifier()));
+    WalletSubscriptions::GetInstance().Unsubscribe(browser->GetIdentifier(), nullptr);
 
-    // Additional logging for debugging
-    LOG_DEBUG_BROWSER("📨 Message received: " + message_name + ", Browser ID: " + std::to_string(browser->GetIdentifier()));
+    if (role_ == "webview") {
+        TabManager::GetInstance().OnTabClosed(browser->GetIdentifier());
+        ProfileCache::GetInstance().Unobserve(browser->GetIdentifier());
+    }
+}
 
-    if (message_name == "navigate") {
+void SimpleHandler::RegisterMessageRoutes() {
+    router_.Register("rpc_request", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                           CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        // Envelope from cefMessage.request(): [requestId, messageName, args]
         CefRefPtr<CefListValue> args = message->GetArgumentList();
-        std::string path = args->GetString(0);
+        int requestId = args->GetInt(0);
+        std::string innerName = args->GetString(1);
+        CefRefPtr<CefListValue> innerArgs = args->GetList(2);
+
+        CefRefPtr<CefProcessMessage> inner = CefProcessMessage::Create(innerName);
+        if (innerArgs) {
+            CefRefPtr<CefListValue> targetArgs = inner->GetArgumentList();
+            for (size_t i = 0; i < innerArgs->GetSize(); i++) {
+                targetArgs->SetValue(i, innerArgs->GetValue(i)->Copy());
+            }
+        }
 
-        // Normalize protocol
-        if (!(path.rfind("http://", 0) == 0 || path.rfind("https://", 0) == 0)) {
-            path = "http://" + path;
+        int previousRequestId = current_rpc_request_id_;
+        bool previousResponseSent = rpc_response_sent_;
+        current_rpc_request_id_ = requestId;
+        rpc_response_sent_ = false;
+
+        bool handled = OnProcessMessageReceived(browser, frame, source_process, inner);
+
+        // Every request must settle on the renderer side, even for fire-and-forget handlers
+        if (!rpc_response_sent_) {
+            nlohmann::json result = handled ? nlohmann::json{{"success", true}}
+                                             : nlohmann::json{{"error", "Unhandled message: " + innerName}};
+            CefRefPtr<CefProcessMessage> ack = CefProcessMessage::Create(innerName + (handled ? "_response" : "_error"));
+            ack->GetArgumentList()->SetString(0, result.dump());
+            SendRendererResponse(browser, ack);
+        }
+
+        current_rpc_request_id_ = previousRequestId;
+        rpc_response_sent_ = previousResponseSent;
+        return true;
+    });
+
+    router_.Register("navigate", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                        CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefListValue> args = message->GetArgumentList();
+        std::string path = NavigationPredictor::NormalizeUrl(args->GetString(0));
+        HistoryStore::GetInstance().NoteTypedNavigation();
+
+        // A matching prerender is swapped in instead of loading the page again
+        if (NavigationPredictor::GetInstance().OnCommit(path)) {
+            return true;
         }
 
         LOG_DEBUG_BROWSER("🔁 Forwarding navigation to webview: " + path);
 
-        if (SimpleHandler::webview_browser_ && SimpleHandler::webview_browser_->GetMainFrame()) {
-            SimpleHandler::webview_browser_->GetMainFrame()->LoadURL(path);
+        CefRefPtr<CefBrowser> webview = SimpleHandler::GetWebviewBrowser();
+        if (webview && webview->GetMainFrame()) {
+            webview->GetMainFrame()->LoadURL(path);
         } else {
             LOG_DEBUG_BROWSER("⚠️ WebView browser not available or not fully initialized.");
         }
 
         return true;
-    }
+    });
 
-    if (message_name == "navigate_back") {
+    // Address bar keystrokes; the predictor warms up the likely destination
+    router_.Register("navigation_input", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        if (role_ == "header") {
+            NavigationPredictor::GetInstance().OnInput(message->GetArgumentList()->GetString(0).ToString());
+        }
+        return true;
+    });
+
+    router_.Register("navigate_back", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                             CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("🔙 navigate_back message received from role: " + role_);
 
         CefRefPtr<CefBrowser> webview = SimpleHandler::GetWebviewBrowser();
@@ -329,9 +473,10 @@ bool SimpleHandler::OnProcessMessageReceived(
             LOG_WARNING_BROWSER("⚠️ No webview browser available for GoBack");
         }
         return true;
-    }
+    });
 
-    if (message_name == "navigate_forward") {
+    router_.Register("navigate_forward", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("🔜 navigate_forward message received from role: " + role_);
 
         CefRefPtr<CefBrowser> webview = SimpleHandler::GetWebviewBrowser();
@@ -342,9 +487,10 @@ bool SimpleHandler::OnProcessMessageReceived(
             LOG_WARNING_BROWSER("⚠️ No webview browser available for GoForward");
         }
         return true;
-    }
+    });
 
-    if (message_name == "navigate_reload") {
+    router_.Register("navigate_reload", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                               CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("🔄 navigate_reload message received from role: " + role_);
 
         CefRefPtr<CefBrowser> webview = SimpleHandler::GetWebviewBrowser();
@@ -355,12 +501,50 @@ bool SimpleHandler::OnProcessMessageReceived(
             LOG_WARNING_BROWSER("⚠️ No webview browser available for Reload");
         }
         return true;
-    }
+    });
 
-    // Duplicate address_generate handler removed - keeping the one at line 489
+    // Tab strip, for the shell's views only: [url, activate?] / [tabId]
+    router_.Register("tab_open", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                        CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        if (!ShellRoleAllowed("tab_open")) {
+            return false;
+        }
+        CefRefPtr<CefListValue> args = message->GetArgumentList();
+        std::string url = args->GetSize() > 0 ? args->GetString(0).ToString() : "";
+        bool activate = args->GetSize() > 1 ? args->GetBool(1) : true;
+        TabManager::GetInstance().OpenTab(url, activate);
+        return true;
+    });
 
+    router_.Register("tab_activate", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                            CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        if (!ShellRoleAllowed("tab_activate")) {
+            return false;
+        }
+        return TabManager::GetInstance().ActivateTab(message->GetArgumentList()->GetInt(0));
+    });
 
-    if (message_name == "force_repaint") {
+    router_.Register("tab_close", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                         CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        if (!ShellRoleAllowed("tab_close")) {
+            return false;
+        }
+        return TabManager::GetInstance().CloseTab(message->GetArgumentList()->GetInt(0));
+    });
+
+    router_.Register("tab_list", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                        CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        if (!ShellRoleAllowed("tab_list")) {
+            return false;
+        }
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("tabs_changed");
+        response->GetArgumentList()->SetString(0, TabManager::GetInstance().GetTabList().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
+
+    router_.Register("force_repaint", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                             CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("🔄 Force repaint requested for " + role_ + " browser");
 
         if (browser) {
@@ -368,9 +552,10 @@ bool SimpleHandler::OnProcessMessageReceived(
             LOG_DEBUG_BROWSER("🔄 Browser invalidated for " + role_ + " browser");
         }
         return true;
-    }
+    });
 
-    if (message_name == "wallet_status_check") {
+    router_.Register("wallet_status_check", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                   CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("🔍 Wallet status check requested");
 
         nlohmann::json response;
@@ -382,6 +567,7 @@ bool SimpleHandler::OnProcessMessageReceived(
 
             // Create WalletService instance for this operation
             WalletService walletService;
+            ScheduleWalletCalls(walletService, browser);
 
             // Call WalletService to get wallet status
             nlohmann::json walletStatus = walletService.getWalletStatus();
@@ -410,13 +596,14 @@ bool SimpleHandler::OnProcessMessageReceived(
         CefRefPtr<CefListValue> responseArgs = cefResponse->GetArgumentList();
         responseArgs->SetString(0, response.dump());
 
-        browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, cefResponse);
+        SendRendererResponse(browser, cefResponse);
         LOG_DEBUG_BROWSER("📤 Wallet status sent: " + response.dump());
 
         return true;
-    }
+    });
 
-    if (message_name == "create_wallet") {
+    router_.Register("create_wallet", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                             CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("🆕 Create wallet requested");
         LOG_DEBUG_BROWSER("🆕 Browser ID: " + std::to_string(browser->GetIdentifier()));
         LOG_DEBUG_BROWSER("🆕 Frame URL: " + browser->GetMainFrame()->GetURL().ToString());
@@ -425,6 +612,7 @@ bool SimpleHandler::OnProcessMessageReceived(
 
         try {
             WalletService walletService;
+            ScheduleWalletCalls(walletService, browser);
 
             if (!walletService.isConnected()) {
                 response["success"] = false;
@@ -440,6 +628,7 @@ bool SimpleHandler::OnProcessMessageReceived(
                     response["wallet"] = newWallet;
 
                     LOG_DEBUG_BROWSER("✅ New wallet created successfully");
+                    IdentityCache::GetInstance().Reload();
                 } else {
                     response["success"] = false;
                     response["error"] = "Failed to create wallet: " + newWallet.dump();
@@ -460,19 +649,21 @@ bool SimpleHandler::OnProcessMessageReceived(
         CefRefPtr<CefListValue> responseArgs = cefResponse->GetArgumentList();
         responseArgs->SetString(0, response.dump());
 
-        browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, cefResponse);
+        SendRendererResponse(browser, cefResponse);
         LOG_DEBUG_BROWSER("📤 Create wallet response sent: " + response.dump());
 
         return true;
-    }
+    });
 
-    if (message_name == "mark_wallet_backed_up") {
+    router_.Register("mark_wallet_backed_up", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                     CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("✅ Mark wallet as backed up requested");
 
         nlohmann::json response;
 
         try {
             WalletService walletService;
+            ScheduleWalletCalls(walletService, browser);
 
             if (!walletService.isConnected()) {
                 response["success"] = false;
@@ -486,6 +677,7 @@ bool SimpleHandler::OnProcessMessageReceived(
                 if (success) {
                     response["success"] = true;
                     LOG_DEBUG_BROWSER("✅ Wallet marked as backed up successfully");
+                    IdentityCache::GetInstance().Reload();
                 } else {
                     response["success"] = false;
                     response["error"] = "Failed to mark wallet as backed up";
@@ -506,19 +698,21 @@ bool SimpleHandler::OnProcessMessageReceived(
         CefRefPtr<CefListValue> responseArgs = cefResponse->GetArgumentList();
         responseArgs->SetString(0, response.dump());
 
-        browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, cefResponse);
+        SendRendererResponse(browser, cefResponse);
         LOG_DEBUG_BROWSER("📤 Mark backed up response sent: " + response.dump());
 
         return true;
-    }
+    });
 
-    if (message_name == "get_wallet_info") {
+    router_.Register("get_wallet_info", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                               CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("🔍 Get wallet info requested");
 
         nlohmann::json response;
 
         try {
             WalletService walletService;
+            ScheduleWalletCalls(walletService, browser);
 
             if (!walletService.isConnected()) {
                 response["success"] = false;
@@ -554,19 +748,21 @@ bool SimpleHandler::OnProcessMessageReceived(
         CefRefPtr<CefListValue> responseArgs = cefResponse->GetArgumentList();
         responseArgs->SetString(0, response.dump());
 
-        browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, cefResponse);
+        SendRendererResponse(browser, cefResponse);
         LOG_DEBUG_BROWSER("📤 Get wallet info response sent: " + response.dump());
 
         return true;
-    }
+    });
 
-    if (message_name == "load_wallet") {
+    router_.Register("load_wallet", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                           CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("📂 Load wallet requested");
 
         nlohmann::json response;
 
         try {
             WalletService walletService;
+            ScheduleWalletCalls(walletService, browser);
 
             if (!walletService.isConnected()) {
                 response["success"] = false;
@@ -582,6 +778,7 @@ bool SimpleHandler::OnProcessMessageReceived(
                     response["wallet"] = loadResult;
 
                     LOG_DEBUG_BROWSER("✅ Wallet loaded successfully");
+                    IdentityCache::GetInstance().Reload();
                 } else {
                     response["success"] = false;
                     response["error"] = "Failed to load wallet: " + loadResult.dump();
@@ -602,19 +799,21 @@ bool SimpleHandler::OnProcessMessageReceived(
         CefRefPtr<CefListValue> responseArgs = cefResponse->GetArgumentList();
         responseArgs->SetString(0, response.dump());
 
-        browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, cefResponse);
+        SendRendererResponse(browser, cefResponse);
         LOG_DEBUG_BROWSER("📤 Load wallet response sent: " + response.dump());
 
         return true;
-    }
+    });
 
-    if (message_name == "get_all_addresses") {
+    router_.Register("get_all_addresses", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                 CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("📍 Get all addresses requested");
 
         nlohmann::json response;
 
         try {
             WalletService walletService;
+            ScheduleWalletCalls(walletService, browser);
 
             if (!walletService.isConnected()) {
                 response["success"] = false;
@@ -650,19 +849,21 @@ bool SimpleHandler::OnProcessMessageReceived(
         CefRefPtr<CefListValue> responseArgs = cefResponse->GetArgumentList();
         responseArgs->SetString(0, response.dump());
 
-        browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, cefResponse);
+        SendRendererResponse(browser, cefResponse);
         LOG_DEBUG_BROWSER("📤 Get all addresses response sent: " + response.dump());
 
         return true;
-    }
+    });
 
-    if (message_name == "get_current_address") {
+    router_.Register("get_current_address", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                   CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("📍 Get current address requested");
 
         nlohmann::json response;
 
         try {
             WalletService walletService;
+            ScheduleWalletCalls(walletService, browser);
 
             if (!walletService.isConnected()) {
                 response["success"] = false;
@@ -698,19 +899,21 @@ bool SimpleHandler::OnProcessMessageReceived(
         CefRefPtr<CefListValue> responseArgs = cefResponse->GetArgumentList();
         responseArgs->SetString(0, response.dump());
 
-        browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, cefResponse);
+        SendRendererResponse(browser, cefResponse);
         LOG_DEBUG_BROWSER("📤 Get current address response sent: " + response.dump());
 
         return true;
-    }
+    });
 
-    if (message_name == "get_addresses") {
+    router_.Register("get_addresses", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                             CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("📍 Get all addresses requested");
 
         nlohmann::json response;
 
         try {
             WalletService walletService;
+            ScheduleWalletCalls(walletService, browser);
 
             if (!walletService.isConnected()) {
                 response["success"] = false;
@@ -740,13 +943,14 @@ bool SimpleHandler::OnProcessMessageReceived(
         CefRefPtr<CefListValue> responseArgs = cefResponse->GetArgumentList();
         responseArgs->SetString(0, response.dump());
 
-        browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, cefResponse);
+        SendRendererResponse(browser, cefResponse);
         LOG_DEBUG_BROWSER("📤 Get addresses response sent: " + response.dump());
 
         return true;
-    }
+    });
 
-    if (message_name == "get_backup_modal_state") {
+    router_.Register("get_backup_modal_state", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                      CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("📨 Message received: get_backup_modal_state");
 
         nlohmann::json response;
@@ -756,13 +960,14 @@ bool SimpleHandler::OnProcessMessageReceived(
         CefRefPtr<CefListValue> responseArgs = cefResponse->GetArgumentList();
         responseArgs->SetString(0, response.dump());
 
-        browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, cefResponse);
+        SendRendererResponse(browser, cefResponse);
         LOG_DEBUG_BROWSER("📤 Backup modal state sent: " + response.dump());
 
         return true;
-    }
+    });
 
-    if (message_name == "set_backup_modal_state") {
+    router_.Register("set_backup_modal_state", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                      CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("📨 Message received: set_backup_modal_state");
 
         CefRefPtr<CefListValue> args = message->GetArgumentList();
@@ -787,71 +992,25 @@ bool SimpleHandler::OnProcessMessageReceived(
         CefRefPtr<CefListValue> responseArgs = cefResponse->GetArgumentList();
         responseArgs->SetString(0, response.dump());
 
-        browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, cefResponse);
+        SendRendererResponse(browser, cefResponse);
         LOG_DEBUG_BROWSER("📤 Backup modal state updated: " + std::to_string(shown));
 
         return true;
-    }
+    });
 
-    if (message_name == "overlay_close") {
+    router_.Register("overlay_close", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                             CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("🧠 [SimpleHandler] overlay_close message received");
 
-        // Find and destroy overlay windows based on role
-        HWND target_hwnd = nullptr;
-        CefRefPtr<CefBrowser> target_browser = nullptr;
-
-        if (role_ == "settings") {
-            target_hwnd = FindWindow(L"CEFSettingsOverlayWindow", L"Settings Overlay");
-            target_browser = GetSettingsBrowser();
-            LOG_DEBUG_BROWSER("✅ Found settings overlay window: " + std::to_string(reinterpret_cast<uintptr_t>(target_hwnd)));
-        } else if (role_ == "wallet") {
-            target_hwnd = FindWindow(L"CEFWalletOverlayWindow", L"Wallet Overlay");
-            target_browser = GetWalletBrowser();
-            LOG_DEBUG_BROWSER("✅ Found wallet overlay window: " + std::to_string(reinterpret_cast<uintptr_t>(target_hwnd)));
-        } else if (role_ == "backup") {
-            target_hwnd = FindWindow(L"CEFBackupOverlayWindow", L"Backup Overlay");
-            target_browser = GetBackupBrowser();
-            LOG_DEBUG_BROWSER("✅ Found backup overlay window: " + std::to_string(reinterpret_cast<uintptr_t>(target_hwnd)));
-        } else if (role_ == "brc100auth") {
-            extern HWND g_brc100_auth_overlay_hwnd;
-            target_hwnd = g_brc100_auth_overlay_hwnd;
-            target_browser = GetBRC100AuthBrowser();
-            LOG_DEBUG_BROWSER("✅ Found BRC-100 auth overlay window: " + std::to_string(reinterpret_cast<uintptr_t>(target_hwnd)));
-        }
-
-        if (target_hwnd && IsWindow(target_hwnd)) {
-            LOG_DEBUG_BROWSER("✅ Found " + role_ + " overlay window: " + std::to_string(reinterpret_cast<uintptr_t>(target_hwnd)));
-
-            // Close the browser first
-            if (target_browser) {
-                LOG_DEBUG_BROWSER("🔄 Closing " + role_ + " browser");
-                target_browser->GetHost()->CloseBrowser(false);
-                // Clear the appropriate browser reference
-                if (role_ == "settings") settings_browser_ = nullptr;
-                else if (role_ == "wallet") wallet_browser_ = nullptr;
-                else if (role_ == "backup") backup_browser_ = nullptr;
-                else if (role_ == "brc100auth") brc100_auth_browser_ = nullptr;
-            }
-
-            // Then destroy the window
-            LOG_DEBUG_BROWSER("🔄 Destroying " + role_ + " overlay window");
-            SendMessage(target_hwnd, WM_CLOSE, 0, 0);
-        } else {
-            LOG_DEBUG_BROWSER("❌ " + role_ + " overlay window not found");
+        // Pooled overlays are hidden and kept warm for the next show
+        if (!OverlayPool::GetInstance().Hide(role_)) {
+            LOG_DEBUG_BROWSER("❌ " + role_ + " overlay not found in pool");
         }
-
-        return true;
-    }
-
-    if (false && message_name == "overlay_hide_NEVER_CALLED_12345") {
-        LOG_DEBUG_BROWSER("🪟 Hiding overlay HWND");
-        LOG_DEBUG_BROWSER("🪟 Before hide - EXSTYLE: 0x" + std::to_string(GetWindowLong(nullptr, GWL_EXSTYLE)));
-        ShowWindow(nullptr, SW_HIDE);
-        LOG_DEBUG_BROWSER("🪟 After hide - EXSTYLE: 0x" + std::to_string(GetWindowLong(nullptr, GWL_EXSTYLE)));
         return true;
-    }
+    });
 
-    if (message_name == "overlay_show_wallet") {
+    router_.Register("overlay_show_wallet", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                   CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("💰 overlay_show_wallet message received from role: " + role_);
 
         LOG_DEBUG_BROWSER("💰 Creating wallet overlay with separate process");
@@ -859,9 +1018,10 @@ bool SimpleHandler::OnProcessMessageReceived(
         extern HINSTANCE g_hInstance;
         CreateWalletOverlayWithSeparateProcess(g_hInstance);
         return true;
-    }
+    });
 
-    if (message_name == "overlay_show_backup") {
+    router_.Register("overlay_show_backup", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                   CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("💾 overlay_show_backup message received from role: " + role_);
 
         LOG_DEBUG_BROWSER("💾 Creating backup overlay with separate process");
@@ -869,9 +1029,10 @@ bool SimpleHandler::OnProcessMessageReceived(
         extern HINSTANCE g_hInstance;
         CreateBackupOverlayWithSeparateProcess(g_hInstance);
         return true;
-    }
+    });
 
-    if (message_name == "overlay_show_settings") {
+    router_.Register("overlay_show_settings", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                     CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("🪟 overlay_show_settings message received from role: " + role_);
 
         LOG_DEBUG_BROWSER("🪟 Creating settings overlay with separate process");
@@ -879,9 +1040,10 @@ bool SimpleHandler::OnProcessMessageReceived(
         extern HINSTANCE g_hInstance;
         CreateSettingsOverlayWithSeparateProcess(g_hInstance);
         return true;
-    }
+    });
 
-    if (message_name == "overlay_show_brc100_auth") {
+    router_.Register("overlay_show_brc100_auth", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                        CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("🔐 overlay_show_brc100_auth message received from role: " + role_);
 
         // Extract auth request data from message
@@ -904,24 +1066,21 @@ bool SimpleHandler::OnProcessMessageReceived(
         extern HINSTANCE g_hInstance;
         CreateBRC100AuthOverlayWithSeparateProcess(g_hInstance);
         return true;
-    }
+    });
 
-    if (message_name == "overlay_hide") {
+    router_.Register("overlay_hide", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                            CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("🪟 overlay_hide message received from role: " + role_);
 
-        // Close the BRC-100 auth overlay window
-        HWND auth_hwnd = FindWindow(L"CEFBRC100AuthOverlayWindow", L"BRC-100 Auth Overlay");
-        LOG_DEBUG_BROWSER("🪟 FindWindow result: " + std::to_string((uintptr_t)auth_hwnd));
-        if (auth_hwnd) {
-            LOG_DEBUG_BROWSER("🪟 Closing BRC-100 auth overlay window");
-            DestroyWindow(auth_hwnd);
-        } else {
-            LOG_DEBUG_BROWSER("🪟 BRC-100 auth overlay window not found");
+        // Hide the BRC-100 auth overlay; its browser stays pooled
+        if (!OverlayPool::GetInstance().Hide("brc100auth")) {
+            LOG_DEBUG_BROWSER("🪟 BRC-100 auth overlay not found in pool");
         }
         return true;
-    }
+    });
 
-    if (message_name == "brc100_auth_response") {
+    router_.Register("brc100_auth_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                    CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("🔐 brc100_auth_response message received from role: " + role_);
 
         // Extract response data from JSON
@@ -1028,9 +1187,10 @@ bool SimpleHandler::OnProcessMessageReceived(
             LOG_DEBUG_BROWSER("🔐 Invalid arguments for brc100_auth_response");
         }
         return true;
-    }
+    });
 
-    if (message_name == "add_domain_to_whitelist") {
+    router_.Register("add_domain_to_whitelist", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                       CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("🔐 add_domain_to_whitelist message received from role: " + role_);
 
         // Extract domain and permanent flag from JSON
@@ -1058,27 +1218,16 @@ bool SimpleHandler::OnProcessMessageReceived(
             LOG_DEBUG_BROWSER("🔐 Invalid arguments for add_domain_to_whitelist");
         }
         return true;
-    }
-
+    });
 
-    if (message_name == "test_settings_message") {
+    router_.Register("test_settings_message", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                     CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("🧪 test_settings_message received from role: " + role_);
         return true;
-    }
-
-    if (false && message_name == "overlay_hide_NEVER_CALLED_67890" && role_ == "settings") {
-        LOG_DEBUG_BROWSER("🪟 overlay_hide message received for settings overlay");
+    });
 
-        // Close the settings overlay window
-        HWND settings_hwnd = FindWindow(L"CEFSettingsOverlayWindow", L"Settings Overlay");
-        if (settings_hwnd) {
-            LOG_DEBUG_BROWSER("🪟 Closing settings overlay window");
-            DestroyWindow(settings_hwnd);
-        }
-        return true;
-    }
-
-    if (message_name == "overlay_input") {
+    router_.Register("overlay_input", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                             CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("🪟 overlay_input message received from role: " + role_);
 
         CefRefPtr<CefListValue> args = message->GetArgumentList();
@@ -1114,14 +1263,16 @@ bool SimpleHandler::OnProcessMessageReceived(
             LOG_DEBUG_BROWSER("❌ No target HWND found for overlay_input");
         }
         return true;
-    }
+    });
 
-    if (message_name == "address_generate") {
+    router_.Register("address_generate", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("🔑 Address generation requested from browser ID: " + std::to_string(browser->GetIdentifier()));
 
         try {
             // Call WalletService to generate address
             WalletService walletService;
+            ScheduleWalletCalls(walletService, browser);
             nlohmann::json addressData = walletService.generateAddress();
 
             LOG_DEBUG_BROWSER("✅ Address generated successfully: " + addressData.dump());
@@ -1131,7 +1282,7 @@ bool SimpleHandler::OnProcessMessageReceived(
             CefRefPtr<CefListValue> responseArgs = response->GetArgumentList();
             responseArgs->SetString(0, addressData.dump());
 
-            browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, response);
+            SendRendererResponse(browser, response);
             LOG_DEBUG_BROWSER("📤 Address data sent back to browser");
             LOG_DEBUG_BROWSER("🔍 Browser ID: " + std::to_string(browser->GetIdentifier()));
             LOG_DEBUG_BROWSER("🔍 Frame URL: " + browser->GetMainFrame()->GetURL().ToString());
@@ -1144,15 +1295,15 @@ bool SimpleHandler::OnProcessMessageReceived(
             CefRefPtr<CefListValue> responseArgs = response->GetArgumentList();
             responseArgs->SetString(0, e.what());
 
-            browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, response);
+            SendRendererResponse(browser, response);
         }
 
         return true;
-    }
+    });
 
     // Transaction Message Handlers
-
-    if (message_name == "create_transaction") {
+    router_.Register("create_transaction", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                  CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("💰 Create transaction requested from browser ID: " + std::to_string(browser->GetIdentifier()));
 
         try {
@@ -1164,6 +1315,7 @@ bool SimpleHandler::OnProcessMessageReceived(
 
                 // Call WalletService to create transaction
                 WalletService walletService;
+                ScheduleWalletCalls(walletService, browser);
                 nlohmann::json result = walletService.createTransaction(transactionData);
 
                 LOG_DEBUG_BROWSER("✅ Transaction creation result: " + result.dump());
@@ -1173,7 +1325,7 @@ bool SimpleHandler::OnProcessMessageReceived(
                 CefRefPtr<CefListValue> responseArgs = response->GetArgumentList();
                 responseArgs->SetString(0, result.dump());
 
-                browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, response);
+                SendRendererResponse(browser, response);
                 LOG_DEBUG_BROWSER("📤 Transaction creation response sent back to browser");
             } else {
                 throw std::runtime_error("No transaction data provided");
@@ -1190,13 +1342,14 @@ bool SimpleHandler::OnProcessMessageReceived(
             CefRefPtr<CefListValue> responseArgs = response->GetArgumentList();
             responseArgs->SetString(0, errorResponse.dump());
 
-            browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, response);
+            SendRendererResponse(browser, response);
         }
 
         return true;
-    }
+    });
 
-    if (message_name == "sign_transaction") {
+    router_.Register("sign_transaction", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("✍️ Sign transaction requested from browser ID: " + std::to_string(browser->GetIdentifier()));
 
         try {
@@ -1208,6 +1361,7 @@ bool SimpleHandler::OnProcessMessageReceived(
 
                 // Call WalletService to sign transaction
                 WalletService walletService;
+                ScheduleWalletCalls(walletService, browser);
                 nlohmann::json result = walletService.signTransaction(transactionData);
 
                 LOG_DEBUG_BROWSER("✅ Transaction signing result: " + result.dump());
@@ -1217,7 +1371,7 @@ bool SimpleHandler::OnProcessMessageReceived(
                 CefRefPtr<CefListValue> responseArgs = response->GetArgumentList();
                 responseArgs->SetString(0, result.dump());
 
-                browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, response);
+                SendRendererResponse(browser, response);
                 LOG_DEBUG_BROWSER("📤 Transaction signing response sent back to browser");
             } else {
                 throw std::runtime_error("No transaction data provided");
@@ -1234,13 +1388,14 @@ bool SimpleHandler::OnProcessMessageReceived(
             CefRefPtr<CefListValue> responseArgs = response->GetArgumentList();
             responseArgs->SetString(0, errorResponse.dump());
 
-            browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, response);
+            SendRendererResponse(browser, response);
         }
 
         return true;
-    }
+    });
 
-    if (message_name == "broadcast_transaction") {
+    router_.Register("broadcast_transaction", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                     CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("📡 Broadcast transaction requested from browser ID: " + std::to_string(browser->GetIdentifier()));
 
         try {
@@ -1252,6 +1407,7 @@ bool SimpleHandler::OnProcessMessageReceived(
 
                 // Call WalletService to broadcast transaction
                 WalletService walletService;
+                ScheduleWalletCalls(walletService, browser);
                 nlohmann::json result = walletService.broadcastTransaction(transactionData);
 
                 LOG_DEBUG_BROWSER("✅ Transaction broadcast result: " + result.dump());
@@ -1261,7 +1417,7 @@ bool SimpleHandler::OnProcessMessageReceived(
                 CefRefPtr<CefListValue> responseArgs = response->GetArgumentList();
                 responseArgs->SetString(0, result.dump());
 
-                browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, response);
+                SendRendererResponse(browser, response);
                 LOG_DEBUG_BROWSER("📤 Transaction broadcast response sent back to browser");
             } else {
                 throw std::runtime_error("No transaction data provided");
@@ -1278,19 +1434,20 @@ bool SimpleHandler::OnProcessMessageReceived(
             CefRefPtr<CefListValue> responseArgs = response->GetArgumentList();
             responseArgs->SetString(0, errorResponse.dump());
 
-            browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, response);
+            SendRendererResponse(browser, response);
         }
 
         return true;
-    }
+    });
 
-
-        if (message_name == "get_balance") {
+    router_.Register("get_balance", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                           CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("💰 Get balance requested from browser ID: " + std::to_string(browser->GetIdentifier()));
 
         try {
             // Call WalletService to get balance (no arguments needed)
             WalletService walletService;
+            ScheduleWalletCalls(walletService, browser);
 
             // Pass empty JSON object to satisfy the method signature
             nlohmann::json emptyData = nlohmann::json::object();
@@ -1303,7 +1460,7 @@ bool SimpleHandler::OnProcessMessageReceived(
             CefRefPtr<CefListValue> responseArgs = response->GetArgumentList();
             responseArgs->SetString(0, result.dump());
 
-            browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, response);
+            SendRendererResponse(browser, response);
             LOG_DEBUG_BROWSER("📤 Balance response sent back to browser");
 
         } catch (const std::exception& e) {
@@ -1317,13 +1474,14 @@ bool SimpleHandler::OnProcessMessageReceived(
             CefRefPtr<CefListValue> responseArgs = response->GetArgumentList();
             responseArgs->SetString(0, errorResponse.dump());
 
-            browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, response);
+            SendRendererResponse(browser, response);
         }
 
         return true;
-    }
+    });
 
-    if (message_name == "send_transaction") {
+    router_.Register("send_transaction", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         LOG_DEBUG_BROWSER("🚀 Send transaction requested from browser ID: " + std::to_string(browser->GetIdentifier()));
 
         try {
@@ -1339,7 +1497,11 @@ bool SimpleHandler::OnProcessMessageReceived(
 
                 // Call WalletService to send transaction
                 WalletService walletService;
+                ScheduleWalletCalls(walletService, browser);
                 nlohmann::json result = walletService.sendTransaction(transactionData);
+                if (!result.contains("error")) {
+                    TransactionHistoryCache::GetInstance().Invalidate();
+                }
 
                 LOG_DEBUG_BROWSER("✅ Transaction result: " + result.dump());
 
@@ -1348,7 +1510,7 @@ bool SimpleHandler::OnProcessMessageReceived(
                 CefRefPtr<CefListValue> responseArgs = response->GetArgumentList();
                 responseArgs->SetString(0, result.dump());
 
-                browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, response);
+                SendRendererResponse(browser, response);
                 LOG_DEBUG_BROWSER("📤 Transaction response sent back to browser");
             } else {
                 LOG_DEBUG_BROWSER("❌ send_transaction: No arguments provided, args->GetSize() = " + std::to_string(args->GetSize()));
@@ -1366,48 +1528,377 @@ bool SimpleHandler::OnProcessMessageReceived(
             CefRefPtr<CefListValue> responseArgs = response->GetArgumentList();
             responseArgs->SetString(0, errorResponse.dump());
 
-            browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, response);
+            SendRendererResponse(browser, response);
         }
 
         return true;
-    }
+    });
 
-    if (message_name == "get_transaction_history") {
-        LOG_DEBUG_BROWSER("📜 Get transaction history requested from browser ID: " + std::to_string(browser->GetIdentifier()));
+    // {offset?, limit?, status?, text?, refresh?}: one window of the cached history, newest first
+    router_.Register("get_transaction_history", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                       CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefListValue> args = message->GetArgumentList();
+        nlohmann::json query = args->GetSize() > 0
+            ? nlohmann::json::parse(args->GetString(0).ToString(), nullptr, false)
+            : nlohmann::json();
 
-        try {
-            // Call WalletService to get transaction history
-            WalletService walletService;
-            nlohmann::json result = walletService.getTransactionHistory();
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_transaction_history_response");
+        response->GetArgumentList()->SetString(0, TransactionHistoryCache::GetInstance().Page(query).dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
+
+    // Cached transactions, sync results and page latency
+    router_.Register("get_transaction_history_stats", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                             CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_transaction_history_stats_response");
+        response->GetArgumentList()->SetString(0, TransactionHistoryCache::GetInstance().GetStats().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
+
+    // {topics: [...]}: push changes to these wallet topics to this browser as wallet_state messages;
+    // the shell's views only, since the topics carry the balance and history
+    router_.Register("wallet_subscribe", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        if (!ShellRoleAllowed("wallet_subscribe")) {
+            return false;
+        }
+        CefRefPtr<CefListValue> args = message->GetArgumentList();
+        nlohmann::json request = nlohmann::json::parse(args->GetSize() > 0 ? args->GetString(0).ToString() : "",
+                                                       nullptr, false);
 
-            LOG_DEBUG_BROWSER("✅ Transaction history result: " + result.dump());
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("wallet_subscribe_response");
+        response->GetArgumentList()->SetString(0, WalletSubscriptions::GetInstance().Subscribe(browser, request).dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
 
-            // Send result back to the requesting browser
-            CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_transaction_history_response");
-            CefRefPtr<CefListValue> responseArgs = response->GetArgumentList();
-            responseArgs->SetString(0, result.dump());
+    // {topics: [...]} or nothing for every topic; also sent by the renderer when the page goes away
+    router_.Register("wallet_unsubscribe", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                  CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefListValue> args = message->GetArgumentList();
+        nlohmann::json request = nlohmann::json::parse(args->GetSize() > 0 ? args->GetString(0).ToString() : "",
+                                                       nullptr, false);
+        WalletSubscriptions::GetInstance().Unsubscribe(browser->GetIdentifier(), request);
+        return true;
+    });
+
+    // Subscribers per topic, event stream state and how many pushes were sent or suppressed
+    router_.Register("get_wallet_subscription_stats", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                             CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_wallet_subscription_stats_response");
+        response->GetArgumentList()->SetString(0, WalletSubscriptions::GetInstance().GetStats().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
+
+    // Transport mode and requests per transport
+    router_.Register("get_wallet_transport_stats", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                          CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_wallet_transport_stats_response");
+        response->GetArgumentList()->SetString(0, DaemonTransport::GetInstance().GetStats().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
+
+    // Channel connection, call counts and daemon wakeups
+    router_.Register("get_wallet_channel_stats", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                        CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_wallet_channel_stats_response");
+        response->GetArgumentList()->SetString(0, DaemonChannel::GetInstance().GetStats().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
+
+    // Calls per scheduler class by verdict, in flight, waiting and queue waits
+    router_.Register("get_daemon_scheduler_stats", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                          CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_daemon_scheduler_stats_response");
+        response->GetArgumentList()->SetString(0, DaemonScheduler::GetInstance().GetStats().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
+
+    // Breaker state, outcomes, hedges and retries for daemon calls
+    router_.Register("get_daemon_breaker_stats", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                        CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_daemon_breaker_stats_response");
+        response->GetArgumentList()->SetString(0, DaemonCircuitBreaker::GetInstance().GetStats().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
 
-            browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, response);
-            LOG_DEBUG_BROWSER("📤 Transaction history response sent back to browser");
+    // Sent by the React app once it has mounted; releases messages queued for this browser
+    router_.Register("app_ready", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                         CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefListValue> args = message->GetArgumentList();
+        std::string path = args->GetSize() > 0 ? args->GetString(0).ToString() : "";
+        LOG_DEBUG_BROWSER("✅ app_ready from role " + role_ + " (" + path + ")");
+        BrowserReadiness::GetInstance().MarkReady(browser);
+        if (role_ == "header") {
+            StartupOrchestrator::GetInstance().Milestone("header_app_ready");
+        }
+        return true;
+    });
 
-        } catch (const std::exception& e) {
-            LOG_DEBUG_BROWSER("❌ Get transaction history failed: " + std::string(e.what()));
+    router_.Register("brc100_auth_modal_visible", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                         CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        extern void recordAuthModalVisible();
+        recordAuthModalVisible();
+        return true;
+    });
+
+    router_.Register("get_auth_modal_latency_stats", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                            CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        extern nlohmann::json getAuthModalLatencyStats();
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_auth_modal_latency_stats_response");
+        response->GetArgumentList()->SetString(0, getAuthModalLatencyStats().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
 
-            // Send error response
-            nlohmann::json errorResponse;
-            errorResponse["error"] = e.what();
+    // Shell renderers ask for the cached identity when a V8 context is created; tabs are not sent it
+    router_.Register("identity_sync", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                             CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        if (role_ == "webview") {
+            return true;
+        }
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("identity_update");
+        response->GetArgumentList()->SetString(0, IdentityCache::GetInstance().GetSnapshot().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
+
+    // Renderers ask whether the session table is live when a V8 context is created
+    router_.Register("brc100_session_sync", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                   CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("brc100_session_update");
+        response->GetArgumentList()->SetString(0, BRC100SessionCache::GetInstance().GetSyncState().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
+
+    // Local session table size and how many session checks it answered
+    router_.Register("get_brc100_session_stats", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                        CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_brc100_session_stats_response");
+        response->GetArgumentList()->SetString(0, BRC100SessionCache::GetInstance().GetStats().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
 
-            CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_transaction_history_error");
-            CefRefPtr<CefListValue> responseArgs = response->GetArgumentList();
-            responseArgs->SetString(0, errorResponse.dump());
+    router_.Register("identity_invalidate", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                   CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        LOG_DEBUG_BROWSER("🪪 Identity invalidated by renderer");
+        IdentityCache::GetInstance().Reload();
+        return true;
+    });
+
+    // Overlay pool occupancy and show-to-first-paint timing
+    router_.Register("get_overlay_pool_stats", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                      CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_overlay_pool_stats_response");
+        response->GetArgumentList()->SetString(0, OverlayPool::GetInstance().GetStats().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
+
+    // Disk-cache hit rates and first-load times for this launch vs. the previous one
+    router_.Register("get_cache_stats", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                               CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_cache_stats_response");
+        response->GetArgumentList()->SetString(0, ProfileCache::GetInstance().GetStats().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
+
+    // Tab counts, switch latency and per-tab memory
+    router_.Register("get_tab_stats", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                             CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_tab_stats_response");
+        response->GetArgumentList()->SetString(0, TabManager::GetInstance().GetStats().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
 
-            browser->GetMainFrame()->SendProcessMessage(PID_RENDERER, response);
+    // [tabCount, url?]: opens that many background tabs (capped) and times switching across them
+    router_.Register("tab_benchmark", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                             CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        if (!BenchmarksAllowed("tab_benchmark")) {
+            return false;
+        }
+        CefRefPtr<CefListValue> args = message->GetArgumentList();
+        int tabCount = args->GetSize() > 0 ? args->GetInt(0) : 50;
+        std::string url = args->GetSize() > 1 ? args->GetString(1).ToString() : "about:blank";
+        TabManager::GetInstance().StartBenchmark(tabCount, url);
+        return true;
+    });
+
+    // Sent by every renderer on main-frame context creation; only tab renderers are tracked
+    router_.Register("renderer_pid", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                            CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        if (role_ == "webview") {
+            TabLifecycle::GetInstance().OnRendererPid(browser->GetIdentifier(),
+                                                      static_cast<DWORD>(message->GetArgumentList()->GetInt(0)));
         }
+        return true;
+    });
 
+    // [scrollX, scrollY] reply to tab_capture_state; completes a pending discard
+    router_.Register("tab_state", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                         CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefListValue> args = message->GetArgumentList();
+        TabLifecycle::GetInstance().OnTabState(browser->GetIdentifier(), args->GetInt(0), args->GetInt(1));
         return true;
-    }
+    });
+
+    // [tabId]: last captured thumbnail as a data URL, empty if there is none
+    router_.Register("tab_thumbnail", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                             CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        int tabId = message->GetArgumentList()->GetInt(0);
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("tab_thumbnail_response");
+        response->GetArgumentList()->SetInt(0, tabId);
+        response->GetArgumentList()->SetString(1, TabLifecycle::GetInstance().GetThumbnailDataUrl(tabId));
+        SendRendererResponse(browser, response);
+        return true;
+    });
+
+    // Discards, restores and renderer memory against the tab budget
+    router_.Register("get_tab_lifecycle_stats", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                       CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_tab_lifecycle_stats_response");
+        response->GetArgumentList()->SetString(0, TabLifecycle::GetInstance().GetStats().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
+
+    // Address bar prediction accuracy and commit-to-ready time by warmup level
+    router_.Register("get_navigation_prediction_stats", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                               CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_navigation_prediction_stats_response");
+        response->GetArgumentList()->SetString(0, NavigationPredictor::GetInstance().GetStats().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
 
-    return false;
+    // Address bar suggestions: the JSON argument is the typed text or {text, limit}
+    router_.Register("history_search", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                              CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        if (!ShellRoleAllowed("history_search")) {
+            return false;
+        }
+        std::string text;
+        size_t limit = 8;
+        nlohmann::json query = nlohmann::json::parse(message->GetArgumentList()->GetString(0).ToString(), nullptr, false);
+        if (query.is_string()) {
+            text = query.get<std::string>();
+        } else if (query.is_object()) {
+            if (query.contains("text") && query["text"].is_string()) {
+                text = query["text"].get<std::string>();
+            }
+            if (query.contains("limit") && query["limit"].is_number_unsigned()) {
+                limit = query["limit"].get<size_t>();
+            }
+        }
+
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("history_search_response");
+        response->GetArgumentList()->SetString(0, HistoryStore::GetInstance().Search(text, limit).dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
+
+    // History size, load time and live query latency
+    router_.Register("get_history_stats", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                 CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_history_stats_response");
+        response->GetArgumentList()->SetString(0, HistoryStore::GetInstance().GetStats().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
+
+    // {domain?, from?, to?, limit?}: per-site wallet usage for the settings UI
+    router_.Register("wallet_activity_query", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                     CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        if (!ShellRoleAllowed("wallet_activity_query")) {
+            return false;
+        }
+        nlohmann::json query = nlohmann::json::parse(message->GetArgumentList()->GetString(0).ToString(), nullptr, false);
+
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("wallet_activity_query_response");
+        response->GetArgumentList()->SetString(0, ActivityJournal::GetInstance().Query(query).dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
+
+    // Journal size, snapshot and load results and query latency
+    router_.Register("get_wallet_activity_stats", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                         CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_wallet_activity_stats_response");
+        response->GetArgumentList()->SetString(0, ActivityJournal::GetInstance().GetStats().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
+
+    // Key count, log size vs. live data, commit latency and compactions of the state store
+    router_.Register("get_state_store_stats", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                     CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_state_store_stats_response");
+        response->GetArgumentList()->SetString(0, StateStore::GetInstance().GetStats().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
+
+    // Which browsers are shown, overlay frame rates and CPU usage per shell state
+    router_.Register("get_occlusion_stats", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                   CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_occlusion_stats_response");
+        response->GetArgumentList()->SetString(0, OcclusionTracker::GetInstance().GetStats().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
+
+    // Startup phase timings, milestones and the first-paint budget result
+    router_.Register("get_startup_timeline", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                    CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_startup_timeline_response");
+        response->GetArgumentList()->SetString(0, StartupOrchestrator::GetInstance().GetTimeline().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
+
+    // Where the UI is served from, bundle map time and per-encoding response counts
+    router_.Register("get_frontend_bundle_stats", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                         CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_frontend_bundle_stats_response");
+        response->GetArgumentList()->SetString(0, FrontendBundle::GetInstance().GetStats().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
+
+    // Routing stats for this handler (call counts and handler time per message)
+    router_.Register("get_ipc_stats", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                             CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefProcessMessage> response = CefProcessMessage::Create("get_ipc_stats_response");
+        response->GetArgumentList()->SetString(0, router_.GetStats().dump());
+        SendRendererResponse(browser, response);
+        return true;
+    });
+}
+
+bool SimpleHandler::OnProcessMessageReceived(
+    CefRefPtr<CefBrowser> browser,
+    CefRefPtr<CefFrame> frame,
+    CefProcessId source_process,
+    CefRefPtr<CefProcessMessage> message
+) {
+    CEF_REQUIRE_UI_THREAD();
+
+    LOG_DEBUG_BROWSER("📨 Message received: " + message->GetName().ToString() + ", Browser ID: " + std::to_string(browser->GetIdentifier()));
+
+    // However many daemon calls a handler makes, the UI thread waits on them for no longer than this
+    DaemonDeadline::Scope deadline(30000);
+    return router_.Dispatch(browser, frame, source_process, message);
 }
 
 CefRefPtr<CefRequestHandler> SimpleHandler::GetRequestHandler() {
@@ -1473,6 +1964,24 @@ bool SimpleHandler::OnPreKeyEvent(CefRefPtr<CefBrowser> browser,
         return false; // Let the event be processed normally
     }
 
+    // Tab shortcuts from the header or any tab: Ctrl+T, Ctrl+W, Ctrl+(Shift+)Tab
+    if ((role_ == "header" || role_ == "webview") && event.type == KEYEVENT_RAWKEYDOWN &&
+        (event.modifiers & EVENTFLAG_CONTROL_DOWN)) {
+        TabManager& tabs = TabManager::GetInstance();
+        if (event.windows_key_code == 'T') {
+            tabs.OpenTab("");
+            return true;
+        }
+        if (event.windows_key_code == 'W') {
+            tabs.CloseTab(tabs.GetActiveTabId());
+            return true;
+        }
+        if (event.windows_key_code == VK_TAB) {
+            tabs.ActivateAdjacent((event.modifiers & EVENTFLAG_SHIFT_DOWN) ? -1 : 1);
+            return true;
+        }
+    }
+
     return false; // Let other handlers process the event
 }
 
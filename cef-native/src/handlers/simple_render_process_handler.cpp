@@ -1,11 +1,13 @@
 // cef_native/src/simple_render_process_handler.cpp
 #include "../../include/handlers/simple_render_process_handler.h"
 #include "../../include/core/IdentityHandler.h"
-#include "../../include/core/NavigationHandler.h"
-#include "../../include/core/AddressHandler.h"
+#include "../../include/core/BitcoinBrowserBindings.h"
+#include "../../include/core/RendererRpc.h"
+#include "../../include/core/FrontendBundle.h"
 #include "BRC100Handler.h"
 #include "wrapper/cef_helpers.h"
 #include "include/cef_v8.h"
+#include <nlohmann/json.hpp>
 #include <iostream>
 #include <fstream>
 
@@ -125,10 +127,12 @@ private:
     IMPLEMENT_REFCOUNTING(CefMessageSendHandler);
 };
 
-// Handler for overlay.close() function
-class OverlayCloseHandler : public CefV8Handler {
+// Handler for cefMessage.request(name, args, onSuccess, onError)
+// Wraps the message in an rpc_request envelope so the browser can echo the id back,
+// letting many same-type calls from one page be in flight at once.
+class CefMessageRequestHandler : public CefV8Handler {
 public:
-    OverlayCloseHandler() {}
+    CefMessageRequestHandler() {}
 
     bool Execute(const CefString& name,
                  CefRefPtr<CefV8Value> object,
@@ -138,30 +142,47 @@ public:
 
         CEF_REQUIRE_RENDERER_THREAD();
 
-        std::cout << "🎯 overlay.close() called from overlay browser" << std::endl;
-        LOG_DEBUG_RENDER("🎯 overlay.close() called from overlay browser");
+        if (arguments.size() < 4 || !arguments[0]->IsString() ||
+            !arguments[2]->IsFunction() || !arguments[3]->IsFunction()) {
+            exception = "cefMessage.request() requires (name, args, onSuccess, onError)";
+            return true;
+        }
 
-        // Send overlay_close message via cefMessage
         CefRefPtr<CefV8Context> context = CefV8Context::GetCurrentContext();
-        if (context && context->GetFrame()) {
-            CefRefPtr<CefProcessMessage> message = CefProcessMessage::Create("overlay_close");
-            context->GetFrame()->SendProcessMessage(PID_BROWSER, message);
+        if (!context || !context->GetFrame()) {
+            exception = "cefMessage.request() called without a frame context";
+            return true;
+        }
 
-            std::cout << "✅ overlay.close() sent overlay_close message" << std::endl;
-            LOG_DEBUG_RENDER("✅ overlay.close() sent overlay_close message");
+        // Objects are forwarded as JSON strings, which is what the browser handlers parse
+        CefRefPtr<CefListValue> callArgs = CefListValue::Create();
+        std::string error;
+        if (!RendererRpc::ConvertArguments(arguments[1], callArgs, error)) {
+            exception = "cefMessage.request() " + error;
+            return true;
         }
 
+        RendererRpc::PendingCall call;
+        call.messageName = arguments[0]->GetStringValue();
+        call.context = context;
+        call.onSuccess = arguments[2];
+        call.onError = arguments[3];
+        int requestId = RendererRpc::Send(std::move(call), callArgs);
+
+        retval = CefV8Value::CreateInt(requestId);
         return true;
     }
 
 private:
-    IMPLEMENT_REFCOUNTING(OverlayCloseHandler);
+    IMPLEMENT_REFCOUNTING(CefMessageRequestHandler);
 };
 
-SimpleRenderProcessHandler::SimpleRenderProcessHandler() {
+SimpleRenderProcessHandler::SimpleRenderProcessHandler()
+    : router_("render", 1) {
     LOG_DEBUG_RENDER("🔧 SimpleRenderProcessHandler constructor called!");
     LOG_DEBUG_RENDER("🔧 Process ID: " + std::to_string(GetCurrentProcessId()));
     LOG_DEBUG_RENDER("🔧 Thread ID: " + std::to_string(GetCurrentThreadId()));
+    RegisterMessageRoutes();
 }
 
 void SimpleRenderProcessHandler::OnContextCreated(
@@ -180,160 +201,212 @@ void SimpleRenderProcessHandler::OnContextCreated(
 
     // Check if this is an overlay browser (any browser that's not the main root browser)
     std::string url = frame->GetURL().ToString();
-    bool isMainBrowser = (url == "http://127.0.0.1:5137" || url == "http://127.0.0.1:5137/");
-    bool isOverlayBrowser = !isMainBrowser && url.find("127.0.0.1:5137") != std::string::npos;
-
-    if (isOverlayBrowser) {
-        LOG_DEBUG_RENDER("🎯 OVERLAY BROWSER V8 CONTEXT CREATED!");
-        LOG_DEBUG_RENDER("🎯 URL: " + url);
-        LOG_DEBUG_RENDER("🎯 Setting up bitcoinBrowser for overlay browser");
-    }
+    bool isMainBrowser = FrontendBundle::IsAppRootUrl(url);
+    bool isOverlayBrowser = !isMainBrowser && FrontendBundle::IsAppUrl(url);
 
     CefRefPtr<CefV8Value> global = context->GetGlobal();
 
-    // Create the bitcoinBrowser object
-    CefRefPtr<CefV8Value> bitcoinBrowser = CefV8Value::CreateObject(nullptr, nullptr);
-    global->SetValue("bitcoinBrowser", bitcoinBrowser, V8_PROPERTY_ATTRIBUTE_READONLY);
-
-    // Create the identity object inside bitcoinBrowser
-    CefRefPtr<CefV8Value> identityObject = CefV8Value::CreateObject(nullptr, nullptr);
-    bitcoinBrowser->SetValue("identity", identityObject, V8_PROPERTY_ATTRIBUTE_READONLY);
-
-    // Bind the IdentityHandler instance
-    CefRefPtr<IdentityHandler> identityHandler = new IdentityHandler();
-
-    identityObject->SetValue("get",
-        CefV8Value::CreateFunction("get", identityHandler),
-        V8_PROPERTY_ATTRIBUTE_NONE);
-
-    identityObject->SetValue("markBackedUp",
-        CefV8Value::CreateFunction("markBackedUp", identityHandler),
-        V8_PROPERTY_ATTRIBUTE_NONE);
-
-    // Create the navigation object inside bitcoinBrowser
-    CefRefPtr<CefV8Value> navigationObject = CefV8Value::CreateObject(nullptr, nullptr);
-    bitcoinBrowser->SetValue("navigation", navigationObject, V8_PROPERTY_ATTRIBUTE_READONLY);
-
-    // Bind the NavigationHandler instance
-    CefRefPtr<NavigationHandler> navigationHandler = new NavigationHandler();
-
-    navigationObject->SetValue("navigate",
-        CefV8Value::CreateFunction("navigate", navigationHandler),
-        V8_PROPERTY_ATTRIBUTE_NONE);
-
-    // overlayPanel object removed - now using process-per-overlay architecture
-
-    // Create the overlay object (for overlay browsers only)
-    if (isOverlayBrowser) {
-        LOG_DEBUG_RENDER("🎯 Creating overlay object for URL: " + url);
-
-        CefRefPtr<CefV8Value> overlayObject = CefV8Value::CreateObject(nullptr, nullptr);
-        bitcoinBrowser->SetValue("overlay", overlayObject, V8_PROPERTY_ATTRIBUTE_READONLY);
-
-        // Add close method for overlay browsers - uses cefMessage internally
-        overlayObject->SetValue("close",
-            CefV8Value::CreateFunction("close", new OverlayCloseHandler()),
+    // bitcoinBrowser API, bound natively before any page script runs; wallet, tabs, history and
+    // overlay only for the browser's own UI, never for web content or frames embedded in it
+    bool appFrame = frame->IsMain() && FrontendBundle::IsAppUrl(url);
+    long long bindMicros = BitcoinBrowserBindings::Install(context, appFrame);
+    bindingInstalls_++;
+    bindingMicrosTotal_ += bindMicros;
+    LOG_INFO_RENDER("⏱️ bitcoinBrowser bindings installed in " + std::to_string(bindMicros) +
+                    " us at context creation (avg " + std::to_string(bindingMicrosTotal_ / bindingInstalls_) +
+                    " us over " + std::to_string(bindingInstalls_) + " contexts): " + url);
+
+    // cefMessage posts any message name to the browser process, so like the bindings above it is
+    // only for the app's own frames; web content reaches the browser through bitcoinBrowser's
+    // public calls and the BRC-100 API
+    if (appFrame) {
+        CefRefPtr<CefV8Value> cefMessageObject = CefV8Value::CreateObject(nullptr, nullptr);
+        global->SetValue("cefMessage", cefMessageObject, V8_PROPERTY_ATTRIBUTE_READONLY);
+
+        // Create the send function for cefMessage
+        CefRefPtr<CefV8Value> sendFunction = CefV8Value::CreateFunction("send", new CefMessageSendHandler());
+        cefMessageObject->SetValue("send", sendFunction, V8_PROPERTY_ATTRIBUTE_NONE);
+
+        // Request/response variant correlated by request id
+        cefMessageObject->SetValue("request",
+            CefV8Value::CreateFunction("request", new CefMessageRequestHandler()),
             V8_PROPERTY_ATTRIBUTE_NONE);
-
-        LOG_DEBUG_RENDER("🎯 Overlay object created with close method");
-    } else {
-        LOG_DEBUG_RENDER("🎯 NOT creating overlay object for URL: " + url);
-        LOG_DEBUG_RENDER("🎯 isMainBrowser: " + std::string(isMainBrowser ? "true" : "false"));
     }
 
-    // Create the address object
-    CefRefPtr<CefV8Value> addressObject = CefV8Value::CreateObject(nullptr, nullptr);
-    bitcoinBrowser->SetValue("address", addressObject, V8_PROPERTY_ATTRIBUTE_READONLY);
-
-    // Bind AddressHandler
-    CefRefPtr<AddressHandler> addressHandler = new AddressHandler();
-    addressObject->SetValue("generate",
-        CefV8Value::CreateFunction("generate", addressHandler),
-        V8_PROPERTY_ATTRIBUTE_NONE);
-
-    // Create the cefMessage object for process communication
-    CefRefPtr<CefV8Value> cefMessageObject = CefV8Value::CreateObject(nullptr, nullptr);
-    global->SetValue("cefMessage", cefMessageObject, V8_PROPERTY_ATTRIBUTE_READONLY);
-
-    // Create the send function for cefMessage
-    CefRefPtr<CefV8Value> sendFunction = CefV8Value::CreateFunction("send", new CefMessageSendHandler());
-    cefMessageObject->SetValue("send", sendFunction, V8_PROPERTY_ATTRIBUTE_NONE);
-
     // Register BRC-100 API
     BRC100Handler::RegisterBRC100API(context);
 
-    // For overlay browsers, signal that all systems are ready
-    if (isOverlayBrowser) {
-        std::string js = R"(
-            console.log("🎯 All systems ready - V8 context created, APIs injected");
-            // Set a flag that all systems are ready
-            window.allSystemsReady = true;
-            // Dispatch a custom event to signal all systems are ready
-            window.dispatchEvent(new CustomEvent('allSystemsReady'));
-            console.log("🎯 allSystemsReady event dispatched");
-        )";
-        frame->ExecuteJavaScript(js, frame->GetURL(), 0);
+    // Pull the browser's cached identity so identity.get() is answered locally
+    if (frame->IsMain()) {
+        frame->SendProcessMessage(PID_BROWSER, CefProcessMessage::Create("identity_sync"));
+        // And whether the session table is live, before validateSession answers from this process
+        frame->SendProcessMessage(PID_BROWSER, CefProcessMessage::Create("brc100_session_sync"));
+
+        // Lets TabLifecycle attribute renderer memory to tabs
+        CefRefPtr<CefProcessMessage> pidMessage = CefProcessMessage::Create("renderer_pid");
+        pidMessage->GetArgumentList()->SetInt(0, static_cast<int>(GetCurrentProcessId()));
+        frame->SendProcessMessage(PID_BROWSER, pidMessage);
+    }
 
-        LOG_DEBUG_RENDER("🎯 All systems ready - V8 context created, APIs injected");
+    // For overlay browsers, signal that all systems are ready. Page scripts have not run yet,
+    // so the flag alone is enough: nothing can be listening for an event at this point.
+    if (isOverlayBrowser) {
+        global->SetValue("allSystemsReady", CefV8Value::CreateBool(true), V8_PROPERTY_ATTRIBUTE_NONE);
+        LOG_DEBUG_RENDER("🎯 All systems ready - V8 context created, APIs bound");
     }
 }
 
-bool SimpleRenderProcessHandler::OnProcessMessageReceived(
+void SimpleRenderProcessHandler::OnContextReleased(
     CefRefPtr<CefBrowser> browser,
     CefRefPtr<CefFrame> frame,
-    CefProcessId source_process,
-    CefRefPtr<CefProcessMessage> message) {
+    CefRefPtr<CefV8Context> context) {
 
     CEF_REQUIRE_RENDERER_THREAD();
 
-    std::string message_name = message->GetName();
-    std::cout << "📨 Render process received message: " << message_name << std::endl;
-    std::cout << "🔍 Browser ID: " << browser->GetIdentifier() << std::endl;
-    std::cout << "🔍 Frame URL: " << frame->GetURL().ToString() << std::endl;
-    std::cout << "🔍 Source Process: " << source_process << std::endl;
+    // Drop RPC calls owned by the released context; late responses fall back to the legacy path
+    RendererRpc::DropContext(context);
 
-        if (message_name == "brc100_auth_request") {
-            CefRefPtr<CefListValue> args = message->GetArgumentList();
-            std::string domain = args->GetString(0);
-            std::string method = args->GetString(1);
-            std::string endpoint = args->GetString(2);
-            std::string body = args->GetString(3);
-
-            LOG_DEBUG_RENDER("🔐 BRC-100 auth request received: " + domain + " " + method + " " + endpoint);
-
-            // Send message to React component
-            std::string js = R"(
-                window.dispatchEvent(new MessageEvent('message', {
-                    data: {
-                        type: 'brc100_auth_request',
-                        payload: {
-                            domain: ')" + domain + R"(',
-                            method: ')" + method + R"(',
-                            endpoint: ')" + endpoint + R"(',
-                            body: ')" + body + R"('
-                        }
-                    }
-                }));
-            )";
-            frame->ExecuteJavaScript(js, frame->GetURL(), 0);
+    // Nobody is left to receive wallet pushes for this page
+    if (frame->IsMain()) {
+        frame->SendProcessMessage(PID_BROWSER, CefProcessMessage::Create("wallet_unsubscribe"));
+    }
+}
+
+void SimpleRenderProcessHandler::RegisterMessageRoutes() {
+    router_.Register("rpc_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                            CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefListValue> args = message->GetArgumentList();
+        int requestId = args->GetInt(0);
+        std::string responseName = args->GetString(1);
+        CefRefPtr<CefListValue> responseArgs = args->GetList(2);
+
+        if (RendererRpc::Complete(requestId, responseName, responseArgs)) {
             return true;
         }
 
-        if (message_name == "address_generate_response") {
-            CefRefPtr<CefListValue> args = message->GetArgumentList();
-            std::string addressDataJson = args->GetString(0);
+        // Caller's context is gone; replay through the legacy callback handlers
+        LOG_DEBUG_RENDER("⚠️ RPC response " + std::to_string(requestId) + " has no pending call, replaying " + responseName);
+        CefRefPtr<CefProcessMessage> inner = CefProcessMessage::Create(responseName);
+        if (responseArgs) {
+            CefRefPtr<CefListValue> innerArgs = inner->GetArgumentList();
+            for (size_t i = 0; i < responseArgs->GetSize(); i++) {
+                innerArgs->SetValue(i, responseArgs->GetValue(i)->Copy());
+            }
+        }
+        return OnProcessMessageReceived(browser, frame, source_process, inner);
+    });
+
+    // Snapshot from the browser's IdentityCache, sent on sync and whenever identity/health changes
+    router_.Register("identity_update", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                               CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        try {
+            IdentityHandler::UpdateCache(nlohmann::json::parse(message->GetArgumentList()->GetString(0).ToString()));
+        } catch (const std::exception& e) {
+            LOG_WARNING_RENDER("⚠️ Invalid identity_update payload: " + std::string(e.what()));
+        }
+        return true;
+    });
+
+    // Session table state and revoked or changed sessions, from the browser's BRC100SessionCache
+    router_.Register("brc100_session_update", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                     CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        try {
+            BRC100Handler::UpdateSessionCache(nlohmann::json::parse(message->GetArgumentList()->GetString(0).ToString()));
+        } catch (const std::exception& e) {
+            LOG_WARNING_RENDER("⚠️ Invalid brc100_session_update payload: " + std::string(e.what()));
+        }
+        return true;
+    });
+
+    // Changed wallet state for a topic this page subscribed to; payload is {topic, version, state}
+    router_.Register("wallet_state", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                            CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        std::string update = message->GetArgumentList()->GetString(0).ToString();
+        std::string js = "window.dispatchEvent(new MessageEvent('message', { data: { type: 'wallet_state', payload: " +
+                         update + " } }));";
+        frame->ExecuteJavaScript(js, frame->GetURL(), 0);
+        return true;
+    });
+
+    // Tab strip updates from TabManager; payload is the tab list as JSON
+    router_.Register("tabs_changed", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                            CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        std::string tabs = message->GetArgumentList()->GetString(0).ToString();
+        std::string js = "window.dispatchEvent(new MessageEvent('message', { data: { type: 'tabs_changed', payload: " +
+                         tabs + " } }));";
+        frame->ExecuteJavaScript(js, frame->GetURL(), 0);
+        return true;
+    });
+
+    // TabLifecycle is about to discard this tab; report the scroll offset so it can be restored
+    router_.Register("tab_capture_state", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                 CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        int scrollX = 0;
+        int scrollY = 0;
+        CefRefPtr<CefV8Context> context = frame->GetV8Context();
+        if (context && context->Enter()) {
+            CefRefPtr<CefV8Value> result;
+            CefRefPtr<CefV8Exception> exception;
+            if (context->Eval("[Math.round(window.scrollX), Math.round(window.scrollY)]", frame->GetURL(), 0, result, exception) &&
+                result && result->IsArray() && result->GetArrayLength() == 2) {
+                scrollX = result->GetValue(0)->GetIntValue();
+                scrollY = result->GetValue(1)->GetIntValue();
+            }
+            context->Exit();
+        }
 
-            std::cout << "✅ Address generation response received: " << addressDataJson << std::endl;
-            LOG_DEBUG_RENDER("✅ Address generation response received: " + addressDataJson);
+        CefRefPtr<CefProcessMessage> reply = CefProcessMessage::Create("tab_state");
+        reply->GetArgumentList()->SetInt(0, scrollX);
+        reply->GetArgumentList()->SetInt(1, scrollY);
+        frame->SendProcessMessage(PID_BROWSER, reply);
+        return true;
+    });
 
-            // Execute JavaScript to call the callback function directly
-            std::string js = "if (window.onAddressGenerated) { window.onAddressGenerated(" + addressDataJson + "); }";
-            frame->ExecuteJavaScript(js, frame->GetURL(), 0);
+    router_.Register("brc100_auth_request", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                   CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefListValue> args = message->GetArgumentList();
+        std::string domain = args->GetString(0);
+        std::string method = args->GetString(1);
+        std::string endpoint = args->GetString(2);
+        std::string body = args->GetString(3);
 
-            return true;
-        }
+        LOG_DEBUG_RENDER("🔐 BRC-100 auth request received: " + domain + " " + method + " " + endpoint);
 
-    if (message_name == "identity_status_check_response") {
+        // Send message to React component
+        std::string js = R"(
+            window.dispatchEvent(new MessageEvent('message', {
+                data: {
+                    type: 'brc100_auth_request',
+                    payload: {
+                        domain: ')" + domain + R"(',
+                        method: ')" + method + R"(',
+                        endpoint: ')" + endpoint + R"(',
+                        body: ')" + body + R"('
+                    }
+                }
+            }));
+        )";
+        frame->ExecuteJavaScript(js, frame->GetURL(), 0);
+        return true;
+    });
+
+    router_.Register("address_generate_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                         CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
+        CefRefPtr<CefListValue> args = message->GetArgumentList();
+        std::string addressDataJson = args->GetString(0);
+
+        std::cout << "✅ Address generation response received: " << addressDataJson << std::endl;
+        LOG_DEBUG_RENDER("✅ Address generation response received: " + addressDataJson);
+
+        // Execute JavaScript to call the callback function directly
+        std::string js = "if (window.onAddressGenerated) { window.onAddressGenerated(" + addressDataJson + "); }";
+        frame->ExecuteJavaScript(js, frame->GetURL(), 0);
+
+        return true;
+    });
+
+    router_.Register("identity_status_check_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                              CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string responseJson = args->GetString(0);
 
@@ -346,9 +419,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "create_identity_response") {
+    router_.Register("create_identity_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                        CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string responseJson = args->GetString(0);
 
@@ -361,9 +435,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "mark_identity_backed_up_response") {
+    router_.Register("mark_identity_backed_up_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                                CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string responseJson = args->GetString(0);
 
@@ -376,9 +451,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "address_generate_error") {
+    router_.Register("address_generate_error", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                      CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string errorMessage = args->GetString(0);
 
@@ -389,39 +465,11 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
     // Transaction Response Handlers
-
-        if (message_name == "address_generate_response") {
-            CefRefPtr<CefListValue> args = message->GetArgumentList();
-            std::string responseJson = args->GetString(0);
-
-            std::cout << "✅ Address generation response received: " << responseJson << std::endl;
-            LOG_DEBUG_RENDER("✅ Address generation response received: " + responseJson);
-
-            // Execute JavaScript to call the callback function directly
-            std::string js = "if (window.onAddressGenerated) { window.onAddressGenerated(" + responseJson + "); }";
-            frame->ExecuteJavaScript(js, frame->GetURL(), 0);
-
-            return true;
-        }
-
-        if (message_name == "address_generate_error") {
-            CefRefPtr<CefListValue> args = message->GetArgumentList();
-            std::string errorJson = args->GetString(0);
-
-            std::cout << "❌ Address generation error received: " << errorJson << std::endl;
-            LOG_DEBUG_RENDER("❌ Address generation error received: " + errorJson);
-
-            // Execute JavaScript to call the error callback function directly
-            std::string js = "if (window.onAddressError) { window.onAddressError(" + errorJson + "); }";
-            frame->ExecuteJavaScript(js, frame->GetURL(), 0);
-
-            return true;
-        }
-
-        if (message_name == "create_transaction_response") {
+    router_.Register("create_transaction_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                           CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string responseJson = args->GetString(0);
 
@@ -437,9 +485,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "create_transaction_error") {
+    router_.Register("create_transaction_error", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                        CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string errorMessage = args->GetString(0);
 
@@ -451,9 +500,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "sign_transaction_response") {
+    router_.Register("sign_transaction_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                         CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string responseJson = args->GetString(0);
 
@@ -469,9 +519,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "sign_transaction_error") {
+    router_.Register("sign_transaction_error", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                      CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string errorMessage = args->GetString(0);
 
@@ -485,9 +536,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "broadcast_transaction_response") {
+    router_.Register("broadcast_transaction_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                              CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string responseJson = args->GetString(0);
 
@@ -505,9 +557,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "broadcast_transaction_error") {
+    router_.Register("broadcast_transaction_error", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                           CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string errorMessage = args->GetString(0);
 
@@ -521,9 +574,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "send_transaction_response") {
+    router_.Register("send_transaction_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                         CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string responseJson = args->GetString(0);
 
@@ -537,9 +591,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "send_transaction_error") {
+    router_.Register("send_transaction_error", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                      CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string errorMessage = args->GetString(0);
 
@@ -553,9 +608,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "get_balance_response") {
+    router_.Register("get_balance_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                    CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string responseJson = args->GetString(0);
 
@@ -573,9 +629,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "get_balance_error") {
+    router_.Register("get_balance_error", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                 CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string errorMessage = args->GetString(0);
 
@@ -589,9 +646,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "get_transaction_history_response") {
+    router_.Register("get_transaction_history_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                                CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string responseJson = args->GetString(0);
 
@@ -609,9 +667,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "get_transaction_history_error") {
+    router_.Register("get_transaction_history_error", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                             CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string errorMessage = args->GetString(0);
 
@@ -625,11 +684,11 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
     // Wallet Response Handlers
-
-    if (message_name == "wallet_status_check_response") {
+    router_.Register("wallet_status_check_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                            CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string responseJson = args->GetString(0);
 
@@ -643,9 +702,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "create_wallet_response") {
+    router_.Register("create_wallet_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                      CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string responseJson = args->GetString(0);
 
@@ -659,9 +719,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "load_wallet_response") {
+    router_.Register("load_wallet_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                    CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string responseJson = args->GetString(0);
 
@@ -675,9 +736,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "get_wallet_info_response") {
+    router_.Register("get_wallet_info_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                        CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string responseJson = args->GetString(0);
 
@@ -691,9 +753,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "get_all_addresses_response") {
+    router_.Register("get_all_addresses_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                          CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string responseJson = args->GetString(0);
 
@@ -707,9 +770,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "get_current_address_response") {
+    router_.Register("get_current_address_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                            CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string responseJson = args->GetString(0);
 
@@ -723,9 +787,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "mark_wallet_backed_up_response") {
+    router_.Register("mark_wallet_backed_up_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                              CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string responseJson = args->GetString(0);
 
@@ -739,9 +804,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "get_addresses_response") {
+    router_.Register("get_addresses_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                      CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string responseJson = args->GetString(0);
 
@@ -755,9 +821,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "get_backup_modal_state_response") {
+    router_.Register("get_backup_modal_state_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                               CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string responseJson = args->GetString(0);
 
@@ -768,9 +835,10 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
 
-    if (message_name == "set_backup_modal_state_response") {
+    router_.Register("set_backup_modal_state_response", [this](CefRefPtr<CefBrowser> browser, CefRefPtr<CefFrame> frame,
+                                                               CefProcessId source_process, CefRefPtr<CefProcessMessage> message) -> bool {
         CefRefPtr<CefListValue> args = message->GetArgumentList();
         std::string responseJson = args->GetString(0);
 
@@ -781,7 +849,20 @@ bool SimpleRenderProcessHandler::OnProcessMessageReceived(
         frame->ExecuteJavaScript(js, frame->GetURL(), 0);
 
         return true;
-    }
+    });
+}
+
+bool SimpleRenderProcessHandler::OnProcessMessageReceived(
+    CefRefPtr<CefBrowser> browser,
+    CefRefPtr<CefFrame> frame,
+    CefProcessId source_process,
+    CefRefPtr<CefProcessMessage> message) {
+    CEF_REQUIRE_RENDERER_THREAD();
+
+    std::cout << "📨 Render process received message: " << message->GetName().ToString() << std::endl;
+    std::cout << "🔍 Browser ID: " << browser->GetIdentifier() << std::endl;
+    std::cout << "🔍 Frame URL: " << frame->GetURL().ToString() << std::endl;
+    std::cout << "🔍 Source Process: " << source_process << std::endl;
 
-    return false;
+    return router_.Dispatch(browser, frame, source_process, message);
 }
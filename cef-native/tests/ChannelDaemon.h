@@ -0,0 +1,224 @@
+#pragma once
+
+// The daemon's side of DaemonChannel for the channel test and benchmark, over the POSIX shared
+// memory object and semaphores DaemonChannel uses off Windows. The layout is written out again
+// from go-wallet/shm_channel_windows.go rather than taken from DaemonChannel.cpp, so a change to
+// the browser's side alone shows up as a failure. A test drives the rings by hand; StartEcho()
+// instead runs the daemon's loop, answering every request with its own payload.
+
+#include <fcntl.h>
+#include <semaphore.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <thread>
+
+namespace ChannelLayout {
+    const uint32_t kMagic = 0x43574242;     // "BBWC"
+    const uint32_t kVersion = 1;
+    const uint32_t kSlotCount = 256;
+    const uint32_t kSlotBytes = 4096;
+
+    const size_t kOffMagic = 0;
+    const size_t kOffVersion = 4;
+    const size_t kOffSlotCount = 8;
+    const size_t kOffSlotBytes = 12;
+    const size_t kOffRequestHead = 64;
+    const size_t kOffRequestTail = 128;
+    const size_t kOffAnswerHead = 192;
+    const size_t kOffAnswerTail = 256;
+    const size_t kOffDaemonWaiting = 320;
+    const size_t kOffBrowserWaiting = 384;
+    const size_t kOffDaemonReady = 448;
+    const size_t kOffSlots = 512;
+    const size_t kChannelBytes = kOffSlots + 2 * size_t(kSlotCount) * kSlotBytes;
+
+    const int kRequestRing = 0;
+    const int kAnswerRing = 1;
+
+    struct Frame {
+        uint32_t length;
+        uint32_t id;
+        uint16_t op;
+        uint16_t status;
+        uint32_t reserved;
+    };
+
+    const uint32_t kMaxPayload = kSlotBytes - sizeof(Frame);
+    const uint16_t kStatusTooLarge = 0xFFFF;
+}
+
+class ChannelDaemon {
+public:
+    // Creates the objects under a name of this process's own; the header stays empty and the
+    // daemon not ready until Ready()
+    ChannelDaemon() {
+        static std::atomic<int> instances{0};
+        name_ = "BabbageChannelTest." + std::to_string(getpid()) + "." + std::to_string(instances++);
+        Unlink();
+        int fd = shm_open(("/" + name_).c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0) {
+            return;
+        }
+        if (ftruncate(fd, ChannelLayout::kChannelBytes) == 0) {
+            void* view = mmap(nullptr, ChannelLayout::kChannelBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            view_ = view != MAP_FAILED ? static_cast<uint8_t*>(view) : nullptr;
+        }
+        close(fd);
+        requestEvent_ = sem_open(("/" + name_ + ".request").c_str(), O_CREAT | O_EXCL, 0600, 0);
+        answerEvent_ = sem_open(("/" + name_ + ".response").c_str(), O_CREAT | O_EXCL, 0600, 0);
+    }
+
+    ~ChannelDaemon() {
+        StopEcho();
+        if (view_) {
+            munmap(view_, ChannelLayout::kChannelBytes);
+        }
+        for (sem_t* semaphore : { requestEvent_, answerEvent_ }) {
+            if (semaphore != SEM_FAILED) {
+                sem_close(semaphore);
+            }
+        }
+        Unlink();
+    }
+
+    ChannelDaemon(const ChannelDaemon&) = delete;
+    ChannelDaemon& operator=(const ChannelDaemon&) = delete;
+
+    bool Ok() const { return view_ && requestEvent_ != SEM_FAILED && answerEvent_ != SEM_FAILED; }
+    std::wstring Name() const { return std::wstring(name_.begin(), name_.end()); }
+
+    std::atomic<uint32_t>* Word(size_t offset) {
+        return reinterpret_cast<std::atomic<uint32_t>*>(view_ + offset);
+    }
+
+    uint8_t* Slot(int ring, uint32_t index) {
+        return view_ + ChannelLayout::kOffSlots +
+               (size_t(ring) * ChannelLayout::kSlotCount + index % ChannelLayout::kSlotCount) * ChannelLayout::kSlotBytes;
+    }
+
+    // Writes the header the daemon writes at startup, then sets or clears its ready flag
+    void Ready(bool ready, uint32_t version = ChannelLayout::kVersion, uint32_t magic = ChannelLayout::kMagic) {
+        Word(ChannelLayout::kOffSlotCount)->store(ChannelLayout::kSlotCount);
+        Word(ChannelLayout::kOffSlotBytes)->store(ChannelLayout::kSlotBytes);
+        Word(ChannelLayout::kOffVersion)->store(version);
+        Word(ChannelLayout::kOffMagic)->store(magic);
+        Word(ChannelLayout::kOffDaemonReady)->store(ready ? 1 : 0);
+    }
+
+    // Hands the objects to another user, as one planted under the daemon's name would be; needs root
+    bool GiveTo(uid_t owner) {
+        int fd = shm_open(("/" + name_).c_str(), O_RDWR, 0);
+        bool given = fd >= 0 && fchown(fd, owner, owner) == 0;
+        if (fd >= 0) {
+            close(fd);
+        }
+        for (const char* event : { ".request", ".response" }) {
+            given = given && chown(("/dev/shm/sem." + name_ + event).c_str(), owner, owner) == 0;
+        }
+        return given;
+    }
+
+    ChannelLayout::Frame ReadRequest(uint32_t index, std::string& body) {
+        ChannelLayout::Frame frame;
+        const uint8_t* slot = Slot(ChannelLayout::kRequestRing, index);
+        std::memcpy(&frame, slot, sizeof(frame));
+        body.assign(reinterpret_cast<const char*>(slot + sizeof(frame)), (std::min)(frame.length, ChannelLayout::kMaxPayload));
+        return frame;
+    }
+
+    void WriteAnswer(uint32_t index, const ChannelLayout::Frame& frame, const std::string& body) {
+        uint8_t* slot = Slot(ChannelLayout::kAnswerRing, index);
+        std::memcpy(slot, &frame, sizeof(frame));
+        std::memcpy(slot + sizeof(frame), body.data(), body.size());
+    }
+
+    // Publishes how far requests have been read and answers written, waking the browser only if
+    // it said it was going to sleep
+    void Publish(uint32_t requestTail, uint32_t answerHead) {
+        Word(ChannelLayout::kOffRequestTail)->store(requestTail);
+        Word(ChannelLayout::kOffAnswerHead)->store(answerHead);
+        if (Word(ChannelLayout::kOffBrowserWaiting)->exchange(0) == 1) {
+            sem_post(answerEvent_);
+        }
+    }
+
+    // Whether the browser signalled the request event since the last look
+    bool TakeWakeup() {
+        return sem_trywait(requestEvent_) == 0;
+    }
+
+    void StartEcho() {
+        echoing_ = true;
+        echo_ = std::thread(&ChannelDaemon::Echo, this);
+    }
+
+    void StopEcho() {
+        if (echoing_.exchange(false)) {
+            sem_post(requestEvent_);
+            echo_.join();
+        }
+    }
+
+private:
+    void Unlink() {
+        shm_unlink(("/" + name_).c_str());
+        sem_unlink(("/" + name_ + ".request").c_str());
+        sem_unlink(("/" + name_ + ".response").c_str());
+    }
+
+    // The daemon's loop: everything published so far is answered before the browser is woken once
+    void Echo() {
+        uint32_t requestTail = Word(ChannelLayout::kOffRequestTail)->load();
+        uint32_t answerHead = Word(ChannelLayout::kOffAnswerHead)->load();
+        std::string body;
+        while (echoing_) {
+            uint32_t requestHead = Word(ChannelLayout::kOffRequestHead)->load();
+            if (requestHead == requestTail) {
+                WaitForRequests(requestTail);
+                continue;
+            }
+            for (; requestTail != requestHead; requestTail++) {
+                while (answerHead - Word(ChannelLayout::kOffAnswerTail)->load() >= ChannelLayout::kSlotCount) {
+                    Publish(requestTail, answerHead);
+                    std::this_thread::yield();
+                }
+                ChannelLayout::Frame frame = ReadRequest(requestTail, body);
+                frame.length = static_cast<uint32_t>(body.size());
+                frame.status = 200;
+                WriteAnswer(answerHead++, frame, body);
+            }
+            Publish(requestTail, answerHead);
+        }
+    }
+
+    void WaitForRequests(uint32_t requestTail) {
+        for (int i = 0; i < 2000; i++) {
+            if (Word(ChannelLayout::kOffRequestHead)->load() != requestTail) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+        Word(ChannelLayout::kOffDaemonWaiting)->store(1);
+        if (Word(ChannelLayout::kOffRequestHead)->load() == requestTail && echoing_) {
+            timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_sec += 1;
+            sem_timedwait(requestEvent_, &deadline);
+        }
+        Word(ChannelLayout::kOffDaemonWaiting)->store(0);
+    }
+
+    std::string name_;
+    uint8_t* view_ = nullptr;
+    sem_t* requestEvent_ = SEM_FAILED;
+    sem_t* answerEvent_ = SEM_FAILED;
+    std::atomic<bool> echoing_{false};
+    std::thread echo_;
+};
@@ -0,0 +1,237 @@
+#pragma once
+
+// A stand-in for the wallet daemon for the socket tests and benchmarks: listens on a Unix domain
+// socket in the temp directory (or on loopback TCP, for comparison) and serves each connection on
+// a thread of its own. respond sees every request and writes the raw response with send, so a
+// test decides exactly what comes back, down to how it is split and when the connection ends.
+// POSIX only, like the rest of this directory's socket code.
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class StubDaemon {
+public:
+    enum Transport { kUnixSocket, kTcp };
+
+    struct Request {
+        std::string method;
+        std::string target;
+        std::string body;
+    };
+
+    // Writes raw bytes to the connection; false once it has failed
+    using Send = std::function<bool(const std::string&)>;
+    // Returns false to close the connection after answering, true to keep it alive
+    using Respond = std::function<bool(const Request&, const Send&)>;
+
+    explicit StubDaemon(Respond respond, Transport transport = kUnixSocket) : respond_(std::move(respond)) {
+        if (transport == kUnixSocket) {
+            static std::atomic<int> instances{0};
+            path_ = "/tmp/stub-daemon-" + std::to_string(getpid()) + "-" + std::to_string(instances++) + ".sock";
+            unlink(path_.c_str());
+            sockaddr_un address = {};
+            address.sun_family = AF_UNIX;
+            std::memcpy(address.sun_path, path_.c_str(), path_.size());
+            listener_ = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (listener_ >= 0 && !Listen(reinterpret_cast<const sockaddr*>(&address), sizeof(address))) {
+                return;
+            }
+        } else {
+            sockaddr_in address = {};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            listener_ = socket(AF_INET, SOCK_STREAM, 0);
+            if (listener_ >= 0 && !Listen(reinterpret_cast<const sockaddr*>(&address), sizeof(address))) {
+                return;
+            }
+            socklen_t length = sizeof(address);
+            getsockname(listener_, reinterpret_cast<sockaddr*>(&address), &length);
+            port_ = ntohs(address.sin_port);
+        }
+        if (listener_ >= 0) {
+            acceptor_ = std::thread(&StubDaemon::Accept, this);
+        }
+    }
+
+    ~StubDaemon() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            for (int s : connections_) {
+                shutdown(s, SHUT_RDWR);
+            }
+        }
+        wake_.notify_all();
+        if (acceptor_.joinable()) {
+            acceptor_.join();
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [this]() { return connections_.empty(); });
+        if (listener_ >= 0) {
+            close(listener_);
+        }
+        if (!path_.empty()) {
+            unlink(path_.c_str());
+        }
+    }
+
+    StubDaemon(const StubDaemon&) = delete;
+    StubDaemon& operator=(const StubDaemon&) = delete;
+
+    bool Listening() const { return listener_ >= 0; }
+    const std::string& Path() const { return path_; }
+    int Port() const { return port_; }
+    // Connections accepted so far
+    size_t Accepted() const { return accepted_; }
+
+    // Sleeps for ms, or less if the stub is being destroyed; false then
+    bool Wait(uint64_t ms) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return !wake_.wait_for(lock, std::chrono::milliseconds(ms), [this]() { return stopping_; });
+    }
+
+    // A response with a Content-Length body
+    static std::string Answer(int status, const std::string& body, const std::string& headers = "") {
+        return "HTTP/1.1 " + std::to_string(status) + " OK\r\nContent-Type: application/json\r\n" + headers +
+               "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body;
+    }
+
+private:
+    bool Listen(const sockaddr* address, socklen_t length) {
+        if (bind(listener_, address, length) != 0 || listen(listener_, SOMAXCONN) != 0) {
+            close(listener_);
+            listener_ = -1;
+            return false;
+        }
+        return true;
+    }
+
+    void Accept() {
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (stopping_) {
+                    return;
+                }
+            }
+            // Polled, so shutting down does not depend on how a blocked accept() is woken
+            fd_set ready;
+            FD_ZERO(&ready);
+            FD_SET(listener_, &ready);
+            timeval wait = {0, 20 * 1000};
+            if (select(listener_ + 1, &ready, nullptr, nullptr, &wait) <= 0) {
+                continue;
+            }
+            int s = accept(listener_, nullptr, nullptr);
+            if (s < 0) {
+                continue;
+            }
+            if (port_ != 0) {
+                int on = 1;
+                setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                close(s);
+                return;
+            }
+            connections_.push_back(s);
+            accepted_++;
+            std::thread(&StubDaemon::Serve, this, s).detach();
+        }
+    }
+
+    void Close(int s) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connections_.erase(std::find(connections_.begin(), connections_.end(), s));
+        close(s);
+        wake_.notify_all();
+    }
+
+    // Reads one request: its head, then a Content-Length body
+    static bool ReadRequest(int s, std::string& buffer, Request& request) {
+        char chunk[64 * 1024];
+        size_t end;
+        while ((end = buffer.find("\r\n\r\n")) == std::string::npos) {
+            ssize_t n = recv(s, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                return false;
+            }
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+        std::string head = buffer.substr(0, end);
+        buffer.erase(0, end + 4);
+
+        size_t space = head.find(' ');
+        size_t secondSpace = head.find(' ', space + 1);
+        if (space == std::string::npos || secondSpace == std::string::npos) {
+            return false;
+        }
+        request.method = head.substr(0, space);
+        request.target = head.substr(space + 1, secondSpace - space - 1);
+
+        size_t contentLength = 0;
+        size_t header = head.find("Content-Length: ");
+        if (header != std::string::npos) {
+            contentLength = static_cast<size_t>(std::strtoull(head.c_str() + header + 16, nullptr, 10));
+        }
+        while (buffer.size() < contentLength) {
+            ssize_t n = recv(s, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                return false;
+            }
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+        request.body = buffer.substr(0, contentLength);
+        buffer.erase(0, contentLength);
+        return true;
+    }
+
+    void Serve(int s) {
+        Send send = [s](const std::string& data) {
+            size_t sent = 0;
+            while (sent < data.size()) {
+                ssize_t n = ::send(s, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+                if (n <= 0) {
+                    return false;
+                }
+                sent += static_cast<size_t>(n);
+            }
+            return true;
+        };
+        std::string buffer;
+        Request request;
+        while (ReadRequest(s, buffer, request) && respond_(request, send)) {
+        }
+        Close(s);
+    }
+
+    Respond respond_;
+    std::string path_;
+    int port_ = 0;
+    int listener_ = -1;
+    std::thread acceptor_;
+    std::atomic<size_t> accepted_{0};
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    // Open connections, each with a detached thread serving it
+    std::vector<int> connections_;
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+// Minimal checks and timing shared by the unit tests and benchmarks in this directory. Each test
+// is its own executable: CHECK records a failure and carries on, and main() returns
+// TestSupport::Result() so ctest sees a non-zero exit when anything failed.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace TestSupport {
+
+    inline int& Failures() {
+        static int failures = 0;
+        return failures;
+    }
+
+    inline int Result() {
+        if (Failures() == 0) {
+            std::printf("PASS\n");
+            return 0;
+        }
+        std::printf("FAIL (%d checks)\n", Failures());
+        return 1;
+    }
+
+    inline int64_t NowMicros() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // p in [0, 1] of unsorted samples; reorders them
+    inline double Percentile(std::vector<double>& samples, double p) {
+        if (samples.empty()) {
+            return 0.0;
+        }
+        size_t index = static_cast<size_t>(p * (samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return samples[index];
+    }
+
+    // Benchmarks take an optional first argument scaling their default sizes, so ctest can run
+    // them small as smoke tests while a manual run uses the full sizes
+    inline double Scale(int argc, char** argv) {
+        double scale = argc > 1 ? std::atof(argv[1]) : 1.0;
+        return scale > 0.0 ? scale : 1.0;
+    }
+}
+
+#define CHECK(condition)                                                                     \
+    do {                                                                                     \
+        if (!(condition)) {                                                                  \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition); \
+            TestSupport::Failures()++;                                                       \
+        }                                                                                    \
+    } while (0)
+
+#define CHECK_MSG(condition, message)                                                        \
+    do {                                                                                     \
+        if (!(condition)) {                                                                  \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s (%s)\n", __FILE__, __LINE__,       \
+                         #condition, std::string(message).c_str());                          \
+            TestSupport::Failures()++;                                                       \
+        }                                                                                    \
+    } while (0)
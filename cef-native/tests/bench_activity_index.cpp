@@ -0,0 +1,100 @@
+// Usage queries against a synthetic wallet activity journal.
+// Usage: bench_activity_index [scale]   (scale < 1 shortens the run; ctest uses 0.01)
+//
+// A year of wallet calls from a few hundred sites, a handful doing most of them, across two dozen
+// routes with one call in twenty failing. Queries mix the all-sites overview and single site
+// breakdowns over ranges from a day to the whole year, like the settings UI would.
+
+#include "ActivityIndex.h"
+#include "TestSupport.h"
+#include <cmath>
+#include <random>
+
+int main(int argc, char** argv) {
+    const double scale = TestSupport::Scale(argc, argv);
+    const size_t eventCount = (std::max)(static_cast<size_t>(1000), static_cast<size_t>(2000000 * scale));
+    const size_t queryCount = (std::max)(static_cast<size_t>(100), static_cast<size_t>(10000 * scale));
+
+    const size_t domainCount = 400;
+    const size_t routeCount = 24;
+    const int64_t dayMs = 24ll * 60 * 60 * 1000;
+    const int64_t spanMs = 365 * dayMs;
+    const int64_t rangesMs[] = { dayMs, 7 * dayMs, 30 * dayMs, spanMs };
+    // Same split as the journal: calls older than a week are kept per day
+    const int64_t hourlyRetentionMs = 7 * dayMs;
+
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    auto pickDomain = [&]() {
+        return static_cast<uint32_t>(domainCount * std::pow(unit(random), 3.0));
+    };
+
+    ActivityIndex index;
+    std::vector<std::string> domains;
+    for (size_t i = 0; i < domainCount; i++) {
+        uint32_t id = 0;
+        domains.push_back("app" + std::to_string(i) + ".example.com");
+        CHECK(index.InternDomain(domains.back(), id));
+    }
+    for (size_t i = 0; i < routeCount; i++) {
+        uint16_t id = 0;
+        CHECK(index.InternRoute("POST /wallet/route" + std::to_string(i), id));
+    }
+
+    const int64_t nowMs = 1700000000000ll;
+    const int64_t startMs = nowMs - spanMs;
+    int64_t buildStart = TestSupport::NowMicros();
+    for (size_t i = 0; i < eventCount; i++) {
+        ActivityIndex::Event event;
+        event.domain = pickDomain();
+        event.route = static_cast<uint16_t>(random() % routeCount);
+        event.outcome = unit(random) < 0.05 ? ActivityIndex::kHttpError : ActivityIndex::kOk;
+        event.timeMs = startMs + static_cast<int64_t>(spanMs * (static_cast<double>(i) / eventCount));
+        event.latencyMicros = static_cast<uint32_t>(2000 + random() % 60000);
+        event.bytesIn = static_cast<uint32_t>(random() % 2048);
+        event.bytesOut = static_cast<uint32_t>(random() % 8192);
+        index.Add(event);
+    }
+    index.Rollup(nowMs - hourlyRetentionMs);
+    double buildMs = (TestSupport::NowMicros() - buildStart) / 1000.0;
+    CHECK(index.EventCount() == eventCount);
+
+    int64_t snapshotStart = TestSupport::NowMicros();
+    std::string snapshot = index.Serialize();
+    ActivityIndex restored;
+    CHECK(restored.Restore(snapshot));
+    double snapshotMs = (TestSupport::NowMicros() - snapshotStart) / 1000.0;
+    CHECK(restored.EventCount() == index.EventCount());
+
+    // The whole year, from the restored copy, accounts for every call
+    nlohmann::json everything = restored.QueryDomains(startMs, nowMs + 1, domainCount);
+    CHECK(everything["total"]["calls"].get<uint64_t>() == eventCount);
+
+    std::vector<double> overviewMicros;
+    std::vector<double> domainMicros;
+    for (size_t i = 0; i < queryCount; i++) {
+        int64_t rangeMs = rangesMs[random() % (sizeof(rangesMs) / sizeof(rangesMs[0]))];
+        int64_t toMs = nowMs - static_cast<int64_t>((spanMs - (std::min)(rangeMs, spanMs)) * unit(random));
+        int64_t fromMs = toMs - rangeMs;
+
+        int64_t start = TestSupport::NowMicros();
+        if (i % 2 == 0) {
+            index.QueryDomains(fromMs, toMs, 50);
+            overviewMicros.push_back(static_cast<double>(TestSupport::NowMicros() - start));
+        } else {
+            index.QueryDomain(domains[pickDomain()], fromMs, toMs);
+            domainMicros.push_back(static_cast<double>(TestSupport::NowMicros() - start));
+        }
+    }
+
+    std::vector<double> all = overviewMicros;
+    all.insert(all.end(), domainMicros.begin(), domainMicros.end());
+    std::printf("calls %zu, sites %zu, index %zu KB, built in %.1f ms\n", static_cast<size_t>(index.EventCount()),
+                index.DomainCount(), index.MemoryBytes() / 1024, buildMs);
+    std::printf("snapshot %zu KB, round trip %.1f ms\n", snapshot.size() / 1024, snapshotMs);
+    std::printf("overview p50 %.1f us, p95 %.1f us; site p50 %.1f us, p95 %.1f us; all p99 %.1f us, max %.1f us\n",
+                TestSupport::Percentile(overviewMicros, 0.5), TestSupport::Percentile(overviewMicros, 0.95),
+                TestSupport::Percentile(domainMicros, 0.5), TestSupport::Percentile(domainMicros, 0.95),
+                TestSupport::Percentile(all, 0.99), TestSupport::Percentile(all, 1.0));
+    return TestSupport::Result();
+}
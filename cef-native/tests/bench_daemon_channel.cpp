@@ -0,0 +1,111 @@
+// Calls through DaemonChannel against the daemon's echo loop: the round trip of one call at a time,
+// wakeups included, then throughput with calls pipelined one per batch and in batches, the way
+// many tabs hitting the wallet at once look to the channel. Every answer is checked.
+// Usage: bench_daemon_channel [scale [batch-size]]   (scale < 1 shortens the run; ctest uses 0.01)
+
+#include "DaemonChannel.h"
+#include "ChannelDaemon.h"
+#include "TestSupport.h"
+
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+void Logger::Log(const std::string&, int, int) {}
+
+namespace {
+    const size_t kCalls = 1000000;
+    // The one-at-a-time phase measures nothing new past this
+    const size_t kLatencyCalls = 20000;
+
+    // A createHmac body of typical size, numbered so a misrouted answer is caught
+    std::string Body(size_t index) {
+        return "{\"message\":\"benchmark-" + std::to_string(index) + "\",\"key\":\"1BabbageBrowserBenchmarkKey000000\"}";
+    }
+}
+
+int main(int argc, char** argv) {
+    double scale = TestSupport::Scale(argc, argv);
+    size_t callCount = (std::max)(size_t(1000), static_cast<size_t>(kCalls * scale));
+    size_t batchSize = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 32;
+    batchSize = (std::max)(size_t(1), (std::min)(batchSize, size_t(ChannelLayout::kSlotCount)));
+
+    ChannelDaemon daemon;
+    daemon.Ready(true);
+    daemon.StartEcho();
+    DaemonChannel channel(daemon.Name());
+    channel.Start();
+    for (int i = 0; i < 200 && daemon.Ok() && !channel.Connected(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (!channel.Connected()) {
+        std::printf("could not set up a channel\n");
+        return 1;
+    }
+
+    // Every call must come back exactly once with its own payload
+    std::atomic<uint64_t> answered{0};
+    std::atomic<uint64_t> mismatched{0};
+    auto check = [&answered, &mismatched](size_t index) {
+        return [&answered, &mismatched, index](int status, std::string body) {
+            if (status != 200 || body != Body(index)) {
+                mismatched++;
+            }
+            answered++;
+        };
+    };
+
+    size_t latencyCalls = (std::min)(callCount, kLatencyCalls);
+    std::vector<double> micros;
+    micros.reserve(latencyCalls);
+    for (size_t i = 0; i < latencyCalls && channel.Connected(); i++) {
+        uint64_t before = answered.load();
+        int64_t start = TestSupport::NowMicros();
+        if (!channel.Submit(DaemonChannel::kCreateHmac, Body(i), check(i))) {
+            break;
+        }
+        while (answered.load() == before) {
+            std::this_thread::yield();
+        }
+        micros.push_back(static_cast<double>(TestSupport::NowMicros() - start));
+    }
+    CHECK(micros.size() == latencyCalls);
+
+    auto pipeline = [&](size_t batch) {
+        uint64_t base = answered.load();
+        size_t submitted = 0;
+        int64_t start = TestSupport::NowMicros();
+        while (answered.load() - base < callCount && channel.Connected()) {
+            size_t inFlight = submitted - static_cast<size_t>(answered.load() - base);
+            if (submitted < callCount && inFlight + batch <= ChannelLayout::kSlotCount) {
+                std::vector<DaemonChannel::Call> calls;
+                calls.reserve(batch);
+                for (size_t i = submitted; i < (std::min)(submitted + batch, callCount); i++) {
+                    calls.push_back({ DaemonChannel::kCreateHmac, Body(i), check(i) });
+                }
+                submitted += channel.SubmitBatch(calls);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        CHECK(answered.load() - base == callCount);
+        double seconds = (TestSupport::NowMicros() - start) / 1e6;
+        return seconds > 0 ? (answered.load() - base) / seconds : 0.0;
+    };
+    double unbatchedPerSecond = pipeline(1);
+    uint64_t wakeupsBefore = channel.GetStats()["daemonWakeups"];
+    double batchedPerSecond = pipeline(batchSize);
+    uint64_t batchedWakeups = channel.GetStats()["daemonWakeups"].get<uint64_t>() - wakeupsBefore;
+
+    std::printf("one at a time   p50 %6.1f us  p99 %6.1f us over %zu calls\n", TestSupport::Percentile(micros, 0.5),
+                TestSupport::Percentile(micros, 0.99), micros.size());
+    std::printf("unbatched       %10.0f calls/s\n", unbatchedPerSecond);
+    std::printf("batches of %-4zu %10.0f calls/s, %llu daemon wakeups for %zu calls\n", batchSize, batchedPerSecond,
+                static_cast<unsigned long long>(batchedWakeups), callCount);
+
+    CHECK(mismatched == 0);
+    CHECK(channel.GetStats()["timeouts"] == 0);
+    channel.Stop();
+    return TestSupport::Result();
+}
@@ -0,0 +1,172 @@
+// Reads from a daemon that stalls now and then and goes unanswering for a while, sent through
+// DaemonSocket once as they are and once through DaemonCircuitBreaker with hedging: latency
+// percentiles and outcomes of each run, and what the breaker did. The stub answers at once, except
+// that 2% of requests stall for 200 ms and nothing is answered during the outage, which starts a
+// quarter of the way in.
+// Usage: bench_daemon_resilience [scale [duration-ms outage-ms]]   (scale < 1 shortens the run; ctest uses 0.01)
+
+#include "DaemonResilience.h"
+#include "DaemonTransport.h"
+#include "StubDaemon.h"
+#include "TestSupport.h"
+#include <random>
+
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+void Logger::Log(const std::string&, int, int) {}
+
+namespace {
+    const uint64_t kDurationMs = 6000;
+    const uint64_t kOutageMs = 3000;
+    const uint64_t kStallMs = 200;
+    const int kReadIntervalMs = 5;
+    const DaemonRoutePolicy kPolicy = {250, true, false};
+
+    uint64_t NowMs() {
+        return static_cast<uint64_t>(TestSupport::NowMicros() / 1000);
+    }
+
+    struct Run {
+        std::vector<double> micros;
+        uint64_t outcomes[4] = {};
+    };
+
+    // The stub for one run; the outage starts and ends at fixed times from construction
+    class FaultyDaemon {
+    public:
+        FaultyDaemon(uint64_t durationMs, uint64_t outageMs)
+            : outageStartMs_(NowMs() + durationMs / 4), outageEndMs_(outageStartMs_ + outageMs),
+              stub_([this](const StubDaemon::Request&, const StubDaemon::Send& send) { return Respond(send); }) {}
+
+        const std::string& Path() const { return stub_.Path(); }
+        bool Listening() const { return stub_.Listening(); }
+
+    private:
+        bool Respond(const StubDaemon::Send& send) {
+            uint64_t now = NowMs();
+            bool stall;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stall = std::uniform_int_distribution<int>(0, 99)(random_) < 2;
+            }
+            if (now >= outageStartMs_ && now < outageEndMs_) {
+                if (!stub_.Wait(outageEndMs_ - now)) {
+                    return false;
+                }
+            } else if (stall && !stub_.Wait(kStallMs)) {
+                return false;
+            }
+            return send(StubDaemon::Answer(200, "{\"ok\":true}"));
+        }
+
+        uint64_t outageStartMs_;
+        uint64_t outageEndMs_;
+        std::mutex mutex_;
+        std::mt19937 random_{42};
+        StubDaemon stub_;
+    };
+
+    using Read = std::function<DaemonCircuitBreaker::Outcome()>;
+
+    Run Measure(uint64_t durationMs, const Read& read) {
+        Run run;
+        uint64_t endMs = NowMs() + durationMs;
+        while (NowMs() < endMs) {
+            int64_t start = TestSupport::NowMicros();
+            run.outcomes[static_cast<int>(read())]++;
+            run.micros.push_back(static_cast<double>(TestSupport::NowMicros() - start));
+            std::this_thread::sleep_for(std::chrono::milliseconds(kReadIntervalMs));
+        }
+        return run;
+    }
+
+    void Print(const char* name, Run& run) {
+        std::printf("%-9s p50 %8.1f ms  p99 %8.1f ms  max %8.1f ms  over %zu reads:", name,
+                    TestSupport::Percentile(run.micros, 0.5) / 1000, TestSupport::Percentile(run.micros, 0.99) / 1000,
+                    TestSupport::Percentile(run.micros, 1.0) / 1000, run.micros.size());
+        for (int o = 0; o < 4; o++) {
+            std::printf(" %s %llu", DaemonCircuitBreaker::OutcomeName(static_cast<DaemonCircuitBreaker::Outcome>(o)),
+                        static_cast<unsigned long long>(run.outcomes[o]));
+        }
+        std::printf("\n");
+    }
+}
+
+int main(int argc, char** argv) {
+    double scale = TestSupport::Scale(argc, argv);
+    uint64_t durationMs = argc > 3 ? std::strtoull(argv[2], nullptr, 10)
+                                   : (std::max)(uint64_t(100), static_cast<uint64_t>(kDurationMs * scale));
+    uint64_t outageMs = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : static_cast<uint64_t>(kOutageMs * scale);
+    std::printf("%llu ms of reads %d ms apart, %llu ms outage\n", static_cast<unsigned long long>(durationMs),
+                kReadIntervalMs, static_cast<unsigned long long>(outageMs));
+
+    // Plain: every read waits out its own timeout while the daemon is down
+    Run plain;
+    {
+        FaultyDaemon daemon(durationMs, outageMs);
+        CHECK(daemon.Listening());
+        DaemonSocket socket(daemon.Path());
+        plain = Measure(durationMs, [&socket]() {
+            int status = 0;
+            std::string body;
+            uint64_t startMs = NowMs();
+            if (socket.Request("GET", "/health", "", status, body, kPolicy.budgetMs) == DaemonSocket::Result::Ok) {
+                return DaemonCircuitBreaker::Outcome::Answered;
+            }
+            return NowMs() - startMs >= kPolicy.budgetMs ? DaemonCircuitBreaker::Outcome::TimedOut
+                                                         : DaemonCircuitBreaker::Outcome::Failed;
+        });
+    }
+
+    // Resilient: stalls are hedged over a connection of their own, and the outage fails fast
+    Run resilient;
+    DaemonCircuitBreaker breaker;
+    {
+        FaultyDaemon daemon(durationMs, outageMs);
+        CHECK(daemon.Listening());
+        std::string path = daemon.Path();
+        DaemonSocket socket(path);
+        resilient = Measure(durationMs, [&breaker, &socket, &path]() {
+            int status = 0;
+            std::string body;
+            return breaker.CallHedged(kPolicy,
+                [&socket](uint32_t timeoutMs, int& attemptStatus, std::string& attemptBody) {
+                    return socket.Request("GET", "/health", "", attemptStatus, attemptBody, timeoutMs) ==
+                           DaemonSocket::Result::Ok;
+                },
+                [&socket]() { socket.CancelRequest(); },
+                [&path]() -> DaemonCircuitBreaker::Attempt {
+                    auto hedgeSocket = std::make_shared<DaemonSocket>(path);
+                    return [hedgeSocket](uint32_t timeoutMs, int& attemptStatus, std::string& attemptBody) {
+                        return hedgeSocket->Request("GET", "/health", "", attemptStatus, attemptBody, timeoutMs) ==
+                               DaemonSocket::Result::Ok;
+                    };
+                }, status, body);
+        });
+        // Hedges abandoned at their deadline finish before the stub goes away
+        for (int i = 0; i < 100 && breaker.GetStats()["hedgesInFlight"] != 0; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    Print("plain", plain);
+    Print("resilient", resilient);
+    nlohmann::json stats = breaker.GetStats();
+    std::printf("breaker   trips %llu  hedges %llu  hedge wins %llu  capped %llu  retries %llu\n",
+                stats["trips"].get<unsigned long long>(), stats["hedges"].get<unsigned long long>(),
+                stats["hedgeWins"].get<unsigned long long>(), stats["hedgesCapped"].get<unsigned long long>(),
+                stats["retries"].get<unsigned long long>());
+    double plainP99 = TestSupport::Percentile(plain.micros, 0.99);
+    double resilientP99 = TestSupport::Percentile(resilient.micros, 0.99);
+    if (resilientP99 > 0) {
+        std::printf("p99 %.1fx lower with the breaker\n", plainP99 / resilientP99);
+    }
+
+    CHECK(!plain.micros.empty() && !resilient.micros.empty());
+    CHECK(plain.outcomes[static_cast<int>(DaemonCircuitBreaker::Outcome::Answered)] > 0);
+    CHECK(resilient.outcomes[static_cast<int>(DaemonCircuitBreaker::Outcome::Answered)] > 0);
+    return TestSupport::Result();
+}
@@ -0,0 +1,196 @@
+// UI call latency against a simulated daemon flooded by sites, once straight through and once
+// with a DaemonScheduler in front of it.
+// Usage: bench_daemon_scheduler [scale]   (scale < 1 shortens the run; ctest uses 0.01)
+
+#include "DaemonScheduler.h"
+#include "TestSupport.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace {
+    // Stands in for the daemon: a few workers taking calls in arrival order, each busy for a fixed
+    // time, as the Go daemon is for a wallet query
+    class SimulatedDaemon {
+    public:
+        static const size_t kWorkers = 2;
+        static const uint64_t kServiceUs = 500;
+
+        SimulatedDaemon() {
+            for (size_t i = 0; i < kWorkers; i++) {
+                workers_.emplace_back(&SimulatedDaemon::Work, this);
+            }
+        }
+
+        ~SimulatedDaemon() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            ready_.notify_all();
+            for (std::thread& worker : workers_) {
+                worker.join();
+            }
+        }
+
+        // done runs on a worker once the call has been served; calls still queued when the
+        // daemon goes away are dropped
+        void Call(std::function<void()> done) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (stopping_) {
+                    return;
+                }
+                calls_.push_back(std::move(done));
+            }
+            ready_.notify_one();
+        }
+
+        static double CallsPerSecond() { return kWorkers * 1e6 / kServiceUs; }
+
+    private:
+        void Work() {
+            for (;;) {
+                std::function<void()> done;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    ready_.wait(lock, [this]() { return stopping_ || !calls_.empty(); });
+                    if (stopping_) {
+                        return;
+                    }
+                    done = std::move(calls_.front());
+                    calls_.pop_front();
+                }
+                // Busy rather than asleep: a sleep this short rounds up to the timer tick
+                uint64_t until = static_cast<uint64_t>(TestSupport::NowMicros()) + kServiceUs;
+                while (static_cast<uint64_t>(TestSupport::NowMicros()) < until) {
+                }
+                done();
+            }
+        }
+
+        std::mutex mutex_;
+        std::condition_variable ready_;
+        std::deque<std::function<void()>> calls_;
+        bool stopping_ = false;
+        std::vector<std::thread> workers_;
+    };
+
+    // One run: sites flood the daemon at twice what it can serve while the UI makes a call every
+    // 20 ms and waits for each answer
+    nlohmann::json FloodRun(DaemonScheduler* scheduler, size_t floodDomains, size_t durationMs) {
+        std::vector<double> uiMicros;
+        std::atomic<uint64_t> offered{0};
+        std::atomic<uint64_t> served{0};
+        std::atomic<uint64_t> shed{0};
+        std::atomic<bool> flooding{true};
+        {
+            SimulatedDaemon daemon;
+            double perDomainPerSecond = 2 * SimulatedDaemon::CallsPerSecond() / floodDomains;
+
+            std::vector<std::thread> floods;
+            for (size_t d = 0; d < floodDomains; d++) {
+                floods.emplace_back([&, d]() {
+                    std::string domain = "flood" + std::to_string(d) + ".example";
+                    uint64_t startUs = static_cast<uint64_t>(TestSupport::NowMicros());
+                    uint64_t sent = 0;
+                    while (flooding) {
+                        // Open loop: catch up to the target rate whatever the timer tick
+                        uint64_t due = static_cast<uint64_t>((static_cast<uint64_t>(TestSupport::NowMicros()) - startUs) / 1e6 * perDomainPerSecond);
+                        for (; sent < due; sent++) {
+                            offered++;
+                            if (!scheduler) {
+                                daemon.Call([&served]() { served++; });
+                                continue;
+                            }
+                            scheduler->Submit(DaemonScheduler::kDapp, domain, [&, scheduler](DaemonScheduler::Verdict verdict) {
+                                if (verdict != DaemonScheduler::kAdmitted) {
+                                    shed++;
+                                    return;
+                                }
+                                daemon.Call([&served, scheduler]() {
+                                    served++;
+                                    scheduler->Release(DaemonScheduler::kDapp);
+                                });
+                            });
+                        }
+                        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                    }
+                });
+            }
+
+            uint64_t endUs = static_cast<uint64_t>(TestSupport::NowMicros()) + durationMs * 1000;
+            while (static_cast<uint64_t>(TestSupport::NowMicros()) < endUs) {
+                uint64_t startedUs = static_cast<uint64_t>(TestSupport::NowMicros());
+                bool admitted = !scheduler || scheduler->Acquire(DaemonScheduler::kUi, "") == DaemonScheduler::kAdmitted;
+                if (admitted) {
+                    std::mutex mutex;
+                    std::condition_variable answered;
+                    bool done = false;
+                    daemon.Call([&]() {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        done = true;
+                        answered.notify_one();
+                    });
+                    std::unique_lock<std::mutex> lock(mutex);
+                    // A call still queued at the end of the run counts as waiting until then
+                    answered.wait_until(lock, std::chrono::steady_clock::now() +
+                                        std::chrono::microseconds(endUs > static_cast<uint64_t>(TestSupport::NowMicros()) ? endUs - static_cast<uint64_t>(TestSupport::NowMicros()) : 0),
+                                        [&done]() { return done; });
+                    lock.unlock();
+                    if (scheduler) {
+                        scheduler->Release(DaemonScheduler::kUi);
+                    }
+                    uiMicros.push_back(static_cast<double>(static_cast<uint64_t>(TestSupport::NowMicros()) - startedUs));
+                    if (!done) {
+                        // The daemon is torn down before this frame goes, taking the call with it
+                        break;
+                    }
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+
+            flooding = false;
+            for (std::thread& flood : floods) {
+                flood.join();
+            }
+        }
+
+        double seconds = durationMs / 1000.0;
+        return {
+            {"uiCalls", uiMicros.size()},
+            {"uiP50Micros", TestSupport::Percentile(uiMicros, 0.5)},
+            {"uiP99Micros", TestSupport::Percentile(uiMicros, 0.99)},
+            {"siteCallsOffered", offered.load()},
+            {"siteCallsServedPerSecond", served.load() / seconds},
+            {"siteCallsShed", shed.load()}
+        };
+    }
+}
+
+int main(int argc, char** argv) {
+    const double scale = TestSupport::Scale(argc, argv);
+    const size_t floodDomains = 4;
+    const size_t durationMs = (std::max)(static_cast<size_t>(200), static_cast<size_t>(5000 * scale));
+
+    nlohmann::json unscheduled = FloodRun(nullptr, floodDomains, durationMs);
+    DaemonScheduler scheduler;
+    nlohmann::json scheduled = FloodRun(&scheduler, floodDomains, durationMs);
+    CHECK(scheduled["uiCalls"].get<size_t>() > 0);
+    CHECK(scheduler.GetStats()["classes"]["ui"]["inFlight"] == 0);
+
+    std::printf("%zu sites offering %.0f calls/s to a daemon serving %.0f, %zu ms per run\n", floodDomains,
+                2 * SimulatedDaemon::CallsPerSecond(), SimulatedDaemon::CallsPerSecond(), durationMs);
+    std::printf("%-12s %8s %12s %12s %14s %10s\n", "", "ui calls", "ui p50 us", "ui p99 us", "site served/s", "site shed");
+    for (const auto& run : { std::make_pair("unscheduled", &unscheduled), std::make_pair("scheduled", &scheduled) }) {
+        const nlohmann::json& r = *run.second;
+        std::printf("%-12s %8zu %12.0f %12.0f %14.0f %10llu\n", run.first, r["uiCalls"].get<size_t>(),
+                    r["uiP50Micros"].get<double>(), r["uiP99Micros"].get<double>(),
+                    r["siteCallsServedPerSecond"].get<double>(),
+                    static_cast<unsigned long long>(r["siteCallsShed"].get<uint64_t>()));
+    }
+    return TestSupport::Result();
+}
@@ -0,0 +1,166 @@
+// Daemon round trips over the Unix domain socket, through DaemonSocket, against the same over a
+// kept-alive loopback TCP connection: latency of empty requests and throughput of large ones.
+// Runs against stub daemons serving /transport/bench?bytes=N as a benchmark build of the daemon
+// does (go build -tags benchmark), or against such a daemon when given its socket and TCP port.
+// Usage: bench_daemon_transport [scale [socket-path tcp-port]]   (ctest uses 0.01)
+
+#include "DaemonTransport.h"
+#include "StubDaemon.h"
+#include "TestSupport.h"
+#include <arpa/inet.h>
+
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+void Logger::Log(const std::string&, int, int) {}
+
+namespace {
+    const size_t kRequests = 2000;
+    const size_t kPayloadBytes = 1 << 20;
+
+    using Get = std::function<bool(const std::string& endpoint, std::string& body)>;
+
+    bool Respond(const StubDaemon::Request& request, const StubDaemon::Send& send) {
+        size_t bytes = std::strtoull(request.target.c_str() + request.target.find('=') + 1, nullptr, 10);
+        return send(StubDaemon::Answer(200, "{\"payload\":\"" + std::string(bytes, 'x') + "\"}"));
+    }
+
+    // A kept-alive HTTP/1.1 client over loopback TCP, for the answers above and the daemon's,
+    // which both carry a Content-Length
+    class TcpClient {
+    public:
+        explicit TcpClient(int port) {
+            sockaddr_in address = {};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(static_cast<uint16_t>(port));
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            socket_ = socket(AF_INET, SOCK_STREAM, 0);
+            if (socket_ >= 0 && connect(socket_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+                close(socket_);
+                socket_ = -1;
+            }
+            int on = 1;
+            setsockopt(socket_, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        }
+
+        ~TcpClient() {
+            if (socket_ >= 0) {
+                close(socket_);
+            }
+        }
+
+        bool Get(const std::string& endpoint, std::string& body) {
+            std::string request = "GET " + endpoint + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+            if (socket_ < 0 || send(socket_, request.data(), request.size(), MSG_NOSIGNAL) != static_cast<ssize_t>(request.size())) {
+                return false;
+            }
+            size_t end;
+            while ((end = buffer_.find("\r\n\r\n")) == std::string::npos) {
+                if (!Fill()) {
+                    return false;
+                }
+            }
+            size_t header = buffer_.find("Content-Length: ");
+            if (buffer_.compare(0, 12, "HTTP/1.1 200") != 0 || header == std::string::npos || header > end) {
+                return false;
+            }
+            size_t length = std::strtoull(buffer_.c_str() + header + 16, nullptr, 10);
+            buffer_.erase(0, end + 4);
+            while (buffer_.size() < length) {
+                if (!Fill()) {
+                    return false;
+                }
+            }
+            body.assign(buffer_, 0, length);
+            buffer_.erase(0, length);
+            return true;
+        }
+
+    private:
+        bool Fill() {
+            char chunk[64 * 1024];
+            ssize_t n = recv(socket_, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                return false;
+            }
+            buffer_.append(chunk, static_cast<size_t>(n));
+            return true;
+        }
+
+        int socket_ = -1;
+        std::string buffer_;
+    };
+
+    // Latency of requestCount empty round trips and throughput of a few payloadBytes transfers
+    void Measure(const char* name, const Get& get, size_t requestCount, size_t payloadBytes) {
+        std::string body;
+        // Connection setup and the daemon's first-request costs stay out of the numbers
+        for (int i = 0; i < 20; i++) {
+            if (!get("/transport/bench?bytes=0", body)) {
+                std::printf("%-7s unavailable\n", name);
+                TestSupport::Failures()++;
+                return;
+            }
+        }
+
+        std::vector<double> micros;
+        for (size_t i = 0; i < requestCount; i++) {
+            int64_t start = TestSupport::NowMicros();
+            CHECK(get("/transport/bench?bytes=0", body) && body == "{\"payload\":\"\"}");
+            micros.push_back(static_cast<double>(TestSupport::NowMicros() - start));
+        }
+
+        // At least 64 MB moved in total, so the rate is not dominated by per-request overhead
+        size_t transfers = (std::min)((std::max)(size_t(4), (size_t(64) << 20) / (std::max)(payloadBytes, size_t(1))),
+                                      requestCount);
+        std::string endpoint = "/transport/bench?bytes=" + std::to_string(payloadBytes);
+        uint64_t bytes = 0;
+        int64_t start = TestSupport::NowMicros();
+        for (size_t i = 0; i < transfers; i++) {
+            CHECK(get(endpoint, body) && body.size() == payloadBytes + 14);
+            bytes += body.size();
+        }
+        double seconds = (TestSupport::NowMicros() - start) / 1e6;
+
+        std::printf("%-7s p50 %7.1f us  p95 %7.1f us  p99 %7.1f us  %8.1f MB/s over %zu transfers\n", name,
+                    TestSupport::Percentile(micros, 0.5), TestSupport::Percentile(micros, 0.95),
+                    TestSupport::Percentile(micros, 0.99), seconds > 0 ? bytes / (1024.0 * 1024.0) / seconds : 0.0,
+                    transfers);
+    }
+}
+
+int main(int argc, char** argv) {
+    double scale = TestSupport::Scale(argc, argv);
+    size_t requestCount = (std::max)(size_t(20), static_cast<size_t>(kRequests * scale));
+    size_t payloadBytes = (std::max)(size_t(1024), static_cast<size_t>(kPayloadBytes * scale));
+    std::printf("%zu requests, %zu byte payloads\n", requestCount, payloadBytes);
+
+    std::unique_ptr<StubDaemon> socketStub;
+    std::unique_ptr<StubDaemon> tcpStub;
+    std::string socketPath;
+    int tcpPort;
+    if (argc > 3) {
+        socketPath = argv[2];
+        tcpPort = std::atoi(argv[3]);
+    } else {
+        socketStub.reset(new StubDaemon(Respond));
+        tcpStub.reset(new StubDaemon(Respond, StubDaemon::kTcp));
+        socketPath = socketStub->Path();
+        tcpPort = tcpStub->Port();
+    }
+
+    DaemonSocket socket(socketPath);
+    Measure("socket", [&socket](const std::string& endpoint, std::string& body) {
+        int status = 0;
+        return socket.Request("GET", endpoint, "", status, body) == DaemonSocket::Result::Ok && status == 200;
+    }, requestCount, payloadBytes);
+
+    TcpClient tcp(tcpPort);
+    Measure("tcp", [&tcp](const std::string& endpoint, std::string& body) {
+        return tcp.Get(endpoint, body);
+    }, requestCount, payloadBytes);
+
+    return TestSupport::Result();
+}
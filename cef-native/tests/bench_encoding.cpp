@@ -0,0 +1,61 @@
+// Hex and base64 throughput per implementation on 1 KB to 10 MB payloads.
+// Usage: bench_encoding [scale]   (scale < 1 shortens the run; ctest uses 0.01)
+
+#include "Encoding.h"
+#include "TestSupport.h"
+#include <random>
+
+namespace {
+    // Best of several passes, in MB/s of decoded bytes
+    template <typename Fn>
+    double Throughput(size_t bytes, size_t iterations, Fn fn) {
+        double best = 0.0;
+        for (int pass = 0; pass < 3; pass++) {
+            int64_t start = TestSupport::NowMicros();
+            for (size_t i = 0; i < iterations; i++) {
+                fn();
+            }
+            double seconds = (TestSupport::NowMicros() - start) / 1e6;
+            if (seconds > 0) {
+                best = (std::max)(best, bytes * static_cast<double>(iterations) / seconds / 1e6);
+            }
+        }
+        return best;
+    }
+}
+
+int main(int argc, char** argv) {
+    const double scale = TestSupport::Scale(argc, argv);
+    const size_t sizes[] = { 1 << 10, 16 << 10, 256 << 10, 1 << 20, 10 << 20 };
+
+    std::mt19937 random(3);
+    std::printf("%-7s %10s %12s %12s %12s %12s\n", "impl", "bytes", "hex enc", "hex dec", "b64 enc", "b64 dec");
+    for (const char* implementation : { "scalar", "ssse3", "avx2" }) {
+        if (!Encoding::forceImplementation(implementation)) {
+            continue;
+        }
+        for (size_t size : sizes) {
+            std::string bytes(size, '\0');
+            for (char& c : bytes) {
+                c = static_cast<char>(random() & 0xff);
+            }
+            // Roughly 64 MB through each codec per size at full scale
+            size_t iterations = (std::max)(static_cast<size_t>(1), static_cast<size_t>((64 << 20) * scale / size));
+
+            const std::string hex = Encoding::hexEncode(bytes);
+            const std::string base64 = Encoding::base64Encode(bytes);
+            std::string decoded;
+            CHECK(Encoding::hexDecode(hex, decoded) && decoded == bytes);
+            CHECK(Encoding::base64Decode(base64, decoded) && decoded == bytes);
+
+            double hexEncode = Throughput(size, iterations, [&] { Encoding::hexEncode(bytes); });
+            double hexDecode = Throughput(size, iterations, [&] { Encoding::hexDecode(hex, decoded); });
+            double base64Encode = Throughput(size, iterations, [&] { Encoding::base64Encode(bytes); });
+            double base64Decode = Throughput(size, iterations, [&] { Encoding::base64Decode(base64, decoded); });
+            std::printf("%-7s %10zu %9.0f MB/s %7.0f MB/s %7.0f MB/s %7.0f MB/s\n", implementation, size,
+                        hexEncode, hexDecode, base64Encode, base64Decode);
+        }
+    }
+    Encoding::forceImplementation("auto");
+    return TestSupport::Result();
+}
@@ -0,0 +1,97 @@
+// Address bar suggestion queries against a synthetic browsing history.
+// Usage: bench_history_index [scale]   (scale < 1 shortens the run; ctest uses 0.01)
+//
+// A Zipf-like history: a few hosts get most visits, each host has a dozen pages, visits spread
+// over six months with one in twenty typed. Queries are key prefixes of one to ten characters
+// plus some title words, like a user typing into the address bar.
+
+#include "HistoryIndex.h"
+#include "TestSupport.h"
+#include <cmath>
+#include <random>
+
+int main(int argc, char** argv) {
+    const double scale = TestSupport::Scale(argc, argv);
+    const size_t visitCount = (std::max)(static_cast<size_t>(1000), static_cast<size_t>(1000000 * scale));
+    const size_t queryCount = (std::max)(static_cast<size_t>(100), static_cast<size_t>(10000 * scale));
+
+    static const char* kSyllables[] = {
+        "ba", "be", "bit", "co", "da", "de", "fi", "go", "ha", "in", "ka", "lo", "ma", "me", "net",
+        "no", "pa", "pro", "ra", "re", "sa", "shop", "so", "ta", "te", "to", "un", "va", "web", "zo"
+    };
+    static const char* kTlds[] = { ".com", ".org", ".net", ".io", ".co.uk", ".app" };
+    static const char* kWords[] = {
+        "news", "wallet", "blocks", "explorer", "market", "docs", "blog", "forum", "search", "video",
+        "account", "settings", "profile", "payments", "tokens", "guide", "help", "store"
+    };
+    const size_t syllableCount = sizeof(kSyllables) / sizeof(kSyllables[0]);
+    const size_t wordCount = sizeof(kWords) / sizeof(kWords[0]);
+    const size_t pagesPerHost = 12;
+    const int64_t spanMs = 180ll * 24 * 60 * 60 * 1000;
+
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    size_t hostCount = (std::max)(visitCount / 50, static_cast<size_t>(100));
+    std::vector<std::string> hosts;
+    hosts.reserve(hostCount);
+    for (size_t i = 0; i < hostCount; i++) {
+        std::string host = unit(random) < 0.3 ? "www." : "";
+        size_t syllables = 2 + random() % 3;
+        for (size_t s = 0; s < syllables; s++) {
+            host += kSyllables[random() % syllableCount];
+        }
+        host += std::to_string(i % 97) + kTlds[random() % (sizeof(kTlds) / sizeof(kTlds[0]))];
+        hosts.push_back(host);
+    }
+
+    const int64_t nowMs = 1700000000000ll;
+    HistoryIndex index;
+    int64_t buildStart = TestSupport::NowMicros();
+    index.BeginBulk();
+    for (size_t i = 0; i < visitCount; i++) {
+        size_t host = static_cast<size_t>(hostCount * std::pow(unit(random), 3.0));
+        size_t page = random() % pagesPerHost;
+        std::string url = "https://" + hosts[host] + "/" + kWords[(host + page) % wordCount] +
+                          "/" + std::to_string(page);
+        int64_t timeMs = nowMs - static_cast<int64_t>(spanMs * unit(random) * unit(random));
+        index.AddVisit(url, timeMs, unit(random) < 0.05);
+        if (i % 7 == 0) {
+            index.SetTitle(url, std::string(kWords[page % wordCount]) + " - " + hosts[host]);
+        }
+    }
+    index.EndBulk(nowMs);
+    double buildMs = (TestSupport::NowMicros() - buildStart) / 1000.0;
+    CHECK(index.VisitCount() == visitCount);
+
+    const std::vector<HistoryIndex::Entry>& entries = index.Entries();
+    std::vector<double> micros;
+    micros.reserve(queryCount);
+    uint64_t results = 0;
+    for (size_t i = 0; i < queryCount && !entries.empty(); i++) {
+        const HistoryIndex::Entry& entry = entries[random() % entries.size()];
+        std::string query;
+        if (i % 5 == 4 && !entry.title.empty()) {
+            // The start of the title's first word, as typed to find a page by name
+            std::string word = entry.title.substr(0, entry.title.find(' '));
+            query = word.substr(0, 3 + random() % 3);
+        } else {
+            query = entry.key.substr(0, 1 + random() % 10);
+        }
+
+        int64_t start = TestSupport::NowMicros();
+        size_t found = index.Query(query, 8, nowMs).size();
+        micros.push_back(static_cast<double>(TestSupport::NowMicros() - start));
+        // Every query is cut from an indexed entry, so something always matches
+        CHECK_MSG(found > 0, query);
+        results += found;
+    }
+
+    std::printf("visits %zu, urls %zu, index %zu KB, built in %.1f ms\n", static_cast<size_t>(index.VisitCount()),
+                entries.size(), index.MemoryBytes() / 1024, buildMs);
+    std::printf("queries %zu, avg results %.2f, p50 %.1f us, p95 %.1f us, p99 %.1f us, max %.1f us\n",
+                micros.size(), micros.empty() ? 0.0 : static_cast<double>(results) / micros.size(),
+                TestSupport::Percentile(micros, 0.5), TestSupport::Percentile(micros, 0.95),
+                TestSupport::Percentile(micros, 0.99), TestSupport::Percentile(micros, 1.0));
+    return TestSupport::Result();
+}
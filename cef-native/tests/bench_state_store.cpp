@@ -0,0 +1,100 @@
+// StateStore commit throughput and latency, recovery time, and commit latency while a compaction
+// rewrites the log on another thread.
+// Usage: bench_state_store [scale]   (scale < 1 shortens the run; ctest uses 0.01)
+
+#include "StateStore.h"
+#include "TestSupport.h"
+#include "include/cef_task.h"
+#include <atomic>
+#include <filesystem>
+#include <thread>
+
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+void Logger::Log(const std::string&, int, int) {}
+
+namespace fs = std::filesystem;
+
+namespace {
+    StateStore& Store() {
+        return StateStore::GetInstance();
+    }
+
+    void Commits(const char* label, size_t count, size_t valueBytes, bool durable) {
+        std::string value(valueBytes, 'v');
+        std::vector<double> micros;
+        micros.reserve(count);
+        int64_t start = TestSupport::NowMicros();
+        for (size_t i = 0; i < count; i++) {
+            int64_t before = TestSupport::NowMicros();
+            CHECK(Store().Put("bench/" + std::to_string(i % 1000), value, durable));
+            micros.push_back(static_cast<double>(TestSupport::NowMicros() - before));
+            // Compactions triggered along the way run inline, as the file thread would
+            FakeCefTasks::RunAll();
+        }
+        double seconds = (TestSupport::NowMicros() - start) / 1e6;
+        std::printf("%-24s %8zu commits %10.0f /s   p50 %7.1f us   p99 %7.1f us\n", label, count,
+                    seconds > 0 ? count / seconds : 0.0, TestSupport::Percentile(micros, 0.5),
+                    TestSupport::Percentile(micros, 0.99));
+    }
+}
+
+int main(int argc, char** argv) {
+    const double scale = TestSupport::Scale(argc, argv);
+    auto scaled = [&](size_t n) { return (std::max)(static_cast<size_t>(10), static_cast<size_t>(n * scale)); };
+
+    fs::path directory = fs::temp_directory_path() / "state_store_bench";
+    fs::remove_all(directory);
+    CHECK(Store().Open(directory.wstring()));
+
+    Commits("buffered 64 B", scaled(100000), 64, false);
+    Commits("buffered 4 KB", scaled(20000), 4096, false);
+    Commits("durable 64 B", scaled(2000), 64, true);
+
+    // Recovery replays every batch still in the log
+    for (size_t i = 0; i < scaled(50000); i++) {
+        Store().Put("recover/" + std::to_string(i), std::string(100, 'r'), false);
+    }
+    FakeCefTasks::RunAll();
+    Store().Close();
+    int64_t openStart = TestSupport::NowMicros();
+    CHECK(Store().Open(directory.wstring()));
+    nlohmann::json stats = Store().GetStats();
+    std::printf("recovery: %llu keys, %llu log bytes in %.1f ms\n",
+                static_cast<unsigned long long>(stats["keys"].get<uint64_t>()),
+                static_cast<unsigned long long>(stats["logBytes"].get<uint64_t>()),
+                (TestSupport::NowMicros() - openStart) / 1000.0);
+
+    // Overwrite until a compaction is due, then commit from this thread while it runs on another
+    std::string value(1000, 'c');
+    for (size_t i = 0; FakeCefTasks::Pending() == 0; i++) {
+        Store().Put("recover/" + std::to_string(i % 5000), value, false);
+    }
+    FakeCefTasks::Posted compaction;
+    CHECK(FakeCefTasks::Take(compaction));
+    std::atomic<bool> done{false};
+    int64_t compactStart = TestSupport::NowMicros();
+    std::thread fileThread([&] {
+        compaction.run();
+        done = true;
+    });
+    std::vector<double> micros;
+    while (!done) {
+        int64_t before = TestSupport::NowMicros();
+        Store().Put("during/" + std::to_string(micros.size()), "x", false);
+        micros.push_back(static_cast<double>(TestSupport::NowMicros() - before));
+    }
+    fileThread.join();
+    stats = Store().GetStats();
+    std::printf("compaction: %.1f ms, %llu bytes reclaimed; %zu commits meanwhile, p99 %.1f us, max %.1f us\n",
+                (TestSupport::NowMicros() - compactStart) / 1000.0,
+                static_cast<unsigned long long>(stats["bytesReclaimed"].get<uint64_t>()), micros.size(),
+                TestSupport::Percentile(micros, 0.99), TestSupport::Percentile(micros, 1.0));
+    CHECK(stats["compactions"].get<uint64_t>() >= 1);
+
+    Store().Close();
+    fs::remove_all(directory);
+    return TestSupport::Result();
+}
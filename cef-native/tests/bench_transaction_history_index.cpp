@@ -0,0 +1,153 @@
+// History panel pages against a synthetic transaction history.
+// Usage: bench_transaction_history_index [scale]   (scale < 1 shortens the run; ctest uses 0.01)
+//
+// Three years of wallet history: a memo on one transaction in ten, one in a hundred failed and
+// the newest few still pending. The first sync arrives in daemon-sized pages, later syncs as
+// small deltas of new transactions and confirmations. Page requests mix scrolling the whole list
+// with status filters and a search box retyped every few requests, like the panel would.
+
+#include "TransactionHistoryIndex.h"
+#include "Encoding.h"
+#include "TestSupport.h"
+#include <random>
+
+namespace {
+    using Transaction = TransactionHistoryIndex::Transaction;
+
+    // Same sizes as TransactionHistoryCache's sync and the panel's page
+    const size_t kSyncPageSize = 1000;
+    const size_t kPageSize = 50;
+}
+
+int main(int argc, char** argv) {
+    const double scale = TestSupport::Scale(argc, argv);
+    const size_t transactionCount = (std::max)(static_cast<size_t>(2000), static_cast<size_t>(100000 * scale));
+    const size_t queryCount = (std::max)(static_cast<size_t>(100), static_cast<size_t>(10000 * scale));
+    const int64_t spanMs = 3ll * 365 * 24 * 60 * 60 * 1000;
+    const size_t pendingCount = 20;
+    const char kBase58[] = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+    std::mt19937_64 random(42);
+    auto randomBytes = [&](size_t length) {
+        std::string bytes(length, '\0');
+        for (char& c : bytes) {
+            c = static_cast<char>(random() & 0xff);
+        }
+        return bytes;
+    };
+    auto randomTxid = [&]() { return Encoding::hexEncode(randomBytes(32)); };
+
+    const int64_t nowMs = 1700000000000ll;
+    std::vector<Transaction> history(transactionCount);
+    for (size_t i = 0; i < transactionCount; i++) {
+        Transaction& transaction = history[i];
+        transaction.txid = randomTxid();
+        transaction.recipient = "1";
+        for (int c = 0; c < 33; c++) {
+            transaction.recipient += kBase58[random() % (sizeof(kBase58) - 1)];
+        }
+        if (i % 10 == 0) {
+            transaction.memo = "Invoice #" + std::to_string(i);
+        }
+        transaction.timestamp = nowMs - spanMs + static_cast<int64_t>(spanMs * (static_cast<double>(i) / transactionCount));
+        transaction.amount = static_cast<int64_t>(1000 + random() % 10000000);
+        transaction.fee = static_cast<int64_t>(50 + random() % 500);
+        bool pending = i + pendingCount >= transactionCount;
+        transaction.confirmations = pending ? 0 : static_cast<uint32_t>(transactionCount - i);
+        transaction.status = pending ? TransactionHistoryIndex::kPending
+                           : (random() % 100 == 0 ? TransactionHistoryIndex::kFailed : TransactionHistoryIndex::kConfirmed);
+    }
+
+    // The first sync, newest page first as a daemon walking back from its tip would send it
+    TransactionHistoryIndex index;
+    int64_t buildStart = TestSupport::NowMicros();
+    for (size_t end = transactionCount; end > 0;) {
+        size_t begin = end > kSyncPageSize ? end - kSyncPageSize : 0;
+        index.Upsert(std::vector<Transaction>(history.begin() + begin, history.begin() + end));
+        end = begin;
+    }
+    double buildMs = (TestSupport::NowMicros() - buildStart) / 1000.0;
+    CHECK(index.Count() == transactionCount);
+
+    // Startup replays the whole log in one batch
+    std::vector<Transaction> replay;
+    replay.reserve(transactionCount);
+    index.ForEach([&](const Transaction& transaction) { replay.push_back(transaction); });
+    int64_t replayStart = TestSupport::NowMicros();
+    TransactionHistoryIndex replayed;
+    replayed.Upsert(replay);
+    double replayMs = (TestSupport::NowMicros() - replayStart) / 1000.0;
+    CHECK(replayed.Count() == transactionCount);
+
+    // What the old path sent across IPC on every open, against one page of the new one
+    nlohmann::json full = nlohmann::json::array();
+    for (const Transaction& transaction : history) {
+        full.push_back(TransactionHistoryIndex::ToJson(transaction));
+    }
+    size_t fullResponseBytes = full.dump().size();
+    full = nullptr;
+    size_t pageResponseBytes = index.Page(0, kPageSize, TransactionHistoryIndex::Filter()).dump().size();
+
+    // Incremental syncs: a few new transactions and the pending ones gaining a confirmation
+    std::vector<double> deltaMicros;
+    for (size_t round = 0; round < 100; round++) {
+        std::vector<Transaction> delta;
+        for (size_t i = 0; i < 5; i++) {
+            Transaction transaction = history.back();
+            transaction.txid = randomTxid();
+            transaction.timestamp = nowMs + static_cast<int64_t>(round * 1000 + i);
+            delta.push_back(transaction);
+        }
+        for (size_t i = transactionCount - pendingCount; i < transactionCount; i++) {
+            history[i].confirmations++;
+            history[i].status = TransactionHistoryIndex::kConfirmed;
+            delta.push_back(history[i]);
+        }
+        int64_t start = TestSupport::NowMicros();
+        CHECK(index.Upsert(delta) == delta.size());
+        deltaMicros.push_back(static_cast<double>(TestSupport::NowMicros() - start));
+    }
+    CHECK(index.Count() == transactionCount + 500);
+
+    std::vector<double> scrollMicros;
+    std::vector<double> statusMicros;
+    std::vector<double> searchMicros;
+    TransactionHistoryIndex::Filter search;
+    for (size_t i = 0; i < queryCount; i++) {
+        size_t offset = static_cast<size_t>(random() % index.Count());
+        int64_t start = TestSupport::NowMicros();
+        switch (i % 4) {
+            case 0:
+            case 1:
+                CHECK(index.Page(offset, kPageSize, TransactionHistoryIndex::Filter())["items"].size() > 0);
+                scrollMicros.push_back(static_cast<double>(TestSupport::NowMicros() - start));
+                break;
+            case 2: {
+                TransactionHistoryIndex::Filter status;
+                status.status = TransactionHistoryIndex::kFailed;
+                index.Page(offset % (index.Count() / 100 + 1), kPageSize, status);
+                statusMicros.push_back(static_cast<double>(TestSupport::NowMicros() - start));
+                break;
+            }
+            default:
+                if (i % 32 == 3) {
+                    search.text = Encoding::hexEncode(randomBytes(2)).substr(0, 3);
+                }
+                index.Page(0, kPageSize, search);
+                searchMicros.push_back(static_cast<double>(TestSupport::NowMicros() - start));
+                break;
+        }
+    }
+
+    std::printf("transactions %zu, index %zu KB (%zu bytes each), first sync %.1f ms, replay %.1f ms\n",
+                index.Count(), index.MemoryBytes() / 1024, index.MemoryBytes() / index.Count(), buildMs, replayMs);
+    std::printf("full response %zu KB, one page %zu KB\n", fullResponseBytes / 1024, pageResponseBytes / 1024);
+    std::printf("delta p50 %.1f us, p95 %.1f us\n",
+                TestSupport::Percentile(deltaMicros, 0.5), TestSupport::Percentile(deltaMicros, 0.95));
+    std::printf("scroll p50 %.1f us, p95 %.1f us; status p50 %.1f us, p95 %.1f us; search p50 %.1f us, p95 %.1f us, max %.1f us\n",
+                TestSupport::Percentile(scrollMicros, 0.5), TestSupport::Percentile(scrollMicros, 0.95),
+                TestSupport::Percentile(statusMicros, 0.5), TestSupport::Percentile(statusMicros, 0.95),
+                TestSupport::Percentile(searchMicros, 0.5), TestSupport::Percentile(searchMicros, 0.95),
+                TestSupport::Percentile(searchMicros, 1.0));
+    return TestSupport::Result();
+}
@@ -0,0 +1,73 @@
+// V8Json on listOutputs-sized results, in both directions.
+// Usage: bench_v8json [scale]   (scale < 1 shortens the run; ctest uses 0.01)
+//
+// Runs against the in-memory CEF values, so it measures the converter's own traversal and
+// allocation; inside the renderer each value also costs a V8 heap allocation on top.
+
+#include "V8JsonConverter.h"
+#include "TestSupport.h"
+#include <random>
+
+using nlohmann::json;
+
+namespace {
+    json ListOutputsResult(size_t count, std::mt19937& random) {
+        static const char digits[] = "0123456789abcdef";
+        auto hex = [&](size_t length) {
+            std::string s(length, '0');
+            for (char& c : s) {
+                c = digits[random() & 0x0f];
+            }
+            return s;
+        };
+
+        json outputs = json::array();
+        for (size_t i = 0; i < count; i++) {
+            outputs.push_back({
+                {"outpoint", hex(64) + "." + std::to_string(i % 4)},
+                {"satoshis", static_cast<int64_t>(random() % 5000000000ULL)},
+                {"lockingScript", "76a914" + hex(40) + "88ac"},
+                {"spendable", true},
+                {"customInstructions", json({{"protocolID", {2, "3241645161d8"}}, {"keyID", hex(16)}}).dump()},
+                {"tags", {"payment", "inbound", hex(8)}},
+                {"labels", {"received"}},
+                {"basket", "default"}
+            });
+        }
+        return {{"totalOutputs", count}, {"outputs", std::move(outputs)}};
+    }
+
+    // Best of several passes, in milliseconds
+    template <typename Fn>
+    double BestMillis(int passes, Fn fn) {
+        double best = 0.0;
+        for (int pass = 0; pass < passes; pass++) {
+            int64_t start = TestSupport::NowMicros();
+            fn();
+            double ms = (TestSupport::NowMicros() - start) / 1000.0;
+            best = pass == 0 ? ms : (std::min)(best, ms);
+        }
+        return best;
+    }
+}
+
+int main(int argc, char** argv) {
+    const double scale = TestSupport::Scale(argc, argv);
+    std::mt19937 random(5);
+
+    std::printf("%10s %12s %12s %14s\n", "outputs", "toV8 ms", "fromV8 ms", "outputs/s");
+    for (size_t base : { 1000, 10000, 100000 }) {
+        size_t count = (std::max)(static_cast<size_t>(1), static_cast<size_t>(base * scale));
+        json result = ListOutputsResult(count, random);
+
+        CefRefPtr<CefV8Value> v8;
+        json back;
+        double toV8 = BestMillis(3, [&] { v8 = V8Json::toV8(result); });
+        double fromV8 = BestMillis(3, [&] { back = V8Json::fromV8(v8); });
+        CHECK(back == result);
+
+        double perSecond = (toV8 + fromV8) > 0 ? count / ((toV8 + fromV8) / 1000.0) : 0.0;
+        std::printf("%10zu %12.2f %12.2f %14.0f\n", count, toV8, fromV8, perSecond);
+    }
+    return TestSupport::Result();
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <functional>
+#include <utility>
+
+namespace base {
+    using OnceClosure = std::function<void()>;
+
+    // Arguments are bound by value, as CEF's BindOnce does for the components' lambdas
+    template <typename Functor, typename... Args>
+    OnceClosure BindOnce(Functor&& functor, Args&&... args) {
+        return std::bind(std::forward<Functor>(functor), std::forward<Args>(args)...);
+    }
+}
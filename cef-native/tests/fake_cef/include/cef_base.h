@@ -0,0 +1,74 @@
+#pragma once
+
+// In-memory stand-ins for the handful of CEF types the shell's core components use, so that
+// those components compile and run in the Linux unit tests without a browser. Only the calls the
+// components make are provided, with the semantics the components rely on.
+
+#include <atomic>
+#include <string>
+#include <utility>
+
+class CefBaseRefCounted {
+public:
+    virtual ~CefBaseRefCounted() = default;
+    virtual void AddRef() const = 0;
+    virtual bool Release() const = 0;
+};
+
+#define IMPLEMENT_REFCOUNTING(ClassName)                                \
+public:                                                                 \
+    void AddRef() const override { refs_.fetch_add(1); }                \
+    bool Release() const override {                                     \
+        if (refs_.fetch_sub(1) == 1) {                                  \
+            delete this;                                                \
+            return true;                                                \
+        }                                                               \
+        return false;                                                   \
+    }                                                                   \
+                                                                        \
+private:                                                                \
+    mutable std::atomic<int> refs_{0}
+
+template <typename T>
+class CefRefPtr {
+public:
+    CefRefPtr() = default;
+    CefRefPtr(std::nullptr_t) {}
+    CefRefPtr(T* p) : p_(p) { if (p_) p_->AddRef(); }
+    CefRefPtr(const CefRefPtr& other) : CefRefPtr(other.p_) {}
+    template <typename U>
+    CefRefPtr(const CefRefPtr<U>& other) : CefRefPtr(other.get()) {}
+    CefRefPtr(CefRefPtr&& other) noexcept : p_(other.p_) { other.p_ = nullptr; }
+    ~CefRefPtr() { if (p_) p_->Release(); }
+
+    CefRefPtr& operator=(CefRefPtr other) noexcept {
+        std::swap(p_, other.p_);
+        return *this;
+    }
+
+    T* get() const { return p_; }
+    T* operator->() const { return p_; }
+    T& operator*() const { return *p_; }
+    explicit operator bool() const { return p_ != nullptr; }
+    bool operator==(const CefRefPtr& other) const { return p_ == other.p_; }
+    bool operator!=(const CefRefPtr& other) const { return p_ != other.p_; }
+
+private:
+    T* p_ = nullptr;
+};
+
+// UTF-8 only; CEF's is UTF-16 on Windows, which the components never rely on
+class CefString {
+public:
+    CefString() = default;
+    CefString(const char* s) : s_(s ? s : "") {}
+    CefString(const std::string& s) : s_(s) {}
+    std::string ToString() const { return s_; }
+    operator std::string() const { return s_; }
+    bool empty() const { return s_.empty(); }
+    bool operator==(const CefString& other) const { return s_ == other.s_; }
+    bool operator<(const CefString& other) const { return s_ < other.s_; }
+
+private:
+    std::string s_;
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "include/cef_frame.h"
+
+// A browser is its identifier and a main frame whose sent messages land in CefFrame::Outbox()
+class CefBrowser : public CefBaseRefCounted {
+public:
+    static CefRefPtr<CefBrowser> Create(int id, bool popup = false) { return new CefBrowser(id, popup); }
+
+    int GetIdentifier() const { return id_; }
+    bool IsPopup() const { return popup_; }
+    CefRefPtr<CefFrame> GetMainFrame() const { return mainFrame_; }
+
+private:
+    CefBrowser(int id, bool popup) : id_(id), popup_(popup), mainFrame_(CefFrame::Create()) {}
+
+    int id_;
+    bool popup_;
+    CefRefPtr<CefFrame> mainFrame_;
+    IMPLEMENT_REFCOUNTING(CefBrowser);
+};
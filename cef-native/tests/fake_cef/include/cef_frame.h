@@ -0,0 +1,33 @@
+#pragma once
+
+#include "include/cef_process_message.h"
+#include <vector>
+
+// Process messages a frame sends are queued in Outbox() for the test to read and answer
+class CefFrame : public CefBaseRefCounted {
+public:
+    static CefRefPtr<CefFrame> Create(const std::string& url = "", bool main = true) { return new CefFrame(url, main); }
+
+    CefString GetURL() const { return url_; }
+    bool IsMain() const { return main_; }
+
+    void SendProcessMessage(CefProcessId target, CefRefPtr<CefProcessMessage> message) {
+        Outbox().push_back({ target, message });
+    }
+
+    struct Sent {
+        CefProcessId target;
+        CefRefPtr<CefProcessMessage> message;
+    };
+    static std::vector<Sent>& Outbox() {
+        static std::vector<Sent> outbox;
+        return outbox;
+    }
+
+private:
+    CefFrame(const std::string& url, bool main) : url_(url), main_(main) {}
+
+    std::string url_;
+    bool main_;
+    IMPLEMENT_REFCOUNTING(CefFrame);
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "include/cef_values.h"
+
+enum CefProcessId {
+    PID_BROWSER,
+    PID_RENDERER,
+};
+
+class CefProcessMessage : public CefBaseRefCounted {
+public:
+    static CefRefPtr<CefProcessMessage> Create(const CefString& name) { return new CefProcessMessage(name); }
+
+    CefString GetName() const { return name_; }
+    CefRefPtr<CefListValue> GetArgumentList() const { return args_; }
+
+    CefRefPtr<CefProcessMessage> Copy() const {
+        CefRefPtr<CefProcessMessage> copy = Create(name_);
+        copy->args_ = args_->Copy();
+        return copy;
+    }
+
+private:
+    explicit CefProcessMessage(const CefString& name) : name_(name), args_(CefListValue::Create()) {}
+
+    CefString name_;
+    CefRefPtr<CefListValue> args_;
+    IMPLEMENT_REFCOUNTING(CefProcessMessage);
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "include/cef_base.h"
+#include <deque>
+#include <functional>
+#include <mutex>
+
+enum CefThreadId {
+    TID_UI,
+    TID_FILE_BACKGROUND,
+    TID_FILE_USER_VISIBLE,
+    TID_FILE_USER_BLOCKING,
+    TID_PROCESS_LAUNCHER,
+    TID_IO,
+    TID_RENDERER,
+};
+
+class CefTask : public CefBaseRefCounted {
+public:
+    virtual void Execute() = 0;
+};
+
+// Posted tasks wait here until the test runs them, on whichever thread it chooses
+namespace FakeCefTasks {
+    struct Posted {
+        CefThreadId thread;
+        int64_t delayMs;
+        std::function<void()> run;
+    };
+
+    inline std::mutex& Mutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+
+    inline std::deque<Posted>& Queue() {
+        static std::deque<Posted> queue;
+        return queue;
+    }
+
+    inline void Post(CefThreadId thread, int64_t delayMs, std::function<void()> run) {
+        std::lock_guard<std::mutex> lock(Mutex());
+        Queue().push_back({ thread, delayMs, std::move(run) });
+    }
+
+    // Takes the oldest posted task, if any
+    inline bool Take(Posted& task) {
+        std::lock_guard<std::mutex> lock(Mutex());
+        if (Queue().empty()) {
+            return false;
+        }
+        task = std::move(Queue().front());
+        Queue().pop_front();
+        return true;
+    }
+
+    // Runs tasks on the calling thread until none are left, including ones they post; returns how many ran
+    inline size_t RunAll() {
+        size_t ran = 0;
+        Posted task;
+        while (Take(task)) {
+            task.run();
+            ran++;
+        }
+        return ran;
+    }
+
+    inline size_t Pending() {
+        std::lock_guard<std::mutex> lock(Mutex());
+        return Queue().size();
+    }
+}
+
+inline bool CefCurrentlyOn(CefThreadId) { return true; }
+
+inline bool CefPostTask(CefThreadId thread, CefRefPtr<CefTask> task) {
+    FakeCefTasks::Post(thread, 0, [task]() { task->Execute(); });
+    return true;
+}
+
+inline bool CefPostDelayedTask(CefThreadId thread, CefRefPtr<CefTask> task, int64_t delayMs) {
+    FakeCefTasks::Post(thread, delayMs, [task]() { task->Execute(); });
+    return true;
+}
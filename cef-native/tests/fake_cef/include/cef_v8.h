@@ -0,0 +1,244 @@
+#pragma once
+
+#include "include/cef_frame.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+class CefV8Value;
+class CefV8Context;
+typedef std::vector<CefRefPtr<CefV8Value>> CefV8ValueList;
+
+enum cef_v8_propertyattribute_t {
+    V8_PROPERTY_ATTRIBUTE_NONE = 0,
+    V8_PROPERTY_ATTRIBUTE_READONLY = 1 << 0,
+    V8_PROPERTY_ATTRIBUTE_DONTENUM = 1 << 1,
+    V8_PROPERTY_ATTRIBUTE_DONTDELETE = 1 << 2,
+};
+
+class CefV8Handler : public CefBaseRefCounted {
+public:
+    virtual bool Execute(const CefString& name, CefRefPtr<CefV8Value> object, const CefV8ValueList& arguments,
+                         CefRefPtr<CefV8Value>& retval, CefString& exception) = 0;
+};
+
+class CefV8Accessor : public CefBaseRefCounted {};
+class CefV8Interceptor : public CefBaseRefCounted {};
+
+class CefV8ArrayBufferReleaseCallback : public CefBaseRefCounted {
+public:
+    virtual void ReleaseBuffer(void* buffer) = 0;
+};
+
+// A V8 value held in memory. Numbers follow V8: every number IsDouble, and integral ones in range
+// are also IsInt / IsUInt.
+class CefV8Value : public CefBaseRefCounted {
+public:
+    enum class Kind { Undefined, Null, Bool, Number, String, Object, Array, Function, ArrayBuffer, Promise };
+    enum class PromiseState { Pending, Resolved, Rejected };
+
+    static CefRefPtr<CefV8Value> CreateUndefined() { return new CefV8Value(Kind::Undefined); }
+    static CefRefPtr<CefV8Value> CreateNull() { return new CefV8Value(Kind::Null); }
+    static CefRefPtr<CefV8Value> CreateBool(bool value) {
+        CefV8Value* v = new CefV8Value(Kind::Bool);
+        v->bool_ = value;
+        return v;
+    }
+    static CefRefPtr<CefV8Value> CreateInt(int32_t value) { return CreateDouble(value); }
+    static CefRefPtr<CefV8Value> CreateUInt(uint32_t value) { return CreateDouble(value); }
+    static CefRefPtr<CefV8Value> CreateDouble(double value) {
+        CefV8Value* v = new CefV8Value(Kind::Number);
+        v->number_ = value;
+        return v;
+    }
+    static CefRefPtr<CefV8Value> CreateString(const CefString& value) {
+        CefV8Value* v = new CefV8Value(Kind::String);
+        v->string_ = value;
+        return v;
+    }
+    static CefRefPtr<CefV8Value> CreateObject(CefRefPtr<CefV8Accessor>, CefRefPtr<CefV8Interceptor>) {
+        return new CefV8Value(Kind::Object);
+    }
+    static CefRefPtr<CefV8Value> CreateArray(int length) {
+        CefV8Value* v = new CefV8Value(Kind::Array);
+        v->elements_.resize(length > 0 ? length : 0);
+        return v;
+    }
+    static CefRefPtr<CefV8Value> CreateFunction(const CefString& name, CefRefPtr<CefV8Handler> handler) {
+        CefV8Value* v = new CefV8Value(Kind::Function);
+        v->string_ = name;
+        v->handler_ = handler;
+        return v;
+    }
+    static CefRefPtr<CefV8Value> CreateArrayBuffer(void* buffer, size_t length,
+                                                  CefRefPtr<CefV8ArrayBufferReleaseCallback> release) {
+        CefV8Value* v = new CefV8Value(Kind::ArrayBuffer);
+        v->buffer_ = buffer;
+        v->bufferLength_ = length;
+        v->release_ = release;
+        return v;
+    }
+    static CefRefPtr<CefV8Value> CreatePromise() { return new CefV8Value(Kind::Promise); }
+
+    ~CefV8Value() override {
+        if (release_ && buffer_) {
+            release_->ReleaseBuffer(buffer_);
+        }
+    }
+
+    bool IsValid() const { return true; }
+    bool IsUndefined() const { return kind_ == Kind::Undefined; }
+    bool IsNull() const { return kind_ == Kind::Null; }
+    bool IsBool() const { return kind_ == Kind::Bool; }
+    bool IsDouble() const { return kind_ == Kind::Number; }
+    bool IsInt() const {
+        return IsDouble() && std::trunc(number_) == number_ &&
+               number_ >= std::numeric_limits<int32_t>::min() && number_ <= std::numeric_limits<int32_t>::max();
+    }
+    bool IsUInt() const {
+        return IsDouble() && std::trunc(number_) == number_ && number_ >= 0 &&
+               number_ <= std::numeric_limits<uint32_t>::max();
+    }
+    bool IsString() const { return kind_ == Kind::String; }
+    bool IsArray() const { return kind_ == Kind::Array; }
+    bool IsFunction() const { return kind_ == Kind::Function; }
+    bool IsArrayBuffer() const { return kind_ == Kind::ArrayBuffer; }
+    bool IsPromise() const { return kind_ == Kind::Promise; }
+    // Arrays, functions, buffers and promises are objects in V8 too
+    bool IsObject() const { return kind_ >= Kind::Object; }
+
+    bool GetBoolValue() const { return bool_; }
+    int32_t GetIntValue() const { return static_cast<int32_t>(number_); }
+    uint32_t GetUIntValue() const { return static_cast<uint32_t>(number_); }
+    double GetDoubleValue() const { return number_; }
+    CefString GetStringValue() const { return string_; }
+
+    int GetArrayLength() const { return static_cast<int>(elements_.size()); }
+    CefRefPtr<CefV8Value> GetValue(int index) const {
+        return index >= 0 && index < GetArrayLength() ? elements_[index] : CreateUndefined();
+    }
+    bool SetValue(int index, CefRefPtr<CefV8Value> value) {
+        if (index < 0) {
+            return false;
+        }
+        if (index >= GetArrayLength()) {
+            elements_.resize(index + 1);
+        }
+        elements_[index] = value;
+        return true;
+    }
+
+    // Own properties in insertion order, as V8 enumerates string keys
+    CefRefPtr<CefV8Value> GetValue(const CefString& key) const {
+        for (const auto& property : properties_) {
+            if (property.first == key) {
+                return property.second;
+            }
+        }
+        return CreateUndefined();
+    }
+    bool SetValue(const CefString& key, CefRefPtr<CefV8Value> value, cef_v8_propertyattribute_t) {
+        for (auto& property : properties_) {
+            if (property.first == key) {
+                property.second = value;
+                return true;
+            }
+        }
+        properties_.emplace_back(key, value);
+        return true;
+    }
+    bool HasValue(const CefString& key) const {
+        for (const auto& property : properties_) {
+            if (property.first == key) {
+                return true;
+            }
+        }
+        return false;
+    }
+    bool GetKeys(std::vector<CefString>& keys) const {
+        for (const auto& property : properties_) {
+            keys.push_back(property.first);
+        }
+        return true;
+    }
+
+    void* GetArrayBufferData() const { return buffer_; }
+    size_t GetArrayBufferByteLength() const { return bufferLength_; }
+
+    CefRefPtr<CefV8Value> ExecuteFunction(CefRefPtr<CefV8Value> object, const CefV8ValueList& arguments) {
+        CefRefPtr<CefV8Value> retval;
+        CefString exception;
+        if (handler_) {
+            handler_->Execute(string_, object, arguments, retval, exception);
+        }
+        return retval ? retval : CreateUndefined();
+    }
+
+    bool ResolvePromise(CefRefPtr<CefV8Value> value) {
+        if (state_ != PromiseState::Pending) {
+            return false;
+        }
+        state_ = PromiseState::Resolved;
+        settled_ = value;
+        return true;
+    }
+    bool RejectPromise(const CefString& error) {
+        if (state_ != PromiseState::Pending) {
+            return false;
+        }
+        state_ = PromiseState::Rejected;
+        string_ = error;
+        return true;
+    }
+
+    // Test inspection of a promise
+    PromiseState GetPromiseState() const { return state_; }
+    CefRefPtr<CefV8Value> GetPromiseResult() const { return settled_; }
+    CefString GetPromiseError() const { return string_; }
+
+private:
+    explicit CefV8Value(Kind kind) : kind_(kind) {}
+
+    Kind kind_;
+    bool bool_ = false;
+    double number_ = 0.0;
+    CefString string_;
+    std::vector<CefRefPtr<CefV8Value>> elements_;
+    std::vector<std::pair<CefString, CefRefPtr<CefV8Value>>> properties_;
+    CefRefPtr<CefV8Handler> handler_;
+    void* buffer_ = nullptr;
+    size_t bufferLength_ = 0;
+    CefRefPtr<CefV8ArrayBufferReleaseCallback> release_;
+    PromiseState state_ = PromiseState::Pending;
+    CefRefPtr<CefV8Value> settled_;
+    IMPLEMENT_REFCOUNTING(CefV8Value);
+};
+
+// Counts Enter/Exit so tests can check every Enter is balanced
+class CefV8Context : public CefBaseRefCounted {
+public:
+    static CefRefPtr<CefV8Context> Create(CefRefPtr<CefFrame> frame = CefFrame::Create()) { return new CefV8Context(frame); }
+
+    bool IsValid() const { return valid_; }
+    void Invalidate() { valid_ = false; }
+    bool Enter() { depth_++; return true; }
+    bool Exit() { depth_--; return depth_ >= 0; }
+    int EnterDepth() const { return depth_; }
+    bool IsSame(CefRefPtr<CefV8Context> that) const { return that.get() == this; }
+    CefRefPtr<CefFrame> GetFrame() const { return frame_; }
+    CefRefPtr<CefV8Value> GetGlobal() { return global_; }
+
+private:
+    explicit CefV8Context(CefRefPtr<CefFrame> frame)
+        : frame_(frame), global_(CefV8Value::CreateObject(nullptr, nullptr)) {}
+
+    CefRefPtr<CefFrame> frame_;
+    CefRefPtr<CefV8Value> global_;
+    bool valid_ = true;
+    int depth_ = 0;
+    IMPLEMENT_REFCOUNTING(CefV8Context);
+};
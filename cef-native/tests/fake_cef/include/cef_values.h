@@ -0,0 +1,70 @@
+#pragma once
+
+#include "include/cef_base.h"
+#include <vector>
+
+enum CefValueType {
+    VTYPE_INVALID = 0,
+    VTYPE_NULL,
+    VTYPE_BOOL,
+    VTYPE_INT,
+    VTYPE_DOUBLE,
+    VTYPE_STRING,
+    VTYPE_BINARY,
+    VTYPE_DICTIONARY,
+    VTYPE_LIST,
+};
+
+class CefListValue : public CefBaseRefCounted {
+public:
+    static CefRefPtr<CefListValue> Create() { return new CefListValue(); }
+
+    // Deep, as CEF's is
+    CefRefPtr<CefListValue> Copy() const {
+        CefRefPtr<CefListValue> copy = Create();
+        copy->items_ = items_;
+        for (Item& item : copy->items_) {
+            if (item.list) {
+                item.list = item.list->Copy();
+            }
+        }
+        return copy;
+    }
+
+    size_t GetSize() const { return items_.size(); }
+    bool SetSize(size_t size) { items_.resize(size); return true; }
+    CefValueType GetType(size_t index) const { return index < items_.size() ? items_[index].type : VTYPE_INVALID; }
+
+    bool GetBool(size_t index) const { return index < items_.size() && items_[index].b; }
+    int GetInt(size_t index) const { return index < items_.size() ? items_[index].i : 0; }
+    double GetDouble(size_t index) const { return index < items_.size() ? items_[index].d : 0.0; }
+    CefString GetString(size_t index) const { return index < items_.size() ? items_[index].s : CefString(); }
+    CefRefPtr<CefListValue> GetList(size_t index) const { return index < items_.size() ? items_[index].list : nullptr; }
+
+    bool SetNull(size_t index) { At(index) = Item{}; At(index).type = VTYPE_NULL; return true; }
+    bool SetBool(size_t index, bool value) { Item& item = At(index) = Item{}; item.type = VTYPE_BOOL; item.b = value; return true; }
+    bool SetInt(size_t index, int value) { Item& item = At(index) = Item{}; item.type = VTYPE_INT; item.i = value; return true; }
+    bool SetDouble(size_t index, double value) { Item& item = At(index) = Item{}; item.type = VTYPE_DOUBLE; item.d = value; return true; }
+    bool SetString(size_t index, const CefString& value) { Item& item = At(index) = Item{}; item.type = VTYPE_STRING; item.s = value; return true; }
+    bool SetList(size_t index, CefRefPtr<CefListValue> value) { Item& item = At(index) = Item{}; item.type = VTYPE_LIST; item.list = value; return true; }
+
+private:
+    struct Item {
+        CefValueType type = VTYPE_INVALID;
+        bool b = false;
+        int i = 0;
+        double d = 0.0;
+        CefString s;
+        CefRefPtr<CefListValue> list;
+    };
+
+    Item& At(size_t index) {
+        if (index >= items_.size()) {
+            items_.resize(index + 1);
+        }
+        return items_[index];
+    }
+
+    std::vector<Item> items_;
+    IMPLEMENT_REFCOUNTING(CefListValue);
+};
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "include/base/cef_bind.h"
+#include "include/cef_task.h"
+
+inline bool CefPostTask(CefThreadId thread, base::OnceClosure closure) {
+    FakeCefTasks::Post(thread, 0, std::move(closure));
+    return true;
+}
+
+inline bool CefPostDelayedTask(CefThreadId thread, base::OnceClosure closure, int64_t delayMs) {
+    FakeCefTasks::Post(thread, delayMs, std::move(closure));
+    return true;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include "include/cef_base.h"
+
+// The tests drive each component from a single thread
+#define CEF_REQUIRE_UI_THREAD() ((void)0)
+#define CEF_REQUIRE_IO_THREAD() ((void)0)
+#define CEF_REQUIRE_RENDERER_THREAD() ((void)0)
@@ -0,0 +1,155 @@
+// ActivityIndex rollups: range totals from running totals, per-route breakdowns, late events,
+// merging old hours into days, and snapshot round trips including malformed snapshots.
+
+#include "ActivityIndex.h"
+#include "TestSupport.h"
+
+namespace {
+    const int64_t kHourMs = 60ll * 60 * 1000;
+    const int64_t kDayMs = 24 * kHourMs;
+    // Midnight, so hour and day arithmetic below lines up with the index's buckets
+    const int64_t kStartMs = 19000 * kDayMs;
+
+    struct Fixture {
+        ActivityIndex index;
+        uint32_t shop = 0;
+        uint32_t news = 0;
+        uint16_t sign = 0;
+        uint16_t balance = 0;
+
+        Fixture() {
+            CHECK(index.InternDomain("shop.example.com", shop));
+            CHECK(index.InternDomain("news.example.com", news));
+            CHECK(index.InternRoute("POST /createSignature", sign));
+            CHECK(index.InternRoute("GET /balance", balance));
+        }
+
+        void Add(uint32_t domain, uint16_t route, int64_t timeMs, uint8_t outcome = ActivityIndex::kOk) {
+            ActivityIndex::Event event;
+            event.domain = domain;
+            event.route = route;
+            event.outcome = outcome;
+            event.timeMs = timeMs;
+            event.latencyMicros = 4000;
+            event.bytesIn = 100;
+            event.bytesOut = 200;
+            index.Add(event);
+        }
+    };
+
+    uint64_t Calls(const nlohmann::json& overview, const std::string& domain) {
+        for (const auto& row : overview["domains"]) {
+            if (row["domain"] == domain) {
+                return row["calls"].get<uint64_t>();
+            }
+        }
+        return 0;
+    }
+
+    void CheckInterning() {
+        Fixture fixture;
+        uint32_t again = 99;
+        CHECK(fixture.index.InternDomain("shop.example.com", again) && again == fixture.shop);
+        CHECK(fixture.index.DomainCount() == 2 && fixture.index.RouteCount() == 2);
+
+        uint32_t tooLong = 0;
+        CHECK(!fixture.index.InternDomain(std::string(2000, 'a'), tooLong));
+
+        // Events naming ids the index has never seen are ignored
+        fixture.Add(7, fixture.sign, kStartMs);
+        CHECK(fixture.index.EventCount() == 0);
+    }
+
+    void CheckRanges() {
+        Fixture fixture;
+        for (int hour = 0; hour < 48; hour++) {
+            fixture.Add(fixture.shop, fixture.sign, kStartMs + hour * kHourMs + 1000);
+            if (hour % 4 == 0) {
+                fixture.Add(fixture.news, fixture.balance, kStartMs + hour * kHourMs + 2000, ActivityIndex::kHttpError);
+            }
+        }
+        // A late event lands in its own hour and shifts the totals after it
+        fixture.Add(fixture.shop, fixture.balance, kStartMs + 5 * kHourMs);
+        CHECK(fixture.index.EventCount() == 61);
+
+        nlohmann::json all = fixture.index.QueryDomains(kStartMs, kStartMs + 2 * kDayMs, 10);
+        CHECK(all["total"]["calls"] == 61);
+        CHECK(all["total"]["errors"] == 12);
+        CHECK(all["domains"].size() == 2 && all["domains"][0]["domain"] == "shop.example.com");
+        CHECK(Calls(all, "shop.example.com") == 49);
+
+        // The first day only; hour 5 holds the late event
+        nlohmann::json firstDay = fixture.index.QueryDomains(kStartMs, kStartMs + kDayMs, 10);
+        CHECK(Calls(firstDay, "shop.example.com") == 25);
+        CHECK(Calls(firstDay, "news.example.com") == 6);
+        nlohmann::json oneHour = fixture.index.QueryDomains(kStartMs + 5 * kHourMs, kStartMs + 6 * kHourMs, 10);
+        CHECK(oneHour["total"]["calls"] == 2);
+        CHECK(fixture.index.QueryDomains(kStartMs, kStartMs + kDayMs, 1)["domains"].size() == 1);
+
+        nlohmann::json shop = fixture.index.QueryDomain("shop.example.com", kStartMs, kStartMs + 2 * kDayMs);
+        CHECK(shop["routes"].size() == 2 && shop["routes"][0]["route"] == "POST /createSignature");
+        CHECK(shop["routes"][0]["calls"] == 48 && shop["routes"][1]["calls"] == 1);
+        CHECK(fixture.index.QueryDomain("unknown.example.com", kStartMs, kStartMs + kDayMs).is_null());
+    }
+
+    void CheckRollup() {
+        Fixture fixture;
+        for (int hour = 0; hour < 72; hour++) {
+            fixture.Add(fixture.shop, hour % 2 ? fixture.sign : fixture.balance, kStartMs + hour * kHourMs);
+        }
+        size_t before = fixture.index.MemoryBytes();
+        fixture.index.Rollup(kStartMs + 2 * kDayMs);
+        CHECK(fixture.index.MemoryBytes() <= before);
+
+        // Merged days still add up; a range inside one widens to the whole day
+        CHECK(fixture.index.QueryDomains(kStartMs, kStartMs + 3 * kDayMs, 10)["total"]["calls"] == 72);
+        CHECK(fixture.index.QueryDomains(kStartMs + kDayMs, kStartMs + 2 * kDayMs, 10)["total"]["calls"] == 24);
+        CHECK(fixture.index.QueryDomains(kStartMs + 3 * kHourMs, kStartMs + 4 * kHourMs, 10)["total"]["calls"] == 24);
+        // Hours after the cutoff keep their resolution
+        CHECK(fixture.index.QueryDomains(kStartMs + 50 * kHourMs, kStartMs + 51 * kHourMs, 10)["total"]["calls"] == 1);
+
+        nlohmann::json shop = fixture.index.QueryDomain("shop.example.com", kStartMs, kStartMs + 3 * kDayMs);
+        CHECK(shop["routes"].size() == 2 && shop["routes"][0]["calls"] == 36 && shop["routes"][1]["calls"] == 36);
+
+        // Events older than the cutoff still count, in their day
+        fixture.Add(fixture.shop, fixture.sign, kStartMs + 7 * kHourMs);
+        CHECK(fixture.index.QueryDomains(kStartMs, kStartMs + kDayMs, 10)["total"]["calls"] == 25);
+    }
+
+    void CheckSnapshots() {
+        Fixture fixture;
+        for (int hour = 0; hour < 30; hour++) {
+            fixture.Add(hour % 3 ? fixture.shop : fixture.news, fixture.sign, kStartMs + hour * kHourMs);
+        }
+        fixture.index.Rollup(kStartMs + kDayMs);
+        std::string snapshot = fixture.index.Serialize();
+
+        ActivityIndex restored;
+        CHECK(restored.Restore(snapshot));
+        CHECK(restored.EventCount() == 30 && restored.DomainCount() == 2 && restored.RouteCount() == 2);
+        CHECK(restored.QueryDomains(kStartMs, kStartMs + 2 * kDayMs, 10) ==
+              fixture.index.QueryDomains(kStartMs, kStartMs + 2 * kDayMs, 10));
+        CHECK(restored.QueryDomain("news.example.com", kStartMs, kStartMs + 2 * kDayMs) ==
+              fixture.index.QueryDomain("news.example.com", kStartMs, kStartMs + 2 * kDayMs));
+
+        // Interning continues after the restored names
+        uint32_t next = 0;
+        CHECK(restored.InternDomain("wallet.example.com", next) && next == 2);
+
+        // Every truncation and trailing garbage is rejected
+        for (size_t length = 0; length < snapshot.size(); length++) {
+            ActivityIndex truncated;
+            CHECK_MSG(!truncated.Restore(snapshot.substr(0, length)), "length " + std::to_string(length));
+        }
+        ActivityIndex padded;
+        CHECK(!padded.Restore(snapshot + "x"));
+    }
+}
+
+int main() {
+    CheckInterning();
+    CheckRanges();
+    CheckRollup();
+    CheckSnapshots();
+    return TestSupport::Result();
+}
@@ -0,0 +1,202 @@
+// BRC100SessionTable, the table behind BRC100SessionCache: reading the daemon's expiresAt, seeding
+// from a snapshot with the events that raced it replayed on top, revocation and expiry, and the
+// table going quiet when the event stream drops. Whatever the table does not hold is left to the
+// daemon rather than answered "not found".
+
+#include "BRC100SessionTable.h"
+#include "TestSupport.h"
+#include <chrono>
+#include <ctime>
+#include <thread>
+
+namespace {
+    // RFC 3339 with milliseconds, as the daemon writes expiresAt
+    std::string Rfc3339(int64_t unixMs) {
+        std::time_t seconds = static_cast<std::time_t>(unixMs / 1000);
+        std::tm utc;
+        gmtime_r(&seconds, &utc);
+        char text[64];
+        std::snprintf(text, sizeof(text), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ", utc.tm_year + 1900, utc.tm_mon + 1,
+                      utc.tm_mday, utc.tm_hour, utc.tm_min, utc.tm_sec, static_cast<int>(unixMs % 1000));
+        return text;
+    }
+
+    nlohmann::json Session(const std::string& id, const std::string& domain, int64_t expiresInMs = 3600 * 1000) {
+        return {{"sessionId", id}, {"appDomain", domain},
+                {"expiresAt", Rfc3339(BRC100SessionTable::NowMs() + expiresInMs)}};
+    }
+
+    nlohmann::json Snapshot(const std::vector<nlohmann::json>& sessions) {
+        return {{"success", true}, {"data", {{"sessions", sessions}}}};
+    }
+
+    std::string ValidateBody(const std::string& id) {
+        return nlohmann::json{{"sessionId", id}}.dump();
+    }
+
+    // The local answer for a session, or "daemon" when the table leaves it to the daemon
+    std::string Answer(BRC100SessionTable& table, const std::string& id) {
+        std::string response;
+        if (!table.Validate(ValidateBody(id), response)) {
+            return "daemon";
+        }
+        nlohmann::json json = nlohmann::json::parse(response);
+        if (json["success"] == true) {
+            CHECK(json["data"]["valid"] == true && json["data"]["session"]["sessionId"] == id);
+            return "valid";
+        }
+        return json["error"].get<std::string>();
+    }
+
+    void CheckExpiresAt() {
+        auto at = [](const char* value) { return BRC100SessionTable::ExpiresAtMs({{"expiresAt", value}}); };
+        // 2024-02-29 is day 19782 of the Unix epoch
+        const int64_t leapDayNoon = (19782LL * 86400 + 12 * 3600 + 34 * 60 + 56) * 1000;
+        CHECK(at("2024-02-29T12:34:56Z") == leapDayNoon);
+        CHECK(at("2024-02-29T12:34:56.789Z") == leapDayNoon + 789);
+        CHECK(at("2024-02-29T12:34:56.789123456Z") == leapDayNoon + 789);
+        CHECK(at("2024-02-29T12:34:56.5Z") == leapDayNoon + 500);
+        CHECK(at("2024-02-29T14:34:56.789+02:00") == leapDayNoon + 789);
+        CHECK(at("2024-02-29T07:04:56-05:30") == leapDayNoon);
+        CHECK(at("1970-01-01T00:00:01Z") == 1000);
+
+        // Unreadable comes back as 0
+        CHECK(at("2024-02-29T12:34:56") == 0);
+        CHECK(at("2024-02-29 12:34:56Z") == 0);
+        CHECK(at("2024-02-29T12:34:56+0200") == 0);
+        CHECK(at("tomorrow") == 0);
+        CHECK(BRC100SessionTable::ExpiresAtMs({{"expiresAt", 1709210096}}) == 0);
+        CHECK(BRC100SessionTable::ExpiresAtMs(nlohmann::json::object()) == 0);
+        CHECK(BRC100SessionTable::ExpiresAtMs(nlohmann::json::array()) == 0);
+
+        int64_t now = BRC100SessionTable::NowMs();
+        CHECK(BRC100SessionTable::ExpiresAtMs({{"expiresAt", Rfc3339(now)}}) == now);
+    }
+
+    void CheckUnseeded() {
+        BRC100SessionTable table;
+        // Events before the stream has connected are counted but not applied
+        CHECK(table.OnEvent("created", Session("s1", "a.example")));
+        CHECK(!table.Live() && table.Size() == 0);
+        CHECK(Answer(table, "s1") == "daemon");
+        CHECK(!table.DomainHasSession("a.example"));
+        // A snapshot nobody asked for is ignored
+        CHECK(table.Seed(0, Snapshot({ Session("s1", "a.example") })) == BRC100SessionTable::kStale);
+        CHECK(!table.Live());
+    }
+
+    void CheckSeedingReplaysEvents() {
+        BRC100SessionTable table;
+        uint64_t generation = table.BeginSeeding();
+
+        // Announced while the snapshot was in flight: s1 is in the snapshot but revoked since, s2
+        // moved domain, s3 is newer than the snapshot
+        CHECK(table.OnEvent("revoked", {{"sessionId", "s1"}}));
+        CHECK(table.OnEvent("updated", Session("s2", "b2.example")));
+        CHECK(table.OnEvent("created", Session("s3", "c.example")));
+        CHECK(!table.Live() && table.Size() == 0);
+        CHECK(Answer(table, "s2") == "daemon");
+
+        // s4 has already expired, s5's expiry cannot be read
+        nlohmann::json unreadable = {{"sessionId", "s5"}, {"appDomain", "e.example"}, {"expiresAt", "soon"}};
+        CHECK(table.Seed(generation, Snapshot({ Session("s1", "a.example"), Session("s2", "b.example"),
+                                                Session("s4", "d.example", -1000), unreadable })) ==
+              BRC100SessionTable::kSeeded);
+        CHECK(table.Live());
+        CHECK(table.Size() == 2);
+
+        CHECK(Answer(table, "s1") == "daemon");
+        CHECK(Answer(table, "s2") == "valid");
+        CHECK(Answer(table, "s3") == "valid");
+        // Neither is held, so the daemon decides, rather than this answering "not found"
+        CHECK(Answer(table, "s4") == "daemon");
+        CHECK(Answer(table, "s5") == "daemon");
+        CHECK(table.GetStats()["unreadable"] == 1);
+
+        CHECK(table.DomainHasSession("b2.example") && !table.DomainHasSession("b.example"));
+        CHECK(table.DomainHasSession("c.example") && !table.DomainHasSession("a.example"));
+
+        // A second snapshot for the same connection is stale
+        CHECK(table.Seed(generation, Snapshot({})) == BRC100SessionTable::kStale);
+        CHECK(table.Size() == 2);
+    }
+
+    void CheckRevokeAndExpiry() {
+        BRC100SessionTable table;
+        CHECK(table.Seed(table.BeginSeeding(), Snapshot({ Session("s1", "a.example"), Session("s2", "a.example"),
+                                                          Session("s3", "b.example", 50) })) ==
+              BRC100SessionTable::kSeeded);
+
+        // One of the domain's two sessions is revoked: the domain is still signed in
+        CHECK(table.OnEvent("revoked", {{"sessionId", "s1"}}));
+        CHECK(Answer(table, "s1") == "daemon");
+        CHECK(table.DomainHasSession("a.example"));
+        CHECK(table.OnEvent("expired", {{"sessionId", "s2"}}));
+        CHECK(!table.DomainHasSession("a.example"));
+        CHECK(table.Size() == 1);
+
+        // Events without a change or session id change nothing
+        CHECK(!table.OnEvent("", Session("s9", "z.example")));
+        CHECK(!table.OnEvent("created", {{"appDomain", "z.example"}}));
+        CHECK(!table.OnEvent("created", {{"sessionId", 9}}));
+        CHECK(!table.OnEvent("created", nlohmann::json::array()));
+        CHECK(table.Size() == 1);
+
+        // Held past its expiry: reported expired as the daemon would, then forgotten
+        CHECK(Answer(table, "s3") == "valid");
+        std::this_thread::sleep_for(std::chrono::milliseconds(80));
+        CHECK(Answer(table, "s3") == "Failed to validate session: session expired: s3");
+        CHECK(Answer(table, "s3") == "daemon");
+        CHECK(table.Size() == 0);
+
+        std::string response;
+        CHECK(!table.Validate("{}", response));
+        CHECK(!table.Validate("not json", response));
+        CHECK(!table.Validate(nlohmann::json{{"sessionId", 3}}.dump(), response));
+    }
+
+    void CheckStreamLoss() {
+        BRC100SessionTable table;
+        CHECK(!table.Drop());
+
+        CHECK(table.Seed(table.BeginSeeding(), Snapshot({ Session("s1", "a.example") })) == BRC100SessionTable::kSeeded);
+        CHECK(Answer(table, "s1") == "valid");
+
+        // Dropped: a restarted daemon may have forgotten s1, so nothing is answered locally
+        CHECK(table.Drop());
+        CHECK(!table.Live() && table.Size() == 0);
+        CHECK(Answer(table, "s1") == "daemon");
+        CHECK(!table.DomainHasSession("a.example"));
+
+        // A snapshot fetched for a connection that dropped before it arrived is ignored
+        uint64_t generation = table.BeginSeeding();
+        table.Drop();
+        CHECK(table.Seed(generation, Snapshot({ Session("s1", "a.example") })) == BRC100SessionTable::kStale);
+        CHECK(!table.Live());
+
+        // So is one from before a reconnect
+        uint64_t older = table.BeginSeeding();
+        uint64_t newer = table.BeginSeeding();
+        CHECK(table.Seed(older, Snapshot({ Session("s1", "a.example") })) == BRC100SessionTable::kStale);
+        CHECK(table.Seed(newer, Snapshot({ Session("s2", "b.example") })) == BRC100SessionTable::kSeeded);
+        CHECK(Answer(table, "s1") == "daemon" && Answer(table, "s2") == "valid");
+
+        // A daemon that will not list sessions (an error, or not on its socket) leaves the table unseeded
+        table.Drop();
+        generation = table.BeginSeeding();
+        CHECK(table.Seed(generation, {{"success", false}}) == BRC100SessionTable::kNotListed);
+        CHECK(!table.Live());
+        CHECK(table.Seed(table.BeginSeeding(), nlohmann::json::object()) == BRC100SessionTable::kNotListed);
+        CHECK(table.Seed(table.BeginSeeding(), "Only served on the local socket") == BRC100SessionTable::kNotListed);
+        CHECK(Answer(table, "s2") == "daemon");
+    }
+}
+
+int main() {
+    CheckExpiresAt();
+    CheckUnseeded();
+    CheckSeedingReplaysEvents();
+    CheckRevokeAndExpiry();
+    CheckStreamLoss();
+    return TestSupport::Result();
+}
@@ -0,0 +1,297 @@
+// DaemonChannel against the daemon's side of the shared-memory layout, driven by hand: what makes
+// it attach, the frames it writes and when it wakes the daemon, answers matched back to their
+// calls by id, the request ring filling up (the daemon's read position included, not only calls
+// outstanding), and calls handed back when the daemon goes away or stops answering. Then a
+// batched load against the daemon's echo loop, checking every answer.
+
+#include "DaemonChannel.h"
+#include "ChannelDaemon.h"
+#include "TestSupport.h"
+#include <map>
+#include <mutex>
+
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+void Logger::Log(const std::string&, int, int) {}
+
+namespace {
+    using namespace ChannelLayout;
+
+    template <typename Condition>
+    bool WaitFor(Condition condition, int timeoutMs = 2000) {
+        int64_t deadline = TestSupport::NowMicros() + timeoutMs * 1000;
+        while (!condition()) {
+            if (TestSupport::NowMicros() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    // What came back for each call, by the order it was submitted in
+    class Answers {
+    public:
+        DaemonChannel::Callback For(int call) {
+            return [this, call](int status, std::string body) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                answers_[call] = { status, std::move(body) };
+            };
+        }
+
+        size_t Count() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return answers_.size();
+        }
+
+        bool Has(int call, int status, const std::string& body = "") {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = answers_.find(call);
+            return it != answers_.end() && it->second.first == status && it->second.second == body;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::map<int, std::pair<int, std::string>> answers_;
+    };
+
+    // Starts a channel on daemon's objects and gives it time to try attaching
+    bool Attaches(ChannelDaemon& daemon) {
+        DaemonChannel channel(daemon.Name());
+        channel.Start();
+        bool connected = WaitFor([&channel] { return channel.Connected(); }, 100);
+        channel.Stop();
+        return connected;
+    }
+
+    void CheckAttach() {
+        ChannelDaemon daemon;
+        CHECK(daemon.Ok());
+        CHECK(!Attaches(daemon));
+        daemon.Ready(false);
+        CHECK(!Attaches(daemon));
+        daemon.Ready(true, kVersion + 1);
+        CHECK(!Attaches(daemon));
+        daemon.Ready(true, kVersion, kMagic + 1);
+        CHECK(!Attaches(daemon));
+        daemon.Ready(true);
+        CHECK(Attaches(daemon));
+
+        // Objects planted by another user under the daemon's name are never mapped
+        if (geteuid() == 0) {
+            CHECK(daemon.GiveTo(65534));
+            CHECK(!Attaches(daemon));
+        }
+
+        // Nothing under that name at all
+        DaemonChannel channel(L"BabbageChannelTest.missing");
+        channel.Start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        CHECK(!channel.Connected());
+        CHECK(!channel.Submit(DaemonChannel::kCreateHmac, "{}", [](int, std::string) {}));
+        channel.Stop();
+    }
+
+    void CheckFramesAndAnswers() {
+        ChannelDaemon daemon;
+        daemon.Ready(true);
+        DaemonChannel channel(daemon.Name());
+        channel.Start();
+        CHECK(WaitFor([&channel] { return channel.Connected(); }));
+        Answers answers;
+
+        // A sleeping daemon is woken once
+        daemon.Word(kOffDaemonWaiting)->store(1);
+        CHECK(channel.Submit(DaemonChannel::kGetPublicKey, "{\"identityKey\":true}", answers.For(0)));
+        CHECK(daemon.Word(kOffRequestHead)->load() == 1);
+        CHECK(daemon.Word(kOffDaemonWaiting)->load() == 0);
+        CHECK(daemon.TakeWakeup() && !daemon.TakeWakeup());
+        std::string body;
+        Frame first = daemon.ReadRequest(0, body);
+        CHECK(first.length == body.size() && body == "{\"identityKey\":true}");
+        CHECK(first.op == DaemonChannel::kGetPublicKey && first.status == 0 && first.reserved == 0);
+
+        // An awake one is not
+        CHECK(channel.Submit(DaemonChannel::kCreateSignature, "{}", answers.For(1)));
+        CHECK(!daemon.TakeWakeup());
+
+        // A batch is published at once, with one wakeup
+        daemon.Word(kOffDaemonWaiting)->store(1);
+        std::vector<DaemonChannel::Call> calls;
+        for (int i = 2; i < 5; i++) {
+            calls.push_back({ DaemonChannel::kCreateHmac, "{\"n\":" + std::to_string(i) + "}", answers.For(i) });
+        }
+        CHECK(channel.SubmitBatch(calls) == 3);
+        CHECK(daemon.Word(kOffRequestHead)->load() == 5);
+        CHECK(daemon.TakeWakeup() && !daemon.TakeWakeup());
+        CHECK(channel.GetStats()["daemonWakeups"] == 2 && channel.GetStats()["batches"] == 3);
+
+        // Every call has an id of its own
+        std::vector<Frame> frames;
+        for (uint32_t i = 0; i < 5; i++) {
+            frames.push_back(daemon.ReadRequest(i, body));
+            CHECK(i == 0 || frames[i].id != frames[i - 1].id);
+        }
+        CHECK(daemon.ReadRequest(3, body).op == DaemonChannel::kCreateHmac && body == "{\"n\":3}");
+
+        // A body that does not fit a slot goes over HTTP
+        CHECK(!channel.Submit(DaemonChannel::kCreateHmac, std::string(kMaxPayload + 1, 'x'), answers.For(99)));
+        CHECK(channel.Submit(DaemonChannel::kCreateHmac, std::string(kMaxPayload, 'x'), answers.For(5)));
+        CHECK(daemon.ReadRequest(5, body).length == kMaxPayload && body == std::string(kMaxPayload, 'x'));
+
+        // Answers in any order, matched by id; an unknown id is dropped, and an answer too large
+        // for a slot hands its call back with status 0
+        Frame answer = frames[3];
+        answer.status = 200;
+        answer.length = 5;
+        daemon.WriteAnswer(0, answer, "three");
+        Frame unknown = { 2, 0xDEAD, DaemonChannel::kCreateHmac, 200, 0 };
+        daemon.WriteAnswer(1, unknown, "{}");
+        Frame tooLarge = frames[1];
+        tooLarge.status = kStatusTooLarge;
+        tooLarge.length = 0;
+        daemon.WriteAnswer(2, tooLarge, "");
+        Frame failed = frames[0];
+        failed.status = 500;
+        failed.length = 2;
+        daemon.WriteAnswer(3, failed, "{}");
+        daemon.Publish(6, 4);
+        CHECK(WaitFor([&answers] { return answers.Count() == 3; }));
+        CHECK(answers.Has(3, 200, "three"));
+        CHECK(answers.Has(1, 0));
+        CHECK(answers.Has(0, 500, "{}"));
+        CHECK(WaitFor([&daemon] { return daemon.Word(kOffAnswerTail)->load() == 4; }));
+        CHECK(channel.GetStats()["answered"] == 4);
+
+        // A daemon that shut down hands the rest back for HTTP
+        daemon.Ready(false);
+        CHECK(WaitFor([&answers] { return answers.Count() == 6; }));
+        CHECK(answers.Has(2, 0) && answers.Has(4, 0) && answers.Has(5, 0));
+        CHECK(!channel.Connected());
+        CHECK(!channel.Submit(DaemonChannel::kCreateHmac, "{}", answers.For(6)));
+        channel.Stop();
+    }
+
+    void CheckRingFull() {
+        ChannelDaemon daemon;
+        daemon.Ready(true);
+        DaemonChannel channel(daemon.Name());
+        channel.Start();
+        CHECK(WaitFor([&channel] { return channel.Connected(); }));
+        Answers answers;
+
+        std::vector<DaemonChannel::Call> calls;
+        for (uint32_t i = 0; i < kSlotCount + 10; i++) {
+            calls.push_back({ DaemonChannel::kCreateHmac, "{}", answers.For(static_cast<int>(i)) });
+        }
+        CHECK(channel.SubmitBatch(calls) == kSlotCount);
+        CHECK(channel.GetStats()["rejected"] == 10);
+
+        // Every call is answered, but the daemon has not moved its read position: the ring is
+        // still full even though nothing is outstanding
+        std::string body;
+        for (uint32_t i = 0; i < kSlotCount; i++) {
+            Frame frame = daemon.ReadRequest(i, body);
+            frame.status = 200;
+            frame.length = 0;
+            daemon.WriteAnswer(i, frame, "");
+        }
+        daemon.Publish(0, kSlotCount);
+        CHECK(WaitFor([&answers] { return answers.Count() == kSlotCount; }));
+        CHECK(!channel.Submit(DaemonChannel::kCreateHmac, "{}", answers.For(1000)));
+
+        // Each slot the daemon reads frees one
+        daemon.Publish(3, kSlotCount);
+        calls.clear();
+        for (int i = 0; i < 5; i++) {
+            calls.push_back({ DaemonChannel::kCreateHmac, "{}", answers.For(1001 + i) });
+        }
+        CHECK(channel.SubmitBatch(calls) == 3);
+        CHECK(daemon.Word(kOffRequestHead)->load() == kSlotCount + 3);
+        channel.Stop();
+    }
+
+    void CheckHungDaemon() {
+        ChannelDaemon daemon;
+        daemon.Ready(true);
+        DaemonChannel channel(daemon.Name());
+        channel.Start();
+        CHECK(WaitFor([&channel] { return channel.Connected(); }));
+        Answers answers;
+
+        // The daemon reads nothing and answers nothing: the calls time out, the channel lets go
+        // and attaches again, and finds the ring as full as it left it
+        std::vector<DaemonChannel::Call> calls;
+        for (uint32_t i = 0; i < kSlotCount; i++) {
+            calls.push_back({ DaemonChannel::kCreateHmac, "{}", answers.For(static_cast<int>(i)) });
+        }
+        CHECK(channel.SubmitBatch(calls) == kSlotCount);
+        CHECK(WaitFor([&answers] { return answers.Count() == kSlotCount; }, 5000));
+        CHECK(answers.Has(0, 0) && answers.Has(kSlotCount - 1, 0));
+        CHECK(channel.GetStats()["timeouts"] == kSlotCount);
+        CHECK(WaitFor([&channel] { return channel.GetStats()["attaches"] == 2 && channel.Connected(); }, 5000));
+        CHECK(!channel.Submit(DaemonChannel::kCreateHmac, "{}", answers.For(1000)));
+
+        // Once the daemon catches up the channel carries on after what it wrote before
+        daemon.Publish(kSlotCount, 0);
+        CHECK(channel.Submit(DaemonChannel::kCreateHmac, "{\"after\":1}", answers.For(1001)));
+        std::string body;
+        daemon.ReadRequest(kSlotCount, body);
+        CHECK(body == "{\"after\":1}");
+        channel.Stop();
+    }
+
+    void CheckEchoLoad() {
+        ChannelDaemon daemon;
+        daemon.Ready(true);
+        daemon.StartEcho();
+        DaemonChannel channel(daemon.Name());
+        channel.Start();
+        CHECK(WaitFor([&channel] { return channel.Connected(); }));
+
+        const size_t kCalls = 20000;
+        std::atomic<size_t> answered{0};
+        std::atomic<size_t> mismatched{0};
+        size_t submitted = 0;
+        while (submitted < kCalls) {
+            std::vector<DaemonChannel::Call> calls;
+            // Batches of 1 to 64, bounded by what is outstanding
+            size_t batch = (std::min)(submitted % 64 + 1, kCalls - submitted);
+            if (submitted - answered.load() + batch > kSlotCount) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (size_t i = submitted; i < submitted + batch; i++) {
+                std::string body = "{\"message\":\"call-" + std::to_string(i) + "\"}";
+                calls.push_back({ DaemonChannel::kCreateHmac, body, [&answered, &mismatched, body](int status, std::string answer) {
+                    if (status != 200 || answer != body) {
+                        mismatched++;
+                    }
+                    answered++;
+                } });
+            }
+            size_t queued = channel.SubmitBatch(calls);
+            CHECK(queued == batch);
+            submitted += queued;
+            if (queued == 0) {
+                break;
+            }
+        }
+        CHECK(WaitFor([&answered] { return answered.load() == kCalls; }, 10000));
+        CHECK(mismatched == 0);
+        CHECK(channel.GetStats()["timeouts"] == 0);
+        channel.Stop();
+    }
+}
+
+int main() {
+    CheckAttach();
+    CheckFramesAndAnswers();
+    CheckRingFull();
+    CheckHungDaemon();
+    CheckEchoLoad();
+    return TestSupport::Result();
+}
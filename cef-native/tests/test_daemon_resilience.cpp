@@ -0,0 +1,358 @@
+// DaemonCircuitBreaker and DaemonDeadline: nested deadline scopes, the route policies, tripping
+// on consecutive failures and on the failure rate, the open / half-open / closed cycle with its
+// doubling cool-down, the quick retry of failed reads, and hedging: a hedge that answers first
+// cancels the first attempt, none is sent for a quick answer or without budget, and only a few
+// are ever out at once.
+
+#include "DaemonResilience.h"
+#include "TestSupport.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+void Logger::Log(const std::string&, int, int) {}
+
+namespace {
+    using Breaker = DaemonCircuitBreaker;
+    using Outcome = Breaker::Outcome;
+
+    const DaemonRoutePolicy kRead = {1000, true, false};
+    const DaemonRoutePolicy kWrite = {1000, false, false};
+    const DaemonRoutePolicy kProbe = {1000, true, true};
+
+    void Sleep(int ms) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    }
+
+    Breaker::Attempt Answers(std::atomic<int>* attempts = nullptr) {
+        return [attempts](uint32_t, int& status, std::string& body) {
+            if (attempts) {
+                (*attempts)++;
+            }
+            status = 200;
+            body = "{}";
+            return true;
+        };
+    }
+
+    Breaker::Attempt Fails(std::atomic<int>* attempts = nullptr) {
+        return [attempts](uint32_t, int&, std::string&) {
+            if (attempts) {
+                (*attempts)++;
+            }
+            return false;
+        };
+    }
+
+    Outcome Call(Breaker& breaker, const DaemonRoutePolicy& policy, const Breaker::Attempt& attempt) {
+        int status = 0;
+        std::string body;
+        return breaker.Call(policy, attempt, status, body);
+    }
+
+    // An attempt that blocks until its timeout or until Cancel(), as a stalled request does
+    class Stalled {
+    public:
+        Breaker::Attempt Attempt() {
+            return [this](uint32_t timeoutMs, int&, std::string&) {
+                std::unique_lock<std::mutex> lock(mutex_);
+                changed_.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return canceled_; });
+                return false;
+            };
+        }
+
+        void Cancel() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            canceled_ = true;
+            cancels_++;
+            changed_.notify_all();
+        }
+
+        int Cancels() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return cancels_;
+        }
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable changed_;
+        bool canceled_ = false;
+        int cancels_ = 0;
+    };
+
+    void CheckDeadlines() {
+        CHECK(DaemonDeadline::RemainingMs(5000) == 5000);
+        {
+            DaemonDeadline::Scope outer(100);
+            CHECK(DaemonDeadline::RemainingMs(5000) <= 100 && DaemonDeadline::RemainingMs(5000) >= 90);
+            CHECK(DaemonDeadline::RemainingMs(20) == 20);
+            {
+                // An inner scope never extends the outer one
+                DaemonDeadline::Scope longer(10000);
+                CHECK(DaemonDeadline::RemainingMs(5000) <= 100);
+                DaemonDeadline::Scope shorter(10);
+                CHECK(DaemonDeadline::RemainingMs(5000) <= 10);
+            }
+            CHECK(DaemonDeadline::RemainingMs(5000) > 10);
+            Sleep(110);
+            CHECK(DaemonDeadline::RemainingMs(5000) == 0);
+
+            // Nothing is sent once the deadline has passed
+            Breaker breaker;
+            std::atomic<int> attempts{0};
+            CHECK(Call(breaker, kRead, Answers(&attempts)) == Outcome::FailedFast);
+            CHECK(attempts == 0);
+        }
+        CHECK(DaemonDeadline::RemainingMs(5000) == 5000);
+
+        // Scopes are per thread
+        DaemonDeadline::Scope scope(50);
+        uint32_t elsewhere = 0;
+        std::thread([&elsewhere] { elsewhere = DaemonDeadline::RemainingMs(5000); }).join();
+        CHECK(elsewhere == 5000);
+    }
+
+    void CheckRoutePolicies() {
+        auto same = [](const DaemonRoutePolicy& policy, uint32_t budgetMs, bool idempotent, bool probe) {
+            return policy.budgetMs == budgetMs && policy.idempotent == idempotent && policy.probe == probe;
+        };
+        CHECK(same(DaemonRoutePolicy::For("GET", "/health"), 2000, true, true));
+        CHECK(same(DaemonRoutePolicy::For("GET", "/transaction/history?limit=50"), 15000, true, false));
+        CHECK(same(DaemonRoutePolicy::For("GET", "/wallet/balance"), 5000, true, false));
+        CHECK(same(DaemonRoutePolicy::For("POST", "/getPublicKey"), 10000, true, false));
+        CHECK(same(DaemonRoutePolicy::For("POST", "/verifyHmac?x=1"), 10000, true, false));
+        CHECK(same(DaemonRoutePolicy::For("POST", "/transaction/send"), 30000, false, false));
+        CHECK(same(DaemonRoutePolicy::For("POST", "/createSignature"), 15000, false, false));
+    }
+
+    void CheckTripsOnConsecutiveFailures() {
+        Breaker breaker;
+        std::atomic<int> attempts{0};
+        for (int i = 0; i < 4; i++) {
+            CHECK(Call(breaker, kWrite, Fails(&attempts)) == Outcome::Failed);
+        }
+        CHECK(breaker.state() == Breaker::State::Closed);
+        CHECK(Call(breaker, kWrite, Fails(&attempts)) == Outcome::Failed);
+        CHECK(breaker.state() == Breaker::State::Open);
+        CHECK(attempts == 5);
+
+        // Open: calls fail without being sent, except probes
+        CHECK(Call(breaker, kRead, Answers(&attempts)) == Outcome::FailedFast);
+        CHECK(attempts == 5);
+        CHECK(Call(breaker, kProbe, Answers(&attempts)) == Outcome::Answered);
+        CHECK(attempts == 6);
+        // and an answer closes it
+        CHECK(breaker.state() == Breaker::State::Closed);
+
+        nlohmann::json stats = breaker.GetStats();
+        CHECK(stats["trips"] == 1 && stats["calls"] == 7);
+        CHECK(stats["outcomes"]["failed"] == 5 && stats["outcomes"]["failedFast"] == 1);
+    }
+
+    void CheckTripsOnFailureRate() {
+        Breaker breaker;
+        // Never five failures in a row, but half of the last ten
+        for (int i = 0; i < 9; i++) {
+            Call(breaker, kWrite, i % 2 == 0 ? Answers() : Fails());
+        }
+        CHECK(breaker.state() == Breaker::State::Closed);
+        Call(breaker, kWrite, Fails());
+        CHECK(breaker.state() == Breaker::State::Open);
+
+        // A mostly healthy daemon is not
+        Breaker healthy;
+        for (int i = 0; i < 100; i++) {
+            Call(healthy, kWrite, i % 3 == 0 ? Fails() : Answers());
+        }
+        CHECK(healthy.state() == Breaker::State::Closed);
+    }
+
+    void CheckHalfOpen() {
+        Breaker breaker;
+        for (int i = 0; i < 5; i++) {
+            breaker.OnFailure();
+        }
+        CHECK(breaker.state() == Breaker::State::Open);
+        CHECK(breaker.GetStats()["coolDownMs"] == 1000);
+        CHECK(!breaker.Allow());
+
+        // After the cool-down a single probe goes through
+        Sleep(1050);
+        CHECK(breaker.Allow());
+        CHECK(breaker.state() == Breaker::State::HalfOpen);
+        CHECK(!breaker.Allow());
+
+        // It fails: open again for twice as long
+        breaker.OnFailure();
+        CHECK(breaker.state() == Breaker::State::Open);
+        CHECK(breaker.GetStats()["coolDownMs"] == 2000);
+        Sleep(1050);
+        CHECK(!breaker.Allow());
+        Sleep(1000);
+        CHECK(breaker.Allow());
+
+        // It answers: closed, and the next trip starts from the first cool-down again
+        breaker.OnSuccess(1000);
+        CHECK(breaker.state() == Breaker::State::Closed);
+        CHECK(breaker.GetStats()["coolDownMs"] == 0);
+        CHECK(breaker.Allow() && breaker.Allow());
+        CHECK(breaker.GetStats()["trips"] == 1);
+    }
+
+    void CheckRetry() {
+        Breaker breaker;
+        std::atomic<int> attempts{0};
+        // A read that fails fast is tried once more
+        Breaker::Attempt flaky = [&attempts](uint32_t, int& status, std::string&) {
+            status = 200;
+            return attempts++ > 0;
+        };
+        CHECK(Call(breaker, kRead, flaky) == Outcome::Answered);
+        CHECK(attempts == 2);
+        CHECK(breaker.GetStats()["retries"] == 1);
+
+        // A write is not, and nor is a read that used up half its budget
+        attempts = 0;
+        CHECK(Call(breaker, kWrite, Fails(&attempts)) == Outcome::Failed);
+        CHECK(attempts == 1);
+        Breaker::Attempt slow = [&attempts](uint32_t timeoutMs, int&, std::string&) {
+            attempts++;
+            Sleep(static_cast<int>(timeoutMs));
+            return false;
+        };
+        attempts = 0;
+        CHECK(Call(breaker, {100, true, false}, slow) == Outcome::TimedOut);
+        CHECK(attempts == 1);
+        CHECK(breaker.GetStats()["retries"] == 1);
+    }
+
+    // Quick answers give the breaker its latency samples and hedge tokens
+    void Warm(Breaker& breaker, int calls) {
+        for (int i = 0; i < calls; i++) {
+            Call(breaker, kRead, Answers());
+        }
+    }
+
+    void CheckHedgeWins() {
+        Breaker breaker;
+        Warm(breaker, 30);
+
+        Stalled first;
+        std::atomic<int> hedgesMade{0};
+        int status = 0;
+        std::string body;
+        int64_t start = TestSupport::NowMicros();
+        Outcome outcome = breaker.CallHedged(kRead, first.Attempt(), [&first] { first.Cancel(); },
+                                             [&hedgesMade]() -> Breaker::Attempt {
+                                                 hedgesMade++;
+                                                 return [](uint32_t, int& hedgeStatus, std::string& hedgeBody) {
+                                                     hedgeStatus = 200;
+                                                     hedgeBody = "hedge";
+                                                     return true;
+                                                 };
+                                             }, status, body);
+        int64_t elapsed = TestSupport::NowMicros() - start;
+        CHECK(outcome == Outcome::Answered && status == 200 && body == "hedge");
+        CHECK(hedgesMade == 1 && first.Cancels() == 1);
+        // Sent after the recent p95, floored at 10 ms, not after half the budget
+        CHECK_MSG(elapsed < 200000, std::to_string(elapsed));
+        nlohmann::json stats = breaker.GetStats();
+        CHECK(stats["hedges"] == 1 && stats["hedgeWins"] == 1 && stats["retries"] == 0);
+
+        // A quick answer sends nothing
+        hedgesMade = 0;
+        for (int i = 0; i < 20; i++) {
+            CHECK(breaker.CallHedged(kRead, Answers(), [] {}, [&hedgesMade]() -> Breaker::Attempt {
+                hedgesMade++;
+                return Answers();
+            }, status, body) == Outcome::Answered);
+        }
+        Sleep(50);
+        CHECK(hedgesMade == 0);
+        CHECK(breaker.GetStats()["hedges"] == 1);
+    }
+
+    void CheckHedgeBudget() {
+        // Without tokens the first attempt is left to finish on its own
+        Breaker breaker;
+        std::atomic<int> hedgesMade{0};
+        int status = 0;
+        std::string body;
+        Breaker::Attempt slowAnswer = [](uint32_t, int& attemptStatus, std::string&) {
+            Sleep(80);
+            attemptStatus = 200;
+            return true;
+        };
+        CHECK(breaker.CallHedged({100, true, false}, slowAnswer, [] {}, [&hedgesMade]() -> Breaker::Attempt {
+            hedgesMade++;
+            return Answers();
+        }, status, body) == Outcome::Answered);
+        CHECK(hedgesMade == 0);
+
+        // Both attempts fail: the call fails once the hedge has come back
+        Warm(breaker, 30);
+        Stalled first;
+        Outcome outcome = breaker.CallHedged({300, true, false}, first.Attempt(), [&first] { first.Cancel(); },
+                                             [] { return Fails(); }, status, body);
+        CHECK(outcome == Outcome::TimedOut);
+        CHECK(first.Cancels() == 0);
+        CHECK(breaker.GetStats()["hedges"] == 1 && breaker.GetStats()["hedgeWins"] == 0);
+    }
+
+    void CheckHedgesCapped() {
+        Breaker breaker;
+        Warm(breaker, 100);
+
+        // Eight reads stall at once, and so does every hedge sent for them
+        const int kReads = 8;
+        std::vector<std::unique_ptr<Stalled>> firsts;
+        std::vector<std::thread> readers;
+        std::atomic<int> hedgesMade{0};
+        for (int i = 0; i < kReads; i++) {
+            firsts.emplace_back(new Stalled());
+        }
+        for (int i = 0; i < kReads; i++) {
+            Stalled* first = firsts[i].get();
+            readers.emplace_back([&breaker, first, &hedgesMade] {
+                int status = 0;
+                std::string body;
+                breaker.CallHedged({300, true, false}, first->Attempt(), [first] { first->Cancel(); },
+                                   [&hedgesMade]() -> Breaker::Attempt {
+                                       hedgesMade++;
+                                       auto hedge = std::make_shared<Stalled>();
+                                       return [hedge](uint32_t timeoutMs, int& hedgeStatus, std::string& hedgeBody) {
+                                           return hedge->Attempt()(timeoutMs, hedgeStatus, hedgeBody);
+                                       };
+                                   }, status, body);
+            });
+        }
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        nlohmann::json stats = breaker.GetStats();
+        CHECK(hedgesMade == 4 && stats["hedges"] == 4);
+        CHECK(stats["hedgesCapped"] == kReads - 4);
+        // Hedges run to their own timeout, then free their place
+        Sleep(100);
+        CHECK(breaker.GetStats()["hedgesInFlight"] == 0);
+    }
+}
+
+int main() {
+    CheckDeadlines();
+    CheckRoutePolicies();
+    CheckTripsOnConsecutiveFailures();
+    CheckTripsOnFailureRate();
+    CheckHalfOpen();
+    CheckRetry();
+    CheckHedgeWins();
+    CheckHedgeBudget();
+    CheckHedgesCapped();
+    return TestSupport::Result();
+}
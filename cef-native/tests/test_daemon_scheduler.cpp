@@ -0,0 +1,98 @@
+// DaemonScheduler admission: a site flooding the daemon holds every shared slot and fills its
+// queue, yet UI calls are still admitted at once; the flood is shed at its own rate and queue
+// limits, and another site waiting behind it gets the next turn.
+
+#include "DaemonScheduler.h"
+#include "TestSupport.h"
+#include <map>
+
+namespace {
+    const char* const kFlood = "flood.example";
+    const char* const kQuiet = "quiet.example";
+
+    void CheckUiAdmittedUnderFlood() {
+        std::map<DaemonScheduler::Verdict, int> verdicts;
+        DaemonScheduler scheduler;
+
+        // Nothing is released, so the flood keeps every shared slot and its queue stays full
+        for (int i = 0; i < 1000; i++) {
+            scheduler.Submit(DaemonScheduler::kDapp, kFlood, [&verdicts](DaemonScheduler::Verdict verdict) {
+                verdicts[verdict]++;
+            });
+        }
+        nlohmann::json dapp = scheduler.GetStats()["classes"]["dapp"];
+        CHECK(dapp["inFlight"] == scheduler.GetStats()["sharedSlots"]);
+        CHECK(dapp["waiting"].get<int>() > 0);
+        CHECK(verdicts[DaemonScheduler::kAdmitted] == dapp["inFlight"].get<int>());
+        CHECK(verdicts[DaemonScheduler::kRateLimited] + verdicts[DaemonScheduler::kQueueFull] > 0);
+
+        // A UI call is answered before Submit returns, and Acquire does not wait out the dApp deadline
+        bool admitted = false;
+        scheduler.Submit(DaemonScheduler::kUi, "", [&admitted](DaemonScheduler::Verdict verdict) {
+            admitted = verdict == DaemonScheduler::kAdmitted;
+        });
+        CHECK(admitted);
+        scheduler.Release(DaemonScheduler::kUi);
+
+        for (int i = 0; i < 100; i++) {
+            int64_t start = TestSupport::NowMicros();
+            CHECK(scheduler.Acquire(DaemonScheduler::kUi, "") == DaemonScheduler::kAdmitted);
+            CHECK_MSG(TestSupport::NowMicros() - start < 50000, "UI call " + std::to_string(i));
+            scheduler.Release(DaemonScheduler::kUi);
+        }
+
+        nlohmann::json ui = scheduler.GetStats()["classes"]["ui"];
+        CHECK(ui["verdicts"]["admitted"] == 101);
+        CHECK(ui["inFlight"] == 0);
+        CHECK(ui["p99WaitMicros"] == 0.0);
+    }
+
+    void CheckOtherSiteGetsTurn() {
+        std::vector<std::string> admittedOrder;
+        DaemonScheduler scheduler;
+        for (int i = 0; i < 20; i++) {
+            scheduler.Submit(DaemonScheduler::kDapp, kFlood, [&admittedOrder](DaemonScheduler::Verdict verdict) {
+                if (verdict == DaemonScheduler::kAdmitted) {
+                    admittedOrder.push_back(kFlood);
+                }
+            });
+        }
+        bool quietShed = false;
+        scheduler.Submit(DaemonScheduler::kDapp, kQuiet, [&](DaemonScheduler::Verdict verdict) {
+            if (verdict == DaemonScheduler::kAdmitted) {
+                admittedOrder.push_back(kQuiet);
+            } else {
+                quietShed = true;
+            }
+        });
+        CHECK(!quietShed);
+        size_t before = admittedOrder.size();
+
+        // Twelve flood calls were waiting first, but the quiet site is admitted within two frees
+        scheduler.Release(DaemonScheduler::kDapp);
+        scheduler.Release(DaemonScheduler::kDapp);
+        CHECK(admittedOrder.size() == before + 2 && admittedOrder[before + 1] == kQuiet);
+    }
+
+    void CheckCancel() {
+        int calls = 0;
+        DaemonScheduler scheduler;
+        uint64_t last = 0;
+        for (int i = 0; i < 9; i++) {
+            last = scheduler.Submit(DaemonScheduler::kDapp, kFlood, [&calls](DaemonScheduler::Verdict) { calls++; });
+        }
+        CHECK(calls == 8);
+        CHECK(scheduler.Cancel(last));
+        CHECK(!scheduler.Cancel(last));
+        scheduler.Release(DaemonScheduler::kDapp);
+        CHECK(calls == 8);
+        CHECK(scheduler.GetStats()["classes"]["dapp"]["verdicts"]["canceled"] == 1);
+    }
+}
+
+int main() {
+    CheckUiAdmittedUnderFlood();
+    CheckOtherSiteGetsTurn();
+    CheckCancel();
+    return TestSupport::Result();
+}
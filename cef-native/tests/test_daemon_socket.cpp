@@ -0,0 +1,283 @@
+// DaemonSocket against a stub daemon on a Unix socket: responses framed by Content-Length, by
+// chunked encoding and by the connection closing, split across reads however the daemon sends
+// them; the kept-alive connection, and a request sent again when the daemon had dropped it;
+// truncated and stalled responses; CancelRequest(); and Stream() up to Cancel().
+
+#include "DaemonTransport.h"
+#include "StubDaemon.h"
+#include "TestSupport.h"
+
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+
+void Logger::Log(const std::string&, int, int) {}
+
+namespace {
+    using Result = DaemonSocket::Result;
+
+    struct Response {
+        Result result;
+        int status = 0;
+        std::string body;
+    };
+
+    Response Request(DaemonSocket& socket, const std::string& method, const std::string& endpoint,
+                     const std::string& body = "", uint32_t timeoutMs = 0) {
+        Response response;
+        response.result = socket.Request(method, endpoint, body, response.status, response.body, timeoutMs);
+        return response;
+    }
+
+    void CheckContentLength() {
+        StubDaemon::Request seen;
+        StubDaemon stub([&seen](const StubDaemon::Request& request, const StubDaemon::Send& send) {
+            seen = request;
+            return send(StubDaemon::Answer(request.method == "POST" ? 201 : 200, "{\"echo\":" + request.body + "}"));
+        });
+        CHECK(stub.Listening());
+        DaemonSocket socket(stub.Path());
+
+        Response response = Request(socket, "POST", "/wallet/sign", "{\"n\":1}");
+        CHECK(response.result == Result::Ok && response.status == 201);
+        CHECK(response.body == "{\"echo\":{\"n\":1}}");
+        CHECK(seen.method == "POST" && seen.target == "/wallet/sign" && seen.body == "{\"n\":1}");
+
+        // Answered on the same connection
+        response = Request(socket, "GET", "/wallet/status");
+        CHECK(response.result == Result::Ok && response.status == 200 && response.body == "{\"echo\":}");
+        CHECK(seen.method == "GET" && seen.body.empty());
+        CHECK(stub.Accepted() == 1);
+
+        // An empty body, and one large enough to take many reads
+        StubDaemon large([](const StubDaemon::Request& request, const StubDaemon::Send& send) {
+            return send(StubDaemon::Answer(204, request.target == "/large" ? std::string(3 << 20, 'x') : ""));
+        });
+        DaemonSocket largeSocket(large.Path());
+        response = Request(largeSocket, "GET", "/empty");
+        CHECK(response.result == Result::Ok && response.status == 204 && response.body.empty());
+        response = Request(largeSocket, "GET", "/large");
+        CHECK(response.result == Result::Ok && response.body == std::string(3 << 20, 'x'));
+        CHECK(large.Accepted() == 1);
+    }
+
+    void CheckChunked() {
+        StubDaemon stub([&](const StubDaemon::Request&, const StubDaemon::Send& send) {
+            // Split mid-line, between "\r" and "\n", and with an extension and a trailer
+            const char* pieces[] = {
+                "HTTP/1.1 200 OK\r\nTransfer-Encoding: chu", "nked\r\n\r\n5\r", "\nhello\r\n",
+                "1;name=value\r\n,\r\n", "6\r\n world\r\n0\r\nX-Trailer: 1\r", "\n\r\n"
+            };
+            for (const char* piece : pieces) {
+                if (!send(piece) || !stub.Wait(2)) {
+                    return false;
+                }
+            }
+            return true;
+        });
+        DaemonSocket socket(stub.Path());
+        for (int i = 0; i < 2; i++) {
+            Response response = Request(socket, "GET", "/wallet/events");
+            CHECK(response.result == Result::Ok && response.status == 200 && response.body == "hello, world");
+        }
+        CHECK(stub.Accepted() == 1);
+    }
+
+    void CheckReadToClose() {
+        StubDaemon stub([&](const StubDaemon::Request& request, const StubDaemon::Send& send) {
+            if (request.target == "/http10") {
+                send("HTTP/1.0 200 OK\r\nContent-Length: 2\r\n\r\nok");
+                return true;
+            }
+            if (request.target == "/close") {
+                send(StubDaemon::Answer(200, "bye", "Connection: close\r\n"));
+                return true;
+            }
+            // No length: the body runs until the connection ends
+            send("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n\r\n{\"a\":");
+            stub.Wait(5);
+            send("1}");
+            return false;
+        });
+        DaemonSocket socket(stub.Path());
+        Response response = Request(socket, "GET", "/unframed");
+        CHECK(response.result == Result::Ok && response.body == "{\"a\":1}");
+        CHECK(stub.Accepted() == 1);
+
+        // Each of these ends its connection, so the next request opens another
+        response = Request(socket, "GET", "/http10");
+        CHECK(response.result == Result::Ok && response.body == "ok");
+        CHECK(stub.Accepted() == 2);
+        response = Request(socket, "GET", "/close");
+        CHECK(response.result == Result::Ok && response.body == "bye");
+        CHECK(stub.Accepted() == 3);
+        response = Request(socket, "GET", "/close");
+        CHECK(response.result == Result::Ok);
+        CHECK(stub.Accepted() == 4);
+    }
+
+    void CheckDroppedKeepAlive() {
+        std::atomic<int> requests{0};
+        // Answers as if keeping the connection, then drops it without a word
+        StubDaemon stub([&requests](const StubDaemon::Request&, const StubDaemon::Send& send) {
+            requests++;
+            send(StubDaemon::Answer(200, "{}"));
+            return false;
+        });
+        DaemonSocket socket(stub.Path());
+        for (int i = 0; i < 3; i++) {
+            Response response = Request(socket, "POST", "/wallet/pay", "{}");
+            CHECK(response.result == Result::Ok && response.status == 200);
+        }
+        // Each request was sent again on a new connection, and reached the daemon once
+        CHECK(requests == 3);
+        CHECK(stub.Accepted() == 3);
+    }
+
+    void CheckFailures() {
+        // No daemon: nothing went out, so the caller may use TCP instead
+        {
+            std::string path;
+            {
+                StubDaemon gone([](const StubDaemon::Request&, const StubDaemon::Send&) { return true; });
+                path = gone.Path();
+            }
+            DaemonSocket socket(path);
+            CHECK(Request(socket, "GET", "/wallet/status").result == Result::Unavailable);
+            CHECK(socket.Stream("/wallet/events", [] {}, [](const char*, size_t) { return true; }) == 0);
+        }
+
+        std::atomic<int> requests{0};
+        StubDaemon stub([&](const StubDaemon::Request& request, const StubDaemon::Send& send) {
+            requests++;
+            if (request.target == "/truncated") {
+                send("HTTP/1.1 200 OK\r\nContent-Length: 100\r\n\r\n{\"partial\"");
+            } else if (request.target == "/truncated-chunk") {
+                send("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n10\r\nshort");
+            } else if (request.target == "/garbage") {
+                send("SSH-2.0-OpenSSH\r\n\r\n");
+            } else if (request.target == "/huge-head") {
+                send("HTTP/1.1 200 OK\r\nX-Filler: " + std::string(100 * 1024, 'a') + "\r\n\r\n");
+            } else if (request.target == "/many-headers") {
+                std::string head = "HTTP/1.1 200 OK\r\n";
+                for (int i = 0; i < 5000; i++) {
+                    head += "X-Filler: aaaaaaaaaaaaaaaa\r\n";
+                }
+                send(head + "\r\n");
+            } else if (request.target == "/stall") {
+                stub.Wait(5000);
+            } else if (request.target == "/ok") {
+                send(StubDaemon::Answer(200, "{}"));
+                return true;
+            }
+            return false;
+        });
+        DaemonSocket socket(stub.Path());
+        for (const char* endpoint : {"/truncated", "/truncated-chunk", "/garbage", "/huge-head", "/many-headers"}) {
+            CHECK_MSG(Request(socket, "GET", endpoint).result == Result::Failed, endpoint);
+        }
+        // Something came back each time, so none was sent twice
+        CHECK(requests == 5);
+
+        // A stall is given up on at the timeout, and not sent again
+        int64_t start = TestSupport::NowMicros();
+        CHECK(Request(socket, "GET", "/stall", "", 100).result == Result::Failed);
+        int64_t elapsed = TestSupport::NowMicros() - start;
+        CHECK_MSG(elapsed >= 90000 && elapsed < 1000000, std::to_string(elapsed));
+        CHECK(requests == 6);
+
+        // Or cut short from another thread
+        std::thread canceler([&socket] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            socket.CancelRequest();
+        });
+        start = TestSupport::NowMicros();
+        CHECK(Request(socket, "GET", "/stall").result == Result::Failed);
+        elapsed = TestSupport::NowMicros() - start;
+        CHECK_MSG(elapsed < 1000000, std::to_string(elapsed));
+        canceler.join();
+        CHECK(requests == 7);
+
+        // Including on a kept-alive connection, where it is not taken for the daemon dropping it
+        // and sent again
+        CHECK(Request(socket, "GET", "/ok").result == Result::Ok);
+        std::thread keptAliveCanceler([&socket] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            socket.CancelRequest();
+        });
+        CHECK(Request(socket, "GET", "/stall").result == Result::Failed);
+        keptAliveCanceler.join();
+        CHECK(requests == 9);
+        CHECK(Request(socket, "GET", "/ok").result == Result::Ok);
+        // With nothing in flight it does nothing
+        socket.CancelRequest();
+        CHECK(Request(socket, "GET", "/ok").result == Result::Ok);
+    }
+
+    void CheckStream() {
+        StubDaemon stub([&](const StubDaemon::Request& request, const StubDaemon::Send& send) {
+            if (request.target != "/wallet/events") {
+                send(StubDaemon::Answer(404, "{}"));
+                return true;
+            }
+            if (!send("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n")) {
+                return false;
+            }
+            // Events until the client goes away
+            for (int i = 0; send("4\r\ne" + std::to_string(i % 10) + ";\n\r\n"); i++) {
+                if (!stub.Wait(1)) {
+                    return false;
+                }
+            }
+            return false;
+        });
+
+        DaemonSocket socket(stub.Path());
+        bool opened = false;
+        std::string received;
+        // Ends when onData returns false
+        int status = socket.Stream("/wallet/events", [&opened] { opened = true; },
+                                   [&received](const char* data, size_t size) {
+                                       received.append(data, size);
+                                       return received.size() < 40;
+                                   });
+        CHECK(status == 200 && opened);
+        CHECK(received.compare(0, 16, "e0;\ne1;\ne2;\ne3;\n") == 0);
+
+        // Ends at Cancel() from another thread
+        std::atomic<size_t> bytes{0};
+        std::thread streamer([&] {
+            status = socket.Stream("/wallet/events", [] {}, [&bytes](const char*, size_t size) {
+                bytes += size;
+                return true;
+            });
+        });
+        while (bytes < 100) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        socket.Cancel();
+        streamer.join();
+        CHECK(status == 200);
+
+        // Anything but a 200 is returned without opening
+        opened = false;
+        CHECK(socket.Stream("/wallet/other", [&opened] { opened = true; },
+                            [](const char*, size_t) { return true; }) == 404);
+        CHECK(!opened);
+
+        // And requests on the same socket still work alongside
+        Response response = Request(socket, "GET", "/wallet/other");
+        CHECK(response.result == Result::Ok && response.status == 404);
+    }
+}
+
+int main() {
+    CheckContentLength();
+    CheckChunked();
+    CheckReadToClose();
+    CheckDroppedKeepAlive();
+    CheckFailures();
+    CheckStream();
+    return TestSupport::Result();
+}
@@ -0,0 +1,146 @@
+// Round-trips every hex and base64 implementation this CPU can run against a naive reference,
+// at every length around the vector block sizes, and checks that bad input is rejected wherever
+// it sits (inside a vector block or in the scalar tail).
+
+#include "Encoding.h"
+#include "TestSupport.h"
+#include <cctype>
+#include <random>
+
+namespace {
+    const char* const kImplementations[] = { "scalar", "ssse3", "avx2" };
+
+    std::string ReferenceHex(const std::string& bytes) {
+        static const char digits[] = "0123456789abcdef";
+        std::string hex;
+        for (unsigned char c : bytes) {
+            hex += digits[c >> 4];
+            hex += digits[c & 0x0f];
+        }
+        return hex;
+    }
+
+    std::string ReferenceBase64(const std::string& bytes) {
+        static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string out;
+        size_t i = 0;
+        for (; i + 3 <= bytes.size(); i += 3) {
+            uint32_t v = (uint8_t(bytes[i]) << 16) | (uint8_t(bytes[i + 1]) << 8) | uint8_t(bytes[i + 2]);
+            for (int shift = 18; shift >= 0; shift -= 6) {
+                out += alphabet[(v >> shift) & 0x3f];
+            }
+        }
+        if (bytes.size() - i == 1) {
+            uint32_t v = uint8_t(bytes[i]) << 16;
+            out += alphabet[(v >> 18) & 0x3f];
+            out += alphabet[(v >> 12) & 0x3f];
+            out += "==";
+        } else if (bytes.size() - i == 2) {
+            uint32_t v = (uint8_t(bytes[i]) << 16) | (uint8_t(bytes[i + 1]) << 8);
+            out += alphabet[(v >> 18) & 0x3f];
+            out += alphabet[(v >> 12) & 0x3f];
+            out += alphabet[(v >> 6) & 0x3f];
+            out += '=';
+        }
+        return out;
+    }
+
+    std::string RandomBytes(std::mt19937& random, size_t length) {
+        std::string bytes(length, '\0');
+        for (char& c : bytes) {
+            c = static_cast<char>(random() & 0xff);
+        }
+        return bytes;
+    }
+
+    void CheckRoundTrips(const std::string& implementation) {
+        std::mt19937 random(7);
+        // Past two AVX2 blocks of every codec, so each length lands in the vector loop and the tail
+        for (size_t length = 0; length <= 160; length++) {
+            std::string bytes = RandomBytes(random, length);
+            std::string where = implementation + " length " + std::to_string(length);
+
+            std::string hex = Encoding::hexEncode(bytes);
+            CHECK_MSG(hex == ReferenceHex(bytes), where);
+            std::string decoded;
+            CHECK_MSG(Encoding::hexDecode(hex, decoded) && decoded == bytes, where);
+
+            std::string upper = hex;
+            for (char& c : upper) {
+                c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            }
+            CHECK_MSG(Encoding::hexDecode(upper, decoded) && decoded == bytes, where + " uppercase");
+
+            std::string base64 = Encoding::base64Encode(bytes);
+            CHECK_MSG(base64 == ReferenceBase64(bytes), where);
+            CHECK_MSG(Encoding::base64Decode(base64, decoded) && decoded == bytes, where);
+        }
+
+        // Every byte value, and a payload the size of a large transaction
+        std::string all;
+        for (int c = 0; c < 256; c++) {
+            all += static_cast<char>(c);
+        }
+        std::string large = RandomBytes(random, 1 << 20);
+        for (const std::string* bytes : { &all, &large }) {
+            std::string decoded;
+            CHECK_MSG(Encoding::hexDecode(Encoding::hexEncode(*bytes), decoded) && decoded == *bytes, implementation);
+            CHECK_MSG(Encoding::base64Encode(*bytes) == ReferenceBase64(*bytes), implementation);
+            CHECK_MSG(Encoding::base64Decode(Encoding::base64Encode(*bytes), decoded) && decoded == *bytes, implementation);
+        }
+    }
+
+    void CheckRejects(const std::string& implementation) {
+        std::mt19937 random(11);
+        std::string bytes = RandomBytes(random, 120);
+        const std::string hex = Encoding::hexEncode(bytes);
+        const std::string base64 = Encoding::base64Encode(bytes);
+        std::string decoded;
+
+        // One bad character at each position: in a vector block, at a block edge, in the tail
+        for (size_t position = 0; position < hex.size(); position++) {
+            for (char bad : { 'g', 'G', '/', ':', '@', '`', ' ', '\0', '\xff' }) {
+                std::string corrupt = hex;
+                corrupt[position] = bad;
+                CHECK_MSG(!Encoding::hexDecode(corrupt, decoded),
+                          implementation + " hex position " + std::to_string(position));
+            }
+        }
+        for (size_t position = 0; position < base64.size(); position++) {
+            for (char bad : { '-', '_', '.', '*', ' ', '\0', '\x80', '=' }) {
+                std::string corrupt = base64;
+                corrupt[position] = bad;
+                if (bad == '=' && position >= base64.size() - 2) {
+                    continue;
+                }
+                CHECK_MSG(!Encoding::base64Decode(corrupt, decoded),
+                          implementation + " base64 position " + std::to_string(position));
+            }
+        }
+
+        CHECK(!Encoding::hexDecode("abc", decoded));
+        CHECK(!Encoding::base64Decode("abc", decoded));
+        CHECK(!Encoding::base64Decode("ab=c", decoded));
+        CHECK(!Encoding::base64Decode("a===", decoded));
+        CHECK(Encoding::isValidHex(""));
+        CHECK(Encoding::isValidBase64(""));
+    }
+}
+
+int main() {
+    std::printf("CPU best: %s\n", Encoding::activeImplementation());
+    for (const char* implementation : kImplementations) {
+        if (!Encoding::forceImplementation(implementation)) {
+            std::printf("%s: not supported on this CPU, skipped\n", implementation);
+            continue;
+        }
+        CHECK(std::string(Encoding::activeImplementation()) == implementation);
+        CheckRoundTrips(implementation);
+        CheckRejects(implementation);
+        std::printf("%s: checked\n", implementation);
+    }
+
+    CHECK(!Encoding::forceImplementation("neon"));
+    CHECK(Encoding::forceImplementation("auto"));
+    return TestSupport::Result();
+}
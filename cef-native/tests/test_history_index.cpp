@@ -0,0 +1,95 @@
+// HistoryIndex matching and ranking: key normalisation, prefix and substring matches, frecency
+// order, and bulk replay of aggregates as log compaction writes them.
+
+#include "HistoryIndex.h"
+#include "TestSupport.h"
+
+namespace {
+    const int64_t kNowMs = 1700000000000ll;
+    const int64_t kDayMs = 24ll * 60 * 60 * 1000;
+
+    std::vector<std::string> Urls(const std::vector<HistoryIndex::Suggestion>& suggestions) {
+        std::vector<std::string> urls;
+        for (const auto& suggestion : suggestions) {
+            urls.push_back(suggestion.url);
+        }
+        return urls;
+    }
+
+    void CheckKeys() {
+        CHECK(HistoryIndex::KeyOf("HTTPS://www.Example.com/Path ") == "example.com/path");
+        CHECK(HistoryIndex::KeyOf("http://example.com") == "example.com");
+        CHECK(HistoryIndex::KeyOf("  Wallet") == "wallet");
+    }
+
+    void CheckRanking() {
+        HistoryIndex index;
+        for (int i = 0; i < 5; i++) {
+            index.AddVisit("https://alpha.com/", kNowMs - i * 1000, false);
+        }
+        index.AddVisit("https://www.alphabet.org/", kNowMs, false);
+        index.AddVisit("https://beta.net/", kNowMs, false);
+        CHECK(index.VisitCount() == 7);
+        CHECK(index.Entries().size() == 3);
+
+        // More visits rank first; "www." is not part of what the user types
+        std::vector<std::string> urls = Urls(index.Query("alp", 8, kNowMs));
+        CHECK(urls.size() == 2);
+        CHECK(!urls.empty() && urls[0] == "https://alpha.com/");
+        CHECK(Urls(index.Query("alphab", 8, kNowMs)) == std::vector<std::string>{ "https://www.alphabet.org/" });
+        CHECK(index.Query("gamma", 8, kNowMs).empty());
+        CHECK(index.Query("a", 1, kNowMs).size() == 1);
+
+        // Equal counts: the recent visit outranks the months-old one
+        HistoryIndex recency;
+        recency.AddVisit("https://example.com/old", kNowMs - 120 * kDayMs, false);
+        recency.AddVisit("https://example.com/new", kNowMs - kDayMs, false);
+        std::vector<HistoryIndex::Suggestion> both = recency.Query("example.com/", 8, kNowMs);
+        CHECK(both.size() == 2 && both[0].url == "https://example.com/new");
+        CHECK(HistoryIndex::Frecency(recency.Entries()[1], kNowMs) > HistoryIndex::Frecency(recency.Entries()[0], kNowMs));
+
+        // A typed visit counts extra
+        HistoryIndex typed;
+        typed.AddVisit("https://site-a.com/", kNowMs, false);
+        typed.AddVisit("https://site-b.com/", kNowMs, true);
+        std::vector<HistoryIndex::Suggestion> sites = typed.Query("site", 8, kNowMs);
+        CHECK(sites.size() == 2 && sites[0].url == "https://site-b.com/" && sites[0].typed == 1);
+    }
+
+    void CheckTitlesAndSubstrings() {
+        HistoryIndex index;
+        index.AddVisit("https://shop.example.com/cart", kNowMs, false);
+        CHECK(index.SetTitle("https://shop.example.com/cart", "Bitcoin Wallet Store"));
+        CHECK(!index.SetTitle("https://never-visited.com/", "Nothing"));
+
+        // Not a key prefix, found through the title and host trigrams
+        std::vector<HistoryIndex::Suggestion> byTitle = index.Query("wallet", 8, kNowMs);
+        CHECK(byTitle.size() == 1 && !byTitle[0].prefixMatch && byTitle[0].title == "Bitcoin Wallet Store");
+        std::vector<HistoryIndex::Suggestion> byHost = index.Query("example", 8, kNowMs);
+        CHECK(byHost.size() == 1 && !byHost[0].prefixMatch);
+        std::vector<HistoryIndex::Suggestion> byPrefix = index.Query("shop.ex", 8, kNowMs);
+        CHECK(byPrefix.size() == 1 && byPrefix[0].prefixMatch);
+    }
+
+    void CheckBulkReplay() {
+        HistoryIndex index;
+        index.BeginBulk();
+        index.AddAggregate("https://zeta.com/", "Zeta", 40, 2, kNowMs - kDayMs);
+        index.AddAggregate("https://zebra.com/", "Zebra", 3, 0, kNowMs - kDayMs);
+        index.AddVisit("https://zebra.com/", kNowMs, false);
+        index.EndBulk(kNowMs);
+
+        CHECK(index.VisitCount() == 44);
+        std::vector<HistoryIndex::Suggestion> suggestions = index.Query("ze", 8, kNowMs);
+        CHECK(suggestions.size() == 2 && suggestions[0].url == "https://zeta.com/" && suggestions[0].visits == 40);
+        CHECK(suggestions.size() == 2 && suggestions[1].visits == 4);
+    }
+}
+
+int main() {
+    CheckKeys();
+    CheckRanking();
+    CheckTitlesAndSubstrings();
+    CheckBulkReplay();
+    return TestSupport::Result();
+}
@@ -0,0 +1,198 @@
+// RendererRpc correlation under load: hundreds of same-type calls in flight at once, answered out
+// of order, each settle exactly their own promise or callback. Also checks that a response V8
+// cannot hold rejects the call and still leaves the context.
+
+#include "RendererRpc.h"
+#include "TestSupport.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <map>
+#include <random>
+
+using nlohmann::json;
+
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 1);
+};
+void Logger::Log(const std::string&, int, int) {}
+
+namespace {
+    // Records what a cefMessage.request callback was called with
+    class RecordingHandler : public CefV8Handler {
+    public:
+        bool Execute(const CefString&, CefRefPtr<CefV8Value>, const CefV8ValueList& arguments,
+                     CefRefPtr<CefV8Value>&, CefString&) override {
+            calls++;
+            last = arguments.empty() ? nullptr : arguments[0];
+            return true;
+        }
+
+        int calls = 0;
+        CefRefPtr<CefV8Value> last;
+
+    private:
+        IMPLEMENT_REFCOUNTING(RecordingHandler);
+    };
+
+    struct Sent {
+        int requestId;
+        std::string messageName;
+    };
+
+    // Drains the frame outbox into the rpc_request envelopes the browser would receive
+    std::vector<Sent> TakeRequests() {
+        std::vector<Sent> sent;
+        for (const auto& entry : CefFrame::Outbox()) {
+            CefRefPtr<CefListValue> envelope = entry.message->GetArgumentList();
+            CHECK(entry.target == PID_BROWSER && entry.message->GetName().ToString() == "rpc_request");
+            sent.push_back({ envelope->GetInt(0), envelope->GetString(1).ToString() });
+        }
+        CefFrame::Outbox().clear();
+        return sent;
+    }
+
+    CefRefPtr<CefListValue> Payload(const std::string& text) {
+        CefRefPtr<CefListValue> args = CefListValue::Create();
+        args->SetString(0, text);
+        return args;
+    }
+
+    CefRefPtr<CefV8Value> SendPromise(CefRefPtr<CefV8Context> context, const std::string& name,
+                                      const std::string& unwrapField = "") {
+        RendererRpc::PendingCall call;
+        call.messageName = name;
+        call.context = context;
+        call.promise = CefV8Value::CreatePromise();
+        call.unwrapField = unwrapField;
+        CefRefPtr<CefV8Value> promise = call.promise;
+        RendererRpc::Send(std::move(call), CefListValue::Create());
+        return promise;
+    }
+
+    void CheckParallelCalls() {
+        const int kCalls = 600;
+        CefRefPtr<CefV8Context> context = CefV8Context::Create();
+
+        // Balance, current address and address list calls, all in flight together
+        std::vector<CefRefPtr<CefV8Value>> promises;
+        for (int i = 0; i < kCalls; i++) {
+            if (i % 3 == 0) {
+                promises.push_back(SendPromise(context, "get_balance"));
+            } else if (i % 3 == 1) {
+                promises.push_back(SendPromise(context, "get_current_address"));
+            } else {
+                promises.push_back(SendPromise(context, "get_addresses", "addresses"));
+            }
+        }
+        CHECK(RendererRpc::InFlight() == static_cast<size_t>(kCalls));
+
+        std::vector<Sent> requests = TakeRequests();
+        CHECK(requests.size() == static_cast<size_t>(kCalls));
+        std::map<int, size_t> callIndex;
+        for (size_t i = 0; i < requests.size(); i++) {
+            callIndex[requests[i].requestId] = i;
+        }
+        CHECK_MSG(callIndex.size() == requests.size(), "request ids are unique");
+
+        // The browser answers in whatever order the daemon finishes
+        std::mt19937 random(13);
+        std::shuffle(requests.begin(), requests.end(), random);
+        for (const Sent& request : requests) {
+            int id = request.requestId;
+            json reply;
+            if (request.messageName == "get_balance") {
+                reply = {{"balance", 1000000000000LL + id}};
+            } else if (request.messageName == "get_current_address") {
+                reply = {{"address", "1Addr" + std::to_string(id)}};
+            } else {
+                reply = {{"success", true}, {"addresses", {"1List" + std::to_string(id)}}};
+            }
+            CHECK(RendererRpc::Complete(id, request.messageName + "_response", Payload(reply.dump())));
+        }
+        CHECK(RendererRpc::InFlight() == 0);
+        CHECK(context->EnterDepth() == 0);
+
+        for (const auto& entry : callIndex) {
+            int id = entry.first;
+            CefRefPtr<CefV8Value> promise = promises[entry.second];
+            CHECK_MSG(promise->GetPromiseState() == CefV8Value::PromiseState::Resolved, std::to_string(id));
+            CefRefPtr<CefV8Value> result = promise->GetPromiseResult();
+            switch (entry.second % 3) {
+                case 0:
+                    CHECK_MSG(result->GetValue("balance")->GetDoubleValue() == 1000000000000.0 + id, std::to_string(id));
+                    break;
+                case 1:
+                    CHECK_MSG(result->GetValue("address")->GetStringValue().ToString() == "1Addr" + std::to_string(id),
+                              std::to_string(id));
+                    break;
+                default:
+                    CHECK_MSG(result->IsArray() && result->GetValue(0)->GetStringValue().ToString() ==
+                                  "1List" + std::to_string(id), std::to_string(id));
+            }
+        }
+
+        // A duplicate or late reply finds nothing pending
+        CHECK(!RendererRpc::Complete(requests.front().requestId, "get_balance_response", Payload("{}")));
+    }
+
+    void CheckCallbacks() {
+        CefRefPtr<CefV8Context> context = CefV8Context::Create();
+        CefRefPtr<RecordingHandler> success = new RecordingHandler();
+        CefRefPtr<RecordingHandler> failure = new RecordingHandler();
+
+        for (int i = 0; i < 2; i++) {
+            RendererRpc::PendingCall call;
+            call.messageName = "get_balance";
+            call.context = context;
+            call.onSuccess = CefV8Value::CreateFunction("onSuccess", success.get());
+            call.onError = CefV8Value::CreateFunction("onError", failure.get());
+            RendererRpc::Send(std::move(call), CefListValue::Create());
+        }
+        std::vector<Sent> requests = TakeRequests();
+        CHECK(requests.size() == 2);
+
+        CHECK(RendererRpc::Complete(requests[1].requestId, "get_balance_error", Payload("\"daemon down\"")));
+        CHECK(failure->calls == 1 && failure->last->GetStringValue().ToString() == "daemon down");
+        CHECK(RendererRpc::Complete(requests[0].requestId, "get_balance_response", Payload("{\"balance\":5}")));
+        CHECK(success->calls == 1 && success->last->GetValue("balance")->GetIntValue() == 5);
+        CHECK(context->EnterDepth() == 0);
+    }
+
+    void CheckMalformedResponses() {
+        CefRefPtr<CefV8Context> context = CefV8Context::Create();
+
+        // Nested past V8Json's cap: conversion throws inside the entered context
+        std::string deep = "1";
+        for (int i = 0; i < 100; i++) {
+            deep = "[" + deep + "]";
+        }
+        CefRefPtr<CefV8Value> tooDeep = SendPromise(context, "get_balance");
+        CefRefPtr<CefV8Value> notObject = SendPromise(context, "get_addresses", "addresses");
+        std::vector<Sent> requests = TakeRequests();
+
+        CHECK(RendererRpc::Complete(requests[0].requestId, "get_balance_response", Payload(deep)));
+        CHECK(tooDeep->GetPromiseState() == CefV8Value::PromiseState::Rejected);
+        CHECK(tooDeep->GetPromiseError().ToString().find("depth") != std::string::npos);
+
+        // An unwrapped call whose payload is not an object is an error, not a type_error
+        CHECK(RendererRpc::Complete(requests[1].requestId, "get_addresses_response", Payload("[1,2]")));
+        CHECK(notObject->GetPromiseState() == CefV8Value::PromiseState::Rejected);
+        CHECK(context->EnterDepth() == 0);
+
+        // Calls of a released context are dropped without being settled
+        CefRefPtr<CefV8Value> orphan = SendPromise(context, "get_balance");
+        int orphanId = TakeRequests()[0].requestId;
+        RendererRpc::DropContext(context);
+        CHECK(!RendererRpc::Complete(orphanId, "get_balance_response", Payload("{}")));
+        CHECK(orphan->GetPromiseState() == CefV8Value::PromiseState::Pending);
+    }
+}
+
+int main() {
+    CheckParallelCalls();
+    CheckCallbacks();
+    CheckMalformedResponses();
+    CHECK(RendererRpc::InFlight() == 0);
+    return TestSupport::Result();
+}
@@ -0,0 +1,210 @@
+// StateStore durability: committed batches survive a reopen, a torn or corrupted tail is cut back
+// to the last intact commit, and a compaction that races commits loses none of them.
+
+#include "StateStore.h"
+#include "TestSupport.h"
+#include "include/cef_task.h"
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+void Logger::Log(const std::string&, int, int) {}
+
+namespace fs = std::filesystem;
+
+namespace {
+    StateStore& Store() {
+        return StateStore::GetInstance();
+    }
+
+    fs::path FreshDirectory(const std::string& name) {
+        fs::path directory = fs::temp_directory_path() / ("state_store_test_" + name);
+        fs::remove_all(directory);
+        return directory;
+    }
+
+    std::string ReadFile(const fs::path& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void WriteFile(const fs::path& path, const std::string& contents) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    }
+
+    bool Has(const std::string& key, const std::string& expected) {
+        std::string value;
+        return Store().Get(key, value) && value == expected;
+    }
+
+    bool Missing(const std::string& key) {
+        std::string value;
+        return !Store().Get(key, value);
+    }
+
+    // Batch i puts three keys and deletes the previous batch's marker
+    void CommitBatch(int i) {
+        StateStore::Batch batch;
+        for (int j = 0; j < 3; j++) {
+            batch.Put("batch/" + std::to_string(i) + "/" + std::to_string(j), "value-" + std::to_string(i * 10 + j));
+        }
+        batch.Put("marker/" + std::to_string(i), "set");
+        if (i > 0) {
+            batch.Delete("marker/" + std::to_string(i - 1));
+        }
+        CHECK(Store().Commit(batch));
+    }
+
+    // Batches below `upTo` applied entirely, the rest not at all
+    void CheckBatches(int upTo, int total, const std::string& where) {
+        for (int i = 0; i < total; i++) {
+            bool applied = i < upTo;
+            for (int j = 0; j < 3; j++) {
+                std::string key = "batch/" + std::to_string(i) + "/" + std::to_string(j);
+                CHECK_MSG(applied ? Has(key, "value-" + std::to_string(i * 10 + j)) : Missing(key),
+                          where + " " + key);
+            }
+            bool latest = i == upTo - 1;
+            CHECK_MSG(latest ? Has("marker/" + std::to_string(i), "set") : Missing("marker/" + std::to_string(i)),
+                      where + " marker " + std::to_string(i));
+        }
+    }
+
+    void CheckBasics() {
+        fs::path directory = FreshDirectory("basics");
+        CHECK(Store().Open(directory.wstring()));
+        CHECK(Store().Put("whitelist/a.com", "{}"));
+        CHECK(Store().Put("whitelist/b.com", "{}"));
+        CHECK(Store().Put("other", "1", false));
+        CHECK(Store().Delete("whitelist/a.com"));
+        CHECK(!Store().Put("", "empty key"));
+        CHECK(Store().Scan("whitelist/").size() == 1);
+        Store().Close();
+
+        CHECK(Store().Open(directory.wstring()));
+        CHECK(Missing("whitelist/a.com") && Has("whitelist/b.com", "{}") && Has("other", "1"));
+        CHECK(Store().GetStats()["recoveredBatches"] == 4);
+        CHECK(Store().GetStats()["truncatedBytes"] == 0);
+        Store().Close();
+    }
+
+    void CheckTornTail() {
+        const int kBatches = 12;
+        fs::path directory = FreshDirectory("torn");
+        fs::path log = directory / "state.log";
+        CHECK(Store().Open(directory.wstring()));
+        for (int i = 0; i < kBatches - 1; i++) {
+            CommitBatch(i);
+        }
+        uint64_t lastGoodEnd = Store().GetStats()["logBytes"];
+        CommitBatch(kBatches - 1);
+        Store().Close();
+
+        const std::string full = ReadFile(log);
+        CHECK(full.size() > lastGoodEnd);
+
+        // A crash can leave any prefix of the last batch on disk
+        for (size_t cut = lastGoodEnd; cut < full.size(); cut++) {
+            WriteFile(log, full.substr(0, cut));
+            CHECK(Store().Open(directory.wstring()));
+            std::string where = "cut at " + std::to_string(cut);
+            CheckBatches(kBatches - 1, kBatches, where);
+            CHECK_MSG(Store().GetStats()["truncatedBytes"] == cut - lastGoodEnd, where);
+            Store().Close();
+            CHECK_MSG(fs::file_size(log) == lastGoodEnd, where);
+        }
+
+        // Any flipped byte in the last batch fails its checksum
+        for (size_t position = lastGoodEnd; position < full.size(); position++) {
+            std::string corrupt = full;
+            corrupt[position] ^= 0x5a;
+            WriteFile(log, corrupt);
+            CHECK(Store().Open(directory.wstring()));
+            CheckBatches(kBatches - 1, kBatches, "flip at " + std::to_string(position));
+            Store().Close();
+        }
+
+        WriteFile(log, full);
+        CHECK(Store().Open(directory.wstring()));
+        CheckBatches(kBatches, kBatches, "intact");
+        Store().Close();
+
+        // Damage in the middle ends recovery there: later batches cannot be trusted to follow it
+        std::string corrupt = full;
+        corrupt[8 + (lastGoodEnd - 8) / 2] ^= 0x5a;
+        WriteFile(log, corrupt);
+        CHECK(Store().Open(directory.wstring()));
+        int recovered = Store().GetStats()["recoveredBatches"];
+        CHECK(recovered > 0 && recovered < kBatches - 1);
+        CheckBatches(recovered, kBatches, "middle flip");
+
+        // The store carries on from the cut
+        CommitBatch(recovered);
+        Store().Close();
+        CHECK(Store().Open(directory.wstring()));
+        CheckBatches(recovered + 1, kBatches, "after recovery");
+        CHECK(Store().GetStats()["truncatedBytes"] == 0);
+        Store().Close();
+
+        // A file that is not a store log starts over empty
+        WriteFile(log, "not a state log at all");
+        CHECK(Store().Open(directory.wstring()));
+        CHECK(Store().GetStats()["keys"] == 0);
+        Store().Close();
+        CHECK(fs::file_size(log) == 8);
+    }
+
+    void CheckCompactionRacingCommits() {
+        fs::path directory = FreshDirectory("compaction");
+        CHECK(Store().Open(directory.wstring()));
+
+        // Rewriting a few keys grows the log well past its live data
+        std::string value(1000, 'x');
+        for (int i = 0; FakeCefTasks::Pending() == 0 && i < 100000; i++) {
+            CHECK(Store().Put("hot/" + std::to_string(i % 50), value + std::to_string(i), false));
+        }
+        CHECK(FakeCefTasks::Pending() == 1);
+        uint64_t before = Store().GetStats()["logBytes"];
+
+        FakeCefTasks::Posted compaction;
+        CHECK(FakeCefTasks::Take(compaction));
+        std::thread fileThread(compaction.run);
+        const int kRacing = 400;
+        for (int i = 0; i < kRacing; i++) {
+            StateStore::Batch batch;
+            batch.Put("race/" + std::to_string(i), std::to_string(i));
+            batch.Put("hot/0", "final-" + std::to_string(i));
+            CHECK(Store().Commit(batch, i % 10 == 0));
+        }
+        fileThread.join();
+        FakeCefTasks::RunAll();
+
+        nlohmann::json stats = Store().GetStats();
+        CHECK(stats["compactions"] >= 1);
+        CHECK(stats["logBytes"] < before);
+        Store().Close();
+
+        CHECK(Store().Open(directory.wstring()));
+        CHECK(Store().GetStats()["truncatedBytes"] == 0);
+        CHECK(Has("hot/0", "final-" + std::to_string(kRacing - 1)));
+        CHECK(Store().Scan("hot/").size() == 50);
+        for (int i = 0; i < kRacing; i++) {
+            CHECK_MSG(Has("race/" + std::to_string(i), std::to_string(i)), "race/" + std::to_string(i));
+        }
+        Store().Close();
+        CHECK(!fs::exists(directory / "state.log.compact"));
+    }
+}
+
+int main() {
+    CheckBasics();
+    CheckTornTail();
+    CheckCompactionRacingCommits();
+    return TestSupport::Result();
+}
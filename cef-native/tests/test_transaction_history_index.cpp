@@ -0,0 +1,194 @@
+// TransactionHistoryIndex: daemon JSON parsing, upserts that add, change and reorder rows, removal
+// and eviction, filtered pages and their cached views, and repacking after heavy churn.
+
+#include "TransactionHistoryIndex.h"
+#include "TestSupport.h"
+
+namespace {
+    using Transaction = TransactionHistoryIndex::Transaction;
+
+    Transaction Make(const std::string& txid, int64_t timestamp, uint8_t status = TransactionHistoryIndex::kConfirmed,
+                     const std::string& memo = "") {
+        Transaction transaction;
+        transaction.txid = txid;
+        transaction.recipient = "1Recipient" + txid;
+        transaction.memo = memo;
+        transaction.timestamp = timestamp;
+        transaction.amount = 1000;
+        transaction.fee = 10;
+        transaction.confirmations = status == TransactionHistoryIndex::kPending ? 0 : 6;
+        transaction.status = status;
+        return transaction;
+    }
+
+    std::vector<std::string> Txids(const nlohmann::json& page) {
+        std::vector<std::string> txids;
+        for (const auto& item : page["items"]) {
+            txids.push_back(item["txid"].get<std::string>());
+        }
+        return txids;
+    }
+
+    void CheckJson() {
+        Transaction transaction;
+        CHECK(!TransactionHistoryIndex::FromJson(nlohmann::json::object(), transaction));
+        CHECK(!TransactionHistoryIndex::FromJson({{"txid", ""}}, transaction));
+        CHECK(!TransactionHistoryIndex::FromJson({{"txid", std::string(300, 'a')}}, transaction));
+        CHECK(!TransactionHistoryIndex::FromJson(nlohmann::json::array(), transaction));
+
+        nlohmann::json daemon = {
+            {"txid", "abc"}, {"recipient", "1Bob"}, {"memo", "lunch"}, {"timestamp", 1700000000.0},
+            {"amount", 5000}, {"fee", 20}, {"confirmations", 3}, {"status", "unknown"}
+        };
+        CHECK(TransactionHistoryIndex::FromJson(daemon, transaction));
+        CHECK(transaction.timestamp == 1700000000 && transaction.confirmations == 3);
+        CHECK(transaction.status == TransactionHistoryIndex::kConfirmed);
+        nlohmann::json json = TransactionHistoryIndex::ToJson(transaction);
+        CHECK(json["status"] == "confirmed" && json["memo"] == "lunch" && json["amount"] == 5000);
+
+        CHECK(TransactionHistoryIndex::FromJson({{"txid", "def"}, {"status", "failed"}, {"confirmations", -4}}, transaction));
+        CHECK(transaction.status == TransactionHistoryIndex::kFailed && transaction.confirmations == 0);
+        CHECK(!TransactionHistoryIndex::ToJson(transaction).contains("memo"));
+    }
+
+    void CheckUpserts() {
+        TransactionHistoryIndex index;
+        CHECK(index.Upsert({ Make("b", 200), Make("a", 100), Make("c", 300), Make("d", 300) }) == 4);
+        // Newest first, ties by txid
+        CHECK(Txids(index.Page(0, 10, {})) == std::vector<std::string>({ "c", "d", "b", "a" }));
+        uint64_t version = index.Version();
+
+        // Unchanged rows are not counted and do not bump the version
+        CHECK(index.Upsert({ Make("a", 100) }) == 0);
+        CHECK(index.Version() == version);
+
+        // A confirmation changes a row in place; a new timestamp moves it; later duplicates win
+        Transaction confirmed = Make("b", 200);
+        confirmed.confirmations = 7;
+        std::vector<size_t> changedAt;
+        CHECK(index.Upsert({ confirmed, Make("a", 50), Make("a", 400) }, &changedAt) == 3);
+        CHECK(changedAt == std::vector<size_t>({ 0, 1, 2 }));
+        CHECK(Txids(index.Page(0, 10, {})) == std::vector<std::string>({ "a", "c", "d", "b" }));
+        CHECK(index.Page(3, 1, {})["items"][0]["confirmations"] == 7);
+        CHECK(index.Count() == 4);
+
+        // A large batch takes the merge path and gives the same order
+        std::vector<Transaction> batch;
+        for (int i = 0; i < 200; i++) {
+            batch.push_back(Make("t" + std::to_string(1000 + i), 1000 + i));
+        }
+        batch.push_back(Make("c", 5));
+        CHECK(index.Upsert(batch) == 201);
+        nlohmann::json first = index.Page(0, 2, {});
+        CHECK(first["total"] == 204 && Txids(first) == std::vector<std::string>({ "t1199", "t1198" }));
+        CHECK(Txids(index.Page(203, 5, {})) == std::vector<std::string>({ "c" }));
+        CHECK(index.Page(500, 5, {})["items"].empty());
+    }
+
+    void CheckRemoveAndEvict() {
+        TransactionHistoryIndex index;
+        index.Upsert({ Make("a", 1), Make("b", 2), Make("c", 3), Make("d", 4) });
+        CHECK(index.Remove({ "b", "b", "missing" }) == 1);
+        CHECK(index.Remove({ "b" }) == 0);
+        CHECK(Txids(index.Page(0, 10, {})) == std::vector<std::string>({ "d", "c", "a" }));
+
+        CHECK(index.MissingFrom({ Make("a", 1), Make("d", 4) }) == std::vector<std::string>({ "c" }));
+
+        CHECK(index.EvictOldest(2) == 1);
+        CHECK(index.EvictOldest(2) == 0);
+        CHECK(Txids(index.Page(0, 10, {})) == std::vector<std::string>({ "d", "c" }));
+
+        // A removed txid can come back
+        CHECK(index.Upsert({ Make("b", 2) }) == 1);
+        CHECK(index.Count() == 3);
+    }
+
+    void CheckFilters() {
+        TransactionHistoryIndex index;
+        index.Upsert({
+            Make("aa01", 1, TransactionHistoryIndex::kConfirmed, "Rent"),
+            Make("bb02", 2, TransactionHistoryIndex::kFailed),
+            Make("cc03", 3, TransactionHistoryIndex::kPending, "coffee RENT split"),
+            Make("dd04", 4, TransactionHistoryIndex::kFailed, "rent")
+        });
+
+        TransactionHistoryIndex::Filter failed;
+        failed.status = TransactionHistoryIndex::kFailed;
+        CHECK(Txids(index.Page(0, 10, failed)) == std::vector<std::string>({ "dd04", "bb02" }));
+
+        // Case-insensitive over txid, recipient and memo, never across their boundary
+        TransactionHistoryIndex::Filter rent;
+        rent.text = "rEnT";
+        CHECK(Txids(index.Page(0, 10, rent)) == std::vector<std::string>({ "dd04", "cc03", "aa01" }));
+        TransactionHistoryIndex::Filter straddle;
+        straddle.text = "031r";
+        CHECK(index.Page(0, 10, straddle)["total"] == 0);
+        TransactionHistoryIndex::Filter recipient;
+        recipient.text = "recipientbb";
+        CHECK(Txids(index.Page(0, 10, recipient)) == std::vector<std::string>({ "bb02" }));
+
+        TransactionHistoryIndex::Filter both = rent;
+        both.status = TransactionHistoryIndex::kFailed;
+        CHECK(Txids(index.Page(0, 10, both)) == std::vector<std::string>({ "dd04" }));
+
+        // Cached views follow changes to the history
+        index.Upsert({ Make("ee05", 5, TransactionHistoryIndex::kFailed, "Rent again") });
+        CHECK(index.Page(0, 10, rent)["total"] == 4);
+        index.Remove({ "dd04" });
+        CHECK(Txids(index.Page(0, 10, failed)) == std::vector<std::string>({ "ee05", "bb02" }));
+        CHECK(Txids(index.Page(1, 1, rent)) == std::vector<std::string>({ "cc03" }));
+
+        // More filters than cached views still answer correctly
+        for (int round = 0; round < 2; round++) {
+            for (const char* text : { "a", "b", "c", "e", "rent", "recipient" }) {
+                TransactionHistoryIndex::Filter filter;
+                filter.text = text;
+                CHECK(index.Page(0, 10, filter)["total"].get<size_t>() >= 1);
+            }
+        }
+    }
+
+    void CheckRepack() {
+        TransactionHistoryIndex index;
+        const int count = 3000;
+        std::vector<Transaction> batch;
+        for (int i = 0; i < count; i++) {
+            batch.push_back(Make("tx" + std::to_string(i), i, TransactionHistoryIndex::kConfirmed, std::string(400, 'm')));
+        }
+        index.Upsert(batch);
+        size_t before = index.MemoryBytes();
+
+        // Rewriting every memo twice leaves most of the text dead, which triggers a repack
+        for (int round = 0; round < 2; round++) {
+            for (Transaction& transaction : batch) {
+                transaction.memo = std::string(400, static_cast<char>('a' + round));
+            }
+            CHECK(index.Upsert(batch) == static_cast<size_t>(count));
+        }
+        CHECK(index.MemoryBytes() < before * 2);
+
+        TransactionHistoryIndex::Filter filter;
+        filter.text = "bbbb";
+        CHECK(index.Page(0, 1, filter)["total"] == count);
+        nlohmann::json newest = index.Page(0, 1, {});
+        CHECK(Txids(newest) == std::vector<std::string>({ "tx2999" }));
+        CHECK(newest["items"][0]["memo"] == std::string(400, 'b'));
+
+        std::vector<std::string> txids;
+        for (int i = 0; i < count; i += 2) {
+            txids.push_back("tx" + std::to_string(i));
+        }
+        CHECK(index.Remove(txids) == txids.size());
+        CHECK(index.Count() == count / 2);
+        CHECK(Txids(index.Page(count / 2 - 1, 5, {})) == std::vector<std::string>({ "tx1" }));
+    }
+}
+
+int main() {
+    CheckJson();
+    CheckUpserts();
+    CheckRemoveAndEvict();
+    CheckFilters();
+    CheckRepack();
+    return TestSupport::Result();
+}
@@ -0,0 +1,119 @@
+// V8Json against the in-memory CEF values: nesting, the depth cap, integer widths, binary data and
+// the JSON.stringify rules for functions and undefined.
+
+#include "V8JsonConverter.h"
+#include "Encoding.h"
+#include "TestSupport.h"
+#include <cmath>
+#include <stdexcept>
+
+using nlohmann::json;
+
+namespace {
+    class NoopHandler : public CefV8Handler {
+    public:
+        bool Execute(const CefString&, CefRefPtr<CefV8Value>, const CefV8ValueList&,
+                     CefRefPtr<CefV8Value>&, CefString&) override { return true; }
+
+    private:
+        IMPLEMENT_REFCOUNTING(NoopHandler);
+    };
+
+    json Nested(int depth) {
+        json value = "leaf";
+        for (int i = 0; i < depth; i++) {
+            value = json::array({ value });
+        }
+        return value;
+    }
+
+    bool Throws(const std::function<void()>& fn) {
+        try {
+            fn();
+        } catch (const std::runtime_error&) {
+            return true;
+        }
+        return false;
+    }
+
+    void CheckNesting() {
+        json outputs = {
+            {"totalOutputs", 2},
+            {"outputs", json::array({
+                {{"outpoint", "ab.0"}, {"satoshis", 1000}, {"tags", {"a", "b"}}, {"spendable", true}},
+                {{"outpoint", "cd.1"}, {"satoshis", 2100000000000000LL}, {"tags", json::array()},
+                 {"customInstructions", nullptr}, {"meta", {{"deep", {{"deeper", {1.5, false}}}}}}}
+            })}
+        };
+        CHECK(V8Json::fromV8(V8Json::toV8(outputs)) == outputs);
+
+        CefRefPtr<CefV8Value> v8 = V8Json::toV8(outputs);
+        CHECK(v8->IsObject() && v8->GetValue("outputs")->IsArray());
+        CHECK(v8->GetValue("outputs")->GetValue(1)->GetValue("meta")->GetValue("deep")->IsObject());
+
+        // The cap counts containers below the root; the leaf sits one level deeper
+        CHECK(!Throws([] { V8Json::toV8(Nested(V8Json::kDefaultMaxDepth)); }));
+        CHECK(Throws([] { V8Json::toV8(Nested(V8Json::kDefaultMaxDepth + 1)); }));
+        CHECK(Throws([] { V8Json::toV8(Nested(3), 2); }));
+
+        CefRefPtr<CefV8Value> deep = CefV8Value::CreateString("leaf");
+        for (int i = 0; i <= V8Json::kDefaultMaxDepth; i++) {
+            CefRefPtr<CefV8Value> wrapper = CefV8Value::CreateArray(1);
+            wrapper->SetValue(0, deep);
+            deep = wrapper;
+        }
+        CHECK(Throws([&] { V8Json::fromV8(deep); }));
+    }
+
+    void CheckNumbers() {
+        // Beyond int32 JS holds a double; integral ones come back as exact integers
+        const int64_t satoshis = 2100000000000000LL;
+        CefRefPtr<CefV8Value> big = V8Json::toV8(json(satoshis));
+        CHECK(big->IsDouble() && !big->IsInt());
+        json back = V8Json::fromV8(big);
+        CHECK(back.is_number_integer() && back.get<int64_t>() == satoshis);
+
+        CHECK(V8Json::toV8(json(-5))->IsInt());
+        CHECK(V8Json::toV8(json(3000000000u))->IsUInt());
+        CHECK(V8Json::fromV8(V8Json::toV8(json(3000000000u))).get<uint64_t>() == 3000000000u);
+
+        json fraction = V8Json::fromV8(CefV8Value::CreateDouble(0.25));
+        CHECK(fraction.is_number_float() && fraction.get<double>() == 0.25);
+        CHECK(V8Json::fromV8(CefV8Value::CreateDouble(std::nan(""))).is_null());
+        CHECK(V8Json::fromV8(CefV8Value::CreateDouble(INFINITY)).is_null());
+    }
+
+    void CheckBinary() {
+        json bytes = json::binary({ 0x00, 0x01, 0xfe, 0xff });
+        CefRefPtr<CefV8Value> buffer = V8Json::toV8(bytes);
+        CHECK(buffer->IsArrayBuffer() && buffer->GetArrayBufferByteLength() == 4);
+        CHECK(V8Json::fromV8(buffer) == json(Encoding::base64Encode(std::string("\x00\x01\xfe\xff", 4))));
+        CHECK(V8Json::fromV8(buffer, V8Json::BinaryMode::Binary) == bytes);
+
+        CefRefPtr<CefV8Value> empty = V8Json::toV8(json::binary({}));
+        CHECK(empty->IsArrayBuffer() && empty->GetArrayBufferByteLength() == 0);
+        CHECK(V8Json::fromV8(empty) == json(""));
+    }
+
+    void CheckDroppedMembers() {
+        CefRefPtr<CefV8Value> object = CefV8Value::CreateObject(nullptr, nullptr);
+        object->SetValue("kept", CefV8Value::CreateString("x"), V8_PROPERTY_ATTRIBUTE_NONE);
+        object->SetValue("method", CefV8Value::CreateFunction("method", new NoopHandler()), V8_PROPERTY_ATTRIBUTE_NONE);
+        object->SetValue("missing", CefV8Value::CreateUndefined(), V8_PROPERTY_ATTRIBUTE_NONE);
+        CHECK(V8Json::fromV8(object) == json({{"kept", "x"}}));
+
+        // In arrays JSON.stringify writes null instead
+        CefRefPtr<CefV8Value> array = CefV8Value::CreateArray(2);
+        array->SetValue(0, CefV8Value::CreateUndefined());
+        array->SetValue(1, CefV8Value::CreateFunction("f", new NoopHandler()));
+        CHECK(V8Json::fromV8(array) == json::array({ nullptr, nullptr }));
+    }
+}
+
+int main() {
+    CheckNesting();
+    CheckNumbers();
+    CheckBinary();
+    CheckDroppedMembers();
+    return TestSupport::Result();
+}
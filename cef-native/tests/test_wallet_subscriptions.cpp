@@ -0,0 +1,264 @@
+// WalletSubscriptions: topic masks from subscribe requests, pushes only to subscribers and only on
+// change, a fetch asked for while one is running going out once more when it ends, and what the
+// event stream connecting and dropping does to stale topics and the session cache. The daemon side
+// (WalletSubscriptionsStream.cpp) is replaced by stand-ins that answer fetches from g_daemonState.
+
+#include "WalletSubscriptions.h"
+#include "TransactionHistoryCache.h"
+#include "BRC100SessionCache.h"
+#include "TestSupport.h"
+#include "include/cef_task.h"
+#include "include/wrapper/cef_closure_task.h"
+#include "include/base/cef_bind.h"
+
+class Logger {
+public:
+    static void Log(const std::string& message, int level = 1, int process = 2);
+};
+void Logger::Log(const std::string&, int, int) {}
+
+namespace {
+    nlohmann::json g_daemonState[WalletSubscriptions::kTopicCount];
+    int g_workerFetches[WalletSubscriptions::kTopicCount] = {};
+    int g_historyRefreshes = 0;
+    int g_historyInvalidations = 0;
+    int g_sessionConnects = 0;
+    int g_sessionLosses = 0;
+    std::vector<nlohmann::json> g_sessionEvents;
+}
+
+// Never destroyed, so the stream thread's side is never needed
+WalletSubscriptions& WalletSubscriptions::GetInstance() {
+    static WalletSubscriptions* instance = new WalletSubscriptions();
+    return *instance;
+}
+
+void WalletSubscriptions::FetchOnWorkerThread(Topic topic) {
+    g_workerFetches[topic]++;
+    CefPostTask(TID_UI, base::BindOnce([](Topic fetched, nlohmann::json result) {
+        WalletSubscriptions::GetInstance().OnFetched(fetched, result);
+    }, topic, g_daemonState[topic]));
+}
+
+TransactionHistoryCache& TransactionHistoryCache::GetInstance() {
+    static TransactionHistoryCache* instance = new TransactionHistoryCache();
+    return *instance;
+}
+void TransactionHistoryCache::Refresh() { g_historyRefreshes++; }
+void TransactionHistoryCache::Invalidate() { g_historyInvalidations++; }
+
+BRC100SessionCache& BRC100SessionCache::GetInstance() {
+    static BRC100SessionCache* instance = new BRC100SessionCache();
+    return *instance;
+}
+void BRC100SessionCache::OnStreamConnected() { g_sessionConnects++; }
+void BRC100SessionCache::OnStreamLost() { g_sessionLosses++; }
+void BRC100SessionCache::OnEvent(const nlohmann::json& data) { g_sessionEvents.push_back(data); }
+
+namespace {
+    WalletSubscriptions& Subscriptions() {
+        return WalletSubscriptions::GetInstance();
+    }
+
+    nlohmann::json Topic(const char* name) {
+        return Subscriptions().GetStats()["topics"][name];
+    }
+
+    // wallet_state messages sent since the last call, in the order they were sent
+    std::vector<nlohmann::json> TakePushes() {
+        std::vector<nlohmann::json> pushes;
+        for (const CefFrame::Sent& sent : CefFrame::Outbox()) {
+            CHECK(sent.target == PID_RENDERER && sent.message->GetName().ToString() == "wallet_state");
+            pushes.push_back(nlohmann::json::parse(sent.message->GetArgumentList()->GetString(0).ToString()));
+        }
+        CefFrame::Outbox().clear();
+        return pushes;
+    }
+
+    void CheckTopicMasks() {
+        CefRefPtr<CefBrowser> browser = CefBrowser::Create(1);
+        // Unknown names and non-strings are skipped; a request without known topics subscribes to nothing
+        CHECK(Subscriptions().Subscribe(browser, {{"topics", {"bogus", 3}}})["states"].empty());
+        CHECK(Subscriptions().Subscribe(browser, {{"topics", "balance"}})["states"].empty());
+        CHECK(Subscriptions().Subscribe(browser, nlohmann::json::array())["states"].empty());
+        CHECK(Subscriptions().GetStats()["browsers"] == 0);
+        CHECK(FakeCefTasks::Pending() == 0);
+
+        Subscriptions().Subscribe(browser, {{"topics", {"history", "bogus", "messages"}}});
+        CHECK(Subscriptions().GetStats()["browsers"] == 1);
+        CHECK(Topic("history")["subscribers"] == 1 && Topic("messages")["subscribers"] == 1);
+        CHECK(Topic("addresses")["subscribers"] == 0 && Topic("balance")["subscribers"] == 0);
+
+        // Subscribing again adds to the mask rather than replacing it or counting twice
+        g_daemonState[WalletSubscriptions::kAddresses] = {{"addresses", {"1A"}}};
+        Subscriptions().Subscribe(browser, {{"topics", {"history", "addresses"}}});
+        CHECK(Topic("history")["subscribers"] == 1 && Topic("addresses")["subscribers"] == 1);
+
+        Subscriptions().Unsubscribe(1, {{"topics", {"messages"}}});
+        CHECK(Topic("messages")["subscribers"] == 0 && Topic("history")["subscribers"] == 1);
+        // Anything but a topic list drops the whole subscription
+        Subscriptions().Unsubscribe(1, nullptr);
+        CHECK(Subscriptions().GetStats()["browsers"] == 0);
+        CHECK(Topic("history")["subscribers"] == 0 && Topic("addresses")["subscribers"] == 0);
+
+        FakeCefTasks::RunAll();
+        TakePushes();
+    }
+
+    void CheckPushesOnlyChanges() {
+        g_daemonState[WalletSubscriptions::kBalance] = {{"balance", 1000}};
+        CefRefPtr<CefBrowser> subscriber = CefBrowser::Create(2);
+        CefRefPtr<CefBrowser> other = CefBrowser::Create(3);
+        Subscriptions().Subscribe(other, {{"topics", {"addresses"}}});
+        uint64_t version = Topic("balance")["version"].get<uint64_t>();
+
+        // Not known yet: nothing in the answer, fetched and pushed when it arrives
+        nlohmann::json answer = Subscriptions().Subscribe(subscriber, {{"topics", {"balance"}}});
+        CHECK(!answer["states"].contains("balance"));
+        FakeCefTasks::RunAll();
+        std::vector<nlohmann::json> pushes = TakePushes();
+        CHECK(pushes.size() == 1);
+        CHECK(pushes[0]["topic"] == "balance" && pushes[0]["state"]["balance"] == 1000);
+        CHECK(pushes[0]["version"] == version + 1);
+
+        // The same state again is not sent
+        Subscriptions().Publish(WalletSubscriptions::kBalance, {{"balance", 1000}});
+        CHECK(TakePushes().empty());
+        CHECK(Topic("balance")["unchanged"].get<uint64_t>() >= 1);
+
+        // Known and fresh: answered at once, without a fetch
+        int fetches = g_workerFetches[WalletSubscriptions::kBalance];
+        answer = Subscriptions().Subscribe(other, {{"topics", {"balance"}}});
+        CHECK(answer["states"]["balance"]["state"]["balance"] == 1000);
+        CHECK(FakeCefTasks::Pending() == 0 && g_workerFetches[WalletSubscriptions::kBalance] == fetches);
+
+        Subscriptions().Publish(WalletSubscriptions::kBalance, {{"balance", 2500}});
+        CHECK(TakePushes().size() == 2);
+
+        Subscriptions().Unsubscribe(2, nullptr);
+        Subscriptions().Unsubscribe(3, nullptr);
+    }
+
+    void CheckFetchAgain() {
+        Subscriptions().OnStreamState(true, true);
+        FakeCefTasks::RunAll();
+        CefRefPtr<CefBrowser> browser = CefBrowser::Create(4);
+        g_daemonState[WalletSubscriptions::kAddresses] = {{"addresses", {"1A"}}};
+        int fetches = g_workerFetches[WalletSubscriptions::kAddresses];
+
+        Subscriptions().Subscribe(browser, {{"topics", {"addresses"}}});
+        CHECK(FakeCefTasks::Pending() == 1);
+        // Changes announced while the fetch is out make it run once more, not once per event
+        g_daemonState[WalletSubscriptions::kAddresses] = {{"addresses", {"1A", "1B"}}};
+        Subscriptions().OnEvent({{"topic", "addresses"}});
+        Subscriptions().OnEvent({{"topic", "addresses"}});
+        CHECK(FakeCefTasks::Pending() == 1);
+        FakeCefTasks::RunAll();
+        CHECK(g_workerFetches[WalletSubscriptions::kAddresses] == fetches + 2);
+        CHECK(Topic("addresses")["events"] == 2);
+
+        // The second fetch had the new state, so that is the last one pushed
+        std::vector<nlohmann::json> pushes = TakePushes();
+        CHECK(!pushes.empty() && pushes.back()["state"]["addresses"].size() == 2);
+
+        // A failed fetch leaves the topic stale and pushes nothing
+        g_daemonState[WalletSubscriptions::kAddresses] = {{"error", "Wallet daemon unavailable"}};
+        Subscriptions().OnEvent({{"topic", "addresses"}});
+        FakeCefTasks::RunAll();
+        CHECK(TakePushes().empty());
+        CHECK(Topic("addresses")["stale"] == true);
+
+        Subscriptions().Unsubscribe(4, nullptr);
+    }
+
+    void CheckEvents() {
+        CefRefPtr<CefBrowser> browser = CefBrowser::Create(5);
+        Subscriptions().Subscribe(browser, {{"topics", {"messages", "history"}}});
+        int refreshes = g_historyRefreshes;
+        FakeCefTasks::RunAll();
+        TakePushes();
+
+        // Events that carry their state are pushed without a fetch; addresses arrive as a bare array
+        Subscriptions().OnEvent({{"topic", "messages"}, {"data", {{"count", 3}}}});
+        Subscriptions().OnEvent({{"topic", "addresses"}, {"data", {"1C"}}});
+        std::vector<nlohmann::json> pushes = TakePushes();
+        CHECK(pushes.size() == 1 && pushes[0]["state"]["count"] == 3);
+        CHECK(Topic("addresses")["known"] == true && Topic("addresses")["stale"] == false);
+        CHECK(FakeCefTasks::Pending() == 0);
+
+        // History is refetched through its cache, which is told its copy is out of date
+        int invalidations = g_historyInvalidations;
+        Subscriptions().OnEvent({{"topic", "history"}});
+        CHECK(g_historyInvalidations == invalidations + 1);
+        CHECK(g_historyRefreshes == refreshes + 1);
+
+        // Nobody subscribes to balance, so its change is only remembered
+        Subscriptions().OnEvent({{"topic", "balance"}});
+        CHECK(Topic("balance")["stale"] == true && FakeCefTasks::Pending() == 0);
+
+        // Session changes go to the session cache; heartbeats and unknown topics are ignored
+        size_t sessionEvents = g_sessionEvents.size();
+        Subscriptions().OnEvent({{"topic", "sessions"}, {"data", {{"change", "revoked"}}}});
+        Subscriptions().OnEvent({{"topic", "heartbeat"}});
+        CHECK(g_sessionEvents.size() == sessionEvents + 1 && g_sessionEvents.back()["change"] == "revoked");
+        CHECK(TakePushes().empty() && FakeCefTasks::Pending() == 0);
+
+        Subscriptions().Unsubscribe(5, nullptr);
+    }
+
+    void CheckStreamState() {
+        CefRefPtr<CefBrowser> browser = CefBrowser::Create(6);
+        g_daemonState[WalletSubscriptions::kBalance] = {{"balance", 7}};
+        Subscriptions().Subscribe(browser, {{"topics", {"balance"}}});
+        FakeCefTasks::RunAll();
+        TakePushes();
+        CHECK(Subscriptions().GetStats()["streamConnected"] == true);
+
+        int losses = g_sessionLosses;
+        Subscriptions().OnStreamState(false, true);
+        CHECK(Subscriptions().GetStats()["streamConnected"] == false);
+        CHECK(g_sessionLosses == losses + 1);
+        // Dropping again changes nothing, but a daemon without the stream is noted
+        Subscriptions().OnStreamState(false, false);
+        CHECK(g_sessionLosses == losses + 1);
+        CHECK(Subscriptions().GetStats()["streamSupported"] == false);
+
+        // With the stream down, the last subscriber leaving means changes go unseen from here on
+        CHECK(Topic("balance")["stale"] == false);
+        Subscriptions().Unsubscribe(6, nullptr);
+        CHECK(Topic("balance")["stale"] == true);
+        Subscriptions().Subscribe(browser, {{"topics", {"balance"}}});
+        FakeCefTasks::RunAll();
+        CHECK(Topic("balance")["stale"] == false);
+
+        // Reconnecting marks every topic stale and refetches the subscribed ones only
+        uint64_t connects = Subscriptions().GetStats()["streamConnects"].get<uint64_t>();
+        int connected = g_sessionConnects;
+        int balanceFetches = g_workerFetches[WalletSubscriptions::kBalance];
+        int addressFetches = g_workerFetches[WalletSubscriptions::kAddresses];
+        Subscriptions().OnStreamState(true, true);
+        CHECK(Subscriptions().GetStats()["streamConnects"] == connects + 1);
+        CHECK(Subscriptions().GetStats()["streamSupported"] == true);
+        CHECK(g_sessionConnects == connected + 1);
+        CHECK(Topic("addresses")["stale"] == true);
+        FakeCefTasks::RunAll();
+        CHECK(g_workerFetches[WalletSubscriptions::kBalance] == balanceFetches + 1);
+        CHECK(g_workerFetches[WalletSubscriptions::kAddresses] == addressFetches);
+        CHECK(Topic("balance")["stale"] == false);
+        // The refetch found nothing new, so nothing was pushed
+        CHECK(TakePushes().empty());
+
+        // With the stream up, unsubscribing leaves the topic fresh: events keep announcing changes
+        Subscriptions().Unsubscribe(6, nullptr);
+        CHECK(Topic("balance")["stale"] == false);
+    }
+}
+
+int main() {
+    CheckTopicMasks();
+    CheckPushesOnlyChanges();
+    CheckFetchAgain();
+    CheckEvents();
+    CheckStreamState();
+    return TestSupport::Result();
+}
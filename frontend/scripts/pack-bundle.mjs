@@ -0,0 +1,119 @@
+// Packs the Vite build (dist/) into dist/frontend.bundle, the single indexed archive the
+// shell memory-maps and serves on bitcoin-browser://app/. Text assets carry precompressed
+// brotli and gzip variants alongside the raw bytes. The layout must match FrontendBundle.h:
+//
+//   header  "BBFEPK01" | u32 entryCount | u32 indexBytes
+//   index   per entry, sorted by path:
+//           u16 pathLen | path | u8 mimeLen | mime | u64 etag (leading 8 bytes of SHA-256 of raw bytes)
+//           3 x (u64 offset | u32 length) for identity, br, gzip (offset 0 = absent)
+//   data    blobs referenced by absolute file offset
+//
+// All integers are little-endian.
+import { readdirSync, readFileSync, statSync, writeFileSync } from 'node:fs';
+import { join, relative, extname, sep } from 'node:path';
+import { fileURLToPath } from 'node:url';
+import { createHash } from 'node:crypto';
+import { brotliCompressSync, gzipSync, constants } from 'node:zlib';
+
+const distDir = fileURLToPath(new URL('../dist/', import.meta.url));
+const outFile = join(distDir, 'frontend.bundle');
+
+const MIME_TYPES = {
+  '.html': 'text/html',
+  '.js': 'text/javascript',
+  '.mjs': 'text/javascript',
+  '.css': 'text/css',
+  '.json': 'application/json',
+  '.map': 'application/json',
+  '.svg': 'image/svg+xml',
+  '.png': 'image/png',
+  '.jpg': 'image/jpeg',
+  '.jpeg': 'image/jpeg',
+  '.gif': 'image/gif',
+  '.webp': 'image/webp',
+  '.ico': 'image/x-icon',
+  '.woff': 'font/woff',
+  '.woff2': 'font/woff2',
+  '.ttf': 'font/ttf',
+  '.txt': 'text/plain',
+  '.wasm': 'application/wasm',
+};
+
+const COMPRESSIBLE = new Set(['.html', '.js', '.mjs', '.css', '.json', '.map', '.svg', '.txt', '.ico', '.ttf', '.wasm']);
+
+function walk(dir) {
+  return readdirSync(dir).flatMap((name) => {
+    const full = join(dir, name);
+    return statSync(full).isDirectory() ? walk(full) : [full];
+  });
+}
+
+function etagOf(buffer) {
+  return createHash('sha256').update(buffer).digest().readBigUInt64LE(0);
+}
+
+// Only keep a compressed variant when it saves at least 10%
+function worthIt(compressed, raw) {
+  return compressed.length < raw.length * 0.9 ? compressed : null;
+}
+
+const files = walk(distDir)
+  .filter((file) => file !== outFile)
+  .map((file) => {
+    const path = '/' + relative(distDir, file).split(sep).join('/');
+    const ext = extname(file).toLowerCase();
+    const raw = readFileSync(file);
+    const compressible = COMPRESSIBLE.has(ext) && raw.length > 256;
+    return {
+      path,
+      mime: MIME_TYPES[ext] ?? 'application/octet-stream',
+      etag: etagOf(raw),
+      variants: [
+        raw,
+        compressible ? worthIt(brotliCompressSync(raw, { params: { [constants.BROTLI_PARAM_QUALITY]: 11 } }), raw) : null,
+        compressible ? worthIt(gzipSync(raw, { level: 9 }), raw) : null,
+      ],
+    };
+  })
+  .sort((a, b) => (a.path < b.path ? -1 : a.path > b.path ? 1 : 0));
+
+const indexBytes = files.reduce(
+  (total, file) => total + 2 + Buffer.byteLength(file.path) + 1 + Buffer.byteLength(file.mime) + 8 + 3 * 12,
+  0
+);
+
+const header = Buffer.alloc(16);
+header.write('BBFEPK01', 0, 'ascii');
+header.writeUInt32LE(files.length, 8);
+header.writeUInt32LE(indexBytes, 12);
+
+const index = Buffer.alloc(indexBytes);
+const blobs = [];
+let indexPos = 0;
+let dataOffset = header.length + indexBytes;
+
+for (const file of files) {
+  indexPos = index.writeUInt16LE(Buffer.byteLength(file.path), indexPos);
+  indexPos += index.write(file.path, indexPos, 'utf8');
+  indexPos = index.writeUInt8(Buffer.byteLength(file.mime), indexPos);
+  indexPos += index.write(file.mime, indexPos, 'ascii');
+  indexPos = index.writeBigUInt64LE(file.etag, indexPos);
+
+  for (const variant of file.variants) {
+    if (variant) {
+      indexPos = index.writeBigUInt64LE(BigInt(dataOffset), indexPos);
+      indexPos = index.writeUInt32LE(variant.length, indexPos);
+      blobs.push(variant);
+      dataOffset += variant.length;
+    } else {
+      indexPos = index.writeBigUInt64LE(0n, indexPos);
+      indexPos = index.writeUInt32LE(0, indexPos);
+    }
+  }
+}
+
+writeFileSync(outFile, Buffer.concat([header, index, ...blobs]));
+
+const rawTotal = files.reduce((total, file) => total + file.variants[0].length, 0);
+const brTotal = files.reduce((total, file) => total + (file.variants[1] ?? file.variants[0]).length, 0);
+console.log(`📦 ${files.length} files packed into ${outFile} (${dataOffset} bytes; raw ${rawTotal}, brotli-served ${brTotal})`);
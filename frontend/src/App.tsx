@@ -38,6 +38,10 @@ const App = () => {
 
     console.log('🔐 Global showBRC100AuthApprovalModal function registered');
 
+    // Route components have mounted by now (child effects run first), so native can
+    // flush whatever it queued for this page instead of guessing with a delay
+    window.cefMessage?.send('app_ready', [window.location.pathname]);
+
     const checkWalletStatus = async () => {
       console.log("🔍 checkWalletStatus started");
 
@@ -450,7 +450,9 @@ declare global {
         getBackupModalState(): Promise<any>;
         setBackupModalState(data: any): Promise<any>;
         sendTransaction(data: any): Promise<any>;
-        getTransactionHistory(): Promise<any>;
+        getTransactionHistory(query?: any): Promise<any>;
+        subscribe(request: any): Promise<any>;
+        unsubscribe(request?: any): Promise<any>;
       };
       identity?: any;
       navigation?: any;
@@ -0,0 +1,21 @@
+// Request/response calls into the native browser process.
+// Each call carries its own request id, so any number of same-type calls can be in flight at once.
+export function cefRequest<T = any>(name: string, args: unknown[] = []): Promise<T> {
+  return new Promise<T>((resolve, reject) => {
+    const request = window.cefMessage?.request;
+    if (!request) {
+      reject(new Error('cefMessage.request bridge not available'));
+      return;
+    }
+
+    request(
+      name,
+      args,
+      (data: T) => resolve(data),
+      (error: any) => {
+        const message = typeof error === 'string' ? error : error?.error ?? JSON.stringify(error);
+        reject(new Error(message));
+      }
+    );
+  });
+}
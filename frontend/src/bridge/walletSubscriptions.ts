@@ -0,0 +1,70 @@
+import type { WalletTopic, WalletTopicState, WalletStateUpdate } from '../types/walletState';
+
+// Pushed wallet state for the whole page. However many components watch a topic, the browser
+// sees one subscription for it, made when the first listener arrives and dropped with the last.
+type Listener<T extends WalletTopic> = (state: WalletTopicState[T]) => void;
+
+const listeners = new Map<WalletTopic, Set<Listener<any>>>();
+const latest = new Map<WalletTopic, { version: number; state: any }>();
+let listening = false;
+
+function deliver(topic: WalletTopic, version: number, state: any) {
+  const known = latest.get(topic);
+  if (known && known.version >= version) {
+    return;
+  }
+  latest.set(topic, { version, state });
+  listeners.get(topic)?.forEach(listener => listener(state));
+}
+
+function handleMessage(event: MessageEvent) {
+  if (event.data?.type !== 'wallet_state') {
+    return;
+  }
+  const update = event.data.payload as WalletStateUpdate;
+  deliver(update.topic, update.version, update.state);
+}
+
+// Calls listener with the topic's state now if known, then on every change; returns the unsubscribe
+export function subscribeWallet<T extends WalletTopic>(topic: T, listener: Listener<T>): () => void {
+  if (!listening) {
+    window.addEventListener('message', handleMessage);
+    listening = true;
+  }
+
+  let topicListeners = listeners.get(topic);
+  const first = !topicListeners;
+  if (!topicListeners) {
+    topicListeners = new Set();
+    listeners.set(topic, topicListeners);
+  }
+  topicListeners.add(listener);
+
+  const known = latest.get(topic);
+  if (known) {
+    listener(known.state);
+  }
+
+  if (first) {
+    window.bitcoinBrowser?.wallet?.subscribe({ topics: [topic] })
+      .then(response => {
+        const current = response.states[topic];
+        if (current) {
+          deliver(topic, current.version, current.state);
+        }
+      })
+      .catch(err => console.error(`Wallet subscription to ${topic} failed:`, err));
+  }
+
+  return () => {
+    const remaining = listeners.get(topic);
+    if (!remaining || !remaining.delete(listener) || remaining.size > 0) {
+      return;
+    }
+    // Nothing on the page watches the topic any more, so the browser can stop pushing it
+    listeners.delete(topic);
+    latest.delete(topic);
+    window.bitcoinBrowser?.wallet?.unsubscribe({ topics: [topic] })
+      .catch(err => console.error(`Wallet unsubscribe from ${topic} failed:`, err));
+  };
+}
@@ -3,12 +3,22 @@ import type { Transaction } from '../types/transaction';
 
 interface TransactionHistoryProps {
   transactions: Transaction[];
+  // All cached transactions; transactions holds the pages loaded so far
+  total?: number;
   isLoading?: boolean;
+  isSyncing?: boolean;
+  onLoadMore?: () => void;
 }
 
+// Distance from the bottom of the list at which the next page is requested
+const LOAD_MORE_THRESHOLD_PX = 200;
+
 export const TransactionHistory: React.FC<TransactionHistoryProps> = ({
   transactions,
-  isLoading = false
+  total = transactions.length,
+  isLoading = false,
+  isSyncing = false,
+  onLoadMore
 }) => {
   const [selectedTransaction, setSelectedTransaction] = useState<Transaction | null>(null);
 
@@ -122,7 +132,15 @@ export const TransactionHistory: React.FC<TransactionHistoryProps> = ({
     );
   }
 
-  if (transactions.length === 0) {
+  const handleScroll = (e: React.UIEvent<HTMLDivElement>) => {
+    const list = e.currentTarget;
+    if (onLoadMore && transactions.length < total &&
+        list.scrollHeight - list.scrollTop - list.clientHeight < LOAD_MORE_THRESHOLD_PX) {
+      onLoadMore();
+    }
+  };
+
+  if (transactions.length === 0 && !isSyncing) {
     return (
       <div className="transaction-history">
         <div className="history-header">
@@ -141,10 +159,12 @@ export const TransactionHistory: React.FC<TransactionHistoryProps> = ({
     <div className="transaction-history">
       <div className="history-header">
         <h3>Transaction History</h3>
-        <span className="transaction-count">{transactions.length} transactions</span>
+        <span className="transaction-count">
+          {total} transactions{isSyncing ? ' (syncing...)' : ''}
+        </span>
       </div>
 
-      <div className="transaction-list">
+      <div className="transaction-list" onScroll={handleScroll}>
         {transactions.map((transaction) => (
           <div
             key={transaction.txid}
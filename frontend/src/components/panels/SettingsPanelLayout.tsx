@@ -1,13 +1,17 @@
-import React from 'react';
+import React, { useEffect, useState } from 'react';
 import {
   Drawer,
   Box,
   Typography,
   IconButton,
   Divider,
+  List,
+  ListItem,
+  ListItemText,
 } from '@mui/material';
 import CloseIcon from '@mui/icons-material/Close';
 import SettingsIcon from '@mui/icons-material/Settings';
+import type { SiteActivity } from '../../types/activity';
 
 type Props = {
   onClose: () => void;
@@ -16,6 +20,20 @@ type Props = {
 
 const SettingsPanelLayout: React.FC<Props> = ({ onClose, open }) => {
   console.log("🔧 SettingsPanelLayout render - open:", open);
+  const [sites, setSites] = useState<SiteActivity[] | null>(null);
+
+  // Wallet calls per site over the last 30 days, refreshed each time the panel opens
+  useEffect(() => {
+    if (!open || !window.bitcoinBrowser?.wallet?.getActivity) {
+      return;
+    }
+    window.bitcoinBrowser.wallet.getActivity({ limit: 20 })
+      .then((result) => setSites(result && 'domains' in result ? result.domains : []))
+      .catch((err) => {
+        console.error("Wallet activity query error:", err);
+        setSites([]);
+      });
+  }, [open]);
 
   return (
     <Drawer
@@ -43,7 +61,23 @@ const SettingsPanelLayout: React.FC<Props> = ({ onClose, open }) => {
       <Divider sx={{ bgcolor: 'grey.700' }} />
 
       <Box p={2}>
-        <Typography>Settings content will go here.</Typography>
+        <Typography variant="subtitle2" sx={{ color: 'grey.400' }}>
+          Wallet activity (30 days)
+        </Typography>
+        {sites && sites.length === 0 && (
+          <Typography variant="body2" sx={{ mt: 1 }}>No site has used the wallet yet.</Typography>
+        )}
+        <List dense>
+          {sites?.map((site) => (
+            <ListItem key={site.domain} disableGutters>
+              <ListItemText
+                primary={site.domain}
+                secondary={`${site.calls} calls · ${site.errors} failed · ${site.avgLatencyMs.toFixed(0)} ms avg`}
+                secondaryTypographyProps={{ sx: { color: 'grey.500' } }}
+              />
+            </ListItem>
+          ))}
+        </List>
       </Box>
     </Drawer>
   );
@@ -1,11 +1,16 @@
-import { useState, useCallback, useEffect } from 'react';
+import { useState, useCallback, useEffect, useRef } from 'react';
+import { subscribeWallet } from '../bridge/walletSubscriptions';
 // Removed useWallet import - using HD wallet system directly
 
 export const useBalance = () => {
   const [balance, setBalance] = useState(0);
-  const [usdValue, setUsdValue] = useState(0);
+  const [bsvPrice, setBsvPrice] = useState(0);
   const [isLoading, setIsLoading] = useState(false);
   const [error, setError] = useState<string | null>(null);
+  const balanceRef = useRef(0);
+
+  // Follows pushed balance changes without refetching the price
+  const usdValue = (balance / 100000000) * bsvPrice;
 
   const fetchBalance = useCallback(async (): Promise<number> => {
     setIsLoading(true);
@@ -20,6 +25,7 @@ export const useBalance = () => {
       // Get total balance across all addresses (no address parameter needed)
       const response = await window.bitcoinBrowser.wallet.getBalance();
 
+      balanceRef.current = response.balance;
       setBalance(response.balance);
       return response.balance;
     } catch (err) {
@@ -57,19 +63,19 @@ export const useBalance = () => {
         throw new Error('Invalid price data received from CryptoCompare API');
       }
 
-      const usdValue = (balance / 100000000) * price; // Convert satoshis to BSV, then to USD
-      setUsdValue(usdValue);
+      const usdValue = (balanceRef.current / 100000000) * price; // Convert satoshis to BSV, then to USD
+      setBsvPrice(price);
 
-      console.log(`💰 BSV Price: $${price}, Balance: ${balance} satoshis, USD Value: $${usdValue.toFixed(2)}`);
+      console.log(`💰 BSV Price: $${price}, Balance: ${balanceRef.current} satoshis, USD Value: $${usdValue.toFixed(2)}`);
       return usdValue;
 
     } catch (err) {
       console.error('❌ Failed to fetch BSV price:', err);
       console.error('🔍 This indicates a problem with the CryptoCompare API - investigate network connectivity and API status');
-      setUsdValue(0);
+      setBsvPrice(0);
       throw new Error(`Price fetch failed: ${err instanceof Error ? err.message : 'Unknown error'}`);
     }
-  }, [balance]);
+  }, []);
 
 
   const refreshBalance = useCallback(async () => {
@@ -77,14 +83,11 @@ export const useBalance = () => {
     await fetchUsdPrice();
   }, [fetchBalance, fetchUsdPrice]);
 
-  // Auto-refresh balance every 30 seconds - DISABLED FOR DEBUGGING
-  // useEffect(() => {
-  //   const interval = setInterval(() => {
-  //     refreshBalance();
-  //   }, 30000);
-
-  //   return () => clearInterval(interval);
-  // }, [refreshBalance]);
+  // The browser pushes balance changes as they happen, so there is nothing to poll
+  useEffect(() => subscribeWallet('balance', state => {
+    balanceRef.current = state.balance;
+    setBalance(state.balance);
+  }), []);
 
   // Initial load
   useEffect(() => {
@@ -77,6 +77,22 @@ export function useBitcoinBrowser() {
     }
   }, []);
 
+  const predict = useCallback((text: string): void => {
+    window.bitcoinBrowser?.navigation?.predict?.(text);
+  }, []);
+
+  const searchHistory = useCallback(async (text: string) => {
+    if (!window.bitcoinBrowser?.history?.search) {
+      return [];
+    }
+    try {
+      return await window.bitcoinBrowser.history.search(text);
+    } catch (err) {
+      console.error("History search error:", err);
+      return [];
+    }
+  }, []);
+
   const goBack = useCallback((): void => {
     console.log('🔙 Going back in browser history');
     window.cefMessage?.send('navigate_back', []);
@@ -97,6 +113,8 @@ export function useBitcoinBrowser() {
     markBackedUp,
     generateAddress,
     navigate,
+    predict,
+    searchHistory,
     goBack,
     goForward,
     reload,
@@ -1,11 +1,77 @@
-import { useState, useCallback } from 'react';
+import { useState, useCallback, useRef, useEffect } from 'react';
 // Removed useWallet import - private keys handled by Go daemon
-import type { TransactionData, Transaction, TransactionResponse } from '../types/transaction';
+import { subscribeWallet } from '../bridge/walletSubscriptions';
+import type { TransactionData, Transaction, TransactionResponse, TransactionHistoryPage } from '../types/transaction';
+
+// Rows fetched per request; the browser keeps the full history and serves windows of it
+const HISTORY_PAGE_SIZE = 50;
 
 export const useTransaction = () => {
-  const [transactions] = useState<Transaction[]>([]);
+  const [transactions, setTransactions] = useState<Transaction[]>([]);
+  const [totalTransactions, setTotalTransactions] = useState(0);
+  const [isSyncing, setIsSyncing] = useState(false);
   const [isLoading, setIsLoading] = useState(false);
   const [error, setError] = useState<string | null>(null);
+  const loadedCount = useRef(0);
+  const loadingMore = useRef(false);
+  // version:syncedAt of the rows on screen, to tell a pushed change from one already shown
+  const shownSync = useRef<string | null>(null);
+
+  const fetchHistoryPage = useCallback(async (offset: number, limit: number, refresh = false): Promise<TransactionHistoryPage> => {
+    if (!window.bitcoinBrowser?.wallet) {
+      throw new Error('Bitcoin Browser wallet not available');
+    }
+    return window.bitcoinBrowser.wallet.getTransactionHistory({ offset, limit, refresh });
+  }, []);
+
+  // Reloads the rows already on screen; a running sync is followed up by the history push it ends with
+  const reloadHistory = useCallback(async (refresh: boolean) => {
+    const page = await fetchHistoryPage(0, Math.max(loadedCount.current, HISTORY_PAGE_SIZE), refresh);
+    loadedCount.current = page.items.length;
+    shownSync.current = `${page.version}:${page.syncedAt}`;
+    setTransactions(page.items);
+    setTotalTransactions(page.total);
+    setIsSyncing(page.syncing);
+    if (page.error) {
+      setError(page.error);
+    }
+  }, [fetchHistoryPage]);
+
+  const getTransactionHistory = useCallback(async () => {
+    setIsLoading(true);
+    try {
+      await reloadHistory(true);
+    } catch (err) {
+      const errorMessage = err instanceof Error ? err.message : 'Failed to load transaction history';
+      setError(errorMessage);
+      throw new Error(errorMessage);
+    } finally {
+      setIsLoading(false);
+    }
+  }, [reloadHistory]);
+
+  const loadMoreTransactions = useCallback(async () => {
+    if (loadingMore.current || loadedCount.current >= totalTransactions) {
+      return;
+    }
+    loadingMore.current = true;
+    try {
+      const page = await fetchHistoryPage(loadedCount.current, HISTORY_PAGE_SIZE);
+      loadedCount.current += page.items.length;
+      setTransactions(previous => previous.concat(page.items));
+      setTotalTransactions(page.total);
+    } finally {
+      loadingMore.current = false;
+    }
+  }, [fetchHistoryPage, totalTransactions]);
+
+  useEffect(() => subscribeWallet('history', state => {
+    // Only once rows are on screen, and only when the push is newer than them
+    if (shownSync.current === null || shownSync.current === `${state.version}:${state.syncedAt}`) {
+      return;
+    }
+    reloadHistory(false).catch(err => console.error('History refresh failed:', err));
+  }), [reloadHistory]);
 
   const sendTransaction = useCallback(async (data: TransactionData): Promise<TransactionResponse> => {
     setIsLoading(true);
@@ -34,8 +100,12 @@ export const useTransaction = () => {
 
   return {
     transactions,
+    totalTransactions,
+    isSyncing,
     isLoading,
     error,
-    sendTransaction
+    sendTransaction,
+    getTransactionHistory,
+    loadMoreTransactions
   };
 };
@@ -29,6 +29,15 @@ const BRC100AuthOverlayRoot: React.FC = () => {
     return () => window.removeEventListener('message', handleMessage);
   }, []);
 
+  // Report when the modal is actually on screen (next frame after it opens) for latency tracking
+  useEffect(() => {
+    if (!authModalOpen) return;
+    const frame = requestAnimationFrame(() => {
+      window.cefMessage?.send('brc100_auth_modal_visible', []);
+    });
+    return () => cancelAnimationFrame(frame);
+  }, [authModalOpen]);
+
   const handleAuthApprove = async (whitelist: boolean) => {
     console.log('🔐 BRC-100 Auth approved, whitelist:', whitelist);
     setAuthModalOpen(false);
@@ -20,6 +20,11 @@ const BackupOverlayRoot: React.FC = () => {
   useEffect(() => {
     console.log("💾 BackupOverlayRoot mounted - always showing modal");
     setShowBackupModal(true);
+
+    // Hidden rather than unmounted on close; bring the modal back on the next show
+    const handleOverlayShown = () => setShowBackupModal(true);
+    window.addEventListener('overlayShown', handleOverlayShown);
+    return () => window.removeEventListener('overlayShown', handleOverlayShown);
   }, []);
 
   // Modal state management functions
@@ -1,4 +1,4 @@
-import React, { useState } from 'react';
+import React, { useRef, useState } from 'react';
 import {
   Box,
   Toolbar,
@@ -27,11 +27,52 @@ const MainBrowserView: React.FC = () => {
     // Settings panel state now managed in separate overlay process
     const [address, setAddress] = useState('https://metanetapps.com/');
 
-    const { navigate, goBack, goForward, reload } = useBitcoinBrowser();
+    const { navigate, predict, searchHistory, goBack, goForward, reload } = useBitcoinBrowser();
+
+    // Inline autocomplete: the best history match fills in after the caret, selected
+    const inputRef = useRef<HTMLInputElement>(null);
+    const typedRef = useRef('');
+    const [completion, setCompletion] = useState<{ text: string; url: string } | null>(null);
+
+    const completeFromHistory = async (typed: string) => {
+        const suggestions = await searchHistory(typed);
+        if (typedRef.current !== typed) {
+            return;
+        }
+        const lower = typed.toLowerCase();
+        for (const suggestion of suggestions) {
+            const bare = suggestion.url.replace(/^[a-z]+:\/\//i, '');
+            const forms = [suggestion.url, bare, bare.replace(/^www\./i, '')];
+            const form = forms.find((candidate) => candidate.toLowerCase().startsWith(lower));
+            if (form && form.length > typed.length) {
+                const text = typed + form.slice(typed.length);
+                setAddress(text);
+                setCompletion({ text, url: suggestion.url });
+                requestAnimationFrame(() => inputRef.current?.setSelectionRange(typed.length, text.length));
+                return;
+            }
+        }
+    };
+
+    const handleChange = (e: React.ChangeEvent<HTMLInputElement>) => {
+        const typed = e.target.value;
+        typedRef.current = typed;
+        setAddress(typed);
+        setCompletion(null);
+        predict(typed);
+
+        // Deleting shouldn't re-complete what was just removed
+        const inputType = (e.nativeEvent as InputEvent).inputType || '';
+        if (typed.trim() && !inputType.startsWith('delete')) {
+            completeFromHistory(typed);
+        }
+    };
 
     const handleNavigate = () => {
-        console.log('🧭 Navigating to:', address);
-        navigate(address);
+        const target = completion && completion.text === address ? completion.url : address;
+        console.log('🧭 Navigating to:', target);
+        setCompletion(null);
+        navigate(target);
     };
 
     const handleKeyDown = (e: React.KeyboardEvent<HTMLInputElement>) => {
@@ -88,7 +129,8 @@ const MainBrowserView: React.FC = () => {
                 >
                     <InputBase
                         value={address}
-                        onChange={(e) => setAddress(e.target.value)}
+                        inputRef={inputRef}
+                        onChange={handleChange}
                         onKeyDown={handleKeyDown}
                         placeholder="Enter address or search"
                         fullWidth
@@ -10,6 +10,9 @@ export const SendPage: React.FC = () => {
   const { balance, usdValue, isLoading: balanceLoading, refreshBalance } = useBalance();
   const {
     transactions,
+    totalTransactions,
+    isSyncing,
+    loadMoreTransactions,
     isLoading: transactionLoading,
     error: transactionError,
     createTransaction,
@@ -133,7 +136,12 @@ Status: ${result.status}`);
           <div className="history-section">
             <TransactionHistory
               transactions={transactions}
+              total={totalTransactions}
               isLoading={transactionLoading}
+              isSyncing={isSyncing}
+              onLoadMore={() => {
+                loadMoreTransactions().catch(err => console.error('Loading more history failed:', err));
+              }}
             />
           </div>
         )}
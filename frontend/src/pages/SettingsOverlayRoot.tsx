@@ -48,6 +48,11 @@ const SettingsOverlayRoot: React.FC = () => {
       // Clear the pending request
       (window as any).pendingBRC100AuthRequest = null;
     }
+
+    // Native keeps this overlay pooled, so reopen the panel whenever it is shown again
+    const handleOverlayShown = () => setSettingsOpen(true);
+    window.addEventListener('overlayShown', handleOverlayShown);
+    return () => window.removeEventListener('overlayShown', handleOverlayShown);
   }, []);
 
   const handleAuthApprove = (whitelist: boolean) => {
@@ -28,6 +28,11 @@ const WalletOverlayRoot: React.FC = () => {
         setWalletOpen(true);
       }
     };
+
+    // Pooled overlay: native hides this page on close and re-shows it instead of reloading
+    const handleOverlayShown = () => setWalletOpen(true);
+    window.addEventListener('overlayShown', handleOverlayShown);
+    return () => window.removeEventListener('overlayShown', handleOverlayShown);
   }, []);
 
   console.log("💰 WalletOverlayRoot render - walletOpen:", walletOpen);
@@ -0,0 +1,44 @@
+export type ActivityTotals = {
+  calls: number;
+  errors: number;
+  avgLatencyMs: number;
+  bytesIn: number;
+  bytesOut: number;
+};
+
+export type SiteActivity = ActivityTotals & {
+  domain: string;
+  lastUsed: number;
+};
+
+export type RouteActivity = ActivityTotals & {
+  route: string;
+  maxLatencyMs: number;
+};
+
+// Without a domain: every site's totals over the range, busiest first
+export type ActivityOverview = {
+  from: number;
+  to: number;
+  total: ActivityTotals & { domains: number };
+  domains: SiteActivity[];
+};
+
+// With a domain: that site's routes and calls over time
+export type SiteActivityDetail = {
+  domain: string;
+  from: number;
+  to: number;
+  total: ActivityTotals;
+  lastUsed: number;
+  routes: RouteActivity[];
+  bucketMs: number;
+  series: { t: number; calls: number; errors: number }[];
+};
+
+export type ActivityQuery = {
+  domain?: string;
+  from?: number;
+  to?: number;
+  limit?: number;
+};
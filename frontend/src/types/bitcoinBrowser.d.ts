@@ -1,5 +1,7 @@
 import type { AddressData } from './address';
-import type { TransactionResponse, BroadcastResponse } from './transaction';
+import type { TransactionResponse, BroadcastResponse, TransactionHistoryQuery, TransactionHistoryPage } from './transaction';
+import type { ActivityQuery, ActivityOverview, SiteActivityDetail } from './activity';
+import type { WalletTopic, WalletSubscribeResponse } from './walletState';
 
 declare global {
   interface Window {
@@ -15,12 +17,31 @@ declare global {
         markBackedUp: () => Promise<{ success: boolean }>;
         getBackupModalState: () => Promise<{ shown: boolean }>;
         setBackupModalState: (shown: boolean) => Promise<{ success: boolean }>;
+        getTransactionHistory: (query?: TransactionHistoryQuery) => Promise<TransactionHistoryPage>;
+        // Wallet calls made by sites; null for an unknown domain, { loading: true } until the journal is read
+        getActivity: (query?: ActivityQuery) => Promise<ActivityOverview | SiteActivityDetail | null | { loading: true }>;
+        // Changes to these topics arrive as 'wallet_state' message events until unsubscribed
+        subscribe: (request: { topics: WalletTopic[] }) => Promise<WalletSubscribeResponse>;
+        unsubscribe: (request?: { topics: WalletTopic[] }) => Promise<{ success: boolean }>;
       };
       address: {
         generate: () => Promise<AddressData>;
       };
       navigation: {
         navigate: (path: string) => void;
+        // Address bar text as typed; lets the browser warm up the likely destination
+        predict: (text: string) => void;
+      };
+      history: {
+        // Best matches first; prefix is true when the URL starts with the typed text
+        search: (text: string) => Promise<{ url: string; title: string; visits: number; typed: number; prefix: boolean }[]>;
+      };
+      tabs: {
+        open: (url?: string, activate?: boolean) => void;
+        activate: (tabId: number) => void;
+        close: (tabId: number) => void;
+        // Replies with a 'tabs_changed' message event
+        list: () => void;
       };
       overlay: {
         show: () => void;
@@ -35,6 +56,7 @@ declare global {
     };
     cefMessage?: {
       send: (channel: string, args: any[]) => void;
+      request: (channel: string, args: any[], onSuccess: (data: any) => void, onError: (error: any) => void) => number;
     };
     triggerPanel?: (panelName: string) => void;
     onAddressGenerated?: (data: AddressData) => void;
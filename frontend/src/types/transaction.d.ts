@@ -16,6 +16,31 @@ export interface Transaction {
   memo?: string;
 }
 
+export interface TransactionHistoryQuery {
+  offset?: number;
+  limit?: number;
+  status?: Transaction['status'];
+  // Case-insensitive match on txid, recipient or memo
+  text?: string;
+  // Sync with the wallet now instead of when the cache is stale
+  refresh?: boolean;
+}
+
+// One window of the browser's cached history, newest first
+export interface TransactionHistoryPage {
+  total: number;
+  offset: number;
+  items: Transaction[];
+  version?: number;
+  // A sync with the wallet is running; a history push follows when it is done
+  syncing: boolean;
+  // false once the oldest transactions have been dropped from the cache
+  complete?: boolean;
+  syncedAt?: number;
+  loading?: boolean;
+  error?: string;
+}
+
 export interface TransactionResponse {
   txid: string;
   rawTx?: string;
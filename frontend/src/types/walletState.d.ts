@@ -0,0 +1,23 @@
+import type { AddressData } from './address';
+
+export type WalletTopic = 'balance' | 'addresses' | 'history' | 'messages';
+
+// State pushed for each topic; history carries only its size, pages come from getTransactionHistory
+export type WalletTopicState = {
+  balance: { balance: number };
+  addresses: { addresses: AddressData[] };
+  history: { total: number; version: number; syncedAt: number };
+  messages: { count: number };
+};
+
+// Payload of a 'wallet_state' message event; version grows with every change to the topic
+export type WalletStateUpdate<T extends WalletTopic = WalletTopic> = {
+  topic: T;
+  version: number;
+  state: WalletTopicState[T];
+};
+
+// Current state of the subscribed topics the browser already knows; the rest arrive as events
+export type WalletSubscribeResponse = {
+  states: { [T in WalletTopic]?: { version: number; state: WalletTopicState[T] } };
+};
@@ -22,12 +22,24 @@ type BRCSession struct {
 	Permissions   []string               `json:"permissions"`
 }
 
+// Session changes reported to a SessionManager's listener
+const (
+	SessionCreated = "created"
+	SessionUpdated = "updated"
+	SessionRevoked = "revoked"
+	SessionExpired = "expired"
+)
+
+// SessionChangeListener receives a copy of each session as it changes
+type SessionChangeListener func(change string, session BRCSession)
+
 // SessionManager manages BRC-100 sessions
 type SessionManager struct {
 	logger    *logrus.Logger
 	sessions  map[string]*BRCSession
 	mutex     sync.RWMutex
 	cleanupTicker *time.Ticker
+	onChange  SessionChangeListener
 }
 
 // NewSessionManager creates a new session manager
@@ -46,6 +58,23 @@ func NewSessionManager() *SessionManager {
 	return sm
 }
 
+// SetChangeListener reports every session created, updated, revoked or expired from now on, so
+// copies of the session table kept elsewhere can follow it
+func (sm *SessionManager) SetChangeListener(listener SessionChangeListener) {
+	sm.mutex.Lock()
+	sm.onChange = listener
+	sm.mutex.Unlock()
+}
+
+func (sm *SessionManager) notify(change string, session *BRCSession) {
+	sm.mutex.RLock()
+	listener := sm.onChange
+	sm.mutex.RUnlock()
+	if listener != nil {
+		listener(change, *session)
+	}
+}
+
 // GenerateBRCSessionID creates a BSV-native session ID
 func GenerateBRCSessionID(walletAddress, appDomain string) string {
 	data := fmt.Sprintf("%s:%s:%d", walletAddress, appDomain, time.Now().Unix())
@@ -85,6 +114,7 @@ func (sm *SessionManager) CreateSession(appDomain string, identityCert map[strin
 	sm.mutex.Lock()
 	sm.sessions[sessionID] = session
 	sm.mutex.Unlock()
+	sm.notify(SessionCreated, session)
 
 	sm.logger.Infof("Session created successfully: %s", sessionID)
 	return session, nil
@@ -105,7 +135,7 @@ func (sm *SessionManager) GetSession(sessionID string) (*BRCSession, error) {
 	// Check if session is expired
 	if time.Now().After(session.ExpiresAt) {
 		sm.logger.Warnf("Session expired: %s", sessionID)
-		sm.DeleteSession(sessionID)
+		sm.removeSession(sessionID, SessionExpired)
 		return nil, fmt.Errorf("session expired: %s", sessionID)
 	}
 
@@ -128,6 +158,7 @@ func (sm *SessionManager) AuthenticateSession(sessionID string) error {
 	// Mark session as authenticated
 	session.Authenticated = true
 	session.LastActivity = time.Now()
+	sm.notify(SessionUpdated, session)
 
 	sm.logger.Infof("Session authenticated successfully: %s", sessionID)
 	return nil
@@ -145,6 +176,7 @@ func (sm *SessionManager) UpdateSessionPermissions(sessionID string, permissions
 	// Update permissions
 	session.Permissions = permissions
 	session.LastActivity = time.Now()
+	sm.notify(SessionUpdated, session)
 
 	sm.logger.Infof("Session permissions updated successfully: %s", sessionID)
 	return nil
@@ -153,13 +185,21 @@ func (sm *SessionManager) UpdateSessionPermissions(sessionID string, permissions
 // DeleteSession deletes a session
 func (sm *SessionManager) DeleteSession(sessionID string) error {
 	sm.logger.Infof("Deleting session: %s", sessionID)
+	sm.removeSession(sessionID, SessionRevoked)
+	sm.logger.Infof("Session deleted successfully: %s", sessionID)
+	return nil
+}
 
+// removeSession drops a session and reports why, if it was still there
+func (sm *SessionManager) removeSession(sessionID string, change string) {
 	sm.mutex.Lock()
+	session, exists := sm.sessions[sessionID]
 	delete(sm.sessions, sessionID)
 	sm.mutex.Unlock()
 
-	sm.logger.Infof("Session deleted successfully: %s", sessionID)
-	return nil
+	if exists {
+		sm.notify(change, session)
+	}
 }
 
 // GetActiveSessions returns all active sessions
@@ -221,6 +261,7 @@ func (sm *SessionManager) ExtendSession(sessionID string, duration time.Duration
 	// Extend expiration time
 	session.ExpiresAt = time.Now().Add(duration)
 	session.LastActivity = time.Now()
+	sm.notify(SessionUpdated, session)
 
 	sm.logger.Infof("Session extended successfully: %s", sessionID)
 	return nil
@@ -256,11 +297,9 @@ func (sm *SessionManager) cleanupExpiredSessions() {
 	sm.mutex.RUnlock()
 
 	// Delete expired sessions
-	sm.mutex.Lock()
 	for _, sessionID := range expiredSessions {
-		delete(sm.sessions, sessionID)
+		sm.removeSession(sessionID, SessionExpired)
 	}
-	sm.mutex.Unlock()
 
 	if len(expiredSessions) > 0 {
 		sm.logger.Infof("Cleaned up %d expired sessions", len(expiredSessions))
@@ -133,6 +133,9 @@ type SPVRequest struct {
 // SetupBRC100Routes sets up all BRC-100 related HTTP routes
 func (ws *WalletService) SetupBRC100Routes() {
 	brc100Service := NewBRC100Service(ws.walletManager)
+	brc100Service.sessionManager.SetChangeListener(func(change string, session authentication.BRCSession) {
+		ws.events.Publish(map[string]interface{}{"change": change, "session": session}, TopicSessions)
+	})
 
 	// Identity Management Endpoints
 	http.HandleFunc("/brc100/identity/generate", func(w http.ResponseWriter, r *http.Request) {
@@ -173,6 +176,10 @@ func (ws *WalletService) SetupBRC100Routes() {
 		handleSessionRevoke(w, r, brc100Service)
 	})
 
+	http.HandleFunc("/brc100/sessions", func(w http.ResponseWriter, r *http.Request) {
+		handleSessionList(w, r, brc100Service)
+	})
+
 	// BEEF Transaction Endpoints
 	http.HandleFunc("/brc100/beef/create", func(w http.ResponseWriter, r *http.Request) {
 		handleBEEFCreate(w, r, brc100Service)
@@ -648,6 +655,32 @@ func handleSessionRevoke(w http.ResponseWriter, r *http.Request, service *BRC100
 	json.NewEncoder(w).Encode(response)
 }
 
+// handleSessionList returns every unexpired session, for the browser to seed its copy of the
+// table before following the sessions topic of /wallet/events
+func handleSessionList(w http.ResponseWriter, r *http.Request, service *BRC100Service) {
+	if r.Method != "GET" {
+		http.Error(w, "Method not allowed", http.StatusMethodNotAllowed)
+		return
+	}
+	// Every site's session IDs are listed here, so only the browser may read them; sites reach
+	// the TCP port through the browser, and a path the browser does not recognise as this one can
+	// still end up here
+	if !fromLocalSocket(r) {
+		http.Error(w, "Only served on the local socket", http.StatusForbidden)
+		return
+	}
+
+	response := BRC100Response{
+		Success: true,
+		Data: map[string]interface{}{
+			"sessions": service.sessionManager.GetActiveSessions(),
+		},
+	}
+
+	w.Header().Set("Content-Type", "application/json")
+	json.NewEncoder(w).Encode(response)
+}
+
 // BEEF Transaction Handlers
 
 func handleBEEFCreate(w http.ResponseWriter, r *http.Request, service *BRC100Service) {
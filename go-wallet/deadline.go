@@ -0,0 +1,36 @@
+package main
+
+import (
+	"context"
+	"net/http"
+	"strconv"
+	"time"
+)
+
+// Header the browser sets to the milliseconds it will still wait for an answer
+const requestDeadlineHeader = "X-Request-Deadline-Ms"
+
+// withRequestDeadline turns the browser's deadline into the request's context deadline, so work
+// done for a caller that has already given up can stop early. A request that arrives with no time
+// left is refused without running.
+func withRequestDeadline(next http.Handler) http.Handler {
+	return http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+		value := r.Header.Get(requestDeadlineHeader)
+		if value == "" {
+			next.ServeHTTP(w, r)
+			return
+		}
+		remainingMs, err := strconv.Atoi(value)
+		if err != nil {
+			next.ServeHTTP(w, r)
+			return
+		}
+		if remainingMs <= 0 {
+			http.Error(w, "request deadline already passed", http.StatusGatewayTimeout)
+			return
+		}
+		ctx, cancel := context.WithTimeout(r.Context(), time.Duration(remainingMs)*time.Millisecond)
+		defer cancel()
+		next.ServeHTTP(w, r.WithContext(ctx))
+	})
+}
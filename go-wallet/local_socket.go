@@ -0,0 +1,49 @@
+package main
+
+import (
+	"fmt"
+	"net"
+	"net/http"
+	"os"
+	"path/filepath"
+)
+
+// GetDaemonSocketPath returns the Unix domain socket the browser prefers over localhost:3301
+func GetDaemonSocketPath() string {
+	homeDir, _ := os.UserHomeDir()
+	return filepath.Join(homeDir, "AppData", "Roaming", "BabbageBrowser", "wallet", "daemon.sock")
+}
+
+// ServeLocalSocket serves the daemon's HTTP API on a Unix domain socket next to the wallet file
+// as well, so the browser can skip the loopback TCP stack. Unlike the TCP port, the socket only
+// accepts connections from the user the daemon runs as (see listenLocalSocket).
+func ServeLocalSocket(server *http.Server) {
+	path := GetDaemonSocketPath()
+	if err := os.MkdirAll(filepath.Dir(path), 0700); err != nil {
+		fmt.Printf("⚠️ Local socket disabled, cannot create %s: %v\n", filepath.Dir(path), err)
+		return
+	}
+
+	// A socket file left behind by a daemon that did not shut down cleanly blocks Listen
+	os.Remove(path)
+
+	listener, err := listenLocalSocket(path)
+	if err != nil {
+		fmt.Printf("⚠️ Local socket disabled, browser will use TCP: %v\n", err)
+		return
+	}
+
+	fmt.Printf("🔌 Wallet daemon also listening on %s\n", path)
+	go func() {
+		if err := server.Serve(listener); err != nil && err != http.ErrServerClosed {
+			fmt.Printf("⚠️ Local socket stopped: %v\n", err)
+		}
+	}()
+}
+
+// fromLocalSocket reports whether r came in over the local socket, which only the daemon's user
+// can connect to, rather than the TCP port that any page the browser loads can reach
+func fromLocalSocket(r *http.Request) bool {
+	_, ok := r.Context().Value(http.LocalAddrContextKey).(*net.UnixAddr)
+	return ok
+}
@@ -0,0 +1,21 @@
+//go:build !windows
+
+package main
+
+import (
+	"net"
+	"os"
+)
+
+// listenLocalSocket listens on the socket at path so that only the daemon's user can connect
+func listenLocalSocket(path string) (net.Listener, error) {
+	listener, err := net.Listen("unix", path)
+	if err != nil {
+		return nil, err
+	}
+	if err := os.Chmod(path, 0600); err != nil {
+		listener.Close()
+		return nil, err
+	}
+	return listener, nil
+}
@@ -0,0 +1,19 @@
+package main
+
+import (
+	"fmt"
+	"net"
+	"path/filepath"
+)
+
+// listenLocalSocket listens on the socket at path so that only the daemon's user can connect.
+// os.Chmod cannot do that on Windows (it only toggles the read-only attribute), and connecting to
+// an AF_UNIX socket is checked against the socket file's DACL, so the wallet directory is given an
+// owner-only DACL first and the socket file inherits it as bind creates it.
+func listenLocalSocket(path string) (net.Listener, error) {
+	dir := filepath.Dir(path)
+	if err := restrictDirectoryToOwner(dir); err != nil {
+		return nil, fmt.Errorf("cannot restrict %s to the current user: %v", dir, err)
+	}
+	return net.Listen("unix", path)
+}
@@ -88,6 +88,7 @@ type WalletService struct {
 	broadcaster        *TransactionBroadcaster
 	selectedUTXOs      []UTXO // Store selected UTXOs for signing
 	createdTransaction *transaction.Transaction // Store created transaction object for signing
+	events             *WalletEvents            // State changes streamed to the browser
 }
 
 // NewWalletService creates a new wallet service instance
@@ -98,6 +99,7 @@ func NewWalletService() *WalletService {
 	walletService := &WalletService{
 		walletManager: NewWalletManager(),
 		logger:        logger,
+		events:        NewWalletEvents(),
 	}
 
 	// Initialize transaction components
@@ -416,24 +418,38 @@ func main() {
 			http.Error(w, fmt.Sprintf("Failed to broadcast transaction: %v", err), http.StatusInternalServerError)
 			return
 		}
+		walletService.events.Publish(nil, TopicBalance, TopicHistory)
 
 		w.Header().Set("Content-Type", "application/json")
 		json.NewEncoder(w).Encode(response)
 	})
 
-	// Transaction history endpoint (placeholder - returns empty array for now)
+	// Transaction history endpoint (placeholder - no history is stored yet)
+	// Query: since=<cursor from the previous response>, limit=<max transactions>.
+	// Response: {transactions, removed, cursor, more}; transactions are the ones added or changed
+	// after the cursor, and more means another request with the new cursor has the rest.
 	http.HandleFunc("/transaction/history", func(w http.ResponseWriter, r *http.Request) {
 		if r.Method != "GET" {
 			http.Error(w, "Method not allowed", http.StatusMethodNotAllowed)
 			return
 		}
 
-		// For now, return empty array - in production this would query a database
+		cursor := r.URL.Query().Get("since")
+		if cursor == "" {
+			cursor = "0"
+		}
+
+		// For now, return an empty delta - in production this would query a database
 		// or blockchain explorer for transaction history
-		history := []map[string]interface{}{}
+		response := map[string]interface{}{
+			"transactions": []map[string]interface{}{},
+			"removed":      []string{},
+			"cursor":       cursor,
+			"more":         false,
+		}
 
 		w.Header().Set("Content-Type", "application/json")
-		json.NewEncoder(w).Encode(history)
+		json.NewEncoder(w).Encode(response)
 	})
 
 	// Unified Wallet Management Endpoints
@@ -487,6 +503,8 @@ func main() {
 			return
 		}
 
+		walletService.events.Publish(nil, TopicBalance, TopicAddresses, TopicHistory)
+
 		response := map[string]interface{}{
 			"success": true,
 			"mnemonic": mnemonic,
@@ -508,6 +526,7 @@ func main() {
 			http.Error(w, fmt.Sprintf("Failed to load unified wallet: %v", err), http.StatusInternalServerError)
 			return
 		}
+		walletService.events.Publish(nil, TopicBalance, TopicAddresses, TopicHistory)
 
 		response := map[string]interface{}{
 			"success": true,
@@ -547,6 +566,7 @@ func main() {
 			http.Error(w, fmt.Sprintf("Failed to save wallet: %v", err), http.StatusInternalServerError)
 			return
 		}
+		walletService.events.Publish(walletService.walletManager.GetAllAddresses(), TopicAddresses)
 
 		w.Header().Set("Content-Type", "application/json")
 		json.NewEncoder(w).Encode(address)
@@ -568,6 +588,9 @@ func main() {
 		json.NewEncoder(w).Encode(address)
 	})
 
+	// Wallet state change stream for the browser's subscriptions (newline-delimited JSON)
+	http.HandleFunc("/wallet/events", walletService.events.HandleWalletEvents)
+
 	// Balance Management Endpoints
 	http.HandleFunc("/wallet/balance", func(w http.ResponseWriter, r *http.Request) {
 		if r.Method != "GET" {
@@ -678,6 +701,7 @@ func main() {
 			http.Error(w, fmt.Sprintf("Failed to broadcast transaction: %v", err), http.StatusInternalServerError)
 			return
 		}
+		walletService.events.Publish(nil, TopicBalance, TopicHistory)
 
 		// Return success response with WhatsOnChain link
 		response := map[string]interface{}{
@@ -1186,6 +1210,7 @@ func main() {
 	fmt.Println("  POST /brc100/session/create - Create authentication session")
 	fmt.Println("  POST /brc100/session/validate - Validate session")
 	fmt.Println("  POST /brc100/session/revoke - Revoke session")
+	fmt.Println("  GET  /brc100/sessions - List unexpired sessions")
 	fmt.Println("  POST /brc100/beef/create - Create BRC-100 BEEF transaction")
 	fmt.Println("  POST /brc100/beef/verify - Verify BRC-100 BEEF transaction")
 	fmt.Println("  POST /brc100/beef/broadcast - Convert and broadcast BEEF")
@@ -1212,6 +1237,7 @@ func main() {
 	fmt.Println("  POST /domain/whitelist/record - Record request from domain")
 	fmt.Println("  GET  /domain/whitelist/list - List all whitelisted domains")
 	fmt.Println("  POST /domain/whitelist/remove - Remove domain from whitelist")
+	registerTransportBench()
 
 
 	// Helper function to derive BRC-42 child key and sign data
@@ -1512,7 +1538,7 @@ func main() {
 	// Create a custom HTTP server that can handle WebSocket upgrades
 	server := &http.Server{
 		Addr: ":" + port,
-		Handler: http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
+		Handler: withRequestDeadline(http.HandlerFunc(func(w http.ResponseWriter, r *http.Request) {
 			// Check if this is a WebSocket upgrade request
 			if r.Header.Get("Connection") == "upgrade" && r.Header.Get("Upgrade") == "websocket" {
 				// Handle WebSocket upgrade
@@ -1526,8 +1552,15 @@ func main() {
 			}
 			// For all other requests, use the default mux
 			http.DefaultServeMux.ServeHTTP(w, r)
-		}),
+		})),
 	}
 
+	ServeSharedMemoryChannel(map[string]http.HandlerFunc{
+		"/getPublicKey":    handleGetPublicKey,
+		"/createSignature": handleCreateSignature,
+		"/createHmac":      handleCreateHmac,
+		"/verifyHmac":      handleVerifyHmac,
+	})
+	ServeLocalSocket(server)
 	log.Fatal(server.ListenAndServe())
 }
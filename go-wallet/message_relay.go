@@ -211,6 +211,8 @@ func HandleSendMessage(messageStore *MessageStore, walletService *WalletService)
 			return
 		}
 
+		walletService.events.Publish(map[string]interface{}{"count": messageStore.GetMessageCount()}, TopicMessages)
+
 		// Return success
 		response := map[string]interface{}{
 			"status":    "success",
@@ -335,6 +337,7 @@ func HandleAcknowledgeMessage(messageStore *MessageStore, walletService *WalletS
 			http.Error(w, "Failed to acknowledge messages", http.StatusInternalServerError)
 			return
 		}
+		walletService.events.Publish(map[string]interface{}{"count": messageStore.GetMessageCount()}, TopicMessages)
 
 		// Return success
 		response := map[string]interface{}{
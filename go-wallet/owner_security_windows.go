@@ -0,0 +1,127 @@
+package main
+
+import (
+	"fmt"
+	"syscall"
+	"unsafe"
+)
+
+// Windows security descriptors for what the daemon shares with the browser: the local socket's
+// directory and the shared-memory channel's mapping and events. All are limited to the user the
+// daemon runs as.
+
+var (
+	advapi32                      = syscall.NewLazyDLL("advapi32.dll")
+	procConvertSddlToSd           = advapi32.NewProc("ConvertStringSecurityDescriptorToSecurityDescriptorW")
+	procGetSecurityDescriptorDacl = advapi32.NewProc("GetSecurityDescriptorDacl")
+	procSetNamedSecurityInfoW     = advapi32.NewProc("SetNamedSecurityInfoW")
+	procGetSecurityInfo           = advapi32.NewProc("GetSecurityInfo")
+)
+
+const (
+	sddlRevision1                    = 1
+	seFileObject                     = 1
+	seKernelObject                   = 6
+	ownerSecurityInformation         = 0x00000001
+	daclSecurityInformation          = 0x00000004
+	protectedDaclSecurityInformation = 0x80000000
+)
+
+// currentUserSid returns the string SID of the user the daemon runs as
+func currentUserSid() (string, error) {
+	token, err := syscall.OpenCurrentProcessToken()
+	if err != nil {
+		return "", err
+	}
+	defer token.Close()
+	user, err := token.GetTokenUser()
+	if err != nil {
+		return "", err
+	}
+	return user.User.Sid.String()
+}
+
+// securityDescriptorFromSddl converts SDDL to a self-relative security descriptor; free it with
+// syscall.LocalFree
+func securityDescriptorFromSddl(sddl string) (uintptr, error) {
+	sddlPtr, err := syscall.UTF16PtrFromString(sddl)
+	if err != nil {
+		return 0, err
+	}
+	var descriptor uintptr
+	ok, _, callErr := procConvertSddlToSd.Call(uintptr(unsafe.Pointer(sddlPtr)), sddlRevision1,
+		uintptr(unsafe.Pointer(&descriptor)), 0)
+	if ok == 0 {
+		return 0, callErr
+	}
+	return descriptor, nil
+}
+
+// restrictDirectoryToOwner replaces dir's DACL with a protected one that lets only the current
+// user (and SYSTEM) in, inherited by every file in it, existing or created later
+func restrictDirectoryToOwner(dir string) error {
+	sid, err := currentUserSid()
+	if err != nil {
+		return err
+	}
+	descriptor, err := securityDescriptorFromSddl(fmt.Sprintf("D:P(A;OICI;GA;;;%s)(A;OICI;GA;;;SY)", sid))
+	if err != nil {
+		return err
+	}
+	defer syscall.LocalFree(syscall.Handle(descriptor))
+
+	var present, defaulted int32
+	var dacl uintptr
+	ok, _, callErr := procGetSecurityDescriptorDacl.Call(descriptor, uintptr(unsafe.Pointer(&present)),
+		uintptr(unsafe.Pointer(&dacl)), uintptr(unsafe.Pointer(&defaulted)))
+	if ok == 0 {
+		return callErr
+	}
+
+	dirPtr, err := syscall.UTF16PtrFromString(dir)
+	if err != nil {
+		return err
+	}
+	status, _, _ := procSetNamedSecurityInfoW.Call(uintptr(unsafe.Pointer(dirPtr)), seFileObject,
+		daclSecurityInformation|protectedDaclSecurityInformation, 0, 0, dacl, 0)
+	if status != 0 {
+		return syscall.Errno(status)
+	}
+	return nil
+}
+
+// ownerOnlySecurityAttributes describes a kernel object owned by and open to the current user
+// alone; call the returned func to free it once the object is created
+func ownerOnlySecurityAttributes() (*syscall.SecurityAttributes, func(), error) {
+	sid, err := currentUserSid()
+	if err != nil {
+		return nil, nil, err
+	}
+	descriptor, err := securityDescriptorFromSddl(fmt.Sprintf("O:%sD:P(A;;GA;;;%s)", sid, sid))
+	if err != nil {
+		return nil, nil, err
+	}
+	attributes := &syscall.SecurityAttributes{SecurityDescriptor: descriptor}
+	attributes.Length = uint32(unsafe.Sizeof(*attributes))
+	return attributes, func() { syscall.LocalFree(syscall.Handle(descriptor)) }, nil
+}
+
+// ownedByCurrentUser reports whether the kernel object behind handle is owned by the current user.
+// Creating a named object that already exists opens it and ignores the security attributes
+// passed, so this catches one that another user created first under the same name.
+func ownedByCurrentUser(handle syscall.Handle) bool {
+	sid, err := currentUserSid()
+	if err != nil {
+		return false
+	}
+	var owner *syscall.SID
+	var descriptor uintptr
+	status, _, _ := procGetSecurityInfo.Call(uintptr(handle), seKernelObject, ownerSecurityInformation,
+		uintptr(unsafe.Pointer(&owner)), 0, 0, 0, uintptr(unsafe.Pointer(&descriptor)))
+	if status != 0 {
+		return false
+	}
+	defer syscall.LocalFree(syscall.Handle(descriptor))
+	ownerSid, err := owner.String()
+	return err == nil && ownerSid == sid
+}
@@ -0,0 +1,8 @@
+//go:build !windows
+
+package main
+
+import "net/http"
+
+// ServeSharedMemoryChannel is Windows-only; elsewhere the browser reaches these calls over HTTP
+func ServeSharedMemoryChannel(handlers map[string]http.HandlerFunc) {}
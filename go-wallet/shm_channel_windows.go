@@ -0,0 +1,233 @@
+package main
+
+import (
+	"bytes"
+	"encoding/binary"
+	"fmt"
+	"net/http"
+	"net/http/httptest"
+	"runtime"
+	"sync/atomic"
+	"syscall"
+	"unsafe"
+)
+
+// Shared-memory channel for the browser's most frequent wallet calls. Layout, framing and the
+// wakeup protocol must match cef-native/src/core/DaemonChannel.cpp, and the test stand-in in
+// cef-native/tests/ChannelDaemon.h.
+const (
+	shmChannelName    = `Local\BabbageBrowserWalletChannel`
+	shmChannelMagic   = 0x43574242 // "BBWC"
+	shmChannelVersion = 1
+	shmSlotCount      = 256
+	shmSlotBytes      = 4096
+	shmFrameBytes     = 16
+	shmMaxPayload     = shmSlotBytes - shmFrameBytes
+
+	shmOffMagic          = 0
+	shmOffVersion        = 4
+	shmOffSlotCount      = 8
+	shmOffSlotBytes      = 12
+	shmOffRequestHead    = 64
+	shmOffRequestTail    = 128
+	shmOffAnswerHead     = 192
+	shmOffAnswerTail     = 256
+	shmOffDaemonWaiting  = 320
+	shmOffBrowserWaiting = 384
+	shmOffDaemonReady    = 448
+	shmOffSlots          = 512
+	shmChannelBytes      = shmOffSlots + 2*shmSlotCount*shmSlotBytes
+
+	shmStatusTooLarge = 0xFFFF
+	shmSpinRounds     = 200
+)
+
+// Endpoints served over the channel, by the op code in each frame
+var shmChannelOps = map[uint16]string{
+	1: "/getPublicKey",
+	2: "/createSignature",
+	3: "/createHmac",
+	4: "/verifyHmac",
+}
+
+var (
+	kernel32         = syscall.NewLazyDLL("kernel32.dll")
+	procCreateEventW = kernel32.NewProc("CreateEventW")
+	procSetEvent     = kernel32.NewProc("SetEvent")
+)
+
+type shmChannel struct {
+	mem          []byte
+	requestEvent syscall.Handle
+	answerEvent  syscall.Handle
+	handlers     map[uint16]http.HandlerFunc
+}
+
+func (c *shmChannel) word(offset int) *uint32 {
+	return (*uint32)(unsafe.Pointer(&c.mem[offset]))
+}
+
+func (c *shmChannel) slot(ring int, index uint32) []byte {
+	offset := shmOffSlots + (ring*shmSlotCount+int(index%shmSlotCount))*shmSlotBytes
+	return c.mem[offset : offset+shmSlotBytes]
+}
+
+// createNamedEvent creates an auto-reset event the browser opens by name
+func createNamedEvent(name string, attributes *syscall.SecurityAttributes) (syscall.Handle, error) {
+	namePtr, err := syscall.UTF16PtrFromString(name)
+	if err != nil {
+		return 0, err
+	}
+	handle, _, callErr := procCreateEventW.Call(uintptr(unsafe.Pointer(attributes)), 0, 0, uintptr(unsafe.Pointer(namePtr)))
+	if handle == 0 {
+		return 0, callErr
+	}
+	return syscall.Handle(handle), nil
+}
+
+// ServeSharedMemoryChannel answers getPublicKey, createSignature, createHmac and verifyHmac from
+// the browser over shared-memory rings as well as HTTP. Each request runs through the same
+// handler as its HTTP route, so both transports give the same answers. The mapping and events are
+// owned by and open to the daemon's user only; the browser checks the owner before attaching.
+func ServeSharedMemoryChannel(handlers map[string]http.HandlerFunc) {
+	attributes, free, err := ownerOnlySecurityAttributes()
+	if err != nil {
+		fmt.Printf("⚠️ Shared-memory channel disabled: %v\n", err)
+		return
+	}
+	defer free()
+
+	namePtr, _ := syscall.UTF16PtrFromString(shmChannelName)
+	mapping, err := syscall.CreateFileMapping(syscall.InvalidHandle, attributes, syscall.PAGE_READWRITE, 0, shmChannelBytes, namePtr)
+	if err != nil {
+		fmt.Printf("⚠️ Shared-memory channel disabled: %v\n", err)
+		return
+	}
+	// Left over from before a restart is fine; created by another user first is not
+	if !ownedByCurrentUser(mapping) {
+		fmt.Printf("⚠️ Shared-memory channel disabled: %s exists and belongs to another user\n", shmChannelName)
+		syscall.CloseHandle(mapping)
+		return
+	}
+	addr, err := syscall.MapViewOfFile(mapping, syscall.FILE_MAP_WRITE, 0, 0, shmChannelBytes)
+	if err != nil {
+		fmt.Printf("⚠️ Shared-memory channel disabled: %v\n", err)
+		syscall.CloseHandle(mapping)
+		return
+	}
+	requestEvent, err := createNamedEvent(shmChannelName+".request", attributes)
+	if err != nil {
+		fmt.Printf("⚠️ Shared-memory channel disabled: %v\n", err)
+		return
+	}
+	answerEvent, err := createNamedEvent(shmChannelName+".response", attributes)
+	if err != nil {
+		fmt.Printf("⚠️ Shared-memory channel disabled: %v\n", err)
+		return
+	}
+	if !ownedByCurrentUser(requestEvent) || !ownedByCurrentUser(answerEvent) {
+		fmt.Printf("⚠️ Shared-memory channel disabled: its events exist and belong to another user\n")
+		return
+	}
+
+	c := &shmChannel{
+		mem:          unsafe.Slice((*byte)(unsafe.Pointer(addr)), shmChannelBytes),
+		requestEvent: requestEvent,
+		answerEvent:  answerEvent,
+		handlers:     make(map[uint16]http.HandlerFunc),
+	}
+	for op, path := range shmChannelOps {
+		if handler, ok := handlers[path]; ok {
+			c.handlers[op] = handler
+		}
+	}
+
+	atomic.StoreUint32(c.word(shmOffSlotCount), shmSlotCount)
+	atomic.StoreUint32(c.word(shmOffSlotBytes), shmSlotBytes)
+	atomic.StoreUint32(c.word(shmOffVersion), shmChannelVersion)
+	atomic.StoreUint32(c.word(shmOffMagic), shmChannelMagic)
+	// A browser still attached from before a restart may have requests queued that nobody will
+	// answer; they time out on its side and go over HTTP
+	atomic.StoreUint32(c.word(shmOffRequestTail), atomic.LoadUint32(c.word(shmOffRequestHead)))
+	atomic.StoreUint32(c.word(shmOffDaemonReady), 1)
+
+	fmt.Printf("⚡ Shared-memory channel ready for %d wallet calls\n", len(c.handlers))
+	go c.serve()
+}
+
+func (c *shmChannel) serve() {
+	requestTail := atomic.LoadUint32(c.word(shmOffRequestTail))
+	answerHead := atomic.LoadUint32(c.word(shmOffAnswerHead))
+	for {
+		requestHead := atomic.LoadUint32(c.word(shmOffRequestHead))
+		if requestHead == requestTail {
+			c.waitForRequests(requestTail)
+			continue
+		}
+
+		// Everything published so far is answered before the browser is woken once
+		for ; requestTail != requestHead; requestTail++ {
+			// The browser keeps no more calls outstanding than there are slots, so this only
+			// waits when it is slow to drain
+			for answerHead-atomic.LoadUint32(c.word(shmOffAnswerTail)) >= shmSlotCount {
+				c.publish(requestTail, answerHead)
+				runtime.Gosched()
+			}
+			c.answer(c.slot(0, requestTail), c.slot(1, answerHead))
+			answerHead++
+		}
+		c.publish(requestTail, answerHead)
+	}
+}
+
+func (c *shmChannel) publish(requestTail, answerHead uint32) {
+	atomic.StoreUint32(c.word(shmOffRequestTail), requestTail)
+	atomic.StoreUint32(c.word(shmOffAnswerHead), answerHead)
+	if atomic.SwapUint32(c.word(shmOffBrowserWaiting), 0) == 1 {
+		procSetEvent.Call(uintptr(c.answerEvent))
+	}
+}
+
+func (c *shmChannel) waitForRequests(requestTail uint32) {
+	for i := 0; i < shmSpinRounds; i++ {
+		if atomic.LoadUint32(c.word(shmOffRequestHead)) != requestTail {
+			return
+		}
+		runtime.Gosched()
+	}
+	// Announce the sleep before the last look, so a request published in between still wakes us
+	atomic.StoreUint32(c.word(shmOffDaemonWaiting), 1)
+	if atomic.LoadUint32(c.word(shmOffRequestHead)) == requestTail {
+		syscall.WaitForSingleObject(c.requestEvent, 1000)
+	}
+	atomic.StoreUint32(c.word(shmOffDaemonWaiting), 0)
+}
+
+// answer runs one request frame through its HTTP handler and writes the answer frame
+func (c *shmChannel) answer(request, answer []byte) {
+	length := binary.LittleEndian.Uint32(request[0:])
+	op := binary.LittleEndian.Uint16(request[8:])
+	copy(answer[4:10], request[4:10]) // id and op
+
+	status := http.StatusNotFound
+	var body []byte
+	if handler, ok := c.handlers[op]; ok && length <= shmMaxPayload {
+		payload := append([]byte(nil), request[shmFrameBytes:shmFrameBytes+length]...)
+		r := httptest.NewRequest("POST", shmChannelOps[op], bytes.NewReader(payload))
+		r.Header.Set("Content-Type", "application/json")
+		recorder := httptest.NewRecorder()
+		handler(recorder, r)
+		status = recorder.Code
+		body = recorder.Body.Bytes()
+	} else if ok {
+		status = http.StatusRequestEntityTooLarge
+	}
+
+	if len(body) > shmMaxPayload {
+		status = shmStatusTooLarge
+		body = nil
+	}
+	binary.LittleEndian.PutUint32(answer[0:], uint32(len(body)))
+	binary.LittleEndian.PutUint16(answer[10:], uint16(status))
+	copy(answer[shmFrameBytes:], body)
+}
@@ -0,0 +1,39 @@
+//go:build benchmark
+
+package main
+
+import (
+	"fmt"
+	"net/http"
+	"strconv"
+	"strings"
+)
+
+// Largest payload /transport/bench will generate
+const transportBenchMaxBytes = 1 << 20
+
+// registerTransportBench adds /transport/bench to benchmark builds (go build -tags benchmark) only,
+// on the TCP port and the local socket alike so the browser can compare the two
+func registerTransportBench() {
+	http.HandleFunc("/transport/bench", handleTransportBench)
+	fmt.Println("  GET  /transport/bench?bytes=N - Fixed-size payload for transport benchmarks (benchmark build)")
+}
+
+// handleTransportBench answers GET /transport/bench?bytes=N with a JSON string of N bytes, so the
+// browser can compare request latency and throughput over the socket and over TCP
+func handleTransportBench(w http.ResponseWriter, r *http.Request) {
+	if r.Method != "GET" {
+		http.Error(w, "Method not allowed", http.StatusMethodNotAllowed)
+		return
+	}
+
+	size, err := strconv.Atoi(r.URL.Query().Get("bytes"))
+	if err != nil || size < 0 || size > transportBenchMaxBytes {
+		http.Error(w, "bytes out of range", http.StatusBadRequest)
+		return
+	}
+
+	w.Header().Set("Content-Type", "application/json")
+	w.Header().Set("Content-Length", strconv.Itoa(len(`{"payload":""}`)+size))
+	fmt.Fprintf(w, `{"payload":"%s"}`, strings.Repeat("x", size))
+}
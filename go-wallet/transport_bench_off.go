@@ -0,0 +1,7 @@
+//go:build !benchmark
+
+package main
+
+// registerTransportBench is a no-op outside benchmark builds, so production daemons never serve
+// /transport/bench
+func registerTransportBench() {}
@@ -0,0 +1,131 @@
+package main
+
+import (
+	"encoding/json"
+	"net/http"
+	"sync"
+	"time"
+)
+
+// Wallet state topics the browser can subscribe to
+const (
+	TopicBalance   = "balance"
+	TopicAddresses = "addresses"
+	TopicHistory   = "history"
+	TopicMessages  = "messages"
+	// BRC-100 session changes, so the browser can answer session checks itself
+	TopicSessions = "sessions"
+)
+
+// How often an idle /wallet/events stream carries a heartbeat, so the browser notices a dead connection
+const walletEventHeartbeat = 15 * time.Second
+
+// Events buffered per listener; a listener that falls this far behind is dropped and reconnects
+const walletEventBacklog = 64
+
+// WalletEvent tells listeners that a piece of wallet state changed. Data carries the new
+// state when it is cheap to include; otherwise the listener fetches it from the usual endpoint.
+type WalletEvent struct {
+	Seq   uint64      `json:"seq"`
+	Topic string      `json:"topic"`
+	Data  interface{} `json:"data,omitempty"`
+}
+
+// WalletEvents fans state changes out to every open /wallet/events stream
+type WalletEvents struct {
+	mu        sync.Mutex
+	seq       uint64
+	listeners map[chan WalletEvent]struct{}
+}
+
+// NewWalletEvents creates an event hub with no listeners
+func NewWalletEvents() *WalletEvents {
+	return &WalletEvents{
+		listeners: make(map[chan WalletEvent]struct{}),
+	}
+}
+
+// Publish sends one event per topic to every listener; data may be nil
+func (we *WalletEvents) Publish(data interface{}, topics ...string) {
+	we.mu.Lock()
+	defer we.mu.Unlock()
+
+	for _, topic := range topics {
+		we.seq++
+		event := WalletEvent{Seq: we.seq, Topic: topic, Data: data}
+		for listener := range we.listeners {
+			select {
+			case listener <- event:
+			default:
+				// Too far behind: closing the stream makes the browser reconnect and refetch everything
+				delete(we.listeners, listener)
+				close(listener)
+			}
+		}
+	}
+}
+
+func (we *WalletEvents) listen() chan WalletEvent {
+	we.mu.Lock()
+	defer we.mu.Unlock()
+
+	listener := make(chan WalletEvent, walletEventBacklog)
+	we.listeners[listener] = struct{}{}
+	return listener
+}
+
+func (we *WalletEvents) forget(listener chan WalletEvent) {
+	we.mu.Lock()
+	defer we.mu.Unlock()
+
+	if _, ok := we.listeners[listener]; ok {
+		delete(we.listeners, listener)
+		close(listener)
+	}
+}
+
+// HandleWalletEvents streams wallet events as newline-delimited JSON until the client goes away.
+// The browser keeps one of these open and fans the changes out to subscribed pages.
+func (we *WalletEvents) HandleWalletEvents(w http.ResponseWriter, r *http.Request) {
+	if r.Method != "GET" {
+		http.Error(w, "Method not allowed", http.StatusMethodNotAllowed)
+		return
+	}
+
+	flusher, ok := w.(http.Flusher)
+	if !ok {
+		http.Error(w, "Streaming not supported", http.StatusInternalServerError)
+		return
+	}
+
+	listener := we.listen()
+	defer we.forget(listener)
+
+	w.Header().Set("Content-Type", "application/x-ndjson")
+	w.Header().Set("Cache-Control", "no-cache")
+	w.WriteHeader(http.StatusOK)
+	flusher.Flush()
+
+	encoder := json.NewEncoder(w)
+	heartbeat := time.NewTicker(walletEventHeartbeat)
+	defer heartbeat.Stop()
+
+	for {
+		select {
+		case event, open := <-listener:
+			if !open {
+				return
+			}
+			if err := encoder.Encode(event); err != nil {
+				return
+			}
+		case <-heartbeat.C:
+			if err := encoder.Encode(WalletEvent{Topic: "heartbeat"}); err != nil {
+				return
+			}
+		case <-r.Context().Done():
+			return
+		}
+		flusher.Flush()
+	}
+}